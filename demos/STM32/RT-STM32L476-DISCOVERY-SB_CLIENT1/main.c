@@ -21,6 +21,65 @@
 
 #include "sbuser.h"
 
+/*
+ * Set to TRUE for measuring the cost of single SVCs against batched
+ * requests, results are printed on the standard output.
+ */
+#if !defined(DEMO_BATCH_BENCHMARK)
+#define DEMO_BATCH_BENCHMARK            FALSE
+#endif
+
+#if DEMO_BATCH_BENCHMARK == TRUE
+#define BENCH_ENTRIES                   8U
+#define BENCH_ROUNDS                    10000U
+
+static uint32_t batch_area[SB_BATCH_AREA_SIZE(BENCH_ENTRIES) /
+                           sizeof (uint32_t)];
+
+/*
+ * Syscalls batching benchmark, the same requests are executed using
+ * one SVC each and then queued and executed using one SVC per round.
+ */
+static void batch_benchmark(void) {
+  sb_batch_t batch;
+  sb_cqe_t cqe;
+  systime_t start;
+  sysinterval_t single, batched;
+  uint32_t i, j;
+
+  if (sbBatchObjectInit(&batch, batch_area, BENCH_ENTRIES) != SB_ERR_NOERROR) {
+    printf("Batch setup failed\r\n");
+    return;
+  }
+
+  /* One SVC for each request.*/
+  start = sbGetSystemTime();
+  for (i = 0U; i < BENCH_ROUNDS; i++) {
+    for (j = 0U; j < BENCH_ENTRIES; j++) {
+      (void) sbGetSystemTime();
+    }
+  }
+  single = sbTimeDiffX(start, sbGetSystemTime());
+
+  /* One SVC for all the requests of a round, SVC 2 is get_systime.*/
+  start = sbGetSystemTime();
+  for (i = 0U; i < BENCH_ROUNDS; i++) {
+    for (j = 0U; j < BENCH_ENTRIES; j++) {
+      (void) sbBatchAdd(&batch, 2U, 0U, 0U, 0U, 0U, j);
+    }
+    (void) sbBatchSubmit(&batch);
+    while (sbBatchGetCompletion(&batch, &cqe)) {
+    }
+  }
+  batched = sbTimeDiffX(start, sbGetSystemTime());
+
+  printf("%u requests, single: %u ms, batched: %u ms\r\n",
+         (unsigned)(BENCH_ROUNDS * BENCH_ENTRIES),
+         (unsigned)sbTimeI2MS(single),
+         (unsigned)sbTimeI2MS(batched));
+}
+#endif
+
 /*
  * Application entry point.
  */
@@ -29,6 +88,10 @@ int main(void) {
   /* API layer initialization.*/
   sbApiInit();
 
+#if DEMO_BATCH_BENCHMARK == TRUE
+  batch_benchmark();
+#endif
+
   /*
    * Normal main() activity, in this demo it does nothing except
    * sleeping in a loop.
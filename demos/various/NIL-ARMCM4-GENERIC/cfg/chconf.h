@@ -312,6 +312,17 @@
 #define CH_CFG_FACTORY_MAX_NAMES_LENGTH     8
 #endif
 
+/**
+ * @brief   Size of the names hash index of each objects list.
+ * @details If not zero then each list of the factory is indexed by an
+ *          open addressing hash table of the specified size, objects
+ *          not fitting the table are still found by a linear search.
+ * @note    Must be zero or a power of two.
+ */
+#if !defined(CH_CFG_FACTORY_HASH_SIZE)
+#define CH_CFG_FACTORY_HASH_SIZE            0
+#endif
+
 /**
  * @brief   Enables the registry of generic objects.
  */
@@ -0,0 +1,295 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ch.hpp"
+#include "hal.h"
+#include "chcoro.hpp"
+
+using namespace chibios_rt;
+
+#define EXECUTOR_WA_SIZE    THD_WORKING_AREA_SIZE(4096)
+#define PINGPONG_WA_SIZE    THD_WORKING_AREA_SIZE(4096)
+#define FANOUT_WA_SIZE      THD_WORKING_AREA_SIZE(1024)
+#define MAX_ACTIVITIES      64U
+
+/*
+ * Run parameters, see usage().
+ */
+static uint32_t rounds = 200000U;
+static uint32_t activities = 16U;
+
+static chibios_co::Executor executor;
+static CounterSemaphore done(0);
+
+/*
+ * Host monotonic time in nanoseconds.
+ */
+static uint64_t host_time_ns(void) {
+  struct timespec ts;
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * Heap and core memory currently available.
+ */
+static size_t mem_free(void) {
+  size_t total;
+
+  (void) chHeapStatus(NULL, &total, NULL);
+
+  return total + chCoreGetStatusX();
+}
+
+static void wait_done(uint32_t n) {
+
+  while (n-- > 0U) {
+    done.wait();
+  }
+}
+
+/*------------------------------------------------------------------------*
+ * Ping-pong.                                                             *
+ *------------------------------------------------------------------------*/
+
+static chibios_co::Semaphore co_ping(0), co_pong(0);
+static BinarySemaphore thd_ping(true), thd_pong(true);
+
+static chibios_co::Task co_pinger(uint32_t n) {
+
+  while (n-- > 0U) {
+    co_ping.signal();
+    co_await co_pong.wait();
+  }
+  done.signal();
+}
+
+static chibios_co::Task co_ponger(uint32_t n) {
+
+  while (n-- > 0U) {
+    co_await co_ping.wait();
+    co_pong.signal();
+  }
+  done.signal();
+}
+
+static THD_FUNCTION(thd_pinger, arg) {
+  uint32_t n = (uint32_t)(uintptr_t)arg;
+
+  while (n-- > 0U) {
+    thd_ping.signal();
+    (void) thd_pong.wait();
+  }
+  done.signal();
+}
+
+static THD_FUNCTION(thd_ponger, arg) {
+  uint32_t n = (uint32_t)(uintptr_t)arg;
+
+  while (n-- > 0U) {
+    (void) thd_ping.wait();
+    thd_pong.signal();
+  }
+  done.signal();
+}
+
+/*------------------------------------------------------------------------*
+ * Fan-out.                                                               *
+ *------------------------------------------------------------------------*/
+
+static chibios_co::Semaphore co_gate(0);
+static CounterSemaphore thd_gate(0);
+
+static chibios_co::Task co_waiter(void) {
+
+  co_await co_gate.wait();
+  done.signal();
+}
+
+static THD_FUNCTION(thd_waiter, arg) {
+
+  (void)arg;
+  (void) thd_gate.wait();
+  done.signal();
+}
+
+/*------------------------------------------------------------------------*
+ * Executor thread.                                                       *
+ *------------------------------------------------------------------------*/
+
+static THD_FUNCTION(executor_thread, arg) {
+
+  (void)arg;
+  executor.run();
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+
+static void usage(const char *name) {
+
+  printf("Usage: %s [-r rounds] [-n activities]\n", name);
+  printf("  -r  ping-pong rounds (%" PRIu32 ")\n", rounds);
+  printf("  -n  number of fan-out activities, up to %u (%" PRIu32 ")\n",
+         MAX_ACTIVITIES, activities);
+  exit(2);
+}
+
+int main(int argc, char *argv[]) {
+  thread_t *threads[MAX_ACTIVITIES];
+  thread_t *executor_tp;
+  uint64_t start, co_time, thd_time;
+  size_t before, co_mem, thd_mem;
+  uint32_t i;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "r:n:h")) != -1) {
+    switch (opt) {
+    case 'r':
+      rounds = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'n':
+      activities = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+  if ((rounds == 0U) || (activities == 0U) ||
+      (activities > MAX_ACTIVITIES)) {
+    usage(argv[0]);
+  }
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  printf("*** ChibiOS/RT coroutines vs threads benchmark\n");
+  printf("***\n");
+  printf("*** Kernel:       %s\n", CH_KERNEL_VERSION);
+#ifdef PORT_COMPILER_NAME
+  printf("*** Compiler:     %s\n", PORT_COMPILER_NAME);
+#endif
+  printf("*** Platform:     %s\n", PLATFORM_NAME);
+  printf("*** Rounds:       %" PRIu32 "\n", rounds);
+  printf("*** Activities:   %" PRIu32 "\n", activities);
+  printf("\n");
+  fflush(stdout);
+
+  /*
+   * A single thread serves the executor, above the main thread.
+   */
+  executor_tp = chThdCreateFromHeap(NULL, EXECUTOR_WA_SIZE, "executor",
+                                    NORMALPRIO + 1, executor_thread, NULL);
+
+  /*
+   * Ping-pong between two coroutines on the executor thread, then between
+   * two threads.
+   */
+  start = host_time_ns();
+  (void) executor.spawn(co_pinger(rounds));
+  (void) executor.spawn(co_ponger(rounds));
+  wait_done(2U);
+  co_time = host_time_ns() - start;
+
+  start = host_time_ns();
+  threads[0] = chThdCreateFromHeap(NULL, PINGPONG_WA_SIZE, "pinger",
+                                   NORMALPRIO + 1, thd_pinger,
+                                   (void *)(uintptr_t)rounds);
+  threads[1] = chThdCreateFromHeap(NULL, PINGPONG_WA_SIZE, "ponger",
+                                   NORMALPRIO + 1, thd_ponger,
+                                   (void *)(uintptr_t)rounds);
+  wait_done(2U);
+  thd_time = host_time_ns() - start;
+  chThdWait(threads[0]);
+  chThdWait(threads[1]);
+
+  printf("Ping-pong, nanoseconds per round\n");
+  printf("  Coroutines:    %" PRIu64 "\n", co_time / rounds);
+  printf("  Threads:       %" PRIu64 "\n", thd_time / rounds);
+
+  /*
+   * Fan-out, activities waiting on a single gate, the memory is measured
+   * while all of them are suspended.
+   */
+  before = mem_free();
+  for (i = 0U; i < activities; i++) {
+    if (!executor.spawn(co_waiter())) {
+      printf("\nFinal result: FAILURE (out of memory)\n");
+      return 1;
+    }
+  }
+  chThdSleepMilliseconds(10);
+  co_mem = before - mem_free();
+  start = host_time_ns();
+  for (i = 0U; i < activities; i++) {
+    co_gate.signal();
+  }
+  wait_done(activities);
+  co_time = host_time_ns() - start;
+
+  before = mem_free();
+  for (i = 0U; i < activities; i++) {
+    threads[i] = chThdCreateFromHeap(NULL, FANOUT_WA_SIZE, "waiter",
+                                     NORMALPRIO + 1, thd_waiter, NULL);
+    if (threads[i] == NULL) {
+      printf("\nFinal result: FAILURE (out of memory)\n");
+      return 1;
+    }
+  }
+  thd_mem = before - mem_free();
+  start = host_time_ns();
+  for (i = 0U; i < activities; i++) {
+    thd_gate.signal();
+  }
+  wait_done(activities);
+  thd_time = host_time_ns() - start;
+  for (i = 0U; i < activities; i++) {
+    chThdWait(threads[i]);
+  }
+
+  printf("Fan-out, memory bytes and wakeup nanoseconds per activity\n");
+  printf("  Coroutines:    %zu bytes, %" PRIu64 " ns\n",
+         co_mem / activities, co_time / activities);
+  printf("  Threads:       %zu bytes, %" PRIu64 " ns\n",
+         thd_mem / activities, thd_time / activities);
+
+  /*
+   * Executor termination.
+   */
+  executor.stop();
+  chThdWait(executor_tp);
+
+  printf("\nFinal result: SUCCESS\n");
+  fflush(stdout);
+
+  return 0;
+}
@@ -0,0 +1,31 @@
+#!/bin/bash
+# Builds and runs the demo in all the lwIP protection configurations, the
+# priority ceiling mode is also built with the kernel mutexes disabled.
+
+function test() {
+  echo "Configuration $1 ($2)"
+  make clean > /dev/null
+  echo -n "  * Building..."
+  if ! make $2 > buildlog.txt
+  then
+    echo "failed"
+    exit 1
+  fi
+  echo "OK"
+  echo -n "  * Running..."
+  if ! ./build/ch -m 16 -r 2000 > runlog.txt
+  then
+    echo "failed"
+    cat runlog.txt
+    exit 1
+  fi
+  mv -f runlog.txt ${1}_run.txt
+  echo "OK"
+}
+
+test cfg1 "USE_LWIP_CEILING=no"
+test cfg2 "USE_LWIP_CEILING=yes"
+test cfg3 "USE_LWIP_CEILING=yes USE_MUTEXES=no"
+
+make clean > /dev/null
+rm -f buildlog.txt
@@ -0,0 +1,293 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#include "lwip/opt.h"
+#include "lwip/init.h"
+#include "lwip/api.h"
+#include "lwip/tcp.h"
+#include "lwip/tcpip.h"
+
+#define BENCH_PORT          5001U
+#define SERVER_WA_SIZE      THD_WORKING_AREA_SIZE(4096)
+#define MAX_CHUNK           8192U
+#define MSG_SIZE            32U
+
+/*
+ * Run parameters, see usage().
+ */
+static uint32_t megabytes = 64U;
+static uint32_t chunk = 1024U;
+static uint32_t rounds = 20000U;
+
+static uint8_t txbuf[MAX_CHUNK];
+static volatile uint32_t received;
+
+/*
+ * Host monotonic time in nanoseconds.
+ */
+static uint64_t host_time_ns(void) {
+  struct timespec ts;
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static void fail(const char *reason) {
+
+  printf("\nFinal result: FAILURE (%s)\n", reason);
+  exit(1);
+}
+
+static void nodelay(struct netconn *conn) {
+
+  LOCK_TCPIP_CORE();
+  tcp_nagle_disable(conn->pcb.tcp);
+  UNLOCK_TCPIP_CORE();
+}
+
+/*------------------------------------------------------------------------*
+ * Server threads.                                                        *
+ *------------------------------------------------------------------------*/
+
+/*
+ * Accepts a single connection and discards the received data.
+ */
+static THD_FUNCTION(sink_thread, arg) {
+  struct netconn *listener = (struct netconn *)arg;
+  struct netconn *conn;
+  struct netbuf *nb;
+
+  chRegSetThreadName("sink");
+  received = 0U;
+  if (netconn_accept(listener, &conn) == ERR_OK) {
+    while (netconn_recv(conn, &nb) == ERR_OK) {
+      received += netbuf_len(nb);
+      netbuf_delete(nb);
+    }
+    (void) netconn_close(conn);
+    (void) netconn_delete(conn);
+  }
+}
+
+/*
+ * Accepts a single connection and echoes back the received data.
+ */
+static THD_FUNCTION(echo_thread, arg) {
+  struct netconn *listener = (struct netconn *)arg;
+  struct netconn *conn;
+  struct netbuf *nb;
+  void *data;
+  u16_t len;
+
+  chRegSetThreadName("echo");
+  if (netconn_accept(listener, &conn) == ERR_OK) {
+    nodelay(conn);
+    while (netconn_recv(conn, &nb) == ERR_OK) {
+      do {
+        (void) netbuf_data(nb, &data, &len);
+        (void) netconn_write(conn, data, len, NETCONN_COPY);
+      } while (netbuf_next(nb) >= 0);
+      netbuf_delete(nb);
+    }
+    (void) netconn_close(conn);
+    (void) netconn_delete(conn);
+  }
+}
+
+/*
+ * Connects to the local server started with the specified thread function.
+ */
+static struct netconn *bench_connect(tfunc_t server, thread_t **tpp,
+                                     struct netconn **listenerp) {
+  struct netconn *listener, *conn;
+  ip_addr_t addr;
+
+  listener = netconn_new(NETCONN_TCP);
+  if ((listener == NULL) ||
+      (netconn_bind(listener, IP_ADDR_ANY, BENCH_PORT) != ERR_OK) ||
+      (netconn_listen(listener) != ERR_OK)) {
+    fail("listen");
+  }
+  *tpp = chThdCreateFromHeap(NULL, SERVER_WA_SIZE, "server",
+                             NORMALPRIO, server, listener);
+  if (*tpp == NULL) {
+    fail("out of memory");
+  }
+
+  IP_ADDR4(&addr, 127, 0, 0, 1);
+  conn = netconn_new(NETCONN_TCP);
+  if ((conn == NULL) || (netconn_connect(conn, &addr, BENCH_PORT) != ERR_OK)) {
+    fail("connect");
+  }
+  *listenerp = listener;
+
+  return conn;
+}
+
+static void bench_close(struct netconn *conn, thread_t *tp,
+                        struct netconn *listener) {
+
+  (void) netconn_close(conn);
+  (void) netconn_delete(conn);
+  chThdWait(tp);
+  (void) netconn_delete(listener);
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+
+static void tcpip_init_done(void *arg) {
+
+  chSemSignal((semaphore_t *)arg);
+}
+
+static void usage(const char *name) {
+
+  printf("Usage: %s [-m megabytes] [-s chunk] [-r rounds]\n", name);
+  printf("  -m  megabytes streamed (%" PRIu32 ")\n", megabytes);
+  printf("  -s  bytes per write, up to %u (%" PRIu32 ")\n", MAX_CHUNK, chunk);
+  printf("  -r  request/response rounds (%" PRIu32 ")\n", rounds);
+  exit(2);
+}
+
+int main(int argc, char *argv[]) {
+  struct netconn *listener, *conn;
+  struct netbuf *nb;
+  semaphore_t sem;
+  thread_t *tp;
+  uint64_t start, elapsed, total, sent;
+  uint32_t i, n;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "m:s:r:h")) != -1) {
+    switch (opt) {
+    case 'm':
+      megabytes = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 's':
+      chunk = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'r':
+      rounds = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+  if ((megabytes == 0U) || (chunk == 0U) || (chunk > MAX_CHUNK) ||
+      (rounds == 0U)) {
+    usage(argv[0]);
+  }
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  /*
+   * lwIP initialization, the loopback interface is created by the stack.
+   */
+  chSemObjectInit(&sem, 0);
+  tcpip_init(tcpip_init_done, &sem);
+  chSemWait(&sem);
+
+  printf("*** ChibiOS/RT lwIP loopback benchmark\n");
+  printf("***\n");
+  printf("*** Kernel:       %s\n", CH_KERNEL_VERSION);
+#ifdef PORT_COMPILER_NAME
+  printf("*** Compiler:     %s\n", PORT_COMPILER_NAME);
+#endif
+  printf("*** Platform:     %s\n", PLATFORM_NAME);
+  printf("*** lwIP:         %s\n", LWIP_VERSION_STRING);
+#if CH_LWIP_USE_PRIORITY_CEILING
+  printf("*** Protection:   priority ceiling\n");
+#else
+  printf("*** Protection:   critical zone\n");
+#endif
+  printf("*** Megabytes:    %" PRIu32 "\n", megabytes);
+  printf("*** Chunk:        %" PRIu32 "\n", chunk);
+  printf("*** Rounds:       %" PRIu32 "\n", rounds);
+  printf("\n");
+  fflush(stdout);
+
+  /*
+   * Stream, the client writes to a sink as fast as possible.
+   */
+  total = (uint64_t)megabytes * 1024U * 1024U;
+  conn = bench_connect(sink_thread, &tp, &listener);
+  start = host_time_ns();
+  for (sent = 0U; sent < total; sent += n) {
+    n = (total - sent) < chunk ? (uint32_t)(total - sent) : chunk;
+    if (netconn_write(conn, txbuf, n, NETCONN_COPY) != ERR_OK) {
+      fail("write");
+    }
+  }
+  bench_close(conn, tp, listener);
+  elapsed = ((host_time_ns() - start) / 1000U) + 1U;   /* Microseconds.*/
+  if (received != total) {
+    fail("data lost");
+  }
+
+  printf("Stream, throughput\n");
+  printf("  Megabytes/s:   %" PRIu64 "\n",
+         ((total * 1000000U) / elapsed) / (1024U * 1024U));
+
+  /*
+   * Request/response, small messages echoed back one at a time.
+   */
+  conn = bench_connect(echo_thread, &tp, &listener);
+  nodelay(conn);
+  start = host_time_ns();
+  for (i = 0U; i < rounds; i++) {
+    if (netconn_write(conn, txbuf, MSG_SIZE, NETCONN_COPY) != ERR_OK) {
+      fail("write");
+    }
+    n = 0U;
+    while (n < MSG_SIZE) {
+      if (netconn_recv(conn, &nb) != ERR_OK) {
+        fail("read");
+      }
+      n += netbuf_len(nb);
+      netbuf_delete(nb);
+    }
+  }
+  elapsed = host_time_ns() - start;
+  bench_close(conn, tp, listener);
+
+  printf("Request/response, nanoseconds per round\n");
+  printf("  %u bytes:      %" PRIu64 "\n", MSG_SIZE, elapsed / rounds);
+
+  printf("\nFinal result: SUCCESS\n");
+  fflush(stdout);
+
+  return 0;
+}
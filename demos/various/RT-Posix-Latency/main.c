@@ -0,0 +1,363 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <unistd.h>
+
+#include "ch.h"
+#include "hal.h"
+
+#if SIM_USE_SYNTHETIC_IRQ != TRUE
+#error "this demo requires SIM_USE_SYNTHETIC_IRQ"
+#endif
+
+/*
+ * Histogram buckets width and number, latencies beyond the last bucket are
+ * accumulated into an overflow bucket.
+ */
+#define HIST_BUCKET_NS      1000U
+#define HIST_BUCKETS        1000U
+
+#define FLYBACK_WA_SIZE     THD_WORKING_AREA_SIZE(4096)
+#define SERVER_WA_SIZE      THD_WORKING_AREA_SIZE(4096)
+#define LOAD_WA_SIZE        THD_WORKING_AREA_SIZE(4096)
+#define MAX_LOAD_THREADS    16U
+
+typedef struct {
+  uint32_t              buckets[HIST_BUCKETS + 1U];
+  uint32_t              n;
+  uint64_t              min;
+  uint64_t              max;
+  uint64_t              sum;
+} histogram_t;
+
+/*
+ * Run parameters, see usage().
+ */
+static uint32_t period_us = 250U;
+static uint32_t duration_s = 5U;
+static uint32_t load_threads = 2U;
+static uint32_t load_work = 2000U;
+static uint64_t limit_ns = 0U;
+static bool csv = false;
+
+static histogram_t isr_hist;
+static histogram_t thd_hist;
+static uint32_t irq_count;
+static uint32_t missed_wakeups;
+static uint64_t flyback_raised;
+static thread_reference_t flyback_trp;
+static thread_t *server_tp;
+static volatile uint32_t load_sink;
+
+/*------------------------------------------------------------------------*
+ * Histograms.                                                            *
+ *------------------------------------------------------------------------*/
+
+static void hist_add(histogram_t *hp, uint64_t ns) {
+  uint64_t i = ns / HIST_BUCKET_NS;
+
+  if (i > HIST_BUCKETS) {
+    i = HIST_BUCKETS;
+  }
+  hp->buckets[i]++;
+  if ((hp->n == 0U) || (ns < hp->min)) {
+    hp->min = ns;
+  }
+  if (ns > hp->max) {
+    hp->max = ns;
+  }
+  hp->sum += ns;
+  hp->n++;
+}
+
+/*
+ * Returns the upper bound of the bucket containing the specified percentile,
+ * expressed in tenths of percent, clamped to the maximum observed value.
+ */
+static uint64_t hist_percentile(const histogram_t *hp, uint32_t permille) {
+  uint64_t target = (((uint64_t)hp->n * permille) + 999U) / 1000U;
+  uint64_t cnt = 0U;
+  uint32_t i;
+
+  for (i = 0U; i < HIST_BUCKETS; i++) {
+    cnt += hp->buckets[i];
+    if (cnt >= target) {
+      uint64_t ns = (uint64_t)(i + 1U) * HIST_BUCKET_NS;
+      return ns < hp->max ? ns : hp->max;
+    }
+  }
+  return hp->max;
+}
+
+static void hist_print(const char *name, const histogram_t *hp) {
+
+  if (hp->n == 0U) {
+    printf("%-16s no samples\n", name);
+    return;
+  }
+  printf("%-16s n=%" PRIu32 " min=%" PRIu64 " avg=%" PRIu64
+         " p50=%" PRIu64 " p90=%" PRIu64 " p99=%" PRIu64
+         " p99.9=%" PRIu64 " max=%" PRIu64 "\n",
+         name, hp->n, hp->min, hp->sum / hp->n,
+         hist_percentile(hp, 500U), hist_percentile(hp, 900U),
+         hist_percentile(hp, 990U), hist_percentile(hp, 999U), hp->max);
+}
+
+static void hist_print_csv(void) {
+  uint32_t i;
+
+  printf("bucket_ns,isr,thread\n");
+  for (i = 0U; i <= HIST_BUCKETS; i++) {
+    if ((isr_hist.buckets[i] != 0U) || (thd_hist.buckets[i] != 0U)) {
+      printf("%" PRIu32 ",%" PRIu32 ",%" PRIu32 "\n",
+             i * HIST_BUCKET_NS, isr_hist.buckets[i], thd_hist.buckets[i]);
+    }
+  }
+}
+
+/*------------------------------------------------------------------------*
+ * Synthetic interrupt and flyback thread.                                *
+ *------------------------------------------------------------------------*/
+
+/*
+ * Synthetic interrupt handler, it measures the time from the host signal
+ * and wakes up the flyback thread.
+ */
+static void latency_irq(uint64_t raised) {
+
+  hist_add(&isr_hist, sim_get_host_time_ns() - raised);
+  irq_count++;
+
+  chSysLockFromISR();
+  if (flyback_trp != NULL) {
+    flyback_raised = raised;
+    chThdResumeI(&flyback_trp, MSG_OK);
+  }
+  else {
+    missed_wakeups++;
+  }
+  chSysUnlockFromISR();
+}
+
+/*
+ * Highest priority thread, it measures the time from the host signal to its
+ * own wakeup.
+ */
+static THD_FUNCTION(flyback_thread, arg) {
+
+  (void)arg;
+  while (true) {
+    uint64_t now;
+    msg_t msg;
+
+    chSysLock();
+    msg = chThdSuspendS(&flyback_trp);
+    now = sim_get_host_time_ns();
+    chSysUnlock();
+
+    if (msg != MSG_OK) {
+      break;
+    }
+    hist_add(&thd_hist, now - flyback_raised);
+  }
+}
+
+/*------------------------------------------------------------------------*
+ * Load.                                                                  *
+ *------------------------------------------------------------------------*/
+
+/*
+ * Messages server, it keeps the scheduler busy switching among the load
+ * threads.
+ */
+static THD_FUNCTION(server_thread, arg) {
+
+  (void)arg;
+  while (!chThdShouldTerminateX()) {
+    thread_t *tp = chMsgWait();
+    chMsgRelease(tp, chMsgGet(tp));
+  }
+}
+
+/*
+ * Load thread, interrupts are only recognized at the end of each computation
+ * step so the step length models the longest interrupts-masked code path.
+ */
+static THD_FUNCTION(load_thread, arg) {
+
+  (void)arg;
+  while (!chThdShouldTerminateX()) {
+    uint32_t i;
+
+    for (i = 0U; i < load_work; i++) {
+      load_sink += i;
+    }
+    _sim_check_for_interrupts();
+
+    (void) chMsgSend(server_tp, (msg_t)i);
+  }
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+
+static void usage(const char *name) {
+
+  printf("Usage: %s [-p period_us] [-d seconds] [-l threads] [-w work] "
+         "[-t limit_us] [-c]\n", name);
+  printf("  -p  synthetic interrupts period in microseconds (%" PRIu32 ")\n",
+         period_us);
+  printf("  -d  measurement duration in seconds (%" PRIu32 ")\n", duration_s);
+  printf("  -l  number of load threads, up to %u (%" PRIu32 ")\n",
+         MAX_LOAD_THREADS, load_threads);
+  printf("  -w  load iterations between interrupt checks (%" PRIu32 ")\n",
+         load_work);
+  printf("  -t  failure threshold for the p99 wakeup latency in "
+         "microseconds\n");
+  printf("  -c  print the histograms in CSV format\n");
+  exit(2);
+}
+
+int main(int argc, char *argv[]) {
+  thread_t *loads[MAX_LOAD_THREADS];
+  thread_t *flyback_tp;
+  uint32_t i;
+  int status, opt;
+
+  while ((opt = getopt(argc, argv, "p:d:l:w:t:ch")) != -1) {
+    switch (opt) {
+    case 'p':
+      period_us = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'd':
+      duration_s = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'l':
+      load_threads = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 'w':
+      load_work = (uint32_t)strtoul(optarg, NULL, 0);
+      break;
+    case 't':
+      limit_ns = (uint64_t)strtoul(optarg, NULL, 0) * 1000U;
+      break;
+    case 'c':
+      csv = true;
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+  if ((period_us == 0U) || (duration_s == 0U) ||
+      (load_threads > MAX_LOAD_THREADS)) {
+    usage(argv[0]);
+  }
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  printf("*** ChibiOS/RT interrupt latency harness\n");
+  printf("***\n");
+  printf("*** Kernel:       %s\n", CH_KERNEL_VERSION);
+#ifdef PORT_COMPILER_NAME
+  printf("*** Compiler:     %s\n", PORT_COMPILER_NAME);
+#endif
+  printf("*** Platform:     %s\n", PLATFORM_NAME);
+  printf("*** Period:       %" PRIu32 " us\n", period_us);
+  printf("*** Duration:     %" PRIu32 " s\n", duration_s);
+  printf("*** Load:         %" PRIu32 " threads, %" PRIu32 " iterations\n",
+         load_threads, load_work);
+  printf("\n");
+  fflush(stdout);
+
+  /*
+   * Threads creation, the flyback thread is above everything else, the
+   * load threads are below the main thread.
+   */
+  flyback_tp = chThdCreateFromHeap(NULL, FLYBACK_WA_SIZE, "flyback",
+                                   NORMALPRIO + 10, flyback_thread, NULL);
+  server_tp = chThdCreateFromHeap(NULL, SERVER_WA_SIZE, "server",
+                                  NORMALPRIO - 1, server_thread, NULL);
+  for (i = 0U; i < load_threads; i++) {
+    loads[i] = chThdCreateFromHeap(NULL, LOAD_WA_SIZE, "load",
+                                   NORMALPRIO - 2, load_thread, NULL);
+  }
+
+  /*
+   * Measurement window.
+   */
+  sim_irq_start(period_us, latency_irq);
+  chThdSleepSeconds(duration_s);
+  sim_irq_stop();
+
+  /*
+   * Threads termination.
+   */
+  for (i = 0U; i < load_threads; i++) {
+    chThdTerminate(loads[i]);
+  }
+  for (i = 0U; i < load_threads; i++) {
+    chThdWait(loads[i]);
+  }
+  chThdTerminate(server_tp);
+  (void) chMsgSend(server_tp, MSG_OK);
+  chThdWait(server_tp);
+  chSysLock();
+  chThdResumeS(&flyback_trp, MSG_RESET);
+  chSysUnlock();
+  chThdWait(flyback_tp);
+
+  /*
+   * Report.
+   */
+  printf("Interrupts:      %" PRIu32 "\n", irq_count);
+  printf("Overruns:        %" PRIu32 "\n", sim_irq_get_overruns());
+  printf("Missed wakeups:  %" PRIu32 "\n", missed_wakeups);
+  printf("Latencies in nanoseconds, %u ns histogram buckets\n",
+         HIST_BUCKET_NS);
+  hist_print("ISR", &isr_hist);
+  hist_print("Thread wakeup", &thd_hist);
+  if (csv) {
+    hist_print_csv();
+  }
+
+  status = 0;
+  if (thd_hist.n == 0U) {
+    printf("\nFinal result: FAILURE (no samples)\n");
+    status = 1;
+  }
+  else if ((limit_ns > 0U) && (hist_percentile(&thd_hist, 990U) > limit_ns)) {
+    printf("\nFinal result: FAILURE (p99 above %" PRIu64 " ns)\n", limit_ns);
+    status = 1;
+  }
+  else {
+    printf("\nFinal result: SUCCESS\n");
+  }
+  fflush(stdout);
+
+  return status;
+}
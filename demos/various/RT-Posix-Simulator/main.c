@@ -29,18 +29,46 @@ static thread_t *cdtp;
 static thread_t *shelltp1;
 static thread_t *shelltp2;
 
+#if SHELL_USE_ASYNC_COMMANDS == TRUE
+#define JOBS_WA_SIZE        THD_WORKING_AREA_SIZE(4096)
+#define JOBS_QUEUE_SIZE     4
+
+/*
+ * Jobs queue executing the shell background commands.
+ */
+static jobs_queue_t jobs;
+static job_descriptor_t jobs_descriptors[JOBS_QUEUE_SIZE];
+static msg_t jobs_messages[JOBS_QUEUE_SIZE];
+
+static THD_FUNCTION(jobs_thread, arg) {
+  msg_t msg;
+
+  (void)arg;
+
+  do {
+    msg = chJobDispatch(&jobs);
+  } while (msg == MSG_OK);
+}
+#endif
+
 static const ShellCommand commands[] = {
   {NULL, NULL}
 };
 
 static const ShellConfig shell_cfg1 = {
   (BaseSequentialStream *)&SD1,
-  commands
+  commands,
+#if SHELL_USE_ASYNC_COMMANDS == TRUE
+  &jobs
+#endif
 };
 
 static const ShellConfig shell_cfg2 = {
   (BaseSequentialStream *)&SD2,
-  commands
+  commands,
+#if SHELL_USE_ASYNC_COMMANDS == TRUE
+  &jobs
+#endif
 };
 
 /*
@@ -181,6 +209,17 @@ int main(void) {
   cdtp = chThdCreateFromHeap(NULL, CONSOLE_WA_SIZE, "console",
                              NORMALPRIO + 1, console_thread, NULL);
 
+#if SHELL_USE_ASYNC_COMMANDS == TRUE
+  /*
+   * Jobs queue and two worker threads for the shells background commands.
+   */
+  chJobObjectInit(&jobs, JOBS_QUEUE_SIZE, jobs_descriptors, jobs_messages);
+  (void) chThdCreateFromHeap(NULL, JOBS_WA_SIZE, "jobs1",
+                             NORMALPRIO, jobs_thread, NULL);
+  (void) chThdCreateFromHeap(NULL, JOBS_WA_SIZE, "jobs2",
+                             NORMALPRIO, jobs_thread, NULL);
+#endif
+
   /*
    * Initializing connection/disconnection events.
    */
@@ -68,17 +68,13 @@ __STATIC_INLINE sysinterval_t tmo(uint32_t millisec) {
 
 /**
  * @brief   Virtual timers common callback.
+ * @note    Periodic timers use continuous virtual timers, there is no
+ *          need to re-arm them here.
  */
 static void timer_cb(void const *arg) {
 
   osTimerId timer_id = (osTimerId)arg;
   timer_id->ptimer(timer_id->argument);
-  if (timer_id->type == osTimerPeriodic) {
-    chSysLockFromISR();
-    chVTDoSetI(&timer_id->vt, TIME_MS2I(timer_id->millisec),
-               (vtfunc_t)timer_cb, timer_id);
-    chSysUnlockFromISR();
-  }
 }
 
 /*===========================================================================*/
@@ -285,7 +281,13 @@ osStatus osTimerStart(osTimerId timer_id, uint32_t millisec) {
   }
 
   timer_id->millisec = millisec;
-  chVTSet(&timer_id->vt, TIME_MS2I(millisec), (vtfunc_t)timer_cb, timer_id);
+  if (timer_id->type == osTimerPeriodic) {
+    chVTSetContinuous(&timer_id->vt, TIME_MS2I(millisec),
+                      (vtfunc_t)timer_cb, timer_id);
+  }
+  else {
+    chVTSet(&timer_id->vt, TIME_MS2I(millisec), (vtfunc_t)timer_cb, timer_id);
+  }
 
   return osOK;
 }
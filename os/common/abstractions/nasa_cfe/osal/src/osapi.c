@@ -79,6 +79,46 @@
 #define MIN_QUEUE_DEPTH     1
 #define MAX_QUEUE_DEPTH     16384
 
+/**
+ * @name    Objects identifiers layout
+ * @details Identifiers are composed of an object type, a generation number
+ *          incremented each time a table slot is reused and the slot
+ *          index. Stale identifiers of deleted objects are detected because
+ *          the generation no more matches the one stored in the table.
+ * @{
+ */
+#define ID_TYPE_TIMER       1U
+#define ID_TYPE_QUEUE       2U
+#define ID_TYPE_BINSEM      3U
+#define ID_TYPE_COUNTSEM    4U
+#define ID_TYPE_MUTEX       5U
+
+#define ID_TYPE_POS         28U
+#define ID_GEN_POS          16U
+#define ID_GEN_MASK         0x0FFFU
+#define ID_INDEX_MASK       0xFFFFU
+
+#define ID_MAKE(type, gen, index)                                           \
+  (((uint32)(type) << ID_TYPE_POS) |                                        \
+   (((uint32)(gen) & ID_GEN_MASK) << ID_GEN_POS) |                          \
+   ((uint32)(index) & ID_INDEX_MASK))
+#define ID_TYPE(id)         ((uint32)(id) >> ID_TYPE_POS)
+#define ID_GEN(id)          (((uint32)(id) >> ID_GEN_POS) & ID_GEN_MASK)
+#define ID_INDEX(id)        ((uint32)(id) & ID_INDEX_MASK)
+/** @} */
+
+/**
+ * @brief   Size of a queue message buffer.
+ */
+#define QUEUE_MSG_SIZE(data_size)                                           \
+  MEM_ALIGN_NEXT((data_size) + sizeof (size_t), PORT_NATURAL_ALIGN)
+
+#if (OS_MAX_TIMERS > 65535) || (OS_MAX_QUEUES > 65535) ||                   \
+    (OS_MAX_BIN_SEMAPHORES > 65535) || (OS_MAX_COUNT_SEMAPHORES > 65535) || \
+    (OS_MAX_MUTEXES > 65535)
+#error "OSAL objects tables limited to 65535 elements"
+#endif
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -96,7 +136,6 @@ typedef void (*funcptr_t)(void);
  * @brief   Type of OSAL timer.
  */
 typedef struct {
-  uint32                is_free;
   char                  name[OS_MAX_API_NAME];
   OS_TimerCallback_t    callback_ptr;
   uint32                start_time;
@@ -108,7 +147,6 @@ typedef struct {
  * @brief   Type of an OSAL queue.
  */
 typedef struct {
-  uint32                is_free;
   char                  name[OS_MAX_API_NAME];
   semaphore_t           free_msgs;
   memory_pool_t         messages;
@@ -145,6 +183,13 @@ typedef struct {
   binary_semaphore_t    binary_semaphores[OS_MAX_BIN_SEMAPHORES];
   semaphore_t           count_semaphores[OS_MAX_COUNT_SEMAPHORES];
   mutex_t               mutexes[OS_MAX_MUTEXES];
+  uint32                timers_ids[OS_MAX_TIMERS];
+  uint32                queues_ids[OS_MAX_QUEUES];
+  uint32                binary_semaphores_ids[OS_MAX_BIN_SEMAPHORES];
+  uint32                count_semaphores_ids[OS_MAX_COUNT_SEMAPHORES];
+  uint32                mutexes_ids[OS_MAX_MUTEXES];
+  uint32                timers_names[OS_MAX_TIMERS * 2];
+  uint32                queues_names[OS_MAX_QUEUES * 2];
 } osal_t;
 
 /*===========================================================================*/
@@ -161,7 +206,8 @@ static osal_t osal;
  * @brief   System time callback.
  */
 static void systime_update(void *p) {
-  sysinterval_t delay = (sysinterval_t)p;
+
+  (void)p;
 
   chSysLockFromISR();
   osal.localtime.microsecs += 1000;
@@ -169,75 +215,298 @@ static void systime_update(void *p) {
     osal.localtime.microsecs = 0;
     osal.localtime.seconds++;
   }
-  chVTDoSetI(&osal.vt, delay, systime_update, p);
   chSysUnlockFromISR();
 }
 
+/**
+ * @brief   Assigns a new identifier to a table slot.
+ * @details The generation number of the slot is incremented.
+ */
+static uint32 id_assign(uint32 *ids, uint32 type, uint32 index) {
+  uint32 id = ID_MAKE(type, ID_GEN(ids[index]) + 1U, index);
+
+  ids[index] = id;
+
+  return id;
+}
+
+/**
+ * @brief   Invalidates the identifier of a table slot.
+ * @details The type is cleared while the generation number is retained
+ *          for the next assignment.
+ */
+static void id_release(uint32 *ids, uint32 id) {
+
+  ids[ID_INDEX(id)] = id & ~((uint32)0xFU << ID_TYPE_POS);
+}
+
+/**
+ * @brief   Verifies an identifier against its table.
+ *
+ * @return              The slot index or -1 if the identifier is not valid.
+ */
+static int32 id_check(const uint32 *ids, uint32 n, uint32 type, uint32 id) {
+  uint32 index = ID_INDEX(id);
+
+  if ((ID_TYPE(id) != type) || (index >= n) || (ids[index] != id)) {
+    return -1;
+  }
+
+  return (int32)index;
+}
+
+/**
+ * @brief   Returns the timer associated to an identifier.
+ */
+static osal_timer_t *timer_get(uint32 timer_id) {
+  int32 i = id_check(osal.timers_ids, OS_MAX_TIMERS,
+                     ID_TYPE_TIMER, timer_id);
+
+  return i < 0 ? NULL : &osal.timers[i];
+}
+
+/**
+ * @brief   Returns the queue associated to an identifier.
+ */
+static osal_queue_t *queue_get(uint32 queue_id) {
+  int32 i = id_check(osal.queues_ids, OS_MAX_QUEUES,
+                     ID_TYPE_QUEUE, queue_id);
+
+  return i < 0 ? NULL : &osal.queues[i];
+}
+
+/**
+ * @brief   Returns the message containing a queue buffer.
+ *
+ * @return              The message or @p NULL if the buffer does not
+ *                      belong to the queue.
+ */
+static osal_message_t *queue_msg(osal_queue_t *oqp, void *data) {
+  uint8 *p = (uint8 *)data - offsetof(osal_message_t, buf);
+  uint8 *base = (uint8 *)oqp->mb_buffer;
+  size_t msgsize = QUEUE_MSG_SIZE(oqp->size);
+
+  if ((p < base) || (p >= base + (msgsize * (size_t)oqp->depth)) ||
+      (((size_t)(p - base) % msgsize) != 0U)) {
+    return NULL;
+  }
+
+  return (osal_message_t *)p;
+}
+
+/**
+ * @brief   Returns the binary semaphore associated to an identifier.
+ */
+static binary_semaphore_t *binsem_get(uint32 sem_id) {
+  int32 i = id_check(osal.binary_semaphores_ids, OS_MAX_BIN_SEMAPHORES,
+                     ID_TYPE_BINSEM, sem_id);
+
+  return i < 0 ? NULL : &osal.binary_semaphores[i];
+}
+
+/**
+ * @brief   Returns the counter semaphore associated to an identifier.
+ */
+static semaphore_t *countsem_get(uint32 sem_id) {
+  int32 i = id_check(osal.count_semaphores_ids, OS_MAX_COUNT_SEMAPHORES,
+                     ID_TYPE_COUNTSEM, sem_id);
+
+  return i < 0 ? NULL : &osal.count_semaphores[i];
+}
+
+/**
+ * @brief   Returns the mutex associated to an identifier.
+ */
+static mutex_t *mutex_get(uint32 sem_id) {
+  int32 i = id_check(osal.mutexes_ids, OS_MAX_MUTEXES,
+                     ID_TYPE_MUTEX, sem_id);
+
+  return i < 0 ? NULL : &osal.mutexes[i];
+}
+
+/**
+ * @brief   Hash function for objects names.
+ */
+static uint32 name_hash(const char *name) {
+  uint32 h = 2166136261U;
+  unsigned i;
+
+  /* FNV-1a on the significant part of the name.*/
+  for (i = 0U; (i < OS_MAX_API_NAME - 1U) && (name[i] != '\0'); i++) {
+    h = (h ^ (uint32)(uint8)name[i]) * 16777619U;
+  }
+
+  return h;
+}
+
+/**
+ * @brief   Finds an object identifier in a names hash table.
+ * @details The table is an open addressing hash table with linear probing
+ *          containing the identifiers of the named objects, names are
+ *          retrieved from the objects table. There are no deleted slots
+ *          markers so a search never probes beyond the cluster of the
+ *          name.
+ * @note    Must be called from within a critical zone.
+ *
+ * @param[in] names     the names hash table
+ * @param[in] n         size of the names hash table
+ * @param[in] base      address of the name of the first object in the table
+ * @param[in] stride    size of the objects
+ * @param[in] name      name to be searched
+ * @return              The object identifier or zero if not found.
+ */
+static uint32 name_find(const uint32 *names, uint32 n,
+                        const char *base, size_t stride, const char *name) {
+  uint32 i, h = name_hash(name) % n;
+
+  for (i = 0U; i < n; i++) {
+    uint32 id = names[(h + i) % n];
+
+    if (id == 0U) {
+      break;
+    }
+    if (strncmp(base + (ID_INDEX(id) * stride), name,
+                OS_MAX_API_NAME - 1) == 0) {
+      return id;
+    }
+  }
+
+  return 0U;
+}
+
+/**
+ * @brief   Adds an object identifier to a names hash table.
+ * @note    The table is twice the size of the objects table so there is
+ *          always a free slot.
+ * @note    Must be called from within a critical zone.
+ */
+static void name_insert(uint32 *names, uint32 n,
+                        uint32 id, const char *name) {
+  uint32 i, h = name_hash(name) % n;
+
+  for (i = 0U; i < n; i++) {
+    uint32 *p = &names[(h + i) % n];
+
+    if (*p == 0U) {
+      *p = id;
+      return;
+    }
+  }
+
+  chDbgAssert(false, "names table full");
+}
+
+/**
+ * @brief   Removes an object identifier from a names hash table.
+ * @details The following entries of the same cluster are moved back into
+ *          the freed slot when their probe sequence crosses it, this way
+ *          no deleted slots markers are left in the table and searches
+ *          do not degrade after many deletions.
+ * @note    Must be called from within a critical zone.
+ */
+static void name_remove(uint32 *names, uint32 n,
+                        const char *base, size_t stride,
+                        uint32 id, const char *name) {
+  uint32 i, j, k;
+
+  /* Searching the identifier in the cluster, the table is twice the size
+     of the objects table so there is always a free slot ending it.*/
+  i = name_hash(name) % n;
+  while (names[i] != id) {
+    if (names[i] == 0U) {
+      chDbgAssert(false, "name not found");
+      return;
+    }
+    i = (i + 1U) % n;
+  }
+
+  names[i] = 0U;
+  j = i;
+  while (true) {
+    j = (j + 1U) % n;
+    if (names[j] == 0U) {
+      return;
+    }
+
+    /* Home slot of the entry, it stays where it is if the home is
+       cyclically within (i, j].*/
+    k = name_hash(base + (ID_INDEX(names[j]) * stride)) % n;
+    if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j))) {
+      continue;
+    }
+
+    /* Moving the entry into the free slot, its own slot becomes the
+       free one.*/
+    names[i] = names[j];
+    names[j] = 0U;
+    i = j;
+  }
+}
+
 /**
  * @brief   Virtual timers callback.
+ * @note    Timers with an interval are continuous virtual timers, there
+ *          is no need to re-arm them here.
  */
 static void timer_handler(void *p) {
   osal_timer_t *otp = (osal_timer_t *)p;
 
   /* Real callback.*/
-  otp->callback_ptr((uint32)p);
+  otp->callback_ptr(osal.timers_ids[otp - &osal.timers[0]]);
+}
+
+/**
+ * @brief   Converts a timer time in microseconds to system ticks.
+ * @note    A non-zero time is never converted to zero ticks, a zero reload
+ *          interval would silently turn a periodic timer into a one-shot
+ *          timer.
+ */
+static sysinterval_t timer_ticks(uint32 usecs) {
+  sysinterval_t ticks = TIME_US2I(usecs);
 
-  /* Timer restart if an interval is defined.*/
-  if (otp->interval_time != 0) {
-    chSysLockFromISR();
-    chVTSetI(&otp->vt, TIME_US2I(otp->interval_time), timer_handler, p);
-    chSysUnlockFromISR();
+  if ((usecs > 0U) && (ticks == (sysinterval_t)0)) {
+    ticks = (sysinterval_t)1;
   }
+
+  return ticks;
 }
 
 /**
  * @brief   Finds a queue by name.
  */
 uint32 queue_find(const char *queue_name) {
-  osal_queue_t *oqp;
+  uint32 id;
 
-  /* Searching the queue in the table.*/
-  for (oqp = &osal.queues[0]; oqp < &osal.queues[OS_MAX_QUEUES]; oqp++) {
-    /* Entering a reentrant critical zone.*/
-    syssts_t sts = chSysGetStatusAndLockX();
+  /* Entering a reentrant critical zone.*/
+  syssts_t sts = chSysGetStatusAndLockX();
 
-    if (!oqp->is_free &&
-        (strncmp(oqp->name, queue_name, OS_MAX_API_NAME - 1) == 0)) {
-      /* Leaving the critical zone.*/
-      chSysRestoreStatusX(sts);
-      return (uint32)oqp;
-    }
+  /* Searching the queue in the names table.*/
+  id = name_find(osal.queues_names, OS_MAX_QUEUES * 2,
+                 osal.queues[0].name, sizeof (osal_queue_t), queue_name);
 
-    /* Leaving the critical zone.*/
-    chSysRestoreStatusX(sts);
-  }
+  /* Leaving the critical zone.*/
+  chSysRestoreStatusX(sts);
 
-  return 0;
+  return id;
 }
 
 /**
  * @brief   Finds a timer by name.
  */
 uint32 timer_find(const char *timer_name) {
-  osal_timer_t *otp;
+  uint32 id;
 
-  /* Searching the queue in the table.*/
-  for (otp = &osal.timers[0]; otp < &osal.timers[OS_MAX_TIMERS]; otp++) {
-    /* Entering a reentrant critical zone.*/
-    syssts_t sts = chSysGetStatusAndLockX();
+  /* Entering a reentrant critical zone.*/
+  syssts_t sts = chSysGetStatusAndLockX();
 
-    if (!otp->is_free &&
-        (strncmp(otp->name, timer_name, OS_MAX_API_NAME - 1) == 0)) {
-      /* Leaving the critical zone.*/
-      chSysRestoreStatusX(sts);
-      return (uint32)otp;
-    }
+  /* Searching the timer in the names table.*/
+  id = name_find(osal.timers_names, OS_MAX_TIMERS * 2,
+                 osal.timers[0].name, sizeof (osal_timer_t), timer_name);
 
-    /* Leaving the critical zone.*/
-    chSysRestoreStatusX(sts);
-  }
+  /* Leaving the critical zone.*/
+  chSysRestoreStatusX(sts);
 
-  return 0;
+  return id;
 }
 
 /*===========================================================================*/
@@ -268,7 +537,16 @@ int32 OS_API_Init(void) {
   osal.localtime.microsecs = 0;
   osal.localtime.seconds   = 0;
   chVTObjectInit(&osal.vt);
-  chVTSet(&osal.vt, TIME_MS2I(1), systime_update, (void *)TIME_MS2I(1));
+  chVTSetContinuous(&osal.vt, TIME_MS2I(1), systime_update, NULL);
+
+  /* Objects identifiers and names tables initialization.*/
+  memset(osal.timers_ids, 0, sizeof osal.timers_ids);
+  memset(osal.queues_ids, 0, sizeof osal.queues_ids);
+  memset(osal.binary_semaphores_ids, 0, sizeof osal.binary_semaphores_ids);
+  memset(osal.count_semaphores_ids, 0, sizeof osal.count_semaphores_ids);
+  memset(osal.mutexes_ids, 0, sizeof osal.mutexes_ids);
+  memset(osal.timers_names, 0, sizeof osal.timers_names);
+  memset(osal.queues_names, 0, sizeof osal.queues_names);
 
   /* Timers pool initialization.*/
   chPoolObjectInit(&osal.timers_pool,
@@ -485,9 +763,14 @@ int32 OS_TimerCreate(uint32 *timer_id, const char *timer_name,
   otp->start_time    = 0;
   otp->interval_time = 0;
   otp->callback_ptr  = callback_ptr;
-  otp->is_free       = 0;   /* Note, last.*/
 
-  *timer_id = (uint32)otp;
+  /* Making the timer visible, note, last.*/
+  chSysLock();
+  *timer_id = id_assign(osal.timers_ids, ID_TYPE_TIMER,
+                        (uint32)(otp - &osal.timers[0]));
+  name_insert(osal.timers_names, OS_MAX_TIMERS * 2, *timer_id, otp->name);
+  chSysUnlock();
+
   *clock_accuracy = (uint32)(1000000 / CH_CFG_ST_FREQUENCY);
 
   return OS_SUCCESS;
@@ -502,26 +785,29 @@ int32 OS_TimerCreate(uint32 *timer_id, const char *timer_name,
  * @api
  */
 int32 OS_TimerDelete(uint32 timer_id) {
-  osal_timer_t *otp = (osal_timer_t *)timer_id;
+  osal_timer_t *otp;
 
-  /* Range check.*/
-  if ((otp < &osal.timers[0]) ||
-      (otp >= &osal.timers[OS_MAX_TIMERS]) ||
-      (otp->is_free)) {
+  chSysLock();
+
+  /* Identifier check.*/
+  otp = timer_get(timer_id);
+  if (otp == NULL) {
+    chSysUnlock();
     return OS_ERR_INVALID_ID;
   }
 
-  chSysLock();
-
-  /* Marking as no more free, will be overwritten by the pool pointer.*/
-  otp->is_free = 1;
+  /* Invalidating the identifier and the name.*/
+  name_remove(osal.timers_names, OS_MAX_TIMERS * 2,
+              osal.timers[0].name, sizeof (osal_timer_t),
+              timer_id, otp->name);
+  id_release(osal.timers_ids, timer_id);
 
   /* Resetting the timer.*/
   chVTResetI(&otp->vt);
   otp->start_time    = 0;
   otp->interval_time = 0;
 
-  /* Flagging it as unused and returning it to the pool.*/
+  /* Returning it to the pool.*/
   chPoolFreeI(&osal.timers_pool, (void *)otp);
 
   chSysUnlock();
@@ -542,25 +828,30 @@ int32 OS_TimerDelete(uint32 timer_id) {
  */
 int32 OS_TimerSet(uint32 timer_id, uint32 start_time, uint32 interval_time) {
   syssts_t sts;
-  osal_timer_t *otp = (osal_timer_t *)timer_id;
-
-  /* Range check.*/
-  if ((otp < &osal.timers[0]) ||
-      (otp >= &osal.timers[OS_MAX_TIMERS]) ||
-      (otp->is_free)) {
-    return OS_ERR_INVALID_ID;
-  }
+  osal_timer_t *otp;
 
   /* Entering a reentrant critical zone.*/
   sts = chSysGetStatusAndLockX();
 
+  /* Identifier check.*/
+  otp = timer_get(timer_id);
+  if (otp == NULL) {
+    /* Leaving the critical zone.*/
+    chSysRestoreStatusX(sts);
+    return OS_ERR_INVALID_ID;
+  }
+
   if (start_time == 0) {
     chVTResetI(&otp->vt);
   }
   else {
     otp->start_time    = start_time;
     otp->interval_time = interval_time;
-    chVTSetI(&otp->vt, TIME_US2I(start_time), timer_handler, (void *)timer_id);
+    chVTSetI(&otp->vt, timer_ticks(start_time), timer_handler, (void *)otp);
+
+    /* Following expirations are periodic, if an interval is defined, an
+       interval shorter than a tick is rounded up to one tick.*/
+    chVTSetReloadIntervalX(&otp->vt, timer_ticks(interval_time));
   }
 
   /* Leaving the critical zone.*/
@@ -611,25 +902,19 @@ int32 OS_TimerGetIdByName(uint32 *timer_id, const char *timer_name) {
  */
 int32 OS_TimerGetInfo(uint32 timer_id, OS_timer_prop_t *timer_prop) {
   syssts_t sts;
-  osal_timer_t *otp = (osal_timer_t *)timer_id;
+  osal_timer_t *otp;
 
   /* NULL pointer checks.*/
   if (timer_prop == NULL) {
     return OS_INVALID_POINTER;
   }
 
-  /* Range check.*/
-  if ((otp < &osal.timers[0]) ||
-      (otp >= &osal.timers[OS_MAX_TIMERS]) ||
-      (otp->is_free)) {
-    return OS_ERR_INVALID_ID;
-  }
-
   /* Entering a reentrant critical zone.*/
   sts = chSysGetStatusAndLockX();
 
   /* If the timer is not in use then error.*/
-  if (otp->is_free) {
+  otp = timer_get(timer_id);
+  if (otp == NULL) {
     /* Leaving the critical zone.*/
     chSysRestoreStatusX(sts);
     return OS_ERR_INVALID_ID;
@@ -700,12 +985,13 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
   }
 
   /* Attempting messages buffer allocation.*/
-  msgsize = MEM_ALIGN_NEXT(data_size + sizeof (size_t), PORT_NATURAL_ALIGN);
+  msgsize = QUEUE_MSG_SIZE(data_size);
   oqp->mb_buffer = chHeapAllocAligned(NULL,
                                       msgsize * (size_t)queue_depth,
                                       PORT_NATURAL_ALIGN);
   if (oqp->mb_buffer == NULL) {
     *queue_id = 0;
+    chPoolFree(&osal.queues_pool, (void *)oqp);
     return OS_ERROR;
   }
 
@@ -716,6 +1002,7 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
   if (oqp->q_buffer == NULL) {
     *queue_id = 0;
     chHeapFree(oqp->mb_buffer);
+    chPoolFree(&osal.queues_pool, (void *)oqp);
     return OS_ERROR;
   }
 
@@ -727,14 +1014,22 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
   chPoolLoadArray(&oqp->messages, oqp->mb_buffer, (size_t)queue_depth);
   oqp->depth   = queue_depth;
   oqp->size    = data_size;
-  oqp->is_free = 0;   /* Note, last.*/
-  *queue_id = (uint32)oqp;
+
+  /* Making the queue visible, note, last.*/
+  chSysLock();
+  *queue_id = id_assign(osal.queues_ids, ID_TYPE_QUEUE,
+                        (uint32)(oqp - &osal.queues[0]));
+  name_insert(osal.queues_names, OS_MAX_QUEUES * 2, *queue_id, oqp->name);
+  chSysUnlock();
 
   return OS_SUCCESS;
 }
 
 /**
  * @brief   Queue deletion.
+ * @note    Buffers obtained using @p OS_QueueAllocBuffer() or
+ *          @p OS_QueueGetBuffer() and not yet returned to the queue become
+ *          invalid.
  *
  * @param[in] queue_id          queue id variable
  * @return                      An error code.
@@ -742,21 +1037,24 @@ int32 OS_QueueCreate(uint32 *queue_id, const char *queue_name,
  * @api
  */
 int32 OS_QueueDelete(uint32 queue_id) {
-  osal_queue_t *oqp = (osal_queue_t *)queue_id;
+  osal_queue_t *oqp;
   void *q_buffer, *mb_buffer;
 
-  /* Range check.*/
-  if ((oqp < &osal.queues[0]) ||
-      (oqp >= &osal.queues[OS_MAX_QUEUES]) ||
-      (oqp->is_free)) {
-    return OS_ERR_INVALID_ID;
-  }
-
   /* Critical zone.*/
   chSysLock();
 
-  /* Marking as no more free, will be overwritten by the pool pointer.*/
-  oqp->is_free = 1;
+  /* Identifier check.*/
+  oqp = queue_get(queue_id);
+  if (oqp == NULL) {
+    chSysUnlock();
+    return OS_ERR_INVALID_ID;
+  }
+
+  /* Invalidating the identifier and the name.*/
+  name_remove(osal.queues_names, OS_MAX_QUEUES * 2,
+              osal.queues[0].name, sizeof (osal_queue_t),
+              queue_id, oqp->name);
+  id_release(osal.queues_ids, queue_id);
 
   /* Pointers to areas to be freed.*/
   q_buffer  = oqp->q_buffer;
@@ -766,7 +1064,7 @@ int32 OS_QueueDelete(uint32 queue_id) {
   chMBResetI(&oqp->mb);
   chSemResetI(&oqp->free_msgs, 0);
 
-  /* Flagging it as unused and returning it to the pool.*/
+  /* Returning it to the pool.*/
   chPoolFreeI(&osal.queues_pool, (void *)oqp);
 
   chSchRescheduleS();
@@ -796,19 +1094,18 @@ int32 OS_QueueDelete(uint32 queue_id) {
  */
 int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size,
                   uint32 *size_copied, int32 timeout) {
-  osal_queue_t *oqp = (osal_queue_t *)queue_id;
-  msg_t msg, msgsts;
+  osal_queue_t *oqp;
   void *body;
+  int32 err;
 
   /* NULL pointer checks.*/
   if ((data == NULL) || (size_copied == NULL)) {
     return OS_INVALID_POINTER;
   }
 
-  /* Range check.*/
-  if ((oqp < &osal.queues[0]) ||
-      (oqp >= &osal.queues[OS_MAX_QUEUES]) ||
-      (oqp->is_free)) {
+  /* Identifier check.*/
+  oqp = queue_get(queue_id);
+  if (oqp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -817,41 +1114,17 @@ int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size,
     return OS_QUEUE_INVALID_SIZE;
   }
 
-  /* Special time handling.*/
-  if (timeout == OS_PEND) {
-    msgsts = chMBFetchTimeout(&oqp->mb, &msg, TIME_INFINITE);
-    if (msgsts < MSG_OK) {
-      *size_copied = 0;
-      return OS_ERROR;
-    }
-  }
-  else if (timeout == OS_CHECK) {
-    msgsts = chMBFetchTimeout(&oqp->mb, &msg, TIME_IMMEDIATE);
-    if (msgsts < MSG_OK) {
-      *size_copied = 0;
-      return OS_QUEUE_EMPTY;
-    }
-  }
-  else {
-    msgsts = chMBFetchTimeout(&oqp->mb, &msg, (sysinterval_t)timeout);
-    if (msgsts < MSG_OK) {
-      *size_copied = 0;
-      return OS_QUEUE_TIMEOUT;
-    }
+  /* Getting the message.*/
+  err = OS_QueueGetBuffer(queue_id, &body, size_copied, timeout);
+  if (err != OS_SUCCESS) {
+    return err;
   }
 
-  /* Message body and size.*/
-  *size_copied = ((osal_message_t *)msg)->size;
-  body  = (void *)((osal_message_t *)msg)->buf;
-
   /* Copying the message body.*/
   memcpy(data, body, *size_copied);
 
   /* Freeing the message buffer.*/
-  chPoolFree(&oqp->messages, (void *)msg);
-  chSemSignal(&oqp->free_msgs);
-
-  return OS_SUCCESS;
+  return OS_QueueReleaseBuffer(queue_id, body);
 }
 
 /**
@@ -866,9 +1139,9 @@ int32 OS_QueueGet(uint32 queue_id, void *data, uint32 size,
  * @api
  */
 int32 OS_QueuePut(uint32 queue_id, void *data, uint32 size, uint32 flags) {
-  osal_queue_t *oqp = (osal_queue_t *)queue_id;
-  msg_t msgsts;
-  osal_message_t *omsg;
+  osal_queue_t *oqp;
+  void *body;
+  int32 err;
 
   (void)flags;
 
@@ -877,10 +1150,9 @@ int32 OS_QueuePut(uint32 queue_id, void *data, uint32 size, uint32 flags) {
     return OS_INVALID_POINTER;
   }
 
-  /* Range check.*/
-  if ((oqp < &osal.queues[0]) ||
-      (oqp >= &osal.queues[OS_MAX_QUEUES]) ||
-      (oqp->is_free)) {
+  /* Identifier check.*/
+  oqp = queue_get(queue_id);
+  if (oqp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -890,23 +1162,16 @@ int32 OS_QueuePut(uint32 queue_id, void *data, uint32 size, uint32 flags) {
   }
 
   /* Getting a message buffer from the pool.*/
-  msgsts = chSemWait(&oqp->free_msgs);
-  if (msgsts < MSG_OK) {
+  err = OS_QueueAllocBuffer(queue_id, &body, OS_PEND);
+  if (err != OS_SUCCESS) {
     return OS_ERROR;
   }
-  omsg = chPoolAlloc(&oqp->messages);
 
-  /* Filling message size and data.*/
-  omsg->size = (size_t)size;
-  memcpy(omsg->buf, data, size);
+  /* Filling message data.*/
+  memcpy(body, data, size);
 
   /* Posting the message.*/
-  msgsts = chMBPostTimeout(&oqp->mb, (msg_t)omsg, TIME_INFINITE);
-  if (msgsts < MSG_OK) {
-    return OS_ERROR;
-  }
-
-  return OS_SUCCESS;
+  return OS_QueuePutBuffer(queue_id, body, size);
 }
 
 /**
@@ -950,7 +1215,7 @@ int32 OS_QueueGetIdByName(uint32 *queue_id, const char *queue_name) {
  * @api
  */
 int32 OS_QueueGetInfo (uint32 queue_id, OS_queue_prop_t *queue_prop) {
-  osal_queue_t *oqp = (osal_queue_t *)queue_id;
+  osal_queue_t *oqp;
   syssts_t sts;
 
   /* NULL pointer checks.*/
@@ -958,18 +1223,12 @@ int32 OS_QueueGetInfo (uint32 queue_id, OS_queue_prop_t *queue_prop) {
     return OS_INVALID_POINTER;
   }
 
-  /* Range check.*/
-  if ((oqp < &osal.queues[0]) ||
-      (oqp >= &osal.queues[OS_MAX_QUEUES]) ||
-      (oqp->is_free)) {
-    return OS_ERR_INVALID_ID;
-  }
-
   /* Entering a reentrant critical zone.*/
   sts = chSysGetStatusAndLockX();
 
   /* If the queue is not in use then error.*/
-  if (oqp->is_free) {
+  oqp = queue_get(queue_id);
+  if (oqp == NULL) {
     /* Leaving the critical zone.*/
     chSysRestoreStatusX(sts);
     return OS_ERR_INVALID_ID;
@@ -982,8 +1241,216 @@ int32 OS_QueueGetInfo (uint32 queue_id, OS_queue_prop_t *queue_prop) {
   chSysRestoreStatusX(sts);
 
   return OS_SUCCESS;
+}
 
-  return OS_ERR_NOT_IMPLEMENTED;
+/**
+ * @brief   Allocates a message buffer from the queue.
+ * @details The buffer is owned by the caller until it is posted using
+ *          @p OS_QueuePutBuffer(), this allows to build a message in place
+ *          without an intermediate copy.
+ *
+ * @param[in] queue_id          queue id variable
+ * @param[out] data             pointer to the message buffer, the buffer
+ *                              size is the queue maximum message size
+ * @param[in] timeout           timeout in ticks, the special values @p OS_PEND
+ *                              and @p OS_CHECK can be specified
+ * @return                      An error code.
+ *
+ * @api
+ */
+int32 OS_QueueAllocBuffer(uint32 queue_id, void **data, int32 timeout) {
+  osal_queue_t *oqp;
+  osal_message_t *omsg;
+  msg_t msgsts;
+
+  /* NULL pointer checks.*/
+  if (data == NULL) {
+    return OS_INVALID_POINTER;
+  }
+
+  /* Identifier check.*/
+  oqp = queue_get(queue_id);
+  if (oqp == NULL) {
+    return OS_ERR_INVALID_ID;
+  }
+
+  /* Special time handling.*/
+  if (timeout == OS_PEND) {
+    msgsts = chSemWaitTimeout(&oqp->free_msgs, TIME_INFINITE);
+    if (msgsts < MSG_OK) {
+      return OS_ERROR;
+    }
+  }
+  else if (timeout == OS_CHECK) {
+    msgsts = chSemWaitTimeout(&oqp->free_msgs, TIME_IMMEDIATE);
+    if (msgsts < MSG_OK) {
+      return OS_QUEUE_FULL;
+    }
+  }
+  else {
+    msgsts = chSemWaitTimeout(&oqp->free_msgs, (sysinterval_t)timeout);
+    if (msgsts < MSG_OK) {
+      return OS_QUEUE_TIMEOUT;
+    }
+  }
+  omsg = chPoolAlloc(&oqp->messages);
+
+  *data = (void *)omsg->buf;
+
+  return OS_SUCCESS;
+}
+
+/**
+ * @brief   Posts a message buffer into the queue.
+ * @details The buffer ownership passes to the queue, the buffer must have
+ *          been obtained using @p OS_QueueAllocBuffer() on the same queue.
+ *
+ * @param[in] queue_id          queue id variable
+ * @param[in] data              pointer to the message buffer
+ * @param[in] size              size of the message
+ * @return                      An error code.
+ *
+ * @api
+ */
+int32 OS_QueuePutBuffer(uint32 queue_id, void *data, uint32 size) {
+  osal_queue_t *oqp;
+  osal_message_t *omsg;
+  msg_t msgsts;
+
+  /* NULL pointer checks.*/
+  if (data == NULL) {
+    return OS_INVALID_POINTER;
+  }
+
+  /* Identifier check.*/
+  oqp = queue_get(queue_id);
+  if (oqp == NULL) {
+    return OS_ERR_INVALID_ID;
+  }
+
+  /* Check on maximum size.*/
+  if (size > oqp->size) {
+    return OS_QUEUE_INVALID_SIZE;
+  }
+
+  /* The buffer must belong to the queue.*/
+  omsg = queue_msg(oqp, data);
+  if (omsg == NULL) {
+    return OS_ERROR;
+  }
+
+  /* Filling message size.*/
+  omsg->size = (size_t)size;
+
+  /* Posting the message, there is always space in the mailbox because the
+     buffer has been taken from the queue.*/
+  msgsts = chMBPostTimeout(&oqp->mb, (msg_t)omsg, TIME_INFINITE);
+  if (msgsts < MSG_OK) {
+    return OS_ERROR;
+  }
+
+  return OS_SUCCESS;
+}
+
+/**
+ * @brief   Retrieves a message buffer from the queue.
+ * @details The message is not copied, the buffer is owned by the caller
+ *          until it is returned to the queue using
+ *          @p OS_QueueReleaseBuffer().
+ *
+ * @param[in] queue_id          queue id variable
+ * @param[out] data             pointer to the message buffer
+ * @param[out] size             size of the received message
+ * @param[in] timeout           timeout in ticks, the special values @p OS_PEND
+ *                              and @p OS_CHECK can be specified
+ * @return                      An error code.
+ *
+ * @api
+ */
+int32 OS_QueueGetBuffer(uint32 queue_id, void **data, uint32 *size,
+                        int32 timeout) {
+  osal_queue_t *oqp;
+  msg_t msg, msgsts;
+
+  /* NULL pointer checks.*/
+  if ((data == NULL) || (size == NULL)) {
+    return OS_INVALID_POINTER;
+  }
+
+  /* Identifier check.*/
+  oqp = queue_get(queue_id);
+  if (oqp == NULL) {
+    return OS_ERR_INVALID_ID;
+  }
+
+  /* Special time handling.*/
+  if (timeout == OS_PEND) {
+    msgsts = chMBFetchTimeout(&oqp->mb, &msg, TIME_INFINITE);
+    if (msgsts < MSG_OK) {
+      *size = 0;
+      return OS_ERROR;
+    }
+  }
+  else if (timeout == OS_CHECK) {
+    msgsts = chMBFetchTimeout(&oqp->mb, &msg, TIME_IMMEDIATE);
+    if (msgsts < MSG_OK) {
+      *size = 0;
+      return OS_QUEUE_EMPTY;
+    }
+  }
+  else {
+    msgsts = chMBFetchTimeout(&oqp->mb, &msg, (sysinterval_t)timeout);
+    if (msgsts < MSG_OK) {
+      *size = 0;
+      return OS_QUEUE_TIMEOUT;
+    }
+  }
+
+  /* Message body and size.*/
+  *size = (uint32)((osal_message_t *)msg)->size;
+  *data = (void *)((osal_message_t *)msg)->buf;
+
+  return OS_SUCCESS;
+}
+
+/**
+ * @brief   Returns a message buffer to the queue.
+ * @details The buffer can be either a buffer obtained using
+ *          @p OS_QueueGetBuffer() or a buffer allocated using
+ *          @p OS_QueueAllocBuffer() and not posted.
+ *
+ * @param[in] queue_id          queue id variable
+ * @param[in] data              pointer to the message buffer
+ * @return                      An error code.
+ *
+ * @api
+ */
+int32 OS_QueueReleaseBuffer(uint32 queue_id, void *data) {
+  osal_queue_t *oqp;
+  osal_message_t *omsg;
+
+  /* NULL pointer checks.*/
+  if (data == NULL) {
+    return OS_INVALID_POINTER;
+  }
+
+  /* Identifier check.*/
+  oqp = queue_get(queue_id);
+  if (oqp == NULL) {
+    return OS_ERR_INVALID_ID;
+  }
+
+  /* The buffer must belong to the queue.*/
+  omsg = queue_msg(oqp, data);
+  if (omsg == NULL) {
+    return OS_ERROR;
+  }
+
+  /* Freeing the message buffer.*/
+  chPoolFree(&oqp->messages, (void *)omsg);
+  chSemSignal(&oqp->free_msgs);
+
+  return OS_SUCCESS;
 }
 
 /*-- Binary Semaphore API ---------------------------------------------------*/
@@ -1029,7 +1496,8 @@ int32 OS_BinSemCreate(uint32 *sem_id, const char *sem_name,
   /* Semaphore is initialized.*/
   chBSemObjectInit(bsp, sem_initial_value == 0 ? true : false);
 
-  *sem_id = (uint32)bsp;
+  *sem_id = id_assign(osal.binary_semaphores_ids, ID_TYPE_BINSEM,
+                      (uint32)(bsp - &osal.binary_semaphores[0]));
 
   return OS_SUCCESS;
 }
@@ -1043,11 +1511,10 @@ int32 OS_BinSemCreate(uint32 *sem_id, const char *sem_name,
  * @api
  */
 int32 OS_BinSemDelete(uint32 sem_id) {
-  binary_semaphore_t *bsp = (binary_semaphore_t *)sem_id;
+  binary_semaphore_t *bsp = binsem_get(sem_id);
 
-  /* Range check.*/
-  if ((bsp < &osal.binary_semaphores[0]) ||
-      (bsp >= &osal.binary_semaphores[OS_MAX_BIN_SEMAPHORES])) {
+  /* Identifier check.*/
+  if (bsp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1056,8 +1523,8 @@ int32 OS_BinSemDelete(uint32 sem_id) {
   /* Resetting the semaphore, no threads in queue.*/
   chBSemResetI(bsp, true);
 
-  /* Flagging it as unused and returning it to the pool.*/
-  bsp->sem.queue.prev = NULL;
+  /* Invalidating the identifier and returning it to the pool.*/
+  id_release(osal.binary_semaphores_ids, sem_id);
   chPoolFreeI(&osal.binary_semaphores_pool, (void *)bsp);
 
   /* Required because some thread could have been made ready.*/
@@ -1080,11 +1547,10 @@ int32 OS_BinSemDelete(uint32 sem_id) {
  */
 int32 OS_BinSemFlush(uint32 sem_id) {
   syssts_t sts;
-  binary_semaphore_t *bsp = (binary_semaphore_t *)sem_id;
+  binary_semaphore_t *bsp = binsem_get(sem_id);
 
-  /* Range check.*/
-  if ((bsp < &osal.binary_semaphores[0]) ||
-      (bsp >= &osal.binary_semaphores[OS_MAX_BIN_SEMAPHORES])) {
+  /* Identifier check.*/
+  if (bsp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1092,7 +1558,7 @@ int32 OS_BinSemFlush(uint32 sem_id) {
   sts = chSysGetStatusAndLockX();
 
   /* If the semaphore is not in use then error.*/
-  if (bsp->sem.queue.prev == NULL) {
+  if (binsem_get(sem_id) == NULL) {
     /* Leaving the critical zone.*/
     chSysRestoreStatusX(sts);
     return OS_SEM_FAILURE;
@@ -1120,11 +1586,10 @@ int32 OS_BinSemFlush(uint32 sem_id) {
  */
 int32 OS_BinSemGive(uint32 sem_id) {
   syssts_t sts;
-  binary_semaphore_t *bsp = (binary_semaphore_t *)sem_id;
+  binary_semaphore_t *bsp = binsem_get(sem_id);
 
-  /* Range check.*/
-  if ((bsp < &osal.binary_semaphores[0]) ||
-      (bsp >= &osal.binary_semaphores[OS_MAX_BIN_SEMAPHORES])) {
+  /* Identifier check.*/
+  if (bsp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1132,7 +1597,7 @@ int32 OS_BinSemGive(uint32 sem_id) {
   sts = chSysGetStatusAndLockX();
 
   /* If the semaphore is not in use then error.*/
-  if (bsp->sem.queue.prev == NULL) {
+  if (binsem_get(sem_id) == NULL) {
     /* Leaving the critical zone.*/
     chSysRestoreStatusX(sts);
     return OS_SEM_FAILURE;
@@ -1155,18 +1620,17 @@ int32 OS_BinSemGive(uint32 sem_id) {
  * @api
  */
 int32 OS_BinSemTake(uint32 sem_id) {
-  binary_semaphore_t *bsp = (binary_semaphore_t *)sem_id;
+  binary_semaphore_t *bsp = binsem_get(sem_id);
 
-  /* Range check.*/
-  if ((bsp < &osal.binary_semaphores[0]) ||
-      (bsp >= &osal.binary_semaphores[OS_MAX_BIN_SEMAPHORES])) {
+  /* Identifier check.*/
+  if (bsp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
   chSysLock();
 
   /* If the semaphore is not in use then error.*/
-  if (bsp->sem.queue.prev == NULL) {
+  if (binsem_get(sem_id) == NULL) {
     chSysUnlock();
     return OS_SEM_FAILURE;
   }
@@ -1188,12 +1652,11 @@ int32 OS_BinSemTake(uint32 sem_id) {
  * @api
  */
 int32 OS_BinSemTimedWait(uint32 sem_id, uint32 msecs) {
-  binary_semaphore_t *bsp = (binary_semaphore_t *)sem_id;
+  binary_semaphore_t *bsp = binsem_get(sem_id);
   msg_t msg;
 
-  /* Range check.*/
-  if ((bsp < &osal.binary_semaphores[0]) ||
-      (bsp >= &osal.binary_semaphores[OS_MAX_BIN_SEMAPHORES])) {
+  /* Identifier check.*/
+  if (bsp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1205,7 +1668,7 @@ int32 OS_BinSemTimedWait(uint32 sem_id, uint32 msecs) {
   chSysLock();
 
   /* If the semaphore is not in use then error.*/
-  if (bsp->sem.queue.prev == NULL) {
+  if (binsem_get(sem_id) == NULL) {
     chSysUnlock();
     return OS_SEM_FAILURE;
   }
@@ -1255,16 +1718,15 @@ int32 OS_BinSemGetIdByName(uint32 *sem_id, const char *sem_name) {
  */
 int32 OS_BinSemGetInfo(uint32 sem_id, OS_bin_sem_prop_t *bin_prop) {
   syssts_t sts;
-  binary_semaphore_t *bsp = (binary_semaphore_t *)sem_id;
+  binary_semaphore_t *bsp = binsem_get(sem_id);
 
   /* NULL pointer checks.*/
   if (bin_prop == NULL) {
     return OS_INVALID_POINTER;
   }
 
-  /* Range check.*/
-  if ((bsp < &osal.binary_semaphores[0]) ||
-      (bsp >= &osal.binary_semaphores[OS_MAX_BIN_SEMAPHORES])) {
+  /* Identifier check.*/
+  if (bsp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1272,7 +1734,7 @@ int32 OS_BinSemGetInfo(uint32 sem_id, OS_bin_sem_prop_t *bin_prop) {
   sts = chSysGetStatusAndLockX();
 
   /* If the semaphore is not in use then error.*/
-  if (bsp->sem.queue.prev == NULL) {
+  if (binsem_get(sem_id) == NULL) {
     /* Leaving the critical zone.*/
     chSysRestoreStatusX(sts);
     return OS_ERR_INVALID_ID;
@@ -1327,7 +1789,8 @@ int32 OS_CountSemCreate(uint32 *sem_id, const char *sem_name,
   /* Semaphore is initialized.*/
   chSemObjectInit(sp, (cnt_t)sem_initial_value);
 
-  *sem_id = (uint32)sp;
+  *sem_id = id_assign(osal.count_semaphores_ids, ID_TYPE_COUNTSEM,
+                      (uint32)(sp - &osal.count_semaphores[0]));
 
   return OS_SUCCESS;
 }
@@ -1341,11 +1804,10 @@ int32 OS_CountSemCreate(uint32 *sem_id, const char *sem_name,
  * @api
  */
 int32 OS_CountSemDelete(uint32 sem_id) {
-  semaphore_t *sp = (semaphore_t *)sem_id;
+  semaphore_t *sp = countsem_get(sem_id);
 
-  /* Range check.*/
-  if ((sp < &osal.count_semaphores[0]) ||
-      (sp >= &osal.count_semaphores[OS_MAX_COUNT_SEMAPHORES])) {
+  /* Identifier check.*/
+  if (sp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1354,8 +1816,8 @@ int32 OS_CountSemDelete(uint32 sem_id) {
   /* Resetting the semaphore, no threads in queue.*/
   chSemResetI(sp, 0);
 
-  /* Flagging it as unused and returning it to the pool.*/
-  sp->queue.prev = NULL;
+  /* Invalidating the identifier and returning it to the pool.*/
+  id_release(osal.count_semaphores_ids, sem_id);
   chPoolFreeI(&osal.count_semaphores_pool, (void *)sp);
 
   /* Required because some thread could have been made ready.*/
@@ -1377,11 +1839,10 @@ int32 OS_CountSemDelete(uint32 sem_id) {
  */
 int32 OS_CountSemGive(uint32 sem_id) {
   syssts_t sts;
-  semaphore_t *sp = (semaphore_t *)sem_id;
+  semaphore_t *sp = countsem_get(sem_id);
 
-  /* Range check.*/
-  if ((sp < &osal.count_semaphores[0]) ||
-      (sp >= &osal.count_semaphores[OS_MAX_COUNT_SEMAPHORES])) {
+  /* Identifier check.*/
+  if (sp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1389,7 +1850,7 @@ int32 OS_CountSemGive(uint32 sem_id) {
   sts = chSysGetStatusAndLockX();
 
   /* If the semaphore is not in use then error.*/
-  if (sp->queue.prev == NULL) {
+  if (countsem_get(sem_id) == NULL) {
     /* Leaving the critical zone.*/
     chSysRestoreStatusX(sts);
     return OS_SEM_FAILURE;
@@ -1412,18 +1873,17 @@ int32 OS_CountSemGive(uint32 sem_id) {
  * @api
  */
 int32 OS_CountSemTake(uint32 sem_id) {
-  semaphore_t *sp = (semaphore_t *)sem_id;
+  semaphore_t *sp = countsem_get(sem_id);
 
-  /* Range check.*/
-  if ((sp < &osal.count_semaphores[0]) ||
-      (sp >= &osal.count_semaphores[OS_MAX_COUNT_SEMAPHORES])) {
+  /* Identifier check.*/
+  if (sp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
   chSysLock();
 
   /* If the semaphore is not in use then error.*/
-  if (sp->queue.prev == NULL) {
+  if (countsem_get(sem_id) == NULL) {
     chSysUnlock();
     return OS_SEM_FAILURE;
   }
@@ -1445,12 +1905,11 @@ int32 OS_CountSemTake(uint32 sem_id) {
  * @api
  */
 int32 OS_CountSemTimedWait(uint32 sem_id, uint32 msecs) {
-  semaphore_t *sp = (semaphore_t *)sem_id;
+  semaphore_t *sp = countsem_get(sem_id);
   msg_t msg;
 
-  /* Range check.*/
-  if ((sp < &osal.count_semaphores[0]) ||
-      (sp >= &osal.count_semaphores[OS_MAX_COUNT_SEMAPHORES])) {
+  /* Identifier check.*/
+  if (sp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1462,7 +1921,7 @@ int32 OS_CountSemTimedWait(uint32 sem_id, uint32 msecs) {
   chSysLock();
 
   /* If the semaphore is not in use then error.*/
-  if (sp->queue.prev == NULL) {
+  if (countsem_get(sem_id) == NULL) {
     chSysUnlock();
     return OS_SEM_FAILURE;
   }
@@ -1512,16 +1971,15 @@ int32 OS_CountSemGetIdByName(uint32 *sem_id, const char *sem_name) {
  */
 int32 OS_CountSemGetInfo(uint32 sem_id, OS_count_sem_prop_t *sem_prop) {
   syssts_t sts;
-  semaphore_t *sp = (semaphore_t *)sem_id;
+  semaphore_t *sp = countsem_get(sem_id);
 
   /* NULL pointer checks.*/
   if (sem_prop == NULL) {
     return OS_INVALID_POINTER;
   }
 
-  /* Range check.*/
-  if ((sp < &osal.count_semaphores[0]) ||
-      (sp >= &osal.count_semaphores[OS_MAX_BIN_SEMAPHORES])) {
+  /* Identifier check.*/
+  if (sp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1529,7 +1987,7 @@ int32 OS_CountSemGetInfo(uint32 sem_id, OS_count_sem_prop_t *sem_prop) {
   sts = chSysGetStatusAndLockX();
 
   /* If the semaphore is not in use then error.*/
-  if (sp->queue.prev == NULL) {
+  if (countsem_get(sem_id) == NULL) {
     /* Leaving the critical zone.*/
     chSysRestoreStatusX(sts);
     return OS_ERR_INVALID_ID;
@@ -1577,7 +2035,8 @@ int32 OS_MutSemCreate(uint32 *sem_id, const char *sem_name, uint32 options) {
   /* Semaphore is initialized.*/
   chMtxObjectInit(mp);
 
-  *sem_id = (uint32)mp;
+  *sem_id = id_assign(osal.mutexes_ids, ID_TYPE_MUTEX,
+                      (uint32)(mp - &osal.mutexes[0]));
 
   return OS_SUCCESS;
 }
@@ -1591,11 +2050,10 @@ int32 OS_MutSemCreate(uint32 *sem_id, const char *sem_name, uint32 options) {
  * @api
  */
 int32 OS_MutSemDelete(uint32 sem_id) {
-  mutex_t *mp = (mutex_t *)sem_id;
+  mutex_t *mp = mutex_get(sem_id);
 
-  /* Range check.*/
-  if ((mp < &osal.mutexes[0]) ||
-      (mp >= &osal.mutexes[OS_MAX_MUTEXES])) {
+  /* Identifier check.*/
+  if (mp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1604,8 +2062,8 @@ int32 OS_MutSemDelete(uint32 sem_id) {
   /* Resetting the mutex, no threads in queue.*/
   chMtxUnlockAllS();
 
-  /* Flagging it as unused and returning it to the pool.*/
-  mp->queue.prev = NULL;
+  /* Invalidating the identifier and returning it to the pool.*/
+  id_release(osal.mutexes_ids, sem_id);
   chPoolFreeI(&osal.mutexes_pool, (void *)mp);
 
   /* Required because some thread could have been made ready.*/
@@ -1625,18 +2083,17 @@ int32 OS_MutSemDelete(uint32 sem_id) {
  * @api
  */
 int32 OS_MutSemGive(uint32 sem_id) {
-  mutex_t *mp = (mutex_t *)sem_id;
+  mutex_t *mp = mutex_get(sem_id);
 
-  /* Range check.*/
-  if ((mp < &osal.mutexes[0]) ||
-      (mp >= &osal.mutexes[OS_MAX_COUNT_SEMAPHORES])) {
+  /* Identifier check.*/
+  if (mp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
   chSysLock();
 
   /* If the mutex is not in use then error.*/
-  if (mp->queue.prev == NULL) {
+  if (mutex_get(sem_id) == NULL) {
     chSysUnlock();
     return OS_SEM_FAILURE;
   }
@@ -1658,18 +2115,17 @@ int32 OS_MutSemGive(uint32 sem_id) {
  * @api
  */
 int32 OS_MutSemTake(uint32 sem_id) {
-  mutex_t *mp = (mutex_t *)sem_id;
+  mutex_t *mp = mutex_get(sem_id);
 
-  /* Range check.*/
-  if ((mp < &osal.mutexes[0]) ||
-      (mp >= &osal.mutexes[OS_MAX_COUNT_SEMAPHORES])) {
+  /* Identifier check.*/
+  if (mp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
   chSysLock();
 
   /* If the mutex is not in use then error.*/
-  if (mp->queue.prev == NULL) {
+  if (mutex_get(sem_id) == NULL) {
     chSysUnlock();
     return OS_SEM_FAILURE;
   }
@@ -1719,16 +2175,15 @@ int32 OS_MutSemGetIdByName(uint32 *sem_id, const char *sem_name) {
  */
 int32 OS_MutSemGetInfo(uint32 sem_id, OS_mut_sem_prop_t *sem_prop) {
   syssts_t sts;
-  mutex_t *mp = (mutex_t *)sem_id;
+  mutex_t *mp = mutex_get(sem_id);
 
   /* NULL pointer checks.*/
   if (sem_prop == NULL) {
     return OS_INVALID_POINTER;
   }
 
-  /* Range check.*/
-  if ((mp < &osal.mutexes[0]) ||
-      (mp >= &osal.mutexes[OS_MAX_BIN_SEMAPHORES])) {
+  /* Identifier check.*/
+  if (mp == NULL) {
     return OS_ERR_INVALID_ID;
   }
 
@@ -1736,7 +2191,7 @@ int32 OS_MutSemGetInfo(uint32 sem_id, OS_mut_sem_prop_t *sem_prop) {
   sts = chSysGetStatusAndLockX();
 
   /* If the mutex is not in use then error.*/
-  if (mp->queue.prev == NULL) {
+  if (mutex_get(sem_id) == NULL) {
     /* Leaving the critical zone.*/
     chSysRestoreStatusX(sts);
     return OS_ERR_INVALID_ID;
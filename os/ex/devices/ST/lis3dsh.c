@@ -47,24 +47,77 @@
 /*===========================================================================*/
 
 #if (LIS3DSH_USE_SPI) || defined(__DOXYGEN__)
+#if ((SPI_USE_QUEUE == TRUE) && (SPI_USE_WAIT == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @brief   Executes a register access through the SPI transactions queue.
+ * @details The address and the data phases are queued as a single group,
+ *          other transactions queued on the same bus cannot be inserted
+ *          while the CS line is asserted. The device configuration is
+ *          carried by the transactions so the bus can be shared with other
+ *          queue users.
+ * @pre     The SPI interface must be initialized and the driver started.
+ *
+ * @param[in] spip      pointer to the SPI interface
+ * @param[in] spicfg    SPI configuration of the device
+ * @param[in] cmdp      pointer to the address frame
+ * @param[in] n         number of data frames
+ * @param[in] txbuf     pointer to the data to be written or @p NULL
+ * @param[out] rxbuf    pointer to the data buffer or @p NULL
+ */
+static void lis3dshSPIQueueAccess(SPIDriver *spip, const SPIConfig *spicfg,
+                                  const uint8_t *cmdp, size_t n,
+                                  const uint8_t *txbuf, uint8_t *rxbuf) {
+  spi_transaction_t cmdt, datat;
+
+  cmdt.next   = &datat;
+  cmdt.config = spicfg;
+  cmdt.n      = 1U;
+  cmdt.txbuf  = cmdp;
+  cmdt.rxbuf  = NULL;
+  cmdt.end_cb = NULL;
+  cmdt.prio   = 0U;
+  cmdt.flags  = SPI_TRANSACTION_KEEP_SELECTED;
+  cmdt.state  = SPI_TRANSACTION_IDLE;
+
+  datat.next   = NULL;
+  datat.config = spicfg;
+  datat.n      = n;
+  datat.txbuf  = txbuf;
+  datat.rxbuf  = rxbuf;
+  datat.end_cb = NULL;
+  datat.prio   = 0U;
+  datat.flags  = 0U;
+  datat.state  = SPI_TRANSACTION_IDLE;
+
+  spiQueueTransaction(spip, &cmdt);
+  spiWaitTransaction(spip, &datat);
+}
+#endif /* (SPI_USE_QUEUE == TRUE) && (SPI_USE_WAIT == TRUE) */
+
 /**
  * @brief   Reads a generic register value using SPI.
  * @pre     The SPI interface must be initialized and the driver started.
  * @note    Multiple write/read requires proper settings in CTRL_REG6.
  *
  * @param[in] spip      pointer to the SPI interface
+ * @param[in] spicfg    SPI configuration of the device
  * @param[in] reg       starting register address
  * @param[in] n         number of adjacent registers to write
  * @param[in] b         pointer to a buffer.
  */
-static void lis3dshSPIReadRegister(SPIDriver *spip, uint8_t reg, size_t n,
-                                   uint8_t* b) {
+static void lis3dshSPIReadRegister(SPIDriver *spip, const SPIConfig *spicfg,
+                                   uint8_t reg, size_t n, uint8_t* b) {
   uint8_t cmd;
   cmd = reg | LIS3DSH_RW;
+#if (SPI_USE_QUEUE == TRUE) && (SPI_USE_WAIT == TRUE)
+  lis3dshSPIQueueAccess(spip, spicfg, &cmd, n, NULL, b);
+#else
+  (void)spicfg;
   spiSelect(spip);
   spiSend(spip, 1, &cmd);
   spiReceive(spip, n, b);
   spiUnselect(spip);
+#endif
 }
 
 /**
@@ -73,18 +126,24 @@ static void lis3dshSPIReadRegister(SPIDriver *spip, uint8_t reg, size_t n,
  * @note    Multiple write/read requires proper settings in CTRL_REG6.
  *
  * @param[in] spip      pointer to the SPI interface
+ * @param[in] spicfg    SPI configuration of the device
  * @param[in] reg       starting register address
  * @param[in] n         number of adjacent registers to write
  * @param[in] b         pointer to a buffer of values.
  */
-static void lis3dshSPIWriteRegister(SPIDriver *spip, uint8_t reg, size_t n,
-                                    uint8_t* b) {
+static void lis3dshSPIWriteRegister(SPIDriver *spip, const SPIConfig *spicfg,
+                                    uint8_t reg, size_t n, uint8_t* b) {
   uint8_t cmd;
   cmd = reg;
+#if (SPI_USE_QUEUE == TRUE) && (SPI_USE_WAIT == TRUE)
+  lis3dshSPIQueueAccess(spip, spicfg, &cmd, n, b, NULL);
+#else
+  (void)spicfg;
   spiSelect(spip);
   spiSend(spip, 1, &cmd);
   spiSend(spip, n, b);
   spiUnselect(spip);
+#endif
 }
 #endif /* LIS3DSH_USE_SPI */
 
@@ -141,7 +200,8 @@ static msg_t acc_read_raw(void *ip, int32_t axes[]) {
            devp->config->spicfg);
 #endif /* LIS3DSH_SHARED_SPI */
 
-  lis3dshSPIReadRegister(devp->config->spip, LIS3DSH_AD_OUT_X_L,
+  lis3dshSPIReadRegister(devp->config->spip, devp->config->spicfg,
+                         LIS3DSH_AD_OUT_X_L,
                          LIS3DSH_ACC_NUMBER_OF_AXES * 2, buff);
 
 #if	LIS3DSH_SHARED_SPI
@@ -346,7 +406,7 @@ static msg_t acc_reset_sensivity(void *ip) {
 static msg_t acc_set_full_scale(LIS3DSHDriver *devp, lis3dsh_acc_fs_t fs) {
   float newfs, scale;
   uint8_t i, cr;
-  msg_t msg;
+  msg_t msg = MSG_OK;
 
   osalDbgCheck(devp != NULL);
 
@@ -389,7 +449,8 @@ static msg_t acc_set_full_scale(LIS3DSHDriver *devp, lis3dsh_acc_fs_t fs) {
 #endif /* LIS3DSH_SHARED_SPI */
 
     /* Getting data from register.*/
-    lis3dshSPIReadRegister(devp->config->spip, LIS3DSH_AD_CTRL_REG5, 1, &cr);
+    lis3dshSPIReadRegister(devp->config->spip, devp->config->spicfg,
+                           LIS3DSH_AD_CTRL_REG5, 1, &cr);
 
 #if LIS3DSH_SHARED_SPI
     spiReleaseBus(devp->config->spip);
@@ -407,7 +468,8 @@ static msg_t acc_set_full_scale(LIS3DSHDriver *devp, lis3dsh_acc_fs_t fs) {
 #endif /* LIS3DSH_SHARED_SPI */
 
     /* Getting data from register.*/
-    lis3dshSPIWriteRegister(devp->config->spip, LIS3DSH_AD_CTRL_REG5, 1, &cr);
+    lis3dshSPIWriteRegister(devp->config->spip, devp->config->spicfg,
+                            LIS3DSH_AD_CTRL_REG5, 1, &cr);
 
 #if LIS3DSH_SHARED_SPI
     spiReleaseBus(devp->config->spip);
@@ -490,7 +552,8 @@ void lis3dshStart(LIS3DSHDriver *devp, const LIS3DSHConfig *config) {
 #endif /* LIS3DSH_SHARED_SPI */
   spiStart(devp->config->spip, devp->config->spicfg);
 
-  lis3dshSPIWriteRegister(devp->config->spip, LIS3DSH_AD_CTRL_REG4, 1, &cr);
+  lis3dshSPIWriteRegister(devp->config->spip, devp->config->spicfg,
+                          LIS3DSH_AD_CTRL_REG4, 1, &cr);
 
 #if LIS3DSH_SHARED_SPI
   spiReleaseBus(devp->config->spip);
@@ -511,7 +574,8 @@ void lis3dshStart(LIS3DSHDriver *devp, const LIS3DSHConfig *config) {
   spiStart(devp->config->spip, devp->config->spicfg);
 #endif /* LIS3DSH_SHARED_SPI */
 
-  lis3dshSPIWriteRegister(devp->config->spip, LIS3DSH_AD_CTRL_REG5, 1, &cr);
+  lis3dshSPIWriteRegister(devp->config->spip, devp->config->spicfg,
+                          LIS3DSH_AD_CTRL_REG5, 1, &cr);
 
 #if LIS3DSH_SHARED_SPI
   spiReleaseBus(devp->config->spip);
@@ -532,7 +596,8 @@ void lis3dshStart(LIS3DSHDriver *devp, const LIS3DSHConfig *config) {
   spiStart(devp->config->spip, devp->config->spicfg);
 #endif /* LIS3DSH_SHARED_SPI */
 
-  lis3dshSPIWriteRegister(devp->config->spip, LIS3DSH_AD_CTRL_REG6, 1, &cr);
+  lis3dshSPIWriteRegister(devp->config->spip, devp->config->spicfg,
+                          LIS3DSH_AD_CTRL_REG6, 1, &cr);
 
 #if	LIS3DSH_SHARED_SPI
   spiReleaseBus(devp->config->spip);
@@ -627,8 +692,8 @@ void lis3dshStop(LIS3DSHDriver *devp) {
 #endif /* LIS3DSH_SHARED_SPI */
     /* Disabling all axes and enabling power down mode.*/
     cr4 = 0;
-    lis3dshSPIWriteRegister(devp->config->spip, LIS3DSH_AD_CTRL_REG4,
-                           1, &cr4);
+    lis3dshSPIWriteRegister(devp->config->spip, devp->config->spicfg,
+                            LIS3DSH_AD_CTRL_REG4, 1, &cr4);
 
     spiStop(devp->config->spip);
 #if	LIS3DSH_SHARED_SPI
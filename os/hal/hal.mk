@@ -26,7 +26,8 @@ ifneq ($(findstring HAL_USE_CAN TRUE,$(HALCONF)),)
 HALSRC += $(CHIBIOS)/os/hal/src/hal_can.c
 endif
 ifneq ($(findstring HAL_USE_CRY TRUE,$(HALCONF)),)
-HALSRC += $(CHIBIOS)/os/hal/src/hal_crypto.c
+HALSRC += $(CHIBIOS)/os/hal/src/hal_crypto.c \
+          $(CHIBIOS)/os/hal/src/hal_crypto_fallback.c
 endif
 ifneq ($(findstring HAL_USE_DAC TRUE,$(HALCONF)),)
 HALSRC += $(CHIBIOS)/os/hal/src/hal_dac.c
@@ -101,6 +102,7 @@ HALSRC = $(CHIBIOS)/os/hal/src/hal.c \
          $(CHIBIOS)/os/hal/src/hal_adc.c \
          $(CHIBIOS)/os/hal/src/hal_can.c \
          $(CHIBIOS)/os/hal/src/hal_crypto.c \
+         $(CHIBIOS)/os/hal/src/hal_crypto_fallback.c \
          $(CHIBIOS)/os/hal/src/hal_dac.c \
          $(CHIBIOS)/os/hal/src/hal_efl.c \
          $(CHIBIOS)/os/hal/src/hal_gpt.c \
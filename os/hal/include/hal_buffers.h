@@ -131,6 +131,20 @@ struct io_buffers_queue {
   void                  *link;
 };
 
+/**
+ * @brief   Type of a scatter element for vectored writes.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the data.
+   */
+  const uint8_t         *base;
+  /**
+   * @brief   Size of the data.
+   */
+  size_t                size;
+} bqiovec_t;
+
 /**
  * @brief   Type of an input buffers queue.
  */
@@ -318,6 +332,9 @@ extern "C" {
   msg_t ibqGetTimeout(input_buffers_queue_t *ibqp, sysinterval_t timeout);
   size_t ibqReadTimeout(input_buffers_queue_t *ibqp, uint8_t *bp,
                         size_t n, sysinterval_t timeout);
+  size_t ibqGetViewTimeout(input_buffers_queue_t *ibqp, uint8_t **bpp,
+                           sysinterval_t timeout);
+  void ibqConsume(input_buffers_queue_t *ibqp, size_t n);
   void obqObjectInit(output_buffers_queue_t *obqp, bool suspended, uint8_t *bp,
                      size_t size, size_t n, bqnotify_t onfy, void *link);
   void obqResetI(output_buffers_queue_t *obqp);
@@ -334,6 +351,11 @@ extern "C" {
                       sysinterval_t timeout);
   size_t obqWriteTimeout(output_buffers_queue_t *obqp, const uint8_t *bp,
                          size_t n, sysinterval_t timeout);
+  size_t obqWriteVTimeout(output_buffers_queue_t *obqp, const bqiovec_t *iovp,
+                          size_t iovcnt, sysinterval_t timeout);
+  size_t obqGetViewTimeout(output_buffers_queue_t *obqp, uint8_t **bpp,
+                           sysinterval_t timeout);
+  void obqCommit(output_buffers_queue_t *obqp, size_t n);
   bool obqTryFlushI(output_buffers_queue_t *obqp);
   void obqFlush(output_buffers_queue_t *obqp);
 #ifdef __cplusplus
@@ -31,6 +31,16 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Request states
+ * @{
+ */
+#define CRY_REQUEST_IDLE                    0U  /** @brief Not queued.      */
+#define CRY_REQUEST_QUEUED                  1U  /** @brief Waiting in queue.*/
+#define CRY_REQUEST_ACTIVE                  2U  /** @brief Being executed.  */
+#define CRY_REQUEST_DONE                    3U  /** @brief Completed.       */
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -54,6 +64,14 @@
 #define HAL_CRY_ENFORCE_FALLBACK            FALSE
 #endif
 
+/**
+ * @brief   Enables the requests queue APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(HAL_CRY_USE_QUEUE) || defined(__DOXYGEN__)
+#define HAL_CRY_USE_QUEUE                   FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -107,6 +125,31 @@ typedef enum {
   cry_algo_hmac                             /**< HMAC variable size.        */
 } cryalgorithm_t;
 
+/**
+ * @brief   Type of a queued request operation.
+ */
+typedef enum {
+  cry_op_encrypt_aes_ecb = 0,               /**< AES ECB encryption.        */
+  cry_op_decrypt_aes_ecb,                   /**< AES ECB decryption.        */
+  cry_op_encrypt_aes_cbc,                   /**< AES CBC encryption.        */
+  cry_op_decrypt_aes_cbc,                   /**< AES CBC decryption.        */
+  cry_op_encrypt_aes_cfb,                   /**< AES CFB encryption.        */
+  cry_op_decrypt_aes_cfb,                   /**< AES CFB decryption.        */
+  cry_op_encrypt_aes_ctr,                   /**< AES CTR encryption.        */
+  cry_op_decrypt_aes_ctr,                   /**< AES CTR decryption.        */
+  cry_op_encrypt_aes_gcm,                   /**< AES GCM encryption.        */
+  cry_op_decrypt_aes_gcm,                   /**< AES GCM decryption.        */
+  cry_op_sha256,                            /**< SHA256 digest.             */
+  cry_op_sha512,                            /**< SHA512 digest.             */
+  cry_op_hmac_sha256,                       /**< HMAC-SHA256 digest.        */
+  cry_op_hmac_sha512                        /**< HMAC-SHA512 digest.        */
+} cryoperation_t;
+
+/**
+ * @brief   Type of a structure representing a queued request.
+ */
+typedef struct hal_cry_request cry_request_t;
+
 #if HAL_CRY_ENFORCE_FALLBACK == FALSE
 /* Use the defined low level driver.*/
 #include "hal_crypto_lld.h"
@@ -157,9 +200,19 @@ typedef struct {
 struct CRYDriver {
   crystate_t                state;
   const CRYConfig           *config;
+#if HAL_CRY_USE_QUEUE == TRUE
+  cry_request_t             *rqueue;
+  cry_request_t             *rcurrent;
+#endif
 };
 #endif /* HAL_CRY_ENFORCE_FALLBACK == TRUE */
 
+/* Queued requests are executed by the HAL unless the LLD is able to start
+   them asynchronously.*/
+#if !defined(CRY_LLD_SUPPORTS_QUEUE)
+#define CRY_LLD_SUPPORTS_QUEUE              FALSE
+#endif
+
 /* The fallback header is included only if required by settings.*/
 #if HAL_CRY_USE_FALLBACK == TRUE
 #include "hal_crypto_fallback.h"
@@ -205,6 +258,114 @@ typedef struct {
 } HMACSHA512Context;
 #endif
 
+#if (HAL_CRY_USE_FALLBACK == FALSE) || defined(__DOXYGEN__)
+/* Stub @p AESGCMContext structure type declaration. Streaming AES-GCM is
+   only provided by the fallback.*/
+typedef struct {
+  uint32_t dummy;
+} AESGCMContext;
+#endif
+
+#if (HAL_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Request completion callback type.
+ *
+ * @param[in] cryp      pointer to the @p CRYDriver object
+ * @param[in] reqp      pointer to the completed @p cry_request_t
+ */
+typedef void (*cryrcallback_t)(CRYDriver *cryp, cry_request_t *reqp);
+
+/**
+ * @brief   Element of a request scatter-gather list.
+ */
+typedef struct {
+  /**
+   * @brief   Size of the segment in bytes.
+   * @note    In chained modes all segments except the last one must be
+   *          multiple of the cipher block size.
+   */
+  size_t                    size;
+  /**
+   * @brief   Input buffer.
+   */
+  const uint8_t             *in;
+  /**
+   * @brief   Output buffer, it can be the same as the input buffer.
+   * @note    Ignored by hash operations.
+   */
+  uint8_t                   *out;
+} cry_segment_t;
+
+/**
+ * @brief   Structure representing a queued request.
+ */
+struct hal_cry_request {
+  /**
+   * @brief   Next request in the queue.
+   */
+  cry_request_t             *next;
+  /**
+   * @brief   Operation to be performed.
+   */
+  cryoperation_t            op;
+  /**
+   * @brief   Key to be used by cipher operations.
+   * @note    HMAC operations use the HMAC transient key.
+   */
+  crykey_t                  key_id;
+  /**
+   * @brief   Scatter-gather list.
+   */
+  const cry_segment_t       *segments;
+  /**
+   * @brief   Number of elements in the scatter-gather list.
+   */
+  size_t                    nsegments;
+  /**
+   * @brief   128 bits input vector or @p NULL.
+   * @note    Required by the CBC, CFB, CTR and GCM modes, the vector is
+   *          not modified, chaining across segments uses an internal copy.
+   */
+  const uint8_t             *iv;
+  /**
+   * @brief   Size of the GCM additional authenticated data.
+   */
+  size_t                    auth_size;
+  /**
+   * @brief   GCM additional authenticated data or @p NULL.
+   */
+  const uint8_t             *auth_in;
+  /**
+   * @brief   Size of the GCM authentication tag.
+   */
+  size_t                    tag_size;
+  /**
+   * @brief   GCM tag or digest buffer.
+   * @note    It receives the tag on GCM encryption and the digest on hash
+   *          operations, it is the tag to be verified on GCM decryption.
+   */
+  uint8_t                   *tag;
+  /**
+   * @brief   Request completion callback or @p NULL.
+   */
+  cryrcallback_t            end_cb;
+  /**
+   * @brief   Operation result, valid when the request is done.
+   * @note    On a GCM authentication failure the output has already been
+   *          written and must be discarded.
+   */
+  cryerror_t                result;
+  /**
+   * @brief   Request state.
+   */
+  volatile uint8_t          state;
+  /**
+   * @brief   Thread waiting for the request completion.
+   */
+  thread_reference_t        thread;
+};
+#endif /* HAL_CRY_USE_QUEUE == TRUE */
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -303,6 +464,30 @@ extern "C" {
                                const uint8_t *iv,
                                size_t tag_size,
                                const uint8_t *tag_in);
+  cryerror_t cryAES_GCMInit(CRYDriver *cryp,
+                            AESGCMContext *gcmctxp,
+                            crykey_t key_id,
+                            const uint8_t *iv,
+                            size_t auth_size,
+                            const uint8_t *auth_in);
+  cryerror_t cryEncryptAES_GCMUpdate(CRYDriver *cryp,
+                                     AESGCMContext *gcmctxp,
+                                     size_t size,
+                                     const uint8_t *in,
+                                     uint8_t *out);
+  cryerror_t cryDecryptAES_GCMUpdate(CRYDriver *cryp,
+                                     AESGCMContext *gcmctxp,
+                                     size_t size,
+                                     const uint8_t *in,
+                                     uint8_t *out);
+  cryerror_t cryEncryptAES_GCMFinal(CRYDriver *cryp,
+                                    AESGCMContext *gcmctxp,
+                                    size_t tag_size,
+                                    uint8_t *tag_out);
+  cryerror_t cryDecryptAES_GCMFinal(CRYDriver *cryp,
+                                    AESGCMContext *gcmctxp,
+                                    size_t tag_size,
+                                    const uint8_t *tag_in);
   cryerror_t cryLoadDESTransientKey(CRYDriver *cryp,
                                     size_t size,
                                     const uint8_t *keyp);
@@ -372,6 +557,17 @@ extern "C" {
   cryerror_t cryHMACSHA512Final(CRYDriver *cryp,
                                 HMACSHA512Context *hmacsha512ctxp,
                                 uint8_t *out);
+#if (HAL_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+#if (CRY_LLD_SUPPORTS_QUEUE == TRUE) || defined(__DOXYGEN__)
+  void cryQueueRequestI(CRYDriver *cryp, cry_request_t *reqp);
+#endif
+  void cryQueueRequest(CRYDriver *cryp, cry_request_t *reqp);
+  cryerror_t cryWaitRequest(CRYDriver *cryp, cry_request_t *reqp);
+  cryerror_t _cry_request_execute(CRYDriver *cryp, cry_request_t *reqp);
+#if (CRY_LLD_SUPPORTS_QUEUE == TRUE) || defined(__DOXYGEN__)
+  void _cry_queue_isr(CRYDriver *cryp, cryerror_t err);
+#endif
+#endif /* HAL_CRY_USE_QUEUE == TRUE */
 #ifdef __cplusplus
 }
 #endif
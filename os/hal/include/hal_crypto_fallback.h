@@ -0,0 +1,368 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_crypto_fallback.h
+ * @brief   Cryptographic Driver software fall-back header.
+ * @details Portable implementation of the algorithms not supported by the
+ *          underlying hardware:
+ *          - AES-128/192/256 using a constant-time bitsliced engine that
+ *            processes two blocks in parallel, ECB, CBC, CFB, CTR and GCM
+ *            modes are built on top of it.
+ *          - GHASH using 4-bit tables, the tables are computed when the
+ *            AES transient key is loaded.
+ *          - SHA1, SHA256, SHA512, HMAC-SHA256 and HMAC-SHA512.
+ *          .
+ * @note    DES and TDES are not implemented by the fall-back, the related
+ *          functions return @p CRY_ERR_INV_ALGO.
+ * @note    Only the transient keys are supported (@p key_id zero). The
+ *          transient keys are stored in the fall-back module and are shared
+ *          among all the driver instances.
+ *
+ * @addtogroup CRYPTO
+ * @{
+ */
+
+#ifndef HAL_CRYPTO_FALLBACK_H
+#define HAL_CRYPTO_FALLBACK_H
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Maximum size of an HMAC transient key stored as-is, in bytes.
+ * @note    Longer keys are accepted, keys longer than the hash block
+ *          size are replaced by their digest when loaded, as required
+ *          by the HMAC specification.
+ */
+#define CRY_FALLBACK_HMAC_KEY_MAX_SIZE      128U
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+#if (CRY_LLD_SUPPORTS_SHA1 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a SHA1 context.
+ */
+typedef struct {
+  uint32_t                  state[5];
+  uint64_t                  size;
+  uint8_t                   buf[64];
+} SHA1Context;
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA256 == FALSE) ||                                   \
+    (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a SHA256 context used by the fall-back.
+ */
+typedef struct {
+  uint32_t                  state[8];
+  uint64_t                  size;
+  uint8_t                   buf[64];
+} cry_fallback_sha256_t;
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA512 == FALSE) ||                                   \
+    (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a SHA512 context used by the fall-back.
+ */
+typedef struct {
+  uint64_t                  state[8];
+  uint64_t                  size;
+  uint8_t                   buf[128];
+} cry_fallback_sha512_t;
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a SHA256 context.
+ */
+typedef cry_fallback_sha256_t SHA256Context;
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a SHA512 context.
+ */
+typedef cry_fallback_sha512_t SHA512Context;
+#endif
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a HMAC_SHA256 context.
+ */
+typedef struct {
+  cry_fallback_sha256_t     sha;
+} HMACSHA256Context;
+#endif
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a HMAC_SHA512 context.
+ */
+typedef struct {
+  cry_fallback_sha512_t     sha;
+} HMACSHA512Context;
+#endif
+
+/**
+ * @brief   Type of a streaming AES-GCM context.
+ * @note    The context refers to the AES transient key, the key must not
+ *          be changed while a streaming operation is in progress.
+ */
+typedef struct {
+  /**
+   * @brief   GHASH accumulator.
+   */
+  uint8_t                   y[16];
+  /**
+   * @brief   Next counter block.
+   */
+  uint8_t                   ctr[16];
+  /**
+   * @brief   Encrypted initial counter block, used for the tag.
+   */
+  uint8_t                   ek0[16];
+  /**
+   * @brief   Key stream buffer, two blocks generated in parallel.
+   */
+  uint8_t                   ks[32];
+  /**
+   * @brief   Size of the authenticated data.
+   */
+  size_t                    auth_size;
+  /**
+   * @brief   Size of the text processed so far.
+   */
+  size_t                    text_size;
+} AESGCMContext;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  cryerror_t cry_fallback_aes_loadkey(CRYDriver *cryp,
+                                      size_t size,
+                                      const uint8_t *keyp);
+  cryerror_t cry_fallback_encrypt_AES(CRYDriver *cryp,
+                                      crykey_t key_id,
+                                      const uint8_t *in,
+                                      uint8_t *out);
+  cryerror_t cry_fallback_decrypt_AES(CRYDriver *cryp,
+                                      crykey_t key_id,
+                                      const uint8_t *in,
+                                      uint8_t *out);
+  cryerror_t cry_fallback_encrypt_AES_ECB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out);
+  cryerror_t cry_fallback_decrypt_AES_ECB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out);
+  cryerror_t cry_fallback_encrypt_AES_CBC(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_decrypt_AES_CBC(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_encrypt_AES_CFB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_decrypt_AES_CFB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_encrypt_AES_CTR(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_decrypt_AES_CTR(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_encrypt_AES_GCM(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t auth_size,
+                                          const uint8_t *auth_in,
+                                          size_t text_size,
+                                          const uint8_t *text_in,
+                                          uint8_t *text_out,
+                                          const uint8_t *iv,
+                                          size_t tag_size,
+                                          uint8_t *tag_out);
+  cryerror_t cry_fallback_decrypt_AES_GCM(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t auth_size,
+                                          const uint8_t *auth_in,
+                                          size_t text_size,
+                                          const uint8_t *text_in,
+                                          uint8_t *text_out,
+                                          const uint8_t *iv,
+                                          size_t tag_size,
+                                          const uint8_t *tag_in);
+  cryerror_t cry_fallback_AES_GCM_init(CRYDriver *cryp,
+                                       AESGCMContext *gcmctxp,
+                                       crykey_t key_id,
+                                       const uint8_t *iv,
+                                       size_t auth_size,
+                                       const uint8_t *auth_in);
+  cryerror_t cry_fallback_encrypt_AES_GCM_update(CRYDriver *cryp,
+                                                 AESGCMContext *gcmctxp,
+                                                 size_t size,
+                                                 const uint8_t *in,
+                                                 uint8_t *out);
+  cryerror_t cry_fallback_decrypt_AES_GCM_update(CRYDriver *cryp,
+                                                 AESGCMContext *gcmctxp,
+                                                 size_t size,
+                                                 const uint8_t *in,
+                                                 uint8_t *out);
+  cryerror_t cry_fallback_encrypt_AES_GCM_final(CRYDriver *cryp,
+                                                AESGCMContext *gcmctxp,
+                                                size_t tag_size,
+                                                uint8_t *tag_out);
+  cryerror_t cry_fallback_decrypt_AES_GCM_final(CRYDriver *cryp,
+                                                AESGCMContext *gcmctxp,
+                                                size_t tag_size,
+                                                const uint8_t *tag_in);
+  cryerror_t cry_fallback_des_loadkey(CRYDriver *cryp,
+                                      size_t size,
+                                      const uint8_t *keyp);
+  cryerror_t cry_fallback_encrypt_DES(CRYDriver *cryp,
+                                      crykey_t key_id,
+                                      const uint8_t *in,
+                                      uint8_t *out);
+  cryerror_t cry_fallback_decrypt_DES(CRYDriver *cryp,
+                                      crykey_t key_id,
+                                      const uint8_t *in,
+                                      uint8_t *out);
+  cryerror_t cry_fallback_encrypt_DES_ECB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out);
+  cryerror_t cry_fallback_decrypt_DES_ECB(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out);
+  cryerror_t cry_fallback_encrypt_DES_CBC(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+  cryerror_t cry_fallback_decrypt_DES_CBC(CRYDriver *cryp,
+                                          crykey_t key_id,
+                                          size_t size,
+                                          const uint8_t *in,
+                                          uint8_t *out,
+                                          const uint8_t *iv);
+#if (CRY_LLD_SUPPORTS_SHA1 == FALSE) || defined(__DOXYGEN__)
+  cryerror_t cry_fallback_SHA1_init(CRYDriver *cryp, SHA1Context *sha1ctxp);
+  cryerror_t cry_fallback_SHA1_update(CRYDriver *cryp, SHA1Context *sha1ctxp,
+                                      size_t size, const uint8_t *in);
+  cryerror_t cry_fallback_SHA1_final(CRYDriver *cryp, SHA1Context *sha1ctxp,
+                                     uint8_t *out);
+#endif
+#if (CRY_LLD_SUPPORTS_SHA256 == FALSE) || defined(__DOXYGEN__)
+  cryerror_t cry_fallback_SHA256_init(CRYDriver *cryp,
+                                      SHA256Context *sha256ctxp);
+  cryerror_t cry_fallback_SHA256_update(CRYDriver *cryp,
+                                        SHA256Context *sha256ctxp,
+                                        size_t size, const uint8_t *in);
+  cryerror_t cry_fallback_SHA256_final(CRYDriver *cryp,
+                                       SHA256Context *sha256ctxp,
+                                       uint8_t *out);
+#endif
+#if (CRY_LLD_SUPPORTS_SHA512 == FALSE) || defined(__DOXYGEN__)
+  cryerror_t cry_fallback_SHA512_init(CRYDriver *cryp,
+                                      SHA512Context *sha512ctxp);
+  cryerror_t cry_fallback_SHA512_update(CRYDriver *cryp,
+                                        SHA512Context *sha512ctxp,
+                                        size_t size, const uint8_t *in);
+  cryerror_t cry_fallback_SHA512_final(CRYDriver *cryp,
+                                       SHA512Context *sha512ctxp,
+                                       uint8_t *out);
+#endif
+  cryerror_t cry_fallback_hmac_loadkey(CRYDriver *cryp,
+                                       size_t size,
+                                       const uint8_t *keyp);
+#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) || defined(__DOXYGEN__)
+  cryerror_t cry_fallback_HMACSHA256_init(CRYDriver *cryp,
+                                          HMACSHA256Context *hmacsha256ctxp);
+  cryerror_t cry_fallback_HMACSHA256_update(CRYDriver *cryp,
+                                            HMACSHA256Context *hmacsha256ctxp,
+                                            size_t size,
+                                            const uint8_t *in);
+  cryerror_t cry_fallback_HMACSHA256_final(CRYDriver *cryp,
+                                           HMACSHA256Context *hmacsha256ctxp,
+                                           uint8_t *out);
+#endif
+#if (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE) || defined(__DOXYGEN__)
+  cryerror_t cry_fallback_HMACSHA512_init(CRYDriver *cryp,
+                                          HMACSHA512Context *hmacsha512ctxp);
+  cryerror_t cry_fallback_HMACSHA512_update(CRYDriver *cryp,
+                                            HMACSHA512Context *hmacsha512ctxp,
+                                            size_t size,
+                                            const uint8_t *in);
+  cryerror_t cry_fallback_HMACSHA512_final(CRYDriver *cryp,
+                                           HMACSHA512Context *hmacsha512ctxp,
+                                           uint8_t *out);
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_CRYPTO_FALLBACK_H */
+
+/** @} */
@@ -166,6 +166,84 @@ struct SerialUSBDriver {
 /* Driver macros.                                                            */
 /*===========================================================================*/
 
+/**
+ * @name    Zero-copy access macros
+ * @{
+ */
+/**
+ * @brief   Gets a view of the received data.
+ * @details The data is accessed in place into the current input buffer, a
+ *          new buffer is acquired if there is no current one. The view never
+ *          crosses the buffer boundary.
+ * @post    The data must be released using @p sduConsume().
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ * @param[out] bpp      pointer to a variable receiving the data pointer
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The size of the view.
+ * @retval 0            if a timeout occurred.
+ *
+ * @api
+ */
+#define sduGetReadViewTimeout(sdup, bpp, timeout)                           \
+  ibqGetViewTimeout(&(sdup)->ibqueue, bpp, timeout)
+
+/**
+ * @brief   Releases data from the current read view.
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ * @param[in] n         number of bytes consumed
+ *
+ * @api
+ */
+#define sduConsume(sdup, n) ibqConsume(&(sdup)->ibqueue, n)
+
+/**
+ * @brief   Gets a view of the free space of the current output buffer.
+ * @details The data is written in place into the current output buffer, a
+ *          new buffer is acquired if there is no current one.
+ * @post    The data must be committed using @p sduCommit().
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ * @param[out] bpp      pointer to a variable receiving the space pointer
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The size of the view.
+ * @retval 0            if a timeout occurred.
+ *
+ * @api
+ */
+#define sduGetWriteViewTimeout(sdup, bpp, timeout)                          \
+  obqGetViewTimeout(&(sdup)->obqueue, bpp, timeout)
+
+/**
+ * @brief   Commits data written into the current write view.
+ * @details The buffer is transmitted when full, partially filled buffers
+ *          are transmitted on the next start of frame.
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ * @param[in] n         number of bytes committed
+ *
+ * @api
+ */
+#define sduCommit(sdup, n) obqCommit(&(sdup)->obqueue, n)
+
+/**
+ * @brief   Vectored write with timeout.
+ * @details The elements are gathered into the output buffers, the
+ *          transmission is started once for all the filled buffers.
+ *
+ * @param[in] sdup      pointer to a @p SerialUSBDriver object
+ * @param[in] iovp      pointer to an array of @p bqiovec_t elements
+ * @param[in] iovcnt    number of elements in the array
+ * @param[in] timeout   the number of ticks before the operation timeouts
+ * @return              The number of bytes effectively transferred.
+ *
+ * @api
+ */
+#define sduWriteVTimeout(sdup, iovp, iovcnt, timeout)                       \
+  obqWriteVTimeout(&(sdup)->obqueue, iovp, iovcnt, timeout)
+/** @} */
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
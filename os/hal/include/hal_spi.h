@@ -44,6 +44,26 @@
 #define SPI_SELECT_MODE_LLD                 4   /** @brief LLD-defined mode.*/
 /** @} */
 
+/**
+ * @name    Transaction flags
+ * @{
+ */
+#define SPI_TRANSACTION_KEEP_SELECTED       1U  /** @brief The CS line is left
+                                                    asserted at the end and
+                                                    the transaction pointed
+                                                    by @p next follows.     */
+/** @} */
+
+/**
+ * @name    Transaction states
+ * @{
+ */
+#define SPI_TRANSACTION_IDLE                0U  /** @brief Not queued.      */
+#define SPI_TRANSACTION_QUEUED              1U  /** @brief Waiting in queue.*/
+#define SPI_TRANSACTION_ACTIVE              2U  /** @brief Being executed.  */
+#define SPI_TRANSACTION_DONE                3U  /** @brief Completed.       */
+/** @} */
+
 /*===========================================================================*/
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -76,6 +96,14 @@
 #define SPI_USE_MUTUAL_EXCLUSION            TRUE
 #endif
 
+/**
+ * @brief   Enables the transactions queue APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(SPI_USE_QUEUE) || defined(__DOXYGEN__)
+#define SPI_USE_QUEUE                       FALSE
+#endif
+
 /**
  * @brief   Handling method for SPI CS line.
  * @note    Disabling this option saves both code and data space.
@@ -130,6 +158,11 @@ typedef struct hal_spi_driver SPIDriver;
  */
 typedef struct hal_spi_config SPIConfig;
 
+/**
+ * @brief   Type of a SPI transaction descriptor.
+ */
+typedef struct hal_spi_transaction spi_transaction_t;
+
 /**
  * @brief   SPI notification callback type.
  *
@@ -138,6 +171,15 @@ typedef struct hal_spi_config SPIConfig;
  */
 typedef void (*spicallback_t)(SPIDriver *spip);
 
+/**
+ * @brief   SPI transaction notification callback type.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object triggering the
+ *                      callback
+ * @param[in] stp       pointer to the completed @p spi_transaction_t
+ */
+typedef void (*spitcallback_t)(SPIDriver *spip, spi_transaction_t *stp);
+
 /* Including the low level driver header, it exports information required
    for completing types.*/
 #include "hal_spi_lld.h"
@@ -210,6 +252,16 @@ struct hal_spi_driver {
    */
   mutex_t                   mutex;
 #endif /* SPI_USE_MUTUAL_EXCLUSION == TRUE */
+#if (SPI_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Queue of pending transactions.
+   */
+  spi_transaction_t         *tqueue;
+  /**
+   * @brief   Transaction being executed or @p NULL.
+   */
+  spi_transaction_t         *tcurrent;
+#endif /* SPI_USE_QUEUE == TRUE */
 #if defined(SPI_DRIVER_EXT_FIELDS)
   SPI_DRIVER_EXT_FIELDS
 #endif
@@ -217,6 +269,63 @@ struct hal_spi_driver {
   spi_lld_driver_fields;
 };
 
+#if (SPI_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Structure representing a SPI transaction.
+ * @note    Transactions with both buffers set to @p NULL ignore @p n
+ *          words, transactions with only one buffer set perform a send
+ *          or a receive operation.
+ */
+struct hal_spi_transaction {
+  /**
+   * @brief   Next transaction in the queue.
+   * @note    This field must be initialized only when the
+   *          @p SPI_TRANSACTION_KEEP_SELECTED flag is specified, it is
+   *          managed by the driver otherwise.
+   */
+  spi_transaction_t         *next;
+  /**
+   * @brief   Configuration used for this transaction.
+   * @note    The configuration also selects the CS line to be asserted.
+   */
+  const SPIConfig           *config;
+  /**
+   * @brief   Number of words to be exchanged.
+   */
+  size_t                    n;
+  /**
+   * @brief   Transmit buffer or @p NULL.
+   */
+  const void                *txbuf;
+  /**
+   * @brief   Receive buffer or @p NULL.
+   */
+  void                      *rxbuf;
+  /**
+   * @brief   Transaction end callback or @p NULL.
+   */
+  spitcallback_t            end_cb;
+  /**
+   * @brief   Priority class, higher values are served first.
+   */
+  uint8_t                   prio;
+  /**
+   * @brief   Transaction flags.
+   */
+  uint8_t                   flags;
+  /**
+   * @brief   Transaction state.
+   */
+  volatile uint8_t          state;
+#if (SPI_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Thread waiting for the transaction completion.
+   */
+  thread_reference_t        thread;
+#endif
+};
+#endif /* SPI_USE_QUEUE == TRUE */
+
 /*===========================================================================*/
 /* Driver macros.                                                            */
 /*===========================================================================*/
@@ -422,6 +531,39 @@ do {                                                                        \
 #define _spi_wakeup_isr(spip)
 #endif /* !SPI_USE_WAIT */
 
+#if (SPI_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Common ISR code when circular mode is not supported.
+ * @details This code handles the portable part of the ISR code:
+ *          - Callback invocation.
+ *          - Waiting thread wakeup, if any.
+ *          - Driver state transitions.
+ *          - Start of the next queued transaction, if any.
+ *          .
+ * @note    This macro is meant to be used in the low level drivers
+ *          implementation only.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+#define _spi_isr_code(spip) {                                               \
+  if ((spip)->tcurrent != NULL) {                                           \
+    _spi_queue_isr(spip);                                                   \
+  }                                                                         \
+  else {                                                                    \
+    if ((spip)->config->end_cb) {                                           \
+      (spip)->state = SPI_COMPLETE;                                         \
+      (spip)->config->end_cb(spip);                                         \
+      if ((spip)->state == SPI_COMPLETE)                                    \
+        (spip)->state = SPI_READY;                                          \
+    }                                                                       \
+    else                                                                    \
+      (spip)->state = SPI_READY;                                            \
+    _spi_wakeup_isr(spip);                                                  \
+  }                                                                         \
+}
+#else /* !SPI_USE_QUEUE */
 /**
  * @brief   Common ISR code when circular mode is not supported.
  * @details This code handles the portable part of the ISR code:
@@ -447,6 +589,7 @@ do {                                                                        \
     (spip)->state = SPI_READY;                                              \
   _spi_wakeup_isr(spip);                                                    \
 }
+#endif /* !SPI_USE_QUEUE */
 
 /**
  * @brief   Half buffer filled ISR code in circular mode.
@@ -521,6 +664,14 @@ extern "C" {
   void spiAcquireBus(SPIDriver *spip);
   void spiReleaseBus(SPIDriver *spip);
 #endif
+#if SPI_USE_QUEUE == TRUE
+  void spiQueueTransactionI(SPIDriver *spip, spi_transaction_t *stp);
+  void spiQueueTransaction(SPIDriver *spip, spi_transaction_t *stp);
+#if SPI_USE_WAIT == TRUE
+  void spiWaitTransaction(SPIDriver *spip, spi_transaction_t *stp);
+#endif
+  void _spi_queue_isr(SPIDriver *spip);
+#endif
 #ifdef __cplusplus
 }
 #endif
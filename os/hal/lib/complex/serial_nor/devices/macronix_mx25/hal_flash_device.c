@@ -663,4 +663,49 @@ flash_error_t snor_device_read_sfdp(SNORDriver *devp, flash_offset_t offset,
   return FLASH_NO_ERROR;
 }
 
+/**
+ * @brief   Device erase suspend.
+ * @note    If the erase operation is already finished then the command
+ *          is ignored by the device.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ */
+flash_error_t snor_device_suspend_erase(SNORDriver *devp) {
+  uint8_t sts[2];
+
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+  bus_cmd(devp->config->busp, MX25_CMD_SPI_PE_SUSPEND);
+#else
+  bus_cmd(devp->config->busp, MX25_CMD_OPI_PE_SUSPEND);
+#endif
+
+  /* Waiting for the WIP bit to go low, suspend latency is in the
+     microseconds range so there is no sleep here.*/
+  do {
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+    bus_cmd_receive(devp->config->busp, MX25_CMD_SPI_RDSR, 1U, sts);
+#else
+    bus_cmd_addr_dummy_receive(devp->config->busp, MX25_CMD_OPI_RDSR,
+                               0U, 4U, 2U, sts);   /*Note: always 4 dummies.*/
+#endif
+  } while ((sts[0] & 1U) != 0U);
+
+  return FLASH_NO_ERROR;
+}
+
+/**
+ * @brief   Device erase resume.
+ * @note    If the device is not suspended then the command is ignored.
+ *
+ * @param[in] devp      pointer to a @p SNORDriver instance
+ */
+void snor_device_resume_erase(SNORDriver *devp) {
+
+#if MX25_BUS_MODE == MX25_BUS_MODE_SPI
+  bus_cmd(devp->config->busp, MX25_CMD_SPI_PE_RESUME);
+#else
+  bus_cmd(devp->config->busp, MX25_CMD_OPI_PE_RESUME);
+#endif
+}
+
 /** @} */
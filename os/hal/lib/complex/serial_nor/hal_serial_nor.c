@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 #include "hal_serial_nor.h"
 
@@ -29,6 +31,10 @@
 /* Driver local definitions.                                                 */
 /*===========================================================================*/
 
+#if (SNOR_USE_ERASE_SUSPEND == TRUE) && (SNOR_DEVICE_SUPPORTS_SUSPEND == FALSE)
+#error "SNOR_USE_ERASE_SUSPEND requires a device supporting erase suspend"
+#endif
+
 /*===========================================================================*/
 /* Driver exported variables.                                                */
 /*===========================================================================*/
@@ -66,6 +72,326 @@ static const struct SNORDriverVMT snor_vmt = {
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (SNOR_USE_READ_CACHE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Invalidates the whole read cache.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ *
+ * @notapi
+ */
+static void snor_cache_reset(SNORDriver *devp) {
+  unsigned i;
+
+  for (i = 0U; i < SNOR_READ_CACHE_LINES; i++) {
+    devp->cache_tags[i] = SNOR_CACHE_INVALID_TAG;
+  }
+  devp->cache_next = (flash_offset_t)SNOR_CACHE_INVALID_TAG;
+}
+
+/**
+ * @brief   Invalidates the cache lines overlapping a flash area.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes
+ *
+ * @notapi
+ */
+static void snor_cache_invalidate(SNORDriver *devp,
+                                  flash_offset_t offset,
+                                  size_t n) {
+  uint32_t first = (uint32_t)offset / SNOR_READ_CACHE_LINE_SIZE;
+  uint32_t last  = ((uint32_t)offset + (uint32_t)n - 1U) /
+                   SNOR_READ_CACHE_LINE_SIZE;
+  unsigned i;
+
+  for (i = 0U; i < SNOR_READ_CACHE_LINES; i++) {
+    if ((devp->cache_tags[i] >= first) && (devp->cache_tags[i] <= last)) {
+      devp->cache_tags[i] = SNOR_CACHE_INVALID_TAG;
+    }
+  }
+}
+
+/**
+ * @brief   Copies a flash area from the cache.
+ * @pre     All the lines overlapping the area must be present in cache.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes to be copied
+ * @param[out] rp       pointer to the data buffer
+ *
+ * @notapi
+ */
+static void snor_cache_copy(SNORDriver *devp,
+                            flash_offset_t offset,
+                            size_t n,
+                            uint8_t *rp) {
+
+  while (n > 0U) {
+    uint32_t line = (uint32_t)offset / SNOR_READ_CACHE_LINE_SIZE;
+    size_t pos    = (size_t)offset & (SNOR_READ_CACHE_LINE_SIZE - 1U);
+    size_t chunk  = SNOR_READ_CACHE_LINE_SIZE - pos;
+
+    if (chunk > n) {
+      chunk = n;
+    }
+    memcpy(rp,
+           &devp->cache_buf[((line % SNOR_READ_CACHE_LINES) *
+                             SNOR_READ_CACHE_LINE_SIZE) + pos],
+           chunk);
+    offset += (flash_offset_t)chunk;
+    rp     += chunk;
+    n      -= chunk;
+  }
+}
+
+/**
+ * @brief   Serves a read operation from the cache, if possible.
+ * @pre     The bus must be already acquired, it protects the cache.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes to be read
+ * @param[out] rp       pointer to the data buffer
+ * @return              The operation status.
+ * @retval false        if the data has been copied from the cache.
+ * @retval true         if one or more lines are not in cache.
+ *
+ * @notapi
+ */
+static bool snor_cache_lookup(SNORDriver *devp,
+                              flash_offset_t offset,
+                              size_t n,
+                              uint8_t *rp) {
+  uint32_t first = (uint32_t)offset / SNOR_READ_CACHE_LINE_SIZE;
+  uint32_t last  = ((uint32_t)offset + (uint32_t)n - 1U) /
+                   SNOR_READ_CACHE_LINE_SIZE;
+  uint32_t line;
+
+  if (last - first >= SNOR_READ_CACHE_LINES) {
+    return true;
+  }
+
+  for (line = first; line <= last; line++) {
+    if (devp->cache_tags[line % SNOR_READ_CACHE_LINES] != line) {
+      return true;
+    }
+  }
+
+  snor_cache_copy(devp, offset, n, rp);
+  devp->cache_next = offset + (flash_offset_t)n;
+
+  return false;
+}
+
+/**
+ * @brief   Reads a flash area through the cache.
+ * @details Missing lines are loaded from the device, adjacent missing
+ *          lines are fetched using a single read operation. If the
+ *          area immediately follows the previous read then the next
+ *          line is also prefetched. Areas larger than the cache are
+ *          read directly from the device.
+ * @pre     The bus must be already acquired.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes to be read
+ * @param[out] rp       pointer to the data buffer
+ * @return              An error code.
+ *
+ * @notapi
+ */
+static flash_error_t snor_cache_read(SNORDriver *devp,
+                                     flash_offset_t offset,
+                                     size_t n,
+                                     uint8_t *rp) {
+  uint32_t first = (uint32_t)offset / SNOR_READ_CACHE_LINE_SIZE;
+  uint32_t last  = ((uint32_t)offset + (uint32_t)n - 1U) /
+                   SNOR_READ_CACHE_LINE_SIZE;
+  uint32_t end, line, start;
+  bool sequential;
+
+  sequential = (bool)(offset == devp->cache_next);
+  devp->cache_next = offset + (flash_offset_t)n;
+
+  /* Areas not fitting the cache are not cached.*/
+  if (last - first >= SNOR_READ_CACHE_LINES) {
+    return snor_device_read(devp, offset, n, rp);
+  }
+
+  /* Sequential access, prefetching the next line if it fits the cache
+     and it is within the device.*/
+  end = last;
+  if (sequential && (last - first + 1U < SNOR_READ_CACHE_LINES) &&
+      (last + 1U < snor_descriptor.size / SNOR_READ_CACHE_LINE_SIZE)) {
+    end = last + 1U;
+  }
+
+  line = first;
+  while (line <= end) {
+    flash_error_t err;
+
+    if (devp->cache_tags[line % SNOR_READ_CACHE_LINES] == line) {
+      line++;
+      continue;
+    }
+
+    /* Run of missing lines mapped on contiguous cache lines, it is
+       fetched in a single operation.*/
+    start = line;
+    do {
+      devp->cache_tags[line % SNOR_READ_CACHE_LINES] = SNOR_CACHE_INVALID_TAG;
+      line++;
+    } while ((line <= end) &&
+             ((line % SNOR_READ_CACHE_LINES) != 0U) &&
+             (devp->cache_tags[line % SNOR_READ_CACHE_LINES] != line));
+
+    err = snor_device_read(devp,
+                           (flash_offset_t)(start * SNOR_READ_CACHE_LINE_SIZE),
+                           (size_t)(line - start) * SNOR_READ_CACHE_LINE_SIZE,
+                           &devp->cache_buf[(start % SNOR_READ_CACHE_LINES) *
+                                            SNOR_READ_CACHE_LINE_SIZE]);
+    if (err != FLASH_NO_ERROR) {
+      return err;
+    }
+
+    while (start < line) {
+      devp->cache_tags[start % SNOR_READ_CACHE_LINES] = start;
+      start++;
+    }
+  }
+
+  snor_cache_copy(devp, offset, n, rp);
+
+  return FLASH_NO_ERROR;
+}
+#endif /* SNOR_USE_READ_CACHE == TRUE */
+
+#if (SNOR_USE_ERASE_SUSPEND == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Reads a flash area while an erase operation is in progress.
+ * @details The erase operation is suspended for the duration of the
+ *          read and then resumed.
+ * @note    The data is read directly from the device and is not cached,
+ *          a prefetch could load lines of the sector being erased.
+ * @pre     The bus must be already acquired.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes to be read
+ * @param[out] rp       pointer to the data buffer
+ * @return              An error code.
+ *
+ * @notapi
+ */
+static flash_error_t snor_suspended_read(SNORDriver *devp,
+                                         flash_offset_t offset,
+                                         size_t n,
+                                         uint8_t *rp) {
+  flash_offset_t start;
+  flash_error_t err;
+  size_t size;
+
+  /* Whole device erase cannot be suspended.*/
+  if (devp->erasing == SNOR_ERASING_ALL) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* Reads overlapping the sector being erased are not possible.*/
+  start = flashGetSectorOffset((BaseFlash *)devp, devp->erasing);
+  size  = (size_t)flashGetSectorSize((BaseFlash *)devp, devp->erasing);
+  if (((size_t)offset < (size_t)start + size) &&
+      ((size_t)offset + n > (size_t)start)) {
+    return FLASH_BUSY_ERASING;
+  }
+
+  /* Suspending the erase operation, the driver stays in FLASH_ERASE
+     state.*/
+  err = snor_device_suspend_erase(devp);
+  if (err == FLASH_NO_ERROR) {
+
+    err = snor_device_read(devp, offset, n, rp);
+
+    /* Erase operation resumed.*/
+    snor_device_resume_erase(devp);
+  }
+
+  return err;
+}
+#endif /* SNOR_USE_ERASE_SUSPEND == TRUE */
+
+#if (SNOR_USE_ERASE_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Checks if a flash area overlaps a sector queued for erase.
+ * @pre     The bus must be already acquired, it protects the queue.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] offset    flash offset
+ * @param[in] n         number of bytes
+ * @return              The check result.
+ * @retval false        if the area does not overlap queued sectors.
+ * @retval true         if the area overlaps a queued sector.
+ *
+ * @notapi
+ */
+static bool snor_erase_queued(SNORDriver *devp,
+                              flash_offset_t offset,
+                              size_t n) {
+  size_t i;
+
+  for (i = 0U; i < devp->erase_count; i++) {
+    flash_sector_t sector;
+    flash_offset_t start;
+    size_t size;
+
+    sector = devp->erase_queue[(devp->erase_first + i) %
+                               SNOR_ERASE_QUEUE_SIZE];
+    start  = flashGetSectorOffset((BaseFlash *)devp, sector);
+    size   = (size_t)flashGetSectorSize((BaseFlash *)devp, sector);
+    if (((size_t)offset < (size_t)start + size) &&
+        ((size_t)offset + n > (size_t)start)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+#endif /* SNOR_USE_ERASE_QUEUE == TRUE */
+
+/**
+ * @brief   Starts a sector erase.
+ * @pre     The bus must be already acquired and the driver must be in
+ *          @p FLASH_READY state.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] sector    sector to be erased
+ * @return              An error code.
+ *
+ * @notapi
+ */
+static flash_error_t snor_erase_start(SNORDriver *devp,
+                                      flash_sector_t sector) {
+
+  /* FLASH_ERASE state while the operation is performed.*/
+  devp->state = FLASH_ERASE;
+
+#if SNOR_USE_READ_CACHE == TRUE
+  /* Lines belonging to the sector are going to be stale.*/
+  snor_cache_invalidate(devp,
+                        flashGetSectorOffset((BaseFlash *)devp, sector),
+                        (size_t)flashGetSectorSize((BaseFlash *)devp, sector));
+#endif
+
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+  devp->erasing = sector;
+#endif
+
+  /* Actual erase implementation.*/
+  return snor_device_start_erase_sector(devp, sector);
+}
+
 /**
  * @brief   Returns a pointer to the device descriptor.
  *
@@ -93,18 +419,38 @@ static flash_error_t snor_read(void *instance, flash_offset_t offset,
   osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
                 "invalid state");
 
-  if (devp->state == FLASH_ERASE) {
-    return FLASH_BUSY_ERASING;
-  }
-
   /* Bus acquired.*/
   bus_acquire(devp->config->busp, devp->config->buscfg);
 
+#if SNOR_USE_READ_CACHE == TRUE
+  /* Reads served by the cache do not touch the device, this is possible
+     also while an erase operation is in progress because lines belonging
+     to the sectors being erased have been invalidated.*/
+  if (!snor_cache_lookup(devp, offset, n, rp)) {
+    bus_release(devp->config->busp);
+    return FLASH_NO_ERROR;
+  }
+#endif
+
+  if (devp->state == FLASH_ERASE) {
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+    err = snor_suspended_read(devp, offset, n, rp);
+#else
+    err = FLASH_BUSY_ERASING;
+#endif
+    bus_release(devp->config->busp);
+    return err;
+  }
+
   /* FLASH_READY state while the operation is performed.*/
   devp->state = FLASH_READ;
 
   /* Actual read implementation.*/
+#if SNOR_USE_READ_CACHE == TRUE
+  err = snor_cache_read(devp, offset, n, rp);
+#else
   err = snor_device_read(devp, offset, n, rp);
+#endif
 
   /* Ready state again.*/
   devp->state = FLASH_READY;
@@ -133,9 +479,22 @@ static flash_error_t snor_program(void *instance, flash_offset_t offset,
   /* Bus acquired.*/
   bus_acquire(devp->config->busp, devp->config->buscfg);
 
+#if SNOR_USE_ERASE_QUEUE == TRUE
+  /* Sectors queued for erase cannot be programmed.*/
+  if (snor_erase_queued(devp, offset, n)) {
+    bus_release(devp->config->busp);
+    return FLASH_ERROR_PROGRAM;
+  }
+#endif
+
   /* FLASH_PGM state while the operation is performed.*/
   devp->state = FLASH_PGM;
 
+#if SNOR_USE_READ_CACHE == TRUE
+  /* Cached data is going to be stale.*/
+  snor_cache_invalidate(devp, offset, n);
+#endif
+
   /* Actual program implementation.*/
   err = snor_device_program(devp, offset, n, pp);
 
@@ -166,6 +525,15 @@ static flash_error_t snor_start_erase_all(void *instance) {
   /* FLASH_ERASE state while the operation is performed.*/
   devp->state = FLASH_ERASE;
 
+#if SNOR_USE_READ_CACHE == TRUE
+  /* The whole cache is going to be stale.*/
+  snor_cache_reset(devp);
+#endif
+
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+  devp->erasing = SNOR_ERASING_ALL;
+#endif
+
   /* Actual erase implementation.*/
   err = snor_device_start_erase_all(devp);
 
@@ -195,11 +563,8 @@ static flash_error_t snor_start_erase_sector(void *instance,
   /* Bus acquired.*/
   bus_acquire(devp->config->busp, devp->config->buscfg);
 
-  /* FLASH_ERASE state while the operation is performed.*/
-  devp->state = FLASH_ERASE;
-
   /* Actual erase implementation.*/
-  err = snor_device_start_erase_sector(devp, sector);
+  err = snor_erase_start(devp, sector);
 
   /* Bus released.*/
   bus_release(devp->config->busp);
@@ -647,6 +1012,16 @@ void snorObjectInit(SNORDriver *devp) {
   devp->vmt         = &snor_vmt;
   devp->state       = FLASH_STOP;
   devp->config      = NULL;
+#if SNOR_USE_READ_CACHE == TRUE
+  snor_cache_reset(devp);
+#endif
+#if SNOR_USE_ERASE_SUSPEND == TRUE
+  devp->erasing     = SNOR_ERASING_ALL;
+#endif
+#if SNOR_USE_ERASE_QUEUE == TRUE
+  devp->erase_first = 0U;
+  devp->erase_count = 0U;
+#endif
 }
 
 /**
@@ -672,6 +1047,11 @@ void snorStart(SNORDriver *devp, const SNORConfig *config) {
     /* Device identification and initialization.*/
     snor_device_init(devp);
 
+#if SNOR_USE_READ_CACHE == TRUE
+    /* Device content could have been changed while stopped.*/
+    snor_cache_reset(devp);
+#endif
+
     /* Driver in ready state.*/
     devp->state = FLASH_READY;
 
@@ -711,6 +1091,158 @@ void snorStop(SNORDriver *devp) {
   }
 }
 
+#if (SNOR_USE_READ_CACHE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Invalidates the whole read cache.
+ * @note    Program and erase operations performed through the driver
+ *          already invalidate the affected lines, this function is
+ *          only required if the flash content is modified by other
+ *          means.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ *
+ * @api
+ */
+void snorCacheInvalidate(SNORDriver *devp) {
+
+  osalDbgCheck(devp != NULL);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  /* Bus acquired, it protects the cache.*/
+  bus_acquire(devp->config->busp, devp->config->buscfg);
+
+  snor_cache_reset(devp);
+
+  /* Bus released.*/
+  bus_release(devp->config->busp);
+}
+#endif /* SNOR_USE_READ_CACHE == TRUE */
+
+#if (SNOR_USE_ERASE_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Queues a sector for deferred erase.
+ * @details The sector is erased later by @p snorServiceEraseQueue(),
+ *          its content remains readable until then. Sectors already in
+ *          the queue are not queued again.
+ * @note    Programming a queued sector fails with @p FLASH_ERROR_PROGRAM
+ *          until its erase has been started.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[in] sector    sector to be erased
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR       if the sector has been queued.
+ * @retval FLASH_BUSY_ERASING   if the queue is full.
+ *
+ * @api
+ */
+flash_error_t snorQueueEraseSector(SNORDriver *devp, flash_sector_t sector) {
+  flash_error_t err;
+  size_t i;
+
+  osalDbgCheck(devp != NULL);
+  osalDbgCheck(sector < snor_descriptor.sectors_count);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  /* Bus acquired, it protects the queue.*/
+  bus_acquire(devp->config->busp, devp->config->buscfg);
+
+  for (i = 0U; i < devp->erase_count; i++) {
+    if (devp->erase_queue[(devp->erase_first + i) %
+                          SNOR_ERASE_QUEUE_SIZE] == sector) {
+      break;
+    }
+  }
+
+  if (i < devp->erase_count) {
+    /* Already queued.*/
+    err = FLASH_NO_ERROR;
+  }
+  else if (devp->erase_count >= SNOR_ERASE_QUEUE_SIZE) {
+    err = FLASH_BUSY_ERASING;
+  }
+  else {
+    devp->erase_queue[(devp->erase_first + devp->erase_count) %
+                      SNOR_ERASE_QUEUE_SIZE] = sector;
+    devp->erase_count++;
+    err = FLASH_NO_ERROR;
+  }
+
+  /* Bus released.*/
+  bus_release(devp->config->busp);
+
+  return err;
+}
+
+/**
+ * @brief   Performs queued erase operations.
+ * @details If an erase operation is in progress then its status is
+ *          checked, else the next queued sector erase is started. The
+ *          function never waits for an erase completion.
+ * @note    This function is meant to be called periodically from a low
+ *          priority thread, so that erase operations are started when
+ *          the bus is not used by other activities.
+ * @note    The check and the start of the next erase are performed under
+ *          a single bus acquisition, other threads cannot start erase
+ *          operations or modify the queue in between.
+ *
+ * @param[in] devp      pointer to the @p SNORDriver object
+ * @param[out] msec     recommended time, in milliseconds, before calling
+ *                      this function again, can be @p NULL
+ * @return              An error code.
+ * @retval FLASH_NO_ERROR       if there are no erase operations in progress
+ *                              and the queue is empty.
+ * @retval FLASH_BUSY_ERASING   if an erase operation is in progress.
+ * @retval FLASH_ERROR_ERASE    if the last erase operation failed.
+ * @retval FLASH_ERROR_HW_FAILURE if access to the memory failed.
+ *
+ * @api
+ */
+flash_error_t snorServiceEraseQueue(SNORDriver *devp, uint32_t *msec) {
+  flash_sector_t sector;
+  flash_error_t err;
+
+  osalDbgCheck(devp != NULL);
+  osalDbgAssert((devp->state == FLASH_READY) || (devp->state == FLASH_ERASE),
+                "invalid state");
+
+  /* Bus acquired, it also protects the queue.*/
+  bus_acquire(devp->config->busp, devp->config->buscfg);
+
+  /* Checking the erase operation in progress, if any.*/
+  err = FLASH_NO_ERROR;
+  if (devp->state == FLASH_ERASE) {
+    err = snor_device_query_erase(devp, msec);
+    if (err == FLASH_NO_ERROR) {
+      devp->state = FLASH_READY;
+    }
+  }
+
+  if ((err == FLASH_NO_ERROR) && (devp->erase_count > 0U)) {
+
+    /* Starting the next queued erase.*/
+    sector = devp->erase_queue[devp->erase_first];
+    devp->erase_first = (devp->erase_first + 1U) % SNOR_ERASE_QUEUE_SIZE;
+    devp->erase_count--;
+    err = snor_erase_start(devp, sector);
+    if (err == FLASH_NO_ERROR) {
+
+      /* Returns FLASH_BUSY_ERASING and the polling time.*/
+      err = snor_device_query_erase(devp, msec);
+      if (err == FLASH_NO_ERROR) {
+        devp->state = FLASH_READY;
+      }
+    }
+  }
+
+  /* Bus released.*/
+  bus_release(devp->config->busp);
+
+  return err;
+}
+#endif /* SNOR_USE_ERASE_QUEUE == TRUE */
+
 #if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
 /**
@@ -31,6 +31,16 @@
 /* Driver constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Read cache invalid line marker.
+ */
+#define SNOR_CACHE_INVALID_TAG              0xFFFFFFFFU
+
+/**
+ * @brief   Erasing sector marker for a whole device erase.
+ */
+#define SNOR_ERASING_ALL                    ((flash_sector_t)0xFFFFFFFFU)
+
 /**
  * @name    Bus interface modes.
  * @{
@@ -65,6 +75,64 @@
 #if !defined(SNOR_SHARED_BUS) || defined(__DOXYGEN__)
 #define SNOR_SHARED_BUS                     TRUE
 #endif
+
+/**
+ * @brief   Read cache switch.
+ * @details If set to @p TRUE the driver keeps a cache of recently read
+ *          flash lines, small reads falling in cached lines do not
+ *          generate bus transactions.
+ * @note    Adjacent missing lines are fetched in a single burst and,
+ *          on sequential access, the line following the requested
+ *          area is prefetched.
+ */
+#if !defined(SNOR_USE_READ_CACHE) || defined(__DOXYGEN__)
+#define SNOR_USE_READ_CACHE                 FALSE
+#endif
+
+/**
+ * @brief   Number of lines in the read cache.
+ */
+#if !defined(SNOR_READ_CACHE_LINES) || defined(__DOXYGEN__)
+#define SNOR_READ_CACHE_LINES               4U
+#endif
+
+/**
+ * @brief   Size of a read cache line.
+ * @note    Must be a power of two not greater than the device
+ *          sector size.
+ */
+#if !defined(SNOR_READ_CACHE_LINE_SIZE) || defined(__DOXYGEN__)
+#define SNOR_READ_CACHE_LINE_SIZE           64U
+#endif
+
+/**
+ * @brief   Erase suspend switch.
+ * @details If set to @p TRUE a read operation issued while a sector erase
+ *          is in progress suspends the erase, reads the data and then
+ *          resumes the erase. Reads overlapping the sector being erased
+ *          still return @p FLASH_BUSY_ERASING.
+ * @note    Requires a device supporting erase suspend.
+ * @note    Frequent suspensions increase the total erase time.
+ */
+#if !defined(SNOR_USE_ERASE_SUSPEND) || defined(__DOXYGEN__)
+#define SNOR_USE_ERASE_SUSPEND              FALSE
+#endif
+
+/**
+ * @brief   Deferred erase queue switch.
+ * @details If set to @p TRUE sectors can be queued for erase, queued
+ *          erase operations are performed by @p snorServiceEraseQueue().
+ */
+#if !defined(SNOR_USE_ERASE_QUEUE) || defined(__DOXYGEN__)
+#define SNOR_USE_ERASE_QUEUE                FALSE
+#endif
+
+/**
+ * @brief   Deferred erase queue size.
+ */
+#if !defined(SNOR_ERASE_QUEUE_SIZE) || defined(__DOXYGEN__)
+#define SNOR_ERASE_QUEUE_SIZE               8U
+#endif
 /** @} */
 
 /*===========================================================================*/
@@ -81,6 +149,21 @@
 #error "invalid SNOR_BUS_DRIVER setting"
 #endif
 
+#if SNOR_USE_READ_CACHE == TRUE
+#if SNOR_READ_CACHE_LINES < 2U
+#error "SNOR_READ_CACHE_LINES must be at least 2"
+#endif
+
+#if (SNOR_READ_CACHE_LINE_SIZE == 0U) ||                                    \
+    ((SNOR_READ_CACHE_LINE_SIZE & (SNOR_READ_CACHE_LINE_SIZE - 1U)) != 0U)
+#error "SNOR_READ_CACHE_LINE_SIZE must be a power of two"
+#endif
+#endif
+
+#if (SNOR_USE_ERASE_QUEUE == TRUE) && (SNOR_ERASE_QUEUE_SIZE < 1U)
+#error "invalid SNOR_ERASE_QUEUE_SIZE value"
+#endif
+
 /*===========================================================================*/
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
@@ -138,6 +221,43 @@ typedef struct {
    * @brief   Device ID and unique ID.
    */
   uint8_t                       device_id[20];
+#if (SNOR_USE_READ_CACHE == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Flash line number held by each cache line.
+   * @note    Invalid lines are marked with @p SNOR_CACHE_INVALID_TAG.
+   */
+  uint32_t                      cache_tags[SNOR_READ_CACHE_LINES];
+  /**
+   * @brief   Offset following the last read, used to detect sequential
+   *          access.
+   */
+  flash_offset_t                cache_next;
+  /**
+   * @brief   Cache lines buffer.
+   */
+  uint8_t                       cache_buf[SNOR_READ_CACHE_LINES *
+                                          SNOR_READ_CACHE_LINE_SIZE];
+#endif
+#if (SNOR_USE_ERASE_SUSPEND == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Sector being erased or @p SNOR_ERASING_ALL.
+   */
+  flash_sector_t                erasing;
+#endif
+#if (SNOR_USE_ERASE_QUEUE == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Deferred erase queue.
+   */
+  flash_sector_t                erase_queue[SNOR_ERASE_QUEUE_SIZE];
+  /**
+   * @brief   Index of the first queued sector.
+   */
+  size_t                        erase_first;
+  /**
+   * @brief   Number of queued sectors.
+   */
+  size_t                        erase_count;
+#endif
 } SNORDriver;
 
 /*===========================================================================*/
@@ -191,6 +311,13 @@ extern "C" {
   void snorObjectInit(SNORDriver *devp);
   void snorStart(SNORDriver *devp, const SNORConfig *config);
   void snorStop(SNORDriver *devp);
+#if (SNOR_USE_READ_CACHE == TRUE) || defined(__DOXYGEN__)
+  void snorCacheInvalidate(SNORDriver *devp);
+#endif
+#if (SNOR_USE_ERASE_QUEUE == TRUE) || defined(__DOXYGEN__)
+  flash_error_t snorQueueEraseSector(SNORDriver *devp, flash_sector_t sector);
+  flash_error_t snorServiceEraseQueue(SNORDriver *devp, uint32_t *msec);
+#endif
 #if (SNOR_BUS_DRIVER == SNOR_BUS_DRIVER_WSPI) || defined(__DOXYGEN__)
 #if (WSPI_SUPPORTS_MEMMAP == TRUE) || defined(__DOXYGEN__)
   void snorMemoryMap(SNORDriver *devp, uint8_t ** addrp);
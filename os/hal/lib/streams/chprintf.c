@@ -28,6 +28,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 #include "chprintf.h"
 #include "memstreams.h"
@@ -35,6 +37,69 @@
 #define MAX_FILLER 11
 #define FLOAT_PRECISION 9
 
+/**
+ * @brief   Output context of a single formatting operation.
+ */
+typedef struct {
+  /**
+   * @brief   Destination stream.
+   */
+  BaseSequentialStream  *chp;
+#if (CHPRINTF_BUFFER_SIZE > 0) || defined(__DOXYGEN__)
+  /**
+   * @brief   Number of bytes pending in the buffer.
+   */
+  size_t                cnt;
+  /**
+   * @brief   Output buffer.
+   */
+  uint8_t               buf[CHPRINTF_BUFFER_SIZE];
+#endif
+} print_out_t;
+
+static void out_flush(print_out_t *op) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  if (op->cnt > 0U) {
+    (void) streamWrite(op->chp, op->buf, op->cnt);
+    op->cnt = 0U;
+  }
+#else
+  (void)op;
+#endif
+}
+
+static void out_put(print_out_t *op, char c) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  if (op->cnt >= (size_t)CHPRINTF_BUFFER_SIZE) {
+    out_flush(op);
+  }
+  op->buf[op->cnt++] = (uint8_t)c;
+#else
+  streamPut(op->chp, (uint8_t)c);
+#endif
+}
+
+static void out_write(print_out_t *op, const char *s, size_t n) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+  if (n > (size_t)CHPRINTF_BUFFER_SIZE - op->cnt) {
+    out_flush(op);
+
+    /* Runs not fitting the buffer are written directly.*/
+    if (n >= (size_t)CHPRINTF_BUFFER_SIZE) {
+      (void) streamWrite(op->chp, (const uint8_t *)s, n);
+      return;
+    }
+  }
+  memcpy(&op->buf[op->cnt], s, n);
+  op->cnt += n;
+#else
+  (void) streamWrite(op->chp, (const uint8_t *)s, n);
+#endif
+}
+
 static char *long_to_string_with_divisor(char *p,
                                          long num,
                                          unsigned radix,
@@ -96,33 +161,7 @@ static char *ftoa(char *p, double num, unsigned long precision) {
 }
 #endif
 
-/**
- * @brief   System formatted output function.
- * @details This function implements a minimal @p vprintf()-like functionality
- *          with output on a @p BaseSequentialStream.
- *          The general parameters format is: %[-][width|*][.precision|*][l|L]p.
- *          The following parameter types (p) are supported:
- *          - <b>x</b> hexadecimal integer.
- *          - <b>X</b> hexadecimal long.
- *          - <b>o</b> octal integer.
- *          - <b>O</b> octal long.
- *          - <b>d</b> decimal signed integer.
- *          - <b>D</b> decimal signed long.
- *          - <b>u</b> decimal unsigned integer.
- *          - <b>U</b> decimal unsigned long.
- *          - <b>c</b> character.
- *          - <b>s</b> string.
- *          .
- *
- * @param[in] chp       pointer to a @p BaseSequentialStream implementing object
- * @param[in] fmt       formatting string
- * @param[in] ap        list of parameters
- * @return              The number of bytes that would have been
- *                      written to @p chp if no stream error occurs
- *
- * @api
- */
-int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
+static int out_vprintf(print_out_t *op, const char *fmt, va_list ap) {
   char *p, *s, c, filler;
   int i, precision, width;
   int n = 0;
@@ -140,13 +179,19 @@ int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
     if (c == 0) {
       return n;
     }
-    
+
+    /* Literal runs are emitted as a whole.*/
     if (c != '%') {
-      streamPut(chp, (uint8_t)c);
-      n++;
+      const char *start = fmt - 1;
+
+      while ((*fmt != '\0') && (*fmt != '%')) {
+        fmt++;
+      }
+      out_write(op, start, (size_t)(fmt - start));
+      n += (int)(fmt - start);
       continue;
     }
-    
+
     p = tmpbuf;
     s = tmpbuf;
 
@@ -316,28 +361,72 @@ unsigned_common:
     }
     if (width < 0) {
       if ((*s == '-' || *s == '+') && filler == '0') {
-        streamPut(chp, (uint8_t)*s++);
+        out_put(op, *s++);
         n++;
         i--;
       }
       do {
-        streamPut(chp, (uint8_t)filler);
+        out_put(op, filler);
         n++;
       } while (++width != 0);
     }
-    while (--i >= 0) {
-      streamPut(chp, (uint8_t)*s++);
-      n++;
+    if (i > 0) {
+      out_write(op, s, (size_t)i);
+      n += i;
     }
 
     while (width) {
-      streamPut(chp, (uint8_t)filler);
+      out_put(op, filler);
       n++;
       width--;
     }
   }
 }
 
+/**
+ * @brief   System formatted output function.
+ * @details This function implements a minimal @p vprintf()-like functionality
+ *          with output on a @p BaseSequentialStream.
+ *          The general parameters format is: %[-][width|*][.precision|*][l|L]p.
+ *          The following parameter types (p) are supported:
+ *          - <b>x</b> hexadecimal integer.
+ *          - <b>X</b> hexadecimal long.
+ *          - <b>o</b> octal integer.
+ *          - <b>O</b> octal long.
+ *          - <b>d</b> decimal signed integer.
+ *          - <b>D</b> decimal signed long.
+ *          - <b>u</b> decimal unsigned integer.
+ *          - <b>U</b> decimal unsigned long.
+ *          - <b>c</b> character.
+ *          - <b>s</b> string.
+ *          .
+ * @note    Literal runs and formatted fields are written using
+ *          @p streamWrite(), if @p CHPRINTF_BUFFER_SIZE is not zero then
+ *          output is also collected in a local buffer and the stream is
+ *          only accessed when the buffer is full or before returning.
+ *
+ * @param[in] chp       pointer to a @p BaseSequentialStream implementing object
+ * @param[in] fmt       formatting string
+ * @param[in] ap        list of parameters
+ * @return              The number of bytes that would have been
+ *                      written to @p chp if no stream error occurs
+ *
+ * @api
+ */
+int chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap) {
+  print_out_t out;
+  int n;
+
+  out.chp = chp;
+#if CHPRINTF_BUFFER_SIZE > 0
+  out.cnt = 0U;
+#endif
+  n = out_vprintf(&out, fmt, ap);
+  out_flush(&out);
+
+  return n;
+}
+
 /**
  * @brief   System formatted output function.
  * @details This function implements a minimal @p printf() like functionality
@@ -34,6 +34,17 @@
 #define CHPRINTF_USE_FLOAT          FALSE
 #endif
 
+/**
+ * @brief   Size of the output buffer allocated on stack by @p chvprintf().
+ * @details If not zero then the formatted output is collected in a buffer
+ *          and written to the stream in blocks, this reduces the number of
+ *          stream calls at the cost of stack space.
+ * @note    Setting this option to zero disables buffering.
+ */
+#if !defined(CHPRINTF_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define CHPRINTF_BUFFER_SIZE        0
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -114,6 +114,16 @@ struct CRYDriver {
    * @brief   Current configuration data.
    */
   const CRYConfig           *config;
+#if (HAL_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Queue of pending requests.
+   */
+  cry_request_t             *rqueue;
+  /**
+   * @brief   Request being executed or @p NULL.
+   */
+  cry_request_t             *rcurrent;
+#endif
   /**
    * @brief   Algorithm type of transient key.
    */
@@ -0,0 +1,145 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_crypto_lld.c
+ * @brief   Simulator cryptographic subsystem low level driver source.
+ *
+ * @addtogroup CRYPTO
+ * @{
+ */
+
+#include "hal.h"
+
+#if ((HAL_USE_CRY == TRUE) && (HAL_CRY_ENFORCE_FALLBACK == FALSE)) ||       \
+    defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief CRY1 driver identifier.*/
+#if (USE_SIM_CRY1 == TRUE) || defined(__DOXYGEN__)
+CRYDriver CRYD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level crypto driver initialization.
+ *
+ * @notapi
+ */
+void cry_lld_init(void) {
+
+#if USE_SIM_CRY1 == TRUE
+  cryObjectInit(&CRYD1);
+#endif
+}
+
+/**
+ * @brief   Configures and activates the crypto peripheral.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ *
+ * @notapi
+ */
+void cry_lld_start(CRYDriver *cryp) {
+
+  (void)cryp;
+}
+
+/**
+ * @brief   Deactivates the crypto peripheral.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ *
+ * @notapi
+ */
+void cry_lld_stop(CRYDriver *cryp) {
+
+  (void)cryp;
+}
+
+#if (HAL_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts a queued request.
+ * @details The request is executed by the next simulated interrupt, the
+ *          caller is never blocked.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] reqp              pointer to the @p cry_request_t object
+ *
+ * @notapi
+ */
+void cry_lld_start_request(CRYDriver *cryp, cry_request_t *reqp) {
+
+  (void)cryp;
+  (void)reqp;
+}
+#endif
+
+/**
+ * @brief   Interrupt simulation.
+ * @details Executes the active request, if any, and signals its completion.
+ *
+ * @return                      The interrupt status.
+ * @retval false                if no interrupt occurred.
+ * @retval true                 if an interrupt occurred.
+ *
+ * @notapi
+ */
+bool cry_lld_interrupt_pending(void) {
+
+#if (USE_SIM_CRY1 == TRUE) && (HAL_CRY_USE_QUEUE == TRUE)
+  if (CRYD1.rcurrent != NULL) {
+    cryerror_t err;
+
+    OSAL_IRQ_PROLOGUE();
+
+    err = _cry_request_execute(&CRYD1, CRYD1.rcurrent);
+    _cry_queue_isr(&CRYD1, err);
+
+    OSAL_IRQ_EPILOGUE();
+
+    return true;
+  }
+#endif
+
+  return false;
+}
+
+#endif /* HAL_USE_CRY == TRUE */
+
+/** @} */
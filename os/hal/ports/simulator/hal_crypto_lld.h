@@ -0,0 +1,160 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_crypto_lld.h
+ * @brief   Simulator cryptographic subsystem low level driver header.
+ * @details The simulated peripheral has no algorithms of its own, all the
+ *          operations are performed by the HAL software fall-back. Queued
+ *          requests are executed asynchronously from the simulated
+ *          interrupt handler.
+ *
+ * @addtogroup CRYPTO
+ * @{
+ */
+
+#ifndef HAL_CRYPTO_LLD_H
+#define HAL_CRYPTO_LLD_H
+
+#if (HAL_USE_CRY == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Driver capability switches
+ * @{
+ */
+#define CRY_LLD_SUPPORTS_AES                FALSE
+#define CRY_LLD_SUPPORTS_AES_ECB            FALSE
+#define CRY_LLD_SUPPORTS_AES_CBC            FALSE
+#define CRY_LLD_SUPPORTS_AES_CFB            FALSE
+#define CRY_LLD_SUPPORTS_AES_CTR            FALSE
+#define CRY_LLD_SUPPORTS_AES_GCM            FALSE
+#define CRY_LLD_SUPPORTS_DES                FALSE
+#define CRY_LLD_SUPPORTS_DES_ECB            FALSE
+#define CRY_LLD_SUPPORTS_DES_CBC            FALSE
+#define CRY_LLD_SUPPORTS_SHA1               FALSE
+#define CRY_LLD_SUPPORTS_SHA256             FALSE
+#define CRY_LLD_SUPPORTS_SHA512             FALSE
+#define CRY_LLD_SUPPORTS_HMAC_SHA256        FALSE
+#define CRY_LLD_SUPPORTS_HMAC_SHA512        FALSE
+#define CRY_LLD_SUPPORTS_QUEUE              TRUE
+/** @} */
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   CRY1 driver enable switch.
+ * @details If set to @p TRUE the support for CRY1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_CRY1) || defined(__DOXYGEN__)
+#define USE_SIM_CRY1                        TRUE
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if HAL_CRY_USE_FALLBACK == FALSE
+#error "the simulated crypto driver requires HAL_CRY_USE_FALLBACK"
+#endif
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   CRY key identifier type.
+ */
+typedef uint_fast8_t crykey_t;
+
+/**
+ * @brief   Type of a structure representing an CRY driver.
+ */
+typedef struct CRYDriver CRYDriver;
+
+/**
+ * @brief   Driver configuration structure.
+ * @note    It could be empty on some architectures.
+ */
+typedef struct {
+  uint32_t                  dummy;
+} CRYConfig;
+
+/**
+ * @brief   Structure representing an CRY driver.
+ */
+struct CRYDriver {
+  /**
+   * @brief   Driver state.
+   */
+  crystate_t                state;
+  /**
+   * @brief   Current configuration data.
+   */
+  const CRYConfig           *config;
+#if (HAL_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Queue of pending requests.
+   */
+  cry_request_t             *rqueue;
+  /**
+   * @brief   Request being executed or @p NULL.
+   */
+  cry_request_t             *rcurrent;
+#endif
+#if defined(CRY_DRIVER_EXT_FIELDS)
+  CRY_DRIVER_EXT_FIELDS
+#endif
+  /* End of the mandatory fields.*/
+};
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (USE_SIM_CRY1 == TRUE) && !defined(__DOXYGEN__)
+extern CRYDriver CRYD1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void cry_lld_init(void);
+  void cry_lld_start(CRYDriver *cryp);
+  void cry_lld_stop(CRYDriver *cryp);
+#if HAL_CRY_USE_QUEUE == TRUE
+  void cry_lld_start_request(CRYDriver *cryp, cry_request_t *reqp);
+#endif
+  bool cry_lld_interrupt_pending(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_CRY == TRUE */
+
+#endif /* HAL_CRYPTO_LLD_H */
+
+/** @} */
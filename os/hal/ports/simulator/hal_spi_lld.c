@@ -0,0 +1,313 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_spi_lld.c
+ * @brief   Simulator SPI subsystem low level driver source.
+ *
+ * @addtogroup SPI
+ * @{
+ */
+
+#include "hal.h"
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Frame sent when there is no transmit buffer.
+ */
+#define SPI_IDLE_FRAME                      0xFFU
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/** @brief SPI1 driver identifier.*/
+#if (USE_SIM_SPI1 == TRUE) || defined(__DOXYGEN__)
+SPIDriver SPID1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Exchanges one frame with the simulated device.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] frame     the frame sent on MOSI
+ * @return              The frame received on MISO.
+ */
+static uint8_t spi_sim_exchange(SPIDriver *spip, uint8_t frame) {
+  const spi_sim_device_t *devp = spip->config->device;
+
+  if ((devp != NULL) && (devp->exchange != NULL)) {
+    return devp->exchange(devp->arg, frame);
+  }
+
+  return frame;
+}
+
+/**
+ * @brief   Prepares an asynchronous operation.
+ * @details The operation is executed by the next simulated interrupt.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of frames
+ * @param[in] txbuf     the pointer to the transmit buffer or @p NULL
+ * @param[out] rxbuf    the pointer to the receive buffer or @p NULL
+ */
+static void spi_sim_start(SPIDriver *spip, size_t n,
+                          const void *txbuf, void *rxbuf) {
+
+  spip->txbuf = (const uint8_t *)txbuf;
+  spip->rxbuf = (uint8_t *)rxbuf;
+  spip->n     = n;
+}
+
+/**
+ * @brief   Executes the operation in progress on a driver, if any.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @return              The interrupt status.
+ */
+static bool spi_sim_serve(SPIDriver *spip) {
+  size_t i;
+
+  if (spip->n == 0U) {
+    return false;
+  }
+
+  OSAL_IRQ_PROLOGUE();
+
+  for (i = 0U; i < spip->n; i++) {
+    uint8_t frame;
+
+    frame = spi_sim_exchange(spip, spip->txbuf != NULL ? spip->txbuf[i] :
+                                                         SPI_IDLE_FRAME);
+    if (spip->rxbuf != NULL) {
+      spip->rxbuf[i] = frame;
+    }
+  }
+
+  /* Clearing before the callback, it could start another operation.*/
+  spip->n = 0U;
+  _spi_isr_code(spip);
+
+  OSAL_IRQ_EPILOGUE();
+
+  return true;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level SPI driver initialization.
+ *
+ * @notapi
+ */
+void spi_lld_init(void) {
+
+#if USE_SIM_SPI1 == TRUE
+  spiObjectInit(&SPID1);
+  SPID1.n = 0U;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the SPI peripheral.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_start(SPIDriver *spip) {
+
+  (void)spip;
+}
+
+/**
+ * @brief   Deactivates the SPI peripheral.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_stop(SPIDriver *spip) {
+
+  spip->n = 0U;
+}
+
+#if (SPI_SELECT_MODE == SPI_SELECT_MODE_LLD) || defined(__DOXYGEN__)
+/**
+ * @brief   Asserts the slave select signal and prepares for transfers.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_select(SPIDriver *spip) {
+  const spi_sim_device_t *devp = spip->config->device;
+
+  if ((devp != NULL) && (devp->select != NULL)) {
+    devp->select(devp->arg);
+  }
+}
+
+/**
+ * @brief   Deasserts the slave select signal.
+ * @details The previously selected peripheral is unselected.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void spi_lld_unselect(SPIDriver *spip) {
+  const spi_sim_device_t *devp = spip->config->device;
+
+  if ((devp != NULL) && (devp->unselect != NULL)) {
+    devp->unselect(devp->arg);
+  }
+}
+#endif /* SPI_SELECT_MODE == SPI_SELECT_MODE_LLD */
+
+/**
+ * @brief   Ignores data on the SPI bus.
+ * @details This asynchronous function starts the transmission of a series of
+ *          idle words on the SPI bus and ignores the received data.
+ * @post    At the end of the operation the configured callback is invoked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to be ignored
+ *
+ * @notapi
+ */
+void spi_lld_ignore(SPIDriver *spip, size_t n) {
+
+  spi_sim_start(spip, n, NULL, NULL);
+}
+
+/**
+ * @brief   Exchanges data on the SPI bus.
+ * @details This asynchronous function starts a simultaneous transmit/receive
+ *          operation.
+ * @post    At the end of the operation the configured callback is invoked.
+ * @note    Only 8 bits frames are simulated.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to be exchanged
+ * @param[in] txbuf     the pointer to the transmit buffer
+ * @param[out] rxbuf    the pointer to the receive buffer
+ *
+ * @notapi
+ */
+void spi_lld_exchange(SPIDriver *spip, size_t n,
+                      const void *txbuf, void *rxbuf) {
+
+  spi_sim_start(spip, n, txbuf, rxbuf);
+}
+
+/**
+ * @brief   Sends data over the SPI bus.
+ * @details This asynchronous function starts a transmit operation.
+ * @post    At the end of the operation the configured callback is invoked.
+ * @note    Only 8 bits frames are simulated.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to send
+ * @param[in] txbuf     the pointer to the transmit buffer
+ *
+ * @notapi
+ */
+void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf) {
+
+  spi_sim_start(spip, n, txbuf, NULL);
+}
+
+/**
+ * @brief   Receives data from the SPI bus.
+ * @details This asynchronous function starts a receive operation.
+ * @post    At the end of the operation the configured callback is invoked.
+ * @note    Only 8 bits frames are simulated.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] n         number of words to receive
+ * @param[out] rxbuf    the pointer to the receive buffer
+ *
+ * @notapi
+ */
+void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf) {
+
+  spi_sim_start(spip, n, NULL, rxbuf);
+}
+
+/**
+ * @brief   Exchanges one frame using a polled wait.
+ * @details This synchronous function exchanges one frame using a polled
+ *          synchronization method. This function is useful when exchanging
+ *          small amount of data on high speed channels, usually in this
+ *          situation is much more efficient just wait for completion using
+ *          polling than suspending the thread waiting for an interrupt.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] frame     the data frame to send over the SPI bus
+ * @return              The received data frame from the SPI bus.
+ *
+ * @notapi
+ */
+uint16_t spi_lld_polled_exchange(SPIDriver *spip, uint16_t frame) {
+
+  return (uint16_t)spi_sim_exchange(spip, (uint8_t)frame);
+}
+
+/**
+ * @brief   Interrupt simulation.
+ * @details Executes the operation in progress, if any, and signals its
+ *          completion.
+ *
+ * @return              The interrupt status.
+ * @retval false        if no interrupt occurred.
+ * @retval true         if an interrupt occurred.
+ *
+ * @notapi
+ */
+bool spi_lld_interrupt_pending(void) {
+  bool int_occurred = false;
+
+#if USE_SIM_SPI1 == TRUE
+  int_occurred |= spi_sim_serve(&SPID1);
+#endif
+
+  return int_occurred;
+}
+
+#endif /* HAL_USE_SPI == TRUE */
+
+/** @} */
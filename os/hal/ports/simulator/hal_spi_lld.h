@@ -0,0 +1,144 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_spi_lld.h
+ * @brief   Simulator SPI subsystem low level driver header.
+ * @details Transfers are executed asynchronously from the simulated
+ *          interrupt handler. The device connected to the bus is modeled
+ *          by the @p spi_sim_device_t structure referred by the driver
+ *          configuration, without a device model the MOSI line is looped
+ *          back on MISO.
+ *
+ * @addtogroup SPI
+ * @{
+ */
+
+#ifndef HAL_SPI_LLD_H
+#define HAL_SPI_LLD_H
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Circular mode support flag.
+ */
+#define SPI_SUPPORTS_CIRCULAR               FALSE
+
+/*===========================================================================*/
+/* Driver pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   SPI1 driver enable switch.
+ * @details If set to @p TRUE the support for SPI1 is included.
+ * @note    The default is @p TRUE.
+ */
+#if !defined(USE_SIM_SPI1) || defined(__DOXYGEN__)
+#define USE_SIM_SPI1                        TRUE
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated SPI device.
+ * @details The callbacks are invoked in ISR context, all of them are
+ *          optional.
+ */
+typedef struct {
+  /**
+   * @brief   CS line asserted, only with @p SPI_SELECT_MODE_LLD.
+   */
+  void                      (*select)(void *arg);
+  /**
+   * @brief   CS line deasserted, only with @p SPI_SELECT_MODE_LLD.
+   */
+  void                      (*unselect)(void *arg);
+  /**
+   * @brief   Exchanges one frame, returns the frame sent on MISO.
+   */
+  uint8_t                   (*exchange)(void *arg, uint8_t frame);
+  /**
+   * @brief   Argument passed to the callbacks.
+   */
+  void                      *arg;
+} spi_sim_device_t;
+
+/*===========================================================================*/
+/* Driver macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level fields of the SPI driver structure.
+ */
+#define spi_lld_driver_fields                                               \
+  /* Frames of the operation in progress, zero if none.*/                   \
+  size_t                    n;                                              \
+  /* Transmit buffer or NULL.*/                                             \
+  const uint8_t             *txbuf;                                         \
+  /* Receive buffer or NULL.*/                                              \
+  uint8_t                   *rxbuf
+
+/**
+ * @brief   Low level fields of the SPI configuration structure.
+ */
+#define spi_lld_config_fields                                               \
+  /* Simulated device or NULL for a loop-back.*/                            \
+  const spi_sim_device_t    *device
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#if (USE_SIM_SPI1 == TRUE) && !defined(__DOXYGEN__)
+extern SPIDriver SPID1;
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void spi_lld_init(void);
+  void spi_lld_start(SPIDriver *spip);
+  void spi_lld_stop(SPIDriver *spip);
+#if (SPI_SELECT_MODE == SPI_SELECT_MODE_LLD) || defined(__DOXYGEN__)
+  void spi_lld_select(SPIDriver *spip);
+  void spi_lld_unselect(SPIDriver *spip);
+#endif
+  void spi_lld_ignore(SPIDriver *spip, size_t n);
+  void spi_lld_exchange(SPIDriver *spip, size_t n,
+                        const void *txbuf, void *rxbuf);
+  void spi_lld_send(SPIDriver *spip, size_t n, const void *txbuf);
+  void spi_lld_receive(SPIDriver *spip, size_t n, void *rxbuf);
+  uint16_t spi_lld_polled_exchange(SPIDriver *spip, uint16_t frame);
+  bool spi_lld_interrupt_pending(void);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_SPI == TRUE */
+
+#endif /* HAL_SPI_LLD_H */
+
+/** @} */
@@ -0,0 +1,634 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_usb_lld.c
+ * @brief   Simulator USB subsystem low level driver source.
+ *
+ * @addtogroup USB
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if (HAL_USE_USB == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @name    Simulated host enumeration steps
+ * @{
+ */
+#define USB_SIM_STEP_IDLE                   0U
+#define USB_SIM_STEP_RESET                  1U
+#define USB_SIM_STEP_SET_ADDRESS            2U
+#define USB_SIM_STEP_SET_CONFIGURATION      3U
+/** @} */
+
+/**
+ * @brief   Address assigned by the simulated host.
+ */
+#define USB_SIM_ADDRESS                     1U
+
+/**
+ * @brief   Configuration selected by the simulated host.
+ */
+#define USB_SIM_CONFIGURATION               1U
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   USB1 driver identifier.
+ */
+#if (USE_SIM_USB1 == TRUE) || defined(__DOXYGEN__)
+USBDriver USBD1;
+#endif
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   EP0 state.
+ * @note    It is an union because IN and OUT endpoints are never used at the
+ *          same time for EP0.
+ */
+static union {
+  /**
+   * @brief   IN EP0 state.
+   */
+  USBInEndpointState in;
+  /**
+   * @brief   OUT EP0 state.
+   */
+  USBOutEndpointState out;
+} ep0_state;
+
+/**
+ * @brief   EP0 initialization structure.
+ */
+static const USBEndpointConfig ep0config = {
+  USB_EP_MODE_TYPE_CTRL,
+  _usb_ep0setup,
+  _usb_ep0in,
+  _usb_ep0out,
+  0x40,
+  0x40,
+  &ep0_state.in,
+  &ep0_state.out
+};
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Checks if an IN endpoint has a transaction in progress.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @return              The transaction status.
+ */
+static bool usb_sim_in_active(USBDriver *usbp, usbep_t ep) {
+
+  return ((usbp->transmitting & (1U << ep)) != 0U) &&
+         ((usbp->sim_stalled_in & (1U << ep)) == 0U);
+}
+
+/**
+ * @brief   Checks if an OUT endpoint has a transaction in progress.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @return              The transaction status.
+ */
+static bool usb_sim_out_active(USBDriver *usbp, usbep_t ep) {
+
+  return ((usbp->receiving & (1U << ep)) != 0U) &&
+         ((usbp->sim_stalled_out & (1U << ep)) == 0U);
+}
+
+/**
+ * @brief   Sends a standard device request from the simulated host.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] req       request code
+ * @param[in] value     request value
+ */
+static void usb_sim_setup(USBDriver *usbp, uint8_t req, uint8_t value) {
+
+  memset(usbp->sim_setup, 0, sizeof usbp->sim_setup);
+  usbp->sim_setup[0] = USB_RTYPE_DIR_HOST2DEV | USB_RTYPE_TYPE_STD |
+                       USB_RTYPE_RECIPIENT_DEVICE;
+  usbp->sim_setup[1] = req;
+  usbp->sim_setup[2] = value;
+  _usb_isr_invoke_setup_cb(usbp, 0U);
+}
+
+/**
+ * @brief   Advances the enumeration performed by the simulated host.
+ * @details A new request is sent when the previous one has been completed
+ *          by the device.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @return              The interrupt status.
+ */
+static bool usb_sim_enumerate(USBDriver *usbp) {
+
+  switch (usbp->sim_step) {
+  case USB_SIM_STEP_RESET:
+    usbp->sim_step = USB_SIM_STEP_SET_ADDRESS;
+    _usb_reset(usbp);
+    return true;
+  case USB_SIM_STEP_SET_ADDRESS:
+  case USB_SIM_STEP_SET_CONFIGURATION:
+    if ((usbp->ep0state != USB_EP0_STP_WAITING) ||
+        ((usbp->transmitting & 1U) != 0U) ||
+        ((usbp->receiving & 1U) != 0U)) {
+      return false;
+    }
+    if (usbp->sim_step == USB_SIM_STEP_SET_ADDRESS) {
+      usbp->sim_step = USB_SIM_STEP_SET_CONFIGURATION;
+      usb_sim_setup(usbp, USB_REQ_SET_ADDRESS, USB_SIM_ADDRESS);
+    }
+    else {
+      usbp->sim_step = USB_SIM_STEP_IDLE;
+      usb_sim_setup(usbp, USB_REQ_SET_CONFIGURATION, USB_SIM_CONFIGURATION);
+    }
+    return true;
+  default:
+    return false;
+  }
+}
+
+/**
+ * @brief   Serves the control endpoint.
+ * @details The simulated host accepts all the data sent by the device and
+ *          only sends zero sized status packets.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @return              The interrupt status.
+ */
+static bool usb_sim_serve_ep0(USBDriver *usbp) {
+
+  if (usb_sim_in_active(usbp, 0U)) {
+    usbp->epc[0]->in_state->txcnt = usbp->epc[0]->in_state->txsize;
+    _usb_isr_invoke_in_cb(usbp, 0U);
+    return true;
+  }
+
+  if (usb_sim_out_active(usbp, 0U)) {
+    usbp->epc[0]->out_state->rxcnt = 0U;
+    _usb_isr_invoke_out_cb(usbp, 0U);
+    return true;
+  }
+
+  return false;
+}
+
+/**
+ * @brief   Serves a data endpoint.
+ * @details Packets are moved from the IN side to the OUT side until one of
+ *          the two transactions is complete. IN endpoints without an OUT
+ *          side are drained by the simulated host.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @return              The interrupt status.
+ */
+static bool usb_sim_serve_ep(USBDriver *usbp, usbep_t ep) {
+  const USBEndpointConfig *epcp = usbp->epc[ep];
+  USBInEndpointState *isp;
+  USBOutEndpointState *osp;
+  bool in_done = false, out_done = false;
+
+  if ((epcp == NULL) || !usb_sim_in_active(usbp, ep)) {
+    return false;
+  }
+
+  isp = epcp->in_state;
+  if (epcp->out_state == NULL) {
+    isp->txcnt = isp->txsize;
+    _usb_isr_invoke_in_cb(usbp, ep);
+    return true;
+  }
+
+  /* The host does not take data from the IN side until there is a
+     transaction on the OUT side, the packets are NAKed.*/
+  if (!usb_sim_out_active(usbp, ep)) {
+    return false;
+  }
+
+  osp = epcp->out_state;
+  while (!in_done && !out_done) {
+    size_t n, room;
+
+    n = isp->txsize - isp->txcnt;
+    if (n > (size_t)epcp->in_maxsize) {
+      n = (size_t)epcp->in_maxsize;
+    }
+
+    /* Data in excess of the receive transaction size is discarded.*/
+    room = osp->rxsize - osp->rxcnt;
+    if (room > n) {
+      room = n;
+    }
+    if (room > 0U) {
+      memcpy(osp->rxbuf + osp->rxcnt, isp->txbuf + isp->txcnt, room);
+      osp->rxcnt += room;
+    }
+    isp->txcnt += n;
+
+    /* A short packet terminates both the transactions, a zero sized
+       packet is sent only if the transaction size is zero.*/
+    in_done  = isp->txcnt >= isp->txsize;
+    out_done = (n < (size_t)epcp->out_maxsize) || (osp->rxcnt >= osp->rxsize);
+  }
+
+  if (out_done) {
+    _usb_isr_invoke_out_cb(usbp, ep);
+  }
+  if (in_done) {
+    _usb_isr_invoke_in_cb(usbp, ep);
+  }
+
+  return true;
+}
+
+/**
+ * @brief   Serves a driver.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @return              The interrupt status.
+ */
+static bool usb_sim_serve(USBDriver *usbp) {
+  bool int_occurred = false;
+  systime_t now;
+  usbep_t ep;
+
+  if (usbp->state == USB_STOP) {
+    return false;
+  }
+
+  OSAL_IRQ_PROLOGUE();
+
+  /* Start of frame every system tick.*/
+  now = osalOsGetSystemTimeX();
+  if (now != usbp->sim_frame_time) {
+    usbp->sim_frame_time = now;
+    usbp->sim_frame = (usbp->sim_frame + 1U) & 0x7FFU;
+    _usb_isr_invoke_sof_cb(usbp);
+    int_occurred = true;
+  }
+
+  if (usb_sim_enumerate(usbp)) {
+    int_occurred = true;
+  }
+
+  if (usbp->epc[0] != NULL) {
+    if (usb_sim_serve_ep0(usbp)) {
+      int_occurred = true;
+    }
+    for (ep = 1U; ep <= (usbep_t)USB_MAX_ENDPOINTS; ep++) {
+      if (usb_sim_serve_ep(usbp, ep)) {
+        int_occurred = true;
+      }
+    }
+  }
+
+  OSAL_IRQ_EPILOGUE();
+
+  return int_occurred;
+}
+
+/*===========================================================================*/
+/* Driver interrupt handlers and threads.                                    */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Low level USB driver initialization.
+ *
+ * @notapi
+ */
+void usb_lld_init(void) {
+
+#if USE_SIM_USB1 == TRUE
+  /* Driver initialization.*/
+  usbObjectInit(&USBD1);
+  USBD1.sim_step = USB_SIM_STEP_IDLE;
+#endif
+}
+
+/**
+ * @brief   Configures and activates the USB peripheral.
+ * @details The simulated host resets and configures the device.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_start(USBDriver *usbp) {
+
+  usbp->sim_step        = USB_SIM_STEP_RESET;
+  usbp->sim_stalled_in  = 0U;
+  usbp->sim_stalled_out = 0U;
+  usbp->sim_frame       = 0U;
+  usbp->sim_frame_time  = osalOsGetSystemTimeX();
+}
+
+/**
+ * @brief   Deactivates the USB peripheral.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_stop(USBDriver *usbp) {
+
+  usbp->sim_step = USB_SIM_STEP_IDLE;
+}
+
+/**
+ * @brief   USB low level reset routine.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_reset(USBDriver *usbp) {
+
+  /* Post reset initialization.*/
+  usbp->sim_stalled_in  = 0U;
+  usbp->sim_stalled_out = 0U;
+
+  /* EP0 initialization.*/
+  usbp->epc[0] = &ep0config;
+  usb_lld_init_endpoint(usbp, 0);
+}
+
+/**
+ * @brief   Sets the USB address.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_set_address(USBDriver *usbp) {
+
+  (void)usbp;
+}
+
+/**
+ * @brief   Enables an endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_init_endpoint(USBDriver *usbp, usbep_t ep) {
+
+  usbp->sim_stalled_in  &= (uint16_t)~(1U << ep);
+  usbp->sim_stalled_out &= (uint16_t)~(1U << ep);
+}
+
+/**
+ * @brief   Disables all the active endpoints except the endpoint zero.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ *
+ * @notapi
+ */
+void usb_lld_disable_endpoints(USBDriver *usbp) {
+
+  usbp->sim_stalled_in  &= 1U;
+  usbp->sim_stalled_out &= 1U;
+}
+
+/**
+ * @brief   Returns the status of an OUT endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @return              The endpoint status.
+ * @retval EP_STATUS_DISABLED The endpoint is not active.
+ * @retval EP_STATUS_STALLED  The endpoint is stalled.
+ * @retval EP_STATUS_ACTIVE   The endpoint is active.
+ *
+ * @notapi
+ */
+usbepstatus_t usb_lld_get_status_out(USBDriver *usbp, usbep_t ep) {
+
+  if ((usbp->epc[ep] == NULL) || (usbp->epc[ep]->out_state == NULL)) {
+    return EP_STATUS_DISABLED;
+  }
+  if ((usbp->sim_stalled_out & (1U << ep)) != 0U) {
+    return EP_STATUS_STALLED;
+  }
+  return EP_STATUS_ACTIVE;
+}
+
+/**
+ * @brief   Returns the status of an IN endpoint.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @return              The endpoint status.
+ * @retval EP_STATUS_DISABLED The endpoint is not active.
+ * @retval EP_STATUS_STALLED  The endpoint is stalled.
+ * @retval EP_STATUS_ACTIVE   The endpoint is active.
+ *
+ * @notapi
+ */
+usbepstatus_t usb_lld_get_status_in(USBDriver *usbp, usbep_t ep) {
+
+  if ((usbp->epc[ep] == NULL) || (usbp->epc[ep]->in_state == NULL)) {
+    return EP_STATUS_DISABLED;
+  }
+  if ((usbp->sim_stalled_in & (1U << ep)) != 0U) {
+    return EP_STATUS_STALLED;
+  }
+  return EP_STATUS_ACTIVE;
+}
+
+/**
+ * @brief   Reads a setup packet from the dedicated packet buffer.
+ * @details This function must be invoked in the context of the @p setup_cb
+ *          callback in order to read the received setup packet.
+ * @pre     In order to use this function the endpoint must have been
+ *          initialized as a control endpoint.
+ * @post    The endpoint is ready to accept another packet.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ * @param[out] buf      buffer where to copy the packet data
+ *
+ * @notapi
+ */
+void usb_lld_read_setup(USBDriver *usbp, usbep_t ep, uint8_t *buf) {
+
+  (void)ep;
+
+  /* A setup packet clears the stall condition of the control endpoint.*/
+  usbp->sim_stalled_in  &= (uint16_t)~1U;
+  usbp->sim_stalled_out &= (uint16_t)~1U;
+  memcpy(buf, usbp->sim_setup, sizeof usbp->sim_setup);
+}
+
+/**
+ * @brief   Prepares for a receive operation.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_prepare_receive(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+}
+
+/**
+ * @brief   Prepares for a transmit operation.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_prepare_transmit(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+}
+
+/**
+ * @brief   Starts a receive operation on an OUT endpoint.
+ * @details The transaction is served by the simulated interrupt handler.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_start_out(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+}
+
+/**
+ * @brief   Starts a transmit operation on an IN endpoint.
+ * @details The transaction is served by the simulated interrupt handler.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_start_in(USBDriver *usbp, usbep_t ep) {
+
+  (void)usbp;
+  (void)ep;
+}
+
+/**
+ * @brief   Brings an OUT endpoint in the stalled state.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_stall_out(USBDriver *usbp, usbep_t ep) {
+
+  usbp->sim_stalled_out |= (uint16_t)(1U << ep);
+}
+
+/**
+ * @brief   Brings an IN endpoint in the stalled state.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_stall_in(USBDriver *usbp, usbep_t ep) {
+
+  usbp->sim_stalled_in |= (uint16_t)(1U << ep);
+}
+
+/**
+ * @brief   Brings an OUT endpoint in the active state.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_clear_out(USBDriver *usbp, usbep_t ep) {
+
+  usbp->sim_stalled_out &= (uint16_t)~(1U << ep);
+}
+
+/**
+ * @brief   Brings an IN endpoint in the active state.
+ *
+ * @param[in] usbp      pointer to the @p USBDriver object
+ * @param[in] ep        endpoint number
+ *
+ * @notapi
+ */
+void usb_lld_clear_in(USBDriver *usbp, usbep_t ep) {
+
+  usbp->sim_stalled_in &= (uint16_t)~(1U << ep);
+}
+
+/**
+ * @brief   Interrupt simulation.
+ * @details Advances the simulated host and executes the transactions in
+ *          progress, if any.
+ *
+ * @return              The interrupt status.
+ * @retval false        if no interrupt occurred.
+ * @retval true         if an interrupt occurred.
+ *
+ * @notapi
+ */
+bool usb_lld_interrupt_pending(void) {
+  bool int_occurred = false;
+
+#if USE_SIM_USB1 == TRUE
+  int_occurred |= usb_sim_serve(&USBD1);
+#endif
+
+  return int_occurred;
+}
+
+#endif /* HAL_USE_USB == TRUE */
+
+/** @} */
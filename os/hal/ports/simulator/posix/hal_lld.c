@@ -24,6 +24,9 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
 #include <sys/time.h>
 
 #include "hal.h"
@@ -39,10 +42,61 @@
 static struct timeval nextcnt;
 static struct timeval tick = {0UL, 1000000UL / OSAL_ST_FREQUENCY};
 
+#if (SIM_USE_SYNTHETIC_IRQ == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Synthetic interrupt handler, @p NULL if the source is stopped.
+ */
+static sim_irq_handler_t sim_irq_handler;
+
+/**
+ * @brief   Synthetic interrupt pending flag, set by the host signal.
+ */
+static volatile sig_atomic_t sim_irq_pending;
+
+/**
+ * @brief   Host time of the pending synthetic interrupt.
+ * @note    Only written by the signal handler while no interrupt is pending.
+ */
+static volatile uint64_t sim_irq_raised;
+
+/**
+ * @brief   Signals received while an interrupt was already pending.
+ */
+static volatile uint32_t sim_irq_overruns;
+
+/**
+ * @brief   Alternate stack for the host signal handler.
+ * @note    Threads working areas are not sized for host signal frames.
+ */
+static uint8_t sim_irq_stack[16384];
+#endif
+
 /*===========================================================================*/
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (SIM_USE_SYNTHETIC_IRQ == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Host timer signal handler.
+ * @details The request is only latched here, it is serviced at the next
+ *          interrupts check like any other simulated interrupt source.
+ *
+ * @param[in] signo     signal number
+ */
+static void sim_irq_signal(int signo) {
+
+  (void)signo;
+
+  if (sim_irq_pending != 0) {
+    sim_irq_overruns++;
+  }
+  else {
+    sim_irq_raised  = sim_get_host_time_ns();
+    sim_irq_pending = 1;
+  }
+}
+#endif
+
 /*===========================================================================*/
 /* Driver interrupt handlers.                                                */
 /*===========================================================================*/
@@ -65,6 +119,93 @@ void hal_lld_init(void) {
   timeradd(&nextcnt, &tick, &nextcnt);
 }
 
+#if (SIM_USE_SYNTHETIC_IRQ == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Returns the host monotonic time.
+ *
+ * @return              The host time in nanoseconds.
+ */
+uint64_t sim_get_host_time_ns(void) {
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief   Starts the synthetic interrupts source.
+ * @details A periodic host signal is raised every @p period_us microseconds,
+ *          each one results in an invocation of @p handler from
+ *          @p _sim_check_for_interrupts().
+ * @note    Signals raised while the previous interrupt is still pending are
+ *          merged and counted as overruns.
+ *
+ * @param[in] period_us interrupts period in microseconds
+ * @param[in] handler   interrupt handler
+ */
+void sim_irq_start(uint32_t period_us, sim_irq_handler_t handler) {
+  struct sigaction sa;
+  struct itimerval itv;
+  stack_t ss;
+
+  osalDbgCheck((period_us > 0U) && (handler != NULL));
+
+  ss.ss_sp    = sim_irq_stack;
+  ss.ss_size  = sizeof sim_irq_stack;
+  ss.ss_flags = 0;
+  if (sigaltstack(&ss, NULL) != 0) {
+    perror("sigaltstack");
+    exit(1);
+  }
+
+  sim_irq_pending  = 0;
+  sim_irq_overruns = 0U;
+  sim_irq_handler  = handler;
+
+  memset(&sa, 0, sizeof sa);
+  sa.sa_handler = sim_irq_signal;
+  sa.sa_flags   = SA_RESTART | SA_ONSTACK;
+  sigemptyset(&sa.sa_mask);
+  if (sigaction(SIGALRM, &sa, NULL) != 0) {
+    perror("sigaction");
+    exit(1);
+  }
+
+  itv.it_interval.tv_sec  = (time_t)(period_us / 1000000U);
+  itv.it_interval.tv_usec = (suseconds_t)(period_us % 1000000U);
+  itv.it_value            = itv.it_interval;
+  if (setitimer(ITIMER_REAL, &itv, NULL) != 0) {
+    perror("setitimer");
+    exit(1);
+  }
+}
+
+/**
+ * @brief   Stops the synthetic interrupts source.
+ * @note    An interrupt already pending is discarded.
+ */
+void sim_irq_stop(void) {
+  struct itimerval itv;
+
+  memset(&itv, 0, sizeof itv);
+  (void) setitimer(ITIMER_REAL, &itv, NULL);
+  (void) signal(SIGALRM, SIG_IGN);
+
+  sim_irq_handler = NULL;
+  sim_irq_pending = 0;
+}
+
+/**
+ * @brief   Returns the number of merged synthetic interrupts.
+ *
+ * @return              Signals raised while an interrupt was still pending.
+ */
+uint32_t sim_irq_get_overruns(void) {
+
+  return sim_irq_overruns;
+}
+#endif /* SIM_USE_SYNTHETIC_IRQ == TRUE */
+
 /**
  * @brief   Interrupt simulation.
  */
@@ -78,6 +219,39 @@ void _sim_check_for_interrupts(void) {
   }
 #endif
 
+#if HAL_USE_CRY && !HAL_CRY_ENFORCE_FALLBACK
+  if (cry_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if HAL_USE_SPI
+  if (spi_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if HAL_USE_USB
+  if (usb_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if SIM_USE_SYNTHETIC_IRQ == TRUE
+  if ((sim_irq_pending != 0) && (sim_irq_handler != NULL)) {
+    uint64_t raised = sim_irq_raised;
+
+    sim_irq_pending = 0;
+    int_occurred = true;
+
+    CH_IRQ_PROLOGUE();
+
+    sim_irq_handler(raised);
+
+    CH_IRQ_EPILOGUE();
+  }
+#endif
+
   gettimeofday(&tv, NULL);
   if (timercmp(&tv, &nextcnt, >=)) {
     int_occurred = true;
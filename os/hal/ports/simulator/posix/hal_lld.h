@@ -53,6 +53,17 @@
 /* Driver pre-compile time settings.                                         */
 /*===========================================================================*/
 
+/**
+ * @brief   Synthetic interrupts source enable switch.
+ * @details If set to @p TRUE a host interval timer is made available, its
+ *          signal is serviced as an interrupt by
+ *          @p _sim_check_for_interrupts(). It is meant for measuring the
+ *          kernel interrupt and wakeup latencies on the host.
+ */
+#if !defined(SIM_USE_SYNTHETIC_IRQ) || defined(__DOXYGEN__)
+#define SIM_USE_SYNTHETIC_IRQ               FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -61,6 +72,17 @@
 /* Driver data structures and types.                                         */
 /*===========================================================================*/
 
+#if (SIM_USE_SYNTHETIC_IRQ == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a synthetic interrupt handler.
+ * @note    The handler is invoked in ISR context.
+ *
+ * @param[in] raised    host time of the interrupt request in nanoseconds,
+ *                      see @p sim_get_host_time_ns()
+ */
+typedef void (*sim_irq_handler_t)(uint64_t raised);
+#endif
+
 /*===========================================================================*/
 /* External declarations.                                                    */
 /*===========================================================================*/
@@ -70,6 +92,12 @@ extern "C" {
 #endif
   void hal_lld_init(void);
   void _sim_check_for_interrupts(void);
+#if SIM_USE_SYNTHETIC_IRQ == TRUE
+  uint64_t sim_get_host_time_ns(void);
+  void sim_irq_start(uint32_t period_us, sim_irq_handler_t handler);
+  void sim_irq_stop(void);
+  uint32_t sim_irq_get_overruns(void);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -147,7 +147,6 @@ abort:
 static bool inint(SerialDriver *sdp) {
 
   if (sdp->com_data != -1) {
-    int i;
     uint8_t data[32];
 
     /*
@@ -169,11 +168,9 @@ static bool inint(SerialDriver *sdp) {
       sdp->com_data = -1;
       return false;
     }
-    for (i = 0; i < n; i++) {
-      osalSysLockFromISR();
-      sdIncomingDataI(sdp, data[i]);
-      osalSysUnlockFromISR();
-    }
+    osalSysLockFromISR();
+    sdIncomingDataBlockI(sdp, data, (size_t)n);
+    osalSysUnlockFromISR();
     return true;
   }
   return false;
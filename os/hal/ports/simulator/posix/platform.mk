@@ -3,7 +3,12 @@ PLATFORMSRC = ${CHIBIOS}/os/hal/ports/simulator/posix/hal_lld.c \
               ${CHIBIOS}/os/hal/ports/simulator/posix/hal_serial_lld.c \
               ${CHIBIOS}/os/hal/ports/simulator/console.c \
               ${CHIBIOS}/os/hal/ports/simulator/hal_pal_lld.c \
-              ${CHIBIOS}/os/hal/ports/simulator/hal_st_lld.c
+              ${CHIBIOS}/os/hal/ports/simulator/hal_st_lld.c \
+              ${CHIBIOS}/os/hal/ports/simulator/hal_crypto_lld.c \
+              ${CHIBIOS}/os/hal/ports/simulator/hal_spi_lld.c \
+              ${CHIBIOS}/os/hal/ports/simulator/hal_usb_lld.c \
+              ${CHIBIOS}/os/hal/ports/simulator/sim_n25q.c \
+              ${CHIBIOS}/os/hal/ports/simulator/sim_lis3dsh.c
 
 # Required include directories
 PLATFORMINC = ${CHIBIOS}/os/hal/ports/simulator/posix \
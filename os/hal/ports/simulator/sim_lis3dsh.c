@@ -0,0 +1,188 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    sim_lis3dsh.c
+ * @brief   Simulated ST LIS3DSH accelerometer code.
+ *
+ * @addtogroup SIM_LIS3DSH
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "sim_lis3dsh.h"
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Frame returned when the device is not driving MISO.
+ */
+#define SIM_LIS3DSH_IDLE_FRAME              0xFFU
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables and types.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Checks if a register can be written through SPI.
+ *
+ * @param[in] reg       register address
+ * @return              The register write permission.
+ */
+static bool sim_lis3dsh_is_writable(uint8_t reg) {
+
+  /* Identification, status and output registers are read-only.*/
+  return (bool)((reg >= 0x10U) && (reg != 0x18U) &&
+                ((reg < SIM_LIS3DSH_AD_STATUS) ||
+                 (reg > SIM_LIS3DSH_AD_OUT_Z_H)));
+}
+
+/**
+ * @brief   Device CS asserted, a new access starts.
+ * @note    The CS line is asserted again at the start of each member of a
+ *          transactions group, only transitions start a new access.
+ *
+ * @param[in] arg       pointer to the @p sim_lis3dsh_t object
+ */
+static void sim_lis3dsh_select(void *arg) {
+  sim_lis3dsh_t *devp = (sim_lis3dsh_t *)arg;
+
+  if (!devp->selected) {
+    devp->selected = true;
+    devp->phase    = 0U;
+    devp->selects++;
+  }
+}
+
+/**
+ * @brief   Device CS deasserted.
+ *
+ * @param[in] arg       pointer to the @p sim_lis3dsh_t object
+ */
+static void sim_lis3dsh_unselect(void *arg) {
+  sim_lis3dsh_t *devp = (sim_lis3dsh_t *)arg;
+
+  devp->selected = false;
+}
+
+/**
+ * @brief   Device frame exchange.
+ *
+ * @param[in] arg       pointer to the @p sim_lis3dsh_t object
+ * @param[in] frame     frame received on MOSI
+ * @return              The frame sent on MISO.
+ */
+static uint8_t sim_lis3dsh_exchange(void *arg, uint8_t frame) {
+  sim_lis3dsh_t *devp = (sim_lis3dsh_t *)arg;
+  uint8_t reg;
+
+  if (devp->phase++ == 0U) {
+    devp->addr = frame & (uint8_t)(SIM_LIS3DSH_NUM_REGS - 1U);
+    devp->read = (bool)((frame & SIM_LIS3DSH_RW) != 0U);
+    return SIM_LIS3DSH_IDLE_FRAME;
+  }
+
+  reg = devp->addr;
+  if ((devp->regs[SIM_LIS3DSH_AD_CTRL_REG6] &
+       SIM_LIS3DSH_CTRL_REG6_ADD_INC) != 0U) {
+    devp->addr = (devp->addr + 1U) & (uint8_t)(SIM_LIS3DSH_NUM_REGS - 1U);
+  }
+
+  if (devp->read) {
+    devp->reads++;
+    if (reg == SIM_LIS3DSH_AD_OUT_Z_H) {
+      /* New data flag cleared by reading the last output register.*/
+      devp->regs[SIM_LIS3DSH_AD_STATUS] &= ~SIM_LIS3DSH_STATUS_ZYXDA;
+    }
+    return devp->regs[reg];
+  }
+
+  devp->writes++;
+  if (sim_lis3dsh_is_writable(reg)) {
+    devp->regs[reg] = frame;
+  }
+  return SIM_LIS3DSH_IDLE_FRAME;
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a simulated LIS3DSH device.
+ * @details The registers are set to their reset values.
+ *
+ * @param[out] devp     pointer to the @p sim_lis3dsh_t object
+ *
+ * @init
+ */
+void simLIS3DSHObjectInit(sim_lis3dsh_t *devp) {
+
+  osalDbgCheck(devp != NULL);
+
+  memset(devp, 0, sizeof (sim_lis3dsh_t));
+  devp->device.select   = sim_lis3dsh_select;
+  devp->device.unselect = sim_lis3dsh_unselect;
+  devp->device.exchange = sim_lis3dsh_exchange;
+  devp->device.arg      = devp;
+  devp->regs[SIM_LIS3DSH_AD_WHO_AM_I] = SIM_LIS3DSH_WHO_AM_I;
+  devp->regs[SIM_LIS3DSH_AD_CTRL_REG4] = 0x07U;
+  devp->regs[SIM_LIS3DSH_AD_CTRL_REG6] = SIM_LIS3DSH_CTRL_REG6_ADD_INC;
+}
+
+/**
+ * @brief   Sets a new sample in the output registers.
+ *
+ * @param[in] devp      pointer to the @p sim_lis3dsh_t object
+ * @param[in] x         X axis raw value
+ * @param[in] y         Y axis raw value
+ * @param[in] z         Z axis raw value
+ *
+ * @iclass
+ */
+void simLIS3DSHSetAxesI(sim_lis3dsh_t *devp,
+                        int16_t x, int16_t y, int16_t z) {
+  uint8_t *p = &devp->regs[SIM_LIS3DSH_AD_OUT_X_L];
+
+  osalDbgCheckClassI();
+  osalDbgCheck(devp != NULL);
+
+  p[0] = (uint8_t)((uint16_t)x & 0xFFU);
+  p[1] = (uint8_t)((uint16_t)x >> 8);
+  p[2] = (uint8_t)((uint16_t)y & 0xFFU);
+  p[3] = (uint8_t)((uint16_t)y >> 8);
+  p[4] = (uint8_t)((uint16_t)z & 0xFFU);
+  p[5] = (uint8_t)((uint16_t)z >> 8);
+  devp->regs[SIM_LIS3DSH_AD_STATUS] |= SIM_LIS3DSH_STATUS_ZYXDA;
+}
+
+#endif /* HAL_USE_SPI == TRUE */
+
+/** @} */
@@ -0,0 +1,165 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    sim_lis3dsh.h
+ * @brief   Simulated ST LIS3DSH accelerometer header.
+ * @details The model implements the SPI registers access protocol of the
+ *          device, the first frame after the CS assertion is the register
+ *          address with the read flag in bit 7, the address is incremented
+ *          after each data frame if @p ADD_INC is set in @p CTRL_REG6.
+ *          The output registers are set by the application.
+ *
+ * @addtogroup SIM_LIS3DSH
+ * @{
+ */
+
+#ifndef SIM_LIS3DSH_H
+#define SIM_LIS3DSH_H
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Number of register addresses.
+ */
+#define SIM_LIS3DSH_NUM_REGS                0x80U
+
+/**
+ * @name    Registers
+ * @{
+ */
+#define SIM_LIS3DSH_AD_WHO_AM_I             0x0FU
+#define SIM_LIS3DSH_AD_CTRL_REG4            0x20U
+#define SIM_LIS3DSH_AD_CTRL_REG5            0x24U
+#define SIM_LIS3DSH_AD_CTRL_REG6            0x25U
+#define SIM_LIS3DSH_AD_STATUS               0x27U
+#define SIM_LIS3DSH_AD_OUT_X_L              0x28U
+#define SIM_LIS3DSH_AD_OUT_Z_H              0x2DU
+/** @} */
+
+/**
+ * @name    Registers values
+ * @{
+ */
+#define SIM_LIS3DSH_WHO_AM_I                0x3FU
+#define SIM_LIS3DSH_CTRL_REG6_ADD_INC       0x10U
+#define SIM_LIS3DSH_STATUS_ZYXDA            0x08U
+/** @} */
+
+/**
+ * @brief   Read flag in the address frame.
+ */
+#define SIM_LIS3DSH_RW                      0x80U
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated LIS3DSH device.
+ */
+typedef struct {
+  /**
+   * @brief   SPI device interface, to be referred by the SPI configuration.
+   */
+  spi_sim_device_t          device;
+  /**
+   * @brief   CS line asserted.
+   */
+  bool                      selected;
+  /**
+   * @brief   Registers file.
+   */
+  uint8_t                   regs[SIM_LIS3DSH_NUM_REGS];
+  /**
+   * @brief   Frames exchanged since the CS line assertion.
+   */
+  uint32_t                  phase;
+  /**
+   * @brief   Current register address.
+   */
+  uint8_t                   addr;
+  /**
+   * @brief   Current access is a read.
+   */
+  bool                      read;
+  /**
+   * @brief   Number of CS assertions.
+   */
+  uint32_t                  selects;
+  /**
+   * @brief   Number of registers read.
+   */
+  uint32_t                  reads;
+  /**
+   * @brief   Number of registers written.
+   */
+  uint32_t                  writes;
+} sim_lis3dsh_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the SPI device interface of a simulated LIS3DSH.
+ *
+ * @param[in] devp      pointer to the @p sim_lis3dsh_t object
+ * @return              Pointer to the @p spi_sim_device_t interface.
+ */
+#define simLIS3DSHGetDevice(devp) (&(devp)->device)
+
+/**
+ * @brief   Returns the value of a register.
+ *
+ * @param[in] devp      pointer to the @p sim_lis3dsh_t object
+ * @param[in] reg       register address
+ * @return              The register value.
+ */
+#define simLIS3DSHGetRegister(devp, reg)                                    \
+  ((devp)->regs[(reg) & (SIM_LIS3DSH_NUM_REGS - 1U)])
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void simLIS3DSHObjectInit(sim_lis3dsh_t *devp);
+  void simLIS3DSHSetAxesI(sim_lis3dsh_t *devp,
+                          int16_t x, int16_t y, int16_t z);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_SPI == TRUE */
+
+#endif /* SIM_LIS3DSH_H */
+
+/** @} */
@@ -0,0 +1,222 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    sim_n25q.c
+ * @brief   Simulated Micron N25Q serial NOR flash code.
+ *
+ * @addtogroup SIM_N25Q
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+#include "sim_n25q.h"
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Frame returned when the device is not driving MISO.
+ */
+#define SIM_N25Q_IDLE_FRAME                 0xFFU
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Manufacturer and memory type identifiers, N25Q at 3V.
+ */
+static const uint8_t sim_n25q_id[2] = {0x20U, 0xBAU};
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+/**
+ * @brief   Device CS asserted, a new command starts.
+ *
+ * @param[in] arg       pointer to the @p sim_n25q_t object
+ */
+static void sim_n25q_select(void *arg) {
+  sim_n25q_t *devp = (sim_n25q_t *)arg;
+
+  devp->phase = 0U;
+  devp->addr  = 0U;
+}
+
+/**
+ * @brief   Device CS deasserted, commands are executed here.
+ *
+ * @param[in] arg       pointer to the @p sim_n25q_t object
+ */
+static void sim_n25q_unselect(void *arg) {
+  sim_n25q_t *devp = (sim_n25q_t *)arg;
+  bool busy = (bool)(devp->erase_polls > 0U);
+
+  switch (devp->cmd) {
+  case SIM_N25Q_CMD_WRITE_ENABLE:
+    devp->wel = true;
+    break;
+  case SIM_N25Q_CMD_PAGE_PROGRAM:
+    devp->wel = false;
+    break;
+  case SIM_N25Q_CMD_SUBSECTOR_ERASE:
+  case SIM_N25Q_CMD_SECTOR_ERASE:
+  case SIM_N25Q_CMD_BULK_ERASE:
+    if (devp->wel && !busy) {
+      if (devp->cmd == SIM_N25Q_CMD_BULK_ERASE) {
+        devp->erase_start = 0U;
+        devp->erase_size  = (uint32_t)devp->size;
+      }
+      else {
+        devp->erase_size  = devp->cmd == SIM_N25Q_CMD_SECTOR_ERASE ?
+                            0x10000U : 0x1000U;
+        devp->erase_start = (devp->addr % (uint32_t)devp->size) &
+                            ~(devp->erase_size - 1U);
+      }
+      devp->erase_polls = devp->erase_length;
+    }
+    devp->wel = false;
+    break;
+  case SIM_N25Q_CMD_ERASE_SUSPEND:
+    if (busy && !devp->suspended) {
+      devp->suspended = true;
+      devp->suspends++;
+    }
+    break;
+  case SIM_N25Q_CMD_ERASE_RESUME:
+    devp->suspended = false;
+    break;
+  default:
+    break;
+  }
+}
+
+/**
+ * @brief   Device frame exchange.
+ *
+ * @param[in] arg       pointer to the @p sim_n25q_t object
+ * @param[in] frame     frame received on MOSI
+ * @return              The frame sent on MISO.
+ */
+static uint8_t sim_n25q_exchange(void *arg, uint8_t frame) {
+  sim_n25q_t *devp = (sim_n25q_t *)arg;
+  uint32_t phase = devp->phase++;
+  uint32_t offset;
+
+  if (phase == 0U) {
+    devp->cmd = frame;
+    if (frame == SIM_N25Q_CMD_READ) {
+      devp->reads++;
+    }
+    return SIM_N25Q_IDLE_FRAME;
+  }
+
+  switch (devp->cmd) {
+  case SIM_N25Q_CMD_READ_ID:
+    if (phase <= sizeof sim_n25q_id) {
+      return sim_n25q_id[phase - 1U];
+    }
+    if (phase == 3U) {
+      /* Capacity as a power of two.*/
+      for (offset = 0U; (1U << offset) < devp->size; offset++) {
+      }
+      return (uint8_t)offset;
+    }
+    return 0U;
+  case SIM_N25Q_CMD_READ_FLAG_STATUS:
+    if (devp->suspended) {
+      return SIM_N25Q_FLAGS_READY | SIM_N25Q_FLAGS_ERASE_SUSPEND;
+    }
+    if (devp->erase_polls > 0U) {
+      if (--devp->erase_polls > 0U) {
+        return 0U;
+      }
+      memset(&devp->mem[devp->erase_start], 0xFF, devp->erase_size);
+    }
+    return SIM_N25Q_FLAGS_READY;
+  case SIM_N25Q_CMD_READ:
+  case SIM_N25Q_CMD_PAGE_PROGRAM:
+  case SIM_N25Q_CMD_SUBSECTOR_ERASE:
+  case SIM_N25Q_CMD_SECTOR_ERASE:
+    if (phase <= 3U) {
+      devp->addr = (devp->addr << 8) | frame;
+      return SIM_N25Q_IDLE_FRAME;
+    }
+    offset = devp->addr + phase - 4U;
+    if (devp->cmd == SIM_N25Q_CMD_READ) {
+      devp->read_bytes++;
+      offset %= (uint32_t)devp->size;
+      if ((devp->erase_polls > 0U) && (offset >= devp->erase_start) &&
+          (offset < devp->erase_start + devp->erase_size)) {
+        return 0x00U;
+      }
+      return devp->mem[offset];
+    }
+    if ((devp->cmd == SIM_N25Q_CMD_PAGE_PROGRAM) && devp->wel &&
+        (devp->erase_polls == 0U)) {
+      /* Page wrap-around.*/
+      offset = (devp->addr & ~0xFFU) | (offset & 0xFFU);
+      devp->mem[offset % (uint32_t)devp->size] &= frame;
+    }
+    return SIM_N25Q_IDLE_FRAME;
+  default:
+    return SIM_N25Q_IDLE_FRAME;
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a simulated N25Q device.
+ * @note    The memory array content is not modified.
+ *
+ * @param[out] devp     pointer to the @p sim_n25q_t object
+ * @param[in] mem       pointer to the memory array
+ * @param[in] size      size of the memory array, a multiple of 64kB
+ *
+ * @init
+ */
+void simN25QObjectInit(sim_n25q_t *devp, uint8_t *mem, size_t size) {
+
+  osalDbgCheck((devp != NULL) && (mem != NULL) &&
+               (size > 0U) && ((size & 0xFFFFU) == 0U));
+
+  memset(devp, 0, sizeof (sim_n25q_t));
+  devp->device.select   = sim_n25q_select;
+  devp->device.unselect = sim_n25q_unselect;
+  devp->device.exchange = sim_n25q_exchange;
+  devp->device.arg      = devp;
+  devp->mem             = mem;
+  devp->size            = size;
+  devp->erase_length    = SIM_N25Q_ERASE_POLLS;
+}
+
+#endif /* HAL_USE_SPI == TRUE */
+
+/** @} */
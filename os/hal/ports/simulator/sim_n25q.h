@@ -0,0 +1,183 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    sim_n25q.h
+ * @brief   Simulated Micron N25Q serial NOR flash header.
+ * @details The model implements the subset of the N25Q commands used by
+ *          the serial NOR driver in SPI mode: identification, read, page
+ *          program, erase, erase suspend/resume and flag status polling.
+ *          An erase operation progresses on each status read, the content
+ *          of the area being erased is undefined until its end.
+ *
+ * @addtogroup SIM_N25Q
+ * @{
+ */
+
+#ifndef SIM_N25Q_H
+#define SIM_N25Q_H
+
+#if (HAL_USE_SPI == TRUE) || defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Supported commands
+ * @{
+ */
+#define SIM_N25Q_CMD_READ_ID                0x9FU
+#define SIM_N25Q_CMD_READ                   0x03U
+#define SIM_N25Q_CMD_WRITE_ENABLE           0x06U
+#define SIM_N25Q_CMD_READ_FLAG_STATUS       0x70U
+#define SIM_N25Q_CMD_PAGE_PROGRAM           0x02U
+#define SIM_N25Q_CMD_SUBSECTOR_ERASE        0x20U
+#define SIM_N25Q_CMD_SECTOR_ERASE           0xD8U
+#define SIM_N25Q_CMD_BULK_ERASE             0xC7U
+#define SIM_N25Q_CMD_ERASE_RESUME           0x7AU
+#define SIM_N25Q_CMD_ERASE_SUSPEND          0x75U
+/** @} */
+
+/**
+ * @name    Flag status register bits
+ * @{
+ */
+#define SIM_N25Q_FLAGS_READY                0x80U
+#define SIM_N25Q_FLAGS_ERASE_SUSPEND        0x40U
+/** @} */
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Default number of status reads required by an erase operation.
+ */
+#if !defined(SIM_N25Q_ERASE_POLLS) || defined(__DOXYGEN__)
+#define SIM_N25Q_ERASE_POLLS                4U
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if SIM_N25Q_ERASE_POLLS < 1U
+#error "invalid SIM_N25Q_ERASE_POLLS value"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Simulated N25Q device.
+ */
+typedef struct {
+  /**
+   * @brief   SPI device interface, to be referred by the SPI configuration.
+   */
+  spi_sim_device_t          device;
+  /**
+   * @brief   Memory array.
+   */
+  uint8_t                   *mem;
+  /**
+   * @brief   Memory array size, a multiple of the sector size.
+   */
+  size_t                    size;
+  /**
+   * @brief   Current command.
+   */
+  uint8_t                   cmd;
+  /**
+   * @brief   Frames exchanged since the CS line assertion.
+   */
+  uint32_t                  phase;
+  /**
+   * @brief   Address of the current command.
+   */
+  uint32_t                  addr;
+  /**
+   * @brief   Write enable latch.
+   */
+  bool                      wel;
+  /**
+   * @brief   Status reads required by an erase operation.
+   * @note    Initialized to @p SIM_N25Q_ERASE_POLLS, it can be changed by
+   *          the application in order to simulate longer erase times,
+   *          it must be at least one.
+   */
+  uint32_t                  erase_length;
+  /**
+   * @brief   Start of the area being erased.
+   */
+  uint32_t                  erase_start;
+  /**
+   * @brief   Size of the area being erased.
+   */
+  uint32_t                  erase_size;
+  /**
+   * @brief   Status reads before the end of the erase, zero if idle.
+   */
+  uint32_t                  erase_polls;
+  /**
+   * @brief   Erase suspended.
+   */
+  bool                      suspended;
+  /**
+   * @brief   Number of read commands executed.
+   */
+  uint32_t                  reads;
+  /**
+   * @brief   Number of bytes read.
+   */
+  uint32_t                  read_bytes;
+  /**
+   * @brief   Number of erase suspensions.
+   */
+  uint32_t                  suspends;
+} sim_n25q_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Returns the SPI device interface of a simulated N25Q.
+ *
+ * @param[in] devp      pointer to the @p sim_n25q_t object
+ * @return              Pointer to the @p spi_sim_device_t interface.
+ */
+#define simN25QGetDevice(devp) (&(devp)->device)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void simN25QObjectInit(sim_n25q_t *devp, uint8_t *mem, size_t size);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HAL_USE_SPI == TRUE */
+
+#endif /* SIM_N25Q_H */
+
+/** @} */
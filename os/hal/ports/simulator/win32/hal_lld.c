@@ -84,6 +84,24 @@ void _sim_check_for_interrupts(void) {
   }
 #endif
 
+#if HAL_USE_CRY && !HAL_CRY_ENFORCE_FALLBACK
+  if (cry_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if HAL_USE_SPI
+  if (spi_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
+#if HAL_USE_USB
+  if (usb_lld_interrupt_pending()) {
+    int_occurred = true;
+  }
+#endif
+
   /* Interrupt Timer simulation (10ms interval).*/
   QueryPerformanceCounter(&n);
   if (n.QuadPart > nextcnt.QuadPart) {
@@ -127,7 +127,6 @@ abort:
 static bool inint(SerialDriver *sdp) {
 
   if (sdp->com_data != INVALID_SOCKET) {
-    int i;
     uint8_t data[32];
 
     /*
@@ -149,11 +148,9 @@ static bool inint(SerialDriver *sdp) {
       sdp->com_data = INVALID_SOCKET;
       return false;
     }
-    for (i = 0; i < n; i++) {
-      chSysLockFromISR();
-      sdIncomingDataI(sdp, data[i]);
-      chSysUnlockFromISR();
-    }
+    chSysLockFromISR();
+    sdIncomingDataBlockI(sdp, data, (size_t)n);
+    chSysUnlockFromISR();
     return true;
   }
   return false;
@@ -56,6 +56,32 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Posts the current buffer in an output queue.
+ * @note    The notification callback is not invoked, it is responsibility
+ *          of the caller.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[in] size      used size of the buffer, cannot be zero
+ *
+ * @notapi
+ */
+static void obq_post_buffer(output_buffers_queue_t *obqp, size_t size) {
+
+  /* Writing size field in the buffer.*/
+  *((size_t *)obqp->bwrptr) = size;
+
+  /* Posting the buffer in the queue.*/
+  obqp->bcounter--;
+  obqp->bwrptr += obqp->bsize;
+  if (obqp->bwrptr >= obqp->btop) {
+    obqp->bwrptr = obqp->buffers;
+  }
+
+  /* No "current" buffer.*/
+  obqp->ptr = NULL;
+}
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -416,6 +442,82 @@ size_t ibqReadTimeout(input_buffers_queue_t *ibqp, uint8_t *bp,
   }
 }
 
+/**
+ * @brief   Gets a direct view of the data in the current input buffer.
+ * @details The function returns a pointer to the unread data in the current
+ *          filled buffer, a new buffer is acquired if there is no current
+ *          buffer. The data can be accessed in place then released, all
+ *          or in part, using @p ibqConsume().
+ * @note    The returned view is valid until the data is consumed or the
+ *          queue is reset.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[out] bpp      pointer to a variable receiving the data pointer
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes accessible through the view.
+ * @retval 0            if a timeout occurred or the queue has been reset.
+ *
+ * @api
+ */
+size_t ibqGetViewTimeout(input_buffers_queue_t *ibqp, uint8_t **bpp,
+                         sysinterval_t timeout) {
+  size_t n;
+
+  osalDbgCheck(bpp != NULL);
+
+  osalSysLock();
+
+  /* This condition indicates that a new buffer must be acquired.*/
+  if (ibqp->ptr == NULL) {
+    msg_t msg;
+
+    msg = ibqGetFullBufferTimeoutS(ibqp, timeout);
+    if (msg != MSG_OK) {
+      osalSysUnlock();
+      return (size_t)0;
+    }
+  }
+
+  *bpp = ibqp->ptr;
+  n = (size_t)ibqp->top - (size_t)ibqp->ptr;
+
+  osalSysUnlock();
+  return n;
+}
+
+/**
+ * @brief   Consumes data from the current input buffer.
+ * @details The specified amount of data, previously accessed through
+ *          @p ibqGetViewTimeout(), is marked as read. The buffer is returned
+ *          to the queue when it has been fully consumed.
+ *
+ * @param[in] ibqp      pointer to the @p input_buffers_queue_t object
+ * @param[in] n         number of bytes to be consumed, it cannot exceed the
+ *                      size returned by @p ibqGetViewTimeout()
+ *
+ * @api
+ */
+void ibqConsume(input_buffers_queue_t *ibqp, size_t n) {
+
+  osalSysLock();
+
+  osalDbgAssert(ibqp->ptr != NULL, "no current buffer");
+  osalDbgCheck(n <= ((size_t)ibqp->top - (size_t)ibqp->ptr));
+
+  ibqp->ptr += n;
+
+  /* Has the current data buffer been finished? if so then release it.*/
+  if (ibqp->ptr >= ibqp->top) {
+    ibqReleaseEmptyBufferS(ibqp);
+  }
+
+  osalSysUnlock();
+}
+
 /**
  * @brief   Initializes an output buffers queue object.
  *
@@ -629,18 +731,7 @@ void obqPostFullBufferS(output_buffers_queue_t *obqp, size_t size) {
   osalDbgCheck((size > 0U) && (size <= (obqp->bsize - sizeof (size_t))));
   osalDbgAssert(!obqIsFullI(obqp), "buffers queue full");
 
-  /* Writing size field in the buffer.*/
-  *((size_t *)obqp->bwrptr) = size;
-
-  /* Posting the buffer in the queue.*/
-  obqp->bcounter--;
-  obqp->bwrptr += obqp->bsize;
-  if (obqp->bwrptr >= obqp->btop) {
-    obqp->bwrptr = obqp->buffers;
-  }
-
-  /* No "current" buffer.*/
-  obqp->ptr = NULL;
+  obq_post_buffer(obqp, size);
 
   /* Notifying the buffer release.*/
   if (obqp->notify != NULL) {
@@ -779,6 +870,195 @@ size_t obqWriteTimeout(output_buffers_queue_t *obqp, const uint8_t *bp,
   }
 }
 
+/**
+ * @brief   Output queue vectored write with timeout.
+ * @details The function writes data from a list of buffers to an output
+ *          queue. The operation completes when all the specified data has
+ *          been transferred or after the specified timeout or if the queue
+ *          has been reset.
+ * @note    Filled buffers are posted in the queue but the notification
+ *          callback is invoked only once, after all the data has been
+ *          transferred or before waiting for an empty buffer. This allows
+ *          the low level driver to process several buffers in a single
+ *          transaction.
+ * @note    Elements with zero size are skipped without acquiring a buffer.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[in] iovp      pointer to an array of @p bqiovec_t elements
+ * @param[in] iovcnt    number of elements in the array, the value 0 is
+ *                      reserved
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes effectively transferred.
+ * @retval 0            if a timeout occurred.
+ *
+ * @api
+ */
+size_t obqWriteVTimeout(output_buffers_queue_t *obqp, const bqiovec_t *iovp,
+                        size_t iovcnt, sysinterval_t timeout) {
+  size_t w = 0, offset = 0;
+  bool posted = false;
+
+  osalDbgCheck((iovp != NULL) && (iovcnt > 0U));
+
+  osalSysLock();
+
+  while (iovcnt > 0U) {
+    size_t size;
+
+    /* Empty elements are skipped, a buffer must not be acquired for them.*/
+    if (iovp->size == 0U) {
+      iovp++;
+      iovcnt--;
+      continue;
+    }
+
+    /* This condition indicates that a new buffer must be acquired.*/
+    if (obqp->ptr == NULL) {
+      msg_t msg;
+
+      /* Buffers posted so far must be notified before waiting, the
+         consumer side would not free any buffer otherwise.*/
+      if (posted && obqIsFullI(obqp)) {
+        posted = false;
+        if (obqp->notify != NULL) {
+          obqp->notify(obqp);
+        }
+      }
+
+      /* Getting an empty buffer using the specified timeout.*/
+      msg = obqGetEmptyBufferTimeoutS(obqp, timeout);
+
+      /* Anything except MSG_OK interrupts the operation.*/
+      if (msg != MSG_OK) {
+        break;
+      }
+    }
+
+    /* Size of the space available in the current buffer.*/
+    size = (size_t)obqp->top - (size_t)obqp->ptr;
+    if (size > (iovp->size - offset)) {
+      size = iovp->size - offset;
+    }
+
+    /* Smaller chunks in order to not make the critical zone too long.*/
+    if (size > (size_t)BUFFERS_CHUNKS_SIZE) {
+      size = (size_t)BUFFERS_CHUNKS_SIZE;
+    }
+    memcpy(obqp->ptr, iovp->base + offset, size);
+    obqp->ptr += size;
+    offset    += size;
+    w         += size;
+
+    /* Has the current data buffer been finished? if so then post it
+       without notification.*/
+    if (obqp->ptr >= obqp->top) {
+      obq_post_buffer(obqp, obqp->bsize - sizeof (size_t));
+      posted = true;
+    }
+
+    /* Next element when the current one has been exhausted.*/
+    if (offset >= iovp->size) {
+      iovp++;
+      iovcnt--;
+      offset = 0U;
+    }
+
+    /* Giving a preemption chance.*/
+    osalSysUnlock();
+    osalSysLock();
+  }
+
+  /* Single notification for all the buffers posted.*/
+  if (posted && (obqp->notify != NULL)) {
+    obqp->notify(obqp);
+  }
+
+  osalSysUnlock();
+  return w;
+}
+
+/**
+ * @brief   Gets a direct view of the space in the current output buffer.
+ * @details The function returns a pointer to the free space in the current
+ *          empty buffer, a new buffer is acquired if there is no current
+ *          buffer. The data can be written in place then committed, all
+ *          or in part, using @p obqCommit().
+ * @note    The returned view is valid until the space is committed or the
+ *          queue is reset.
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[out] bpp      pointer to a variable receiving the space pointer
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The number of bytes accessible through the view.
+ * @retval 0            if a timeout occurred or the queue has been reset.
+ *
+ * @api
+ */
+size_t obqGetViewTimeout(output_buffers_queue_t *obqp, uint8_t **bpp,
+                         sysinterval_t timeout) {
+  size_t n;
+
+  osalDbgCheck(bpp != NULL);
+
+  osalSysLock();
+
+  /* This condition indicates that a new buffer must be acquired.*/
+  if (obqp->ptr == NULL) {
+    msg_t msg;
+
+    msg = obqGetEmptyBufferTimeoutS(obqp, timeout);
+    if (msg != MSG_OK) {
+      osalSysUnlock();
+      return (size_t)0;
+    }
+  }
+
+  *bpp = obqp->ptr;
+  n = (size_t)obqp->top - (size_t)obqp->ptr;
+
+  osalSysUnlock();
+  return n;
+}
+
+/**
+ * @brief   Commits data written in the current output buffer.
+ * @details The specified amount of data, previously written through
+ *          @p obqGetViewTimeout(), is added to the current buffer. The
+ *          buffer is posted in the queue when it has been completely
+ *          filled, partially filled buffers can be posted using
+ *          @p obqFlush().
+ *
+ * @param[in] obqp      pointer to the @p output_buffers_queue_t object
+ * @param[in] n         number of bytes to be committed, it cannot exceed the
+ *                      size returned by @p obqGetViewTimeout()
+ *
+ * @api
+ */
+void obqCommit(output_buffers_queue_t *obqp, size_t n) {
+
+  osalSysLock();
+
+  osalDbgAssert(obqp->ptr != NULL, "no current buffer");
+  osalDbgCheck(n <= ((size_t)obqp->top - (size_t)obqp->ptr));
+
+  obqp->ptr += n;
+
+  /* Has the current data buffer been finished? if so then post it.*/
+  if (obqp->ptr >= obqp->top) {
+    obqPostFullBufferS(obqp, obqp->bsize - sizeof (size_t));
+  }
+
+  osalSysUnlock();
+}
+
 /**
  * @brief   Flushes the current, partially filled, buffer to the queue.
  * @note    The notification callback is not invoked because the function
@@ -803,18 +1083,7 @@ bool obqTryFlushI(output_buffers_queue_t *obqp) {
 
     if (size > 0U) {
 
-      /* Writing size field in the buffer.*/
-      *((size_t *)obqp->bwrptr) = size;
-
-      /* Posting the buffer in the queue.*/
-      obqp->bcounter--;
-      obqp->bwrptr += obqp->bsize;
-      if (obqp->bwrptr >= obqp->btop) {
-        obqp->bwrptr = obqp->buffers;
-      }
-
-      /* No "current" buffer.*/
-      obqp->ptr = NULL;
+      obq_post_buffer(obqp, size);
 
       return true;
     }
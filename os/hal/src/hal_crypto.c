@@ -22,6 +22,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "hal.h"
 
 #if (HAL_USE_CRY == TRUE) || defined(__DOXYGEN__)
@@ -42,6 +44,298 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (HAL_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Advances the 32 bits counter of a CTR vector.
+ *
+ * @param[in,out] iv            128 bits input vector + counter
+ * @param[in] size              number of bytes processed
+ *
+ * @notapi
+ */
+static void cry_ctr_advance(uint8_t *iv, size_t size) {
+  uint32_t ctr;
+
+  ctr = ((uint32_t)iv[12] << 24) | ((uint32_t)iv[13] << 16) |
+        ((uint32_t)iv[14] << 8)  | (uint32_t)iv[15];
+  ctr += (uint32_t)(size / (size_t)16);
+  iv[12] = (uint8_t)(ctr >> 24);
+  iv[13] = (uint8_t)(ctr >> 16);
+  iv[14] = (uint8_t)(ctr >> 8);
+  iv[15] = (uint8_t)ctr;
+}
+
+/**
+ * @brief   Executes an AES ECB, CBC, CFB or CTR request.
+ * @details The input vector is chained across segments using a local copy,
+ *          decryption chains on the ciphertext which is saved before the
+ *          segment is processed because it could be overwritten by an
+ *          in-place operation.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] reqp              pointer to the @p cry_request_t object
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+static cryerror_t cry_request_cipher(CRYDriver *cryp, cry_request_t *reqp) {
+  const cry_segment_t *sp = reqp->segments;
+  const cry_segment_t *end = &reqp->segments[reqp->nsegments];
+  uint8_t iv[16], next[16];
+  cryerror_t err = CRY_NOERROR;
+
+  if (reqp->iv != NULL) {
+    memcpy(iv, reqp->iv, sizeof iv);
+  }
+
+  while ((err == CRY_NOERROR) && (sp < end)) {
+    size_t n = sp->size;
+    bool chain = n >= sizeof iv;
+
+    switch (reqp->op) {
+    case cry_op_encrypt_aes_ecb:
+      err = cryEncryptAES_ECB(cryp, reqp->key_id, n, sp->in, sp->out);
+      break;
+    case cry_op_decrypt_aes_ecb:
+      err = cryDecryptAES_ECB(cryp, reqp->key_id, n, sp->in, sp->out);
+      break;
+    case cry_op_encrypt_aes_cbc:
+      err = cryEncryptAES_CBC(cryp, reqp->key_id, n, sp->in, sp->out, iv);
+      if (chain) {
+        memcpy(iv, &sp->out[n - sizeof iv], sizeof iv);
+      }
+      break;
+    case cry_op_decrypt_aes_cbc:
+      if (chain) {
+        memcpy(next, &sp->in[n - sizeof iv], sizeof iv);
+      }
+      err = cryDecryptAES_CBC(cryp, reqp->key_id, n, sp->in, sp->out, iv);
+      if (chain) {
+        memcpy(iv, next, sizeof iv);
+      }
+      break;
+    case cry_op_encrypt_aes_cfb:
+      err = cryEncryptAES_CFB(cryp, reqp->key_id, n, sp->in, sp->out, iv);
+      if (chain) {
+        memcpy(iv, &sp->out[n - sizeof iv], sizeof iv);
+      }
+      break;
+    case cry_op_decrypt_aes_cfb:
+      if (chain) {
+        memcpy(next, &sp->in[n - sizeof iv], sizeof iv);
+      }
+      err = cryDecryptAES_CFB(cryp, reqp->key_id, n, sp->in, sp->out, iv);
+      if (chain) {
+        memcpy(iv, next, sizeof iv);
+      }
+      break;
+    case cry_op_encrypt_aes_ctr:
+      err = cryEncryptAES_CTR(cryp, reqp->key_id, n, sp->in, sp->out, iv);
+      cry_ctr_advance(iv, n);
+      break;
+    case cry_op_decrypt_aes_ctr:
+      err = cryDecryptAES_CTR(cryp, reqp->key_id, n, sp->in, sp->out, iv);
+      cry_ctr_advance(iv, n);
+      break;
+    default:
+      err = CRY_ERR_INV_ALGO;
+      break;
+    }
+    sp++;
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Executes an AES GCM request using the streaming functions.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] reqp              pointer to the @p cry_request_t object
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+static cryerror_t cry_request_gcm(CRYDriver *cryp, cry_request_t *reqp) {
+  const cry_segment_t *sp = reqp->segments;
+  const cry_segment_t *end = &reqp->segments[reqp->nsegments];
+  AESGCMContext ctx;
+  cryerror_t err;
+
+  err = cryAES_GCMInit(cryp, &ctx, reqp->key_id, reqp->iv,
+                       reqp->auth_size, reqp->auth_in);
+  while ((err == CRY_NOERROR) && (sp < end)) {
+    if (reqp->op == cry_op_encrypt_aes_gcm) {
+      err = cryEncryptAES_GCMUpdate(cryp, &ctx, sp->size, sp->in, sp->out);
+    }
+    else {
+      err = cryDecryptAES_GCMUpdate(cryp, &ctx, sp->size, sp->in, sp->out);
+    }
+    sp++;
+  }
+  if (err == CRY_NOERROR) {
+    if (reqp->op == cry_op_encrypt_aes_gcm) {
+      err = cryEncryptAES_GCMFinal(cryp, &ctx, reqp->tag_size, reqp->tag);
+    }
+    else {
+      err = cryDecryptAES_GCMFinal(cryp, &ctx, reqp->tag_size, reqp->tag);
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Executes a hash request.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] reqp              pointer to the @p cry_request_t object
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+static cryerror_t cry_request_hash(CRYDriver *cryp, cry_request_t *reqp) {
+  const cry_segment_t *sp = reqp->segments;
+  const cry_segment_t *end = &reqp->segments[reqp->nsegments];
+  union {
+    SHA256Context           sha256;
+    SHA512Context           sha512;
+    HMACSHA256Context       hmacsha256;
+    HMACSHA512Context       hmacsha512;
+  } ctx;
+  cryerror_t err;
+
+  switch (reqp->op) {
+  case cry_op_sha256:
+    err = crySHA256Init(cryp, &ctx.sha256);
+    while ((err == CRY_NOERROR) && (sp < end)) {
+      err = crySHA256Update(cryp, &ctx.sha256, sp->size, sp->in);
+      sp++;
+    }
+    if (err == CRY_NOERROR) {
+      err = crySHA256Final(cryp, &ctx.sha256, reqp->tag);
+    }
+    break;
+  case cry_op_sha512:
+    err = crySHA512Init(cryp, &ctx.sha512);
+    while ((err == CRY_NOERROR) && (sp < end)) {
+      err = crySHA512Update(cryp, &ctx.sha512, sp->size, sp->in);
+      sp++;
+    }
+    if (err == CRY_NOERROR) {
+      err = crySHA512Final(cryp, &ctx.sha512, reqp->tag);
+    }
+    break;
+  case cry_op_hmac_sha256:
+    err = cryHMACSHA256Init(cryp, &ctx.hmacsha256);
+    while ((err == CRY_NOERROR) && (sp < end)) {
+      err = cryHMACSHA256Update(cryp, &ctx.hmacsha256, sp->size, sp->in);
+      sp++;
+    }
+    if (err == CRY_NOERROR) {
+      err = cryHMACSHA256Final(cryp, &ctx.hmacsha256, reqp->tag);
+    }
+    break;
+  case cry_op_hmac_sha512:
+    err = cryHMACSHA512Init(cryp, &ctx.hmacsha512);
+    while ((err == CRY_NOERROR) && (sp < end)) {
+      err = cryHMACSHA512Update(cryp, &ctx.hmacsha512, sp->size, sp->in);
+      sp++;
+    }
+    if (err == CRY_NOERROR) {
+      err = cryHMACSHA512Final(cryp, &ctx.hmacsha512, reqp->tag);
+    }
+    break;
+  default:
+    err = CRY_ERR_INV_ALGO;
+    break;
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Checks the segments size of a request.
+ * @details In the CBC, CFB and CTR modes the chaining state is carried from
+ *          a segment to the next one, all segments except the last one must
+ *          be a multiple of the AES block size.
+ *
+ * @param[in] reqp              pointer to the @p cry_request_t object
+ * @return                      The segments size validity.
+ *
+ * @notapi
+ */
+static bool cry_segments_valid(const cry_request_t *reqp) {
+  size_t i;
+
+  if ((reqp->op < cry_op_encrypt_aes_cbc) ||
+      (reqp->op > cry_op_decrypt_aes_ctr)) {
+    return true;
+  }
+
+  for (i = (size_t)1; i < reqp->nsegments; i++) {
+    if ((reqp->segments[i - (size_t)1].size % (size_t)16) != (size_t)0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief   Appends a request to the driver queue.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] reqp              pointer to the @p cry_request_t object
+ *
+ * @notapi
+ */
+static void cry_queue_insert(CRYDriver *cryp, cry_request_t *reqp) {
+  cry_request_t **pp;
+
+  osalDbgCheck((reqp->segments != NULL) || (reqp->nsegments == (size_t)0));
+  osalDbgCheck((reqp->op < cry_op_encrypt_aes_cbc) ||
+               (reqp->op > cry_op_decrypt_aes_gcm) ||
+               (reqp->iv != NULL));
+  osalDbgCheck((reqp->op < cry_op_encrypt_aes_gcm) ||
+               (reqp->tag != NULL));
+  osalDbgCheck(cry_segments_valid(reqp));
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+  osalDbgAssert((reqp->state == CRY_REQUEST_IDLE) ||
+                (reqp->state == CRY_REQUEST_DONE),
+                "already queued");
+
+  reqp->state  = CRY_REQUEST_QUEUED;
+  reqp->thread = NULL;
+  reqp->next   = NULL;
+
+  pp = &cryp->rqueue;
+  while (*pp != NULL) {
+    pp = &(*pp)->next;
+  }
+  *pp = reqp;
+}
+
+#if (CRY_LLD_SUPPORTS_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the next request in the queue.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ *
+ * @notapi
+ */
+static void cry_queue_start(CRYDriver *cryp) {
+  cry_request_t *reqp = cryp->rqueue;
+
+  cryp->rqueue   = reqp->next;
+  cryp->rcurrent = reqp;
+  reqp->state    = CRY_REQUEST_ACTIVE;
+
+  cry_lld_start_request(cryp, reqp);
+}
+#endif /* CRY_LLD_SUPPORTS_QUEUE == TRUE */
+#endif /* HAL_CRY_USE_QUEUE == TRUE */
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -71,6 +365,10 @@ void cryObjectInit(CRYDriver *cryp) {
 
   cryp->state    = CRY_STOP;
   cryp->config   = NULL;
+#if HAL_CRY_USE_QUEUE == TRUE
+  cryp->rqueue   = NULL;
+  cryp->rcurrent = NULL;
+#endif
 #if defined(CRY_DRIVER_EXT_INIT_HOOK)
   CRY_DRIVER_EXT_INIT_HOOK(cryp);
 #endif
@@ -115,6 +413,10 @@ void cryStop(CRYDriver *cryp) {
 
   osalDbgAssert((cryp->state == CRY_STOP) || (cryp->state == CRY_READY),
                 "invalid state");
+#if HAL_CRY_USE_QUEUE == TRUE
+  osalDbgAssert((cryp->rqueue == NULL) && (cryp->rcurrent == NULL),
+                "requests pending");
+#endif
 
 #if HAL_CRY_ENFORCE_FALLBACK == FALSE
   cry_lld_stop(cryp);
@@ -147,7 +449,20 @@ cryerror_t cryLoadAESTransientKey(CRYDriver *cryp,
 
   osalDbgCheck((cryp != NULL) &&  (keyp != NULL));
 
-#if CRY_LLD_SUPPORTS_AES == TRUE
+#if (CRY_LLD_SUPPORTS_AES == TRUE) && (HAL_CRY_USE_FALLBACK == TRUE)
+  {
+    cryerror_t err;
+
+    /* The fallback serves the modes not supported by the LLD, it needs
+       its own copy of the key.*/
+    err = cry_lld_aes_loadkey(cryp, size, keyp);
+    if (err == CRY_NOERROR) {
+      err = cry_fallback_aes_loadkey(cryp, size, keyp);
+    }
+
+    return err;
+  }
+#elif CRY_LLD_SUPPORTS_AES == TRUE
   return cry_lld_aes_loadkey(cryp, size, keyp);
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_aes_loadkey(cryp, size, keyp);
@@ -821,6 +1136,217 @@ cryerror_t cryDecryptAES_GCM(CRYDriver *cryp,
 #endif
 }
 
+/**
+ * @brief   Initializes a streaming AES-GCM operation.
+ * @details The authenticated data is processed here, the text is then
+ *          processed in chunks of any size using
+ *          @p cryEncryptAES_GCMUpdate() or @p cryDecryptAES_GCMUpdate().
+ * @note    Streaming is only supported by the fallback, the AES transient
+ *          key must not be changed until the operation is finalized.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] gcmctxp          pointer to a GCM context to be initialized
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key, other values are keys stored
+ *                              in an unspecified way
+ * @param[in] iv                input vector, only the first 96 bits are used
+ * @param[in] auth_size         size of the data buffer to be authenticated
+ * @param[in] auth_in           buffer containing the data to be authenticated
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @api
+ */
+cryerror_t cryAES_GCMInit(CRYDriver *cryp,
+                          AESGCMContext *gcmctxp,
+                          crykey_t key_id,
+                          const uint8_t *iv,
+                          size_t auth_size,
+                          const uint8_t *auth_in) {
+
+  osalDbgCheck((cryp != NULL) && (gcmctxp != NULL) && (iv != NULL) &&
+               ((auth_size == (size_t)0) || (auth_in != NULL)));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+#if HAL_CRY_USE_FALLBACK == TRUE
+  return cry_fallback_AES_GCM_init(cryp, gcmctxp, key_id, iv,
+                                   auth_size, auth_in);
+#else
+  (void)cryp;
+  (void)gcmctxp;
+  (void)key_id;
+  (void)iv;
+  (void)auth_size;
+  (void)auth_in;
+
+  return CRY_ERR_INV_ALGO;
+#endif
+}
+
+/**
+ * @brief   Encrypts a chunk of a streaming AES-GCM operation.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] gcmctxp           pointer to a GCM context
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ *
+ * @api
+ */
+cryerror_t cryEncryptAES_GCMUpdate(CRYDriver *cryp,
+                                   AESGCMContext *gcmctxp,
+                                   size_t size,
+                                   const uint8_t *in,
+                                   uint8_t *out) {
+
+  osalDbgCheck((cryp != NULL) && (gcmctxp != NULL) &&
+               (in != NULL) && (out != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+#if HAL_CRY_USE_FALLBACK == TRUE
+  return cry_fallback_encrypt_AES_GCM_update(cryp, gcmctxp, size, in, out);
+#else
+  (void)cryp;
+  (void)gcmctxp;
+  (void)size;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+#endif
+}
+
+/**
+ * @brief   Decrypts a chunk of a streaming AES-GCM operation.
+ * @note    The plaintext is released before the tag is verified, it must
+ *          not be trusted until @p cryDecryptAES_GCMFinal() succeeds.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] gcmctxp           pointer to a GCM context
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ *
+ * @api
+ */
+cryerror_t cryDecryptAES_GCMUpdate(CRYDriver *cryp,
+                                   AESGCMContext *gcmctxp,
+                                   size_t size,
+                                   const uint8_t *in,
+                                   uint8_t *out) {
+
+  osalDbgCheck((cryp != NULL) && (gcmctxp != NULL) &&
+               (in != NULL) && (out != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+#if HAL_CRY_USE_FALLBACK == TRUE
+  return cry_fallback_decrypt_AES_GCM_update(cryp, gcmctxp, size, in, out);
+#else
+  (void)cryp;
+  (void)gcmctxp;
+  (void)size;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+#endif
+}
+
+/**
+ * @brief   Finalizes a streaming AES-GCM encryption.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] gcmctxp           pointer to a GCM context
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[out] tag_out          buffer for the generated authentication tag
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ *
+ * @api
+ */
+cryerror_t cryEncryptAES_GCMFinal(CRYDriver *cryp,
+                                  AESGCMContext *gcmctxp,
+                                  size_t tag_size,
+                                  uint8_t *tag_out) {
+
+  osalDbgCheck((cryp != NULL) && (gcmctxp != NULL) &&
+               (tag_size >= (size_t)1) && (tag_size <= (size_t)16) &&
+               (tag_out != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+#if HAL_CRY_USE_FALLBACK == TRUE
+  return cry_fallback_encrypt_AES_GCM_final(cryp, gcmctxp,
+                                            tag_size, tag_out);
+#else
+  (void)cryp;
+  (void)gcmctxp;
+  (void)tag_size;
+  (void)tag_out;
+
+  return CRY_ERR_INV_ALGO;
+#endif
+}
+
+/**
+ * @brief   Finalizes a streaming AES-GCM decryption.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] gcmctxp           pointer to a GCM context
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[in] tag_in            buffer containing the authentication tag
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_ALGO     if the operation is unsupported on this
+ *                              device instance.
+ * @retval CRY_ERR_AUTH_FAILED  authentication failed
+ *
+ * @api
+ */
+cryerror_t cryDecryptAES_GCMFinal(CRYDriver *cryp,
+                                  AESGCMContext *gcmctxp,
+                                  size_t tag_size,
+                                  const uint8_t *tag_in) {
+
+  osalDbgCheck((cryp != NULL) && (gcmctxp != NULL) &&
+               (tag_size >= (size_t)1) && (tag_size <= (size_t)16) &&
+               (tag_in != NULL));
+
+  osalDbgAssert(cryp->state == CRY_READY, "not ready");
+
+#if HAL_CRY_USE_FALLBACK == TRUE
+  return cry_fallback_decrypt_AES_GCM_final(cryp, gcmctxp,
+                                            tag_size, tag_in);
+#else
+  (void)cryp;
+  (void)gcmctxp;
+  (void)tag_size;
+  (void)tag_in;
+
+  return CRY_ERR_INV_ALGO;
+#endif
+}
+
 /**
  * @brief   Initializes the DES transient key.
  * @note    It is the underlying implementation to decide which key sizes are
@@ -1499,8 +2025,25 @@ cryerror_t cryLoadHMACTransientKey(CRYDriver *cryp,
 
   osalDbgCheck((cryp != NULL) &&  (keyp != NULL));
 
-#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == TRUE) ||                               \
-    (CRY_LLD_SUPPORTS_HMAC_SHA512 == TRUE)
+#if ((CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) ||                             \
+     (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE)) &&                            \
+    ((CRY_LLD_SUPPORTS_HMAC_SHA256 == TRUE) ||                              \
+     (CRY_LLD_SUPPORTS_HMAC_SHA512 == TRUE)) &&                             \
+    (HAL_CRY_USE_FALLBACK == TRUE)
+  {
+    cryerror_t err;
+
+    /* One of the HMAC algorithms is served by the fallback, it needs
+       its own copy of the key.*/
+    err = cry_lld_hmac_loadkey(cryp, size, keyp);
+    if (err == CRY_NOERROR) {
+      err = cry_fallback_hmac_loadkey(cryp, size, keyp);
+    }
+
+    return err;
+  }
+#elif (CRY_LLD_SUPPORTS_HMAC_SHA256 == TRUE) ||                             \
+      (CRY_LLD_SUPPORTS_HMAC_SHA512 == TRUE)
   return cry_lld_hmac_loadkey(cryp, size, keyp);
 #elif HAL_CRY_USE_FALLBACK == TRUE
   return cry_fallback_hmac_loadkey(cryp, size, keyp);
@@ -1731,6 +2274,182 @@ cryerror_t cryHMACSHA512Final(CRYDriver *cryp,
 #endif
 }
 
+#if (HAL_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+#if (CRY_LLD_SUPPORTS_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Queues a request.
+ * @details The request is appended to the driver queue and started
+ *          immediately if the driver is idle. Queued requests are executed
+ *          back-to-back from the completion interrupt.
+ * @note    This function is only available if the LLD is able to execute
+ *          requests asynchronously.
+ * @note    The queue cannot be used while a synchronous operation is in
+ *          progress, mutual exclusion between the two methods is
+ *          responsibility of the application.
+ * @post    At the end of each request its callback is invoked.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] reqp              pointer to the @p cry_request_t object
+ *
+ * @iclass
+ */
+void cryQueueRequestI(CRYDriver *cryp, cry_request_t *reqp) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((cryp != NULL) && (reqp != NULL));
+
+  cry_queue_insert(cryp, reqp);
+
+  /* Starting immediately if the driver is idle.*/
+  if (cryp->rcurrent == NULL) {
+    cry_queue_start(cryp);
+  }
+}
+#endif /* CRY_LLD_SUPPORTS_QUEUE == TRUE */
+
+/**
+ * @brief   Queues a request.
+ * @details The request is appended to the driver queue and started
+ *          immediately if the driver is idle.
+ * @note    If the LLD is not able to execute requests asynchronously then
+ *          the requests are executed by the thread finding the driver
+ *          idle, it returns after executing all the requests queued in the
+ *          meantime by other threads or by the callbacks.
+ * @note    See @p cryQueueRequestI() for the details.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] reqp              pointer to the @p cry_request_t object
+ *
+ * @api
+ */
+void cryQueueRequest(CRYDriver *cryp, cry_request_t *reqp) {
+
+  osalDbgCheck((cryp != NULL) && (reqp != NULL));
+
+  osalSysLock();
+#if CRY_LLD_SUPPORTS_QUEUE == TRUE
+  cryQueueRequestI(cryp, reqp);
+#else
+  cry_queue_insert(cryp, reqp);
+  if (cryp->rcurrent == NULL) {
+    while (cryp->rqueue != NULL) {
+      cry_request_t *rp = cryp->rqueue;
+      cryerror_t err;
+
+      cryp->rqueue   = rp->next;
+      cryp->rcurrent = rp;
+      rp->state      = CRY_REQUEST_ACTIVE;
+      osalSysUnlock();
+
+      err = _cry_request_execute(cryp, rp);
+
+      /* The current request pointer is kept until the callback returns
+         so that other threads only append to the queue.*/
+      osalSysLock();
+      rp->result = err;
+      rp->state  = CRY_REQUEST_DONE;
+      osalThreadResumeS(&rp->thread, MSG_OK);
+      osalSysUnlock();
+
+      if (rp->end_cb != NULL) {
+        rp->end_cb(cryp, rp);
+      }
+
+      osalSysLock();
+    }
+    cryp->rcurrent = NULL;
+  }
+#endif
+  osalSysUnlock();
+}
+
+/**
+ * @brief   Waits for a queued request to complete.
+ * @pre     Only one thread can wait for the same request.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] reqp              pointer to the @p cry_request_t to be waited
+ * @return                      The request result.
+ *
+ * @api
+ */
+cryerror_t cryWaitRequest(CRYDriver *cryp, cry_request_t *reqp) {
+
+  osalDbgCheck((cryp != NULL) && (reqp != NULL));
+
+  osalSysLock();
+  osalDbgAssert(reqp->state != CRY_REQUEST_IDLE, "not queued");
+  if (reqp->state != CRY_REQUEST_DONE) {
+    (void) osalThreadSuspendS(&reqp->thread);
+  }
+  osalSysUnlock();
+
+  return reqp->result;
+}
+
+/**
+ * @brief   Executes a request synchronously.
+ * @details The request is executed using the synchronous API, this is the
+ *          engine used when the LLD does not support asynchronous requests
+ *          and can be used by LLDs emulating them.
+ * @note    The request state is not modified.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] reqp              pointer to the @p cry_request_t object
+ * @return                      The operation status.
+ *
+ * @notapi
+ */
+cryerror_t _cry_request_execute(CRYDriver *cryp, cry_request_t *reqp) {
+
+  if (reqp->op <= cry_op_decrypt_aes_ctr) {
+    return cry_request_cipher(cryp, reqp);
+  }
+  if (reqp->op <= cry_op_decrypt_aes_gcm) {
+    return cry_request_gcm(cryp, reqp);
+  }
+  return cry_request_hash(cryp, reqp);
+}
+
+#if (CRY_LLD_SUPPORTS_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Queued request completion handler.
+ * @details Ends the current request, invokes its callback and starts the
+ *          next request in the queue, if any.
+ * @note    This function is meant to be invoked by the LLD completion
+ *          interrupt handler.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] err               result of the current request
+ *
+ * @notapi
+ */
+void _cry_queue_isr(CRYDriver *cryp, cryerror_t err) {
+  cry_request_t *reqp = cryp->rcurrent;
+
+  osalSysLockFromISR();
+  cryp->rcurrent = NULL;
+  reqp->result   = err;
+  reqp->state    = CRY_REQUEST_DONE;
+  osalThreadResumeI(&reqp->thread, MSG_OK);
+  osalSysUnlockFromISR();
+
+  /* Request callback, the request can be queued again from here.*/
+  if (reqp->end_cb != NULL) {
+    reqp->end_cb(cryp, reqp);
+  }
+
+  osalSysLockFromISR();
+
+  /* Next request, the callback could have already started one.*/
+  if ((cryp->rcurrent == NULL) && (cryp->rqueue != NULL)) {
+    cry_queue_start(cryp);
+  }
+  osalSysUnlockFromISR();
+}
+#endif /* CRY_LLD_SUPPORTS_QUEUE == TRUE */
+#endif /* HAL_CRY_USE_QUEUE == TRUE */
+
 #endif /* HAL_USE_CRY == TRUE */
 
 /** @} */
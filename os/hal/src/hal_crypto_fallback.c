@@ -0,0 +1,2588 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_crypto_fallback.c
+ * @brief   Cryptographic Driver software fall-back code.
+ * @details The AES engine is bitsliced: the state of two blocks is spread
+ *          over eight 32 bits words, one word for each bit position, so
+ *          that the S-box becomes a boolean circuit and no secret-dependent
+ *          memory access or branch is performed. Modes that allow it
+ *          (ECB, CBC and CFB decryption, CTR, GCM) process two blocks for
+ *          each pass of the engine.
+ *
+ * @addtogroup CRYPTO
+ * @{
+ */
+
+#include <string.h>
+
+#include "hal.h"
+
+#if ((HAL_USE_CRY == TRUE) && (HAL_CRY_USE_FALLBACK == TRUE)) ||            \
+    defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Driver local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   AES block size.
+ */
+#define AES_BLOCK_SIZE                      16U
+
+/**
+ * @brief   Size of the bitsliced key stream generated in a single pass.
+ */
+#define AES_KS_SIZE                         (2U * AES_BLOCK_SIZE)
+
+/*===========================================================================*/
+/* Driver exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Driver local variables and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of the AES transient key.
+ */
+typedef struct {
+  /**
+   * @brief   Number of rounds, zero if the key has not been loaded.
+   */
+  unsigned                  rounds;
+  /**
+   * @brief   Bitsliced round keys, eight words for each round key.
+   */
+  uint32_t                  skey[120];
+  /**
+   * @brief   GHASH 4-bit table, low halves of the multiples of H.
+   */
+  uint64_t                  hl[16];
+  /**
+   * @brief   GHASH 4-bit table, high halves of the multiples of H.
+   */
+  uint64_t                  hh[16];
+} aes_key_t;
+
+/**
+ * @brief   AES transient key.
+ */
+static aes_key_t aes_key;
+
+/**
+ * @brief   HMAC transient key.
+ * @note    Keys longer than @p CRY_FALLBACK_HMAC_KEY_MAX_SIZE are not
+ *          stored, only their digests are kept.
+ */
+static struct {
+  size_t                    size;
+  uint8_t                   data[CRY_FALLBACK_HMAC_KEY_MAX_SIZE];
+#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) || defined(__DOXYGEN__)
+  uint8_t                   sha256[32];
+#endif
+#if (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE) || defined(__DOXYGEN__)
+  uint8_t                   sha512[64];
+#endif
+} hmac_key;
+
+/**
+ * @brief   Round constants for the AES key schedule.
+ */
+static const uint8_t aes_rcon[10] = {
+  0x01U, 0x02U, 0x04U, 0x08U, 0x10U, 0x20U, 0x40U, 0x80U, 0x1BU, 0x36U
+};
+
+/**
+ * @brief   GHASH reduction constants for the 4-bit tables.
+ */
+static const uint64_t ghash_last4[16] = {
+  0x0000U, 0x1C20U, 0x3840U, 0x2460U, 0x7080U, 0x6CA0U, 0x48C0U, 0x54E0U,
+  0xE100U, 0xFD20U, 0xD940U, 0xC560U, 0x9180U, 0x8DA0U, 0xA9C0U, 0xB5E0U
+};
+
+#if (CRY_LLD_SUPPORTS_SHA256 == FALSE) ||                                   \
+    (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   SHA256 initial hash value.
+ */
+static const uint32_t sha256_h0[8] = {
+  0x6A09E667U, 0xBB67AE85U, 0x3C6EF372U, 0xA54FF53AU,
+  0x510E527FU, 0x9B05688CU, 0x1F83D9ABU, 0x5BE0CD19U
+};
+
+/**
+ * @brief   SHA256 round constants.
+ */
+static const uint32_t sha256_k[64] = {
+  0x428A2F98U, 0x71374491U, 0xB5C0FBCFU, 0xE9B5DBA5U,
+  0x3956C25BU, 0x59F111F1U, 0x923F82A4U, 0xAB1C5ED5U,
+  0xD807AA98U, 0x12835B01U, 0x243185BEU, 0x550C7DC3U,
+  0x72BE5D74U, 0x80DEB1FEU, 0x9BDC06A7U, 0xC19BF174U,
+  0xE49B69C1U, 0xEFBE4786U, 0x0FC19DC6U, 0x240CA1CCU,
+  0x2DE92C6FU, 0x4A7484AAU, 0x5CB0A9DCU, 0x76F988DAU,
+  0x983E5152U, 0xA831C66DU, 0xB00327C8U, 0xBF597FC7U,
+  0xC6E00BF3U, 0xD5A79147U, 0x06CA6351U, 0x14292967U,
+  0x27B70A85U, 0x2E1B2138U, 0x4D2C6DFCU, 0x53380D13U,
+  0x650A7354U, 0x766A0ABBU, 0x81C2C92EU, 0x92722C85U,
+  0xA2BFE8A1U, 0xA81A664BU, 0xC24B8B70U, 0xC76C51A3U,
+  0xD192E819U, 0xD6990624U, 0xF40E3585U, 0x106AA070U,
+  0x19A4C116U, 0x1E376C08U, 0x2748774CU, 0x34B0BCB5U,
+  0x391C0CB3U, 0x4ED8AA4AU, 0x5B9CCA4FU, 0x682E6FF3U,
+  0x748F82EEU, 0x78A5636FU, 0x84C87814U, 0x8CC70208U,
+  0x90BEFFFAU, 0xA4506CEBU, 0xBEF9A3F7U, 0xC67178F2U
+};
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA512 == FALSE) ||                                   \
+    (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   SHA512 initial hash value.
+ */
+static const uint64_t sha512_h0[8] = {
+  0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL,
+  0x3C6EF372FE94F82BULL, 0xA54FF53A5F1D36F1ULL,
+  0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL,
+  0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL
+};
+
+/**
+ * @brief   SHA512 round constants.
+ */
+static const uint64_t sha512_k[80] = {
+  0x428A2F98D728AE22ULL, 0x7137449123EF65CDULL,
+  0xB5C0FBCFEC4D3B2FULL, 0xE9B5DBA58189DBBCULL,
+  0x3956C25BF348B538ULL, 0x59F111F1B605D019ULL,
+  0x923F82A4AF194F9BULL, 0xAB1C5ED5DA6D8118ULL,
+  0xD807AA98A3030242ULL, 0x12835B0145706FBEULL,
+  0x243185BE4EE4B28CULL, 0x550C7DC3D5FFB4E2ULL,
+  0x72BE5D74F27B896FULL, 0x80DEB1FE3B1696B1ULL,
+  0x9BDC06A725C71235ULL, 0xC19BF174CF692694ULL,
+  0xE49B69C19EF14AD2ULL, 0xEFBE4786384F25E3ULL,
+  0x0FC19DC68B8CD5B5ULL, 0x240CA1CC77AC9C65ULL,
+  0x2DE92C6F592B0275ULL, 0x4A7484AA6EA6E483ULL,
+  0x5CB0A9DCBD41FBD4ULL, 0x76F988DA831153B5ULL,
+  0x983E5152EE66DFABULL, 0xA831C66D2DB43210ULL,
+  0xB00327C898FB213FULL, 0xBF597FC7BEEF0EE4ULL,
+  0xC6E00BF33DA88FC2ULL, 0xD5A79147930AA725ULL,
+  0x06CA6351E003826FULL, 0x142929670A0E6E70ULL,
+  0x27B70A8546D22FFCULL, 0x2E1B21385C26C926ULL,
+  0x4D2C6DFC5AC42AEDULL, 0x53380D139D95B3DFULL,
+  0x650A73548BAF63DEULL, 0x766A0ABB3C77B2A8ULL,
+  0x81C2C92E47EDAEE6ULL, 0x92722C851482353BULL,
+  0xA2BFE8A14CF10364ULL, 0xA81A664BBC423001ULL,
+  0xC24B8B70D0F89791ULL, 0xC76C51A30654BE30ULL,
+  0xD192E819D6EF5218ULL, 0xD69906245565A910ULL,
+  0xF40E35855771202AULL, 0x106AA07032BBD1B8ULL,
+  0x19A4C116B8D2D0C8ULL, 0x1E376C085141AB53ULL,
+  0x2748774CDF8EEB99ULL, 0x34B0BCB5E19B48A8ULL,
+  0x391C0CB3C5C95A63ULL, 0x4ED8AA4AE3418ACBULL,
+  0x5B9CCA4F7763E373ULL, 0x682E6FF3D6B2B8A3ULL,
+  0x748F82EE5DEFB2FCULL, 0x78A5636F43172F60ULL,
+  0x84C87814A1F0AB72ULL, 0x8CC702081A6439ECULL,
+  0x90BEFFFA23631E28ULL, 0xA4506CEBDE82BDE9ULL,
+  0xBEF9A3F7B2C67915ULL, 0xC67178F2E372532BULL,
+  0xCA273ECEEA26619CULL, 0xD186B8C721C0C207ULL,
+  0xEADA7DD6CDE0EB1EULL, 0xF57D4F7FEE6ED178ULL,
+  0x06F067AA72176FBAULL, 0x0A637DC5A2C898A6ULL,
+  0x113F9804BEF90DAEULL, 0x1B710B35131C471BULL,
+  0x28DB77F523047D84ULL, 0x32CAAB7B40C72493ULL,
+  0x3C9EBE0A15C9BEBCULL, 0x431D67C49C100D4CULL,
+  0x4CC5D4BECB3E42B6ULL, 0x597F299CFC657E2AULL,
+  0x5FCB6FAB3AD6FAECULL, 0x6C44198C4A475817ULL
+};
+#endif
+
+/*===========================================================================*/
+/* Driver local functions.                                                   */
+/*===========================================================================*/
+
+static inline uint32_t dec32le(const uint8_t *p) {
+
+  return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+         ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void enc32le(uint8_t *p, uint32_t x) {
+
+  p[0] = (uint8_t)x;
+  p[1] = (uint8_t)(x >> 8);
+  p[2] = (uint8_t)(x >> 16);
+  p[3] = (uint8_t)(x >> 24);
+}
+
+static inline uint32_t dec32be(const uint8_t *p) {
+
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+         ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static inline void enc32be(uint8_t *p, uint32_t x) {
+
+  p[0] = (uint8_t)(x >> 24);
+  p[1] = (uint8_t)(x >> 16);
+  p[2] = (uint8_t)(x >> 8);
+  p[3] = (uint8_t)x;
+}
+
+static inline uint64_t dec64be(const uint8_t *p) {
+
+  return ((uint64_t)dec32be(p) << 32) | (uint64_t)dec32be(p + 4);
+}
+
+static inline void enc64be(uint8_t *p, uint64_t x) {
+
+  enc32be(p, (uint32_t)(x >> 32));
+  enc32be(p + 4, (uint32_t)x);
+}
+
+/**
+ * @brief   XORs two buffers.
+ */
+static inline void xor_buf(uint8_t *dst, const uint8_t *a,
+                           const uint8_t *b, size_t n) {
+
+  while (n > 0U) {
+    *dst++ = *a++ ^ *b++;
+    n--;
+  }
+}
+
+/**
+ * @brief   Increments the 32 bits big endian counter of a counter block.
+ */
+static inline void inc32(uint8_t *cb) {
+
+  enc32be(&cb[12], dec32be(&cb[12]) + 1U);
+}
+
+/**
+ * @brief   Bitsliced AES S-box.
+ * @details Boyar-Peralta circuit, @p q[0] contains the least significant
+ *          bit of each byte.
+ *
+ * @param[in,out] q             bitsliced state
+ */
+static void aes_sbox(uint32_t *q) {
+  uint32_t x0, x1, x2, x3, x4, x5, x6, x7;
+  uint32_t y1, y2, y3, y4, y5, y6, y7, y8, y9;
+  uint32_t y10, y11, y12, y13, y14, y15, y16, y17, y18, y19;
+  uint32_t y20, y21;
+  uint32_t z0, z1, z2, z3, z4, z5, z6, z7, z8, z9;
+  uint32_t z10, z11, z12, z13, z14, z15, z16, z17;
+  uint32_t t0, t1, t2, t3, t4, t5, t6, t7, t8, t9;
+  uint32_t t10, t11, t12, t13, t14, t15, t16, t17, t18, t19;
+  uint32_t t20, t21, t22, t23, t24, t25, t26, t27, t28, t29;
+  uint32_t t30, t31, t32, t33, t34, t35, t36, t37, t38, t39;
+  uint32_t t40, t41, t42, t43, t44, t45, t46, t47, t48, t49;
+  uint32_t t50, t51, t52, t53, t54, t55, t56, t57, t58, t59;
+  uint32_t t60, t61, t62, t63, t64, t65, t66, t67;
+  uint32_t s0, s1, s2, s3, s4, s5, s6, s7;
+
+  x0 = q[7];
+  x1 = q[6];
+  x2 = q[5];
+  x3 = q[4];
+  x4 = q[3];
+  x5 = q[2];
+  x6 = q[1];
+  x7 = q[0];
+
+  /* Top linear transformation.*/
+  y14 = x3 ^ x5;
+  y13 = x0 ^ x6;
+  y9  = x0 ^ x3;
+  y8  = x0 ^ x5;
+  t0  = x1 ^ x2;
+  y1  = t0 ^ x7;
+  y4  = y1 ^ x3;
+  y12 = y13 ^ y14;
+  y2  = y1 ^ x0;
+  y5  = y1 ^ x6;
+  y3  = y5 ^ y8;
+  t1  = x4 ^ y12;
+  y15 = t1 ^ x5;
+  y20 = t1 ^ x1;
+  y6  = y15 ^ x7;
+  y10 = y15 ^ t0;
+  y11 = y20 ^ y9;
+  y7  = x7 ^ y11;
+  y17 = y10 ^ y11;
+  y19 = y10 ^ y8;
+  y16 = t0 ^ y11;
+  y21 = y13 ^ y16;
+  y18 = x0 ^ y16;
+
+  /* Non-linear section.*/
+  t2  = y12 & y15;
+  t3  = y3 & y6;
+  t4  = t3 ^ t2;
+  t5  = y4 & x7;
+  t6  = t5 ^ t2;
+  t7  = y13 & y16;
+  t8  = y5 & y1;
+  t9  = t8 ^ t7;
+  t10 = y2 & y7;
+  t11 = t10 ^ t7;
+  t12 = y9 & y11;
+  t13 = y14 & y17;
+  t14 = t13 ^ t12;
+  t15 = y8 & y10;
+  t16 = t15 ^ t12;
+  t17 = t4 ^ t14;
+  t18 = t6 ^ t16;
+  t19 = t9 ^ t14;
+  t20 = t11 ^ t16;
+  t21 = t17 ^ y20;
+  t22 = t18 ^ y19;
+  t23 = t19 ^ y21;
+  t24 = t20 ^ y18;
+
+  t25 = t21 ^ t22;
+  t26 = t21 & t23;
+  t27 = t24 ^ t26;
+  t28 = t25 & t27;
+  t29 = t28 ^ t22;
+  t30 = t23 ^ t24;
+  t31 = t22 ^ t26;
+  t32 = t31 & t30;
+  t33 = t32 ^ t24;
+  t34 = t23 ^ t33;
+  t35 = t27 ^ t33;
+  t36 = t24 & t35;
+  t37 = t36 ^ t34;
+  t38 = t27 ^ t36;
+  t39 = t29 & t38;
+  t40 = t25 ^ t39;
+
+  t41 = t40 ^ t37;
+  t42 = t29 ^ t33;
+  t43 = t29 ^ t40;
+  t44 = t33 ^ t37;
+  t45 = t42 ^ t41;
+  z0  = t44 & y15;
+  z1  = t37 & y6;
+  z2  = t33 & x7;
+  z3  = t43 & y16;
+  z4  = t40 & y1;
+  z5  = t29 & y7;
+  z6  = t42 & y11;
+  z7  = t45 & y17;
+  z8  = t41 & y10;
+  z9  = t44 & y12;
+  z10 = t37 & y3;
+  z11 = t33 & y4;
+  z12 = t43 & y13;
+  z13 = t40 & y5;
+  z14 = t29 & y2;
+  z15 = t42 & y9;
+  z16 = t45 & y14;
+  z17 = t41 & y8;
+
+  /* Bottom linear transformation.*/
+  t46 = z15 ^ z16;
+  t47 = z10 ^ z11;
+  t48 = z5 ^ z13;
+  t49 = z9 ^ z10;
+  t50 = z2 ^ z12;
+  t51 = z2 ^ z5;
+  t52 = z7 ^ z8;
+  t53 = z0 ^ z3;
+  t54 = z6 ^ z7;
+  t55 = z16 ^ z17;
+  t56 = z12 ^ t48;
+  t57 = t50 ^ t53;
+  t58 = z4 ^ t46;
+  t59 = z3 ^ t54;
+  t60 = t46 ^ t57;
+  t61 = z14 ^ t57;
+  t62 = t52 ^ t58;
+  t63 = t49 ^ t58;
+  t64 = z4 ^ t59;
+  t65 = t61 ^ t62;
+  t66 = z1 ^ t63;
+  s0  = t59 ^ t63;
+  s6  = t56 ^ ~t62;
+  s7  = t48 ^ ~t60;
+  t67 = t64 ^ t65;
+  s3  = t53 ^ t66;
+  s4  = t51 ^ t66;
+  s5  = t47 ^ t65;
+  s1  = t64 ^ ~s3;
+  s2  = t55 ^ ~t67;
+
+  q[7] = s0;
+  q[6] = s1;
+  q[5] = s2;
+  q[4] = s3;
+  q[3] = s4;
+  q[2] = s5;
+  q[1] = s6;
+  q[0] = s7;
+}
+
+/**
+ * @brief   Inverse of the S-box affine transformation, bitsliced.
+ *
+ * @param[in,out] q             bitsliced state
+ */
+static void aes_inv_affine(uint32_t *q) {
+  uint32_t q0, q1, q2, q3, q4, q5, q6, q7;
+
+  q0 = ~q[0];
+  q1 = ~q[1];
+  q2 = q[2];
+  q3 = q[3];
+  q4 = q[4];
+  q5 = ~q[5];
+  q6 = ~q[6];
+  q7 = q[7];
+  q[7] = q1 ^ q4 ^ q6;
+  q[6] = q0 ^ q3 ^ q5;
+  q[5] = q7 ^ q2 ^ q4;
+  q[4] = q6 ^ q1 ^ q3;
+  q[3] = q5 ^ q0 ^ q2;
+  q[2] = q4 ^ q7 ^ q1;
+  q[1] = q3 ^ q6 ^ q0;
+  q[0] = q2 ^ q5 ^ q7;
+}
+
+/**
+ * @brief   Bitsliced AES inverse S-box.
+ * @details The inversion in GF(2^8) is obtained from the forward S-box
+ *          circuit by removing its affine transformation on both sides.
+ *
+ * @param[in,out] q             bitsliced state
+ */
+static void aes_inv_sbox(uint32_t *q) {
+
+  aes_inv_affine(q);
+  aes_sbox(q);
+  aes_inv_affine(q);
+}
+
+#define SWAPN(cl, ch, s, x, y) do {                                         \
+  uint32_t a_ = (x), b_ = (y);                                              \
+  (x) = (a_ & (uint32_t)(cl)) | ((b_ & (uint32_t)(cl)) << (s));             \
+  (y) = ((a_ & (uint32_t)(ch)) >> (s)) | (b_ & (uint32_t)(ch));             \
+} while (false)
+
+/**
+ * @brief   Converts between the natural and the bitsliced representation.
+ * @note    The transformation is its own inverse.
+ *
+ * @param[in,out] q             state to be converted
+ */
+static void aes_ortho(uint32_t *q) {
+
+  SWAPN(0x55555555U, 0xAAAAAAAAU, 1, q[0], q[1]);
+  SWAPN(0x55555555U, 0xAAAAAAAAU, 1, q[2], q[3]);
+  SWAPN(0x55555555U, 0xAAAAAAAAU, 1, q[4], q[5]);
+  SWAPN(0x55555555U, 0xAAAAAAAAU, 1, q[6], q[7]);
+
+  SWAPN(0x33333333U, 0xCCCCCCCCU, 2, q[0], q[2]);
+  SWAPN(0x33333333U, 0xCCCCCCCCU, 2, q[1], q[3]);
+  SWAPN(0x33333333U, 0xCCCCCCCCU, 2, q[4], q[6]);
+  SWAPN(0x33333333U, 0xCCCCCCCCU, 2, q[5], q[7]);
+
+  SWAPN(0x0F0F0F0FU, 0xF0F0F0F0U, 4, q[0], q[4]);
+  SWAPN(0x0F0F0F0FU, 0xF0F0F0F0U, 4, q[1], q[5]);
+  SWAPN(0x0F0F0F0FU, 0xF0F0F0F0U, 4, q[2], q[6]);
+  SWAPN(0x0F0F0F0FU, 0xF0F0F0F0U, 4, q[3], q[7]);
+}
+
+static inline void aes_add_round_key(uint32_t *q, const uint32_t *sk) {
+  unsigned i;
+
+  for (i = 0U; i < 8U; i++) {
+    q[i] ^= sk[i];
+  }
+}
+
+static inline void aes_shift_rows(uint32_t *q) {
+  unsigned i;
+
+  for (i = 0U; i < 8U; i++) {
+    uint32_t x = q[i];
+
+    q[i] = (x & 0x000000FFU) |
+           ((x & 0x0000FC00U) >> 2) | ((x & 0x00000300U) << 6) |
+           ((x & 0x00F00000U) >> 4) | ((x & 0x000F0000U) << 4) |
+           ((x & 0xC0000000U) >> 6) | ((x & 0x3F000000U) << 2);
+  }
+}
+
+static inline void aes_inv_shift_rows(uint32_t *q) {
+  unsigned i;
+
+  for (i = 0U; i < 8U; i++) {
+    uint32_t x = q[i];
+
+    q[i] = (x & 0x000000FFU) |
+           ((x & 0x00003F00U) << 2) | ((x & 0x0000C000U) >> 6) |
+           ((x & 0x000F0000U) << 4) | ((x & 0x00F00000U) >> 4) |
+           ((x & 0x03000000U) << 6) | ((x & 0xFC000000U) >> 2);
+  }
+}
+
+static inline uint32_t rotr8(uint32_t x) {
+
+  return (x << 24) | (x >> 8);
+}
+
+static inline uint32_t rotr16(uint32_t x) {
+
+  return (x << 16) | (x >> 16);
+}
+
+static void aes_mix_columns(uint32_t *q) {
+  uint32_t q0, q1, q2, q3, q4, q5, q6, q7;
+  uint32_t r0, r1, r2, r3, r4, r5, r6, r7;
+
+  q0 = q[0];
+  q1 = q[1];
+  q2 = q[2];
+  q3 = q[3];
+  q4 = q[4];
+  q5 = q[5];
+  q6 = q[6];
+  q7 = q[7];
+  r0 = rotr8(q0);
+  r1 = rotr8(q1);
+  r2 = rotr8(q2);
+  r3 = rotr8(q3);
+  r4 = rotr8(q4);
+  r5 = rotr8(q5);
+  r6 = rotr8(q6);
+  r7 = rotr8(q7);
+
+  q[0] = q7 ^ r7 ^ r0 ^ rotr16(q0 ^ r0);
+  q[1] = q0 ^ r0 ^ q7 ^ r7 ^ r1 ^ rotr16(q1 ^ r1);
+  q[2] = q1 ^ r1 ^ r2 ^ rotr16(q2 ^ r2);
+  q[3] = q2 ^ r2 ^ q7 ^ r7 ^ r3 ^ rotr16(q3 ^ r3);
+  q[4] = q3 ^ r3 ^ q7 ^ r7 ^ r4 ^ rotr16(q4 ^ r4);
+  q[5] = q4 ^ r4 ^ r5 ^ rotr16(q5 ^ r5);
+  q[6] = q5 ^ r5 ^ r6 ^ rotr16(q6 ^ r6);
+  q[7] = q6 ^ r6 ^ r7 ^ rotr16(q7 ^ r7);
+}
+
+/**
+ * @brief   Bitsliced inverse MixColumns.
+ * @details The inverse matrix is factored as MixColumns times
+ *          {04}x^2 + {05}, the second factor only requires a rotation
+ *          and two doublings.
+ *
+ * @param[in,out] q             bitsliced state
+ */
+static void aes_inv_mix_columns(uint32_t *q) {
+  uint32_t t0, t1, t2, t3, t4, t5, t6, t7;
+
+  /* t = a + rot16(a).*/
+  t0 = q[0] ^ rotr16(q[0]);
+  t1 = q[1] ^ rotr16(q[1]);
+  t2 = q[2] ^ rotr16(q[2]);
+  t3 = q[3] ^ rotr16(q[3]);
+  t4 = q[4] ^ rotr16(q[4]);
+  t5 = q[5] ^ rotr16(q[5]);
+  t6 = q[6] ^ rotr16(q[6]);
+  t7 = q[7] ^ rotr16(q[7]);
+
+  /* a = a + {04} * t, the reduction polynomial is x^8+x^4+x^3+x+1.*/
+  q[0] ^= t6;
+  q[1] ^= t7 ^ t6;
+  q[2] ^= t0 ^ t7;
+  q[3] ^= t1 ^ t6;
+  q[4] ^= t2 ^ t7 ^ t6;
+  q[5] ^= t3 ^ t7;
+  q[6] ^= t4;
+  q[7] ^= t5;
+
+  aes_mix_columns(q);
+}
+
+/**
+ * @brief   Encrypts two bitsliced blocks.
+ *
+ * @param[in,out] q             bitsliced state
+ */
+static void aes_bitslice_encrypt(uint32_t *q) {
+  const uint32_t *sk = aes_key.skey;
+  unsigned u;
+
+  aes_add_round_key(q, sk);
+  for (u = 1U; u < aes_key.rounds; u++) {
+    aes_sbox(q);
+    aes_shift_rows(q);
+    aes_mix_columns(q);
+    aes_add_round_key(q, sk + (u << 3));
+  }
+  aes_sbox(q);
+  aes_shift_rows(q);
+  aes_add_round_key(q, sk + (aes_key.rounds << 3));
+}
+
+/**
+ * @brief   Decrypts two bitsliced blocks.
+ *
+ * @param[in,out] q             bitsliced state
+ */
+static void aes_bitslice_decrypt(uint32_t *q) {
+  const uint32_t *sk = aes_key.skey;
+  unsigned u;
+
+  aes_add_round_key(q, sk + (aes_key.rounds << 3));
+  for (u = aes_key.rounds - 1U; u > 0U; u--) {
+    aes_inv_shift_rows(q);
+    aes_inv_sbox(q);
+    aes_add_round_key(q, sk + (u << 3));
+    aes_inv_mix_columns(q);
+  }
+  aes_inv_shift_rows(q);
+  aes_inv_sbox(q);
+  aes_add_round_key(q, sk);
+}
+
+/**
+ * @brief   Processes one or two consecutive blocks.
+ * @details Both blocks are processed in a single pass of the bitsliced
+ *          engine, processing a single block costs the same.
+ *
+ * @param[in] in                input blocks
+ * @param[out] out              output blocks, can be the same as @p in
+ * @param[in] n                 number of blocks, one or two
+ * @param[in] decrypt           @p true for decryption
+ */
+static void aes_process(const uint8_t *in, uint8_t *out,
+                        size_t n, bool decrypt) {
+  const uint8_t *in2 = n > 1U ? in + AES_BLOCK_SIZE : in;
+  uint32_t q[8];
+  unsigned i;
+
+  for (i = 0U; i < 4U; i++) {
+    q[i << 1]        = dec32le(in + (i << 2));
+    q[(i << 1) + 1U] = dec32le(in2 + (i << 2));
+  }
+  aes_ortho(q);
+  if (decrypt) {
+    aes_bitslice_decrypt(q);
+  }
+  else {
+    aes_bitslice_encrypt(q);
+  }
+  aes_ortho(q);
+  for (i = 0U; i < 4U; i++) {
+    enc32le(out + (i << 2), q[i << 1]);
+  }
+  if (n > 1U) {
+    for (i = 0U; i < 4U; i++) {
+      enc32le(out + AES_BLOCK_SIZE + (i << 2), q[(i << 1) + 1U]);
+    }
+  }
+}
+
+/**
+ * @brief   Applies the S-box to the four bytes of a word.
+ */
+static uint32_t aes_sub_word(uint32_t x) {
+  uint32_t q[8];
+
+  memset(q, 0, sizeof q);
+  q[0] = x;
+  aes_ortho(q);
+  aes_sbox(q);
+  aes_ortho(q);
+
+  return q[0];
+}
+
+/**
+ * @brief   Generates the counter mode key stream for two blocks.
+ *
+ * @param[in,out] cb            counter block, incremented twice
+ * @param[out] ks               key stream
+ */
+static void aes_ctr_keystream(uint8_t *cb, uint8_t *ks) {
+
+  memcpy(ks, cb, AES_BLOCK_SIZE);
+  inc32(cb);
+  memcpy(ks + AES_BLOCK_SIZE, cb, AES_BLOCK_SIZE);
+  inc32(cb);
+  aes_process(ks, ks, 2U, false);
+}
+
+/**
+ * @brief   Checks the key identifier of an AES operation.
+ */
+static cryerror_t aes_check_key(crykey_t key_id) {
+
+  if ((key_id != (crykey_t)0) || (aes_key.rounds == 0U)) {
+    return CRY_ERR_INV_KEY_ID;
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Computes the GHASH tables for the current key.
+ */
+static void ghash_init_tables(void) {
+  uint8_t h[AES_BLOCK_SIZE];
+  uint64_t vh, vl;
+  unsigned i, j;
+
+  memset(h, 0, sizeof h);
+  aes_process(h, h, 1U, false);
+
+  vh = dec64be(&h[0]);
+  vl = dec64be(&h[8]);
+  aes_key.hl[8] = vl;
+  aes_key.hh[8] = vh;
+  aes_key.hl[0] = 0U;
+  aes_key.hh[0] = 0U;
+  for (i = 4U; i > 0U; i >>= 1) {
+    uint64_t t = (vl & 1U) * 0xE100000000000000ULL;
+
+    vl = (vh << 63) | (vl >> 1);
+    vh = (vh >> 1) ^ t;
+    aes_key.hl[i] = vl;
+    aes_key.hh[i] = vh;
+  }
+  for (i = 2U; i <= 8U; i <<= 1) {
+    vh = aes_key.hh[i];
+    vl = aes_key.hl[i];
+    for (j = 1U; j < i; j++) {
+      aes_key.hh[i + j] = vh ^ aes_key.hh[j];
+      aes_key.hl[i + j] = vl ^ aes_key.hl[j];
+    }
+  }
+}
+
+/**
+ * @brief   Multiplies the GHASH accumulator by H.
+ *
+ * @param[in,out] y             the GHASH accumulator
+ */
+static void ghash_mult(uint8_t *y) {
+  uint64_t zh, zl;
+  unsigned i, lo, hi, rem;
+
+  lo = (unsigned)y[15] & 0x0FU;
+  zh = aes_key.hh[lo];
+  zl = aes_key.hl[lo];
+  for (i = 16U; i-- > 0U; ) {
+    lo = (unsigned)y[i] & 0x0FU;
+    hi = (unsigned)y[i] >> 4;
+    if (i != 15U) {
+      rem = (unsigned)zl & 0x0FU;
+      zl = (zh << 60) | (zl >> 4);
+      zh = (zh >> 4) ^ (ghash_last4[rem] << 48);
+      zh ^= aes_key.hh[lo];
+      zl ^= aes_key.hl[lo];
+    }
+    rem = (unsigned)zl & 0x0FU;
+    zl = (zh << 60) | (zl >> 4);
+    zh = (zh >> 4) ^ (ghash_last4[rem] << 48);
+    zh ^= aes_key.hh[hi];
+    zl ^= aes_key.hl[hi];
+  }
+  enc64be(&y[0], zh);
+  enc64be(&y[8], zl);
+}
+
+/**
+ * @brief   Processes text in a streaming GCM context.
+ *
+ * @param[in,out] ctxp          the GCM context
+ * @param[in] size              size of the text
+ * @param[in] in                input text
+ * @param[out] out              output text
+ * @param[in] decrypt           @p true if the input is the ciphertext
+ */
+static void gcm_process(AESGCMContext *ctxp, size_t size,
+                        const uint8_t *in, uint8_t *out, bool decrypt) {
+
+  while (size > 0U) {
+    size_t pos = ctxp->text_size % AES_KS_SIZE;
+    size_t i, n;
+
+    if (pos == 0U) {
+      aes_ctr_keystream(ctxp->ctr, ctxp->ks);
+    }
+    n = AES_KS_SIZE - pos;
+    if (n > size) {
+      n = size;
+    }
+    for (i = 0U; i < n; i++) {
+      uint8_t c, p = in[i];
+      size_t k = (pos + i) & (AES_BLOCK_SIZE - 1U);
+
+      c = p ^ ctxp->ks[pos + i];
+      out[i] = c;
+      ctxp->y[k] ^= decrypt ? p : c;
+      if (k == AES_BLOCK_SIZE - 1U) {
+        ghash_mult(ctxp->y);
+      }
+    }
+    ctxp->text_size += n;
+    in   += n;
+    out  += n;
+    size -= n;
+  }
+}
+
+/**
+ * @brief   Computes the GCM tag.
+ *
+ * @param[in,out] ctxp          the GCM context
+ * @param[out] tag              the 16 bytes tag
+ */
+static void gcm_tag(AESGCMContext *ctxp, uint8_t *tag) {
+  uint8_t lens[AES_BLOCK_SIZE];
+
+  if ((ctxp->text_size % AES_BLOCK_SIZE) != 0U) {
+    ghash_mult(ctxp->y);
+  }
+  enc64be(&lens[0], (uint64_t)ctxp->auth_size * 8U);
+  enc64be(&lens[8], (uint64_t)ctxp->text_size * 8U);
+  xor_buf(ctxp->y, ctxp->y, lens, AES_BLOCK_SIZE);
+  ghash_mult(ctxp->y);
+  xor_buf(tag, ctxp->y, ctxp->ek0, AES_BLOCK_SIZE);
+}
+
+/**
+ * @brief   Constant time comparison.
+ *
+ * @return              Zero if the buffers are equal.
+ */
+static unsigned ct_compare(const uint8_t *a, const uint8_t *b, size_t n) {
+  unsigned d = 0U;
+
+  while (n > 0U) {
+    d |= (unsigned)(*a++ ^ *b++);
+    n--;
+  }
+
+  return d;
+}
+
+#if (CRY_LLD_SUPPORTS_SHA1 == FALSE) ||                                     \
+    (CRY_LLD_SUPPORTS_SHA256 == FALSE) ||                                   \
+    (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a compression function with 64 bytes blocks.
+ */
+typedef void (*md32_compress_t)(uint32_t *state, const uint8_t *blk);
+
+/**
+ * @brief   Buffered update for hashes with 64 bytes blocks.
+ *
+ * @param[in,out] state         hash state
+ * @param[in,out] sizep         total size of the hashed data
+ * @param[in,out] buf           partial block buffer
+ * @param[in] size              size of the input data
+ * @param[in] in                input data
+ * @param[in] compress          compression function
+ */
+static void md32_update(uint32_t *state, uint64_t *sizep, uint8_t *buf,
+                        size_t size, const uint8_t *in,
+                        md32_compress_t compress) {
+  size_t pos = (size_t)(*sizep & 63U);
+
+  *sizep += size;
+  if (pos > 0U) {
+    size_t n = 64U - pos;
+
+    if (n > size) {
+      n = size;
+    }
+    memcpy(&buf[pos], in, n);
+    in   += n;
+    size -= n;
+    if (pos + n < 64U) {
+      return;
+    }
+    compress(state, buf);
+  }
+  while (size >= 64U) {
+    compress(state, in);
+    in   += 64U;
+    size -= 64U;
+  }
+  memcpy(buf, in, size);
+}
+
+/**
+ * @brief   Padding and output for hashes with 64 bytes blocks.
+ *
+ * @param[in,out] state         hash state
+ * @param[in] sizep             total size of the hashed data
+ * @param[in,out] buf           partial block buffer
+ * @param[in] compress          compression function
+ * @param[in] n                 number of state words to be output
+ * @param[out] out              digest
+ */
+static void md32_final(uint32_t *state, const uint64_t *sizep, uint8_t *buf,
+                       md32_compress_t compress, unsigned n, uint8_t *out) {
+  size_t pos = (size_t)(*sizep & 63U);
+  unsigned i;
+
+  buf[pos++] = 0x80U;
+  if (pos > 56U) {
+    memset(&buf[pos], 0, 64U - pos);
+    compress(state, buf);
+    pos = 0U;
+  }
+  memset(&buf[pos], 0, 56U - pos);
+  enc64be(&buf[56], *sizep * 8U);
+  compress(state, buf);
+  for (i = 0U; i < n; i++) {
+    enc32be(out + (i << 2), state[i]);
+  }
+}
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA1 == FALSE) || defined(__DOXYGEN__)
+static inline uint32_t rotl32(uint32_t x, unsigned n) {
+
+  return (x << n) | (x >> (32U - n));
+}
+
+static void sha1_compress(uint32_t *state, const uint8_t *blk) {
+  uint32_t w[16];
+  uint32_t a, b, c, d, e, f, k, t;
+  unsigned i;
+
+  for (i = 0U; i < 16U; i++) {
+    w[i] = dec32be(blk + (i << 2));
+  }
+  a = state[0];
+  b = state[1];
+  c = state[2];
+  d = state[3];
+  e = state[4];
+  for (i = 0U; i < 80U; i++) {
+    if (i >= 16U) {
+      w[i & 15U] = rotl32(w[(i + 13U) & 15U] ^ w[(i + 8U) & 15U] ^
+                          w[(i + 2U) & 15U] ^ w[i & 15U], 1U);
+    }
+    if (i < 20U) {
+      f = (b & c) | (~b & d);
+      k = 0x5A827999U;
+    }
+    else if (i < 40U) {
+      f = b ^ c ^ d;
+      k = 0x6ED9EBA1U;
+    }
+    else if (i < 60U) {
+      f = (b & c) | (b & d) | (c & d);
+      k = 0x8F1BBCDCU;
+    }
+    else {
+      f = b ^ c ^ d;
+      k = 0xCA62C1D6U;
+    }
+    t = rotl32(a, 5U) + f + e + k + w[i & 15U];
+    e = d;
+    d = c;
+    c = rotl32(b, 30U);
+    b = a;
+    a = t;
+  }
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+}
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA256 == FALSE) ||                                   \
+    (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) || defined(__DOXYGEN__)
+static inline uint32_t rotr32(uint32_t x, unsigned n) {
+
+  return (x >> n) | (x << (32U - n));
+}
+
+static void sha256_compress(uint32_t *state, const uint8_t *blk) {
+  uint32_t w[64];
+  uint32_t a, b, c, d, e, f, g, h, t1, t2;
+  unsigned i;
+
+  for (i = 0U; i < 16U; i++) {
+    w[i] = dec32be(blk + (i << 2));
+  }
+  for (i = 16U; i < 64U; i++) {
+    uint32_t s0 = rotr32(w[i - 15U], 7U) ^ rotr32(w[i - 15U], 18U) ^
+                  (w[i - 15U] >> 3);
+    uint32_t s1 = rotr32(w[i - 2U], 17U) ^ rotr32(w[i - 2U], 19U) ^
+                  (w[i - 2U] >> 10);
+    w[i] = w[i - 16U] + s0 + w[i - 7U] + s1;
+  }
+  a = state[0];
+  b = state[1];
+  c = state[2];
+  d = state[3];
+  e = state[4];
+  f = state[5];
+  g = state[6];
+  h = state[7];
+  for (i = 0U; i < 64U; i++) {
+    t1 = h + (rotr32(e, 6U) ^ rotr32(e, 11U) ^ rotr32(e, 25U)) +
+         ((e & f) ^ (~e & g)) + sha256_k[i] + w[i];
+    t2 = (rotr32(a, 2U) ^ rotr32(a, 13U) ^ rotr32(a, 22U)) +
+         ((a & b) ^ (a & c) ^ (b & c));
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+static void sha256_init(cry_fallback_sha256_t *ctxp) {
+
+  memcpy(ctxp->state, sha256_h0, sizeof ctxp->state);
+  ctxp->size = 0U;
+}
+
+static void sha256_update(cry_fallback_sha256_t *ctxp,
+                          size_t size, const uint8_t *in) {
+
+  md32_update(ctxp->state, &ctxp->size, ctxp->buf, size, in,
+              sha256_compress);
+}
+
+static void sha256_final(cry_fallback_sha256_t *ctxp, uint8_t *out) {
+
+  md32_final(ctxp->state, &ctxp->size, ctxp->buf, sha256_compress,
+             8U, out);
+}
+#endif
+
+#if (CRY_LLD_SUPPORTS_SHA512 == FALSE) ||                                   \
+    (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE) || defined(__DOXYGEN__)
+static inline uint64_t rotr64(uint64_t x, unsigned n) {
+
+  return (x >> n) | (x << (64U - n));
+}
+
+static void sha512_compress(uint64_t *state, const uint8_t *blk) {
+  uint64_t w[80];
+  uint64_t a, b, c, d, e, f, g, h, t1, t2;
+  unsigned i;
+
+  for (i = 0U; i < 16U; i++) {
+    w[i] = dec64be(blk + (i << 3));
+  }
+  for (i = 16U; i < 80U; i++) {
+    uint64_t s0 = rotr64(w[i - 15U], 1U) ^ rotr64(w[i - 15U], 8U) ^
+                  (w[i - 15U] >> 7);
+    uint64_t s1 = rotr64(w[i - 2U], 19U) ^ rotr64(w[i - 2U], 61U) ^
+                  (w[i - 2U] >> 6);
+    w[i] = w[i - 16U] + s0 + w[i - 7U] + s1;
+  }
+  a = state[0];
+  b = state[1];
+  c = state[2];
+  d = state[3];
+  e = state[4];
+  f = state[5];
+  g = state[6];
+  h = state[7];
+  for (i = 0U; i < 80U; i++) {
+    t1 = h + (rotr64(e, 14U) ^ rotr64(e, 18U) ^ rotr64(e, 41U)) +
+         ((e & f) ^ (~e & g)) + sha512_k[i] + w[i];
+    t2 = (rotr64(a, 28U) ^ rotr64(a, 34U) ^ rotr64(a, 39U)) +
+         ((a & b) ^ (a & c) ^ (b & c));
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+static void sha512_init(cry_fallback_sha512_t *ctxp) {
+
+  memcpy(ctxp->state, sha512_h0, sizeof ctxp->state);
+  ctxp->size = 0U;
+}
+
+static void sha512_update(cry_fallback_sha512_t *ctxp,
+                          size_t size, const uint8_t *in) {
+  size_t pos = (size_t)(ctxp->size & 127U);
+
+  ctxp->size += size;
+  if (pos > 0U) {
+    size_t n = 128U - pos;
+
+    if (n > size) {
+      n = size;
+    }
+    memcpy(&ctxp->buf[pos], in, n);
+    in   += n;
+    size -= n;
+    if (pos + n < 128U) {
+      return;
+    }
+    sha512_compress(ctxp->state, ctxp->buf);
+  }
+  while (size >= 128U) {
+    sha512_compress(ctxp->state, in);
+    in   += 128U;
+    size -= 128U;
+  }
+  memcpy(ctxp->buf, in, size);
+}
+
+static void sha512_final(cry_fallback_sha512_t *ctxp, uint8_t *out) {
+  size_t pos = (size_t)(ctxp->size & 127U);
+  unsigned i;
+
+  ctxp->buf[pos++] = 0x80U;
+  if (pos > 112U) {
+    memset(&ctxp->buf[pos], 0, 128U - pos);
+    sha512_compress(ctxp->state, ctxp->buf);
+    pos = 0U;
+  }
+  memset(&ctxp->buf[pos], 0, 120U - pos);
+  enc64be(&ctxp->buf[120], ctxp->size * 8U);
+  sha512_compress(ctxp->state, ctxp->buf);
+  for (i = 0U; i < 8U; i++) {
+    enc64be(out + (i << 3), ctxp->state[i]);
+  }
+}
+#endif
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) ||                              \
+    (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Prepares an HMAC padded key block.
+ *
+ * @param[out] blk              the key block
+ * @param[in] bsize             hash block size
+ * @param[in] pad               pad byte
+ */
+static void hmac_key_block(uint8_t *blk, size_t bsize, uint8_t pad) {
+  size_t i;
+
+  memset(blk, 0, bsize);
+  if (hmac_key.size > bsize) {
+    /* Keys longer than the block are replaced by their digest, it has
+       been calculated when the key has been loaded.*/
+#if CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE
+    if (bsize == 64U) {
+      memcpy(blk, hmac_key.sha256, sizeof hmac_key.sha256);
+    }
+#endif
+#if CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE
+    if (bsize == 128U) {
+      memcpy(blk, hmac_key.sha512, sizeof hmac_key.sha512);
+    }
+#endif
+  }
+  else {
+    memcpy(blk, hmac_key.data, hmac_key.size);
+  }
+  for (i = 0U; i < bsize; i++) {
+    blk[i] ^= pad;
+  }
+}
+#endif
+
+/*===========================================================================*/
+/* Driver exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes the AES transient key.
+ * @note    The bitsliced round keys and the GHASH tables are computed
+ *          here, the cost of a key change is roughly equivalent to the
+ *          encryption of 20 blocks.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] size              key size in bytes
+ * @param[in] keyp              pointer to the key data
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_SIZE if the specified key size is invalid for
+ *                              the specified algorithm.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_aes_loadkey(CRYDriver *cryp,
+                                    size_t size,
+                                    const uint8_t *keyp) {
+  unsigned i, j, k, nk, nkf;
+  uint32_t tmp;
+
+  (void)cryp;
+
+  if ((size != 16U) && (size != 24U) && (size != 32U)) {
+    return CRY_ERR_INV_KEY_SIZE;
+  }
+
+  nk  = (unsigned)size >> 2;
+  aes_key.rounds = nk + 6U;
+  nkf = (aes_key.rounds + 1U) << 2;
+
+  /* Key expansion, each word is duplicated for the two bitsliced blocks.*/
+  tmp = 0U;
+  for (i = 0U; i < nk; i++) {
+    tmp = dec32le(keyp + (i << 2));
+    aes_key.skey[i << 1]        = tmp;
+    aes_key.skey[(i << 1) + 1U] = tmp;
+  }
+  for (i = nk, j = 0U, k = 0U; i < nkf; i++) {
+    if (j == 0U) {
+      tmp = aes_sub_word(rotr8(tmp)) ^ (uint32_t)aes_rcon[k];
+    }
+    else if ((nk > 6U) && (j == 4U)) {
+      tmp = aes_sub_word(tmp);
+    }
+    tmp ^= aes_key.skey[(i - nk) << 1];
+    aes_key.skey[i << 1]        = tmp;
+    aes_key.skey[(i << 1) + 1U] = tmp;
+    if (++j == nk) {
+      j = 0U;
+      k++;
+    }
+  }
+  for (i = 0U; i < nkf; i += 4U) {
+    aes_ortho(&aes_key.skey[i << 1]);
+  }
+
+  ghash_init_tables();
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Encryption of a single block using AES.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    const uint8_t *in,
+                                    uint8_t *out) {
+  cryerror_t err;
+
+  (void)cryp;
+
+  err = aes_check_key(key_id);
+  if (err == CRY_NOERROR) {
+    aes_process(in, out, 1U, false);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption of a single block using AES.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    const uint8_t *in,
+                                    uint8_t *out) {
+  cryerror_t err;
+
+  (void)cryp;
+
+  err = aes_check_key(key_id);
+  if (err == CRY_NOERROR) {
+    aes_process(in, out, 1U, true);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Encryption operation using AES-ECB.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_ECB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out) {
+  cryerror_t err;
+
+  (void)cryp;
+
+  err = aes_check_key(key_id);
+  if (err == CRY_NOERROR) {
+    while (size >= AES_BLOCK_SIZE) {
+      size_t n = size >= AES_KS_SIZE ? 2U : 1U;
+
+      aes_process(in, out, n, false);
+      in   += n * AES_BLOCK_SIZE;
+      out  += n * AES_BLOCK_SIZE;
+      size -= n * AES_BLOCK_SIZE;
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption operation using AES-ECB.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_ECB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out) {
+  cryerror_t err;
+
+  (void)cryp;
+
+  err = aes_check_key(key_id);
+  if (err == CRY_NOERROR) {
+    while (size >= AES_BLOCK_SIZE) {
+      size_t n = size >= AES_KS_SIZE ? 2U : 1U;
+
+      aes_process(in, out, n, true);
+      in   += n * AES_BLOCK_SIZE;
+      out  += n * AES_BLOCK_SIZE;
+      size -= n * AES_BLOCK_SIZE;
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Encryption operation using AES-CBC.
+ * @note    CBC encryption is sequential, a block at time is processed.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                128 bits input vector
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_CBC(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  const uint8_t *prev = iv;
+  cryerror_t err;
+
+  (void)cryp;
+
+  err = aes_check_key(key_id);
+  if (err == CRY_NOERROR) {
+    while (size >= AES_BLOCK_SIZE) {
+      xor_buf(out, in, prev, AES_BLOCK_SIZE);
+      aes_process(out, out, 1U, false);
+      prev  = out;
+      in   += AES_BLOCK_SIZE;
+      out  += AES_BLOCK_SIZE;
+      size -= AES_BLOCK_SIZE;
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption operation using AES-CBC.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key
+ * @param[in] size              size of both buffers, this number must be a
+ *                              multiple of 16
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @param[in] iv                128 bits input vector
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_CBC(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  uint8_t prev[AES_KS_SIZE + AES_BLOCK_SIZE], tmp[AES_KS_SIZE];
+  cryerror_t err;
+
+  (void)cryp;
+
+  err = aes_check_key(key_id);
+  if (err == CRY_NOERROR) {
+    memcpy(prev, iv, AES_BLOCK_SIZE);
+    while (size >= AES_BLOCK_SIZE) {
+      size_t n = size >= AES_KS_SIZE ? 2U : 1U;
+
+      /* The ciphertext is saved because buffers can overlap.*/
+      memcpy(&prev[AES_BLOCK_SIZE], in, n * AES_BLOCK_SIZE);
+      aes_process(in, tmp, n, true);
+      xor_buf(out, tmp, prev, n * AES_BLOCK_SIZE);
+      memcpy(prev, &prev[n * AES_BLOCK_SIZE], AES_BLOCK_SIZE);
+      in   += n * AES_BLOCK_SIZE;
+      out  += n * AES_BLOCK_SIZE;
+      size -= n * AES_BLOCK_SIZE;
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Encryption operation using AES-CFB.
+ * @note    This is a stream cipher, there are no size restrictions.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                128 bits input vector
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_CFB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  uint8_t ks[AES_BLOCK_SIZE];
+  cryerror_t err;
+
+  (void)cryp;
+
+  err = aes_check_key(key_id);
+  if (err == CRY_NOERROR) {
+    memcpy(ks, iv, AES_BLOCK_SIZE);
+    while (size > 0U) {
+      size_t n = size >= AES_BLOCK_SIZE ? AES_BLOCK_SIZE : size;
+
+      aes_process(ks, ks, 1U, false);
+      xor_buf(out, in, ks, n);
+      memcpy(ks, out, n);
+      in   += n;
+      out  += n;
+      size -= n;
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption operation using AES-CFB.
+ * @note    This is a stream cipher, there are no size restrictions.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @param[in] iv                128 bits input vector
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_CFB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  uint8_t ks[AES_KS_SIZE], fb[AES_BLOCK_SIZE];
+  cryerror_t err;
+
+  (void)cryp;
+
+  err = aes_check_key(key_id);
+  if (err == CRY_NOERROR) {
+    memcpy(fb, iv, AES_BLOCK_SIZE);
+    while (size > 0U) {
+      size_t n = size >= AES_KS_SIZE ? AES_KS_SIZE : size;
+      size_t nb = n > AES_BLOCK_SIZE ? 2U : 1U;
+
+      /* The feedback is the ciphertext, so the key stream of two blocks
+         can be computed in a single pass.*/
+      memcpy(ks, fb, AES_BLOCK_SIZE);
+      if (nb > 1U) {
+        memcpy(&ks[AES_BLOCK_SIZE], in, AES_BLOCK_SIZE);
+      }
+      if (n >= nb * AES_BLOCK_SIZE) {
+        memcpy(fb, &in[(nb - 1U) * AES_BLOCK_SIZE], AES_BLOCK_SIZE);
+      }
+      aes_process(ks, ks, nb, false);
+      xor_buf(out, in, ks, n);
+      in   += n;
+      out  += n;
+      size -= n;
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Encryption operation using AES-CTR.
+ * @note    This is a stream cipher, there are no size restrictions.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                128 bits input vector + counter, it contains
+ *                              a 96 bits IV and a 32 bits counter
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_CTR(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+  uint8_t cb[AES_BLOCK_SIZE], ks[AES_KS_SIZE];
+  cryerror_t err;
+
+  (void)cryp;
+
+  err = aes_check_key(key_id);
+  if (err == CRY_NOERROR) {
+    memcpy(cb, iv, AES_BLOCK_SIZE);
+    while (size > 0U) {
+      size_t n = size >= AES_KS_SIZE ? AES_KS_SIZE : size;
+
+      aes_ctr_keystream(cb, ks);
+      xor_buf(out, in, ks, n);
+      in   += n;
+      out  += n;
+      size -= n;
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption operation using AES-CTR.
+ * @note    This is a stream cipher, there are no size restrictions.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @param[in] iv                128 bits input vector + counter, it contains
+ *                              a 96 bits IV and a 32 bits counter
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_CTR(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+
+  return cry_fallback_encrypt_AES_CTR(cryp, key_id, size, in, out, iv);
+}
+
+/**
+ * @brief   Encryption operation using AES-GCM.
+ * @note    This is a stream cipher, there are no size restrictions.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key
+ * @param[in] auth_size         size of the data buffer to be authenticated
+ * @param[in] auth_in           buffer containing the data to be authenticated
+ * @param[in] text_size         size of the text buffer
+ * @param[in] text_in           buffer containing the input plaintext
+ * @param[out] text_out         buffer for the output ciphertext
+ * @param[in] iv                input vector, only the first 96 bits are
+ *                              used, the counter is handled internally
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[out] tag_out          buffer for the generated authentication tag
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_GCM(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t auth_size,
+                                        const uint8_t *auth_in,
+                                        size_t text_size,
+                                        const uint8_t *text_in,
+                                        uint8_t *text_out,
+                                        const uint8_t *iv,
+                                        size_t tag_size,
+                                        uint8_t *tag_out) {
+  AESGCMContext ctx;
+  cryerror_t err;
+
+  err = cry_fallback_AES_GCM_init(cryp, &ctx, key_id, iv,
+                                  auth_size, auth_in);
+  if (err == CRY_NOERROR) {
+    gcm_process(&ctx, text_size, text_in, text_out, false);
+    err = cry_fallback_encrypt_AES_GCM_final(cryp, &ctx, tag_size, tag_out);
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Decryption operation using AES-GCM.
+ * @note    This is a stream cipher, there are no size restrictions.
+ * @note    If the authentication fails then the output buffer is cleared.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key
+ * @param[in] auth_size         size of the data buffer to be authenticated
+ * @param[in] auth_in           buffer containing the data to be authenticated
+ * @param[in] text_size         size of the text buffer
+ * @param[in] text_in           buffer containing the input ciphertext
+ * @param[out] text_out         buffer for the output plaintext
+ * @param[in] iv                input vector, only the first 96 bits are
+ *                              used, the counter is handled internally
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[in] tag_in            buffer containing the authentication tag
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ * @retval CRY_ERR_AUTH_FAILED  authentication failed
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_GCM(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t auth_size,
+                                        const uint8_t *auth_in,
+                                        size_t text_size,
+                                        const uint8_t *text_in,
+                                        uint8_t *text_out,
+                                        const uint8_t *iv,
+                                        size_t tag_size,
+                                        const uint8_t *tag_in) {
+  AESGCMContext ctx;
+  cryerror_t err;
+
+  err = cry_fallback_AES_GCM_init(cryp, &ctx, key_id, iv,
+                                  auth_size, auth_in);
+  if (err == CRY_NOERROR) {
+    gcm_process(&ctx, text_size, text_in, text_out, true);
+    err = cry_fallback_decrypt_AES_GCM_final(cryp, &ctx, tag_size, tag_in);
+    if (err != CRY_NOERROR) {
+      memset(text_out, 0, text_size);
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Initializes a streaming AES-GCM operation.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] gcmctxp          pointer to a GCM context to be initialized
+ * @param[in] key_id            the key to be used for the operation, zero is
+ *                              the transient key
+ * @param[in] iv                input vector, only the first 96 bits are
+ *                              used, the counter is handled internally
+ * @param[in] auth_size         size of the data buffer to be authenticated
+ * @param[in] auth_in           buffer containing the data to be authenticated
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_INV_KEY_ID   if the specified key identifier is invalid
+ *                              or refers to an empty key slot.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_AES_GCM_init(CRYDriver *cryp,
+                                     AESGCMContext *gcmctxp,
+                                     crykey_t key_id,
+                                     const uint8_t *iv,
+                                     size_t auth_size,
+                                     const uint8_t *auth_in) {
+  cryerror_t err;
+
+  (void)cryp;
+
+  err = aes_check_key(key_id);
+  if (err == CRY_NOERROR) {
+    /* J0 = IV || 1, its encryption masks the tag.*/
+    memcpy(gcmctxp->ctr, iv, 12U);
+    enc32be(&gcmctxp->ctr[12], 1U);
+    aes_process(gcmctxp->ctr, gcmctxp->ek0, 1U, false);
+    inc32(gcmctxp->ctr);
+
+    /* Hashing the authenticated data, the last block is zero-padded.*/
+    memset(gcmctxp->y, 0, AES_BLOCK_SIZE);
+    gcmctxp->auth_size = auth_size;
+    gcmctxp->text_size = 0U;
+    while (auth_size > 0U) {
+      size_t n = auth_size >= AES_BLOCK_SIZE ? AES_BLOCK_SIZE : auth_size;
+
+      xor_buf(gcmctxp->y, gcmctxp->y, auth_in, n);
+      ghash_mult(gcmctxp->y);
+      auth_in   += n;
+      auth_size -= n;
+    }
+  }
+
+  return err;
+}
+
+/**
+ * @brief   Encrypts a chunk of a streaming AES-GCM operation.
+ * @note    Chunks can have any size.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] gcmctxp       pointer to a GCM context
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_GCM_update(CRYDriver *cryp,
+                                               AESGCMContext *gcmctxp,
+                                               size_t size,
+                                               const uint8_t *in,
+                                               uint8_t *out) {
+
+  (void)cryp;
+
+  gcm_process(gcmctxp, size, in, out, false);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Decrypts a chunk of a streaming AES-GCM operation.
+ * @note    Chunks can have any size.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] gcmctxp       pointer to a GCM context
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_GCM_update(CRYDriver *cryp,
+                                               AESGCMContext *gcmctxp,
+                                               size_t size,
+                                               const uint8_t *in,
+                                               uint8_t *out) {
+
+  (void)cryp;
+
+  gcm_process(gcmctxp, size, in, out, true);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Terminates a streaming AES-GCM encryption.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] gcmctxp       pointer to a GCM context
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[out] tag_out          buffer for the generated authentication tag
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_AES_GCM_final(CRYDriver *cryp,
+                                              AESGCMContext *gcmctxp,
+                                              size_t tag_size,
+                                              uint8_t *tag_out) {
+  uint8_t tag[AES_BLOCK_SIZE];
+
+  (void)cryp;
+
+  gcm_tag(gcmctxp, tag);
+  memcpy(tag_out, tag, tag_size);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Terminates a streaming AES-GCM decryption.
+ * @note    The tag is compared in constant time.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in,out] gcmctxp       pointer to a GCM context
+ * @param[in] tag_size          size of the authentication tag, this number
+ *                              must be between 1 and 16
+ * @param[in] tag_in            buffer containing the authentication tag
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ * @retval CRY_ERR_AUTH_FAILED  authentication failed
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_AES_GCM_final(CRYDriver *cryp,
+                                              AESGCMContext *gcmctxp,
+                                              size_t tag_size,
+                                              const uint8_t *tag_in) {
+  uint8_t tag[AES_BLOCK_SIZE];
+
+  (void)cryp;
+
+  gcm_tag(gcmctxp, tag);
+  if (ct_compare(tag, tag_in, tag_size) != 0U) {
+    return CRY_ERR_AUTH_FAILED;
+  }
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Initializes the DES transient key.
+ * @note    DES is not implemented by the fall-back.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] size              key size in bytes
+ * @param[in] keyp              pointer to the key data
+ * @return                      The operation status.
+ * @retval CRY_ERR_INV_ALGO     the algorithm is unsupported.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_des_loadkey(CRYDriver *cryp,
+                                    size_t size,
+                                    const uint8_t *keyp) {
+
+  (void)cryp;
+  (void)size;
+  (void)keyp;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Encryption of a single block using (T)DES.
+ * @note    DES is not implemented by the fall-back.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ * @retval CRY_ERR_INV_ALGO     the algorithm is unsupported.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_DES(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    const uint8_t *in,
+                                    uint8_t *out) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Decryption of a single block using (T)DES.
+ * @note    DES is not implemented by the fall-back.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ * @retval CRY_ERR_INV_ALGO     the algorithm is unsupported.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_DES(CRYDriver *cryp,
+                                    crykey_t key_id,
+                                    const uint8_t *in,
+                                    uint8_t *out) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Encryption operation using (T)DES-ECB.
+ * @note    DES is not implemented by the fall-back.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @return                      The operation status.
+ * @retval CRY_ERR_INV_ALGO     the algorithm is unsupported.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_DES_ECB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)size;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Decryption operation using (T)DES-ECB.
+ * @note    DES is not implemented by the fall-back.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @return                      The operation status.
+ * @retval CRY_ERR_INV_ALGO     the algorithm is unsupported.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_DES_ECB(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)size;
+  (void)in;
+  (void)out;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Encryption operation using (T)DES-CBC.
+ * @note    DES is not implemented by the fall-back.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input plaintext
+ * @param[out] out              buffer for the output ciphertext
+ * @param[in] iv                64 bits input vector
+ * @return                      The operation status.
+ * @retval CRY_ERR_INV_ALGO     the algorithm is unsupported.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_encrypt_DES_CBC(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)size;
+  (void)in;
+  (void)out;
+  (void)iv;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+/**
+ * @brief   Decryption operation using (T)DES-CBC.
+ * @note    DES is not implemented by the fall-back.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] key_id            the key to be used for the operation
+ * @param[in] size              size of both buffers
+ * @param[in] in                buffer containing the input ciphertext
+ * @param[out] out              buffer for the output plaintext
+ * @param[in] iv                64 bits input vector
+ * @return                      The operation status.
+ * @retval CRY_ERR_INV_ALGO     the algorithm is unsupported.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_decrypt_DES_CBC(CRYDriver *cryp,
+                                        crykey_t key_id,
+                                        size_t size,
+                                        const uint8_t *in,
+                                        uint8_t *out,
+                                        const uint8_t *iv) {
+
+  (void)cryp;
+  (void)key_id;
+  (void)size;
+  (void)in;
+  (void)out;
+  (void)iv;
+
+  return CRY_ERR_INV_ALGO;
+}
+
+#if (CRY_LLD_SUPPORTS_SHA1 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Hash initialization using SHA1.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] sha1ctxp         pointer to a SHA1 context to be initialized
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA1_init(CRYDriver *cryp, SHA1Context *sha1ctxp) {
+
+  (void)cryp;
+
+  sha1ctxp->state[0] = 0x67452301U;
+  sha1ctxp->state[1] = 0xEFCDAB89U;
+  sha1ctxp->state[2] = 0x98BADCFEU;
+  sha1ctxp->state[3] = 0x10325476U;
+  sha1ctxp->state[4] = 0xC3D2E1F0U;
+  sha1ctxp->size     = 0U;
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash update using SHA1.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha1ctxp          pointer to a SHA1 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA1_update(CRYDriver *cryp, SHA1Context *sha1ctxp,
+                                    size_t size, const uint8_t *in) {
+
+  (void)cryp;
+
+  md32_update(sha1ctxp->state, &sha1ctxp->size, sha1ctxp->buf, size, in,
+              sha1_compress);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using SHA1.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha1ctxp          pointer to a SHA1 context
+ * @param[out] out              20 bytes output buffer
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA1_final(CRYDriver *cryp, SHA1Context *sha1ctxp,
+                                   uint8_t *out) {
+
+  (void)cryp;
+
+  md32_final(sha1ctxp->state, &sha1ctxp->size, sha1ctxp->buf,
+             sha1_compress, 5U, out);
+
+  return CRY_NOERROR;
+}
+#endif /* CRY_LLD_SUPPORTS_SHA1 == FALSE */
+
+#if (CRY_LLD_SUPPORTS_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Hash initialization using SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] sha256ctxp       pointer to a SHA256 context to be initialized
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA256_init(CRYDriver *cryp,
+                                    SHA256Context *sha256ctxp) {
+
+  (void)cryp;
+
+  sha256_init(sha256ctxp);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash update using SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha256ctxp        pointer to a SHA256 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA256_update(CRYDriver *cryp,
+                                      SHA256Context *sha256ctxp,
+                                      size_t size, const uint8_t *in) {
+
+  (void)cryp;
+
+  sha256_update(sha256ctxp, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha256ctxp        pointer to a SHA256 context
+ * @param[out] out              32 bytes output buffer
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA256_final(CRYDriver *cryp,
+                                     SHA256Context *sha256ctxp,
+                                     uint8_t *out) {
+
+  (void)cryp;
+
+  sha256_final(sha256ctxp, out);
+
+  return CRY_NOERROR;
+}
+#endif /* CRY_LLD_SUPPORTS_SHA256 == FALSE */
+
+#if (CRY_LLD_SUPPORTS_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Hash initialization using SHA512.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] sha512ctxp       pointer to a SHA512 context to be initialized
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA512_init(CRYDriver *cryp,
+                                    SHA512Context *sha512ctxp) {
+
+  (void)cryp;
+
+  sha512_init(sha512ctxp);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash update using SHA512.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha512ctxp        pointer to a SHA512 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA512_update(CRYDriver *cryp,
+                                      SHA512Context *sha512ctxp,
+                                      size_t size, const uint8_t *in) {
+
+  (void)cryp;
+
+  sha512_update(sha512ctxp, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using SHA512.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] sha512ctxp        pointer to a SHA512 context
+ * @param[out] out              64 bytes output buffer
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_SHA512_final(CRYDriver *cryp,
+                                     SHA512Context *sha512ctxp,
+                                     uint8_t *out) {
+
+  (void)cryp;
+
+  sha512_final(sha512ctxp, out);
+
+  return CRY_NOERROR;
+}
+#endif /* CRY_LLD_SUPPORTS_SHA512 == FALSE */
+
+/**
+ * @brief   Initializes the HMAC transient key.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @note    Keys longer than the hash block size are replaced by their
+ *          digest, as required by the HMAC specification, the digests
+ *          are calculated here for all the HMAC algorithms served by
+ *          the fallback.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] size              key size in bytes
+ * @param[in] keyp              pointer to the key data
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_hmac_loadkey(CRYDriver *cryp,
+                                     size_t size,
+                                     const uint8_t *keyp) {
+
+  (void)cryp;
+
+#if CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE
+  if (size > 64U) {
+    cry_fallback_sha256_t sha;
+
+    sha256_init(&sha);
+    sha256_update(&sha, size, keyp);
+    sha256_final(&sha, hmac_key.sha256);
+  }
+#endif
+#if CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE
+  if (size > 128U) {
+    cry_fallback_sha512_t sha;
+
+    sha512_init(&sha);
+    sha512_update(&sha, size, keyp);
+    sha512_final(&sha, hmac_key.sha512);
+  }
+#endif
+  if (size <= CRY_FALLBACK_HMAC_KEY_MAX_SIZE) {
+    memcpy(hmac_key.data, keyp, size);
+  }
+  hmac_key.size = size;
+
+  return CRY_NOERROR;
+}
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Hash initialization using HMAC_SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] hmacsha256ctxp   pointer to a HMAC_SHA256 context to be
+ *                              initialized
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA256_init(CRYDriver *cryp,
+                                        HMACSHA256Context *hmacsha256ctxp) {
+  uint8_t blk[64];
+
+  (void)cryp;
+
+  hmac_key_block(blk, sizeof blk, 0x36U);
+  sha256_init(&hmacsha256ctxp->sha);
+  sha256_update(&hmacsha256ctxp->sha, sizeof blk, blk);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash update using HMAC_SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] hmacsha256ctxp    pointer to a HMAC_SHA256 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA256_update(CRYDriver *cryp,
+                                          HMACSHA256Context *hmacsha256ctxp,
+                                          size_t size,
+                                          const uint8_t *in) {
+
+  (void)cryp;
+
+  sha256_update(&hmacsha256ctxp->sha, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using HMAC_SHA256.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] hmacsha256ctxp    pointer to a HMAC_SHA256 context
+ * @param[out] out              32 bytes output buffer
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA256_final(CRYDriver *cryp,
+                                         HMACSHA256Context *hmacsha256ctxp,
+                                         uint8_t *out) {
+  uint8_t blk[64];
+
+  (void)cryp;
+
+  /* Outer hash over the inner digest.*/
+  sha256_final(&hmacsha256ctxp->sha, out);
+  hmac_key_block(blk, sizeof blk, 0x5CU);
+  sha256_init(&hmacsha256ctxp->sha);
+  sha256_update(&hmacsha256ctxp->sha, sizeof blk, blk);
+  sha256_update(&hmacsha256ctxp->sha, 32U, out);
+  sha256_final(&hmacsha256ctxp->sha, out);
+
+  return CRY_NOERROR;
+}
+#endif /* CRY_LLD_SUPPORTS_HMAC_SHA256 == FALSE */
+
+#if (CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE) || defined(__DOXYGEN__)
+/**
+ * @brief   Hash initialization using HMAC_SHA512.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[out] hmacsha512ctxp   pointer to a HMAC_SHA512 context to be
+ *                              initialized
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA512_init(CRYDriver *cryp,
+                                        HMACSHA512Context *hmacsha512ctxp) {
+  uint8_t blk[128];
+
+  (void)cryp;
+
+  hmac_key_block(blk, sizeof blk, 0x36U);
+  sha512_init(&hmacsha512ctxp->sha);
+  sha512_update(&hmacsha512ctxp->sha, sizeof blk, blk);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash update using HMAC_SHA512.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] hmacsha512ctxp    pointer to a HMAC_SHA512 context
+ * @param[in] size              size of input buffer
+ * @param[in] in                buffer containing the input text
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA512_update(CRYDriver *cryp,
+                                          HMACSHA512Context *hmacsha512ctxp,
+                                          size_t size,
+                                          const uint8_t *in) {
+
+  (void)cryp;
+
+  sha512_update(&hmacsha512ctxp->sha, size, in);
+
+  return CRY_NOERROR;
+}
+
+/**
+ * @brief   Hash finalization using HMAC_SHA512.
+ *
+ * @param[in] cryp              pointer to the @p CRYDriver object
+ * @param[in] hmacsha512ctxp    pointer to a HMAC_SHA512 context
+ * @param[out] out              64 bytes output buffer
+ * @return                      The operation status.
+ * @retval CRY_NOERROR          if the operation succeeded.
+ *
+ * @notapi
+ */
+cryerror_t cry_fallback_HMACSHA512_final(CRYDriver *cryp,
+                                         HMACSHA512Context *hmacsha512ctxp,
+                                         uint8_t *out) {
+  uint8_t blk[128];
+
+  (void)cryp;
+
+  /* Outer hash over the inner digest.*/
+  sha512_final(&hmacsha512ctxp->sha, out);
+  hmac_key_block(blk, sizeof blk, 0x5CU);
+  sha512_init(&hmacsha512ctxp->sha);
+  sha512_update(&hmacsha512ctxp->sha, sizeof blk, blk);
+  sha512_update(&hmacsha512ctxp->sha, 64U, out);
+  sha512_final(&hmacsha512ctxp->sha, out);
+
+  return CRY_NOERROR;
+}
+#endif /* CRY_LLD_SUPPORTS_HMAC_SHA512 == FALSE */
+
+#endif /* (HAL_USE_CRY == TRUE) && (HAL_CRY_USE_FALLBACK == TRUE) */
+
+/** @} */
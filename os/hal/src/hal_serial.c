@@ -275,6 +275,62 @@ msg_t sdRequestDataI(SerialDriver *sdp) {
   return b;
 }
 
+/**
+ * @brief   Handles a block of incoming data.
+ * @details This function can be called from the input interrupt service
+ *          routine of drivers able to receive more than one byte per
+ *          interrupt, for example from an hardware FIFO, in order to
+ *          enqueue the incoming data and generate the related events.
+ * @note    The incoming data event is only generated when the input queue
+ *          becomes non-empty.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver structure
+ * @param[in] bp        pointer to the received data
+ * @param[in] n         number of received bytes, the value 0 is reserved
+ *
+ * @iclass
+ */
+void sdIncomingDataBlockI(SerialDriver *sdp, const uint8_t *bp, size_t n) {
+
+  osalDbgCheckClassI();
+  osalDbgCheck((sdp != NULL) && (bp != NULL) && (n > 0U));
+
+  if (iqIsEmptyI(&sdp->iqueue))
+    chnAddFlagsI(sdp, CHN_INPUT_AVAILABLE);
+  if (iqWriteI(&sdp->iqueue, bp, n) < n)
+    chnAddFlagsI(sdp, SD_QUEUE_FULL_ERROR);
+}
+
+/**
+ * @brief   Handles a block of outgoing data.
+ * @details This function can be called from the output interrupt service
+ *          routine of drivers able to transmit more than one byte per
+ *          interrupt, for example into an hardware FIFO, in order to get
+ *          the next bytes to be transmitted.
+ *
+ * @param[in] sdp       pointer to a @p SerialDriver structure
+ * @param[out] bp       pointer to the data buffer
+ * @param[in] n         maximum number of bytes to be read, the value 0 is
+ *                      reserved
+ * @return              The number of bytes read from the driver's output
+ *                      queue.
+ * @retval 0            if the queue is empty (the lower driver usually
+ *                      disables the interrupt source when this happens).
+ *
+ * @iclass
+ */
+size_t sdRequestDataBlockI(SerialDriver *sdp, uint8_t *bp, size_t n) {
+  size_t rd;
+
+  osalDbgCheckClassI();
+  osalDbgCheck((sdp != NULL) && (bp != NULL) && (n > 0U));
+
+  rd = oqReadI(&sdp->oqueue, bp, n);
+  if (rd == (size_t)0)
+    chnAddFlagsI(sdp, CHN_OUTPUT_EMPTY);
+  return rd;
+}
+
 /**
  * @brief   Direct output check on a @p SerialDriver.
  * @note    This function bypasses the indirect access to the channel and
@@ -42,6 +42,49 @@
 /* Driver local functions.                                                   */
 /*===========================================================================*/
 
+#if (SPI_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Starts the next transaction in the queue.
+ * @note    The driver is reconfigured if the transaction uses a different
+ *          configuration, this requires that the LLD start function can
+ *          be invoked from within a critical zone.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+static void spi_queue_start(SPIDriver *spip) {
+  spi_transaction_t *stp = spip->tqueue;
+
+  spip->tqueue   = stp->next;
+  spip->tcurrent = stp;
+  stp->state     = SPI_TRANSACTION_ACTIVE;
+
+  if (stp->config != spip->config) {
+    spip->config = stp->config;
+    spi_lld_start(spip);
+  }
+
+  spiSelectI(spip);
+  if (stp->txbuf == NULL) {
+    if (stp->rxbuf == NULL) {
+      spiStartIgnoreI(spip, stp->n);
+    }
+    else {
+      spiStartReceiveI(spip, stp->n, stp->rxbuf);
+    }
+  }
+  else {
+    if (stp->rxbuf == NULL) {
+      spiStartSendI(spip, stp->n, stp->txbuf);
+    }
+    else {
+      spiStartExchangeI(spip, stp->n, stp->txbuf, stp->rxbuf);
+    }
+  }
+}
+#endif /* SPI_USE_QUEUE == TRUE */
+
 /*===========================================================================*/
 /* Driver exported functions.                                                */
 /*===========================================================================*/
@@ -75,6 +118,10 @@ void spiObjectInit(SPIDriver *spip) {
 #if SPI_USE_MUTUAL_EXCLUSION == TRUE
   osalMutexObjectInit(&spip->mutex);
 #endif
+#if SPI_USE_QUEUE == TRUE
+  spip->tqueue   = NULL;
+  spip->tcurrent = NULL;
+#endif
 #if defined(SPI_DRIVER_EXT_INIT_HOOK)
   SPI_DRIVER_EXT_INIT_HOOK(spip);
 #endif
@@ -116,6 +163,10 @@ void spiStop(SPIDriver *spip) {
 
   osalDbgAssert((spip->state == SPI_STOP) || (spip->state == SPI_READY),
                 "invalid state");
+#if SPI_USE_QUEUE == TRUE
+  osalDbgAssert((spip->tqueue == NULL) && (spip->tcurrent == NULL),
+                "transactions pending");
+#endif
 
   spi_lld_stop(spip);
   spip->config = NULL;
@@ -464,6 +515,178 @@ void spiReleaseBus(SPIDriver *spip) {
 }
 #endif /* SPI_USE_MUTUAL_EXCLUSION == TRUE */
 
+#if (SPI_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Queues a transaction.
+ * @details The transaction is inserted in the driver queue after all the
+ *          pending transactions with higher or equal priority, it is
+ *          started immediately if the driver is idle. Queued transactions
+ *          are executed back-to-back from the completion interrupt, the CS
+ *          line is asserted before each transaction and deasserted after.
+ * @note    If the transaction specifies the @p SPI_TRANSACTION_KEEP_SELECTED
+ *          flag then the CS line is not deasserted at its end and the
+ *          transaction pointed by its @p next field is queued with it as
+ *          a single group, groups are never split by other transactions.
+ *          A group being executed cannot be preempted, new transactions
+ *          are always inserted after its last member.
+ * @note    The queue cannot be used while a non-queued operation is in
+ *          progress, mutual exclusion between the two methods is
+ *          responsibility of the application.
+ * @post    At the end of each transaction its callback is invoked, the
+ *          driver configuration callback is not invoked.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] stp       pointer to the first @p spi_transaction_t of the group
+ *
+ * @iclass
+ */
+void spiQueueTransactionI(SPIDriver *spip, spi_transaction_t *stp) {
+  spi_transaction_t **pp, *last;
+
+  osalDbgCheckClassI();
+  osalDbgCheck((spip != NULL) && (stp != NULL));
+  osalDbgAssert((spip->state == SPI_READY) ||
+                ((spip->state == SPI_ACTIVE) && (spip->tcurrent != NULL)),
+                "invalid state");
+
+  /* Preparing all the transactions in the group.*/
+  last = stp;
+  while (true) {
+    osalDbgCheck((last->config != NULL) && (last->n > 0U));
+    osalDbgAssert((last->state == SPI_TRANSACTION_IDLE) ||
+                  (last->state == SPI_TRANSACTION_DONE),
+                  "already queued");
+
+    last->state = SPI_TRANSACTION_QUEUED;
+#if SPI_USE_WAIT == TRUE
+    last->thread = NULL;
+#endif
+    if ((last->flags & SPI_TRANSACTION_KEEP_SELECTED) == 0U) {
+      break;
+    }
+    last = last->next;
+  }
+
+  /* If a group is being executed then its remaining members are at the
+     queue head and cannot be preempted.*/
+  pp = &spip->tqueue;
+  if ((spip->tcurrent != NULL) &&
+      ((spip->tcurrent->flags & SPI_TRANSACTION_KEEP_SELECTED) != 0U)) {
+    while (((*pp)->flags & SPI_TRANSACTION_KEEP_SELECTED) != 0U) {
+      pp = &(*pp)->next;
+    }
+    pp = &(*pp)->next;
+  }
+
+  /* Priority ordered insertion, whole groups are skipped.*/
+  while ((*pp != NULL) && ((*pp)->prio >= stp->prio)) {
+    while (((*pp)->flags & SPI_TRANSACTION_KEEP_SELECTED) != 0U) {
+      pp = &(*pp)->next;
+    }
+    pp = &(*pp)->next;
+  }
+  last->next = *pp;
+  *pp = stp;
+
+  /* Starting immediately if the driver is idle.*/
+  if (spip->state == SPI_READY) {
+    spi_queue_start(spip);
+  }
+}
+
+/**
+ * @brief   Queues a transaction.
+ * @details The transaction is inserted in the driver queue after all the
+ *          pending transactions with higher or equal priority, it is
+ *          started immediately if the driver is idle.
+ * @note    See @p spiQueueTransactionI() for the details.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] stp       pointer to the first @p spi_transaction_t of the group
+ *
+ * @api
+ */
+void spiQueueTransaction(SPIDriver *spip, spi_transaction_t *stp) {
+
+  osalSysLock();
+  spiQueueTransactionI(spip, stp);
+  osalSysUnlock();
+}
+
+#if (SPI_USE_WAIT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Waits for a queued transaction to complete.
+ * @pre     In order to use this function the option @p SPI_USE_WAIT must be
+ *          enabled.
+ * @pre     Only one thread can wait for the same transaction.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ * @param[in] stp       pointer to the @p spi_transaction_t to be waited
+ *
+ * @api
+ */
+void spiWaitTransaction(SPIDriver *spip, spi_transaction_t *stp) {
+
+  osalDbgCheck((spip != NULL) && (stp != NULL));
+
+  osalSysLock();
+  osalDbgAssert(stp->state != SPI_TRANSACTION_IDLE, "not queued");
+  if (stp->state != SPI_TRANSACTION_DONE) {
+    (void) osalThreadSuspendS(&stp->thread);
+  }
+  osalSysUnlock();
+}
+#endif /* SPI_USE_WAIT == TRUE */
+
+/**
+ * @brief   Queued transaction completion handler.
+ * @details Ends the current transaction, invokes its callback and starts
+ *          the next transaction in the queue, if any.
+ * @note    If the transaction is not the last member of a group then the
+ *          driver stays active with @p tcurrent pointing to it until the
+ *          next member is started, this prevents other transactions from
+ *          being started while the CS line is asserted.
+ * @note    This function is meant to be invoked by @p _spi_isr_code() only.
+ *
+ * @param[in] spip      pointer to the @p SPIDriver object
+ *
+ * @notapi
+ */
+void _spi_queue_isr(SPIDriver *spip) {
+  spi_transaction_t *stp = spip->tcurrent;
+
+  osalSysLockFromISR();
+  if ((stp->flags & SPI_TRANSACTION_KEEP_SELECTED) == 0U) {
+    spiUnselectI(spip);
+    spip->tcurrent = NULL;
+    spip->state    = SPI_READY;
+  }
+  stp->state = SPI_TRANSACTION_DONE;
+#if SPI_USE_WAIT == TRUE
+  osalThreadResumeI(&stp->thread, MSG_OK);
+#endif
+  osalSysUnlockFromISR();
+
+  /* Transaction callback, it is invoked outside the critical zone like
+     the driver callback, the transaction can be queued again from here.*/
+  if (stp->end_cb != NULL) {
+    stp->end_cb(spip, stp);
+  }
+
+  osalSysLockFromISR();
+
+  /* Next transaction, it is the next member if a group is in progress
+     else the callback could have already started one.*/
+  if (spip->tcurrent == stp) {
+    spi_queue_start(spip);
+  }
+  else if ((spip->state == SPI_READY) && (spip->tqueue != NULL)) {
+    spi_queue_start(spip);
+  }
+  osalSysUnlockFromISR();
+}
+#endif /* SPI_USE_QUEUE == TRUE */
+
 #endif /* HAL_USE_SPI == TRUE */
 
 /** @} */
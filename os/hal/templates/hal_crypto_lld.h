@@ -49,6 +49,7 @@
 #define CRY_LLD_SUPPORTS_SHA512             TRUE
 #define CRY_LLD_SUPPORTS_HMAC_SHA256        TRUE
 #define CRY_LLD_SUPPORTS_HMAC_SHA512        TRUE
+#define CRY_LLD_SUPPORTS_QUEUE              FALSE
 /** @} */
 
 /*===========================================================================*/
@@ -107,6 +108,16 @@ struct CRYDriver {
    * @brief   Current configuration data.
    */
   const CRYConfig           *config;
+#if (HAL_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+  /**
+   * @brief   Queue of pending requests.
+   */
+  cry_request_t             *rqueue;
+  /**
+   * @brief   Request being executed or @p NULL.
+   */
+  cry_request_t             *rcurrent;
+#endif
 #if defined(CRY_DRIVER_EXT_FIELDS)
   CRY_DRIVER_EXT_FIELDS
 #endif
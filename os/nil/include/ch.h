@@ -322,7 +322,7 @@
 #error "at least one thread must be defined"
 #endif
 
-#if CH_CFG_MAX_THREADS > 16
+#if CH_CFG_MAX_THREADS > 64
 #error "ChibiOS/NIL is not recommended for thread-intensive applications,"  \
        "consider ChibiOS/RT instead"
 #endif
@@ -397,6 +397,19 @@ typedef uint16_t sysinterval_t;
 typedef uint32_t time_conv_t;
 #endif
 
+/**
+ * @brief   Type of a threads bitmap.
+ * @details Each thread is associated to a bit, the highest priority thread
+ *          is associated to the most significant bit so the highest
+ *          priority thread in a map is found by counting the leading zeros.
+ * @note    The idle thread is not represented in bitmaps.
+ */
+#if (CH_CFG_MAX_THREADS <= 32) || defined(__DOXYGEN__)
+typedef uint32_t nil_bitmap_t;
+#else
+typedef uint64_t nil_bitmap_t;
+#endif
+
 /**
  * @brief   Type of a structure representing the system.
  */
@@ -445,6 +458,7 @@ typedef threads_queue_t semaphore_t;
  */
 struct nil_threads_queue {
   volatile cnt_t    cnt;        /**< @brief Threads Queue counter.          */
+  nil_bitmap_t      waiters;    /**< @brief Map of the waiting threads.     */
 };
 
 /**
@@ -481,8 +495,9 @@ struct nil_thread {
     eventmask_t         ewmask;     /**< @brief Enabled events mask.        */
 #endif
   } u1;
-  volatile sysinterval_t timeout;   /**< @brief Timeout counter, zero
-                                                if disabled.                */
+  systime_t             wakeup;     /**< @brief Timeout time, only valid
+                                                if the thread is in the
+                                                timeouts map.               */
 #if (CH_CFG_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
   eventmask_t           epmask;     /**< @brief Pending events mask.        */
 #endif
@@ -512,6 +527,14 @@ struct nil_os_instance {
    *          or to an higher priority thread if a switch is required.
    */
   thread_t              *next;
+  /**
+   * @brief   Map of the ready threads.
+   */
+  nil_bitmap_t          ready;
+  /**
+   * @brief   Map of the threads waiting with a timeout.
+   */
+  nil_bitmap_t          timeouts;
 #if (CH_CFG_ST_TIMEDELTA == 0) || defined(__DOXYGEN__)
   /**
    * @brief   System time.
@@ -523,11 +546,14 @@ struct nil_os_instance {
    * @brief   System time of the last tick event.
    */
   systime_t             lasttime;
+#endif
   /**
-   * @brief   Time of the next scheduled tick event.
+   * @brief   Time of the next timeout event.
+   * @note    In tick mode it is only valid if there are threads in the
+   *          timeouts map, in tick-less mode it is the time of the next
+   *          scheduled tick event.
    */
   systime_t             nexttime;
-#endif
 #if (CH_DBG_SYSTEM_STATE_CHECK == TRUE) || defined(__DOXYGEN__)
   /**
    * @brief   ISR nesting level.
@@ -912,7 +938,7 @@ struct nil_os_instance {
  *
  * @param[in] name      the name of the threads queue variable
  */
-#define __THREADS_QUEUE_DATA(name) {(cnt_t)0}
+#define __THREADS_QUEUE_DATA(name) {(cnt_t)0, (nil_bitmap_t)0}
 
 /**
  * @brief   Static threads queue object initializer.
@@ -1174,7 +1200,10 @@ struct nil_os_instance {
  *
  * @init
  */
-#define chThdQueueObjectInit(tqp) ((tqp)->cnt = (cnt_t)0)
+#define chThdQueueObjectInit(tqp) do {                                      \
+  (tqp)->cnt = (cnt_t)0;                                                    \
+  (tqp)->waiters = (nil_bitmap_t)0;                                         \
+} while (false)
 
 /**
  * @brief   Evaluates to @p true if the specified queue is empty.
@@ -1340,7 +1369,7 @@ extern const thread_descriptor_t nil_thd_configs[];
 extern "C" {
 #endif
   thread_t *nil_find_thread(tstate_t state, void *p);
-  cnt_t nil_ready_all(void *p, cnt_t cnt, msg_t msg);
+  cnt_t nil_ready_all(threads_queue_t *tqp, cnt_t cnt, msg_t msg);
   void chSysInit(void);
   void chSysHalt(const char *reason);
   void chSysTimerHandlerI(void);
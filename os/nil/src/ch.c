@@ -31,6 +31,22 @@
 /* Module local definitions.                                                 */
 /*===========================================================================*/
 
+/**
+ * @brief   Number of bits in a threads bitmap.
+ */
+#define NIL_BITMAP_WIDTH        (sizeof (nil_bitmap_t) * 8U)
+
+/**
+ * @brief   Bitmap mask of the thread in the specified slot.
+ */
+#define NIL_SLOT_MASK(i)                                                    \
+  ((nil_bitmap_t)1 << (NIL_BITMAP_WIDTH - 1U - (unsigned)(i)))
+
+/**
+ * @brief   Bitmap mask of the specified thread.
+ */
+#define NIL_THD_MASK(tp)        NIL_SLOT_MASK((tp) - &nil.threads[0])
+
 /*===========================================================================*/
 /* Module exported variables.                                                */
 /*===========================================================================*/
@@ -48,6 +64,54 @@ os_instance_t nil;
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Returns the slot of the highest priority thread in a map.
+ * @note    On GCC-compatible compilers this is a count leading zeros
+ *          instruction on most architectures.
+ *
+ * @param[in] map       the threads map, must not be empty
+ * @return              The slot index.
+ */
+static inline unsigned bitmap_first(nil_bitmap_t map) {
+
+#if defined(__GNUC__)
+  if (sizeof (nil_bitmap_t) == sizeof (unsigned int)) {
+    return (unsigned)__builtin_clz((unsigned int)map);
+  }
+  if (sizeof (nil_bitmap_t) == sizeof (unsigned long)) {
+    return (unsigned)__builtin_clzl((unsigned long)map);
+  }
+  return (unsigned)__builtin_clzll((unsigned long long)map);
+#else
+  unsigned i = 0U;
+
+  while ((map & NIL_SLOT_MASK(i)) == (nil_bitmap_t)0) {
+    i++;
+  }
+  return i;
+#endif
+}
+
+/**
+ * @brief   Handles the timeout of a thread.
+ *
+ * @param[in] tp        the thread whose timeout expired
+ */
+static void thread_timeout(thread_t *tp) {
+
+  /* Timeout on thread queues requires a special handling because the
+     counter must be incremented.*/
+  if (NIL_THD_IS_WTQUEUE(tp)) {
+    tp->u1.tqp->cnt++;
+  }
+  else {
+    if (NIL_THD_IS_SUSPENDED(tp)) {
+      *tp->u1.trp = NULL;
+    }
+  }
+  (void) chSchReadyI(tp, MSG_TIMEOUT);
+}
+
 /*===========================================================================*/
 /* Module interrupt handlers.                                                */
 /*===========================================================================*/
@@ -81,10 +145,10 @@ thread_t *nil_find_thread(tstate_t state, void *p) {
 }
 
 /**
- * @brief   Puts in ready state all thread matching the specified status and
- *          associated object.
+ * @brief   Puts in ready state the threads waiting on a threads queue.
+ * @details Threads are readied in priority order.
  *
- * @param[in] p         object pointer
+ * @param[in] tqp       pointer to the threads queue object
  * @param[in] cnt       number of threads to be readied as a negative number,
  *                      non negative numbers are ignored
  * @param[in] msg       the wakeup message
@@ -92,20 +156,15 @@ thread_t *nil_find_thread(tstate_t state, void *p) {
  *
  * @notapi
  */
-cnt_t nil_ready_all(void *p, cnt_t cnt, msg_t msg) {
-  thread_t *tp = nil.threads;;
+cnt_t nil_ready_all(threads_queue_t *tqp, cnt_t cnt, msg_t msg) {
 
   while (cnt < (cnt_t)0) {
 
-    chDbgAssert(tp < &nil.threads[CH_CFG_MAX_THREADS],
-                "pointer out of range");
+    chDbgAssert(tqp->waiters != (nil_bitmap_t)0, "no waiting threads");
 
-    /* Is this thread waiting on this queue?*/
-    if ((tp->state == NIL_STATE_WTQUEUE) && (tp->u1.p == p)) {
-      cnt++;
-      (void) chSchReadyI(tp, msg);
-    }
-    tp++;
+    /* The waiters map bit is cleared by chSchReadyI().*/
+    cnt++;
+    (void) chSchReadyI(&nil.threads[bitmap_first(tqp->waiters)], msg);
   }
 
   return cnt;
@@ -158,7 +217,7 @@ void __dbg_check_lock(void) {
   if ((nil.isr_cnt != (cnt_t)0) || (nil.lock_cnt != (cnt_t)0)) {
     chSysHalt("SV#4");
   }
-  _dbg_enter_lock();
+  __dbg_enter_lock();
 }
 
 /**
@@ -171,7 +230,7 @@ void __dbg_check_unlock(void) {
   if ((nil.isr_cnt != (cnt_t)0) || (nil.lock_cnt <= (cnt_t)0)) {
     chSysHalt("SV#5");
   }
-  _dbg_leave_lock();
+  __dbg_leave_lock();
 }
 
 /**
@@ -184,7 +243,7 @@ void __dbg_check_lock_from_isr(void) {
   if ((nil.isr_cnt <= (cnt_t)0) || (nil.lock_cnt != (cnt_t)0)) {
     chSysHalt("SV#6");
   }
-  _dbg_enter_lock();
+  __dbg_enter_lock();
 }
 
 /**
@@ -197,7 +256,7 @@ void __dbg_check_unlock_from_isr(void) {
   if ((nil.isr_cnt <= (cnt_t)0) || (nil.lock_cnt <= (cnt_t)0)) {
     chSysHalt("SV#7");
   }
-  _dbg_leave_lock();
+  __dbg_leave_lock();
 }
 
 /**
@@ -357,84 +416,78 @@ void chSysTimerHandlerI(void) {
   chDbgCheckClassI();
 
 #if CH_CFG_ST_TIMEDELTA == 0
-  thread_t *tp = &nil.threads[0];
   nil.systime++;
-  do {
-    /* Is the thread in a wait state with timeout?.*/
-    if (tp->timeout > (sysinterval_t)0) {
+
+  /* Threads are visited only when the earliest timeout expires, all the
+     other ticks have a constant cost.*/
+  if ((nil.timeouts != (nil_bitmap_t)0) && (nil.systime == nil.nexttime)) {
+    nil_bitmap_t map = nil.timeouts;
+    sysinterval_t next = (sysinterval_t)0;
+
+    do {
+      unsigned i = bitmap_first(map);
+      thread_t *tp = &nil.threads[i];
 
       chDbgAssert(!NIL_THD_IS_READY(tp), "is ready");
 
-      /* Did the timer reach zero?*/
-      if (--tp->timeout == (sysinterval_t)0) {
-        /* Timeout on queues/semaphores requires a special handling because
-           the counter must be incremented.*/
-        /*lint -save -e9013 [15.7] There is no else because it is not needed.*/
-#if CH_CFG_USE_SEMAPHORES == TRUE
-        if (NIL_THD_IS_WTQUEUE(tp)) {
-          tp->u1.semp->cnt++;
-        }
-        else
-#endif
-        if (NIL_THD_IS_SUSPENDED(tp)) {
-          *tp->u1.trp = NULL;
+      map &= ~NIL_SLOT_MASK(i);
+      if (tp->wakeup == nil.systime) {
+        thread_timeout(tp);
+      }
+      else {
+        sysinterval_t timeout = chTimeDiffX(nil.systime, tp->wakeup);
+
+        if (timeout <= (sysinterval_t)(next - (sysinterval_t)1)) {
+          next = timeout;
         }
-        /*lint -restore*/
-        (void) chSchReadyI(tp, MSG_TIMEOUT);
       }
+
+      /* Lock released in order to give a preemption chance on those
+         architectures supporting IRQ preemption, threads readied in the
+         meanwhile are removed from the map.*/
+      chSysUnlockFromISR();
+      chSysLockFromISR();
+      map &= nil.timeouts;
+    } while (map != (nil_bitmap_t)0);
+
+    if (next > (sysinterval_t)0) {
+      nil.nexttime = chTimeAddX(nil.systime, next);
     }
-    /* Lock released in order to give a preemption chance on those
-       architectures supporting IRQ preemption.*/
-    chSysUnlockFromISR();
-    tp++;
-    chSysLockFromISR();
-  } while (tp < &nil.threads[CH_CFG_MAX_THREADS]);
+  }
 #else
-  thread_t *tp = &nil.threads[0];
+  nil_bitmap_t map = nil.timeouts;
   sysinterval_t next = (sysinterval_t)0;
+  sysinterval_t elapsed = chTimeDiffX(nil.lasttime, nil.nexttime);
 
   chDbgAssert(nil.nexttime == port_timer_get_alarm(), "time mismatch");
 
-  do {
-    sysinterval_t timeout = tp->timeout;
+  /* Only threads with an active timeout are visited.*/
+  while (map != (nil_bitmap_t)0) {
+    unsigned i = bitmap_first(map);
+    thread_t *tp = &nil.threads[i];
+    sysinterval_t timeout = chTimeDiffX(nil.lasttime, tp->wakeup);
 
-    /* Is the thread in a wait state with timeout?.*/
-    if (timeout > (sysinterval_t)0) {
+    chDbgAssert(!NIL_THD_IS_READY(tp), "is ready");
+    chDbgAssert(timeout >= elapsed, "skipped one");
 
-      chDbgAssert(!NIL_THD_IS_READY(tp), "is ready");
-      chDbgAssert(timeout >= chTimeDiffX(nil.lasttime, nil.nexttime),
-                  "skipped one");
-
-      /* The volatile field is updated once, here.*/
-      timeout -= chTimeDiffX(nil.lasttime, nil.nexttime);
-      tp->timeout = timeout;
-
-      if (timeout == (sysinterval_t)0) {
-        /* Timeout on thread queues requires a special handling because the
-           counter must be incremented.*/
-        if (NIL_THD_IS_WTQUEUE(tp)) {
-          tp->u1.tqp->cnt++;
-        }
-        else {
-          if (NIL_THD_IS_SUSPENDED(tp)) {
-            *tp->u1.trp = NULL;
-          }
-        }
-        (void) chSchReadyI(tp, MSG_TIMEOUT);
-      }
-      else {
-        if (timeout <= (sysinterval_t)(next - (sysinterval_t)1)) {
-          next = timeout;
-        }
+    map &= ~NIL_SLOT_MASK(i);
+    if (timeout == elapsed) {
+      thread_timeout(tp);
+    }
+    else {
+      timeout -= elapsed;
+      if (timeout <= (sysinterval_t)(next - (sysinterval_t)1)) {
+        next = timeout;
       }
     }
 
     /* Lock released in order to give a preemption chance on those
-       architectures supporting IRQ preemption.*/
+       architectures supporting IRQ preemption, threads readied in the
+       meanwhile are removed from the map.*/
     chSysUnlockFromISR();
-    tp++;
     chSysLockFromISR();
-  } while (tp < &nil.threads[CH_CFG_MAX_THREADS]);
+    map &= nil.timeouts;
+  }
 
   nil.lasttime = nil.nexttime;
   if (next > (sysinterval_t)0) {
@@ -585,9 +638,15 @@ thread_t *chSchReadyI(thread_t *tp, msg_t msg) {
   chDbgAssert(!NIL_THD_IS_READY(tp), "already ready");
   chDbgAssert(nil.next <= nil.current, "priority ordering");
 
+  /* Removing the thread from the maps of the waiting threads.*/
+  if (NIL_THD_IS_WTQUEUE(tp)) {
+    tp->u1.tqp->waiters &= ~NIL_THD_MASK(tp);
+  }
+  nil.timeouts &= ~NIL_THD_MASK(tp);
+  nil.ready |= NIL_THD_MASK(tp);
+
   tp->u1.msg = msg;
   tp->state = NIL_STATE_READY;
-  tp->timeout = (sysinterval_t)0;
   if (tp < nil.next) {
     nil.next = tp;
   }
@@ -670,6 +729,10 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
 
   /* Storing the wait object for the current thread.*/
   otp->state = newstate;
+  nil.ready &= ~NIL_THD_MASK(otp);
+  if (NIL_THD_IS_WTQUEUE(otp)) {
+    otp->u1.tqp->waiters |= NIL_THD_MASK(otp);
+  }
 
 #if CH_CFG_ST_TIMEDELTA > 0
   if (timeout != TIME_INFINITE) {
@@ -699,32 +762,42 @@ msg_t chSchGoSleepTimeoutS(tstate_t newstate, sysinterval_t timeout) {
     }
 
     /* Timeout settings.*/
-    otp->timeout = abstime - nil.lasttime;
+    otp->wakeup = abstime;
+    nil.timeouts |= NIL_THD_MASK(otp);
   }
 #else
+  if (timeout != TIME_INFINITE) {
+    systime_t abstime = chTimeAddX(nil.systime, timeout);
 
-  /* Timeout settings.*/
-  otp->timeout = timeout;
-#endif
-
-  /* Scanning the whole threads array.*/
-  ntp = nil.threads;
-  while (true) {
-    /* Is this thread ready to execute?*/
-    if (NIL_THD_IS_READY(ntp)) {
-      nil.current = nil.next = ntp;
-      if (ntp == &nil.threads[CH_CFG_MAX_THREADS]) {
-        CH_CFG_IDLE_ENTER_HOOK();
-      }
-      port_switch(ntp, otp);
-      return nil.current->u1.msg;
+    /* The earliest timeout is cached so that the tick handler has nothing
+       to do until it expires.*/
+    if ((nil.timeouts == (nil_bitmap_t)0) ||
+        (chTimeDiffX(nil.systime, abstime) <
+         chTimeDiffX(nil.systime, nil.nexttime))) {
+      nil.nexttime = abstime;
     }
 
-    /* Points to the next thread in lowering priority order.*/
-    ntp++;
-    chDbgAssert(ntp <= &nil.threads[CH_CFG_MAX_THREADS],
-                "pointer out of range");
+    /* Timeout settings.*/
+    otp->wakeup = abstime;
+    nil.timeouts |= NIL_THD_MASK(otp);
   }
+#endif
+
+  /* The highest priority ready thread is found in the ready map, the idle
+     thread is not in the map because it is always ready.*/
+  if (nil.ready != (nil_bitmap_t)0) {
+    ntp = &nil.threads[bitmap_first(nil.ready)];
+  }
+  else {
+    ntp = &nil.threads[CH_CFG_MAX_THREADS];
+    CH_CFG_IDLE_ENTER_HOOK();
+  }
+
+  chDbgAssert(NIL_THD_IS_READY(ntp), "not ready");
+
+  nil.current = nil.next = ntp;
+  port_switch(ntp, otp);
+  return nil.current->u1.msg;
 }
 
 /**
@@ -1034,11 +1107,12 @@ void chThdDoDequeueNextI(threads_queue_t *tqp, msg_t msg) {
 
   chDbgAssert(tqp->cnt < (cnt_t)0, "empty queue");
 
-  tqp->cnt++;
-  tp = nil_find_thread(NIL_STATE_WTQUEUE, (void *)tqp);
-
-  chDbgAssert(tp != NULL, "thread not found");
+  chDbgAssert(tqp->waiters != (nil_bitmap_t)0, "no waiting threads");
 
+  /* The highest priority waiting thread is dequeued, the waiters map bit
+     is cleared by chSchReadyI().*/
+  tqp->cnt++;
+  tp = &nil.threads[bitmap_first(tqp->waiters)];
   (void) chSchReadyI(tp, msg);
 }
 
@@ -1074,7 +1148,7 @@ void chThdDequeueAllI(threads_queue_t *tqp, msg_t msg) {
   chDbgCheckClassI();
   chDbgCheck(tqp != NULL);
 
-  tqp->cnt = nil_ready_all((void *)tqp, tqp->cnt, msg);
+  tqp->cnt = nil_ready_all(tqp, tqp->cnt, msg);
 }
 
 /** @} */
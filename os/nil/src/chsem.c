@@ -155,12 +155,11 @@ void chSemSignalI(semaphore_t *sp) {
   chDbgCheckClassI();
   chDbgCheck(sp != NULL);
 
-  if (++sp->cnt <= (cnt_t)0) {
-    thread_t *tp = nil_find_thread(NIL_STATE_WTQUEUE, (void *)sp);
-
-    chDbgAssert(tp != NULL, "thread not found");
-
-    (void) chSchReadyI(tp, MSG_OK);
+  if (sp->cnt < (cnt_t)0) {
+    chThdDoDequeueNextI(sp, MSG_OK);
+  }
+  else {
+    sp->cnt++;
   }
 }
 
@@ -216,7 +215,7 @@ void chSemResetWithMessageI(semaphore_t *sp, cnt_t n, msg_t msg) {
   sp->cnt = n;
 
   /* Does nothing for cnt >= 0, calling anyway.*/
-  (void) nil_ready_all((void *)sp, cnt, msg);
+  (void) nil_ready_all(sp, cnt, msg);
 }
 
 #endif /* CH_CFG_USE_SEMAPHORES == TRUE */
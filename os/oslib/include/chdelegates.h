@@ -84,6 +84,62 @@ typedef msg_t (*delegate_fn3_t)(msg_t p1, msg_t p2, msg_t p3);
  */
 typedef msg_t (*delegate_fn4_t)(msg_t p1, msg_t p2, msg_t p3, msg_t p4);
 
+/**
+ * @brief   Type of a delegate future.
+ * @details A future receives the return value of an asynchronous call,
+ *          a thread can wait for its completion.
+ */
+typedef struct ch_delegate_future {
+  thread_reference_t    thread;         /**< @brief Waiting thread.         */
+  msg_t                 result;         /**< @brief Function return value.  */
+  bool                  done;           /**< @brief Call completed.         */
+} delegate_future_t;
+
+/**
+ * @brief   Type of an asynchronous call descriptor.
+ */
+typedef struct ch_delegate_call {
+  /**
+   * @brief   Function to be called, the member is selected by @p argc.
+   */
+  union {
+    delegate_fn0_t      fn0;
+    delegate_fn1_t      fn1;
+    delegate_fn2_t      fn2;
+    delegate_fn3_t      fn3;
+    delegate_fn4_t      fn4;
+  } func;
+  /**
+   * @brief   Number of parameters, from zero to four.
+   */
+  unsigned              argc;
+  /**
+   * @brief   Parameters.
+   */
+  msg_t                 argv[4];
+  /**
+   * @brief   Future receiving the result or @p NULL.
+   */
+  delegate_future_t     *future;
+} delegate_call_t;
+
+/**
+ * @brief   Type of a delegate calls queue.
+ * @details Asynchronous calls are copied into a ring of descriptors, the
+ *          delegate thread executes them in batches.
+ */
+typedef struct ch_delegate_queue {
+  delegate_call_t       *buffer;        /**< @brief Pointer to the calls
+                                                    buffer.                 */
+  delegate_call_t       *top;           /**< @brief Pointer to the location
+                                                    after the buffer.       */
+  delegate_call_t       *wrptr;         /**< @brief Write pointer.          */
+  delegate_call_t       *rdptr;         /**< @brief Read pointer.           */
+  size_t                cnt;            /**< @brief Calls in queue.         */
+  threads_queue_t       qw;             /**< @brief Queued posters.         */
+  threads_queue_t       qr;             /**< @brief Queued dispatcher.      */
+} delegate_queue_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -103,6 +159,20 @@ extern "C" {
   void chDelegateDispatch(void);
   msg_t chDelegateDispatchTimeout(sysinterval_t timeout);
   msg_t chDelegateCallVeneer(thread_t *tp, delegate_veneer_t veneer, ...);
+  void chDelegateQueueObjectInit(delegate_queue_t *dqp,
+                                 delegate_call_t *buf, size_t n);
+  msg_t chDelegatePostTimeout(delegate_queue_t *dqp,
+                              const delegate_call_t *dcp,
+                              sysinterval_t timeout);
+  msg_t chDelegatePostTimeoutS(delegate_queue_t *dqp,
+                               const delegate_call_t *dcp,
+                               sysinterval_t timeout);
+  msg_t chDelegatePostI(delegate_queue_t *dqp, const delegate_call_t *dcp);
+  void chDelegateDispatchQueue(delegate_queue_t *dqp);
+  msg_t chDelegateDispatchQueueTimeout(delegate_queue_t *dqp,
+                                       sysinterval_t timeout);
+  msg_t chDelegateFutureWaitTimeout(delegate_future_t *dfp,
+                                    sysinterval_t timeout);
 #ifdef __cplusplus
 }
 #endif
@@ -201,6 +271,225 @@ static inline msg_t chDelegateCallDirect4(thread_t *tp, delegate_fn4_t func,
   return chDelegateCallVeneer(tp, __ch_delegate_fn4, func, p1, p2, p3, p4);
 }
 
+/**
+ * @brief   Returns the number of calls in a delegate calls queue.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t object
+ * @return              The number of queued calls.
+ *
+ * @iclass
+ */
+static inline size_t chDelegateGetUsedCountI(const delegate_queue_t *dqp) {
+
+  chDbgCheckClassI();
+
+  return dqp->cnt;
+}
+
+/**
+ * @brief   Returns the number of free slots in a delegate calls queue.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t object
+ * @return              The number of free call slots.
+ *
+ * @iclass
+ */
+static inline size_t chDelegateGetFreeCountI(const delegate_queue_t *dqp) {
+
+  chDbgCheckClassI();
+
+  return (size_t)(dqp->top - dqp->buffer) - dqp->cnt;
+}
+
+/**
+ * @brief   Returns the completion state of a future.
+ *
+ * @param[in] dfp       pointer to a @p delegate_future_t object
+ * @return              The completion state.
+ * @retval true         if the call has been executed.
+ * @retval false        if the call is still pending.
+ *
+ * @xclass
+ */
+static inline bool chDelegateFutureIsDoneX(const delegate_future_t *dfp) {
+
+  return dfp->done;
+}
+
+/**
+ * @brief   Returns the result stored in a completed future.
+ * @pre     The future must be completed.
+ *
+ * @param[in] dfp       pointer to a @p delegate_future_t object
+ * @return              The function return value as a @p msg_t.
+ *
+ * @xclass
+ */
+static inline msg_t chDelegateFutureGetResultX(const delegate_future_t *dfp) {
+
+  return dfp->result;
+}
+
+/**
+ * @brief   Waits for the completion of a future.
+ *
+ * @param[in] dfp       pointer to a @p delegate_future_t object
+ * @return              The function return value as a @p msg_t.
+ *
+ * @api
+ */
+static inline msg_t chDelegateFutureWait(delegate_future_t *dfp) {
+
+  (void) chDelegateFutureWaitTimeout(dfp, TIME_INFINITE);
+
+  return dfp->result;
+}
+
+/**
+ * @brief   Asynchronous call to a function with no parameters.
+ * @note    The function returns as soon as the call has been queued.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t object
+ * @param[out] dfp      pointer to a future receiving the result or @p NULL
+ * @param[in] func      pointer to the function to be called
+ * @return              The operation status.
+ * @retval MSG_OK       if the call has been queued.
+ *
+ * @api
+ */
+static inline msg_t chDelegateCallAsync0(delegate_queue_t *dqp,
+                                         delegate_future_t *dfp,
+                                         delegate_fn0_t func) {
+  delegate_call_t dc;
+
+  dc.func.fn0 = func;
+  dc.argc     = 0U;
+  dc.future   = dfp;
+
+  return chDelegatePostTimeout(dqp, &dc, TIME_INFINITE);
+}
+
+/**
+ * @brief   Asynchronous call to a function with one parameter.
+ * @note    The function returns as soon as the call has been queued.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t object
+ * @param[out] dfp      pointer to a future receiving the result or @p NULL
+ * @param[in] func      pointer to the function to be called
+ * @param[in] p1        parameter 1 passed as a @p msg_t
+ * @return              The operation status.
+ * @retval MSG_OK       if the call has been queued.
+ *
+ * @api
+ */
+static inline msg_t chDelegateCallAsync1(delegate_queue_t *dqp,
+                                         delegate_future_t *dfp,
+                                         delegate_fn1_t func,
+                                         msg_t p1) {
+  delegate_call_t dc;
+
+  dc.func.fn1 = func;
+  dc.argc     = 1U;
+  dc.argv[0]  = p1;
+  dc.future   = dfp;
+
+  return chDelegatePostTimeout(dqp, &dc, TIME_INFINITE);
+}
+
+/**
+ * @brief   Asynchronous call to a function with two parameters.
+ * @note    The function returns as soon as the call has been queued.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t object
+ * @param[out] dfp      pointer to a future receiving the result or @p NULL
+ * @param[in] func      pointer to the function to be called
+ * @param[in] p1        parameter 1 passed as a @p msg_t
+ * @param[in] p2        parameter 2 passed as a @p msg_t
+ * @return              The operation status.
+ * @retval MSG_OK       if the call has been queued.
+ *
+ * @api
+ */
+static inline msg_t chDelegateCallAsync2(delegate_queue_t *dqp,
+                                         delegate_future_t *dfp,
+                                         delegate_fn2_t func,
+                                         msg_t p1, msg_t p2) {
+  delegate_call_t dc;
+
+  dc.func.fn2 = func;
+  dc.argc     = 2U;
+  dc.argv[0]  = p1;
+  dc.argv[1]  = p2;
+  dc.future   = dfp;
+
+  return chDelegatePostTimeout(dqp, &dc, TIME_INFINITE);
+}
+
+/**
+ * @brief   Asynchronous call to a function with three parameters.
+ * @note    The function returns as soon as the call has been queued.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t object
+ * @param[out] dfp      pointer to a future receiving the result or @p NULL
+ * @param[in] func      pointer to the function to be called
+ * @param[in] p1        parameter 1 passed as a @p msg_t
+ * @param[in] p2        parameter 2 passed as a @p msg_t
+ * @param[in] p3        parameter 3 passed as a @p msg_t
+ * @return              The operation status.
+ * @retval MSG_OK       if the call has been queued.
+ *
+ * @api
+ */
+static inline msg_t chDelegateCallAsync3(delegate_queue_t *dqp,
+                                         delegate_future_t *dfp,
+                                         delegate_fn3_t func,
+                                         msg_t p1, msg_t p2, msg_t p3) {
+  delegate_call_t dc;
+
+  dc.func.fn3 = func;
+  dc.argc     = 3U;
+  dc.argv[0]  = p1;
+  dc.argv[1]  = p2;
+  dc.argv[2]  = p3;
+  dc.future   = dfp;
+
+  return chDelegatePostTimeout(dqp, &dc, TIME_INFINITE);
+}
+
+/**
+ * @brief   Asynchronous call to a function with four parameters.
+ * @note    The function returns as soon as the call has been queued.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t object
+ * @param[out] dfp      pointer to a future receiving the result or @p NULL
+ * @param[in] func      pointer to the function to be called
+ * @param[in] p1        parameter 1 passed as a @p msg_t
+ * @param[in] p2        parameter 2 passed as a @p msg_t
+ * @param[in] p3        parameter 3 passed as a @p msg_t
+ * @param[in] p4        parameter 4 passed as a @p msg_t
+ * @return              The operation status.
+ * @retval MSG_OK       if the call has been queued.
+ *
+ * @api
+ */
+static inline msg_t chDelegateCallAsync4(delegate_queue_t *dqp,
+                                         delegate_future_t *dfp,
+                                         delegate_fn4_t func,
+                                         msg_t p1, msg_t p2, msg_t p3,
+                                         msg_t p4) {
+  delegate_call_t dc;
+
+  dc.func.fn4 = func;
+  dc.argc     = 4U;
+  dc.argv[0]  = p1;
+  dc.argv[1]  = p2;
+  dc.argv[2]  = p3;
+  dc.argv[3]  = p4;
+  dc.future   = dfp;
+
+  return chDelegatePostTimeout(dqp, &dc, TIME_INFINITE);
+}
+
 #endif /* CH_CFG_USE_DELEGATES == TRUE */
 
 #endif /* CHDELEGATES_H */
@@ -47,6 +47,17 @@
 #define CH_CFG_FACTORY_MAX_NAMES_LENGTH     8
 #endif
 
+/**
+ * @brief   Size of the names hash index of each objects list.
+ * @details If not zero then each list of the factory is indexed by an
+ *          open addressing hash table of the specified size, objects
+ *          not fitting the table are still found by a linear search.
+ * @note    Must be zero or a power of two.
+ */
+#if !defined(CH_CFG_FACTORY_HASH_SIZE) || defined(__DOXYGEN__)
+#define CH_CFG_FACTORY_HASH_SIZE            0
+#endif
+
 /**
  * @brief   Enables the registry of generic objects.
  */
@@ -143,6 +154,11 @@
 #error "invalid CH_CFG_FACTORY_MAX_NAMES_LENGTH value"
 #endif
 
+#if (CH_CFG_FACTORY_HASH_SIZE < 0) ||                                       \
+    ((CH_CFG_FACTORY_HASH_SIZE & (CH_CFG_FACTORY_HASH_SIZE - 1)) != 0)
+#error "invalid CH_CFG_FACTORY_HASH_SIZE value"
+#endif
+
 #if (CH_CFG_USE_MUTEXES == FALSE) && (CH_CFG_USE_SEMAPHORES == FALSE)
 #error "CH_CFG_USE_FACTORY requires CH_CFG_USE_MUTEXES and/or CH_CFG_USE_SEMAPHORES"
 #endif
@@ -187,6 +203,16 @@ typedef struct ch_dyn_element {
  */
 typedef struct ch_dyn_list {
     dyn_element_t       *next;
+#if (CH_CFG_FACTORY_HASH_SIZE > 0) || defined(__DOXYGEN__)
+    /**
+     * @brief   Names hash index.
+     */
+    dyn_element_t       *index[CH_CFG_FACTORY_HASH_SIZE];
+    /**
+     * @brief   Number of objects not present in the index.
+     */
+    ucnt_t              unindexed;
+#endif
 } dyn_list_t;
 
 #if (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) || defined(__DOXYGEN__)
@@ -454,6 +480,37 @@ static inline uint8_t *chFactoryGetBuffer(dyn_buffer_t *dbp) {
 
   return (uint8_t *)(dbp + 1);
 }
+
+/**
+ * @brief   Opens a dynamic buffer by name.
+ * @details The name is resolved once and a reference is taken, the
+ *          returned pointer can be used directly until it is closed
+ *          using @p chFactoryCloseBuffer().
+ *
+ * @param[in] name      name of the dynamic buffer object
+ * @return              The pointer to the dynamic buffer.
+ * @retval NULL         if a dynamic buffer object with the specified
+ *                      name does not exist.
+ *
+ * @api
+ */
+static inline uint8_t *chFactoryOpenBuffer(const char *name) {
+  dyn_buffer_t *dbp = chFactoryFindBuffer(name);
+
+  return dbp != NULL ? chFactoryGetBuffer(dbp) : NULL;
+}
+
+/**
+ * @brief   Closes a dynamic buffer opened by @p chFactoryOpenBuffer().
+ *
+ * @param[in] bp        pointer to the dynamic buffer
+ *
+ * @api
+ */
+static inline void chFactoryCloseBuffer(uint8_t *bp) {
+
+  chFactoryReleaseBuffer((dyn_buffer_t *)(void *)bp - 1);
+}
 #endif /* CH_CFG_FACTORY_GENERIC_BUFFERS == TRUE */
 
 #if (CH_CFG_FACTORY_SEMAPHORES == TRUE) || defined(__DOXYGEN__)
@@ -469,6 +526,38 @@ static inline semaphore_t *chFactoryGetSemaphore(dyn_semaphore_t *dsp) {
 
   return &dsp->sem;
 }
+
+/**
+ * @brief   Opens a dynamic semaphore by name.
+ * @details The name is resolved once and a reference is taken, the
+ *          returned pointer can be used directly until it is closed
+ *          using @p chFactoryCloseSemaphore().
+ *
+ * @param[in] name      name of the dynamic semaphore object
+ * @return              The pointer to the semaphore.
+ * @retval NULL         if a dynamic semaphore object with the specified
+ *                      name does not exist.
+ *
+ * @api
+ */
+static inline semaphore_t *chFactoryOpenSemaphore(const char *name) {
+  dyn_semaphore_t *dsp = chFactoryFindSemaphore(name);
+
+  return dsp != NULL ? chFactoryGetSemaphore(dsp) : NULL;
+}
+
+/**
+ * @brief   Closes a semaphore opened by @p chFactoryOpenSemaphore().
+ *
+ * @param[in] sp        pointer to the semaphore
+ *
+ * @api
+ */
+static inline void chFactoryCloseSemaphore(semaphore_t *sp) {
+  uint8_t *p = (uint8_t *)sp - offsetof(dyn_semaphore_t, sem);
+
+  chFactoryReleaseSemaphore((dyn_semaphore_t *)(void *)p);
+}
 #endif /* CH_CFG_FACTORY_SEMAPHORES == TRUE */
 
 #if (CH_CFG_FACTORY_MAILBOXES == TRUE) || defined(__DOXYGEN__)
@@ -484,6 +573,38 @@ static inline mailbox_t *chFactoryGetMailbox(dyn_mailbox_t *dmp) {
 
   return &dmp->mbx;
 }
+
+/**
+ * @brief   Opens a dynamic mailbox by name.
+ * @details The name is resolved once and a reference is taken, the
+ *          returned pointer can be used directly until it is closed
+ *          using @p chFactoryCloseMailbox().
+ *
+ * @param[in] name      name of the dynamic mailbox object
+ * @return              The pointer to the mailbox.
+ * @retval NULL         if a dynamic mailbox object with the specified
+ *                      name does not exist.
+ *
+ * @api
+ */
+static inline mailbox_t *chFactoryOpenMailbox(const char *name) {
+  dyn_mailbox_t *dmp = chFactoryFindMailbox(name);
+
+  return dmp != NULL ? chFactoryGetMailbox(dmp) : NULL;
+}
+
+/**
+ * @brief   Closes a mailbox opened by @p chFactoryOpenMailbox().
+ *
+ * @param[in] mbp       pointer to the mailbox
+ *
+ * @api
+ */
+static inline void chFactoryCloseMailbox(mailbox_t *mbp) {
+  uint8_t *p = (uint8_t *)mbp - offsetof(dyn_mailbox_t, mbx);
+
+  chFactoryReleaseMailbox((dyn_mailbox_t *)(void *)p);
+}
 #endif /* CH_CFG_FACTORY_MAILBOXES == TRUE */
 
 #if (CH_CFG_FACTORY_OBJ_FIFOS == TRUE) || defined(__DOXYGEN__)
@@ -499,6 +620,38 @@ static inline objects_fifo_t *chFactoryGetObjectsFIFO(dyn_objects_fifo_t *dofp)
 
   return &dofp->fifo;
 }
+
+/**
+ * @brief   Opens a dynamic "objects FIFO" by name.
+ * @details The name is resolved once and a reference is taken, the
+ *          returned pointer can be used directly until it is closed
+ *          using @p chFactoryCloseObjectsFIFO().
+ *
+ * @param[in] name      name of the dynamic "objects FIFO" object
+ * @return              The pointer to the objects FIFO.
+ * @retval NULL         if a dynamic "objects FIFO" object with the specified
+ *                      name does not exist.
+ *
+ * @api
+ */
+static inline objects_fifo_t *chFactoryOpenObjectsFIFO(const char *name) {
+  dyn_objects_fifo_t *dofp = chFactoryFindObjectsFIFO(name);
+
+  return dofp != NULL ? chFactoryGetObjectsFIFO(dofp) : NULL;
+}
+
+/**
+ * @brief   Closes a objects FIFO opened by @p chFactoryOpenObjectsFIFO().
+ *
+ * @param[in] ofp       pointer to the objects FIFO
+ *
+ * @api
+ */
+static inline void chFactoryCloseObjectsFIFO(objects_fifo_t *ofp) {
+  uint8_t *p = (uint8_t *)ofp - offsetof(dyn_objects_fifo_t, fifo);
+
+  chFactoryReleaseObjectsFIFO((dyn_objects_fifo_t *)(void *)p);
+}
 #endif /* CH_CFG_FACTORY_OBJ_FIFOS == TRUE */
 
 #if (CH_CFG_FACTORY_PIPES == TRUE) || defined(__DOXYGEN__)
@@ -514,6 +667,38 @@ static inline pipe_t *chFactoryGetPipe(dyn_pipe_t *dpp) {
 
   return &dpp->pipe;
 }
+
+/**
+ * @brief   Opens a dynamic pipe by name.
+ * @details The name is resolved once and a reference is taken, the
+ *          returned pointer can be used directly until it is closed
+ *          using @p chFactoryClosePipe().
+ *
+ * @param[in] name      name of the dynamic pipe object
+ * @return              The pointer to the pipe.
+ * @retval NULL         if a dynamic pipe object with the specified
+ *                      name does not exist.
+ *
+ * @api
+ */
+static inline pipe_t *chFactoryOpenPipe(const char *name) {
+  dyn_pipe_t *dpp = chFactoryFindPipe(name);
+
+  return dpp != NULL ? chFactoryGetPipe(dpp) : NULL;
+}
+
+/**
+ * @brief   Closes a pipe opened by @p chFactoryOpenPipe().
+ *
+ * @param[in] pp        pointer to the pipe
+ *
+ * @api
+ */
+static inline void chFactoryClosePipe(pipe_t *pp) {
+  uint8_t *p = (uint8_t *)pp - offsetof(dyn_pipe_t, pipe);
+
+  chFactoryReleasePipe((dyn_pipe_t *)(void *)p);
+}
 #endif /* CH_CFG_FACTORY_PIPES == TRUE */
 
 #endif /* CH_CFG_USE_FACTORY == TRUE */
@@ -129,6 +129,10 @@
 #error "CH_CFG_FACTORY_MAX_NAMES_LENGTH not defined in chconf.h"
 #endif
 
+#if !defined(CH_CFG_FACTORY_HASH_SIZE)
+#error "CH_CFG_FACTORY_HASH_SIZE not defined in chconf.h"
+#endif
+
 #if !defined(CH_CFG_FACTORY_OBJECTS_REGISTRY)
 #error "CH_CFG_FACTORY_OBJECTS_REGISTRY not defined in chconf.h"
 #endif
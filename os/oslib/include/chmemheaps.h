@@ -126,6 +126,7 @@ extern "C" {
   void chHeapObjectInit(memory_heap_t *heapp, void *buf, size_t size);
   void *chHeapAllocAligned(memory_heap_t *heapp, size_t size, unsigned align);
   void chHeapFree(void *p);
+  void *chHeapRealloc(void *p, size_t size);
   size_t chHeapStatus(memory_heap_t *heapp, size_t *totalp, size_t *largestp);
 #ifdef __cplusplus
 }
@@ -27,6 +27,12 @@
  *          encapsulating a library not designed for threading into a
  *          delegate thread. Other threads have access to the library without
  *          having to worry about mutual exclusion.
+ *          <h2>Asynchronous calls</h2>
+ *          Calls can also be posted into a delegate calls queue, the
+ *          caller does not wait for the function execution and the
+ *          delegate thread executes all the queued calls in a single
+ *          batch. Calls needing a result can be associated to a future
+ *          object the caller can wait on.
  * @pre     In order to use the pipes APIs the @p CH_CFG_USE_DELEGATES
  *          option must be enabled in @p chconf.h.
  * @note    Compatible with RT and NIL.
@@ -73,6 +79,62 @@ typedef struct {
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+/**
+ * @brief   Executes an asynchronous call.
+ *
+ * @param[in] dcp       pointer to the call descriptor
+ * @return              The function return value.
+ */
+static msg_t delegate_execute(const delegate_call_t *dcp) {
+  msg_t msg;
+
+  switch (dcp->argc) {
+  case 0U:
+    msg = dcp->func.fn0();
+    break;
+  case 1U:
+    msg = dcp->func.fn1(dcp->argv[0]);
+    break;
+  case 2U:
+    msg = dcp->func.fn2(dcp->argv[0], dcp->argv[1]);
+    break;
+  case 3U:
+    msg = dcp->func.fn3(dcp->argv[0], dcp->argv[1], dcp->argv[2]);
+    break;
+  default:
+    msg = dcp->func.fn4(dcp->argv[0], dcp->argv[1], dcp->argv[2],
+                        dcp->argv[3]);
+    break;
+  }
+
+  return msg;
+}
+
+/**
+ * @brief   Copies a call descriptor into a calls queue.
+ * @pre     There must be a free slot in the queue.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t object
+ * @param[in] dcp       pointer to the call descriptor
+ */
+static void delegate_enqueue(delegate_queue_t *dqp,
+                             const delegate_call_t *dcp) {
+
+  if (dcp->future != NULL) {
+    dcp->future->thread = NULL;
+    dcp->future->done   = false;
+  }
+
+  *dqp->wrptr++ = *dcp;
+  if (dqp->wrptr >= dqp->top) {
+    dqp->wrptr = dqp->buffer;
+  }
+  dqp->cnt++;
+
+  /* If the dispatcher is waiting then makes it ready.*/
+  chThdDequeueNextI(&dqp->qr, MSG_OK);
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -234,6 +296,250 @@ msg_t chDelegateDispatchTimeout(sysinterval_t timeout) {
   return MSG_OK;
 }
 
+/**
+ * @brief   Initializes a @p delegate_queue_t object.
+ *
+ * @param[out] dqp      pointer to a @p delegate_queue_t object
+ * @param[in] buf       pointer to the calls buffer array of
+ *                      @p delegate_call_t
+ * @param[in] n         number of elements in the buffer array
+ *
+ * @init
+ */
+void chDelegateQueueObjectInit(delegate_queue_t *dqp,
+                               delegate_call_t *buf, size_t n) {
+
+  chDbgCheck((dqp != NULL) && (buf != NULL) && (n > (size_t)0));
+
+  dqp->buffer = buf;
+  dqp->rdptr  = buf;
+  dqp->wrptr  = buf;
+  dqp->top    = &buf[n];
+  dqp->cnt    = (size_t)0;
+  chThdQueueObjectInit(&dqp->qw);
+  chThdQueueObjectInit(&dqp->qr);
+}
+
+/**
+ * @brief   Posts an asynchronous call into a delegate calls queue.
+ * @details The descriptor is copied into the queue, if the queue is full
+ *          then the calling thread waits for a slot to become available
+ *          or for the timeout to expire.
+ * @note    If a future is specified then it is prepared by this function,
+ *          it must remain valid until the call has been executed.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t object
+ * @param[in] dcp       pointer to the call descriptor
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the call has been queued.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chDelegatePostTimeout(delegate_queue_t *dqp,
+                            const delegate_call_t *dcp,
+                            sysinterval_t timeout) {
+  msg_t msg;
+
+  chSysLock();
+  msg = chDelegatePostTimeoutS(dqp, dcp, timeout);
+  chSysUnlock();
+
+  return msg;
+}
+
+/**
+ * @brief   Posts an asynchronous call into a delegate calls queue.
+ * @details The descriptor is copied into the queue, if the queue is full
+ *          then the calling thread waits for a slot to become available
+ *          or for the timeout to expire.
+ * @note    If a future is specified then it is prepared by this function,
+ *          it must remain valid until the call has been executed.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t object
+ * @param[in] dcp       pointer to the call descriptor
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the call has been queued.
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @sclass
+ */
+msg_t chDelegatePostTimeoutS(delegate_queue_t *dqp,
+                             const delegate_call_t *dcp,
+                             sysinterval_t timeout) {
+  msg_t rdymsg;
+
+  chDbgCheckClassS();
+  chDbgCheck((dqp != NULL) && (dcp != NULL) && (dcp->argc <= 4U));
+
+  do {
+    /* Is there a free slot in queue? if so then post.*/
+    if (chDelegateGetFreeCountI(dqp) > (size_t)0) {
+      delegate_enqueue(dqp, dcp);
+      chSchRescheduleS();
+
+      return MSG_OK;
+    }
+
+    /* No space in the queue, waiting for a slot to become available.*/
+    rdymsg = chThdEnqueueTimeoutS(&dqp->qw, timeout);
+  } while (rdymsg == MSG_OK);
+
+  return rdymsg;
+}
+
+/**
+ * @brief   Posts an asynchronous call into a delegate calls queue.
+ * @details This variant is non-blocking, the function returns a timeout
+ *          condition if the queue is full.
+ * @note    If a future is specified then it is prepared by this function,
+ *          it must remain valid until the call has been executed.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t object
+ * @param[in] dcp       pointer to the call descriptor
+ * @return              The operation status.
+ * @retval MSG_OK       if the call has been queued.
+ * @retval MSG_TIMEOUT  if the queue is full.
+ *
+ * @iclass
+ */
+msg_t chDelegatePostI(delegate_queue_t *dqp, const delegate_call_t *dcp) {
+
+  chDbgCheckClassI();
+  chDbgCheck((dqp != NULL) && (dcp != NULL) && (dcp->argc <= 4U));
+
+  /* Is there a free slot in queue? if so then post.*/
+  if (chDelegateGetFreeCountI(dqp) > (size_t)0) {
+    delegate_enqueue(dqp, dcp);
+
+    return MSG_OK;
+  }
+
+  /* No space, immediate timeout.*/
+  return MSG_TIMEOUT;
+}
+
+/**
+ * @brief   Calls queue dispatching.
+ * @details The function awaits for queued calls then executes all of
+ *          them, including calls posted during the execution, then it
+ *          returns.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t object
+ *
+ * @api
+ */
+void chDelegateDispatchQueue(delegate_queue_t *dqp) {
+
+  (void) chDelegateDispatchQueueTimeout(dqp, TIME_INFINITE);
+}
+
+/**
+ * @brief   Calls queue dispatching with timeout.
+ * @details The function awaits for queued calls then executes all of
+ *          them, including calls posted during the execution, then it
+ *          returns. Calls are executed in posting order, futures are
+ *          completed after each call.
+ *
+ * @param[in] dqp       pointer to a @p delegate_queue_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The function outcome.
+ * @retval MSG_OK       if at least a function has been called.
+ * @retval MSG_TIMEOUT  if a timeout occurred.
+ *
+ * @api
+ */
+msg_t chDelegateDispatchQueueTimeout(delegate_queue_t *dqp,
+                                     sysinterval_t timeout) {
+  msg_t msg;
+
+  chDbgCheck(dqp != NULL);
+
+  chSysLock();
+
+  /* Waiting for the first call of the batch.*/
+  while (dqp->cnt == (size_t)0) {
+    msg = chThdEnqueueTimeoutS(&dqp->qr, timeout);
+    if (msg != MSG_OK) {
+      chSysUnlock();
+      return msg;
+    }
+  }
+
+  /* Draining the queue.*/
+  do {
+    delegate_call_t dc = *dqp->rdptr++;
+
+    if (dqp->rdptr >= dqp->top) {
+      dqp->rdptr = dqp->buffer;
+    }
+    dqp->cnt--;
+
+    /* If there is a poster waiting then makes it ready.*/
+    chThdDequeueNextI(&dqp->qw, MSG_OK);
+    chSchRescheduleS();
+    chSysUnlock();
+
+    msg = delegate_execute(&dc);
+
+    chSysLock();
+    if (dc.future != NULL) {
+      dc.future->result = msg;
+      dc.future->done   = true;
+      chThdResumeI(&dc.future->thread, MSG_OK);
+    }
+  } while (dqp->cnt > (size_t)0);
+
+  chSchRescheduleS();
+  chSysUnlock();
+
+  return MSG_OK;
+}
+
+/**
+ * @brief   Waits for the completion of a future.
+ *
+ * @param[in] dfp       pointer to a @p delegate_future_t object
+ * @param[in] timeout   the number of ticks before the operation timeouts,
+ *                      the following special values are allowed:
+ *                      - @a TIME_IMMEDIATE immediate timeout.
+ *                      - @a TIME_INFINITE no timeout.
+ *                      .
+ * @return              The operation status.
+ * @retval MSG_OK       if the call has been executed, the result is
+ *                      available using @p chDelegateFutureGetResultX().
+ * @retval MSG_TIMEOUT  if the operation has timed out.
+ *
+ * @api
+ */
+msg_t chDelegateFutureWaitTimeout(delegate_future_t *dfp,
+                                  sysinterval_t timeout) {
+  msg_t msg = MSG_OK;
+
+  chDbgCheck(dfp != NULL);
+
+  chSysLock();
+  if (!dfp->done) {
+    msg = chThdSuspendTimeoutS(&dfp->thread, timeout);
+  }
+  chSysUnlock();
+
+  return msg;
+}
+
 #endif /* CH_CFG_USE_DELEGATES == TRUE */
 
 /** @} */
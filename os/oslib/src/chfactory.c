@@ -95,14 +95,133 @@ static void copy_name(const char *sp, char *dp) {
   } while ((c != (char)0) && (i > 0U));
 }
 
+#if (CH_CFG_FACTORY_HASH_SIZE > 0) || defined(__DOXYGEN__)
+static unsigned dyn_hash(const char *name) {
+  uint32_t h = 2166136261U;
+  unsigned i;
+
+  /* FNV-1a on the significant part of the name.*/
+  for (i = 0U; (i < (unsigned)CH_CFG_FACTORY_MAX_NAMES_LENGTH) &&
+               (name[i] != (char)0); i++) {
+    h = (h ^ (uint32_t)(uint8_t)name[i]) * 16777619U;
+  }
+
+  return (unsigned)h & ((unsigned)CH_CFG_FACTORY_HASH_SIZE - 1U);
+}
+
+static void dyn_index_insert(dyn_element_t *dep, dyn_list_t *dlp) {
+  unsigned i, h = dyn_hash(dep->name);
+
+  /* Linear probing for a free slot.*/
+  for (i = 0U; i < (unsigned)CH_CFG_FACTORY_HASH_SIZE; i++) {
+    unsigned slot = (h + i) & ((unsigned)CH_CFG_FACTORY_HASH_SIZE - 1U);
+
+    if (dlp->index[slot] == NULL) {
+      dlp->index[slot] = dep;
+      return;
+    }
+  }
+
+  /* Index full, the object will be found by linear search.*/
+  dlp->unindexed++;
+}
+
+/*
+ * Backward-shift deletion, the following elements of the cluster are moved
+ * into the freed slot when their probe sequence crosses it, this way no
+ * deleted slots markers are left in the index and lookups do not degrade
+ * after many deletions.
+ */
+static void dyn_index_remove(dyn_element_t *dep, dyn_list_t *dlp) {
+  const unsigned mask = (unsigned)CH_CFG_FACTORY_HASH_SIZE - 1U;
+  unsigned i, j, k, n;
+
+  /* Searching the element in its cluster.*/
+  i = dyn_hash(dep->name);
+  for (n = 0U; n < (unsigned)CH_CFG_FACTORY_HASH_SIZE; n++) {
+    if (dlp->index[i] == dep) {
+      break;
+    }
+    if (dlp->index[i] == NULL) {
+      n = (unsigned)CH_CFG_FACTORY_HASH_SIZE;
+      break;
+    }
+    i = (i + 1U) & mask;
+  }
+
+  if (n >= (unsigned)CH_CFG_FACTORY_HASH_SIZE) {
+    /* The element did not fit the index.*/
+    chDbgAssert(dlp->unindexed > (ucnt_t)0, "not indexed");
+
+    dlp->unindexed--;
+    return;
+  }
+
+  /* The scan is bounded because a full index has no free slot ending the
+     cluster.*/
+  dlp->index[i] = NULL;
+  j = i;
+  for (n = 1U; n < (unsigned)CH_CFG_FACTORY_HASH_SIZE; n++) {
+    j = (j + 1U) & mask;
+    if (dlp->index[j] == NULL) {
+      return;
+    }
+
+    /* Home slot of the element, it stays where it is if the home is
+       cyclically within (i, j].*/
+    k = dyn_hash(dlp->index[j]->name);
+    if ((i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j))) {
+      continue;
+    }
+
+    /* Moving the element into the free slot, its own slot becomes the
+       free one.*/
+    dlp->index[i] = dlp->index[j];
+    dlp->index[j] = NULL;
+    i = j;
+  }
+}
+#endif /* CH_CFG_FACTORY_HASH_SIZE > 0 */
+
 static inline void dyn_list_init(dyn_list_t *dlp) {
+#if CH_CFG_FACTORY_HASH_SIZE > 0
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)CH_CFG_FACTORY_HASH_SIZE; i++) {
+    dlp->index[i] = NULL;
+  }
+  dlp->unindexed = (ucnt_t)0;
+#endif
 
   dlp->next = (dyn_element_t *)dlp;
 }
 
 static dyn_element_t *dyn_list_find(const char *name, dyn_list_t *dlp) {
-  dyn_element_t *p = dlp->next;
+  dyn_element_t *p;
+
+#if CH_CFG_FACTORY_HASH_SIZE > 0
+  unsigned i, h = dyn_hash(name);
+
+  for (i = 0U; i < (unsigned)CH_CFG_FACTORY_HASH_SIZE; i++) {
+    unsigned slot = (h + i) & ((unsigned)CH_CFG_FACTORY_HASH_SIZE - 1U);
+
+    p = dlp->index[slot];
+    if (p == NULL) {
+      break;
+    }
+    if (strncmp(p->name, name, CH_CFG_FACTORY_MAX_NAMES_LENGTH) == 0) {
+      return p;
+    }
+  }
+
+  /* Not in the index, the linear search is only required if there are
+     objects that did not fit the index.*/
+  if (dlp->unindexed == (ucnt_t)0) {
+    return NULL;
+  }
+#endif
 
+  p = dlp->next;
   while (p != (dyn_element_t *)dlp) {
     if (strncmp(p->name, name, CH_CFG_FACTORY_MAX_NAMES_LENGTH) == 0) {
       return p;
@@ -122,6 +241,9 @@ static dyn_element_t *dyn_list_unlink(dyn_element_t *element,
     if (prev->next == element) {
       /* Found.*/
       prev->next = element->next;
+#if CH_CFG_FACTORY_HASH_SIZE > 0
+      dyn_index_remove(element, dlp);
+#endif
       return element;
     }
 
@@ -160,6 +282,9 @@ static dyn_element_t *dyn_create_object_heap(const char *name,
 
   /* Updating factory list.*/
   dlp->next = dep;
+#if CH_CFG_FACTORY_HASH_SIZE > 0
+  dyn_index_insert(dep, dlp);
+#endif
 
   return dep;
 }
@@ -205,6 +330,9 @@ static dyn_element_t *dyn_create_object_pool(const char *name,
 
   /* Updating factory list.*/
   dlp->next = (dyn_element_t *)dep;
+#if CH_CFG_FACTORY_HASH_SIZE > 0
+  dyn_index_insert(dep, dlp);
+#endif
 
   return dep;
 }
@@ -35,6 +35,8 @@
  * @{
  */
 
+#include <string.h>
+
 #include "ch.h"
 
 #if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
@@ -339,6 +341,124 @@ void chHeapFree(void *p) {
   return;
 }
 
+/**
+ * @brief   Changes the size of a previously allocated memory block.
+ * @details The block is resized in place when possible: when shrinking the
+ *          excess is split and returned to the heap, when growing the
+ *          block is extended into the adjacent free block if it is large
+ *          enough. Else a new block is allocated from the same heap, the
+ *          content is copied and the old block is freed.
+ * @note    If @p p is @p NULL then the function is equivalent to
+ *          @p chHeapAlloc() on the default heap.
+ * @note    A moved block is only guaranteed to be aligned to
+ *          @p CH_HEAP_ALIGNMENT, blocks allocated with a stricter
+ *          alignment should not be reallocated.
+ *
+ * @param[in] p         pointer to the memory block to be resized or
+ *                      @p NULL
+ * @param[in] size      the new size of the block
+ * @return              A pointer to the resized block, it can differ from
+ *                      @p p if the block has been moved.
+ * @retval NULL         if the block cannot be resized, in this case the
+ *                      original block is left untouched.
+ *
+ * @api
+ */
+void *chHeapRealloc(void *p, size_t size) {
+  heap_header_t *qp, *hp, *fp, *limit;
+  memory_heap_t *heapp;
+  size_t pages, oldpages;
+  void *np;
+
+  chDbgCheck(size > 0U);
+
+  if (p == NULL) {
+    return chHeapAlloc(NULL, size);
+  }
+
+  chDbgCheck(MEM_IS_ALIGNED(p, CH_HEAP_ALIGNMENT));
+
+  /*lint -save -e9087 [11.3] Safe cast.*/
+  hp = (heap_header_t *)p - 1U;
+  /*lint -restore*/
+  heapp = H_HEAP(hp);
+
+  /* Sizes are converted in number of elementary allocation units.*/
+  pages = MEM_ALIGN_NEXT(size, CH_HEAP_ALIGNMENT) / CH_HEAP_ALIGNMENT;
+  oldpages = MEM_ALIGN_NEXT(H_SIZE(hp),
+                            CH_HEAP_ALIGNMENT) / CH_HEAP_ALIGNMENT;
+
+  if (pages < oldpages) {
+    /* Shrinking, the excess becomes a block which is then freed, this
+       way it is merged with an adjacent free block if any. The heap is
+       not locked because both blocks are owned by the caller.*/
+    fp = H_BLOCK(hp) + pages;
+    H_HEAP(fp) = heapp;
+    H_SIZE(fp) = ((oldpages - pages) - 1U) * CH_HEAP_ALIGNMENT;
+    H_SIZE(hp) = size;
+    chHeapFree((void *)H_BLOCK(fp));
+
+    return p;
+  }
+
+  if (pages == oldpages) {
+    /* Same allocation units, just updating the size.*/
+    H_SIZE(hp) = size;
+
+    return p;
+  }
+
+  /* Taking heap mutex/semaphore.*/
+  H_LOCK(heapp);
+
+  /* Looking for a free block starting right after the current block, the
+     free list is ordered by address. Note, H_LIMIT() cannot be used on
+     an allocated block because its header contains the size in bytes.*/
+  limit = H_BLOCK(hp) + oldpages;
+  qp = &heapp->header;
+  while ((H_NEXT(qp) != NULL) && (H_NEXT(qp) < limit)) {
+    qp = H_NEXT(qp);
+  }
+  fp = H_NEXT(qp);
+
+  if ((fp == limit) &&
+      ((pages - oldpages) <= (H_PAGES(fp) + 1U))) {
+    size_t needed = pages - oldpages;
+
+    if (needed == (H_PAGES(fp) + 1U)) {
+      /* Exact size, getting the whole free block.*/
+      H_NEXT(qp) = H_NEXT(fp);
+    }
+    else {
+      /* The free block is bigger than required, moving its header after
+         the extended area.*/
+      heap_header_t *rp = fp + needed;
+
+      H_NEXT(rp)  = H_NEXT(fp);
+      H_PAGES(rp) = H_PAGES(fp) - needed;
+      H_NEXT(qp)  = rp;
+    }
+    H_SIZE(hp) = size;
+
+    /* Releasing heap mutex/semaphore.*/
+    H_UNLOCK(heapp);
+
+    return p;
+  }
+
+  /* Releasing heap mutex/semaphore.*/
+  H_UNLOCK(heapp);
+
+  /* Growing in place is not possible, moving the block.*/
+  np = chHeapAlloc(heapp, size);
+  if (np != NULL) {
+    memcpy(np, p, H_SIZE(hp));
+    chHeapFree(p);
+  }
+
+  return np;
+}
+
 /**
  * @brief   Reports the heap status.
  * @note    This function is meant to be used in the test suite, it should
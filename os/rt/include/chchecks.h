@@ -105,6 +105,10 @@
 #error "CH_CFG_USE_REGISTRY not defined in chconf.h"
 #endif
 
+#if !defined(CH_CFG_USE_THREADS_TABLE)
+#error "CH_CFG_USE_THREADS_TABLE not defined in chconf.h"
+#endif
+
 #if !defined(CH_CFG_USE_WAITEXIT)
 #error "CH_CFG_USE_WAITEXIT not defined in chconf.h"
 #endif
@@ -141,6 +145,10 @@
 #error "CH_CFG_USE_EVENTS_TIMEOUT not defined in chconf.h"
 #endif
 
+#if !defined(CH_CFG_USE_EVENTS_COALESCING)
+#error "CH_CFG_USE_EVENTS_COALESCING not defined in chconf.h"
+#endif
+
 #if !defined(CH_CFG_USE_MESSAGES)
 #error "CH_CFG_USE_MESSAGES not defined in chconf.h"
 #endif
@@ -66,6 +66,18 @@ struct event_listener {
                                                     by the event source.    */
   eventflags_t          wflags;         /**< @brief Flags that this listener
                                                     interested in.          */
+#if (CH_CFG_USE_EVENTS_COALESCING == TRUE) || defined(__DOXYGEN__)
+  sysinterval_t         interval;       /**< @brief Minimum interval between
+                                                    two wakeups, zero if
+                                                    coalescing is disabled. */
+  ucnt_t                threshold;      /**< @brief Deferred broadcasts
+                                                    forcing a wakeup, zero
+                                                    if not used.            */
+  ucnt_t                deferred;       /**< @brief Broadcasts deferred in
+                                                    the current interval.   */
+  virtual_timer_t       vt;             /**< @brief Coalescing interval
+                                                    timer.                  */
+#endif
 };
 
 /**
@@ -134,6 +146,18 @@ extern "C" {
   void chEvtSignalI(thread_t *tp, eventmask_t events);
   void chEvtBroadcastFlags(event_source_t *esp, eventflags_t flags);
   void chEvtBroadcastFlagsI(event_source_t *esp, eventflags_t flags);
+  void chEvtBroadcastFlagsMany(event_source_t * const *espp, unsigned n,
+                               eventflags_t flags);
+  void chEvtBroadcastFlagsManyI(event_source_t * const *espp, unsigned n,
+                                eventflags_t flags);
+#if CH_CFG_USE_EVENTS_COALESCING == TRUE
+  void chEvtSetCoalescing(event_listener_t *elp,
+                          sysinterval_t interval,
+                          ucnt_t threshold);
+  void chEvtSetCoalescingI(event_listener_t *elp,
+                           sysinterval_t interval,
+                           ucnt_t threshold);
+#endif
   void chEvtDispatch(const evhandler_t *handlers, eventmask_t events);
 #if (CH_CFG_OPTIMIZE_SPEED == TRUE) || (CH_CFG_USE_EVENTS_TIMEOUT == FALSE)
   eventmask_t chEvtWaitOne(eventmask_t events);
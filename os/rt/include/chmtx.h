@@ -99,6 +99,7 @@ struct ch_mutex {
 #ifdef __cplusplus
 extern "C" {
 #endif
+  tprio_t __mtx_get_inherited_prio(thread_t *tp);
   void chMtxObjectInit(mutex_t *mp);
   void chMtxLock(mutex_t *mp);
   void chMtxLockS(mutex_t *mp);
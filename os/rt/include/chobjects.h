@@ -98,6 +98,14 @@ typedef struct ch_virtual_timer {
    * @brief   Timer callback function parameter.
    */
   void                          *par;
+  /**
+   * @brief   Reload interval, zero for one-shot timers.
+   */
+  sysinterval_t                 reload;
+  /**
+   * @brief   Number of expirations skipped by a continuous timer.
+   */
+  ucnt_t                        overruns;
 } virtual_timer_t;
 
 /**
@@ -226,6 +226,43 @@ typedef struct {
 }
 /** @} */
 
+/**
+ * @name    Threads table macros
+ * @{
+ */
+/**
+ * @brief   Start of a static threads table.
+ * @details The table is a constant array of thread descriptors placed in
+ *          flash, the threads are created by @p chSysInit() before the
+ *          system is declared running, there is no need to create them
+ *          from @p main().
+ * @note    Requires @p CH_CFG_USE_THREADS_TABLE.
+ */
+#define THD_TABLE_BEGIN                                                     \
+  const thread_descriptor_t ch_threads_table[] = {
+
+/**
+ * @brief   Entry of a static threads table.
+ *
+ * @param[in] prio      thread priority
+ * @param[in] name      thread name
+ * @param[in] wa        name of a working area declared using
+ *                      @p THD_WORKING_AREA()
+ * @param[in] funcp     thread function pointer
+ * @param[in] arg       thread argument
+ */
+#define THD_TABLE_THREAD(prio, name, wa, funcp, arg)                        \
+  THD_DESCRIPTOR((name), THD_WORKING_AREA_BASE(wa),                         \
+                 THD_WORKING_AREA_END(wa), (prio), (funcp), (arg)),
+
+/**
+ * @brief   End of a static threads table.
+ */
+#define THD_TABLE_END                                                       \
+  THD_DESCRIPTOR(NULL, NULL, NULL, 0, NULL, NULL)                           \
+};
+/** @} */
+
 /**
  * @name    Macro Functions
  * @{
@@ -284,6 +321,9 @@ typedef struct {
 
 #ifdef __cplusplus
 extern "C" {
+#endif
+#if (CH_CFG_USE_THREADS_TABLE == TRUE) && !defined(__DOXYGEN__)
+  extern const thread_descriptor_t ch_threads_table[];
 #endif
    thread_t *__thd_object_init(os_instance_t *oip,
                                thread_t *tp,
@@ -73,6 +73,8 @@ extern "C" {
 #endif
   void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
                   vtfunc_t vtfunc, void *par);
+  void chVTDoSetContinuousI(virtual_timer_t *vtp, sysinterval_t delay,
+                            vtfunc_t vtfunc, void *par);
   void chVTDoResetI(virtual_timer_t *vtp);
   void chVTDoTickI(void);
 #if CH_CFG_USE_TIMESTAMP == TRUE
@@ -101,6 +103,8 @@ extern "C" {
 static inline void chVTObjectInit(virtual_timer_t *vtp) {
 
   vtp->func = NULL;
+  vtp->reload = (sysinterval_t)0;
+  vtp->overruns = (ucnt_t)0;
 }
 
 /**
@@ -362,6 +366,114 @@ static inline void chVTSet(virtual_timer_t *vtp, sysinterval_t delay,
   chSysUnlock();
 }
 
+/**
+ * @brief   Enables a continuous virtual timer.
+ * @details If the virtual timer was already enabled then it is re-enabled
+ *          using the new parameters.
+ * @pre     The timer must have been initialized using @p chVTObjectInit()
+ *          or @p chVTDoSetI().
+ *
+ * @param[in] vtp       the @p virtual_timer_t structure pointer
+ * @param[in] delay     the number of ticks between expirations, the
+ *                      special values are handled as follow:
+ *                      - @a TIME_INFINITE is allowed but interpreted as a
+ *                        normal time specification.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ *                      .
+ * @param[in] vtfunc    the timer callback function. The timer stays armed
+ *                      while the callback is invoked, it can be stopped
+ *                      from the callback using @p chVTResetI().
+ * @param[in] par       a parameter that will be passed to the callback
+ *                      function
+ *
+ * @iclass
+ */
+static inline void chVTSetContinuousI(virtual_timer_t *vtp,
+                                      sysinterval_t delay,
+                                      vtfunc_t vtfunc, void *par) {
+
+  chVTResetI(vtp);
+  chVTDoSetContinuousI(vtp, delay, vtfunc, par);
+}
+
+/**
+ * @brief   Enables a continuous virtual timer.
+ * @details If the virtual timer was already enabled then it is re-enabled
+ *          using the new parameters.
+ * @pre     The timer must have been initialized using @p chVTObjectInit()
+ *          or @p chVTDoSetI().
+ *
+ * @param[in] vtp       the @p virtual_timer_t structure pointer
+ * @param[in] delay     the number of ticks between expirations, the
+ *                      special values are handled as follow:
+ *                      - @a TIME_INFINITE is allowed but interpreted as a
+ *                        normal time specification.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ *                      .
+ * @param[in] vtfunc    the timer callback function. The timer stays armed
+ *                      while the callback is invoked, it can be stopped
+ *                      from the callback using @p chVTResetI().
+ * @param[in] par       a parameter that will be passed to the callback
+ *                      function
+ *
+ * @api
+ */
+static inline void chVTSetContinuous(virtual_timer_t *vtp,
+                                     sysinterval_t delay,
+                                     vtfunc_t vtfunc, void *par) {
+
+  chSysLock();
+  chVTSetContinuousI(vtp, delay, vtfunc, par);
+  chSysUnlock();
+}
+
+/**
+ * @brief   Returns the current reload interval.
+ *
+ * @param[in] vtp       the @p virtual_timer_t structure pointer
+ * @return              The reload interval, zero for one-shot timers.
+ *
+ * @xclass
+ */
+static inline sysinterval_t chVTGetReloadIntervalX(const virtual_timer_t *vtp) {
+
+  return vtp->reload;
+}
+
+/**
+ * @brief   Changes the reload interval of an armed timer.
+ * @details The new interval is used starting from the next expiration,
+ *          setting it to zero makes the timer one-shot.
+ * @note    The reload interval is reset by @p chVTDoSetI(), this function
+ *          must be called after arming the timer.
+ *
+ * @param[in] vtp       the @p virtual_timer_t structure pointer
+ * @param[in] reload    the new reload interval
+ *
+ * @xclass
+ */
+static inline void chVTSetReloadIntervalX(virtual_timer_t *vtp,
+                                          sysinterval_t reload) {
+
+  vtp->reload = reload;
+}
+
+/**
+ * @brief   Returns the number of skipped expirations.
+ * @details A continuous timer served later than its next deadline skips
+ *          the expired deadlines, keeping its phase, and counts them as
+ *          overruns. The counter is cleared when the timer is armed.
+ *
+ * @param[in] vtp       the @p virtual_timer_t structure pointer
+ * @return              The number of overruns.
+ *
+ * @xclass
+ */
+static inline ucnt_t chVTGetOverrunsX(const virtual_timer_t *vtp) {
+
+  return vtp->overruns;
+}
+
 #if (CH_CFG_USE_TIMESTAMP == TRUE) || defined(__DOXYGEN__)
 /**
  * @brief   Generates a monotonic time stamp.
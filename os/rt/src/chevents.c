@@ -49,7 +49,11 @@
  *          Event Source will be signaled with an events mask.<br>
  *          An unlimited number of Event Sources can exists in a system and
  *          each thread can be listening on an unlimited number of
- *          them.
+ *          them.<br>
+ *          If the @p CH_CFG_USE_EVENTS_COALESCING option is enabled then
+ *          an Event Listener can limit the rate of its wakeups, broadcasts
+ *          received within the coalescing interval are delivered together
+ *          at the interval end.
  * @pre     In order to use the Events APIs the @p CH_CFG_USE_EVENTS option
  *          must be enabled in @p chconf.h.
  * @post    Enabling events requires 1-4 (depending on the architecture)
@@ -81,6 +85,59 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (CH_CFG_USE_EVENTS_COALESCING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Coalescing interval end.
+ * @details If broadcasts have been deferred during the interval then the
+ *          listener is signaled and a new interval is started.
+ *
+ * @param[in] p         pointer to the @p event_listener_t structure
+ */
+static void evt_coalescing_end(void *p) {
+  event_listener_t *elp = (event_listener_t *)p;
+
+  chSysLockFromISR();
+  if (elp->deferred > (ucnt_t)0) {
+    elp->deferred = (ucnt_t)0;
+    chEvtSignalI(elp->listener, elp->events);
+    chVTDoSetI(&elp->vt, elp->interval, evt_coalescing_end, (void *)elp);
+  }
+  chSysUnlockFromISR();
+}
+#endif
+
+/**
+ * @brief   Signals a listener on behalf of a broadcast.
+ * @details If coalescing is enabled on the listener then the signal is
+ *          deferred to the end of the current interval unless the
+ *          threshold of deferred broadcasts is reached.
+ *
+ * @param[in] elp       pointer to the @p event_listener_t structure
+ */
+static void evt_listener_signal(event_listener_t *elp) {
+
+#if CH_CFG_USE_EVENTS_COALESCING == TRUE
+  if (elp->interval > (sysinterval_t)0) {
+    if (chVTIsArmedI(&elp->vt)) {
+      /* Inside an interval, the wakeup is deferred unless the threshold
+         has been reached.*/
+      elp->deferred++;
+      if ((elp->threshold == (ucnt_t)0) ||
+          (elp->deferred < elp->threshold)) {
+        return;
+      }
+      chVTResetI(&elp->vt);
+    }
+
+    /* Immediate wakeup, a new interval is started.*/
+    elp->deferred = (ucnt_t)0;
+    chVTDoSetI(&elp->vt, elp->interval, evt_coalescing_end, (void *)elp);
+  }
+#endif
+
+  chEvtSignalI(elp->listener, elp->events);
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -115,6 +172,12 @@ void chEvtRegisterMaskWithFlags(event_source_t *esp,
   elp->events   = events;
   elp->flags    = (eventflags_t)0;
   elp->wflags   = wflags;
+#if CH_CFG_USE_EVENTS_COALESCING == TRUE
+  elp->interval  = (sysinterval_t)0;
+  elp->threshold = (ucnt_t)0;
+  elp->deferred  = (ucnt_t)0;
+  chVTObjectInit(&elp->vt);
+#endif
   chSysUnlock();
 }
 
@@ -145,6 +208,11 @@ void chEvtUnregister(event_source_t *esp, event_listener_t *elp) {
   /*lint -restore*/
     if (p->next == elp) {
       p->next = elp->next;
+#if CH_CFG_USE_EVENTS_COALESCING == TRUE
+      if (chVTIsArmedI(&elp->vt)) {
+        chVTResetI(&elp->vt);
+      }
+#endif
       break;
     }
     p = p->next;
@@ -239,12 +307,40 @@ void chEvtBroadcastFlagsI(event_source_t *esp, eventflags_t flags) {
        source does not emit any flag.*/
     if ((flags == (eventflags_t)0) ||
         ((flags & elp->wflags) != (eventflags_t)0)) {
-      chEvtSignalI(elp->listener, elp->events);
+      evt_listener_signal(elp);
     }
     elp = elp->next;
   }
 }
 
+/**
+ * @brief   Signals all the Event Listeners registered on several Event
+ *          Sources.
+ * @details The flags are broadcasted on all the specified sources within
+ *          a single critical zone.
+ * @post    This function does not reschedule so a call to a rescheduling
+ *          function must be performed before unlocking the kernel. Note that
+ *          interrupt handlers always reschedule on exit so an explicit
+ *          reschedule must not be performed in ISRs.
+ *
+ * @param[in] espp      pointer to an array of @p event_source_t pointers
+ * @param[in] n         number of elements in the array
+ * @param[in] flags     the flags set to be added to the listener flags mask
+ *
+ * @iclass
+ */
+void chEvtBroadcastFlagsManyI(event_source_t * const *espp, unsigned n,
+                              eventflags_t flags) {
+  unsigned i;
+
+  chDbgCheckClassI();
+  chDbgCheck((espp != NULL) || (n == 0U));
+
+  for (i = 0U; i < n; i++) {
+    chEvtBroadcastFlagsI(espp[i], flags);
+  }
+}
+
 /**
  * @brief   Returns the flags associated to an @p event_listener_t.
  * @details The flags are returned and the @p event_listener_t flags mask is
@@ -334,6 +430,95 @@ void chEvtBroadcastFlags(event_source_t *esp, eventflags_t flags) {
   chSysUnlock();
 }
 
+/**
+ * @brief   Signals all the Event Listeners registered on several Event
+ *          Sources.
+ * @details The flags are broadcasted on all the specified sources within
+ *          a single critical zone and with a single reschedule.
+ *
+ * @param[in] espp      pointer to an array of @p event_source_t pointers
+ * @param[in] n         number of elements in the array
+ * @param[in] flags     the flags set to be added to the listener flags mask
+ *
+ * @api
+ */
+void chEvtBroadcastFlagsMany(event_source_t * const *espp, unsigned n,
+                             eventflags_t flags) {
+
+  chSysLock();
+  chEvtBroadcastFlagsManyI(espp, n, flags);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+#if (CH_CFG_USE_EVENTS_COALESCING == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Configures the wakeups coalescing of an Event Listener.
+ * @details After a wakeup caused by a broadcast the listening thread is
+ *          not signaled again before @p interval is elapsed, broadcasts
+ *          received meanwhile are deferred to the end of the interval and
+ *          delivered with a single wakeup. Flags are accumulated in the
+ *          listener as usual.
+ * @note    If @p threshold is not zero then the listener is signaled
+ *          immediately when that number of broadcasts has been deferred.
+ * @note    Setting @p interval to zero disables the coalescing, deferred
+ *          broadcasts are signaled immediately.
+ *
+ * @param[in] elp       pointer to the @p event_listener_t structure
+ * @param[in] interval  minimum interval between two wakeups
+ * @param[in] threshold number of deferred broadcasts forcing a wakeup,
+ *                      zero if not used
+ *
+ * @iclass
+ */
+void chEvtSetCoalescingI(event_listener_t *elp,
+                         sysinterval_t interval,
+                         ucnt_t threshold) {
+
+  chDbgCheckClassI();
+  chDbgCheck(elp != NULL);
+
+  if (chVTIsArmedI(&elp->vt)) {
+    chVTResetI(&elp->vt);
+  }
+  if (elp->deferred > (ucnt_t)0) {
+    elp->deferred = (ucnt_t)0;
+    chEvtSignalI(elp->listener, elp->events);
+  }
+  elp->interval  = interval;
+  elp->threshold = threshold;
+}
+
+/**
+ * @brief   Configures the wakeups coalescing of an Event Listener.
+ * @details After a wakeup caused by a broadcast the listening thread is
+ *          not signaled again before @p interval is elapsed, broadcasts
+ *          received meanwhile are deferred to the end of the interval and
+ *          delivered with a single wakeup. Flags are accumulated in the
+ *          listener as usual.
+ * @note    If @p threshold is not zero then the listener is signaled
+ *          immediately when that number of broadcasts has been deferred.
+ * @note    Setting @p interval to zero disables the coalescing, deferred
+ *          broadcasts are signaled immediately.
+ *
+ * @param[in] elp       pointer to the @p event_listener_t structure
+ * @param[in] interval  minimum interval between two wakeups
+ * @param[in] threshold number of deferred broadcasts forcing a wakeup,
+ *                      zero if not used
+ *
+ * @api
+ */
+void chEvtSetCoalescing(event_listener_t *elp,
+                        sysinterval_t interval,
+                        ucnt_t threshold) {
+
+  chSysLock();
+  chEvtSetCoalescingI(elp, interval, threshold);
+  chSchRescheduleS();
+  chSysUnlock();
+}
+#endif /* CH_CFG_USE_EVENTS_COALESCING == TRUE */
+
 /**
  * @brief   Returns the unmasked flags associated to an @p event_listener_t.
  * @details The flags are returned and the @p event_listener_t flags mask is
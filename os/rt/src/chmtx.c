@@ -93,6 +93,35 @@
 /* Module exported functions.                                                */
 /*===========================================================================*/
 
+/**
+ * @brief   Calculates the priority of a thread owning mutexes.
+ * @details The priority is the highest between the thread base priority and
+ *          the priorities of the threads waiting on the mutexes owned by
+ *          the thread.
+ *
+ * @param[in] tp        pointer to the thread
+ * @return              The priority the thread must have.
+ *
+ * @notapi
+ */
+tprio_t __mtx_get_inherited_prio(thread_t *tp) {
+  tprio_t prio = tp->realprio;
+  mutex_t *mp = tp->mtxlist;
+
+  while (mp != NULL) {
+    /* If the highest priority thread waiting in the mutexes list has a
+       greater priority than the thread base priority then the final
+       priority will have at least that priority.*/
+    if (chMtxQueueNotEmptyS(mp) &&
+        (((thread_t *)mp->queue.next)->hdr.pqueue.prio > prio)) {
+      prio = ((thread_t *)mp->queue.next)->hdr.pqueue.prio;
+    }
+    mp = mp->next;
+  }
+
+  return prio;
+}
+
 /**
  * @brief   Initializes s @p mutex_t structure.
  *
@@ -325,7 +354,6 @@ bool chMtxTryLockS(mutex_t *mp) {
  */
 void chMtxUnlock(mutex_t *mp) {
   thread_t *currtp = chThdGetSelfX();
-  mutex_t *lmp;
 
   chDbgCheck(mp != NULL);
 
@@ -352,22 +380,7 @@ void chMtxUnlock(mutex_t *mp) {
 
       /* Recalculates the optimal thread priority by scanning the owned
          mutexes list.*/
-      tprio_t newprio = currtp->realprio;
-      lmp = currtp->mtxlist;
-      while (lmp != NULL) {
-        /* If the highest priority thread waiting in the mutexes list has a
-           greater priority than the current thread base priority then the
-           final priority will have at least that priority.*/
-        if (chMtxQueueNotEmptyS(lmp) &&
-            (((thread_t *)lmp->queue.next)->hdr.pqueue.prio > newprio)) {
-          newprio = ((thread_t *)lmp->queue.next)->hdr.pqueue.prio;
-        }
-        lmp = lmp->next;
-      }
-
-      /* Assigns to the current thread the highest priority among all the
-         waiting threads.*/
-      currtp->hdr.pqueue.prio = newprio;
+      currtp->hdr.pqueue.prio = __mtx_get_inherited_prio(currtp);
 
       /* Awakens the highest priority thread waiting for the unlocked mutex and
          assigns the mutex to it.*/
@@ -412,7 +425,6 @@ void chMtxUnlock(mutex_t *mp) {
  */
 void chMtxUnlockS(mutex_t *mp) {
   thread_t *currtp = chThdGetSelfX();
-  mutex_t *lmp;
 
   chDbgCheckClassS();
   chDbgCheck(mp != NULL);
@@ -438,22 +450,7 @@ void chMtxUnlockS(mutex_t *mp) {
 
       /* Recalculates the optimal thread priority by scanning the owned
          mutexes list.*/
-      tprio_t newprio = currtp->realprio;
-      lmp = currtp->mtxlist;
-      while (lmp != NULL) {
-        /* If the highest priority thread waiting in the mutexes list has a
-           greater priority than the current thread base priority then the
-           final priority will have at least that priority.*/
-        if (chMtxQueueNotEmptyS(lmp) &&
-            (((thread_t *)lmp->queue.next)->hdr.pqueue.prio > newprio)) {
-          newprio = ((thread_t *)lmp->queue.next)->hdr.pqueue.prio;
-        }
-        lmp = lmp->next;
-      }
-
-      /* Assigns to the current thread the highest priority among all the
-         waiting threads.*/
-      currtp->hdr.pqueue.prio = newprio;
+      currtp->hdr.pqueue.prio = __mtx_get_inherited_prio(currtp);
 
       /* Awakens the highest priority thread waiting for the unlocked mutex and
          assigns the mutex to it.*/
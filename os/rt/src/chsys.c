@@ -151,6 +151,8 @@ void chSysWaitSystemState(system_state_t state) {
  * @post    The main thread is created with priority @p NORMALPRIO and
  *          interrupts are enabled.
  * @post    the system is in @p ch_sys_running state.
+ * @post    If @p CH_CFG_USE_THREADS_TABLE is enabled then the threads in
+ *          the static threads table have been created.
  *
  * @special
  */
@@ -182,8 +184,29 @@ void chSysInit(void) {
   /* Initializing default OS instance.*/
   chInstanceObjectInit(&ch0, &ch_core0_cfg);
 
+#if CH_CFG_USE_THREADS_TABLE == TRUE
+  /* Threads declared in the static threads table are created in a single
+     pass, the table is terminated by an entry with no function.*/
+  {
+    const thread_descriptor_t *tdp;
+
+    for (tdp = &ch_threads_table[0]; tdp->funcp != NULL; tdp++) {
+#if CH_DBG_FILL_THREADS == TRUE
+      __thd_memfill((uint8_t *)tdp->wbase,
+                    (uint8_t *)tdp->wend,
+                    CH_DBG_STACK_FILL_VALUE);
+#endif
+      (void) chThdCreateI(tdp);
+    }
+  }
+#endif
+
   /* It is alive now.*/
   ch_system.state = ch_sys_running;
+#if CH_CFG_USE_THREADS_TABLE == TRUE
+  /* Table threads with priority higher than main() start now.*/
+  chSchRescheduleS();
+#endif
   chSysUnlock();
 }
 
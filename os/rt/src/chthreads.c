@@ -616,11 +616,13 @@ tprio_t chThdSetPriority(tprio_t newprio) {
   chSysLock();
 #if CH_CFG_USE_MUTEXES == TRUE
   oldprio = currtp->realprio;
-  if ((currtp->hdr.pqueue.prio == currtp->realprio) ||
+  currtp->realprio = newprio;
+  if ((currtp->hdr.pqueue.prio == oldprio) ||
       (newprio > currtp->hdr.pqueue.prio)) {
-    currtp->hdr.pqueue.prio = newprio;
+    /* A priority inherited from threads waiting on owned mutexes is
+       retained, if any.*/
+    currtp->hdr.pqueue.prio = __mtx_get_inherited_prio(currtp);
   }
-  currtp->realprio = newprio;
 #else
   oldprio = currtp->hdr.pqueue.prio;
   currtp->hdr.pqueue.prio = newprio;
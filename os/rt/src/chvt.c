@@ -60,6 +60,47 @@ static inline bool is_vtlist_empty(delta_list_t *dlhp) {
   return (bool)(dlhp == dlhp->next);
 }
 
+/**
+ * @brief   Inserts a timer in the delta list.
+ * @note    The alarm is not reprogrammed, it is caller's responsibility.
+ *
+ * @param[in] vtlp      pointer to the timers list
+ * @param[in] vtp       the @p virtual_timer_t structure pointer
+ * @param[in] delta     delta from the list base time
+ *
+ * @notapi
+ */
+static void vt_insert(virtual_timers_list_t *vtlp,
+                      virtual_timer_t *vtp,
+                      sysinterval_t delta) {
+  delta_list_t *dlp;
+
+  /* The delta list is scanned in order to find the correct position for
+     this timer. */
+  dlp = vtlp->dlist.next;
+  while (dlp->delta < delta) {
+    /* Debug assert if the timer is already in the list.*/
+    chDbgAssert(dlp != &vtp->dlist, "timer already armed");
+
+    delta -= dlp->delta;
+    dlp = dlp->next;
+  }
+
+  /* The timer is inserted in the delta list.*/
+  vtp->dlist.next       = dlp;
+  vtp->dlist.prev       = vtp->dlist.next->prev;
+  vtp->dlist.prev->next = &vtp->dlist;
+  dlp->prev             = &vtp->dlist;
+  vtp->dlist.delta      = delta;
+
+  /* Calculate new delta for the following entry.*/
+  dlp->delta -= delta;
+
+  /* Special case when the timer is in last position in the list, the
+     value in the header must be restored.*/
+  vtlp->dlist.delta = (sysinterval_t)-1;
+}
+
 #if (CH_CFG_ST_TIMEDELTA > 0) || defined(__DOXYGEN__)
 /**
  * @brief   Last timer in the list check.
@@ -158,7 +199,6 @@ static void vt_list_compress(virtual_timers_list_t *vtlp,
 void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
                 vtfunc_t vtfunc, void *par) {
   virtual_timers_list_t *vtlp = &currcore->vtlist;
-  delta_list_t *dlp;
   sysinterval_t delta;
 
   chDbgCheckClassI();
@@ -166,6 +206,8 @@ void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
 
   vtp->par = par;
   vtp->func = vtfunc;
+  vtp->reload = (sysinterval_t)0;
+  vtp->overruns = (ucnt_t)0;
 
 #if CH_CFG_ST_TIMEDELTA > 0
   {
@@ -234,30 +276,39 @@ void chVTDoSetI(virtual_timer_t *vtp, sysinterval_t delay,
   delta = delay;
 #endif /* CH_CFG_ST_TIMEDELTA == 0 */
 
-  /* The delta list is scanned in order to find the correct position for
-     this timer. */
-  dlp = vtlp->dlist.next;
-  while (dlp->delta < delta) {
-    /* Debug assert if the timer is already in the list.*/
-    chDbgAssert(dlp != &vtp->dlist, "timer already armed");
-
-    delta -= dlp->delta;
-    dlp = dlp->next;
-  }
-
-  /* The timer is inserted in the delta list.*/
-  vtp->dlist.next       = dlp;
-  vtp->dlist.prev       = vtp->dlist.next->prev;
-  vtp->dlist.prev->next = &vtp->dlist;
-  dlp->prev             = &vtp->dlist;
-  vtp->dlist.delta      = delta;
+  vt_insert(vtlp, vtp, delta);
+}
 
-  /* Calculate new delta for the following entry.*/
-  dlp->delta -= delta;
+/**
+ * @brief   Enables a continuous virtual timer.
+ * @details The timer is enabled and programmed to trigger after the delay
+ *          specified as parameter and then periodically with the same
+ *          interval. Each deadline is computed from the previous one, not
+ *          from the callback execution time, so there is no accumulated
+ *          drift.
+ * @pre     The timer must not be already armed before calling this function.
+ * @note    The callback function is invoked from interrupt context.
+ *
+ * @param[out] vtp      the @p virtual_timer_t structure pointer
+ * @param[in] delay     the number of ticks between expirations, the
+ *                      special values are handled as follow:
+ *                      - @a TIME_INFINITE is allowed but interpreted as a
+ *                        normal time specification.
+ *                      - @a TIME_IMMEDIATE this value is not allowed.
+ *                      .
+ * @param[in] vtfunc    the timer callback function. The timer stays armed
+ *                      while the callback is invoked, it can be stopped
+ *                      from the callback using @p chVTResetI().
+ * @param[in] par       a parameter that will be passed to the callback
+ *                      function
+ *
+ * @iclass
+ */
+void chVTDoSetContinuousI(virtual_timer_t *vtp, sysinterval_t delay,
+                          vtfunc_t vtfunc, void *par) {
 
-  /* Special case when the timer is in last position in the list, the
-     value in the header must be restored.*/
-  vtlp->dlist.delta = (sysinterval_t)-1;
+  chVTDoSetI(vtp, delay, vtfunc, par);
+  vtp->reload = delay;
 }
 
 /**
@@ -382,9 +433,18 @@ void chVTDoTickI(void) {
 
       vtp = (virtual_timer_t *)vtlp->dlist.next;
       fn = vtp->func;
-      vtp->func = NULL;
       vtp->dlist.next->prev = &vtlp->dlist;
       vtlp->dlist.next = vtp->dlist.next;
+
+      /* Continuous timers are re-inserted before invoking the callback,
+         in this mode the deadline is always exact, else the timer is
+         marked as non active.*/
+      if (vtp->reload > (sysinterval_t)0) {
+        vt_insert(vtlp, vtp, vtp->reload);
+      }
+      else {
+        vtp->func = NULL;
+      }
       chSysUnlockFromISR();
       fn(vtp->par);
       chSysLockFromISR();
@@ -423,14 +483,29 @@ void chVTDoTickI(void) {
       dlp->next->prev = &vtlp->dlist;
       vtlp->dlist.next = dlp->next;
 
-      /* Calling the associated function and then marking the timer as
-         non active.*/
       fn = vtp->func;
-      vtp->func = NULL;
-
-      /* If the list becomes empty then the timer is stopped.*/
-      if (is_vtlist_empty(&vtlp->dlist)) {
-        port_timer_stop_alarm();
+      if (vtp->reload > (sysinterval_t)0) {
+        sysinterval_t reload = vtp->reload;
+
+        /* Continuous timer, the next deadline is computed from this
+           expiration time, "lasttime", so there is no drift. Deadlines
+           already in the past are skipped and counted as overruns.*/
+        if (reload <= nowdelta) {
+          ucnt_t missed = (ucnt_t)(nowdelta / reload);
+
+          vtp->overruns += missed;
+          reload += (sysinterval_t)missed * vtp->reload;
+        }
+        vt_insert(vtlp, vtp, reload);
+      }
+      else {
+        /* Marking the timer as non active.*/
+        vtp->func = NULL;
+
+        /* If the list becomes empty then the timer is stopped.*/
+        if (is_vtlist_empty(&vtlp->dlist)) {
+          port_timer_stop_alarm();
+        }
       }
 
       /* The callback is invoked outside the kernel critical zone.*/
@@ -0,0 +1,229 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    sb/common/sbbatch.h
+ * @brief   ARMv7-M sandbox batched syscalls macros and structures.
+ * @details A batch is a pair of rings located in a sandbox writable
+ *          region: the sandbox queues syscall requests in the submission
+ *          ring then executes all of them with a single SVC, results are
+ *          posted in the completion ring. Requests use the same numbers
+ *          and registers of the equivalent SVCs.
+ * @note    Rings are only accessed by the sandbox thread, either directly
+ *          or through the host while serving its syscalls, so there are
+ *          no concurrency issues.
+ *
+ * @addtogroup ARM_SANDBOX_BATCH
+ * @{
+ */
+
+#ifndef SBBATCH_H
+#define SBBATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "sberr.h"
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @name    Batch syscalls
+ * @{
+ */
+#define SB_BATCH_SVC_SETUP      12
+#define SB_BATCH_SVC_SUBMIT     13
+/** @} */
+
+/**
+ * @brief   Highest SVC number.
+ */
+#define SB_BATCH_SVC_MAX        255
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a batch header in shared memory.
+ * @note    The submission ring follows the header, then the completion
+ *          ring, both have the same number of entries.
+ */
+typedef struct {
+  /**
+   * @brief   Free running submission counter, written by the sandbox.
+   */
+  uint32_t                      sq_head;
+  /**
+   * @brief   Free running execution counter, written by the host.
+   */
+  uint32_t                      sq_tail;
+  /**
+   * @brief   Free running completion counter, written by the host.
+   */
+  uint32_t                      cq_head;
+  /**
+   * @brief   Free running reaping counter, written by the sandbox.
+   */
+  uint32_t                      cq_tail;
+} sb_batch_header_t;
+
+/**
+ * @brief   Type of a submission entry.
+ */
+typedef struct {
+  /**
+   * @brief   SVC number of the requested service.
+   */
+  uint32_t                      svc;
+  /**
+   * @brief   Values of registers R0..R3 for the service.
+   */
+  uint32_t                      r[4];
+  /**
+   * @brief   User data copied in the completion entry.
+   */
+  uint32_t                      user;
+} sb_sqe_t;
+
+/**
+ * @brief   Type of a completion entry.
+ */
+typedef struct {
+  /**
+   * @brief   User data from the submission entry.
+   */
+  uint32_t                      user;
+  /**
+   * @brief   Value returned by the service in R0.
+   */
+  uint32_t                      result;
+} sb_cqe_t;
+
+/**
+ * @brief   Type of a batch requests dispatcher.
+ *
+ * @param[in] p         dispatcher argument
+ * @param[in] sqep      pointer to a private copy of the submission entry
+ * @return              The value to be posted in the completion entry.
+ */
+typedef uint32_t (*sb_batch_dispatch_t)(void *p, const sb_sqe_t *sqep);
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the shared area required by a batch.
+ *
+ * @param[in] n         number of entries, it must be a power of two
+ */
+#define SB_BATCH_AREA_SIZE(n)                                               \
+  (sizeof (sb_batch_header_t) +                                             \
+   ((size_t)(n) * (sizeof (sb_sqe_t) + sizeof (sb_cqe_t))))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Executes the requests queued in a batch.
+ * @details Requests are executed in order as long as there is space in the
+ *          completion ring. Requests with an invalid SVC number or
+ *          requesting the batch services are completed with
+ *          @p SB_ERR_EINVAL without being dispatched.
+ * @note    Counters are sampled once, services could write in the shared
+ *          area and the number of executed requests must be bounded
+ *          anyway. Inconsistent counters result in no requests executed.
+ * @note    Each entry is copied before being dispatched, the dispatcher
+ *          only sees values that cannot change while it runs.
+ *
+ * @param[in] bhp       pointer to the shared header, the area must have
+ *                      been validated for the specified number of entries
+ * @param[in] size      number of entries in the rings, it is a power of
+ *                      two and it is not taken from the shared area
+ * @param[in] dispatch  requests dispatcher
+ * @param[in] p         dispatcher argument
+ * @return              The number of executed requests.
+ *
+ * @notapi
+ */
+static inline uint32_t sb_batch_execute(sb_batch_header_t *bhp,
+                                        uint32_t size,
+                                        sb_batch_dispatch_t dispatch,
+                                        void *p) {
+  uint32_t mask, sq_tail, cq_head, n, cq_free, i, result;
+  const sb_sqe_t *sq;
+  sb_cqe_t *cq;
+
+  mask = size - 1U;
+  sq   = (const sb_sqe_t *)(bhp + 1);
+  cq   = (sb_cqe_t *)&sq[size];
+
+  sq_tail = bhp->sq_tail;
+  cq_head = bhp->cq_head;
+  n = bhp->sq_head - sq_tail;
+  cq_free = size - (cq_head - bhp->cq_tail);
+  if ((n > size) || (cq_free > size)) {
+    n = 0U;
+  }
+  else if (n > cq_free) {
+    n = cq_free;
+  }
+
+  for (i = 0U; i < n; i++) {
+    sb_sqe_t sqe = sq[sq_tail & mask];
+
+    if ((sqe.svc > (uint32_t)SB_BATCH_SVC_MAX) ||
+        (sqe.svc == (uint32_t)SB_BATCH_SVC_SETUP) ||
+        (sqe.svc == (uint32_t)SB_BATCH_SVC_SUBMIT)) {
+      result = SB_ERR_EINVAL;
+    }
+    else {
+      result = dispatch(p, &sqe);
+    }
+
+    cq[cq_head & mask].user   = sqe.user;
+    cq[cq_head & mask].result = result;
+    sq_tail++;
+    cq_head++;
+    bhp->sq_tail = sq_tail;
+    bhp->cq_head = cq_head;
+  }
+
+  return n;
+}
+
+#endif /* SBBATCH_H */
+
+/** @} */
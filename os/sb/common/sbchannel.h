@@ -0,0 +1,393 @@
+/*
+    ChibiOS - Copyright (C) 2006,2007,2008,2009,2010,2011,2012,2013,2014,
+              2015,2016,2017,2018,2019,2020,2021 Giovanni Di Sirio.
+
+    This file is part of ChibiOS.
+
+    ChibiOS is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation version 3 of the License.
+
+    ChibiOS is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file    sb/common/sbchannel.h
+ * @brief   ARMv7-M sandbox shared channels macros and structures.
+ * @details A channel is a single producer, single consumer ring buffer
+ *          located in a sandbox writable region, both the host and the
+ *          sandbox access it directly without going through the syscall
+ *          interface. The header contains free running counters, each one
+ *          written by one side only.
+ * @note    The host cannot trust the content of the shared header, the
+ *          buffer size is kept in the private channel descriptor and
+ *          counters are always masked and checked, a corrupted header
+ *          can only affect the data exchanged by the sandbox itself.
+ *
+ * @addtogroup ARM_SANDBOX_CHANNELS
+ * @{
+ */
+
+#ifndef SBCHANNEL_H
+#define SBCHANNEL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the shared channel header.
+ */
+#define SB_CHANNEL_HEADER_SIZE          sizeof (sb_channel_header_t)
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Type of a channel header in shared memory.
+ * @note    The data buffer follows the header.
+ */
+typedef struct {
+  /**
+   * @brief   Free running write counter, written by the producer.
+   */
+  uint32_t                      head;
+  /**
+   * @brief   Free running read counter, written by the consumer.
+   */
+  uint32_t                      tail;
+  /**
+   * @brief   Size of the data buffer, written by the host.
+   */
+  uint32_t                      size;
+  /**
+   * @brief   Reserved, keeps the buffer aligned to 64 bits.
+   */
+  uint32_t                      reserved;
+} sb_channel_header_t;
+
+/**
+ * @brief   Type of a private view of a channel.
+ * @note    Each side keeps its own copy, the host one is initialized from
+ *          trusted parameters and not from the shared header.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the shared header.
+   */
+  sb_channel_header_t           *hdr;
+  /**
+   * @brief   Pointer to the data buffer.
+   */
+  uint8_t                       *buffer;
+  /**
+   * @brief   Size of the data buffer, it is a power of two.
+   */
+  uint32_t                      size;
+} sb_ring_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the shared area required by a channel.
+ *
+ * @param[in] n         size of the data buffer, it must be a power of two
+ */
+#define SB_CHANNEL_AREA_SIZE(n)         (SB_CHANNEL_HEADER_SIZE + (size_t)(n))
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+/**
+ * @brief   Initializes a private view of a channel.
+ *
+ * @param[out] rp       pointer to the @p sb_ring_t object
+ * @param[in] p         pointer to the shared area
+ * @param[in] size      size of the data buffer, it must be a power of two
+ *
+ * @notapi
+ */
+static inline void sb_ring_init(sb_ring_t *rp, void *p, uint32_t size) {
+
+  rp->hdr    = (sb_channel_header_t *)p;
+  rp->buffer = (uint8_t *)p + SB_CHANNEL_HEADER_SIZE;
+  rp->size   = size;
+}
+
+/**
+ * @brief   Resets the shared header of a channel.
+ * @note    Only the host resets channels, before handing them to the
+ *          sandbox.
+ *
+ * @param[in] rp        pointer to the @p sb_ring_t object
+ *
+ * @notapi
+ */
+static inline void sb_ring_reset(sb_ring_t *rp) {
+
+  rp->hdr->head     = 0U;
+  rp->hdr->tail     = 0U;
+  rp->hdr->size     = rp->size;
+  rp->hdr->reserved = 0U;
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+/**
+ * @brief   Returns the number of bytes in a channel.
+ * @note    A corrupted header is reported as a full channel.
+ *
+ * @param[in] rp        pointer to the @p sb_ring_t object
+ * @return              The number of bytes ready to be read.
+ *
+ * @notapi
+ */
+static inline uint32_t sb_ring_get_used(sb_ring_t *rp) {
+  uint32_t used;
+
+  used = __atomic_load_n(&rp->hdr->head, __ATOMIC_ACQUIRE) -
+         __atomic_load_n(&rp->hdr->tail, __ATOMIC_ACQUIRE);
+  if (used > rp->size) {
+    used = rp->size;
+  }
+
+  return used;
+}
+
+/**
+ * @brief   Returns the contiguous free space in a channel.
+ * @details The returned area can be filled in place and then published
+ *          using @p sb_ring_write_commit().
+ *
+ * @param[in] rp        pointer to the @p sb_ring_t object
+ * @param[out] pp       pointer to the free area
+ * @return              The size of the contiguous free area.
+ * @retval 0            if the channel is full or its header is corrupted.
+ *
+ * @notapi
+ */
+static inline size_t sb_ring_write_span(sb_ring_t *rp, uint8_t **pp) {
+  uint32_t head, used, offset, n;
+
+  head = __atomic_load_n(&rp->hdr->head, __ATOMIC_RELAXED);
+  used = head - __atomic_load_n(&rp->hdr->tail, __ATOMIC_ACQUIRE);
+  if (used >= rp->size) {
+    return (size_t)0;
+  }
+
+  offset = head & (rp->size - 1U);
+  n = rp->size - used;
+  if (n > rp->size - offset) {
+    n = rp->size - offset;
+  }
+  *pp = &rp->buffer[offset];
+
+  return (size_t)n;
+}
+
+/**
+ * @brief   Publishes data written in the area returned by
+ *          @p sb_ring_write_span().
+ *
+ * @param[in] rp        pointer to the @p sb_ring_t object
+ * @param[in] n         number of bytes to be published, it must not exceed
+ *                      the size returned by @p sb_ring_write_span()
+ * @return              The doorbell state.
+ * @retval false        if the consumer does not need to be notified.
+ * @retval true         if the consumer could be waiting for data.
+ *
+ * @notapi
+ */
+static inline bool sb_ring_write_commit(sb_ring_t *rp, size_t n) {
+  uint32_t head;
+
+  head = __atomic_load_n(&rp->hdr->head, __ATOMIC_RELAXED);
+  __atomic_store_n(&rp->hdr->head, head + (uint32_t)n, __ATOMIC_RELEASE);
+
+  /* The tail is read after publishing the new head, if the consumer
+     emptied the channel before seeing it then it could be sleeping.*/
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+  return __atomic_load_n(&rp->hdr->tail, __ATOMIC_RELAXED) == head;
+}
+
+/**
+ * @brief   Returns the contiguous data in a channel.
+ * @details The returned area can be processed in place and then released
+ *          using @p sb_ring_read_release().
+ *
+ * @param[in] rp        pointer to the @p sb_ring_t object
+ * @param[out] pp       pointer to the data area
+ * @return              The size of the contiguous data area.
+ * @retval 0            if the channel is empty or its header is corrupted.
+ *
+ * @notapi
+ */
+static inline size_t sb_ring_read_span(sb_ring_t *rp, const uint8_t **pp) {
+  uint32_t tail, used, offset, n;
+
+  tail = __atomic_load_n(&rp->hdr->tail, __ATOMIC_RELAXED);
+  used = __atomic_load_n(&rp->hdr->head, __ATOMIC_ACQUIRE) - tail;
+  if ((used == 0U) || (used > rp->size)) {
+    return (size_t)0;
+  }
+
+  offset = tail & (rp->size - 1U);
+  n = used;
+  if (n > rp->size - offset) {
+    n = rp->size - offset;
+  }
+  *pp = &rp->buffer[offset];
+
+  return (size_t)n;
+}
+
+/**
+ * @brief   Releases data returned by @p sb_ring_read_span().
+ *
+ * @param[in] rp        pointer to the @p sb_ring_t object
+ * @param[in] n         number of bytes to be released, it must not exceed
+ *                      the size returned by @p sb_ring_read_span()
+ * @return              The doorbell state.
+ * @retval false        if the producer does not need to be notified.
+ * @retval true         if the producer could be waiting for space.
+ *
+ * @notapi
+ */
+static inline bool sb_ring_read_release(sb_ring_t *rp, size_t n) {
+  uint32_t tail;
+
+  tail = __atomic_load_n(&rp->hdr->tail, __ATOMIC_RELAXED);
+  __atomic_store_n(&rp->hdr->tail, tail + (uint32_t)n, __ATOMIC_RELEASE);
+
+  /* The head is read after publishing the new tail, if the channel was
+     full then the producer could be sleeping.*/
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+  return (__atomic_load_n(&rp->hdr->head, __ATOMIC_RELAXED) - tail) >=
+         rp->size;
+}
+
+/**
+ * @brief   Copies data into a channel.
+ * @details Data is written as long as there is space, the write is
+ *          published once.
+ *
+ * @param[in] rp        pointer to the @p sb_ring_t object
+ * @param[in] bp        pointer to the data
+ * @param[in] n         number of bytes to be written
+ * @param[out] dbp      doorbell state, see @p sb_ring_write_commit()
+ * @return              The number of bytes written.
+ *
+ * @notapi
+ */
+static inline size_t sb_ring_write(sb_ring_t *rp, const uint8_t *bp,
+                                   size_t n, bool *dbp) {
+  uint32_t head, used, offset, done, chunk;
+
+  *dbp = false;
+
+  head = __atomic_load_n(&rp->hdr->head, __ATOMIC_RELAXED);
+  used = head - __atomic_load_n(&rp->hdr->tail, __ATOMIC_ACQUIRE);
+  if (used >= rp->size) {
+    return (size_t)0;
+  }
+  if (n > (size_t)(rp->size - used)) {
+    n = (size_t)(rp->size - used);
+  }
+
+  /* At most two chunks because wrapping.*/
+  done = 0U;
+  while (done < (uint32_t)n) {
+    offset = (head + done) & (rp->size - 1U);
+    chunk = (uint32_t)n - done;
+    if (chunk > rp->size - offset) {
+      chunk = rp->size - offset;
+    }
+    memcpy(&rp->buffer[offset], bp + done, (size_t)chunk);
+    done += chunk;
+  }
+
+  if (n > (size_t)0) {
+    *dbp = sb_ring_write_commit(rp, n);
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Copies data from a channel.
+ * @details Data is read as long as it is available, the space is released
+ *          once.
+ *
+ * @param[in] rp        pointer to the @p sb_ring_t object
+ * @param[out] bp       pointer to the buffer
+ * @param[in] n         maximum number of bytes to be read
+ * @param[out] dbp      doorbell state, see @p sb_ring_read_release()
+ * @return              The number of bytes read.
+ *
+ * @notapi
+ */
+static inline size_t sb_ring_read(sb_ring_t *rp, uint8_t *bp,
+                                  size_t n, bool *dbp) {
+  uint32_t tail, used, offset, done, chunk;
+
+  *dbp = false;
+
+  tail = __atomic_load_n(&rp->hdr->tail, __ATOMIC_RELAXED);
+  used = __atomic_load_n(&rp->hdr->head, __ATOMIC_ACQUIRE) - tail;
+  if ((used == 0U) || (used > rp->size)) {
+    return (size_t)0;
+  }
+  if (n > (size_t)used) {
+    n = (size_t)used;
+  }
+
+  /* At most two chunks because wrapping.*/
+  done = 0U;
+  while (done < (uint32_t)n) {
+    offset = (tail + done) & (rp->size - 1U);
+    chunk = (uint32_t)n - done;
+    if (chunk > rp->size - offset) {
+      chunk = rp->size - offset;
+    }
+    memcpy(bp + done, &rp->buffer[offset], (size_t)chunk);
+    done += chunk;
+  }
+
+  if (n > (size_t)0) {
+    *dbp = sb_ring_read_release(rp, n);
+  }
+
+  return n;
+}
+
+#endif /* SBCHANNEL_H */
+
+/** @} */
@@ -52,8 +52,15 @@
 #define SB_SVC9_HANDLER         sb_api_wait_any_timeout
 #define SB_SVC10_HANDLER        sb_api_wait_all_timeout
 #define SB_SVC11_HANDLER        sb_api_broadcast_flags
+#define SB_SVC12_HANDLER        sb_api_batch_setup
+#define SB_SVC13_HANDLER        sb_api_batch_submit
 /** @} */
 
+/**
+ * @brief   Maximum number of entries in batch rings.
+ */
+#define SB_BATCH_MAX_ENTRIES    256U
+
 #define __SVC(x) asm volatile ("svc " #x)
 
 /*
@@ -918,6 +925,20 @@ static void sb_undef_handler(struct port_extctx *ectxp) {
   ectxp->r0 = SB_ERR_ENOSYS;
 }
 
+static uint32_t sb_batch_dispatch(void *p, const sb_sqe_t *sqep) {
+  struct port_extctx ctx = *(const struct port_extctx *)p;
+
+  /* Requests are served by the same handlers of the equivalent SVCs,
+     using a copy of the caller context.*/
+  ctx.r0 = sqep->r[0];
+  ctx.r1 = sqep->r[1];
+  ctx.r2 = sqep->r[2];
+  ctx.r3 = sqep->r[3];
+  sb_syscalls[sqep->svc](&ctx);
+
+  return ctx.r0;
+}
+
 /*===========================================================================*/
 /* Module exported functions.                                                */
 /*===========================================================================*/
@@ -1064,4 +1085,51 @@ void sb_api_broadcast_flags(struct port_extctx *ectxp) {
 #endif
 }
 
+void sb_api_batch_setup(struct port_extctx *ectxp) {
+  sb_class_t *sbcp = (sb_class_t *)chThdGetSelfX()->ctx.syscall.p;
+  sb_batch_header_t *bhp = (sb_batch_header_t *)ectxp->r0;
+  uint32_t n = ectxp->r1;
+
+  /* Zero entries releases the batch.*/
+  if (n == 0U) {
+    sbcp->batch      = NULL;
+    sbcp->batch_size = 0U;
+    ectxp->r0 = SB_ERR_NOERROR;
+    return;
+  }
+
+  if (((n & (n - 1U)) != 0U) || (n > SB_BATCH_MAX_ENTRIES)) {
+    ectxp->r0 = SB_ERR_EINVAL;
+    return;
+  }
+
+  /* The area is validated once here, submissions only access it through
+     masked indexes.*/
+  if ((((uint32_t)bhp & 3U) != 0U) ||
+      !sb_is_valid_write_range(sbcp, (void *)bhp, SB_BATCH_AREA_SIZE(n))) {
+    ectxp->r0 = SB_ERR_EFAULT;
+    return;
+  }
+
+  bhp->sq_head = 0U;
+  bhp->sq_tail = 0U;
+  bhp->cq_head = 0U;
+  bhp->cq_tail = 0U;
+  sbcp->batch      = bhp;
+  sbcp->batch_size = n;
+  ectxp->r0 = SB_ERR_NOERROR;
+}
+
+void sb_api_batch_submit(struct port_extctx *ectxp) {
+  sb_class_t *sbcp = (sb_class_t *)chThdGetSelfX()->ctx.syscall.p;
+
+  if (sbcp->batch == NULL) {
+    ectxp->r0 = SB_ERR_EINVAL;
+    return;
+  }
+
+  ectxp->r0 = sb_batch_execute(sbcp->batch, sbcp->batch_size,
+                               sb_batch_dispatch, (void *)ectxp);
+}
+
 /** @} */
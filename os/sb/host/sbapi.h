@@ -114,6 +114,8 @@ extern "C" {
   void sb_api_wait_any_timeout(struct port_extctx *ctxp);
   void sb_api_wait_all_timeout(struct port_extctx *ctxp);
   void sb_api_broadcast_flags(struct port_extctx *ctxp);
+  void sb_api_batch_setup(struct port_extctx *ctxp);
+  void sb_api_batch_submit(struct port_extctx *ctxp);
 #ifdef __cplusplus
 }
 #endif
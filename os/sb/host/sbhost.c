@@ -48,36 +48,46 @@
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
-/*===========================================================================*/
-/* Module exported functions.                                                */
-/*===========================================================================*/
-
-bool sb_is_valid_read_range(sb_class_t *sbcp, const void *start, size_t size) {
-  const sb_memory_region_t *rp = &sbcp->config->regions[0];
+static const sb_memory_region_t *find_region(const sb_config_t *config,
+                                             const void *start,
+                                             size_t size) {
+  const sb_memory_region_t *rp = &config->regions[0];
 
   do {
     if (((uint32_t)start >= rp->base) && ((uint32_t)start < rp->end) &&
-        (size <= ((size_t)rp->base - (size_t)start))) {
-      return true;
+        (size <= ((size_t)rp->end - (size_t)start))) {
+      return rp;
     }
     rp++;
-  } while (rp < &sbcp->config->regions[SB_NUM_REGIONS]);
+  } while (rp < &config->regions[SB_NUM_REGIONS]);
 
-  return false;
+  return NULL;
 }
 
-bool sb_is_valid_write_range(sb_class_t *sbcp, void *start, size_t size) {
-  const sb_memory_region_t *rp = &sbcp->config->regions[0];
+#if CH_CFG_USE_EVENTS == TRUE
+static void channel_doorbell(sb_channel_t *chp) {
 
-  do {
-    if (((uint32_t)start >= rp->base) && ((uint32_t)start < rp->end) &&
-        (size <= ((size_t)rp->base - (size_t)start))) {
-      return rp->writeable;
-    }
-    rp++;
-  } while (rp < &sbcp->config->regions[SB_NUM_REGIONS]);
+  /* If the sandbox has not been started yet then there is nobody to
+     notify, it will find the data when looking at the channel.*/
+  if (chp->sbcp->tp != NULL) {
+    sbEvtSignal(chp->sbcp, chp->events);
+  }
+}
+#endif
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+bool sb_is_valid_read_range(sb_class_t *sbcp, const void *start, size_t size) {
 
-  return false;
+  return find_region(sbcp->config, start, size) != NULL;
+}
+
+bool sb_is_valid_write_range(sb_class_t *sbcp, void *start, size_t size) {
+  const sb_memory_region_t *rp = find_region(sbcp->config, start, size);
+
+  return (rp != NULL) && rp->writeable;
 }
 
 /**
@@ -97,6 +107,8 @@ void sbObjectInit(sb_class_t *sbcp) {
 #if CH_CFG_USE_EVENTS == TRUE
   chEvtObjectInit(&sbcp->es);
 #endif
+  sbcp->batch      = NULL;
+  sbcp->batch_size = 0U;
 }
 
 /**
@@ -190,4 +202,149 @@ msg_t sbSendMessageTimeout(sb_class_t *sbcp,
 }
 #endif /* CH_CFG_USE_MESSAGES == TRUE */
 
+#if (CH_CFG_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Channel object initialization.
+ * @details The shared area must be located in a writable region of the
+ *          sandbox, it is validated once here so data transfers do not
+ *          require any further check. The shared header is reset, the
+ *          area can then be handed to the sandbox, for example sending
+ *          its address as a message.
+ * @note    Each channel is unidirectional, the host can be either the
+ *          producer or the consumer. A sandbox notifies the host by
+ *          broadcasting flags on the sandbox event source.
+ *
+ * @param[out] chp      pointer to the @p sb_channel_t object
+ * @param[in] sbcp      pointer to the sandbox object
+ * @param[in] config    configuration of the sandbox, it can be used before
+ *                      the sandbox is started
+ * @param[in] p         pointer to the shared area, it must be aligned to
+ *                      32 bits
+ * @param[in] size      size of the data buffer, it must be a power of two,
+ *                      the shared area size is given by
+ *                      @p SB_CHANNEL_AREA_SIZE()
+ * @param[in] events    events signaled to the sandbox when data is
+ *                      written or space is released by the host
+ * @return              The operation status.
+ * @retval SB_ERR_NOERROR if the channel has been initialized.
+ * @retval SB_ERR_EINVAL  if the size is not valid.
+ * @retval SB_ERR_EFAULT  if the area is not in a sandbox writable region.
+ *
+ * @api
+ */
+uint32_t sbChannelObjectInit(sb_channel_t *chp,
+                             sb_class_t *sbcp,
+                             const sb_config_t *config,
+                             void *p,
+                             size_t size,
+                             eventmask_t events) {
+  const sb_memory_region_t *rp;
+
+  chDbgCheck((chp != NULL) && (sbcp != NULL) && (config != NULL));
+
+  if ((size == (size_t)0) || ((size & (size - (size_t)1)) != (size_t)0) ||
+      (size > (size_t)0x80000000U)) {
+    return SB_ERR_EINVAL;
+  }
+
+  rp = find_region(config, p, SB_CHANNEL_AREA_SIZE(size));
+  if ((rp == NULL) || !rp->writeable || (((uint32_t)p & 3U) != 0U)) {
+    return SB_ERR_EFAULT;
+  }
+
+  chp->sbcp   = sbcp;
+  chp->events = events;
+  sb_ring_init(&chp->ring, p, (uint32_t)size);
+  sb_ring_reset(&chp->ring);
+
+  return SB_ERR_NOERROR;
+}
+
+/**
+ * @brief   Writes data into a channel.
+ * @details The function does not block, the sandbox is notified if it
+ *          could be waiting for data.
+ *
+ * @param[in] chp       pointer to the @p sb_channel_t object
+ * @param[in] bp        pointer to the data
+ * @param[in] n         number of bytes to be written
+ * @return              The number of bytes written.
+ *
+ * @api
+ */
+size_t sbChannelWrite(sb_channel_t *chp, const uint8_t *bp, size_t n) {
+  bool doorbell;
+
+  chDbgCheck((chp != NULL) && (bp != NULL));
+
+  n = sb_ring_write(&chp->ring, bp, n, &doorbell);
+  if (doorbell) {
+    channel_doorbell(chp);
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Reads data from a channel.
+ * @details The function does not block, the sandbox is notified if it
+ *          could be waiting for space.
+ *
+ * @param[in] chp       pointer to the @p sb_channel_t object
+ * @param[out] bp       pointer to the buffer
+ * @param[in] n         maximum number of bytes to be read
+ * @return              The number of bytes read.
+ *
+ * @api
+ */
+size_t sbChannelRead(sb_channel_t *chp, uint8_t *bp, size_t n) {
+  bool doorbell;
+
+  chDbgCheck((chp != NULL) && (bp != NULL));
+
+  n = sb_ring_read(&chp->ring, bp, n, &doorbell);
+  if (doorbell) {
+    channel_doorbell(chp);
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Publishes data written in place.
+ *
+ * @param[in] chp       pointer to the @p sb_channel_t object
+ * @param[in] n         number of bytes to be published, it must not exceed
+ *                      the size returned by @p sbChannelGetWriteBufferX()
+ *
+ * @api
+ */
+void sbChannelCommit(sb_channel_t *chp, size_t n) {
+
+  chDbgCheck(chp != NULL);
+
+  if ((n > (size_t)0) && sb_ring_write_commit(&chp->ring, n)) {
+    channel_doorbell(chp);
+  }
+}
+
+/**
+ * @brief   Releases data processed in place.
+ *
+ * @param[in] chp       pointer to the @p sb_channel_t object
+ * @param[in] n         number of bytes to be released, it must not exceed
+ *                      the size returned by @p sbChannelGetReadBufferX()
+ *
+ * @api
+ */
+void sbChannelRelease(sb_channel_t *chp, size_t n) {
+
+  chDbgCheck(chp != NULL);
+
+  if ((n > (size_t)0) && sb_ring_read_release(&chp->ring, n)) {
+    channel_doorbell(chp);
+  }
+}
+#endif /* CH_CFG_USE_EVENTS == TRUE */
+
 /** @} */
@@ -30,6 +30,8 @@
 
 #include "sberr.h"
 #include "sbapi.h"
+#include "sbchannel.h"
+#include "sbbatch.h"
 
 /*===========================================================================*/
 /* Module constants.                                                         */
@@ -136,8 +138,36 @@ typedef struct {
 #if (CH_CFG_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
   event_source_t                es;
 #endif
+  /**
+   * @brief   Batch shared area or @p NULL if not set up.
+   */
+  sb_batch_header_t             *batch;
+  /**
+   * @brief   Number of entries in the batch rings.
+   */
+  uint32_t                      batch_size;
 } sb_class_t;
 
+#if (CH_CFG_USE_EVENTS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Type of a host side channel descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   Sandbox owning the shared area.
+   */
+  sb_class_t                    *sbcp;
+  /**
+   * @brief   Private view of the shared ring buffer.
+   */
+  sb_ring_t                     ring;
+  /**
+   * @brief   Events signaled to the sandbox as doorbell.
+   */
+  eventmask_t                   events;
+} sb_channel_t;
+#endif
+
 /**
  * @brief   Type of a sandbox binary image header.
  */
@@ -179,6 +209,18 @@ extern "C" {
   msg_t sbSendMessageTimeout(sb_class_t *sbcp,
                              msg_t msg,
                              sysinterval_t timeout);
+#if CH_CFG_USE_EVENTS == TRUE
+  uint32_t sbChannelObjectInit(sb_channel_t *chp,
+                               sb_class_t *sbcp,
+                               const sb_config_t *config,
+                               void *p,
+                               size_t size,
+                               eventmask_t events);
+  size_t sbChannelWrite(sb_channel_t *chp, const uint8_t *bp, size_t n);
+  size_t sbChannelRead(sb_channel_t *chp, uint8_t *bp, size_t n);
+  void sbChannelCommit(sb_channel_t *chp, size_t n);
+  void sbChannelRelease(sb_channel_t *chp, size_t n);
+#endif
 #ifdef __cplusplus
 }
 #endif
@@ -262,6 +304,55 @@ static inline event_source_t *sbGetEventSourceX(sb_class_t *sbcp) {
 
   return &sbcp->es;
 }
+
+/**
+ * @brief   Returns the number of bytes in a channel.
+ *
+ * @param[in] chp       pointer to the @p sb_channel_t object
+ * @return              The number of bytes ready to be read.
+ *
+ * @xclass
+ */
+static inline size_t sbChannelGetUsedX(sb_channel_t *chp) {
+
+  return (size_t)sb_ring_get_used(&chp->ring);
+}
+
+/**
+ * @brief   Returns the contiguous free space in a channel.
+ * @details The area can be filled in place, the data is then published
+ *          using @p sbChannelCommit().
+ *
+ * @param[in] chp       pointer to the @p sb_channel_t object
+ * @param[out] pp       pointer to the free area
+ * @return              The size of the contiguous free area.
+ * @retval 0            if the channel is full.
+ *
+ * @xclass
+ */
+static inline size_t sbChannelGetWriteBufferX(sb_channel_t *chp,
+                                              uint8_t **pp) {
+
+  return sb_ring_write_span(&chp->ring, pp);
+}
+
+/**
+ * @brief   Returns the contiguous data in a channel.
+ * @details The area can be processed in place, it is then released using
+ *          @p sbChannelRelease().
+ *
+ * @param[in] chp       pointer to the @p sb_channel_t object
+ * @param[out] pp       pointer to the data area
+ * @return              The size of the contiguous data area.
+ * @retval 0            if the channel is empty.
+ *
+ * @xclass
+ */
+static inline size_t sbChannelGetReadBufferX(sb_channel_t *chp,
+                                             const uint8_t **pp) {
+
+  return sb_ring_read_span(&chp->ring, pp);
+}
 #endif /* CH_CFG_USE_EVENTS == TRUE */
 
 #endif /* SBHOST_H */
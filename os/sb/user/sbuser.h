@@ -29,6 +29,8 @@
 #define SBUSER_H
 
 #include "sberr.h"
+#include "sbchannel.h"
+#include "sbbatch.h"
 
 /*===========================================================================*/
 /* Module constants.                                                         */
@@ -101,6 +103,42 @@ typedef struct {
   time_conv_t               frequency;
 } sbapi_state_t;
 
+/**
+ * @brief   Type of a sandbox side channel descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   Private view of the shared ring buffer.
+   */
+  sb_ring_t                 ring;
+  /**
+   * @brief   Flags broadcasted to the host as doorbell.
+   */
+  eventflags_t              flags;
+} sb_channel_t;
+
+/**
+ * @brief   Type of a batch descriptor.
+ */
+typedef struct {
+  /**
+   * @brief   Pointer to the shared header.
+   */
+  sb_batch_header_t         *hdr;
+  /**
+   * @brief   Submission ring.
+   */
+  sb_sqe_t                  *sq;
+  /**
+   * @brief   Completion ring.
+   */
+  sb_cqe_t                  *cq;
+  /**
+   * @brief   Number of entries in each ring.
+   */
+  uint32_t                  size;
+} sb_batch_t;
+
 /*===========================================================================*/
 /* Module macros.                                                            */
 /*===========================================================================*/
@@ -664,6 +702,305 @@ static inline void sbSleepMicroseconds(time_usecs_t usecs) {
   sbSleep(sbTimeUS2I(usecs));
 }
 
+/**
+ * @brief   Channel object initialization.
+ * @details Attaches to a shared area previously initialized by the host,
+ *          the area address is usually received as a message.
+ *
+ * @param[out] chp      pointer to the @p sb_channel_t object
+ * @param[in] p         pointer to the shared area
+ * @param[in] flags     flags broadcasted to the host when data is written
+ *                      or space is released by the sandbox
+ *
+ * @api
+ */
+static inline void sbChannelObjectInit(sb_channel_t *chp,
+                                       void *p,
+                                       eventflags_t flags) {
+
+  sb_ring_init(&chp->ring, p, ((sb_channel_header_t *)p)->size);
+  chp->flags = flags;
+}
+
+/**
+ * @brief   Returns the number of bytes in a channel.
+ *
+ * @param[in] chp       pointer to the @p sb_channel_t object
+ * @return              The number of bytes ready to be read.
+ *
+ * @api
+ */
+static inline size_t sbChannelGetUsed(sb_channel_t *chp) {
+
+  return (size_t)sb_ring_get_used(&chp->ring);
+}
+
+/**
+ * @brief   Writes data into a channel.
+ * @details The data is copied directly into the shared area, a syscall
+ *          is performed only if the host could be waiting for data.
+ *
+ * @param[in] chp       pointer to the @p sb_channel_t object
+ * @param[in] bp        pointer to the data
+ * @param[in] n         number of bytes to be written
+ * @return              The number of bytes written.
+ *
+ * @api
+ */
+static inline size_t sbChannelWrite(sb_channel_t *chp,
+                                    const uint8_t *bp,
+                                    size_t n) {
+  bool doorbell;
+
+  n = sb_ring_write(&chp->ring, bp, n, &doorbell);
+  if (doorbell) {
+    (void) sbEventBroadcastFlags(chp->flags);
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Reads data from a channel.
+ * @details The data is copied directly from the shared area, a syscall
+ *          is performed only if the host could be waiting for space.
+ *
+ * @param[in] chp       pointer to the @p sb_channel_t object
+ * @param[out] bp       pointer to the buffer
+ * @param[in] n         maximum number of bytes to be read
+ * @return              The number of bytes read.
+ *
+ * @api
+ */
+static inline size_t sbChannelRead(sb_channel_t *chp,
+                                   uint8_t *bp,
+                                   size_t n) {
+  bool doorbell;
+
+  n = sb_ring_read(&chp->ring, bp, n, &doorbell);
+  if (doorbell) {
+    (void) sbEventBroadcastFlags(chp->flags);
+  }
+
+  return n;
+}
+
+/**
+ * @brief   Returns the contiguous free space in a channel.
+ * @details The area can be filled in place, the data is then published
+ *          using @p sbChannelCommit().
+ *
+ * @param[in] chp       pointer to the @p sb_channel_t object
+ * @param[out] pp       pointer to the free area
+ * @return              The size of the contiguous free area.
+ * @retval 0            if the channel is full.
+ *
+ * @api
+ */
+static inline size_t sbChannelGetWriteBuffer(sb_channel_t *chp,
+                                             uint8_t **pp) {
+
+  return sb_ring_write_span(&chp->ring, pp);
+}
+
+/**
+ * @brief   Publishes data written in place.
+ *
+ * @param[in] chp       pointer to the @p sb_channel_t object
+ * @param[in] n         number of bytes to be published, it must not exceed
+ *                      the size returned by @p sbChannelGetWriteBuffer()
+ *
+ * @api
+ */
+static inline void sbChannelCommit(sb_channel_t *chp, size_t n) {
+
+  if ((n > (size_t)0) && sb_ring_write_commit(&chp->ring, n)) {
+    (void) sbEventBroadcastFlags(chp->flags);
+  }
+}
+
+/**
+ * @brief   Returns the contiguous data in a channel.
+ * @details The area can be processed in place, it is then released using
+ *          @p sbChannelRelease().
+ *
+ * @param[in] chp       pointer to the @p sb_channel_t object
+ * @param[out] pp       pointer to the data area
+ * @return              The size of the contiguous data area.
+ * @retval 0            if the channel is empty.
+ *
+ * @api
+ */
+static inline size_t sbChannelGetReadBuffer(sb_channel_t *chp,
+                                            const uint8_t **pp) {
+
+  return sb_ring_read_span(&chp->ring, pp);
+}
+
+/**
+ * @brief   Releases data processed in place.
+ *
+ * @param[in] chp       pointer to the @p sb_channel_t object
+ * @param[in] n         number of bytes to be released, it must not exceed
+ *                      the size returned by @p sbChannelGetReadBuffer()
+ *
+ * @api
+ */
+static inline void sbChannelRelease(sb_channel_t *chp, size_t n) {
+
+  if ((n > (size_t)0) && sb_ring_read_release(&chp->ring, n)) {
+    (void) sbEventBroadcastFlags(chp->flags);
+  }
+}
+
+/**
+ * @brief   Batch object initialization.
+ * @details The shared area is registered with the host, it must be
+ *          located in a writable region and be aligned to 32 bits.
+ *
+ * @param[out] bp       pointer to the @p sb_batch_t object
+ * @param[in] p         pointer to the shared area, its size is given by
+ *                      @p SB_BATCH_AREA_SIZE()
+ * @param[in] n         number of entries, it must be a power of two
+ * @return              An error code.
+ *
+ * @api
+ */
+static inline uint32_t sbBatchObjectInit(sb_batch_t *bp,
+                                         void *p,
+                                         uint32_t n) {
+
+  __syscall2r(12, p, n);
+  if (r0 == SB_ERR_NOERROR) {
+    bp->hdr  = (sb_batch_header_t *)p;
+    bp->sq   = (sb_sqe_t *)(bp->hdr + 1);
+    bp->cq   = (sb_cqe_t *)&bp->sq[n];
+    bp->size = n;
+  }
+  return r0;
+}
+
+/**
+ * @brief   Queues a request.
+ * @details Requests are executed in order by @p sbBatchSubmit(), blocking
+ *          services delay the execution of the following requests.
+ *
+ * @param[in] bp        pointer to the @p sb_batch_t object
+ * @param[in] svc       SVC number of the service
+ * @param[in] r0        value of register R0 for the service
+ * @param[in] r1        value of register R1 for the service
+ * @param[in] r2        value of register R2 for the service
+ * @param[in] r3        value of register R3 for the service
+ * @param[in] user      user data returned in the completion entry
+ * @return              The operation status.
+ * @retval false        if the submission ring is full.
+ * @retval true         if the request has been queued.
+ *
+ * @api
+ */
+static inline bool sbBatchAdd(sb_batch_t *bp, uint32_t svc,
+                              uint32_t r0, uint32_t r1,
+                              uint32_t r2, uint32_t r3,
+                              uint32_t user) {
+  sb_sqe_t *sqep;
+
+  if ((bp->hdr->sq_head - bp->hdr->sq_tail) >= bp->size) {
+    return false;
+  }
+
+  sqep = &bp->sq[bp->hdr->sq_head & (bp->size - 1U)];
+  sqep->svc  = svc;
+  sqep->r[0] = r0;
+  sqep->r[1] = r1;
+  sqep->r[2] = r2;
+  sqep->r[3] = r3;
+  sqep->user = user;
+  bp->hdr->sq_head++;
+
+  return true;
+}
+
+/**
+ * @brief   Queues a Posix-style file read.
+ *
+ * @param[in] bp        pointer to the @p sb_batch_t object
+ * @param[in] fd        file descriptor
+ * @param[in] buf       buffer pointer
+ * @param[in] count     number of bytes
+ * @param[in] user      user data returned in the completion entry
+ * @return              The operation status, see @p sbBatchAdd().
+ *
+ * @api
+ */
+static inline bool sbBatchAddFileRead(sb_batch_t *bp, uint32_t fd,
+                                      uint8_t *buf, size_t count,
+                                      uint32_t user) {
+
+  return sbBatchAdd(bp, 0U, SB_POSIX_READ, fd,
+                    (uint32_t)buf, (uint32_t)count, user);
+}
+
+/**
+ * @brief   Queues a Posix-style file write.
+ *
+ * @param[in] bp        pointer to the @p sb_batch_t object
+ * @param[in] fd        file descriptor
+ * @param[in] buf       buffer pointer
+ * @param[in] count     number of bytes
+ * @param[in] user      user data returned in the completion entry
+ * @return              The operation status, see @p sbBatchAdd().
+ *
+ * @api
+ */
+static inline bool sbBatchAddFileWrite(sb_batch_t *bp, uint32_t fd,
+                                       const uint8_t *buf, size_t count,
+                                       uint32_t user) {
+
+  return sbBatchAdd(bp, 0U, SB_POSIX_WRITE, fd,
+                    (uint32_t)buf, (uint32_t)count, user);
+}
+
+/**
+ * @brief   Executes the queued requests.
+ * @details Requests are executed as long as there is space in the
+ *          completion ring.
+ *
+ * @param[in] bp        pointer to the @p sb_batch_t object
+ * @return              The number of executed requests or an error.
+ *
+ * @api
+ */
+static inline uint32_t sbBatchSubmit(sb_batch_t *bp) {
+
+  (void)bp;
+
+  __syscall0r(13);
+  return r0;
+}
+
+/**
+ * @brief   Fetches a completion entry.
+ *
+ * @param[in] bp        pointer to the @p sb_batch_t object
+ * @param[out] cqep     pointer to the completion entry to be filled
+ * @return              The operation status.
+ * @retval false        if the completion ring is empty.
+ * @retval true         if an entry has been fetched.
+ *
+ * @api
+ */
+static inline bool sbBatchGetCompletion(sb_batch_t *bp, sb_cqe_t *cqep) {
+
+  if (bp->hdr->cq_head == bp->hdr->cq_tail) {
+    return false;
+  }
+
+  *cqep = bp->cq[bp->hdr->cq_tail & (bp->size - 1U)];
+  bp->hdr->cq_tail++;
+
+  return true;
+}
+
 #endif /* SBUSER_H */
 
 /** @} */
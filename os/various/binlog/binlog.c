@@ -0,0 +1,273 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    binlog.c
+ * @brief   Deferred binary log code.
+ * @details Call sites store the address of the format string and the raw
+ *          arguments into a per-core buffer, a low priority thread drains
+ *          the buffers into a stream. Formatting is performed on the host
+ *          side using the strings contained in the ELF file.
+ *
+ * @addtogroup BINLOG
+ * @{
+ */
+
+#include <stdarg.h>
+#include <string.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "binlog.h"
+
+/*===========================================================================*/
+/* Module local definitions.                                                 */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the chunks moved from a buffer to the stream.
+ */
+#define BINLOG_CHUNK_SIZE           64U
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local types.                                                       */
+/*===========================================================================*/
+
+/*===========================================================================*/
+/* Module local variables.                                                   */
+/*===========================================================================*/
+
+static binlog_buffer_t buffers[PORT_CORES_NUMBER];
+static thread_reference_t drain_trp;
+static thread_t *drain_tp;
+static THD_WORKING_AREA(wa_binlog, BINLOG_THREAD_STACK_SIZE);
+
+/*===========================================================================*/
+/* Module local functions.                                                   */
+/*===========================================================================*/
+
+static inline unsigned get_core_id(void) {
+
+#if PORT_CORES_NUMBER > 1
+  return (unsigned)port_get_core_id();
+#else
+  return 0U;
+#endif
+}
+
+static void put32(uint8_t *p, uint32_t w) {
+
+  memcpy(p, &w, sizeof (uint32_t));
+}
+
+static size_t buffer_get(binlog_buffer_t *bp, uint8_t *p, size_t n) {
+  size_t i, full = (size_t)(bp->head - bp->tail);
+
+  if (n > full) {
+    n = full;
+  }
+  for (i = 0U; i < n; i++) {
+    p[i] = bp->buffer[(bp->tail + i) & (BINLOG_BUFFER_SIZE - 1U)];
+  }
+  bp->tail += (uint32_t)n;
+
+  return n;
+}
+
+static THD_FUNCTION(binlog_thread, p) {
+  BaseSequentialStream *stream = (BaseSequentialStream *)p;
+
+  chRegSetThreadName(BINLOG_THREAD_NAME);
+  while (true) {
+    chSysLock();
+    (void) chThdSuspendTimeoutS(&drain_trp, BINLOG_DRAIN_INTERVAL);
+    chSysUnlock();
+
+    (void) binlogDrain(stream);
+  }
+}
+
+/*===========================================================================*/
+/* Module exported functions.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Binary log initialization.
+ *
+ * @init
+ */
+void binlogInit(void) {
+  unsigned i;
+
+  for (i = 0U; i < (unsigned)PORT_CORES_NUMBER; i++) {
+    buffers[i].head    = 0U;
+    buffers[i].tail    = 0U;
+    buffers[i].dropped = 0U;
+  }
+  drain_trp = NULL;
+  drain_tp  = NULL;
+}
+
+/**
+ * @brief   Starts the drain thread.
+ * @details The thread periodically moves the recorded frames to the
+ *          specified stream, it is also awakened when a buffer becomes
+ *          half full.
+ *
+ * @param[in] stream    pointer to a @p BaseSequentialStream object
+ * @param[in] prio      priority of the drain thread, it should be lower
+ *                      than the priority of the logging threads
+ * @return              A pointer to the drain thread.
+ *
+ * @api
+ */
+thread_t *binlogStart(BaseSequentialStream *stream, tprio_t prio) {
+
+  chDbgCheck(stream != NULL);
+  chDbgAssert(drain_tp == NULL, "already started");
+
+  drain_tp = chThdCreateStatic(wa_binlog, sizeof (wa_binlog), prio,
+                               binlog_thread, (void *)stream);
+
+  return drain_tp;
+}
+
+/**
+ * @brief   Records a log entry.
+ * @details The frame is built on the caller stack and then copied into
+ *          the buffer of the current core, if there is not enough space
+ *          then the record is dropped and counted.
+ * @note    Use the @p BLOG() macro rather than calling this function
+ *          directly.
+ * @note    This function can be called from any context.
+ *
+ * @param[in] fmt       format string
+ * @param[in] n         number of arguments
+ * @param[in] ...       arguments, 32 bits values
+ *
+ * @xclass
+ */
+void binlogWrite(const char *fmt, unsigned n, ...) {
+  uint8_t frame[BINLOG_HEADER_SIZE + 4U * BINLOG_MAX_ARGUMENTS];
+  binlog_buffer_t *bp;
+  syssts_t sts;
+  va_list ap;
+  unsigned i, core = get_core_id();
+  size_t size;
+
+  chDbgCheck(n <= BINLOG_MAX_ARGUMENTS);
+
+  /* Building the frame outside the critical zone.*/
+  frame[0] = (uint8_t)BINLOG_SYNC;
+  frame[1] = (uint8_t)(n | (core << 4));
+  put32(&frame[2], (uint32_t)chVTGetSystemTimeX());
+  put32(&frame[6], (uint32_t)(uintptr_t)fmt);
+  va_start(ap, n);
+  for (i = 0U; i < n; i++) {
+    put32(&frame[BINLOG_HEADER_SIZE + 4U * i], va_arg(ap, uint32_t));
+  }
+  va_end(ap);
+  size = BINLOG_HEADER_SIZE + 4U * n;
+
+  bp = &buffers[core];
+  sts = chSysGetStatusAndLockX();
+  if ((size_t)(BINLOG_BUFFER_SIZE - (bp->head - bp->tail)) < size) {
+    bp->dropped++;
+  }
+  else {
+    for (i = 0U; i < size; i++) {
+      bp->buffer[(bp->head + i) & (BINLOG_BUFFER_SIZE - 1U)] = frame[i];
+    }
+    bp->head += (uint32_t)size;
+
+    /* Awakening the drain thread early if the buffer is getting full.*/
+    if ((bp->head - bp->tail) >= (BINLOG_BUFFER_SIZE / 2U)) {
+      chThdResumeI(&drain_trp, MSG_OK);
+    }
+  }
+  chSysRestoreStatusX(sts);
+}
+
+/**
+ * @brief   Moves the recorded frames to a stream.
+ * @details Frames are moved in chunks, the critical zone only covers the
+ *          copy of a chunk from the buffer. If records have been dropped
+ *          then a @p BINLOG_ID_DROPPED frame is emitted after the last
+ *          frame preceding the loss.
+ * @note    This function is invoked by the drain thread, it can also be
+ *          called by the application if the thread is not used.
+ * @note    There must be a single consumer, frames are moved one chunk at
+ *          a time so concurrent drains would interleave partial frames.
+ *          If the drain thread has been started then this function must
+ *          not be called by other threads, else the application must
+ *          call it from a single thread.
+ *
+ * @param[in] stream    pointer to a @p BaseSequentialStream object
+ * @return              The number of bytes written to the stream.
+ *
+ * @api
+ */
+size_t binlogDrain(BaseSequentialStream *stream) {
+  uint8_t chunk[BINLOG_CHUNK_SIZE];
+  size_t n, total = 0U;
+  uint32_t dropped;
+  unsigned i;
+
+  chDbgCheck(stream != NULL);
+  chDbgAssert((drain_tp == NULL) || (chThdGetSelfX() == drain_tp),
+              "drain thread running");
+
+  for (i = 0U; i < (unsigned)PORT_CORES_NUMBER; i++) {
+    binlog_buffer_t *bp = &buffers[i];
+
+    do {
+      chSysLock();
+      n = buffer_get(bp, chunk, sizeof (chunk));
+
+      /* Losses are reported only when the buffer is empty, this way the
+         report does not split a frame.*/
+      dropped = 0U;
+      if (bp->head == bp->tail) {
+        dropped = bp->dropped;
+        bp->dropped = 0U;
+      }
+      chSysUnlock();
+
+      if (n > 0U) {
+        total += streamWrite(stream, chunk, n);
+      }
+
+      if (dropped > 0U) {
+        uint8_t frame[BINLOG_HEADER_SIZE + 4U];
+
+        frame[0] = (uint8_t)BINLOG_SYNC;
+        frame[1] = (uint8_t)(1U | (i << 4));
+        put32(&frame[2], (uint32_t)chVTGetSystemTimeX());
+        put32(&frame[6], (uint32_t)BINLOG_ID_DROPPED);
+        put32(&frame[10], dropped);
+        total += streamWrite(stream, frame, sizeof (frame));
+      }
+    } while (n == sizeof (chunk));
+  }
+
+  return total;
+}
+
+/** @} */
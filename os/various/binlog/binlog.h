@@ -0,0 +1,198 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    binlog.h
+ * @brief   Deferred binary log header.
+ *
+ * @addtogroup BINLOG
+ * @{
+ */
+
+#ifndef BINLOG_H
+#define BINLOG_H
+
+#if defined(BINLOG_CONFIG_FILE)
+#include "binlogconf.h"
+#endif
+
+/*===========================================================================*/
+/* Module constants.                                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Frame synchronization byte.
+ */
+#define BINLOG_SYNC                 0xA5U
+
+/**
+ * @brief   Size of a frame header.
+ * @details The header is composed of the sync byte, a byte containing
+ *          the arguments number in the lower nibble and the core
+ *          identifier in the upper nibble, a 32 bits time stamp and the
+ *          32 bits address of the format string.
+ */
+#define BINLOG_HEADER_SIZE          10U
+
+/**
+ * @brief   Format identifier of frames reporting lost records.
+ * @details Frames with this identifier carry a single argument, the
+ *          number of records dropped because of a full buffer.
+ */
+#define BINLOG_ID_DROPPED           0U
+
+/*===========================================================================*/
+/* Module pre-compile time settings.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Size of the per-core records buffer.
+ * @note    Must be a power of two.
+ */
+#if !defined(BINLOG_BUFFER_SIZE) || defined(__DOXYGEN__)
+#define BINLOG_BUFFER_SIZE          512U
+#endif
+
+/**
+ * @brief   Maximum number of arguments in a record.
+ */
+#if !defined(BINLOG_MAX_ARGUMENTS) || defined(__DOXYGEN__)
+#define BINLOG_MAX_ARGUMENTS        8U
+#endif
+
+/**
+ * @brief   Interval between drain cycles.
+ * @note    The drain thread is also awakened when a buffer is half full.
+ */
+#if !defined(BINLOG_DRAIN_INTERVAL) || defined(__DOXYGEN__)
+#define BINLOG_DRAIN_INTERVAL       TIME_MS2I(50)
+#endif
+
+/**
+ * @brief   Drain thread stack size.
+ */
+#if !defined(BINLOG_THREAD_STACK_SIZE) || defined(__DOXYGEN__)
+#define BINLOG_THREAD_STACK_SIZE    256
+#endif
+
+/**
+ * @brief   Default drain thread name.
+ */
+#if !defined(BINLOG_THREAD_NAME) || defined(__DOXYGEN__)
+#define BINLOG_THREAD_NAME          "binlog"
+#endif
+
+/*===========================================================================*/
+/* Derived constants and error checks.                                       */
+/*===========================================================================*/
+
+#if (BINLOG_BUFFER_SIZE & (BINLOG_BUFFER_SIZE - 1U)) != 0U
+#error "BINLOG_BUFFER_SIZE must be a power of two"
+#endif
+
+#if (BINLOG_MAX_ARGUMENTS < 1U) || (BINLOG_MAX_ARGUMENTS > 15U)
+#error "BINLOG_MAX_ARGUMENTS must be within 1 and 15"
+#endif
+
+#if BINLOG_BUFFER_SIZE < (2U * (BINLOG_HEADER_SIZE + 4U * BINLOG_MAX_ARGUMENTS))
+#error "BINLOG_BUFFER_SIZE too small"
+#endif
+
+#if PORT_CORES_NUMBER > 16
+#error "binary log supports up to 16 cores"
+#endif
+
+/*===========================================================================*/
+/* Module data structures and types.                                         */
+/*===========================================================================*/
+
+/**
+ * @brief   Records buffer of a single core.
+ */
+typedef struct {
+  /**
+   * @brief   Free running write counter.
+   */
+  uint32_t              head;
+  /**
+   * @brief   Free running read counter.
+   */
+  uint32_t              tail;
+  /**
+   * @brief   Number of records dropped since last drain.
+   */
+  uint32_t              dropped;
+  /**
+   * @brief   Records buffer.
+   */
+  uint8_t               buffer[BINLOG_BUFFER_SIZE];
+} binlog_buffer_t;
+
+/*===========================================================================*/
+/* Module macros.                                                            */
+/*===========================================================================*/
+
+/**
+ * @brief   Counts the arguments of a record.
+ *
+ * @notapi
+ */
+#define __BINLOG_NARGS(...)                                                 \
+  __BINLOG_NARGS_(0, ##__VA_ARGS__, 15, 14, 13, 12, 11, 10, 9, 8,           \
+                  7, 6, 5, 4, 3, 2, 1, 0)
+#define __BINLOG_NARGS_(_0, _1, _2, _3, _4, _5, _6, _7, _8,                 \
+                        _9, _10, _11, _12, _13, _14, _15, n, ...) n
+
+/**
+ * @brief   Records a log entry.
+ * @details Only the format string address and the arguments are stored,
+ *          the text is reconstructed by the host using the format strings
+ *          contained in the application ELF file.
+ * @note    Arguments must be 32 bits integers or pointers, strings are
+ *          only supported if located in the ELF file (the host reads them
+ *          from there), floating point numbers are not supported.
+ * @note    This macro can be invoked from any context.
+ *
+ * @param[in] fmt       format string literal
+ * @param[in] ...       arguments
+ *
+ * @xclass
+ */
+#define BLOG(fmt, ...)                                                      \
+  binlogWrite(fmt, __BINLOG_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  void binlogInit(void);
+  thread_t *binlogStart(BaseSequentialStream *stream, tprio_t prio);
+  void binlogWrite(const char *fmt, unsigned n, ...);
+  size_t binlogDrain(BaseSequentialStream *stream);
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Module inline functions.                                                  */
+/*===========================================================================*/
+
+#endif /* BINLOG_H */
+
+/** @} */
@@ -0,0 +1,8 @@
+# Binary log files.
+BINLOGSRC = $(CHIBIOS)/os/various/binlog/binlog.c
+
+BINLOGINC = $(CHIBIOS)/os/various/binlog
+
+# Shared variables
+ALLCSRC += $(BINLOGSRC)
+ALLINC  += $(BINLOGINC)
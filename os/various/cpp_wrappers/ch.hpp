@@ -390,6 +390,10 @@ namespace chibios_rt {
     volatile const syssts_t syssts = chSysGetStatusAndLockX();
 
   public:
+    CriticalSectionLocker() = default;
+    CriticalSectionLocker(const CriticalSectionLocker &) = delete;
+    CriticalSectionLocker &operator=(const CriticalSectionLocker &) = delete;
+
     ~CriticalSectionLocker() {
 
       chSysRestoreStatusX(syssts);
@@ -545,6 +549,48 @@ namespace chibios_rt {
       chVTSetI(&vt, timeout, vtfunc, par);
     }
 
+    /**
+     * @brief   Enables a continuous virtual timer.
+     * @note    The associated function is invoked from interrupt context.
+     *
+     * @param[in] interval  the number of ticks between expirations, the
+     *                      special values are handled as follow:
+     *                      - @a TIME_INFINITE is allowed but interpreted as a
+     *                        normal time specification.
+     *                      - @a TIME_IMMEDIATE this value is not allowed.
+     *                      .
+     * @param[in] vtfunc    the timer callback function
+     * @param[in] par       a parameter that will be passed to the callback
+     *                      function
+     *
+     * @api
+     */
+    void setContinuous(sysinterval_t interval, vtfunc_t vtfunc, void *par) {
+
+      chVTSetContinuous(&vt, interval, vtfunc, par);
+    }
+
+    /**
+     * @brief   Enables a continuous virtual timer.
+     * @note    The associated function is invoked from interrupt context.
+     *
+     * @param[in] interval  the number of ticks between expirations, the
+     *                      special values are handled as follow:
+     *                      - @a TIME_INFINITE is allowed but interpreted as a
+     *                        normal time specification.
+     *                      - @a TIME_IMMEDIATE this value is not allowed.
+     *                      .
+     * @param[in] vtfunc    the timer callback function
+     * @param[in] par       a parameter that will be passed to the callback
+     *                      function
+     *
+     * @iclass
+     */
+    void setContinuousI(sysinterval_t interval, vtfunc_t vtfunc, void *par) {
+
+      chVTSetContinuousI(&vt, interval, vtfunc, par);
+    }
+
     /**
      * @brief   Resets the timer, if armed.
      *
@@ -2107,20 +2153,50 @@ namespace chibios_rt {
    *------------------------------------------------------------------------*/
   /**
    * @brief   RAII helper for mutexes.
+   * @details The locker is move-only, the ownership of the lock can be
+   *          transferred to another locker in the same thread.
+   * @note    Mutexes must be unlocked in reverse lock order, lockers
+   *          declared in nested scopes satisfy this requirement. Moving a
+   *          locker out of its scope or calling @p unlock() early can
+   *          violate it, the order is checked by the kernel when
+   *          @p CH_DBG_ENABLE_ASSERTS is enabled.
    */
   class MutexLocker
   {
-    Mutex& mutex;
+    Mutex *mutex;
 
   public:
-      MutexLocker(Mutex& m) : mutex(m) {
+      MutexLocker(Mutex& m) : mutex(&m) {
 
-        mutex.lock();
+        mutex->lock();
+      }
+
+      MutexLocker(const MutexLocker &) = delete;
+      MutexLocker &operator=(const MutexLocker &) = delete;
+
+      MutexLocker(MutexLocker &&other) noexcept : mutex(other.mutex) {
+
+        other.mutex = nullptr;
       }
 
       ~MutexLocker() {
 
-        mutex.unlock();
+        unlock();
+      }
+
+      /**
+       * @brief   Unlocks the mutex before the locker destruction.
+       * @pre     The mutex must be the last mutex locked by the current
+       *          thread and not yet unlocked.
+       *
+       * @api
+       */
+      void unlock(void) {
+
+        if (mutex != nullptr) {
+          mutex->unlock();
+          mutex = nullptr;
+        }
       }
   };
 
@@ -2344,6 +2420,38 @@ namespace chibios_rt {
 
       return chEvtGetAndClearFlagsI(&ev_listener);
     }
+
+#if (CH_CFG_USE_EVENTS_COALESCING == TRUE) || defined(__DOXYGEN__)
+    /**
+     * @brief   Configures the wakeups coalescing of the listener.
+     *
+     * @param[in] interval  minimum interval between two wakeups, zero
+     *                      disables the coalescing
+     * @param[in] threshold number of deferred broadcasts forcing a wakeup,
+     *                      zero if not used
+     *
+     * @api
+     */
+    void setCoalescing(sysinterval_t interval, ucnt_t threshold) {
+
+      chEvtSetCoalescing(&ev_listener, interval, threshold);
+    }
+
+    /**
+     * @brief   Configures the wakeups coalescing of the listener.
+     *
+     * @param[in] interval  minimum interval between two wakeups, zero
+     *                      disables the coalescing
+     * @param[in] threshold number of deferred broadcasts forcing a wakeup,
+     *                      zero if not used
+     *
+     * @iclass
+     */
+    void setCoalescingI(sysinterval_t interval, ucnt_t threshold) {
+
+      chEvtSetCoalescingI(&ev_listener, interval, threshold);
+    }
+#endif /* CH_CFG_USE_EVENTS_COALESCING == TRUE */
   };
 
   /*------------------------------------------------------------------------*
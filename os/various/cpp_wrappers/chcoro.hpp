@@ -0,0 +1,1277 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    chcoro.hpp
+ * @brief   C++20 coroutines layer over the RT wrappers.
+ * @details Coroutines are executed by an @p Executor, a queue of ready
+ *          coroutines served by one or more threads, so many activities
+ *          can share a single stack. Coroutines wait on coroutine-aware synchronization
+ *          objects, these objects can be signaled by threads and ISRs,
+ *          the waiting coroutine is then resumed through the executor.
+ * @note    Requires C++20 or later, coroutine frames are allocated from
+ *          the default heap when @p CH_CFG_USE_HEAP is enabled.
+ *
+ * @addtogroup cpp_library
+ * @{
+ */
+
+#include <chrono>
+#include <coroutine>
+#include <memory>
+#include <utility>
+
+#include "ch.hpp"
+
+#ifndef _CHCORO_HPP_
+#define _CHCORO_HPP_
+
+#if __cplusplus < 202002L
+#error "chcoro.hpp requires C++20 or later"
+#endif
+
+#if CH_CFG_USE_SEMAPHORES == FALSE
+#error "chcoro.hpp requires CH_CFG_USE_SEMAPHORES"
+#endif
+
+namespace chibios_rt {
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::durationToInterval()                                       *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Duration of a system tick.
+   */
+  using ticks = std::chrono::duration<sysinterval_t,
+                                      std::ratio<1, CH_CFG_ST_FREQUENCY>>;
+
+  /**
+   * @brief   Converts a @p std::chrono duration to a system interval.
+   * @note    The result is rounded upward to the next tick boundary and
+   *          saturated to @p TIME_MAX_INTERVAL, negative durations are
+   *          converted to @p TIME_IMMEDIATE.
+   *
+   * @param[in] d         the duration
+   * @return              The number of ticks.
+   *
+   * @special
+   */
+  template <class Rep, class Period>
+  constexpr sysinterval_t
+  durationToInterval(const std::chrono::duration<Rep, Period> &d) {
+    using wide = std::chrono::duration<long long,
+                                       std::ratio<1, CH_CFG_ST_FREQUENCY>>;
+    long long n = std::chrono::ceil<wide>(d).count();
+
+    if (n <= 0) {
+      return TIME_IMMEDIATE;
+    }
+    if (n > (long long)TIME_MAX_INTERVAL) {
+      return TIME_MAX_INTERVAL;
+    }
+    return (sysinterval_t)n;
+  }
+
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+  /*------------------------------------------------------------------------*
+   * chibios_rt::Mailbox<std::unique_ptr<T>, N>                             *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Mailbox transferring the ownership of objects.
+   * @details Only the raw pointer is queued, the ownership is released by
+   *          the sender when the pointer is posted and acquired by the
+   *          receiver when it is fetched. Objects still queued are deleted
+   *          when the mailbox is reset.
+   *
+   * @param T               type of the owned objects
+   * @param N               length of the mailbox buffer
+   */
+  template <typename T, int N>
+  class Mailbox<std::unique_ptr<T>, N> {
+
+    static_assert(sizeof (T *) <= sizeof (msg_t),
+                  "pointers do not fit in msg_t");
+
+  private:
+    mailbox_t   mb;
+    msg_t       mb_buf[N];
+
+  public:
+    /**
+     * @brief   Mailbox constructor.
+     *
+     * @init
+     */
+    Mailbox(void) {
+
+      chMBObjectInit(&mb, mb_buf, (size_t)N);
+    }
+
+    Mailbox(const Mailbox &) = delete;
+    Mailbox &operator=(const Mailbox &) = delete;
+
+    /**
+     * @brief   Mailbox destructor.
+     * @details Queued objects are deleted.
+     */
+    ~Mailbox() {
+
+      reset();
+    }
+
+    /**
+     * @brief   Resets the mailbox.
+     * @details All the waiting threads are resumed with status @p MSG_RESET
+     *          and the queued objects are deleted.
+     *
+     * @api
+     */
+    void reset(void) {
+      msg_t msg;
+
+      chSysLock();
+      while (chMBFetchI(&mb, &msg) == MSG_OK) {
+        chSysUnlock();
+        delete reinterpret_cast<T *>(msg);
+        chSysLock();
+      }
+      chMBResetI(&mb);
+      chSchRescheduleS();
+      chSysUnlock();
+    }
+
+    /**
+     * @brief   Terminates the reset state.
+     *
+     * @xclass
+     */
+    void resumeX(void) {
+
+      chMBResumeX(&mb);
+    }
+
+    /**
+     * @brief   Posts an object into the mailbox.
+     * @details The ownership is transferred only if the operation
+     *          succeeded, else the object is still owned by @p p.
+     *
+     * @param[in,out] p     the object to be posted
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval MSG_OK       if the object has been posted.
+     * @retval MSG_RESET    if the mailbox has been reset while waiting.
+     * @retval MSG_TIMEOUT  if the operation has timed out.
+     *
+     * @api
+     */
+    msg_t post(std::unique_ptr<T> &p, sysinterval_t timeout) {
+      msg_t msg;
+
+      msg = chMBPostTimeout(&mb, reinterpret_cast<msg_t>(p.get()), timeout);
+      if (msg == MSG_OK) {
+        (void) p.release();
+      }
+      return msg;
+    }
+
+    /**
+     * @brief   Posts an object into the mailbox.
+     * @details This variant is non-blocking, the ownership is transferred
+     *          only if the operation succeeded.
+     *
+     * @param[in,out] p     the object to be posted
+     * @return              The operation status.
+     * @retval MSG_OK       if the object has been posted.
+     * @retval MSG_RESET    if the mailbox has been reset.
+     * @retval MSG_TIMEOUT  if the mailbox is full.
+     *
+     * @iclass
+     */
+    msg_t postI(std::unique_ptr<T> &p) {
+      msg_t msg;
+
+      msg = chMBPostI(&mb, reinterpret_cast<msg_t>(p.get()));
+      if (msg == MSG_OK) {
+        (void) p.release();
+      }
+      return msg;
+    }
+
+    /**
+     * @brief   Fetches an object from the mailbox.
+     *
+     * @param[out] p        the received object
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval MSG_OK       if an object has been fetched.
+     * @retval MSG_RESET    if the mailbox has been reset while waiting.
+     * @retval MSG_TIMEOUT  if the operation has timed out.
+     *
+     * @api
+     */
+    msg_t fetch(std::unique_ptr<T> &p, sysinterval_t timeout) {
+      msg_t msg, raw;
+
+      msg = chMBFetchTimeout(&mb, &raw, timeout);
+      if (msg == MSG_OK) {
+        p.reset(reinterpret_cast<T *>(raw));
+      }
+      return msg;
+    }
+
+    /**
+     * @brief   Fetches an object from the mailbox.
+     * @details This variant is non-blocking.
+     *
+     * @param[out] p        the received object
+     * @return              The operation status.
+     * @retval MSG_OK       if an object has been fetched.
+     * @retval MSG_RESET    if the mailbox has been reset.
+     * @retval MSG_TIMEOUT  if the mailbox is empty.
+     *
+     * @iclass
+     */
+    msg_t fetchI(std::unique_ptr<T> &p) {
+      msg_t msg, raw;
+
+      msg = chMBFetchI(&mb, &raw);
+      if (msg == MSG_OK) {
+        p.reset(reinterpret_cast<T *>(raw));
+      }
+      return msg;
+    }
+
+    /**
+     * @brief   Returns the number of queued objects.
+     *
+     * @iclass
+     */
+    size_t getUsedCountI(void) const {
+
+      return chMBGetUsedCountI(&mb);
+    }
+  };
+#endif /* CH_CFG_USE_MAILBOXES == TRUE */
+}
+
+/**
+ * @brief   Coroutines layer.
+ */
+namespace chibios_co {
+
+  class Executor;
+
+  /*------------------------------------------------------------------------*
+   * chibios_co::Task                                                       *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Coroutine return type.
+   * @details A task is created suspended, it starts when spawned on an
+   *          executor and its frame is freed when it returns.
+   */
+  class Task {
+  public:
+    /**
+     * @brief   Coroutine promise.
+     */
+    struct promise_type {
+      /**
+       * @brief   Executor running the coroutine.
+       */
+      Executor *executor = nullptr;
+      /**
+       * @brief   Next coroutine in the executor ready queue.
+       */
+      promise_type *next = nullptr;
+
+      Task get_return_object(void) noexcept {
+
+        return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+      }
+
+      static Task get_return_object_on_allocation_failure(void) noexcept {
+
+        return Task();
+      }
+
+      std::suspend_always initial_suspend(void) noexcept {
+
+        return {};
+      }
+
+      std::suspend_never final_suspend(void) noexcept {
+
+        return {};
+      }
+
+      void return_void(void) noexcept {
+      }
+
+      void unhandled_exception(void) noexcept {
+
+        chSysHalt("unhandled exception");
+      }
+
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+      static void *operator new(size_t size) noexcept {
+
+        return chHeapAlloc(nullptr, size);
+      }
+
+      static void operator delete(void *p) noexcept {
+
+        chHeapFree(p);
+      }
+#endif
+    };
+
+    /**
+     * @brief   Type of a handle to a task coroutine.
+     */
+    using handle_type = std::coroutine_handle<promise_type>;
+
+  private:
+    handle_type handle;
+
+    explicit Task(handle_type h) noexcept : handle(h) {
+    }
+
+    friend class Executor;
+
+  public:
+    Task(void) noexcept : handle(nullptr) {
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {
+    }
+
+    Task &operator=(Task &&other) noexcept {
+
+      if (this != &other) {
+        if (handle) {
+          handle.destroy();
+        }
+        handle = std::exchange(other.handle, nullptr);
+      }
+      return *this;
+    }
+
+    /**
+     * @brief   Task destructor.
+     * @details A task never spawned is destroyed.
+     */
+    ~Task() {
+
+      if (handle) {
+        handle.destroy();
+      }
+    }
+
+    /**
+     * @brief   Checks if the task has been created.
+     * @note    A task is invalid if its frame could not be allocated.
+     */
+    bool isValid(void) const noexcept {
+
+      return (bool)handle;
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_co::Executor                                                   *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Coroutines executor.
+   * @details Coroutines to be resumed are linked into a FIFO ready queue
+   *          through their promise objects, a counting semaphore counts
+   *          the pending resumptions. The queue is served by threads
+   *          calling @p dispatch() or @p run().
+   * @note    The queue requires no storage other than the coroutine
+   *          frames so a resumption can never fail, each coroutine can
+   *          have at most one pending resumption.
+   */
+  class Executor {
+    /**
+     * @brief   Pending resumptions and stop requests counter.
+     */
+    semaphore_t         sem;
+    /**
+     * @brief   First coroutine in the ready queue.
+     */
+    Task::promise_type  *head = nullptr;
+    /**
+     * @brief   Last coroutine in the ready queue.
+     */
+    Task::promise_type  *tail = nullptr;
+
+  public:
+    /**
+     * @brief   Executor constructor.
+     *
+     * @init
+     */
+    Executor(void) {
+
+      chSemObjectInit(&sem, (cnt_t)0);
+    }
+
+    Executor(const Executor &) = delete;
+    Executor &operator=(const Executor &) = delete;
+
+    /**
+     * @brief   Schedules the resumption of a coroutine.
+     *
+     * @param[in] h         handle of the coroutine
+     *
+     * @iclass
+     */
+    void resumeI(Task::handle_type h) {
+      Task::promise_type *pp = &h.promise();
+
+      chDbgCheckClassI();
+
+      pp->next = nullptr;
+      if (tail == nullptr) {
+        head = pp;
+      }
+      else {
+        tail->next = pp;
+      }
+      tail = pp;
+      chSemSignalI(&sem);
+    }
+
+    /**
+     * @brief   Schedules the resumption of a coroutine.
+     *
+     * @param[in] h         handle of the coroutine
+     *
+     * @api
+     */
+    void resume(Task::handle_type h) {
+
+      chSysLock();
+      resumeI(h);
+      chSchRescheduleS();
+      chSysUnlock();
+    }
+
+    /**
+     * @brief   Starts a task on this executor.
+     * @details The task object is consumed, the coroutine frame is freed
+     *          when the coroutine returns.
+     *
+     * @param[in] task      the task to be started
+     * @return              The operation status.
+     * @retval false        if the task is invalid.
+     * @retval true         if the task has been started.
+     *
+     * @api
+     */
+    bool spawn(Task &&task) {
+      Task::handle_type h = std::exchange(task.handle, nullptr);
+
+      if (!h) {
+        return false;
+      }
+      h.promise().executor = this;
+      resume(h);
+      return true;
+    }
+
+    /**
+     * @brief   Executes the next pending resumption.
+     *
+     * @param[in] timeout   the number of ticks before the operation timeouts,
+     *                      the following special values are allowed:
+     *                      - @a TIME_IMMEDIATE immediate timeout.
+     *                      - @a TIME_INFINITE no timeout.
+     *                      .
+     * @return              The operation status.
+     * @retval MSG_OK       if a coroutine has been resumed.
+     * @retval MSG_TIMEOUT  if the operation has timed out.
+     * @retval MSG_RESET    if @p stop() has been invoked.
+     *
+     * @api
+     */
+    msg_t dispatch(sysinterval_t timeout = TIME_INFINITE) {
+      Task::promise_type *pp;
+      msg_t msg;
+
+      chSysLock();
+      msg = chSemWaitTimeoutS(&sem, timeout);
+      if (msg != MSG_OK) {
+        chSysUnlock();
+        return msg;
+      }
+
+      /* A signal without a queued coroutine is a stop request.*/
+      pp = head;
+      if (pp == nullptr) {
+        chSysUnlock();
+        return MSG_RESET;
+      }
+      head = pp->next;
+      if (head == nullptr) {
+        tail = nullptr;
+      }
+      chSysUnlock();
+
+      Task::handle_type::from_promise(*pp).resume();
+
+      return MSG_OK;
+    }
+
+    /**
+     * @brief   Serves the executor until @p stop() is invoked.
+     *
+     * @api
+     */
+    void run(void) {
+
+      while (dispatch() != MSG_RESET) {
+      }
+    }
+
+    /**
+     * @brief   Makes one thread return from @p run().
+     * @details The request is served when no resumptions are pending.
+     *
+     * @api
+     */
+    void stop(void) {
+
+      chSemSignal(&sem);
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_co::Waiter                                                     *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Coroutine waiting on a synchronization object.
+   * @note    Waiters are part of the awaiter objects, they are located in
+   *          the coroutine frames.
+   */
+  struct Waiter {
+    /**
+     * @brief   Next waiter in the queue.
+     */
+    Waiter              *next;
+    /**
+     * @brief   Waiting coroutine.
+     */
+    Task::handle_type   handle;
+
+    /**
+     * @brief   Resumes the waiting coroutine through its executor.
+     *
+     * @iclass
+     */
+    void wakeupI(void) {
+
+      handle.promise().executor->resumeI(handle);
+    }
+  };
+
+  /**
+   * @brief   FIFO queue of waiters.
+   */
+  class WaitQueue {
+    Waiter *head = nullptr;
+    Waiter *tail = nullptr;
+
+  public:
+    bool isEmpty(void) const {
+
+      return head == nullptr;
+    }
+
+    void insert(Waiter *wp) {
+
+      wp->next = nullptr;
+      if (tail == nullptr) {
+        head = wp;
+      }
+      else {
+        tail->next = wp;
+      }
+      tail = wp;
+    }
+
+    Waiter *remove(void) {
+      Waiter *wp = head;
+
+      head = wp->next;
+      if (head == nullptr) {
+        tail = nullptr;
+      }
+      return wp;
+    }
+
+    /**
+     * @brief   Removes the waiters selected by a predicate.
+     * @details Selected waiters are passed to @p fn in FIFO order.
+     */
+    template <typename Pred, typename Fn>
+    void removeIf(Pred pred, Fn fn) {
+      Waiter **wpp = &head;
+
+      tail = nullptr;
+      while (*wpp != nullptr) {
+        Waiter *wp = *wpp;
+
+        if (pred(wp)) {
+          *wpp = wp->next;
+          fn(wp);
+        }
+        else {
+          tail = wp;
+          wpp = &wp->next;
+        }
+      }
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_co::Semaphore                                                  *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Coroutine-aware counting semaphore.
+   */
+  class Semaphore {
+    cnt_t       cnt;
+    WaitQueue   queue;
+
+  public:
+    /**
+     * @brief   Move-only guard returned by @p acquire().
+     * @details The semaphore is signaled when the guard is destroyed.
+     */
+    class Guard {
+      Semaphore *sp;
+
+    public:
+      explicit Guard(Semaphore *s) noexcept : sp(s) {
+      }
+
+      Guard(const Guard &) = delete;
+      Guard &operator=(const Guard &) = delete;
+
+      Guard(Guard &&other) noexcept : sp(std::exchange(other.sp, nullptr)) {
+      }
+
+      Guard &operator=(Guard &&other) noexcept {
+
+        if (this != &other) {
+          release();
+          sp = std::exchange(other.sp, nullptr);
+        }
+        return *this;
+      }
+
+      ~Guard() {
+
+        release();
+      }
+
+      /**
+       * @brief   Signals the semaphore before the guard destruction.
+       */
+      void release(void) {
+
+        if (sp != nullptr) {
+          std::exchange(sp, nullptr)->signal();
+        }
+      }
+    };
+
+    /**
+     * @brief   Awaiter returned by @p wait().
+     */
+    class Awaiter {
+    protected:
+      Semaphore &sem;
+      Waiter    waiter;
+
+    public:
+      explicit Awaiter(Semaphore &s) noexcept : sem(s) {
+      }
+
+      bool await_ready(void) const noexcept {
+
+        return false;
+      }
+
+      bool await_suspend(Task::handle_type h) noexcept {
+
+        chSysLock();
+        if (sem.cnt > (cnt_t)0) {
+          sem.cnt--;
+          chSysUnlock();
+          return false;
+        }
+        waiter.handle = h;
+        sem.queue.insert(&waiter);
+        chSysUnlock();
+        return true;
+      }
+
+      void await_resume(void) const noexcept {
+      }
+    };
+
+    /**
+     * @brief   Awaiter returned by @p acquire().
+     */
+    class GuardAwaiter : public Awaiter {
+    public:
+      using Awaiter::Awaiter;
+
+      Guard await_resume(void) const noexcept {
+
+        return Guard(&sem);
+      }
+    };
+
+    /**
+     * @brief   Semaphore constructor.
+     *
+     * @param[in] n         initial value of the semaphore counter, it must
+     *                      be non-negative
+     *
+     * @init
+     */
+    explicit Semaphore(cnt_t n) : cnt(n) {
+
+      chDbgCheck(n >= (cnt_t)0);
+    }
+
+    Semaphore(const Semaphore &) = delete;
+    Semaphore &operator=(const Semaphore &) = delete;
+
+    /**
+     * @brief   Waits on the semaphore.
+     *
+     * @return              An object to be awaited.
+     */
+    Awaiter wait(void) noexcept {
+
+      return Awaiter(*this);
+    }
+
+    /**
+     * @brief   Waits on the semaphore.
+     *
+     * @return              An object to be awaited, it returns a guard
+     *                      signaling the semaphore when destroyed.
+     */
+    GuardAwaiter acquire(void) noexcept {
+
+      return GuardAwaiter(*this);
+    }
+
+    /**
+     * @brief   Signals the semaphore.
+     *
+     * @iclass
+     */
+    void signalI(void) {
+
+      if (!queue.isEmpty()) {
+        queue.remove()->wakeupI();
+      }
+      else {
+        cnt++;
+      }
+    }
+
+    /**
+     * @brief   Signals the semaphore.
+     *
+     * @api
+     */
+    void signal(void) {
+
+      chSysLock();
+      signalI();
+      chSchRescheduleS();
+      chSysUnlock();
+    }
+
+    /**
+     * @brief   Returns the semaphore counter.
+     *
+     * @iclass
+     */
+    cnt_t getCounterI(void) const {
+
+      return cnt;
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_co::Mailbox                                                    *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Coroutine-aware typed mailbox.
+   * @details Coroutines can await both posting and fetching, threads and
+   *          ISRs can post without blocking.
+   *
+   * @param T               type of the messages, it must be default
+   *                        constructible and movable
+   * @param N               length of the mailbox buffer
+   */
+  template <typename T, size_t N>
+  class Mailbox {
+
+    static_assert(N > 0U, "invalid mailbox size");
+
+    T           buf[N];
+    size_t      rd = 0U;
+    size_t      cnt = 0U;
+    WaitQueue   getters;
+    WaitQueue   putters;
+
+    struct GetWaiter : public Waiter {
+      T         msg;
+    };
+
+    struct PutWaiter : public Waiter {
+      T         msg;
+    };
+
+    void putI(T &&msg) {
+
+      buf[(rd + cnt) % N] = std::move(msg);
+      cnt++;
+    }
+
+    T getI(void) {
+      T msg = std::move(buf[rd]);
+
+      rd = (rd + 1U) % N;
+      cnt--;
+      return msg;
+    }
+
+    /* Tries to post a message, a waiting getter receives it directly.*/
+    bool tryPostI(T &msg) {
+
+      if (!getters.isEmpty()) {
+        GetWaiter *gwp = static_cast<GetWaiter *>(getters.remove());
+        gwp->msg = std::move(msg);
+        gwp->wakeupI();
+        return true;
+      }
+      if (cnt < N) {
+        putI(std::move(msg));
+        return true;
+      }
+      return false;
+    }
+
+    /* Tries to fetch a message, a waiting putter fills the freed slot.*/
+    bool tryFetchI(T &msg) {
+
+      if (cnt == 0U) {
+        return false;
+      }
+      msg = getI();
+      if (!putters.isEmpty()) {
+        PutWaiter *pwp = static_cast<PutWaiter *>(putters.remove());
+        putI(std::move(pwp->msg));
+        pwp->wakeupI();
+      }
+      return true;
+    }
+
+  public:
+    /**
+     * @brief   Awaiter returned by @p fetch().
+     */
+    class FetchAwaiter {
+      Mailbox   &mb;
+      GetWaiter waiter;
+
+    public:
+      explicit FetchAwaiter(Mailbox &m) noexcept : mb(m) {
+      }
+
+      bool await_ready(void) const noexcept {
+
+        return false;
+      }
+
+      bool await_suspend(Task::handle_type h) {
+
+        chSysLock();
+        if (mb.tryFetchI(waiter.msg)) {
+          chSysUnlock();
+          return false;
+        }
+        waiter.handle = h;
+        mb.getters.insert(&waiter);
+        chSysUnlock();
+        return true;
+      }
+
+      T await_resume(void) {
+
+        return std::move(waiter.msg);
+      }
+    };
+
+    /**
+     * @brief   Awaiter returned by @p post().
+     */
+    class PostAwaiter {
+      Mailbox   &mb;
+      PutWaiter waiter;
+
+    public:
+      PostAwaiter(Mailbox &m, T &&msg) noexcept : mb(m) {
+
+        waiter.msg = std::move(msg);
+      }
+
+      bool await_ready(void) const noexcept {
+
+        return false;
+      }
+
+      bool await_suspend(Task::handle_type h) {
+
+        chSysLock();
+        if (mb.tryPostI(waiter.msg)) {
+          chSysUnlock();
+          return false;
+        }
+        waiter.handle = h;
+        mb.putters.insert(&waiter);
+        chSysUnlock();
+        return true;
+      }
+
+      void await_resume(void) const noexcept {
+      }
+    };
+
+    Mailbox(void) = default;
+    Mailbox(const Mailbox &) = delete;
+    Mailbox &operator=(const Mailbox &) = delete;
+
+    /**
+     * @brief   Fetches a message.
+     *
+     * @return              An object to be awaited, it returns the message.
+     */
+    FetchAwaiter fetch(void) noexcept {
+
+      return FetchAwaiter(*this);
+    }
+
+    /**
+     * @brief   Posts a message.
+     * @details The coroutine is suspended while the mailbox is full.
+     *
+     * @param[in] msg       the message to be posted
+     * @return              An object to be awaited.
+     */
+    PostAwaiter post(T msg) noexcept {
+
+      return PostAwaiter(*this, std::move(msg));
+    }
+
+    /**
+     * @brief   Posts a message without waiting.
+     *
+     * @param[in] msg       the message to be posted
+     * @return              The operation status.
+     * @retval false        if the mailbox is full, the message is not
+     *                      consumed.
+     * @retval true         if the message has been posted.
+     *
+     * @iclass
+     */
+    bool postI(T &msg) {
+
+      return tryPostI(msg);
+    }
+
+    /**
+     * @brief   Posts a message without waiting.
+     *
+     * @param[in] msg       the message to be posted
+     * @return              The operation status, see @p postI().
+     *
+     * @api
+     */
+    bool tryPost(T &msg) {
+      bool result;
+
+      chSysLock();
+      result = tryPostI(msg);
+      chSchRescheduleS();
+      chSysUnlock();
+
+      return result;
+    }
+
+    /**
+     * @brief   Fetches a message without waiting.
+     *
+     * @param[out] msg      the fetched message
+     * @return              The operation status.
+     * @retval false        if the mailbox is empty.
+     * @retval true         if a message has been fetched.
+     *
+     * @iclass
+     */
+    bool fetchI(T &msg) {
+
+      return tryFetchI(msg);
+    }
+
+    /**
+     * @brief   Returns the number of queued messages.
+     *
+     * @iclass
+     */
+    size_t getUsedCountI(void) const {
+
+      return cnt;
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_co::EventFlags                                                 *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Coroutine-aware event flags.
+   * @details Broadcasted flags are accumulated, a waiting coroutine
+   *          consumes the pending flags matching its mask.
+   */
+  class EventFlags {
+    eventflags_t    pending = (eventflags_t)0;
+    WaitQueue       queue;
+
+    struct FlagsWaiter : public Waiter {
+      eventflags_t  mask;
+      eventflags_t  flags;
+    };
+
+  public:
+    /**
+     * @brief   Awaiter returned by @p wait().
+     */
+    class Awaiter {
+      EventFlags    &ef;
+      FlagsWaiter   waiter;
+
+    public:
+      Awaiter(EventFlags &e, eventflags_t mask) noexcept : ef(e) {
+
+        waiter.mask  = mask;
+        waiter.flags = (eventflags_t)0;
+      }
+
+      bool await_ready(void) const noexcept {
+
+        return false;
+      }
+
+      bool await_suspend(Task::handle_type h) noexcept {
+
+        chSysLock();
+        waiter.flags = ef.pending & waiter.mask;
+        if (waiter.flags != (eventflags_t)0) {
+          ef.pending &= ~waiter.flags;
+          chSysUnlock();
+          return false;
+        }
+        waiter.handle = h;
+        ef.queue.insert(&waiter);
+        chSysUnlock();
+        return true;
+      }
+
+      eventflags_t await_resume(void) const noexcept {
+
+        return waiter.flags;
+      }
+    };
+
+    EventFlags(void) = default;
+    EventFlags(const EventFlags &) = delete;
+    EventFlags &operator=(const EventFlags &) = delete;
+
+    /**
+     * @brief   Waits for any of the specified flags.
+     *
+     * @param[in] mask      flags of interest
+     * @return              An object to be awaited, it returns the consumed
+     *                      flags.
+     */
+    Awaiter wait(eventflags_t mask) noexcept {
+
+      return Awaiter(*this, mask);
+    }
+
+    /**
+     * @brief   Adds flags and wakes up the interested coroutines.
+     *
+     * @param[in] flags     the flags to be added
+     *
+     * @iclass
+     */
+    void broadcastFlagsI(eventflags_t flags) {
+
+      pending |= flags;
+      queue.removeIf([this](Waiter *wp) {
+                       FlagsWaiter *fwp = static_cast<FlagsWaiter *>(wp);
+                       fwp->flags = pending & fwp->mask;
+                       pending &= ~fwp->flags;
+                       return fwp->flags != (eventflags_t)0;
+                     },
+                     [](Waiter *wp) {
+                       wp->wakeupI();
+                     });
+    }
+
+    /**
+     * @brief   Adds flags and wakes up the interested coroutines.
+     *
+     * @param[in] flags     the flags to be added
+     *
+     * @api
+     */
+    void broadcastFlags(eventflags_t flags) {
+
+      chSysLock();
+      broadcastFlagsI(flags);
+      chSchRescheduleS();
+      chSysUnlock();
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_co::sleep()                                                    *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Awaiter returned by @p sleep().
+   * @details The virtual timer is located in the coroutine frame.
+   */
+  class SleepAwaiter {
+    sysinterval_t       interval;
+    virtual_timer_t     vt;
+    Task::handle_type   handle;
+
+    static void wakeup(void *p) {
+      SleepAwaiter *sap = static_cast<SleepAwaiter *>(p);
+
+      chSysLockFromISR();
+      sap->handle.promise().executor->resumeI(sap->handle);
+      chSysUnlockFromISR();
+    }
+
+  public:
+    explicit SleepAwaiter(sysinterval_t i) noexcept : interval(i) {
+
+      chVTObjectInit(&vt);
+    }
+
+    bool await_ready(void) const noexcept {
+
+      return interval == TIME_IMMEDIATE;
+    }
+
+    void await_suspend(Task::handle_type h) noexcept {
+
+      handle = h;
+      chVTSet(&vt, interval, wakeup, this);
+    }
+
+    void await_resume(void) const noexcept {
+    }
+  };
+
+  /**
+   * @brief   Suspends the coroutine for the specified time interval.
+   *
+   * @param[in] interval  the interval, @p TIME_INFINITE is not allowed
+   * @return              An object to be awaited.
+   */
+  inline SleepAwaiter sleep(sysinterval_t interval) noexcept {
+
+    return SleepAwaiter(interval);
+  }
+
+  /**
+   * @brief   Suspends the coroutine for the specified duration.
+   *
+   * @param[in] d         the duration
+   * @return              An object to be awaited.
+   */
+  template <class Rep, class Period>
+  inline SleepAwaiter sleep(const std::chrono::duration<Rep, Period> &d) noexcept {
+
+    return SleepAwaiter(chibios_rt::durationToInterval(d));
+  }
+
+  /**
+   * @brief   Awaiter returned by @p yield().
+   */
+  struct YieldAwaiter {
+    bool await_ready(void) const noexcept {
+
+      return false;
+    }
+
+    void await_suspend(Task::handle_type h) noexcept {
+
+      h.promise().executor->resume(h);
+    }
+
+    void await_resume(void) const noexcept {
+    }
+  };
+
+  /**
+   * @brief   Lets the other coroutines of the executor run.
+   *
+   * @return              An object to be awaited.
+   */
+  inline YieldAwaiter yield(void) noexcept {
+
+    return YieldAwaiter();
+  }
+}
+
+#endif /* _CHCORO_HPP_ */
+
+/** @} */
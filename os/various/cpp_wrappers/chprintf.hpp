@@ -0,0 +1,753 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    chprintf.hpp
+ * @brief   C++ compile-time formatted output front-end.
+ * @details The format string is parsed at compile time into a table of
+ *          segments, each conversion is then bound to the type of the
+ *          corresponding argument so the run-time code does not need to
+ *          interpret the format string nor to access a @p va_list.
+ *          The supported syntax is the same of @p chprintf() except
+ *          for the @p * width and precision modifiers.
+ * @note    Requires C++14 or later.
+ *
+ * @addtogroup cpp_library
+ * @{
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+#include "hal.h"
+#include "chprintf.h"
+#include "memstreams.h"
+
+#ifndef _CHPRINTF_HPP_
+#define _CHPRINTF_HPP_
+
+#if __cplusplus < 201402L
+#error "chprintf.hpp requires C++14 or later"
+#endif
+
+/**
+ * @brief   Wraps a string literal into a type usable as format string.
+ *
+ * @param[in] s         the format string literal
+ */
+#define CH_FMT(s)                                                           \
+  ([] {                                                                     \
+    struct fmt_string {                                                     \
+      static constexpr const char *str(void) { return s; }                  \
+    };                                                                      \
+    return fmt_string{};                                                    \
+  }())
+
+/**
+ * @brief   Compile-time formatted output.
+ */
+namespace chibios_fmt {
+
+  /*------------------------------------------------------------------------*
+   * chibios_fmt::Segment                                                   *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Parsed format string segment.
+   * @details A segment is either a run of literal characters or a single
+   *          conversion specification.
+   */
+  struct Segment {
+    /**
+     * @brief   Offset of the segment into the format string.
+     */
+    size_t      start;
+    /**
+     * @brief   Length of the literal run, zero for conversions.
+     */
+    size_t      len;
+    /**
+     * @brief   Conversion character.
+     */
+    char        conv;
+    /**
+     * @brief   Left alignment flag.
+     */
+    bool        left_align;
+    /**
+     * @brief   Forced sign flag.
+     */
+    bool        do_sign;
+    /**
+     * @brief   Filler character.
+     */
+    char        filler;
+    /**
+     * @brief   Field width.
+     */
+    int         width;
+    /**
+     * @brief   Field precision.
+     */
+    int         precision;
+    /**
+     * @brief   Unsupported modifier found in the specification.
+     */
+    bool        invalid;
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_fmt::Table                                                     *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Table of the segments of a format string.
+   *
+   * @tparam N          number of segments, at least one
+   */
+  template <size_t N>
+  struct Table {
+    /**
+     * @brief   Segments array.
+     */
+    Segment     seg[N];
+  };
+
+  /**
+   * @brief   Argument classes as seen by conversions.
+   */
+  enum class ArgClass : uint8_t {
+    none,
+    integer,
+    floating,
+    string,
+    pointer
+  };
+
+  /**
+   * @brief   Scans the next segment of a format string.
+   *
+   * @param[in] fmt     the format string
+   * @param[in] pos     offset of the segment
+   * @param[out] seg    the parsed segment
+   * @return            The offset of the following segment or zero if
+   *                    there are no more segments.
+   *
+   * @notapi
+   */
+  constexpr size_t scan(const char *fmt, size_t pos, Segment &seg) {
+    size_t i = pos;
+    char c = '\0';
+
+    seg = Segment{pos, 0, '\0', false, false, ' ', 0, 0, false};
+    if (fmt[i] == '\0') {
+      return 0;
+    }
+
+    /* Literal run, "%%" and unknown conversions are literals too.*/
+    if (fmt[i] != '%') {
+      while ((fmt[i] != '\0') && (fmt[i] != '%')) {
+        i++;
+      }
+      seg.len = i - pos;
+      return i;
+    }
+
+    i++;
+    if (fmt[i] == '-') {
+      seg.left_align = true;
+      i++;
+    }
+    if (fmt[i] == '+') {
+      seg.do_sign = true;
+      i++;
+    }
+    if (fmt[i] == '0') {
+      seg.filler = '0';
+      i++;
+    }
+    if (fmt[i] == '*') {
+      seg.invalid = true;
+      i++;
+    }
+    while ((fmt[i] >= '0') && (fmt[i] <= '9')) {
+      seg.width = seg.width * 10 + (fmt[i++] - '0');
+    }
+    if (fmt[i] == '.') {
+      i++;
+      if (fmt[i] == '*') {
+        seg.invalid = true;
+        i++;
+      }
+      while ((fmt[i] >= '0') && (fmt[i] <= '9')) {
+        seg.precision = seg.precision * 10 + (fmt[i++] - '0');
+      }
+    }
+    if ((fmt[i] == 'l') || (fmt[i] == 'L')) {
+      i++;
+    }
+
+    /* Truncated specification, output stops here as in chprintf().*/
+    c = fmt[i];
+    if (c == '\0') {
+      return 0;
+    }
+    switch (c) {
+    case 'c': case 's': case 'd': case 'D': case 'i': case 'I':
+    case 'x': case 'X': case 'p': case 'P': case 'u': case 'U':
+    case 'o': case 'O': case 'f':
+      seg.conv = c;
+      break;
+    default:
+      seg.start = i;
+      seg.len = 1U;
+      break;
+    }
+    return i + 1U;
+  }
+
+  /**
+   * @brief   Counts the segments of a format string.
+   *
+   * @notapi
+   */
+  constexpr size_t count(const char *fmt) {
+    Segment seg{0, 0, '\0', false, false, ' ', 0, 0, false};
+    size_t n = 0, pos = 0;
+
+    while ((pos = scan(fmt, pos, seg)) != 0U) {
+      n++;
+    }
+    return n;
+  }
+
+  /**
+   * @brief   Builds the segments table of a format string.
+   *
+   * @notapi
+   */
+  template <size_t N>
+  constexpr Table<N> parse(const char *fmt) {
+    Table<N> t{};
+    size_t n = 0, pos = 0;
+
+    while ((n < N) && ((pos = scan(fmt, pos, t.seg[n])) != 0U)) {
+      n++;
+    }
+    return t;
+  }
+
+  /**
+   * @brief   Class of the argument required by a conversion.
+   *
+   * @notapi
+   */
+  constexpr ArgClass conv_class(char conv) {
+
+    switch (conv) {
+    case 's':
+      return ArgClass::string;
+    case 'p':
+    case 'P':
+      return ArgClass::pointer;
+    case 'f':
+      return ArgClass::floating;
+    case '\0':
+      return ArgClass::none;
+    default:
+      return ArgClass::integer;
+    }
+  }
+
+  /**
+   * @brief   Class of an argument type.
+   *
+   * @notapi
+   */
+  template <typename T>
+  constexpr ArgClass arg_class(void) {
+    using U = typename std::decay<T>::type;
+
+    return std::is_integral<U>::value || std::is_enum<U>::value ?
+             ArgClass::integer :
+           std::is_floating_point<U>::value ?
+             ArgClass::floating :
+           std::is_same<U, char *>::value ||
+           std::is_same<U, const char *>::value ?
+             ArgClass::string :
+           std::is_pointer<U>::value || std::is_null_pointer<U>::value ?
+             ArgClass::pointer :
+             ArgClass::none;
+  }
+
+  /**
+   * @brief   Parsed format string.
+   *
+   * @tparam S          type generated by @p CH_FMT()
+   */
+  template <typename S>
+  struct Format {
+    /**
+     * @brief   Number of segments.
+     */
+    static constexpr size_t size = count(S::str());
+    /**
+     * @brief   Segments table.
+     */
+    static constexpr Table<(size > 0U) ? size : 1U> table =
+        parse<(size > 0U) ? size : 1U>(S::str());
+
+    /**
+     * @brief   Number of conversions.
+     */
+    static constexpr size_t conversions(void) {
+      size_t n = 0;
+
+      for (size_t i = 0; i < size; i++) {
+        if (table.seg[i].len == 0U) {
+          n++;
+        }
+      }
+      return n;
+    }
+
+    /**
+     * @brief   Checks for unsupported modifiers.
+     */
+    static constexpr bool valid(void) {
+
+      for (size_t i = 0; i < size; i++) {
+        if (table.seg[i].invalid) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    /**
+     * @brief   Checks the arguments types against the conversions.
+     */
+    template <typename... Args>
+    static constexpr bool matches(void) {
+      const ArgClass classes[] = {arg_class<Args>()..., ArgClass::none};
+      size_t a = 0;
+
+      for (size_t i = 0; i < size; i++) {
+        if (table.seg[i].len == 0U) {
+          ArgClass c = conv_class(table.seg[i].conv);
+
+          /* Characters and integers are also accepted as pointers.*/
+          if ((classes[a] != c) &&
+              !((c == ArgClass::pointer) && (classes[a] == ArgClass::integer))) {
+            return false;
+          }
+          a++;
+        }
+      }
+      return true;
+    }
+  };
+
+  template <typename S>
+  constexpr size_t Format<S>::size;
+
+  template <typename S>
+  constexpr Table<(Format<S>::size > 0U) ? Format<S>::size : 1U>
+      Format<S>::table;
+
+  /*------------------------------------------------------------------------*
+   * chibios_fmt::Writer                                                    *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Output side of a formatting operation.
+   * @details Output is collected in a buffer of @p CHPRINTF_BUFFER_SIZE
+   *          bytes, if the option is zero then runs are written directly
+   *          using @p streamWrite().
+   */
+  class Writer {
+    BaseSequentialStream *chp;
+#if CHPRINTF_BUFFER_SIZE > 0
+    size_t              cnt;
+    uint8_t             buf[CHPRINTF_BUFFER_SIZE];
+#endif
+
+  public:
+    /**
+     * @brief   Number of bytes produced.
+     */
+    int                 n;
+
+    /**
+     * @brief   Writer constructor.
+     *
+     * @param[in] chp   pointer to a @p BaseSequentialStream object
+     */
+    Writer(BaseSequentialStream *chp) : chp(chp),
+#if CHPRINTF_BUFFER_SIZE > 0
+                                        cnt(0),
+#endif
+                                        n(0) {
+    }
+
+    Writer(const Writer &) = delete;
+    Writer &operator=(const Writer &) = delete;
+
+    /**
+     * @brief   Writer destructor, pending data is flushed.
+     */
+    ~Writer() {
+
+      flush();
+    }
+
+    /**
+     * @brief   Writes pending data to the stream.
+     */
+    void flush(void) {
+
+#if CHPRINTF_BUFFER_SIZE > 0
+      if (cnt > 0U) {
+        (void) streamWrite(chp, buf, cnt);
+        cnt = 0U;
+      }
+#endif
+    }
+
+    /**
+     * @brief   Emits a character.
+     */
+    void put(char c) {
+
+      n++;
+#if CHPRINTF_BUFFER_SIZE > 0
+      if (cnt >= (size_t)CHPRINTF_BUFFER_SIZE) {
+        flush();
+      }
+      buf[cnt++] = (uint8_t)c;
+#else
+      streamPut(chp, (uint8_t)c);
+#endif
+    }
+
+    /**
+     * @brief   Emits a run of characters.
+     */
+    void write(const char *s, size_t len) {
+
+      n += (int)len;
+#if CHPRINTF_BUFFER_SIZE > 0
+      if (len >= (size_t)CHPRINTF_BUFFER_SIZE) {
+        /* Runs not fitting the buffer are written directly.*/
+        flush();
+        (void) streamWrite(chp, (const uint8_t *)s, len);
+        return;
+      }
+      if (len > (size_t)CHPRINTF_BUFFER_SIZE - cnt) {
+        flush();
+      }
+      memcpy(&buf[cnt], s, len);
+      cnt += len;
+#else
+      (void) streamWrite(chp, (const uint8_t *)s, len);
+#endif
+    }
+
+    /**
+     * @brief   Emits a field applying alignment and filling.
+     * @details Same rules of @p chprintf(), a leading sign is emitted
+     *          before zero fillers.
+     */
+    void field(const Segment &seg, char filler, const char *s, int len) {
+      int width = seg.width - len;
+
+      if (width < 0) {
+        width = 0;
+      }
+      if (!seg.left_align) {
+        if ((len > 0) && ((*s == '-') || (*s == '+')) && (filler == '0')) {
+          put(*s++);
+          len--;
+        }
+        while (width > 0) {
+          put(filler);
+          width--;
+        }
+      }
+      write(s, (size_t)len);
+      while (width > 0) {
+        put(filler);
+        width--;
+      }
+    }
+  };
+
+  /**
+   * @brief   Unsigned number to string conversion.
+   * @note    Digits are produced backward starting from @p q.
+   *
+   * @notapi
+   */
+  template <typename T>
+  inline char *utoa(char *q, T num, unsigned radix, int mindigits) {
+    int i = 0;
+
+    do {
+      unsigned d = (unsigned)(num % radix);
+      *--q = (char)(d < 10U ? '0' + d : 'A' + d - 10U);
+      num /= radix;
+      i++;
+    } while ((num != 0U) || (i < mindigits));
+    return q;
+  }
+
+  /**
+   * @brief   Integer emitter.
+   *
+   * @notapi
+   */
+  template <typename T>
+  inline void emit(Writer &w, const Segment &seg, T arg,
+                   typename std::enable_if<std::is_integral<T>::value ||
+                                           std::is_enum<T>::value>::type * = nullptr) {
+    using I = typename std::conditional<std::is_enum<T>::value ||
+                                        std::is_same<T, bool>::value,
+                                        long, T>::type;
+    using U = typename std::make_unsigned<I>::type;
+    char buf[sizeof (U) * 3U + 2U];
+    char *end = &buf[sizeof buf];
+    char *q;
+    I v = (I)arg;
+
+    switch (seg.conv) {
+    case 'c':
+      buf[0] = (char)v;
+      w.field(seg, ' ', buf, 1);
+      return;
+    case 'd':
+    case 'D':
+    case 'i':
+    case 'I':
+      if (v < 0) {
+        q = utoa(end, (U)(0U - (U)v), 10U, 1);
+        *--q = '-';
+      }
+      else {
+        q = utoa(end, (U)v, 10U, 1);
+        if (seg.do_sign) {
+          *--q = '+';
+        }
+      }
+      break;
+    case 'o':
+    case 'O':
+      q = utoa(end, (U)v, 8U, 1);
+      break;
+    case 'u':
+    case 'U':
+      q = utoa(end, (U)v, 10U, 1);
+      break;
+    default:
+      q = utoa(end, (U)v, 16U, 1);
+      break;
+    }
+    w.field(seg, seg.filler, q, (int)(end - q));
+  }
+
+  /**
+   * @brief   String emitter.
+   *
+   * @notapi
+   */
+  inline void emit(Writer &w, const Segment &seg, const char *s) {
+    int precision = seg.precision == 0 ? 32767 : seg.precision;
+    int len = 0;
+
+    if (s == nullptr) {
+      s = "(null)";
+    }
+    while ((s[len] != '\0') && (len < precision)) {
+      len++;
+    }
+    w.field(seg, ' ', s, len);
+  }
+
+  /**
+   * @brief   Pointer emitter.
+   *
+   * @notapi
+   */
+  template <typename T>
+  inline void emit(Writer &w, const Segment &seg, T arg,
+                   typename std::enable_if<std::is_pointer<T>::value &&
+                                           !std::is_same<typename std::decay<T>::type, const char *>::value &&
+                                           !std::is_same<typename std::decay<T>::type, char *>::value>::type * = nullptr) {
+
+    emit(w, seg, (uintptr_t)arg);
+  }
+
+  /**
+   * @brief   Null pointer emitter.
+   *
+   * @notapi
+   */
+  inline void emit(Writer &w, const Segment &seg, std::nullptr_t) {
+
+    emit(w, seg, (uintptr_t)0U);
+  }
+
+  /**
+   * @brief   Floating point emitter.
+   * @details Same algorithm and precision limits of @p chprintf().
+   *
+   * @notapi
+   */
+  inline void emit(Writer &w, const Segment &seg, double arg) {
+    static const long pow10[9] = {
+      10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+    };
+    char buf[32];
+    char *end = &buf[sizeof buf];
+    char *q;
+    float f = (float)arg;
+    bool neg = f < 0;
+    int precision = seg.precision;
+    long l, div;
+
+    if (neg) {
+      f = -f;
+    }
+    if ((precision == 0) || (precision > 9)) {
+      precision = 9;
+    }
+    div = pow10[precision - 1];
+    l = (long)f;
+    /* The fractional part is scaled in double precision as chprintf()
+       does, the result differs in the last digits if done in float.*/
+    q = utoa(end, (unsigned long)(((double)f - l) * div), 10U, precision);
+    *--q = '.';
+    q = utoa(q, (unsigned long)l, 10U, 1);
+    if (neg) {
+      *--q = '-';
+    }
+    else if (seg.do_sign) {
+      *--q = '+';
+    }
+    w.field(seg, seg.filler, q, (int)(end - q));
+  }
+
+  /**
+   * @brief   Emitter of the segment @p I of the format @p S.
+   *
+   * @notapi
+   */
+  template <typename S, size_t I, bool end = (I >= Format<S>::size)>
+  struct Emitter;
+
+  template <typename S, size_t I>
+  struct Emitter<S, I, true> {
+    static void run(Writer &w) {
+
+      (void)w;
+    }
+  };
+
+  template <typename S, size_t I>
+  struct Emitter<S, I, false> {
+    static constexpr bool literal = Format<S>::table.seg[I].len > 0U;
+
+    template <typename... Args>
+    static void run(Writer &w, const Args &... args) {
+
+      step(std::integral_constant<bool, literal>(), w, args...);
+    }
+
+    template <typename... Args>
+    static void step(std::true_type, Writer &w, const Args &... args) {
+
+      w.write(S::str() + Format<S>::table.seg[I].start,
+              Format<S>::table.seg[I].len);
+      Emitter<S, I + 1U>::run(w, args...);
+    }
+
+    template <typename T, typename... Args>
+    static void step(std::false_type, Writer &w,
+                     const T &arg, const Args &... args) {
+
+      emit(w, Format<S>::table.seg[I], arg);
+      Emitter<S, I + 1U>::run(w, args...);
+    }
+  };
+
+  /**
+   * @brief   Formatted output.
+   * @details The format is checked at compile time against the arguments.
+   *
+   * @param[in] chp     pointer to a @p BaseSequentialStream object
+   * @param[in] fmt     format string wrapped by @p CH_FMT()
+   * @param[in] args    arguments
+   * @return            The number of bytes that would have been
+   *                    written to @p chp if no stream error occurs
+   *
+   * @api
+   */
+  template <typename S, typename... Args>
+  inline int print(BaseSequentialStream *chp, S fmt, const Args &... args) {
+
+    static_assert(Format<S>::valid(),
+                  "unsupported format modifier");
+    static_assert(Format<S>::conversions() == sizeof... (Args),
+                  "format conversions and arguments count mismatch");
+    static_assert(Format<S>::template matches<Args...>(),
+                  "format argument type mismatch");
+    (void)fmt;
+
+    Writer w(chp);
+    Emitter<S, 0U>::run(w, args...);
+    return w.n;
+  }
+
+  /**
+   * @brief   Formatted output into a buffer.
+   * @post    @p str is NUL-terminated, unless @p size is 0.
+   *
+   * @param[in] str     pointer to a buffer
+   * @param[in] size    maximum size of the buffer
+   * @param[in] fmt     format string wrapped by @p CH_FMT()
+   * @param[in] args    arguments
+   * @return            The number of characters (excluding the
+   *                    terminating NUL byte) that would have been
+   *                    stored in @p str if there was room.
+   *
+   * @api
+   */
+  template <typename S, typename... Args>
+  inline int snprint(char *str, size_t size, S fmt, const Args &... args) {
+    MemoryStream ms;
+    int n;
+
+    msObjectInit(&ms, (uint8_t *)str, size > 0U ? size - 1U : 0U, 0);
+    n = print((BaseSequentialStream *)(void *)&ms, fmt, args...);
+    if (size > 0U) {
+      str[ms.eos] = '\0';
+    }
+
+    return n;
+  }
+}
+
+#endif /* _CHPRINTF_HPP_ */
+
+/** @} */
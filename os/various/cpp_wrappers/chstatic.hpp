@@ -0,0 +1,234 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    chstatic.hpp
+ * @brief   Compile-time initialized objects for the C++ wrappers.
+ * @details Objects declared in this module have @p constexpr constructors,
+ *          when declared @p constinit at namespace scope their whole
+ *          state is computed by the compiler and placed in the @p .data
+ *          image, no code is executed at boot in order to initialize them.
+ * @note    Objects embedding threads queues (semaphores, mutexes,
+ *          mailboxes, guarded pools) cannot be @p constexpr because the
+ *          empty queue points to itself through a cast, use the static
+ *          initializers of the C API for them (@p SEMAPHORE_DECL(),
+ *          @p MUTEX_DECL(), @p MAILBOX_DECL() and similar), those are
+ *          constant initializers too.
+ * @note    Threads can be created at boot without code in @p main() using
+ *          the threads table, see @p CH_CFG_USE_THREADS_TABLE.
+ * @note    Requires C++20 or later.
+ *
+ * @addtogroup cpp_library
+ * @{
+ */
+
+#include "ch.hpp"
+
+#ifndef _CHSTATIC_HPP_
+#define _CHSTATIC_HPP_
+
+#if __cplusplus < 202002L
+#error "chstatic.hpp requires C++20 or later"
+#endif
+
+#if CH_CFG_USE_MEMPOOLS == FALSE
+#error "chstatic.hpp requires CH_CFG_USE_MEMPOOLS"
+#endif
+
+namespace chibios_rt {
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::StaticObjectsPool                                          *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Template class encapsulating a preloaded objects pool.
+   * @details Differently from @p ObjectsPool the free list is built by
+   *          the constructor at compile time, the pool is ready to be used
+   *          without any initialization code.
+   *
+   * @code
+   *   constinit chibios_rt::StaticObjectsPool<msg_buffer_t, 16> buffers;
+   * @endcode
+   * @note    Some compilers (GCC 12) fail to constant-initialize arrays of
+   *          pools declared without an explicit initializer list, declare
+   *          the pools individually or initialize each array element.
+   *
+   * @tparam T            type of the pool objects
+   * @tparam N            number of objects in the pool
+   */
+  template <class T, size_t N>
+  class StaticObjectsPool {
+    static_assert(N > 0, "empty pool");
+
+    /**
+     * @brief   Storage for a single object.
+     * @details The pool header overlaps the object while the slot is in
+     *          the free list.
+     */
+    union slot {
+      struct pool_header  hdr;
+      alignas(T) uint8_t  obj[sizeof (T)];
+
+      constexpr slot() : hdr{nullptr} {
+
+      }
+    };
+
+    /**
+     * @brief   Objects storage.
+     */
+    slot slots[N];
+
+    /**
+     * @brief   Embedded @p memory_pool_t structure.
+     */
+    memory_pool_t pool;
+
+  public:
+    /**
+     * @brief   StaticObjectsPool constructor.
+     * @details Links all the slots in the pool free list.
+     *
+     * @init
+     */
+    constexpr StaticObjectsPool(void) :
+      slots(),
+      pool{&slots[0].hdr, sizeof (slot), (unsigned)alignof (slot), nullptr} {
+
+      for (size_t i = 0; i < N - 1; i++) {
+        slots[i].hdr.next = &slots[i + 1].hdr;
+      }
+    }
+
+    /* Prohibit copy construction and assignment, the free list refers
+       to the object itself.*/
+    StaticObjectsPool(const StaticObjectsPool &) = delete;
+    StaticObjectsPool &operator=(const StaticObjectsPool &) = delete;
+
+    /**
+     * @brief   Allocates an object from the pool.
+     *
+     * @return              The pointer to the allocated object storage,
+     *                      the object is not constructed.
+     * @retval nullptr      if pool is empty.
+     *
+     * @iclass
+     */
+    T *allocI(void) {
+
+      return static_cast<T *>(chPoolAllocI(&pool));
+    }
+
+    /**
+     * @brief   Allocates an object from the pool.
+     *
+     * @return              The pointer to the allocated object storage,
+     *                      the object is not constructed.
+     * @retval nullptr      if pool is empty.
+     *
+     * @api
+     */
+    T *alloc(void) {
+
+      return static_cast<T *>(chPoolAlloc(&pool));
+    }
+
+    /**
+     * @brief   Releases an object into the pool.
+     *
+     * @param[in] objp      the pointer to the object to be released
+     *
+     * @iclass
+     */
+    void freeI(T *objp) {
+
+      chPoolFreeI(&pool, objp);
+    }
+
+    /**
+     * @brief   Releases an object into the pool.
+     *
+     * @param[in] objp      the pointer to the object to be released
+     *
+     * @api
+     */
+    void free(T *objp) {
+
+      chPoolFree(&pool, objp);
+    }
+
+    /**
+     * @brief   Returns a pointer to the embedded @p memory_pool_t.
+     *
+     * @return              The pointer to the memory pool.
+     *
+     * @xclass
+     */
+    memory_pool_t *getPoolX(void) {
+
+      return &pool;
+    }
+  };
+
+  /*------------------------------------------------------------------------*
+   * chibios_rt::StaticWorkingArea                                          *
+   *------------------------------------------------------------------------*/
+  /**
+   * @brief   Template class encapsulating a thread working area.
+   * @details The working area can be referenced by a threads table entry,
+   *          the descriptor is computed at compile time.
+   *
+   * @code
+   *   static chibios_rt::StaticWorkingArea<256> wa_blinker;
+   *
+   *   THD_TABLE_BEGIN
+   *     wa_blinker.entry("blinker", NORMALPRIO + 1, blinker, nullptr),
+   *   THD_TABLE_END
+   * @endcode
+   *
+   * @tparam S            size of the thread stack
+   */
+  template <size_t S>
+  class StaticWorkingArea {
+  public:
+    /**
+     * @brief   The working area.
+     */
+    THD_WORKING_AREA(wa, S);
+
+    /**
+     * @brief   Builds a thread descriptor for this working area.
+     *
+     * @param[in] name      thread name
+     * @param[in] prio      thread priority
+     * @param[in] funcp     thread function pointer
+     * @param[in] arg       thread argument
+     * @return              The thread descriptor.
+     *
+     * @special
+     */
+    constexpr thread_descriptor_t entry(const char *name, tprio_t prio,
+                                        tfunc_t funcp, void *arg) {
+
+      return THD_DESCRIPTOR(name, THD_WORKING_AREA_BASE(wa),
+                            THD_WORKING_AREA_END(wa), prio, funcp, arg);
+    }
+  };
+}
+
+#endif /* _CHSTATIC_HPP_ */
+
+/** @} */
@@ -125,6 +125,15 @@ u32_t sys_arch_sem_wait(sys_sem_t *sem, u32_t timeout) {
   sysinterval_t tmo, remaining;
 
   chSysLock();
+
+  /* Fast path, the semaphore can be taken without waiting so there is no
+     time to account.*/
+  if (chSemGetCounterI(*sem) > (cnt_t)0) {
+    chSemFastWaitI(*sem);
+    chSysUnlock();
+    return 0;
+  }
+
   tmo = timeout > 0 ? TIME_MS2I((time_msecs_t)timeout) : TIME_INFINITE;
   start = chVTGetSystemTimeX();
   if (chSemWaitTimeoutS(*sem, tmo) != MSG_OK) {
@@ -201,11 +210,33 @@ err_t sys_mbox_trypost(sys_mbox_t *mbox, void *msg) {
   return ERR_OK;
 }
 
+err_t sys_mbox_trypost_fromisr(sys_mbox_t *mbox, void *msg) {
+  msg_t rdymsg;
+
+  chSysLockFromISR();
+  rdymsg = chMBPostI(*mbox, (msg_t)msg);
+  chSysUnlockFromISR();
+  if (rdymsg != MSG_OK) {
+    SYS_STATS_INC(mbox.err);
+    return ERR_MEM;
+  }
+  return ERR_OK;
+}
+
 u32_t sys_arch_mbox_fetch(sys_mbox_t *mbox, void **msg, u32_t timeout) {
   systime_t start;
   sysinterval_t tmo, remaining;
 
   chSysLock();
+
+  /* Fast path, a message is already available so there is no time to
+     account. A writer could have been awakened, rescheduling.*/
+  if (chMBFetchI(*mbox, (msg_t *)msg) == MSG_OK) {
+    chSchRescheduleS();
+    chSysUnlock();
+    return 0;
+  }
+
   tmo = timeout > 0 ? TIME_MS2I((time_msecs_t)timeout) : TIME_INFINITE;
   start = chVTGetSystemTimeX();
   if (chMBFetchTimeoutS(*mbox, (msg_t *)msg, tmo) != MSG_OK) {
@@ -251,12 +282,28 @@ sys_thread_t sys_thread_new(const char *name, lwip_thread_fn thread,
 
 sys_prot_t sys_arch_protect(void) {
 
+#if CH_LWIP_USE_PRIORITY_CEILING
+  /* Immediate priority ceiling, no other lwIP user can preempt the caller
+     until the priority is restored. Nesting is implicit because an inner
+     call returns the ceiling itself.*/
+  chDbgAssert(chThdGetPriorityX() <= CH_LWIP_CEILING_PRIORITY,
+              "above ceiling");
+
+  return chThdSetPriority(CH_LWIP_CEILING_PRIORITY);
+#else
   return chSysGetStatusAndLockX();
+#endif
 }
 
 void sys_arch_unprotect(sys_prot_t pval) {
 
+#if CH_LWIP_USE_PRIORITY_CEILING
+  /* Restoring the base priority, a priority inherited from threads waiting
+     on mutexes owned by the caller is retained by the kernel.*/
+  (void) chThdSetPriority((tprio_t)pval);
+#else
   chSysRestoreStatusX((syssts_t)pval);
+#endif
 }
 
 u32_t sys_now(void) {
@@ -53,10 +53,29 @@
 #ifndef __SYS_ARCH_H__
 #define __SYS_ARCH_H__
 
+/*
+ * If enabled, sys_arch_protect() raises the caller priority to
+ * CH_LWIP_CEILING_PRIORITY instead of entering a critical zone, this
+ * way interrupts are never disabled by lwIP.
+ * Note, lwIP must only be invoked from threads with priority lower than
+ * CH_LWIP_CEILING_PRIORITY and never from ISRs.
+ */
+#ifndef CH_LWIP_USE_PRIORITY_CEILING
+#define CH_LWIP_USE_PRIORITY_CEILING FALSE
+#endif
+
+#ifndef CH_LWIP_CEILING_PRIORITY
+#define CH_LWIP_CEILING_PRIORITY HIGHPRIO
+#endif
+
 typedef semaphore_t *   sys_sem_t;
 typedef mailbox_t *     sys_mbox_t;
 typedef thread_t *      sys_thread_t;
+#if CH_LWIP_USE_PRIORITY_CEILING
+typedef tprio_t         sys_prot_t;
+#else
 typedef syssts_t        sys_prot_t;
+#endif
 
 #define SYS_MBOX_NULL   (mailbox_t *)0
 #define SYS_THREAD_NULL (thread_t *)0
@@ -49,10 +49,42 @@ event_source_t shell_terminated;
 /* Module local types.                                                       */
 /*===========================================================================*/
 
+#if (SHELL_USE_ASYNC_COMMANDS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Background command output stream.
+ * @details The output is collected in lines, each line is written on the
+ *          shell channel while holding the shell output lock.
+ */
+typedef struct {
+  const struct BaseSequentialStreamVMT *vmt;
+  BaseSequentialStream  *chp;
+  mutex_t               *mtxp;
+  size_t                n;
+  uint8_t               buf[SHELL_MAX_LINE_LENGTH];
+} shell_job_stream_t;
+
+/**
+ * @brief   Background command descriptor.
+ */
+typedef struct {
+  bool                  busy;
+  thread_t              *owner;
+  shellcmd_t            function;
+  shell_job_stream_t    stream;
+  int                   argc;
+  char                  *argv[SHELL_MAX_ARGUMENTS + 1];
+  char                  line[SHELL_MAX_LINE_LENGTH];
+} shell_job_t;
+#endif
+
 /*===========================================================================*/
 /* Module local variables.                                                   */
 /*===========================================================================*/
 
+#if (SHELL_USE_ASYNC_COMMANDS == TRUE) || defined(__DOXYGEN__)
+static shell_job_t shell_jobs[SHELL_MAX_ASYNC_JOBS];
+#endif
+
 /*===========================================================================*/
 /* Module local functions.                                                   */
 /*===========================================================================*/
@@ -90,6 +122,9 @@ static char *parse_arguments(char *str, char **saveptr) {
   return *p != '\0' ? p : NULL;
 }
 
+static bool get_line(ShellConfig *scfg, char *line, unsigned size,
+                     ShellHistory *shp, void *lockp);
+
 static void list_commands(BaseSequentialStream *chp, const ShellCommand *scp) {
 
   while (scp->sc_name != NULL) {
@@ -98,18 +133,198 @@ static void list_commands(BaseSequentialStream *chp, const ShellCommand *scp) {
   }
 }
 
-static bool cmdexec(const ShellCommand *scp, BaseSequentialStream *chp,
-                      char *name, int argc, char *argv[]) {
+static size_t count_commands(const ShellCommand *scp) {
+  size_t n = 0U;
 
-  while (scp->sc_name != NULL) {
-    if (strcmp(scp->sc_name, name) == 0) {
-      scp->sc_function(chp, argc, argv);
-      return false;
+  if (scp != NULL) {
+    while (scp[n].sc_name != NULL) {
+#if SHELL_USE_SORTED_COMMANDS == TRUE
+      chDbgAssert((n == 0U) || (strcmp(scp[n - 1U].sc_name,
+                                       scp[n].sc_name) < 0),
+                  "commands table not sorted");
+#endif
+      n++;
     }
-    scp++;
   }
-  return true;
+  return n;
+}
+
+static const ShellCommand *find_command(const ShellCommand *scp, size_t n,
+                                        const char *name) {
+#if SHELL_USE_SORTED_COMMANDS == TRUE
+  size_t low = 0U, high = n;
+
+  while (low < high) {
+    size_t mid = low + ((high - low) / 2U);
+    int cmp = strcmp(scp[mid].sc_name, name);
+
+    if (cmp == 0) {
+      return &scp[mid];
+    }
+    if (cmp < 0) {
+      low = mid + 1U;
+    }
+    else {
+      high = mid;
+    }
+  }
+#else
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    if (strcmp(scp[i].sc_name, name) == 0) {
+      return &scp[i];
+    }
+  }
+#endif
+  return NULL;
+}
+
+#if (SHELL_USE_ASYNC_COMMANDS == TRUE) || defined(__DOXYGEN__)
+static void job_stream_flush(shell_job_stream_t *jsp) {
+
+  if (jsp->n > 0U) {
+    chMtxLock(jsp->mtxp);
+    (void) streamWrite(jsp->chp, jsp->buf, jsp->n);
+    chMtxUnlock(jsp->mtxp);
+    jsp->n = 0U;
+  }
+}
+
+static msg_t job_stream_put(void *ip, uint8_t b) {
+  shell_job_stream_t *jsp = (shell_job_stream_t *)ip;
+
+  jsp->buf[jsp->n++] = b;
+  if ((b == (uint8_t)'\n') || (jsp->n >= sizeof (jsp->buf))) {
+    job_stream_flush(jsp);
+  }
+
+  return MSG_OK;
+}
+
+static size_t job_stream_write(void *ip, const uint8_t *bp, size_t n) {
+  size_t i;
+
+  for (i = 0U; i < n; i++) {
+    (void) job_stream_put(ip, bp[i]);
+  }
+
+  return n;
+}
+
+static size_t job_stream_read(void *ip, uint8_t *bp, size_t n) {
+
+  /* Background commands have no input.*/
+  (void)ip;
+  (void)bp;
+  (void)n;
+
+  return 0U;
+}
+
+static msg_t job_stream_get(void *ip) {
+
+  (void)ip;
+
+  return MSG_RESET;
+}
+
+static const struct BaseSequentialStreamVMT job_stream_vmt = {
+  (size_t)0, job_stream_write, job_stream_read, job_stream_put, job_stream_get
+};
+
+static void shell_job(void *arg) {
+  shell_job_t *sjp = (shell_job_t *)arg;
+  BaseSequentialStream *chp = (BaseSequentialStream *)&sjp->stream;
+
+  sjp->function(chp, sjp->argc, sjp->argv);
+  chprintf(chp, SHELL_NEWLINE_STR "[%d] done" SHELL_NEWLINE_STR,
+           (int)(sjp - shell_jobs) + 1);
+  job_stream_flush(&sjp->stream);
+
+  chSysLock();
+  sjp->busy = false;
+  chSysUnlock();
+}
+
+static void wait_jobs(thread_t *tp) {
+  bool busy;
+  int i;
+
+  do {
+    busy = false;
+    chSysLock();
+    for (i = 0; i < SHELL_MAX_ASYNC_JOBS; i++) {
+      if (shell_jobs[i].busy && (shell_jobs[i].owner == tp)) {
+        busy = true;
+      }
+    }
+    chSysUnlock();
+    if (busy) {
+      chThdSleepMilliseconds(10);
+    }
+  } while (busy);
+}
+
+static void cmdexec_async(ShellConfig *scfg, mutex_t *mtxp,
+                          const ShellCommand *cp,
+                          char *line, int argc, char *argv[]) {
+  BaseSequentialStream *chp = scfg->sc_channel;
+  shell_job_t *sjp = NULL;
+  job_descriptor_t *jdp;
+  int i;
+
+  if (scfg->sc_jobs == NULL) {
+    chprintf(chp, "no jobs queue" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  /* Reserving a background command descriptor.*/
+  chSysLock();
+  for (i = 0; i < SHELL_MAX_ASYNC_JOBS; i++) {
+    if (!shell_jobs[i].busy) {
+      sjp = &shell_jobs[i];
+      sjp->busy = true;
+      break;
+    }
+  }
+  chSysUnlock();
+  if (sjp == NULL) {
+    chprintf(chp, "too many jobs" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  jdp = chJobGetTimeout(scfg->sc_jobs, TIME_IMMEDIATE);
+  if (jdp == NULL) {
+    chSysLock();
+    sjp->busy = false;
+    chSysUnlock();
+    chprintf(chp, "jobs queue full" SHELL_NEWLINE_STR);
+    return;
+  }
+
+  /* The line buffer is reused by the shell so arguments are copied in the
+     descriptor, the separators are already replaced by zeros.*/
+  memcpy(sjp->line, line, SHELL_MAX_LINE_LENGTH);
+  for (i = 0; i < argc; i++) {
+    sjp->argv[i] = sjp->line + (argv[i] - line);
+  }
+  sjp->argv[argc] = NULL;
+  sjp->argc        = argc;
+  sjp->function    = cp->sc_function;
+  sjp->owner       = chThdGetSelfX();
+  sjp->stream.vmt  = &job_stream_vmt;
+  sjp->stream.chp  = chp;
+  sjp->stream.mtxp = mtxp;
+  sjp->stream.n    = 0U;
+
+  jdp->jobfunc = shell_job;
+  jdp->jobarg  = (void *)sjp;
+  chJobPost(scfg->sc_jobs, jdp);
+  chprintf(chp, "[%d] started" SHELL_NEWLINE_STR,
+           (int)(sjp - shell_jobs) + 1);
 }
+#endif
 
 #if (SHELL_USE_HISTORY == TRUE) || defined(__DOXYGEN__)
 static void del_histbuff_entry(ShellHistory *shp) {
@@ -337,8 +552,21 @@ THD_FUNCTION(shellThread, p) {
   ShellConfig *scfg = p;
   BaseSequentialStream *chp = scfg->sc_channel;
   const ShellCommand *scp = scfg->sc_commands;
+  const ShellCommand *cp;
+  size_t nlocal, nuser;
   char *lp, *cmd, *tokp, line[SHELL_MAX_LINE_LENGTH];
   char *args[SHELL_MAX_ARGUMENTS + 1];
+  void *lockp = NULL;
+#if SHELL_USE_ASYNC_COMMANDS == TRUE
+  bool async;
+  mutex_t omtx;
+
+  /* Background commands only write on the channel while holding this lock,
+     the shell releases it only while waiting for input.*/
+  chMtxObjectInit(&omtx);
+  chMtxLock(&omtx);
+  lockp = (void *)&omtx;
+#endif
 
 #if !defined(_CHIBIOS_NIL_)
   chRegSetThreadName(SHELL_THREAD_NAME);
@@ -358,6 +586,10 @@ THD_FUNCTION(shellThread, p) {
   ShellHistory *shp = NULL;
 #endif
 
+  /* Tables sizes are computed once, this also checks the ordering.*/
+  nlocal = count_commands(shell_local_commands);
+  nuser  = count_commands(scp);
+
   chprintf(chp, SHELL_NEWLINE_STR);
   chprintf(chp, "ChibiOS/RT Shell" SHELL_NEWLINE_STR);
 #if !defined(_CHIBIOS_NIL_)
@@ -366,7 +598,7 @@ THD_FUNCTION(shellThread, p) {
   while (true) {
 #endif
     chprintf(chp, SHELL_PROMPT_STR);
-    if (shellGetLine(scfg, line, sizeof(line), shp)) {
+    if (get_line(scfg, line, sizeof(line), shp, lockp)) {
 #if (SHELL_CMD_EXIT_ENABLED == TRUE) && !defined(_CHIBIOS_NIL_)
       chprintf(chp, SHELL_NEWLINE_STR);
       chprintf(chp, "logout");
@@ -389,22 +621,52 @@ THD_FUNCTION(shellThread, p) {
       args[n++] = lp;
     }
     args[n] = NULL;
+#if SHELL_USE_ASYNC_COMMANDS == TRUE
+    /* A trailing "&" requests execution as a background job.*/
+    async = false;
+    if ((n > 0) && (strcmp(args[n - 1], "&") == 0)) {
+      async = true;
+      args[--n] = NULL;
+
+      /* Commands acting on the shell itself cannot be executed by the
+         jobs queue.*/
+      if ((cmd != NULL) &&
+          ((strcmp(cmd, "help") == 0) || (strcmp(cmd, "exit") == 0))) {
+        chprintf(chp, "%s: not a background command" SHELL_NEWLINE_STR, cmd);
+        cmd = NULL;
+      }
+    }
+#endif
     if (cmd != NULL) {
       if (strcmp(cmd, "help") == 0) {
         if (n > 0) {
           shellUsage(chp, "help");
-          continue;
         }
-        chprintf(chp, "Commands: help ");
-        list_commands(chp, shell_local_commands);
-        if (scp != NULL)
-          list_commands(chp, scp);
-        chprintf(chp, SHELL_NEWLINE_STR);
+        else {
+          chprintf(chp, "Commands: help ");
+          list_commands(chp, shell_local_commands);
+          if (scp != NULL)
+            list_commands(chp, scp);
+          chprintf(chp, SHELL_NEWLINE_STR);
+        }
       }
-      else if (cmdexec(shell_local_commands, chp, cmd, n, args) &&
-          ((scp == NULL) || cmdexec(scp, chp, cmd, n, args))) {
-        chprintf(chp, "%s", cmd);
-        chprintf(chp, " ?" SHELL_NEWLINE_STR);
+      else {
+        cp = find_command(shell_local_commands, nlocal, cmd);
+        if (cp == NULL) {
+          cp = find_command(scp, nuser, cmd);
+        }
+        if (cp == NULL) {
+          chprintf(chp, "%s", cmd);
+          chprintf(chp, " ?" SHELL_NEWLINE_STR);
+        }
+#if SHELL_USE_ASYNC_COMMANDS == TRUE
+        else if (async) {
+          cmdexec_async(scfg, &omtx, cp, line, n, args);
+        }
+#endif
+        else {
+          cp->sc_function(chp, n, args);
+        }
       }
     }
   }
@@ -430,6 +692,9 @@ void shellInit(void) {
  * @brief   Terminates the shell.
  * @note    Must be invoked from the command handlers.
  * @note    Does not return.
+ * @note    If @p SHELL_USE_ASYNC_COMMANDS is enabled then the mutexes owned
+ *          by the shell thread are released and the background commands
+ *          started by the shell are awaited before terminating.
  *
  * @param[in] msg       shell exit code
  *
@@ -437,6 +702,11 @@ void shellInit(void) {
  */
 void shellExit(msg_t msg) {
 
+#if SHELL_USE_ASYNC_COMMANDS == TRUE
+  chMtxUnlockAll();
+  wait_jobs(chThdGetSelfX());
+#endif
+
   /* Atomically broadcasting the event source and terminating the thread,
      there is not a chSysUnlock() because the thread terminates upon return.*/
   chSysLock();
@@ -445,27 +715,12 @@ void shellExit(msg_t msg) {
 }
 #endif
 
-/**
- * @brief   Reads a whole line from the input channel.
- * @note    Input chars are echoed on the same stream object with the
- *          following exceptions:
- *          - DEL and BS are echoed as BS-SPACE-BS.
- *          - CR is echoed as CR-LF.
- *          - 0x4 is echoed as "^D".
- *          - Other values below 0x20 are not echoed.
- *          .
- *
- * @param[in] scfg      pointer to a @p ShellConfig object
- * @param[in] line      pointer to the line buffer
- * @param[in] size      buffer maximum length
- * @param[in] shp       pointer to a @p ShellHistory object or NULL
- * @return              The operation status.
- * @retval true         the channel was reset or CTRL-D pressed.
- * @retval false        operation successful.
- *
- * @api
+/*
+ * Line input, the output lock, if specified, is released while waiting for
+ * input chars.
  */
-bool shellGetLine(ShellConfig *scfg, char *line, unsigned size, ShellHistory *shp) {
+static bool get_line(ShellConfig *scfg, char *line, unsigned size,
+                     ShellHistory *shp, void *lockp) {
   char *p = line;
   BaseSequentialStream *chp = scfg->sc_channel;
 #if SHELL_USE_ESC_SEQ == TRUE
@@ -479,8 +734,22 @@ bool shellGetLine(ShellConfig *scfg, char *line, unsigned size, ShellHistory *sh
 
   while (true) {
     char c;
+    size_t n;
 
-    if (streamRead(chp, (uint8_t *)&c, 1) == 0)
+#if SHELL_USE_ASYNC_COMMANDS == TRUE
+    if (lockp != NULL) {
+      chMtxUnlock((mutex_t *)lockp);
+      n = streamRead(chp, (uint8_t *)&c, 1);
+      chMtxLock((mutex_t *)lockp);
+    }
+    else {
+      n = streamRead(chp, (uint8_t *)&c, 1);
+    }
+#else
+    (void) lockp;
+    n = streamRead(chp, (uint8_t *)&c, 1);
+#endif
+    if (n == 0)
       return true;
 #if SHELL_USE_ESC_SEQ == TRUE
     if (c == 27) {
@@ -601,4 +870,29 @@ bool shellGetLine(ShellConfig *scfg, char *line, unsigned size, ShellHistory *sh
   }
 }
 
+/**
+ * @brief   Reads a whole line from the input channel.
+ * @note    Input chars are echoed on the same stream object with the
+ *          following exceptions:
+ *          - DEL and BS are echoed as BS-SPACE-BS.
+ *          - CR is echoed as CR-LF.
+ *          - 0x4 is echoed as "^D".
+ *          - Other values below 0x20 are not echoed.
+ *          .
+ *
+ * @param[in] scfg      pointer to a @p ShellConfig object
+ * @param[in] line      pointer to the line buffer
+ * @param[in] size      buffer maximum length
+ * @param[in] shp       pointer to a @p ShellHistory object or NULL
+ * @return              The operation status.
+ * @retval true         the channel was reset or CTRL-D pressed.
+ * @retval false        operation successful.
+ *
+ * @api
+ */
+bool shellGetLine(ShellConfig *scfg, char *line, unsigned size, ShellHistory *shp) {
+
+  return get_line(scfg, line, size, shp, NULL);
+}
+
 /** @} */
@@ -92,6 +92,35 @@
 #define SHELL_USE_ESC_SEQ           FALSE
 #endif
 
+/**
+ * @brief   Enable binary search of the commands tables.
+ * @note    When enabled the default commands and the user commands tables
+ *          must be sorted by name in @p strcmp() order.
+ */
+#if !defined(SHELL_USE_SORTED_COMMANDS) || defined(__DOXYGEN__)
+#define SHELL_USE_SORTED_COMMANDS   FALSE
+#endif
+
+/**
+ * @brief   Enable execution of commands as background jobs.
+ * @details A command line terminated by "&" is executed by the jobs
+ *          queue specified in the shell configuration, the command output
+ *          is written on the shell stream line by line, while the shell is
+ *          not executing a command.
+ * @note    Commands executed in background must be reentrant, "help" and
+ *          "exit" are rejected.
+ */
+#if !defined(SHELL_USE_ASYNC_COMMANDS) || defined(__DOXYGEN__)
+#define SHELL_USE_ASYNC_COMMANDS    FALSE
+#endif
+
+/**
+ * @brief   Maximum number of background jobs in execution.
+ */
+#if !defined(SHELL_MAX_ASYNC_JOBS) || defined(__DOXYGEN__)
+#define SHELL_MAX_ASYNC_JOBS        2
+#endif
+
 /**
  * @brief   Prompt string
  */
@@ -117,6 +146,18 @@
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (SHELL_USE_ASYNC_COMMANDS == TRUE) && (CH_CFG_USE_JOBS == FALSE)
+#error "SHELL_USE_ASYNC_COMMANDS requires CH_CFG_USE_JOBS"
+#endif
+
+#if (SHELL_USE_ASYNC_COMMANDS == TRUE) && (CH_CFG_USE_MUTEXES == FALSE)
+#error "SHELL_USE_ASYNC_COMMANDS requires CH_CFG_USE_MUTEXES"
+#endif
+
+#if (SHELL_USE_ASYNC_COMMANDS == TRUE) && (SHELL_MAX_ASYNC_JOBS < 1)
+#error "invalid SHELL_MAX_ASYNC_JOBS value"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -168,6 +209,10 @@ typedef struct {
   char                  **sc_completion;    /**< @brief Shell command completion
                                                  buffer.                    */
 #endif
+#if (SHELL_USE_ASYNC_COMMANDS == TRUE) || defined(__DOXYGEN__)
+  jobs_queue_t          *sc_jobs;           /**< @brief Jobs queue executing
+                                                 background commands.       */
+#endif
 } ShellConfig;
 
 /*===========================================================================*/
@@ -22,6 +22,7 @@
  * @{
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "ch.h"
@@ -33,6 +34,8 @@
 #if (SHELL_CMD_TEST_ENABLED == TRUE) || defined(__DOXYGEN__)
 #include "rt_test_root.h"
 #include "oslib_test_root.h"
+#elif SHELL_CMD_BENCH_ENABLED == TRUE
+#include "rt_test_root.h"
 #endif
 
 /*===========================================================================*/
@@ -47,14 +50,60 @@
 /* Module local types.                                                       */
 /*===========================================================================*/
 
+#if (SHELL_CMD_BENCH_ENABLED == TRUE) || defined(__DOXYGEN__)
+/**
+ * @brief   Benchmark run, the RT benchmarks sequence or a single benchmark
+ *          wrapped in a test suite.
+ */
+typedef struct {
+  BaseSequentialStream      *chp;
+  const testcase_t          *cases[2];
+  testsequence_t            sequence;
+  const testsequence_t      *sequences[2];
+  testsuite_t               suite;
+} bench_run_t;
+#endif
+
 /*===========================================================================*/
 /* Module local variables.                                                   */
 /*===========================================================================*/
 
+#if (SHELL_CMD_TEST_ENABLED == TRUE) || (SHELL_CMD_BENCH_ENABLED == TRUE) ||  \
+    defined(__DOXYGEN__)
+/**
+ * @brief   Test framework in use, it is not reentrant.
+ */
+static bool test_busy;
+#endif
+
 /*===========================================================================*/
 /* Module local functions.                                                   */
 /*===========================================================================*/
 
+#if (SHELL_CMD_TEST_ENABLED == TRUE) || (SHELL_CMD_BENCH_ENABLED == TRUE) ||  \
+    defined(__DOXYGEN__)
+static bool test_acquire(BaseSequentialStream *chp) {
+  bool busy;
+
+  chSysLock();
+  busy = test_busy;
+  test_busy = true;
+  chSysUnlock();
+  if (busy) {
+    chprintf(chp, "test framework busy" SHELL_NEWLINE_STR);
+  }
+
+  return !busy;
+}
+
+static void test_release(void) {
+
+  chSysLock();
+  test_busy = false;
+  chSysUnlock();
+}
+#endif
+
 #if ((SHELL_CMD_EXIT_ENABLED == TRUE) && !defined(_CHIBIOS_NIL_)) ||        \
     defined(__DOXYGEN__)
 static void cmd_exit(BaseSequentialStream *chp, int argc, char *argv[]) {
@@ -213,14 +262,83 @@ static void cmd_test(BaseSequentialStream *chp, int argc, char *argv[]) {
     shellUsage(chp, "test rt|oslib");
     return;
   }
+  if (!test_acquire(chp)) {
+    return;
+  }
   tp = chThdCreateFromHeap(NULL, SHELL_CMD_TEST_WA_SIZE,
                            "test", chThdGetPriorityX(),
                            tfp, chp);
   if (tp == NULL) {
     chprintf(chp, "out of memory" SHELL_NEWLINE_STR);
+  }
+  else {
+    chThdWait(tp);
+  }
+  test_release();
+}
+#endif
+
+#if (SHELL_CMD_BENCH_ENABLED == TRUE) || defined(__DOXYGEN__)
+static THD_FUNCTION(bench_rt, arg) {
+  bench_run_t *brp = (bench_run_t *)arg;
+  test_execute(brp->chp, &brp->suite);
+}
+
+static void cmd_bench(BaseSequentialStream *chp, int argc, char *argv[]) {
+  const testcase_t * const *cases = rt_test_sequence_012.cases;
+  bench_run_t br;
+  thread_t *tp;
+  int i, n;
+
+  if (argc > 1) {
+    shellUsage(chp, "bench [list|<n>]");
     return;
   }
-  chThdWait(tp);
+
+  /* Counting the available benchmarks.*/
+  for (n = 0; cases[n] != NULL; n++) {
+  }
+
+  if (argc == 0) {
+    br.sequence.name  = rt_test_sequence_012.name;
+    br.sequence.cases = cases;
+  }
+  else if (strcmp(argv[0], "list") == 0) {
+    for (i = 0; i < n; i++) {
+      chprintf(chp, "%2d %s" SHELL_NEWLINE_STR, i + 1, cases[i]->name);
+    }
+    return;
+  }
+  else {
+    i = atoi(argv[0]);
+    if ((i < 1) || (i > n)) {
+      shellUsage(chp, "bench [list|<n>]");
+      return;
+    }
+    br.cases[0] = cases[i - 1];
+    br.cases[1] = NULL;
+    br.sequence.name  = cases[i - 1]->name;
+    br.sequence.cases = br.cases;
+  }
+  br.chp          = chp;
+  br.sequences[0] = &br.sequence;
+  br.sequences[1] = NULL;
+  br.suite.name      = "ChibiOS/RT Benchmarks";
+  br.suite.sequences = br.sequences;
+
+  if (!test_acquire(chp)) {
+    return;
+  }
+  tp = chThdCreateFromHeap(NULL, SHELL_CMD_TEST_WA_SIZE,
+                           "bench", chThdGetPriorityX(),
+                           bench_rt, &br);
+  if (tp == NULL) {
+    chprintf(chp, "out of memory" SHELL_NEWLINE_STR);
+  }
+  else {
+    chThdWait(tp);
+  }
+  test_release();
 }
 #endif
 
@@ -230,28 +348,33 @@ static void cmd_test(BaseSequentialStream *chp, int argc, char *argv[]) {
 
 /**
  * @brief   Array of the default commands.
+ * @note    The array is sorted by name as required when
+ *          @p SHELL_USE_SORTED_COMMANDS is enabled.
  */
 const ShellCommand shell_local_commands[] = {
+#if SHELL_CMD_BENCH_ENABLED == TRUE
+  {"bench", cmd_bench},
+#endif
+#if SHELL_CMD_ECHO_ENABLED == TRUE
+  {"echo", cmd_echo},
+#endif
 #if (SHELL_CMD_EXIT_ENABLED == TRUE) && !defined(_CHIBIOS_NIL_)
   {"exit", cmd_exit},
 #endif
 #if SHELL_CMD_INFO_ENABLED == TRUE
   {"info", cmd_info},
 #endif
-#if SHELL_CMD_ECHO_ENABLED == TRUE
-  {"echo", cmd_echo},
+#if SHELL_CMD_MEM_ENABLED == TRUE
+  {"mem", cmd_mem},
 #endif
 #if SHELL_CMD_SYSTIME_ENABLED == TRUE
   {"systime", cmd_systime},
 #endif
-#if SHELL_CMD_MEM_ENABLED == TRUE
-  {"mem", cmd_mem},
+#if SHELL_CMD_TEST_ENABLED == TRUE
+  {"test", cmd_test},
 #endif
 #if SHELL_CMD_THREADS_ENABLED == TRUE
   {"threads", cmd_threads},
-#endif
-#if SHELL_CMD_TEST_ENABLED == TRUE
-  {"test", cmd_test},
 #endif
   {NULL, NULL}
 };
@@ -65,6 +65,10 @@
 #define SHELL_CMD_TEST_WA_SIZE              THD_WORKING_AREA_SIZE(256)
 #endif
 
+#if !defined(SHELL_CMD_BENCH_ENABLED) || defined(__DOXYGEN__)
+#define SHELL_CMD_BENCH_ENABLED             FALSE
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
@@ -81,6 +85,10 @@
 #error "SHELL_CMD_THREADS_ENABLED requires CH_CFG_USE_REGISTRY"
 #endif
 
+#if (SHELL_CMD_BENCH_ENABLED == TRUE) && (CH_CFG_USE_HEAP == FALSE)
+#error "SHELL_CMD_BENCH_ENABLED requires CH_CFG_USE_HEAP"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -82,5 +82,5 @@ int custom_rand_generate_block(unsigned char* output, unsigned int sz);
 
 /* Realloc (to use without USE_FAST_MATH) */
 
-void *chHeapRealloc (void *addr, uint32_t size);
-#define XREALLOC(p,n,h,t) chHeapRealloc( (p) , (n) )
+void *chibios_realloc(void *ptr, int size);
+#define XREALLOC(p,n,h,t) chibios_realloc( (p) , (n) )
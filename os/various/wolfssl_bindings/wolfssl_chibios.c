@@ -200,45 +200,6 @@ uint32_t TimeNowInMilliseconds(void)
     return ST2MS(t);
 }
 
-void *chHeapRealloc (void *addr, uint32_t size)
-{
-    union heap_header *hp;
-    uint32_t prev_size, new_size;
-
-    void *ptr;
-
-    if(addr == NULL) {
-        return chHeapAlloc(NULL, size);
-    }
-
-    /* previous allocated segment is preceded by an heap_header */
-    hp = addr - sizeof(union heap_header);
-    prev_size = hp->used.size; /* size is always multiple of 8 */
-
-    /* check new size memory alignment */
-    if(size % 8 == 0) {
-        new_size = size;
-    }
-    else {
-        new_size = ((int) (size / 8)) * 8 + 8;
-    }
-
-    if(prev_size >= new_size) {
-        return addr;
-    }
-
-    ptr = chHeapAlloc(NULL, size);
-    if(ptr == NULL) {
-        return NULL;
-    }
-
-    memcpy(ptr, addr, prev_size);
-
-    chHeapFree(addr);
-
-    return ptr;
-}
-
 void *chibios_alloc(void *heap, int size)
 {
     return chHeapAlloc(heap, size);
@@ -250,3 +211,8 @@ void chibios_free(void *ptr)
         chHeapFree(ptr);
 }
 
+void *chibios_realloc(void *ptr, int size)
+{
+    return chHeapRealloc(ptr, size);
+}
+
@@ -65,6 +65,7 @@ int wolfssl_recv_cb(WOLFSSL *ssl, char *buf, int sz, void *ctx);
 
 void *chibios_alloc(void *heap, int size);
 void chibios_free(void *ptr);
+void *chibios_realloc(void *ptr, int size);
 word32 LowResTimer(void);
 
 #endif
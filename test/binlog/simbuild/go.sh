@@ -0,0 +1,41 @@
+#!/bin/bash
+# Binary log round trip, frames are recorded by the target code, decoded by
+# tools/binlog/binlog_decode.py and compared with the text that chprintf()
+# produces for the same records.
+
+DECODER=../../../tools/binlog/binlog_decode.py
+
+echo -n "  * Building..."
+if ! make > buildlog.txt
+then
+  echo "failed"
+  exit 1
+fi
+echo "OK"
+
+echo -n "  * Recording..."
+if ! ./build/ch capture.bin expected.txt
+then
+  echo "failed"
+  exit 1
+fi
+echo "OK"
+
+echo -n "  * Decoding..."
+if ! python3 $DECODER ./build/ch capture.bin > decoded.txt
+then
+  echo "failed"
+  exit 1
+fi
+echo "OK"
+
+echo -n "  * Comparing..."
+if ! sed -e 's/^\[ *[0-9]*:[0-9]*\] //' decoded.txt | diff expected.txt - > difflog.txt
+then
+  echo "failed"
+  cat difflog.txt
+  exit 1
+fi
+echo "OK"
+
+rm -f buildlog.txt difflog.txt capture.bin expected.txt decoded.txt
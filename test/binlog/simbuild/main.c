@@ -0,0 +1,139 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "chprintf.h"
+#include "memstreams.h"
+#include "binlog.h"
+
+/*
+ * Records a log entry and writes the text expected from the decoder, as
+ * formatted by chprintf() on the target.
+ */
+#define LOG(fmt, ...) do {                                                  \
+  BLOG(fmt, ##__VA_ARGS__);                                                 \
+  expect(fmt, ##__VA_ARGS__);                                               \
+} while (false)
+
+static uint8_t capture[0x10000];
+static MemoryStream ms;
+static FILE *expected;
+
+static void expect(const char *fmt, ...) {
+  char buf[128];
+  va_list ap;
+
+  va_start(ap, fmt);
+  (void) chvsnprintf(buf, sizeof (buf), fmt, ap);
+  va_end(ap);
+  fprintf(expected, "%s\n", buf);
+}
+
+static void drain(void) {
+
+  (void) binlogDrain((BaseSequentialStream *)&ms);
+  chDbgAssert(ms.eos < ms.size, "capture full");
+}
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+  FILE *f;
+  unsigned i, n;
+
+  if (argc != 3) {
+    fprintf(stderr, "Usage: %s <capture.bin> <expected.txt>\n", argv[0]);
+    exit(2);
+  }
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  binlogInit();
+  msObjectInit(&ms, capture, sizeof (capture), 0U);
+  expected = fopen(argv[2], "w");
+  if (expected == NULL) {
+    exit(2);
+  }
+
+  /*
+   * Conversions, the buffer is drained after each record.
+   */
+  LOG("no arguments"); drain();
+  LOG("%d %d %d", 0, 1234, -1234); drain();
+  LOG("%+d %+d", 5, -5); drain();
+  LOG("%u %u", 0U, 4294967295U); drain();
+  LOG("%x %X %08X", 0xABCDU, 0xDEADBEEFU, 0x12U); drain();
+  LOG("%o %5o", 8U, 64U); drain();
+  LOG("[%6d] [%-6d] [%06d] [%+06d]", 42, 42, -42, 42); drain();
+  LOG("%ld %lu %lx", -7L, 7UL, 255UL); drain();
+  LOG("%c%c%c [%3c]", 'a', 'b', 'c', 'z'); drain();
+  LOG("%s", "string"); drain();
+  LOG("[%8s] [%-8s] [%.3s] [%5.2s]", "abc", "abc", "abcdef", "abcdef"); drain();
+  LOG("%s", NULL); drain();
+  LOG("100%% done"); drain();
+  LOG("%d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8); drain();
+
+  /*
+   * Widths and precisions taken from the arguments.
+   */
+  LOG("[%*d]", 6, 42); drain();
+  LOG("[%-*d]", 6, 42); drain();
+  LOG("[%0*X]", 8, 0xBEEFU); drain();
+  LOG("[%*d]", -6, 42); drain();
+  LOG("[%.*s]", 2, "abcdef"); drain();
+  LOG("[%*.*s] %u", 6, 3, "abcdef", 99U); drain();
+  LOG("[%.*s]", 0, "abcdef"); drain();
+  LOG("[%.*s]", -1, "abcdef"); drain();
+
+  /*
+   * Records not fitting the buffer are dropped and reported after the
+   * last stored record.
+   */
+  n = BINLOG_BUFFER_SIZE / (BINLOG_HEADER_SIZE + 4U);
+  for (i = 0U; i < n + 4U; i++) {
+    BLOG("record %u", i);
+    if (i < n) {
+      expect("record %u", i);
+    }
+  }
+  expect("*** %u records dropped ***", 4U);
+  drain();
+  LOG("after drop"); drain();
+
+  fclose(expected);
+
+  f = fopen(argv[1], "wb");
+  if ((f == NULL) || (fwrite(capture, 1U, ms.eos, f) != ms.eos)) {
+    exit(2);
+  }
+  fclose(f);
+
+  exit(0);
+}
@@ -0,0 +1,33 @@
+#!/bin/bash
+# Compares the output of chprintf(), chsnprintf() and of the C++ front-end
+# in chprintf.hpp with the reference unbuffered implementation, for several
+# output buffer sizes. The benchmark results are in the *_run.txt files.
+
+function test() {
+  echo "Configuration $1 ($2)"
+  make clean > /dev/null
+  echo -n "  * Building..."
+  if ! make $2 > buildlog.txt
+  then
+    echo "failed"
+    exit 1
+  fi
+  echo "OK"
+  echo -n "  * Running..."
+  if ! ./build/ch bench > runlog.txt
+  then
+    echo "failed"
+    cat runlog.txt
+    exit 1
+  fi
+  mv -f runlog.txt ${1}_run.txt
+  echo "OK"
+}
+
+test cfg1 "CHPRINTF_BUFFER=0"
+test cfg2 "CHPRINTF_BUFFER=5"
+test cfg3 "CHPRINTF_BUFFER=64"
+test cfg4 "CHPRINTF_BUFFER=64 CHPRINTF_FLOAT=yes"
+
+make clean > /dev/null
+rm -f buildlog.txt
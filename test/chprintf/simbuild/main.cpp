@@ -0,0 +1,410 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "chprintf.h"
+#include "memstreams.h"
+#include "nullstreams.h"
+#include "chprintf.hpp"
+#include "ref_chprintf.h"
+
+#define OUT_SIZE            1024U
+#define BENCH_MIN_NS        200000000ULL
+
+/*
+ * Checks a format against the reference implementation, both using the
+ * C functions and the C++ front-end.
+ */
+#define CHECK(fmt, ...) do {                                                \
+  check_c(__LINE__, fmt, ##__VA_ARGS__);                                    \
+  check_cpp(__LINE__, CH_FMT(fmt), ##__VA_ARGS__);                          \
+} while (false)
+
+/*
+ * Checks a format against the reference implementation using the C
+ * functions only, for the "*" modifiers not supported by the C++ front-end.
+ */
+#define CHECK_C(fmt, ...) check_c(__LINE__, fmt, ##__VA_ARGS__)
+
+/*------------------------------------------------------------------------*
+ * Recording stream.                                                      *
+ *------------------------------------------------------------------------*/
+
+/*
+ * Stream recording the output and the calls performed on it.
+ */
+struct RecordStream {
+  const struct BaseSequentialStreamVMT *vmt;
+  char          data[OUT_SIZE];
+  size_t        n;
+  unsigned      puts;
+  unsigned      writes;
+};
+
+static size_t rec_write(void *ip, const uint8_t *bp, size_t n) {
+  RecordStream *rsp = (RecordStream *)ip;
+
+  rsp->writes++;
+  if (n > OUT_SIZE - rsp->n) {
+    n = OUT_SIZE - rsp->n;
+  }
+  memcpy(&rsp->data[rsp->n], bp, n);
+  rsp->n += n;
+
+  return n;
+}
+
+static size_t rec_read(void *ip, uint8_t *bp, size_t n) {
+
+  (void)ip;
+  (void)bp;
+  (void)n;
+
+  return 0;
+}
+
+static msg_t rec_put(void *ip, uint8_t b) {
+  RecordStream *rsp = (RecordStream *)ip;
+
+  rsp->puts++;
+  if (rsp->n >= OUT_SIZE) {
+    return MSG_RESET;
+  }
+  rsp->data[rsp->n++] = (char)b;
+
+  return MSG_OK;
+}
+
+static msg_t rec_get(void *ip) {
+
+  (void)ip;
+
+  return MSG_RESET;
+}
+
+static const struct BaseSequentialStreamVMT rec_vmt = {
+  (size_t)0, rec_write, rec_read, rec_put, rec_get
+};
+
+static void rec_init(RecordStream *rsp) {
+
+  rsp->vmt   = &rec_vmt;
+  rsp->n     = 0U;
+  rsp->puts  = 0U;
+  rsp->writes = 0U;
+}
+
+/*------------------------------------------------------------------------*
+ * Checks.                                                                *
+ *------------------------------------------------------------------------*/
+
+static unsigned checks, failures;
+static char expected[OUT_SIZE];
+static int expected_n;
+
+static void fail(int line, const char *what, const char *out, size_t n) {
+
+  printf("line %d: %s mismatch\n", line, what);
+  printf("  expected (%d): \"%s\"\n", expected_n, expected);
+  printf("  actual   (%u): \"%.*s\"\n", (unsigned)n, (int)n, out);
+  failures++;
+}
+
+/*
+ * Verifies the output and the calls performed on a recording stream, with
+ * the buffer enabled the output is coalesced so any two consecutive writes
+ * carry more than a buffer worth of data.
+ */
+static void check_stream(int line, const char *what,
+                         const RecordStream *rsp, int n) {
+
+  checks++;
+  if ((n != expected_n) || (rsp->n != (size_t)expected_n) ||
+      (memcmp(rsp->data, expected, rsp->n) != 0)) {
+    fail(line, what, rsp->data, rsp->n);
+    return;
+  }
+#if CHPRINTF_BUFFER_SIZE > 0
+  if ((rsp->puts != 0U) ||
+      (rsp->writes > (2U * ((unsigned)n / CHPRINTF_BUFFER_SIZE)) + 1U)) {
+    printf("line %d: %s buffering, %u puts, %u writes for %d bytes\n",
+           line, what, rsp->puts, rsp->writes, n);
+    failures++;
+  }
+#endif
+}
+
+static void check_string(int line, const char *what,
+                         const char *buf, size_t size, int n) {
+  size_t len = (size_t)expected_n < size ? (size_t)expected_n : size - 1U;
+
+  checks++;
+  if ((n != expected_n) || (strlen(buf) != len) ||
+      (memcmp(buf, expected, len) != 0)) {
+    fail(line, what, buf, strlen(buf));
+  }
+}
+
+static void check_c(int line, const char *fmt, ...) {
+  static const size_t sizes[] = {1U, 2U, 5U, sizeof (expected)};
+  RecordStream rs;
+  char buf[OUT_SIZE];
+  va_list ap;
+  unsigned i;
+  int n;
+
+  va_start(ap, fmt);
+  expected_n = ref_chvsnprintf(expected, sizeof (expected), fmt, ap);
+  va_end(ap);
+
+  rec_init(&rs);
+  va_start(ap, fmt);
+  n = chvprintf((BaseSequentialStream *)(void *)&rs, fmt, ap);
+  va_end(ap);
+  check_stream(line, "chvprintf()", &rs, n);
+
+  for (i = 0U; i < sizeof (sizes) / sizeof (sizes[0]); i++) {
+    memset(buf, 0x55, sizeof (buf));
+    va_start(ap, fmt);
+    n = chvsnprintf(buf, sizes[i], fmt, ap);
+    va_end(ap);
+    check_string(line, "chvsnprintf()", buf, sizes[i], n);
+  }
+}
+
+template <typename S, typename... Args>
+static void check_cpp(int line, S fmt, const Args &... args) {
+  static const size_t sizes[] = {1U, 2U, 5U, sizeof (expected)};
+  RecordStream rs;
+  char buf[OUT_SIZE];
+  unsigned i;
+  int n;
+
+  rec_init(&rs);
+  n = chibios_fmt::print((BaseSequentialStream *)(void *)&rs, fmt, args...);
+  check_stream(line, "chibios_fmt::print()", &rs, n);
+
+  for (i = 0U; i < sizeof (sizes) / sizeof (sizes[0]); i++) {
+    memset(buf, 0x55, sizeof (buf));
+    n = chibios_fmt::snprint(buf, sizes[i], fmt, args...);
+    check_string(line, "chibios_fmt::snprint()", buf, sizes[i], n);
+  }
+}
+
+/*
+ * Strings around the buffer boundaries, the field is placed at any offset
+ * of the buffer by a variable length literal prefix.
+ */
+static void check_boundaries(void) {
+  static const char pattern[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                "abcdefghijklmnopqrstuvwxyz";
+  char s[OUT_SIZE / 4U];
+  size_t len, i;
+  int pre;
+
+  for (len = 0U; len < sizeof (s); len++) {
+    for (i = 0U; i < len; i++) {
+      s[i] = pattern[i % (sizeof (pattern) - 1U)];
+    }
+    s[len] = '\0';
+    for (pre = 0; pre < 8; pre++) {
+      CHECK_C("%.*s[%s]", pre, pattern, s);
+      CHECK_C("%.*s%*s|%-*s|", pre, pattern, (int)len + 1, s, (int)len, s);
+    }
+    CHECK("[%s]", (const char *)s);
+    CHECK("%s%s", (const char *)s, (const char *)s);
+    CHECK("%d%s%c", (int)len, (const char *)s, 'x');
+  }
+}
+
+/*------------------------------------------------------------------------*
+ * Benchmark.                                                             *
+ *------------------------------------------------------------------------*/
+
+/*
+ * Host monotonic time in nanoseconds.
+ */
+static uint64_t host_time_ns(void) {
+  struct timespec ts;
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static void print_rate(const char *name, uint64_t bytes, uint64_t ns) {
+
+  printf("  %-16s %10llu bytes/s\n", name,
+         (unsigned long long)((bytes * 1000000000ULL) / ns));
+}
+
+/*
+ * Runs a print operation on a null stream until the minimum time has
+ * elapsed, the bytes per second rate is printed.
+ */
+#define BENCH(name, expr) do {                                              \
+  uint64_t start = host_time_ns(), bytes = 0U, ns;                          \
+  do {                                                                      \
+    for (unsigned k = 0U; k < 1000U; k++) {                                 \
+      bytes += (uint64_t)(expr);                                            \
+    }                                                                       \
+    ns = host_time_ns() - start;                                            \
+  } while (ns < BENCH_MIN_NS);                                              \
+  print_rate(name, bytes, ns);                                              \
+} while (false)
+
+static void bench(void) {
+  static const char line[] = "the quick brown fox jumps over the lazy dog";
+  BaseSequentialStream *chp;
+  NullStream ns;
+
+  nullObjectInit(&ns);
+  chp = (BaseSequentialStream *)(void *)&ns;
+
+  printf("Literal text\n");
+  BENCH("reference", ref_chprintf(chp, "the quick brown fox jumps over "
+                                       "the lazy dog\r\n"));
+  BENCH("chprintf()", chprintf(chp, "the quick brown fox jumps over "
+                                    "the lazy dog\r\n"));
+  BENCH("chibios_fmt", chibios_fmt::print(chp,
+                         CH_FMT("the quick brown fox jumps over "
+                                "the lazy dog\r\n")));
+
+  printf("Strings\n");
+  BENCH("reference", ref_chprintf(chp, "%s: %-20s|%s\r\n",
+                                  "str", line, line));
+  BENCH("chprintf()", chprintf(chp, "%s: %-20s|%s\r\n",
+                               "str", line, line));
+  BENCH("chibios_fmt", chibios_fmt::print(chp,
+                         CH_FMT("%s: %-20s|%s\r\n"),
+                         "str", (const char *)line, (const char *)line));
+
+  printf("Integers\n");
+  BENCH("reference", ref_chprintf(chp, "%5d %08X %u %o %-6d|\r\n",
+                                  -1234, 0xBEEFU, 4000000000U, 511U, 42));
+  BENCH("chprintf()", chprintf(chp, "%5d %08X %u %o %-6d|\r\n",
+                               -1234, 0xBEEFU, 4000000000U, 511U, 42));
+  BENCH("chibios_fmt", chibios_fmt::print(chp,
+                         CH_FMT("%5d %08X %u %o %-6d|\r\n"),
+                         -1234, 0xBEEFU, 4000000000U, 511U, 42));
+}
+
+/*------------------------------------------------------------------------*
+ * Simulator main.                                                        *
+ *------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[]) {
+  static const char *null_string = NULL;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  chSysInit();
+
+  printf("*** chprintf() equivalence test\n");
+  printf("***\n");
+  printf("*** Buffer size:  %d\n", CHPRINTF_BUFFER_SIZE);
+  printf("*** Float:        %s\n", CHPRINTF_USE_FLOAT ? "yes" : "no");
+  printf("\n");
+
+  /*
+   * Literals and conversions.
+   */
+  CHECK("");
+  CHECK("no arguments");
+  CHECK("100%% done");
+  CHECK("%c%c%c [%3c] [%-3c] [%03c]", 'a', 'b', 'c', 'x', 'y', 'z');
+  CHECK("%s|%s", "string", "");
+  CHECK("[%8s] [%-8s] [%.3s] [%5.2s] [%-5.2s]",
+        "abc", "abc", "abcdef", "abcdef", "abcdef");
+  CHECK("[%08s] [%.0s] [%.10s]", "abc", "abcdef", "abc");
+  CHECK("%s", null_string);
+  CHECK("%d %d %d %d", 0, 1234, -1234, -2147483647 - 1);
+  CHECK("%i %I %D", 7, -7L, 2147483647L);
+  CHECK("%+d %+d %+i", 5, -5, 0);
+  CHECK("[%6d] [%-6d] [%06d] [%+06d] [%-+6d] [%+6d]", 42, 42, -42, 42, 42, 42);
+  CHECK("[%2d] [%02d] [%.3d]", 12345, -12345, 7);
+  CHECK("%u %u %U", 0U, 4294967295U, 4294967295UL);
+  CHECK("%x %X %08X %08x", 0xABCDU, 0xDEADBEEFU, 0x12U, 0xFFFFFFFFU);
+  CHECK("%o %5o %-5o| %O", 8U, 64U, 64U, 8UL);
+  CHECK("%ld %lu %lx %Ld %lX", -7L, 7UL, 255UL, -100000L, 0xCAFEUL);
+  CHECK("%p %08p", (void *)0x1234, (void *)0xABCD);
+  CHECK("%d %d %d %d %d %d %d %d", 1, 2, 3, 4, 5, 6, 7, 8);
+  CHECK("%k %y %%d");
+  CHECK("%s%d%c%x%s", "a", 1, 'b', 2U, "c");
+#if CHPRINTF_USE_FLOAT
+  CHECK("%f %f %f", 0.0, 1.5, -2.25);
+  CHECK("%.1f %.3f %.9f %.12f", 3.14159, 3.14159, 3.14159, 3.14159);
+  CHECK("[%10.2f] [%-10.2f] [%010.2f] [%+.2f] [%+010.2f]",
+        12.5, 12.5, -12.5, 12.5, 12.5);
+  CHECK("%.4f %.4f", 0.0001, 1000000.5);
+#endif
+
+  /*
+   * Widths and precisions taken from the arguments.
+   */
+  CHECK_C("[%*d]", 6, 42);
+  CHECK_C("[%-*d]", 6, 42);
+  CHECK_C("[%0*X]", 8, 0xBEEFU);
+  CHECK_C("[%*d]", -6, 42);
+  CHECK_C("[%.*s]", 2, "abcdef");
+  CHECK_C("[%*.*s] %u", 6, 3, "abcdef", 99U);
+  CHECK_C("[%.*s]", 0, "abcdef");
+  CHECK_C("[%.*s]", -1, "abcdef");
+
+  /*
+   * Truncated specifications, output stops at the string end.
+   */
+  CHECK_C("abc%");
+  CHECK_C("abc%-");
+  CHECK_C("abc%5");
+  CHECK_C("abc%5.");
+  CHECK_C("abc%5.2");
+  CHECK_C("abc%l");
+
+  /*
+   * Fields and literal runs around the buffer boundaries.
+   */
+  check_boundaries();
+
+  printf("Checks:           %u\n", checks);
+  printf("Failures:         %u\n", failures);
+  printf("\n");
+
+  if ((argc > 1) && (strcmp(argv[1], "bench") == 0)) {
+    bench();
+    printf("\n");
+  }
+
+  if (failures > 0U) {
+    printf("Final result: FAILURE\n");
+    exit(1);
+  }
+  printf("Final result: SUCCESS\n");
+
+  return 0;
+}
@@ -0,0 +1,33 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#ifndef REF_CHPRINTF_H
+#define REF_CHPRINTF_H
+
+#include <stdarg.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+  int ref_chvprintf(BaseSequentialStream *chp, const char *fmt, va_list ap);
+  int ref_chprintf(BaseSequentialStream *chp, const char *fmt, ...);
+  int ref_chsnprintf(char *str, size_t size, const char *fmt, ...);
+  int ref_chvsnprintf(char *str, size_t size, const char *fmt, va_list ap);
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* REF_CHPRINTF_H */
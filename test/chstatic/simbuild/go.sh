@@ -0,0 +1,33 @@
+#!/bin/bash
+# Builds the test with the threads table disabled and enabled, each
+# configuration is run five times. The results are in the *_run.txt files.
+
+function test() {
+  echo "Configuration $1 ($2)"
+  make clean > /dev/null
+  echo -n "  * Building..."
+  if ! make $2 > buildlog.txt
+  then
+    echo "failed"
+    exit 1
+  fi
+  echo "OK"
+  echo -n "  * Running..."
+  rm -f ${1}_run.txt
+  for i in 1 2 3 4 5
+  do
+    if ! ./build/ch >> ${1}_run.txt
+    then
+      echo "failed"
+      cat ${1}_run.txt
+      exit 1
+    fi
+  done
+  echo "OK"
+}
+
+test cfg1 "THREADS_TABLE=no"
+test cfg2 "THREADS_TABLE=yes"
+
+make clean > /dev/null
+rm -f buildlog.txt
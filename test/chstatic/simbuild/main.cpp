@@ -0,0 +1,243 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <time.h>
+
+#include "ch.hpp"
+#include "hal.h"
+#include "chstatic.hpp"
+
+using namespace chibios_rt;
+
+#define NUM_THREADS         16U
+#define NUM_POOLS           8U
+#define POOL_OBJECTS        64U
+#define WA_SIZE             1024U
+
+typedef struct {
+  uint32_t                  data[4];
+} object_t;
+
+static uint64_t boot_time, first_time, ready_time;
+static unsigned started;
+
+/*
+ * Host monotonic time in nanoseconds.
+ */
+static uint64_t host_time_ns(void) {
+  struct timespec ts;
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+static void fail(const char *reason) {
+
+  printf("\nFinal result: FAILURE (%s)\n", reason);
+  exit(1);
+}
+
+/*
+ * The first and the last thread record the time of their first run.
+ */
+static THD_FUNCTION(worker, arg) {
+  uint64_t now = host_time_ns();
+
+  (void)arg;
+
+  if (started == 0U) {
+    first_time = now;
+  }
+  if (++started == NUM_THREADS) {
+    ready_time = now;
+  }
+}
+
+static StaticWorkingArea<WA_SIZE> was[NUM_THREADS];
+
+#if CH_CFG_USE_THREADS_TABLE == TRUE
+/*
+ * Pools built by the compiler, arrays of pools are not constant-initialized
+ * by GCC 12 so they are declared individually.
+ */
+constinit static StaticObjectsPool<object_t, POOL_OBJECTS> pool0;
+constinit static StaticObjectsPool<object_t, POOL_OBJECTS> pool1;
+constinit static StaticObjectsPool<object_t, POOL_OBJECTS> pool2;
+constinit static StaticObjectsPool<object_t, POOL_OBJECTS> pool3;
+constinit static StaticObjectsPool<object_t, POOL_OBJECTS> pool4;
+constinit static StaticObjectsPool<object_t, POOL_OBJECTS> pool5;
+constinit static StaticObjectsPool<object_t, POOL_OBJECTS> pool6;
+constinit static StaticObjectsPool<object_t, POOL_OBJECTS> pool7;
+
+static memory_pool_t *const pools[NUM_POOLS] = {
+  pool0.getPoolX(), pool1.getPoolX(), pool2.getPoolX(), pool3.getPoolX(),
+  pool4.getPoolX(), pool5.getPoolX(), pool6.getPoolX(), pool7.getPoolX()
+};
+
+/*
+ * Threads created by chSysInit().
+ */
+THD_TABLE_BEGIN
+  was[0].entry("worker", NORMALPRIO + 1, worker, nullptr),
+  was[1].entry("worker", NORMALPRIO + 1, worker, nullptr),
+  was[2].entry("worker", NORMALPRIO + 1, worker, nullptr),
+  was[3].entry("worker", NORMALPRIO + 1, worker, nullptr),
+  was[4].entry("worker", NORMALPRIO + 1, worker, nullptr),
+  was[5].entry("worker", NORMALPRIO + 1, worker, nullptr),
+  was[6].entry("worker", NORMALPRIO + 1, worker, nullptr),
+  was[7].entry("worker", NORMALPRIO + 1, worker, nullptr),
+  was[8].entry("worker", NORMALPRIO + 1, worker, nullptr),
+  was[9].entry("worker", NORMALPRIO + 1, worker, nullptr),
+  was[10].entry("worker", NORMALPRIO + 1, worker, nullptr),
+  was[11].entry("worker", NORMALPRIO + 1, worker, nullptr),
+  was[12].entry("worker", NORMALPRIO + 1, worker, nullptr),
+  was[13].entry("worker", NORMALPRIO + 1, worker, nullptr),
+  was[14].entry("worker", NORMALPRIO + 1, worker, nullptr),
+  was[15].entry("worker", NORMALPRIO + 1, worker, nullptr),
+THD_TABLE_END
+
+static void prefault(void) {
+  const volatile uint8_t *p;
+  unsigned i;
+  size_t j;
+
+  /* The pools are already in their final state, reading them is enough.*/
+  for (i = 0U; i < NUM_POOLS; i++) {
+    p = (const volatile uint8_t *)pools[i]->next;
+    for (j = 0U; j < POOL_OBJECTS * sizeof (object_t); j += 64U) {
+      (void)p[j];
+    }
+  }
+}
+
+#else /* CH_CFG_USE_THREADS_TABLE == FALSE */
+/*
+ * Pools loaded by main().
+ */
+static memory_pool_t pools_objs[NUM_POOLS];
+static object_t pools_storage[NUM_POOLS][POOL_OBJECTS];
+static memory_pool_t *const pools[NUM_POOLS] = {
+  &pools_objs[0], &pools_objs[1], &pools_objs[2], &pools_objs[3],
+  &pools_objs[4], &pools_objs[5], &pools_objs[6], &pools_objs[7]
+};
+
+static void prefault(void) {
+
+  memset(pools_storage, 0, sizeof pools_storage);
+}
+#endif /* CH_CFG_USE_THREADS_TABLE == FALSE */
+
+/*
+ * Allocates all the objects of a pool, the objects must be distinct and
+ * the pool must be empty after the last allocation.
+ */
+static void check_pool(memory_pool_t *mp) {
+  object_t *objs[POOL_OBJECTS];
+  unsigned i, j;
+
+  for (i = 0U; i < POOL_OBJECTS; i++) {
+    objs[i] = (object_t *)chPoolAlloc(mp);
+    if (objs[i] == NULL) {
+      fail("pool too small");
+    }
+    for (j = 0U; j < i; j++) {
+      if (objs[j] == objs[i]) {
+        fail("object allocated twice");
+      }
+    }
+    memset(objs[i], 0x55, sizeof (object_t));
+  }
+  if (chPoolAlloc(mp) != NULL) {
+    fail("pool too large");
+  }
+  for (i = 0U; i < POOL_OBJECTS; i++) {
+    chPoolFree(mp, objs[i]);
+  }
+}
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+  unsigned i;
+
+  (void)argc;
+  (void)argv;
+
+  /*
+   * Page faults on the host would be accounted to the boot time, all the
+   * memory used during the boot is touched in advance.
+   */
+  for (i = 0U; i < NUM_THREADS; i++) {
+    memset(was[i].wa, 0, sizeof was[i].wa);
+  }
+  prefault();
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+
+  /* The boot time is measured from the kernel initialization, the HAL
+     initialization is the same in both the configurations.*/
+  boot_time = host_time_ns();
+  chSysInit();
+
+#if CH_CFG_USE_THREADS_TABLE == FALSE
+  /*
+   * Pools loading and threads creation at runtime.
+   */
+  for (i = 0U; i < NUM_POOLS; i++) {
+    chPoolObjectInit(pools[i], sizeof (object_t), NULL);
+    chPoolLoadArray(pools[i], pools_storage[i], POOL_OBJECTS);
+  }
+  for (i = 0U; i < NUM_THREADS; i++) {
+    (void) chThdCreateStatic(was[i].wa, sizeof was[i].wa, NORMALPRIO + 1,
+                             worker, NULL);
+  }
+#endif
+
+  /* All the threads have a priority above NORMALPRIO so they ran before
+     getting here.*/
+  if (started != NUM_THREADS) {
+    fail("threads not started");
+  }
+  for (i = 0U; i < NUM_POOLS; i++) {
+    check_pool(pools[i]);
+  }
+
+  printf("*** Threads table:  %s\n",
+         CH_CFG_USE_THREADS_TABLE == TRUE ? "yes" : "no");
+  printf("*** Threads:        %u\n", NUM_THREADS);
+  printf("*** Pools:          %u x %u objects\n", NUM_POOLS, POOL_OBJECTS);
+  printf("\n");
+  printf("Boot to first thread, nanoseconds\n");
+  printf("  %" PRIu64 "\n", first_time - boot_time);
+  printf("Boot to all threads started, nanoseconds\n");
+  printf("  %" PRIu64 "\n", ready_time - boot_time);
+  printf("\nFinal result: SUCCESS\n");
+
+  return 0;
+}
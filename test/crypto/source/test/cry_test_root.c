@@ -30,6 +30,10 @@
  * - @subpage cry_test_sequence_007
  * - @subpage cry_test_sequence_008
  * - @subpage cry_test_sequence_009
+ * - @subpage cry_test_sequence_010
+ * - @subpage cry_test_sequence_011
+ * - @subpage cry_test_sequence_012
+ * - @subpage cry_test_sequence_013
  * .
  */
 
@@ -60,6 +64,12 @@ const testsequence_t * const cry_test_suite_array[] = {
   &cry_test_sequence_007,
   &cry_test_sequence_008,
   &cry_test_sequence_009,
+  &cry_test_sequence_010,
+#if (HAL_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+  &cry_test_sequence_011,
+#endif
+  &cry_test_sequence_012,
+  &cry_test_sequence_013,
   NULL
 };
 
@@ -33,6 +33,10 @@
 #include "cry_test_sequence_007.h"
 #include "cry_test_sequence_008.h"
 #include "cry_test_sequence_009.h"
+#include "cry_test_sequence_010.h"
+#include "cry_test_sequence_011.h"
+#include "cry_test_sequence_012.h"
+#include "cry_test_sequence_013.h"
 
 #if !defined(__DOXYGEN__)
 
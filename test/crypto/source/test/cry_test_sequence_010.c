@@ -0,0 +1,422 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "cry_test_root.h"
+
+/**
+ * @file    cry_test_sequence_010.c
+ * @brief   Test Sequence 010 code.
+ *
+ * @page cry_test_sequence_010 [10] Benchmarks
+ *
+ * File: @ref cry_test_sequence_010.c
+ *
+ * <h2>Description</h2>
+ * Cycles per byte benchmarks of the cipher and hash functions, the
+ * sequence is self-contained and runs on the simulator using the
+ * software fallback.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage cry_test_010_001
+ * - @subpage cry_test_010_002
+ * - @subpage cry_test_010_003
+ * - @subpage cry_test_010_004
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#define BENCH_SIZE                          512U
+#define BENCH_CHUNK                         64U
+#define BENCH_DURATION                      OSAL_MS2I(1000)
+
+#if HAL_CRY_ENFORCE_FALLBACK == TRUE
+static CRYDriver crybench;
+#define BENCH_DRIVER                        crybench
+#else
+#define BENCH_DRIVER                        CRYD1
+#endif
+
+typedef cryerror_t (*benchfn_t)(CRYDriver *cryp);
+
+static ALIGNED_VAR(4) uint8_t bench_in[BENCH_SIZE];
+static ALIGNED_VAR(4) uint8_t bench_out[BENCH_SIZE];
+static ALIGNED_VAR(4) uint8_t bench_chk[BENCH_SIZE];
+static uint8_t bench_tag[16];
+static uint8_t bench_iv[16];
+static AESGCMContext bench_gcm;
+static SHA256Context bench_sha;
+
+static const uint8_t bench_key[16] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+
+static const uint8_t bench_aad[16] = {
+  0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef,
+  0xfe, 0xed, 0xfa, 0xce, 0xde, 0xad, 0xbe, 0xef
+};
+
+static void bench_setup(void) {
+
+#if HAL_CRY_ENFORCE_FALLBACK == TRUE
+  cryObjectInit(&crybench);
+#endif
+  cryStart(&BENCH_DRIVER, NULL);
+  memset(bench_in, 0x55, BENCH_SIZE);
+  memset(bench_iv, 0, sizeof bench_iv);
+  (void) cryLoadAESTransientKey(&BENCH_DRIVER, sizeof bench_key, bench_key);
+}
+
+static cryerror_t bench_aes_ctr(CRYDriver *cryp) {
+
+  return cryEncryptAES_CTR(cryp, 0, BENCH_SIZE, bench_in, bench_out,
+                           bench_iv);
+}
+
+static cryerror_t bench_aes_gcm(CRYDriver *cryp) {
+
+  return cryEncryptAES_GCM(cryp, 0, sizeof bench_aad, bench_aad,
+                           BENCH_SIZE, bench_in, bench_out, bench_iv,
+                           sizeof bench_tag, bench_tag);
+}
+
+static cryerror_t bench_aes_gcm_stream(CRYDriver *cryp) {
+  cryerror_t err;
+  size_t n;
+
+  err = cryAES_GCMInit(cryp, &bench_gcm, 0, bench_iv,
+                       sizeof bench_aad, bench_aad);
+  for (n = 0U; (err == CRY_NOERROR) && (n < BENCH_SIZE); n += BENCH_CHUNK) {
+    err = cryEncryptAES_GCMUpdate(cryp, &bench_gcm, BENCH_CHUNK,
+                                  bench_in + n, bench_out + n);
+  }
+  if (err == CRY_NOERROR) {
+    err = cryEncryptAES_GCMFinal(cryp, &bench_gcm,
+                                 sizeof bench_tag, bench_tag);
+  }
+  return err;
+}
+
+static cryerror_t bench_sha256(CRYDriver *cryp) {
+  cryerror_t err;
+
+  err = crySHA256Init(cryp, &bench_sha);
+  if (err == CRY_NOERROR) {
+    err = crySHA256Update(cryp, &bench_sha, BENCH_SIZE, bench_in);
+  }
+  if (err == CRY_NOERROR) {
+    err = crySHA256Final(cryp, &bench_sha, bench_out);
+  }
+  return err;
+}
+
+/*
+ * Runs the operation on a BENCH_SIZE buffer for one second, the score is
+ * printed as bytes per second and as realtime counter ticks per byte, the
+ * latter is the cycles per byte figure on ports where the realtime counter
+ * is clocked by the core.
+ */
+static void bench_run(benchfn_t fn) {
+  systime_t start, end;
+  uint64_t ticks = 0U;
+  uint32_t bytes = 0U, cpb;
+  cryerror_t err;
+
+  /* Aligning to the next system tick.*/
+  osalThreadSleep((sysinterval_t)1);
+  start = osalOsGetSystemTimeX();
+  end = osalTimeAddX(start, BENCH_DURATION);
+  do {
+    rtcnt_t t = chSysGetRealtimeCounterX();
+
+    err = fn(&BENCH_DRIVER);
+    ticks += (uint64_t)(chSysGetRealtimeCounterX() - t);
+    bytes += BENCH_SIZE;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while ((err == CRY_NOERROR) &&
+           osalTimeIsInRangeX(osalOsGetSystemTimeX(), start, end));
+  test_assert(err == CRY_NOERROR, "operation failed");
+
+  cpb = (uint32_t)((ticks * 100U) / bytes);
+  test_print("--- Score : ");
+  test_printn(bytes);
+  test_println(" bytes/S");
+  test_print("--- Cycles: ");
+  test_printn(cpb / 100U);
+  test_print(".");
+  test_printn((cpb / 10U) % 10U);
+  test_printn(cpb % 10U);
+  test_println(" per byte");
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page cry_test_010_001 [10.1] AES-128 CTR throughput
+ *
+ * <h2>Description</h2>
+ * Measures the AES-128 CTR encryption speed on 512 bytes buffers, the
+ * key schedule is verified against the FIPS-197 vector first.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.1.1] checking the key schedule against FIPS-197
+ * - [10.1.2] measuring CTR encryption
+ * .
+ */
+
+static void cry_test_010_001_setup(void) {
+  bench_setup();
+}
+
+static void cry_test_010_001_teardown(void) {
+  cryStop(&BENCH_DRIVER);
+}
+
+static void cry_test_010_001_execute(void) {
+
+  /* [10.1.1] checking the key schedule against FIPS-197*/
+  test_set_step(1);
+  {
+    static const uint8_t pt[16] = {
+      0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+      0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff
+    };
+    static const uint8_t ct[16] = {
+      0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+      0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a
+    };
+    cryerror_t err;
+
+    err = cryEncryptAES(&BENCH_DRIVER, 0, pt, bench_out);
+    test_assert(err == CRY_NOERROR, "encryption failed");
+    test_assert(memcmp(bench_out, ct, 16) == 0, "ciphertext mismatch");
+  }
+
+  /* [10.1.2] measuring CTR encryption*/
+  test_set_step(2);
+  {
+    bench_run(bench_aes_ctr);
+  }
+}
+
+static const testcase_t cry_test_010_001 = {
+  "AES-128 CTR throughput",
+  cry_test_010_001_setup,
+  cry_test_010_001_teardown,
+  cry_test_010_001_execute
+};
+
+/**
+ * @page cry_test_010_002 [10.2] AES-128 GCM throughput
+ *
+ * <h2>Description</h2>
+ * Measures the AES-128 GCM encryption speed on 512 bytes buffers with
+ * 16 bytes of additional data, the output is verified by decrypting it
+ * first.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.2.1] checking that decryption reverses encryption
+ * - [10.2.2] measuring GCM encryption
+ * .
+ */
+
+static void cry_test_010_002_setup(void) {
+  bench_setup();
+}
+
+static void cry_test_010_002_teardown(void) {
+  cryStop(&BENCH_DRIVER);
+}
+
+static void cry_test_010_002_execute(void) {
+
+  /* [10.2.1] checking that decryption reverses encryption*/
+  test_set_step(1);
+  {
+    cryerror_t err;
+
+    err = bench_aes_gcm(&BENCH_DRIVER);
+    test_assert(err == CRY_NOERROR, "encryption failed");
+    err = cryDecryptAES_GCM(&BENCH_DRIVER, 0, sizeof bench_aad, bench_aad,
+                            BENCH_SIZE, bench_out, bench_chk, bench_iv,
+                            sizeof bench_tag, bench_tag);
+    test_assert(err == CRY_NOERROR, "authentication failed");
+    test_assert(memcmp(bench_chk, bench_in, BENCH_SIZE) == 0, "plaintext mismatch");
+    bench_tag[0] ^= 1U;
+    err = cryDecryptAES_GCM(&BENCH_DRIVER, 0, sizeof bench_aad, bench_aad,
+                            BENCH_SIZE, bench_out, bench_chk, bench_iv,
+                            sizeof bench_tag, bench_tag);
+    test_assert(err == CRY_ERR_AUTH_FAILED, "tampered tag accepted");
+  }
+
+  /* [10.2.2] measuring GCM encryption*/
+  test_set_step(2);
+  {
+    bench_run(bench_aes_gcm);
+  }
+}
+
+static const testcase_t cry_test_010_002 = {
+  "AES-128 GCM throughput",
+  cry_test_010_002_setup,
+  cry_test_010_002_teardown,
+  cry_test_010_002_execute
+};
+
+/**
+ * @page cry_test_010_003 [10.3] AES-128 GCM streaming throughput
+ *
+ * <h2>Description</h2>
+ * Measures the AES-128 GCM encryption speed using the streaming
+ * interface with 64 bytes updates, the result is verified against the
+ * one-shot function first.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.3.1] checking that streaming matches the one-shot function
+ * - [10.3.2] measuring streaming GCM encryption
+ * .
+ */
+
+static void cry_test_010_003_setup(void) {
+  bench_setup();
+}
+
+static void cry_test_010_003_teardown(void) {
+  cryStop(&BENCH_DRIVER);
+}
+
+static void cry_test_010_003_execute(void) {
+
+  /* [10.3.1] checking that streaming matches the one-shot function*/
+  test_set_step(1);
+  {
+    uint8_t tag[16];
+    cryerror_t err;
+
+    err = bench_aes_gcm(&BENCH_DRIVER);
+    test_assert(err == CRY_NOERROR, "encryption failed");
+    memcpy(bench_chk, bench_out, BENCH_SIZE);
+    memcpy(tag, bench_tag, sizeof tag);
+    memset(bench_out, 0, BENCH_SIZE);
+    err = bench_aes_gcm_stream(&BENCH_DRIVER);
+    test_assert(err == CRY_NOERROR, "streaming encryption failed");
+    test_assert(memcmp(bench_chk, bench_out, BENCH_SIZE) == 0, "ciphertext mismatch");
+    test_assert(memcmp(tag, bench_tag, sizeof tag) == 0, "tag mismatch");
+  }
+
+  /* [10.3.2] measuring streaming GCM encryption*/
+  test_set_step(2);
+  {
+    bench_run(bench_aes_gcm_stream);
+  }
+}
+
+static const testcase_t cry_test_010_003 = {
+  "AES-128 GCM streaming throughput",
+  cry_test_010_003_setup,
+  cry_test_010_003_teardown,
+  cry_test_010_003_execute
+};
+
+/**
+ * @page cry_test_010_004 [10.4] SHA-256 throughput
+ *
+ * <h2>Description</h2>
+ * Measures the SHA-256 speed on 512 bytes messages, the digest is
+ * verified against the FIPS 180-2 "abc" vector first.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.4.1] checking the "abc" digest
+ * - [10.4.2] measuring SHA-256
+ * .
+ */
+
+static void cry_test_010_004_setup(void) {
+  bench_setup();
+}
+
+static void cry_test_010_004_teardown(void) {
+  cryStop(&BENCH_DRIVER);
+}
+
+static void cry_test_010_004_execute(void) {
+
+  /* [10.4.1] checking the "abc" digest*/
+  test_set_step(1);
+  {
+    static const uint8_t digest[32] = {
+      0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea,
+      0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+      0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c,
+      0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad
+    };
+    cryerror_t err;
+
+    err = crySHA256Init(&BENCH_DRIVER, &bench_sha);
+    test_assert(err == CRY_NOERROR, "init failed");
+    err = crySHA256Update(&BENCH_DRIVER, &bench_sha, 3U, (const uint8_t *)"abc");
+    test_assert(err == CRY_NOERROR, "update failed");
+    err = crySHA256Final(&BENCH_DRIVER, &bench_sha, bench_out);
+    test_assert(err == CRY_NOERROR, "final failed");
+    test_assert(memcmp(bench_out, digest, 32) == 0, "digest mismatch");
+  }
+
+  /* [10.4.2] measuring SHA-256*/
+  test_set_step(2);
+  {
+    bench_run(bench_sha256);
+  }
+}
+
+static const testcase_t cry_test_010_004 = {
+  "SHA-256 throughput",
+  cry_test_010_004_setup,
+  cry_test_010_004_teardown,
+  cry_test_010_004_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const cry_test_sequence_010_array[] = {
+  &cry_test_010_001,
+  &cry_test_010_002,
+  &cry_test_010_003,
+  &cry_test_010_004,
+  NULL
+};
+
+/**
+ * @brief   Benchmarks.
+ */
+const testsequence_t cry_test_sequence_010 = {
+  "Benchmarks",
+  cry_test_sequence_010_array
+};
@@ -0,0 +1,342 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "cry_test_root.h"
+
+/**
+ * @file    cry_test_sequence_011.c
+ * @brief   Test Sequence 011 code.
+ *
+ * @page cry_test_sequence_011 [11] Requests queue
+ *
+ * File: @ref cry_test_sequence_011.c
+ *
+ * <h2>Description</h2>
+ * Asynchronous requests queue testing, scatter-gather lists,
+ * back-to-back execution and completion callbacks.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - HAL_CRY_USE_QUEUE == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage cry_test_011_001
+ * - @subpage cry_test_011_002
+ * .
+ */
+
+#if (HAL_CRY_USE_QUEUE == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#define QUEUE_SIZE                          256U
+
+#if HAL_CRY_ENFORCE_FALLBACK == TRUE
+static CRYDriver cryqueue;
+#define QUEUE_DRIVER                        cryqueue
+#else
+#define QUEUE_DRIVER                        CRYD1
+#endif
+
+static ALIGNED_VAR(4) uint8_t queue_plain[QUEUE_SIZE];
+static ALIGNED_VAR(4) uint8_t queue_ref[QUEUE_SIZE];
+static ALIGNED_VAR(4) uint8_t queue_out[QUEUE_SIZE];
+static uint8_t queue_tag[48], queue_reftag[48];
+static char queue_order[4];
+static unsigned queue_done;
+
+static const uint8_t queue_key[16] = {
+  0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+  0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+
+static const uint8_t queue_iv[16] = {
+  0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+  0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xf0
+};
+
+static void queue_setup(void) {
+  unsigned i;
+
+#if HAL_CRY_ENFORCE_FALLBACK == TRUE
+  cryObjectInit(&cryqueue);
+#endif
+  cryStart(&QUEUE_DRIVER, NULL);
+  for (i = 0U; i < QUEUE_SIZE; i++) {
+    queue_plain[i] = (uint8_t)(i * 7U);
+  }
+  memset(queue_out, 0, QUEUE_SIZE);
+  queue_done = 0U;
+  (void) cryLoadAESTransientKey(&QUEUE_DRIVER, sizeof queue_key, queue_key);
+}
+
+/*
+ * Callbacks are serialized by the driver, they can run in thread or
+ * interrupt context depending on the implementation.
+ */
+static void queue_callback(CRYDriver *cryp, cry_request_t *reqp) {
+
+  (void)cryp;
+
+  if (queue_done < sizeof queue_order) {
+    queue_order[queue_done] = (char)('A' + (int)reqp->op - (int)cry_op_encrypt_aes_gcm);
+  }
+  queue_done++;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page cry_test_011_001 [11.1] Scatter-gather cipher requests
+ *
+ * <h2>Description</h2>
+ * AES-128 CBC and CTR requests are executed on scatter-gather lists,
+ * the results are compared with the synchronous functions on the whole
+ * buffer.
+ *
+ * <h2>Test Steps</h2>
+ * - [11.1.1] CBC encryption of three segments, the result must match
+ *   the synchronous function
+ * - [11.1.2] in-place CBC decryption of the same segments, the
+ *   plaintext must be restored
+ * - [11.1.3] CTR encryption of three segments with a partial last
+ *   block, the result must match the synchronous function
+ * .
+ */
+
+static void cry_test_011_001_setup(void) {
+  queue_setup();
+}
+
+static void cry_test_011_001_teardown(void) {
+  cryStop(&QUEUE_DRIVER);
+}
+
+static void cry_test_011_001_execute(void) {
+  static const size_t cbc_sizes[3] = {64U, 128U, 64U};
+  static const size_t ctr_sizes[3] = {48U, 96U, 100U};
+  cry_segment_t segs[3];
+  cry_request_t req = {0};
+  cryerror_t err;
+  size_t i, offs;
+
+  /* [11.1.1] CBC encryption of three segments, the result must match
+     the synchronous function*/
+  test_set_step(1);
+  {
+    err = cryEncryptAES_CBC(&QUEUE_DRIVER, 0, QUEUE_SIZE, queue_plain,
+                            queue_ref, queue_iv);
+    test_assert(err == CRY_NOERROR, "synchronous encryption failed");
+    for (i = 0U, offs = 0U; i < 3U; offs += cbc_sizes[i], i++) {
+      segs[i].size = cbc_sizes[i];
+      segs[i].in   = &queue_plain[offs];
+      segs[i].out  = &queue_out[offs];
+    }
+    req.op        = cry_op_encrypt_aes_cbc;
+    req.segments  = segs;
+    req.nsegments = 3U;
+    req.iv        = queue_iv;
+    cryQueueRequest(&QUEUE_DRIVER, &req);
+    err = cryWaitRequest(&QUEUE_DRIVER, &req);
+    test_assert(err == CRY_NOERROR, "request failed");
+    test_assert(memcmp(queue_out, queue_ref, QUEUE_SIZE) == 0, "ciphertext mismatch");
+  }
+
+  /* [11.1.2] in-place CBC decryption of the same segments, the
+     plaintext must be restored*/
+  test_set_step(2);
+  {
+    for (i = 0U; i < 3U; i++) {
+      segs[i].in = segs[i].out;
+    }
+    req.op = cry_op_decrypt_aes_cbc;
+    cryQueueRequest(&QUEUE_DRIVER, &req);
+    err = cryWaitRequest(&QUEUE_DRIVER, &req);
+    test_assert(err == CRY_NOERROR, "request failed");
+    test_assert(memcmp(queue_out, queue_plain, QUEUE_SIZE) == 0, "plaintext mismatch");
+  }
+
+  /* [11.1.3] CTR encryption of three segments with a partial last
+     block, the result must match the synchronous function*/
+  test_set_step(3);
+  {
+    err = cryEncryptAES_CTR(&QUEUE_DRIVER, 0, 244U, queue_plain,
+                            queue_ref, queue_iv);
+    test_assert(err == CRY_NOERROR, "synchronous encryption failed");
+    for (i = 0U, offs = 0U; i < 3U; offs += ctr_sizes[i], i++) {
+      segs[i].size = ctr_sizes[i];
+      segs[i].in   = &queue_plain[offs];
+      segs[i].out  = &queue_out[offs];
+    }
+    req.op = cry_op_encrypt_aes_ctr;
+    cryQueueRequest(&QUEUE_DRIVER, &req);
+    err = cryWaitRequest(&QUEUE_DRIVER, &req);
+    test_assert(err == CRY_NOERROR, "request failed");
+    test_assert(memcmp(queue_out, queue_ref, 244U) == 0, "ciphertext mismatch");
+  }
+}
+
+static const testcase_t cry_test_011_001 = {
+  "Scatter-gather cipher requests",
+  cry_test_011_001_setup,
+  cry_test_011_001_teardown,
+  cry_test_011_001_execute
+};
+
+/**
+ * @page cry_test_011_002 [11.2] Back-to-back requests
+ *
+ * <h2>Description</h2>
+ * A GCM encryption, a GCM decryption and a SHA256 request are queued
+ * back-to-back, the callbacks must be invoked in order and the results
+ * must match the synchronous functions.
+ *
+ * <h2>Test Steps</h2>
+ * - [11.2.1] computing the reference results using the synchronous
+ *   functions
+ * - [11.2.2] queuing the three requests and waiting for all of them
+ * - [11.2.3] checking the results, the GCM decryption worked in place
+ *   on the encryption output
+ * .
+ */
+
+static void cry_test_011_002_setup(void) {
+  queue_setup();
+}
+
+static void cry_test_011_002_teardown(void) {
+  cryStop(&QUEUE_DRIVER);
+}
+
+static void cry_test_011_002_execute(void) {
+  cry_segment_t segs[2], dsegs[2];
+  cry_request_t reqs[3] = {{0}};
+  cryerror_t err;
+  unsigned i;
+
+  /* [11.2.1] computing the reference results using the synchronous
+     functions*/
+  test_set_step(1);
+  {
+    SHA256Context ctx;
+
+    err = cryEncryptAES_GCM(&QUEUE_DRIVER, 0, 16U, queue_key,
+                            QUEUE_SIZE, queue_plain, queue_ref, queue_iv,
+                            16U, queue_reftag);
+    test_assert(err == CRY_NOERROR, "synchronous encryption failed");
+    err = crySHA256Init(&QUEUE_DRIVER, &ctx);
+    test_assert(err == CRY_NOERROR, "synchronous hash failed");
+    err = crySHA256Update(&QUEUE_DRIVER, &ctx, QUEUE_SIZE, queue_plain);
+    test_assert(err == CRY_NOERROR, "synchronous hash failed");
+    err = crySHA256Final(&QUEUE_DRIVER, &ctx, &queue_reftag[16]);
+    test_assert(err == CRY_NOERROR, "synchronous hash failed");
+  }
+
+  /* [11.2.2] queuing the three requests and waiting for all of them*/
+  test_set_step(2);
+  {
+    segs[0].size = 100U;
+    segs[0].in   = queue_plain;
+    segs[0].out  = queue_out;
+    segs[1].size = QUEUE_SIZE - 100U;
+    segs[1].in   = &queue_plain[100];
+    segs[1].out  = &queue_out[100];
+    dsegs[0].size = segs[0].size;
+    dsegs[0].in   = segs[0].out;
+    dsegs[0].out  = segs[0].out;
+    dsegs[1].size = segs[1].size;
+    dsegs[1].in   = segs[1].out;
+    dsegs[1].out  = segs[1].out;
+    for (i = 0U; i < 3U; i++) {
+      reqs[i].segments  = segs;
+      reqs[i].nsegments = 2U;
+      reqs[i].iv        = queue_iv;
+      reqs[i].end_cb    = queue_callback;
+    }
+    reqs[0].op        = cry_op_encrypt_aes_gcm;
+    reqs[0].auth_size = 16U;
+    reqs[0].auth_in   = queue_key;
+    reqs[0].tag_size  = 16U;
+    reqs[0].tag       = queue_tag;
+    reqs[1].op        = cry_op_decrypt_aes_gcm;
+    reqs[1].segments  = dsegs;
+    reqs[1].auth_size = 16U;
+    reqs[1].auth_in   = queue_key;
+    reqs[1].tag_size  = 16U;
+    reqs[1].tag       = queue_reftag;
+    reqs[2].op        = cry_op_sha256;
+    reqs[2].tag       = &queue_tag[16];
+    cryQueueRequest(&QUEUE_DRIVER, &reqs[0]);
+    cryQueueRequest(&QUEUE_DRIVER, &reqs[1]);
+    cryQueueRequest(&QUEUE_DRIVER, &reqs[2]);
+    for (i = 0U; i < 3U; i++) {
+      (void) cryWaitRequest(&QUEUE_DRIVER, &reqs[i]);
+    }
+    test_assert(queue_done == 3U, "missing callbacks");
+    test_assert(memcmp(queue_order, "ABC", 3U) == 0, "invalid sequence");
+  }
+
+  /* [11.2.3] checking the results, the GCM decryption worked in place
+     on the encryption output*/
+  test_set_step(3);
+  {
+    test_assert(reqs[0].result == CRY_NOERROR, "encryption failed");
+    test_assert(memcmp(queue_tag, queue_reftag, 16U) == 0, "tag mismatch");
+    test_assert(reqs[1].result == CRY_NOERROR, "authentication failed");
+    test_assert(memcmp(queue_out, queue_plain, QUEUE_SIZE) == 0, "plaintext mismatch");
+    test_assert(reqs[2].result == CRY_NOERROR, "hash failed");
+    test_assert(memcmp(&queue_tag[16], &queue_reftag[16], 16U) == 0, "digest mismatch");
+  }
+}
+
+static const testcase_t cry_test_011_002 = {
+  "Back-to-back requests",
+  cry_test_011_002_setup,
+  cry_test_011_002_teardown,
+  cry_test_011_002_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const cry_test_sequence_011_array[] = {
+  &cry_test_011_001,
+  &cry_test_011_002,
+  NULL
+};
+
+/**
+ * @brief   Requests queue.
+ */
+const testsequence_t cry_test_sequence_011 = {
+  "Requests queue",
+  cry_test_sequence_011_array
+};
+
+#endif /* HAL_CRY_USE_QUEUE == TRUE */
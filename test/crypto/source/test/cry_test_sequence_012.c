@@ -0,0 +1,512 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "cry_test_root.h"
+
+/**
+ * @file    cry_test_sequence_012.c
+ * @brief   Test Sequence 012 code.
+ *
+ * @page cry_test_sequence_012 [12] HMAC known answers
+ *
+ * File: @ref cry_test_sequence_012.c
+ *
+ * <h2>Description</h2>
+ * Known answer tests of the HMAC functions, the RFC 4231 test vectors
+ * are used, including the keys longer than the hash block size.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage cry_test_012_001
+ * - @subpage cry_test_012_002
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#if HAL_CRY_ENFORCE_FALLBACK == TRUE
+static CRYDriver cryhmac;
+#define HMAC_DRIVER                         cryhmac
+#else
+#define HMAC_DRIVER                         CRYD1
+#endif
+
+typedef struct {
+  size_t            keysize;
+  const uint8_t     *key;
+  size_t            msgsize;
+  const uint8_t     *msg;
+  const uint8_t     *sha256;
+  const uint8_t     *sha512;
+} hmac_vector_t;
+
+static const uint8_t hmac_key1[20] = {
+  0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+  0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b, 0x0b,
+  0x0b, 0x0b, 0x0b, 0x0b
+};
+
+static const char hmac_msg1[] =
+  "Hi There";
+
+static const uint8_t hmac_sha256_1[32] = {
+  0xb0, 0x34, 0x4c, 0x61, 0xd8, 0xdb, 0x38, 0x53,
+  0x5c, 0xa8, 0xaf, 0xce, 0xaf, 0x0b, 0xf1, 0x2b,
+  0x88, 0x1d, 0xc2, 0x00, 0xc9, 0x83, 0x3d, 0xa7,
+  0x26, 0xe9, 0x37, 0x6c, 0x2e, 0x32, 0xcf, 0xf7
+};
+
+static const uint8_t hmac_sha512_1[64] = {
+  0x87, 0xaa, 0x7c, 0xde, 0xa5, 0xef, 0x61, 0x9d,
+  0x4f, 0xf0, 0xb4, 0x24, 0x1a, 0x1d, 0x6c, 0xb0,
+  0x23, 0x79, 0xf4, 0xe2, 0xce, 0x4e, 0xc2, 0x78,
+  0x7a, 0xd0, 0xb3, 0x05, 0x45, 0xe1, 0x7c, 0xde,
+  0xda, 0xa8, 0x33, 0xb7, 0xd6, 0xb8, 0xa7, 0x02,
+  0x03, 0x8b, 0x27, 0x4e, 0xae, 0xa3, 0xf4, 0xe4,
+  0xbe, 0x9d, 0x91, 0x4e, 0xeb, 0x61, 0xf1, 0x70,
+  0x2e, 0x69, 0x6c, 0x20, 0x3a, 0x12, 0x68, 0x54
+};
+
+static const uint8_t hmac_key2[4] = {
+  0x4a, 0x65, 0x66, 0x65
+};
+
+static const char hmac_msg2[] =
+  "what do ya want for nothing?";
+
+static const uint8_t hmac_sha256_2[32] = {
+  0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e,
+  0x6a, 0x04, 0x24, 0x26, 0x08, 0x95, 0x75, 0xc7,
+  0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27, 0x39, 0x83,
+  0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43
+};
+
+static const uint8_t hmac_sha512_2[64] = {
+  0x16, 0x4b, 0x7a, 0x7b, 0xfc, 0xf8, 0x19, 0xe2,
+  0xe3, 0x95, 0xfb, 0xe7, 0x3b, 0x56, 0xe0, 0xa3,
+  0x87, 0xbd, 0x64, 0x22, 0x2e, 0x83, 0x1f, 0xd6,
+  0x10, 0x27, 0x0c, 0xd7, 0xea, 0x25, 0x05, 0x54,
+  0x97, 0x58, 0xbf, 0x75, 0xc0, 0x5a, 0x99, 0x4a,
+  0x6d, 0x03, 0x4f, 0x65, 0xf8, 0xf0, 0xe6, 0xfd,
+  0xca, 0xea, 0xb1, 0xa3, 0x4d, 0x4a, 0x6b, 0x4b,
+  0x63, 0x6e, 0x07, 0x0a, 0x38, 0xbc, 0xe7, 0x37
+};
+
+static const uint8_t hmac_key3[20] = {
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa
+};
+
+static const uint8_t hmac_msg3[50] = {
+  0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd,
+  0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd,
+  0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd,
+  0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd,
+  0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd,
+  0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd, 0xdd,
+  0xdd, 0xdd
+};
+
+static const uint8_t hmac_sha256_3[32] = {
+  0x77, 0x3e, 0xa9, 0x1e, 0x36, 0x80, 0x0e, 0x46,
+  0x85, 0x4d, 0xb8, 0xeb, 0xd0, 0x91, 0x81, 0xa7,
+  0x29, 0x59, 0x09, 0x8b, 0x3e, 0xf8, 0xc1, 0x22,
+  0xd9, 0x63, 0x55, 0x14, 0xce, 0xd5, 0x65, 0xfe
+};
+
+static const uint8_t hmac_sha512_3[64] = {
+  0xfa, 0x73, 0xb0, 0x08, 0x9d, 0x56, 0xa2, 0x84,
+  0xef, 0xb0, 0xf0, 0x75, 0x6c, 0x89, 0x0b, 0xe9,
+  0xb1, 0xb5, 0xdb, 0xdd, 0x8e, 0xe8, 0x1a, 0x36,
+  0x55, 0xf8, 0x3e, 0x33, 0xb2, 0x27, 0x9d, 0x39,
+  0xbf, 0x3e, 0x84, 0x82, 0x79, 0xa7, 0x22, 0xc8,
+  0x06, 0xb4, 0x85, 0xa4, 0x7e, 0x67, 0xc8, 0x07,
+  0xb9, 0x46, 0xa3, 0x37, 0xbe, 0xe8, 0x94, 0x26,
+  0x74, 0x27, 0x88, 0x59, 0xe1, 0x32, 0x92, 0xfb
+};
+
+static const uint8_t hmac_key4[25] = {
+  0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+  0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+  0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+  0x19
+};
+
+static const uint8_t hmac_msg4[50] = {
+  0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+  0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+  0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+  0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+  0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+  0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd, 0xcd,
+  0xcd, 0xcd
+};
+
+static const uint8_t hmac_sha256_4[32] = {
+  0x82, 0x55, 0x8a, 0x38, 0x9a, 0x44, 0x3c, 0x0e,
+  0xa4, 0xcc, 0x81, 0x98, 0x99, 0xf2, 0x08, 0x3a,
+  0x85, 0xf0, 0xfa, 0xa3, 0xe5, 0x78, 0xf8, 0x07,
+  0x7a, 0x2e, 0x3f, 0xf4, 0x67, 0x29, 0x66, 0x5b
+};
+
+static const uint8_t hmac_sha512_4[64] = {
+  0xb0, 0xba, 0x46, 0x56, 0x37, 0x45, 0x8c, 0x69,
+  0x90, 0xe5, 0xa8, 0xc5, 0xf6, 0x1d, 0x4a, 0xf7,
+  0xe5, 0x76, 0xd9, 0x7f, 0xf9, 0x4b, 0x87, 0x2d,
+  0xe7, 0x6f, 0x80, 0x50, 0x36, 0x1e, 0xe3, 0xdb,
+  0xa9, 0x1c, 0xa5, 0xc1, 0x1a, 0xa2, 0x5e, 0xb4,
+  0xd6, 0x79, 0x27, 0x5c, 0xc5, 0x78, 0x80, 0x63,
+  0xa5, 0xf1, 0x97, 0x41, 0x12, 0x0c, 0x4f, 0x2d,
+  0xe2, 0xad, 0xeb, 0xeb, 0x10, 0xa2, 0x98, 0xdd
+};
+
+static const uint8_t hmac_key5[131] = {
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+  0xaa, 0xaa, 0xaa
+};
+
+static const char hmac_msg5[] =
+  "Test Using Larger Than Block-Size Key - Hash Key First";
+
+static const uint8_t hmac_sha256_5[32] = {
+  0x60, 0xe4, 0x31, 0x59, 0x1e, 0xe0, 0xb6, 0x7f,
+  0x0d, 0x8a, 0x26, 0xaa, 0xcb, 0xf5, 0xb7, 0x7f,
+  0x8e, 0x0b, 0xc6, 0x21, 0x37, 0x28, 0xc5, 0x14,
+  0x05, 0x46, 0x04, 0x0f, 0x0e, 0xe3, 0x7f, 0x54
+};
+
+static const uint8_t hmac_sha512_5[64] = {
+  0x80, 0xb2, 0x42, 0x63, 0xc7, 0xc1, 0xa3, 0xeb,
+  0xb7, 0x14, 0x93, 0xc1, 0xdd, 0x7b, 0xe8, 0xb4,
+  0x9b, 0x46, 0xd1, 0xf4, 0x1b, 0x4a, 0xee, 0xc1,
+  0x12, 0x1b, 0x01, 0x37, 0x83, 0xf8, 0xf3, 0x52,
+  0x6b, 0x56, 0xd0, 0x37, 0xe0, 0x5f, 0x25, 0x98,
+  0xbd, 0x0f, 0xd2, 0x21, 0x5d, 0x6a, 0x1e, 0x52,
+  0x95, 0xe6, 0x4f, 0x73, 0xf6, 0x3f, 0x0a, 0xec,
+  0x8b, 0x91, 0x5a, 0x98, 0x5d, 0x78, 0x65, 0x98
+};
+
+static const char hmac_msg6[] =
+  "This is a test using a larger than block-size key and a larg"
+  "er than block-size data. The key needs to be hashed before b"
+  "eing used by the HMAC algorithm.";
+
+static const uint8_t hmac_sha256_6[32] = {
+  0x9b, 0x09, 0xff, 0xa7, 0x1b, 0x94, 0x2f, 0xcb,
+  0x27, 0x63, 0x5f, 0xbc, 0xd5, 0xb0, 0xe9, 0x44,
+  0xbf, 0xdc, 0x63, 0x64, 0x4f, 0x07, 0x13, 0x93,
+  0x8a, 0x7f, 0x51, 0x53, 0x5c, 0x3a, 0x35, 0xe2
+};
+
+static const uint8_t hmac_sha512_6[64] = {
+  0xe3, 0x7b, 0x6a, 0x77, 0x5d, 0xc8, 0x7d, 0xba,
+  0xa4, 0xdf, 0xa9, 0xf9, 0x6e, 0x5e, 0x3f, 0xfd,
+  0xde, 0xbd, 0x71, 0xf8, 0x86, 0x72, 0x89, 0x86,
+  0x5d, 0xf5, 0xa3, 0x2d, 0x20, 0xcd, 0xc9, 0x44,
+  0xb6, 0x02, 0x2c, 0xac, 0x3c, 0x49, 0x82, 0xb1,
+  0x0d, 0x5e, 0xeb, 0x55, 0xc3, 0xe4, 0xde, 0x15,
+  0x13, 0x46, 0x76, 0xfb, 0x6d, 0xe0, 0x44, 0x60,
+  0x65, 0xc9, 0x74, 0x40, 0xfa, 0x8c, 0x6a, 0x58
+};
+
+static const uint8_t hmac_key6[100] = {
+  0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c,
+  0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c,
+  0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c,
+  0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c,
+  0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c,
+  0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c,
+  0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c,
+  0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c,
+  0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c,
+  0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c,
+  0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c,
+  0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c, 0x5c,
+  0x5c, 0x5c, 0x5c, 0x5c
+};
+
+static const uint8_t hmac_sha256_7[32] = {
+  0x8b, 0x78, 0x93, 0x5a, 0x58, 0x42, 0x71, 0x68,
+  0xdc, 0x7a, 0x4a, 0xeb, 0x13, 0x2c, 0xac, 0x81,
+  0x3f, 0xa0, 0x96, 0x39, 0xf0, 0x89, 0x82, 0xbe,
+  0xf6, 0xd5, 0x9b, 0xda, 0x35, 0x3a, 0x1c, 0xd4
+};
+
+static const uint8_t hmac_sha512_7[64] = {
+  0x08, 0xa3, 0xc5, 0x4c, 0xef, 0x71, 0xbd, 0x7e,
+  0x3b, 0xc4, 0x9d, 0xd2, 0xe8, 0x1c, 0x37, 0x6a,
+  0x6e, 0x53, 0xa4, 0x82, 0xf9, 0xeb, 0xbd, 0x0f,
+  0xfa, 0x7e, 0x95, 0x94, 0x01, 0xa4, 0x5c, 0x58,
+  0xce, 0xcc, 0x76, 0xf6, 0x39, 0xae, 0x2c, 0x32,
+  0x31, 0x9b, 0xa4, 0xfa, 0xdb, 0x92, 0x9c, 0xe8,
+  0xd8, 0xcd, 0x27, 0x6a, 0x9e, 0xea, 0x7e, 0xf9,
+  0x0b, 0x2d, 0xa5, 0x4f, 0x36, 0xff, 0xc0, 0xb2
+};
+
+#define HMAC_VECTORS                        7U
+
+static const hmac_vector_t hmac_vectors[HMAC_VECTORS] = {
+  /* RFC 4231 case 1.*/
+  {sizeof hmac_key1, hmac_key1,
+   sizeof hmac_msg1 - 1U, (const uint8_t *)hmac_msg1,
+   hmac_sha256_1, hmac_sha512_1},
+  /* RFC 4231 case 2.*/
+  {sizeof hmac_key2, hmac_key2,
+   sizeof hmac_msg2 - 1U, (const uint8_t *)hmac_msg2,
+   hmac_sha256_2, hmac_sha512_2},
+  /* RFC 4231 case 3.*/
+  {sizeof hmac_key3, hmac_key3,
+   sizeof hmac_msg3, hmac_msg3,
+   hmac_sha256_3, hmac_sha512_3},
+  /* RFC 4231 case 4.*/
+  {sizeof hmac_key4, hmac_key4,
+   sizeof hmac_msg4, hmac_msg4,
+   hmac_sha256_4, hmac_sha512_4},
+  /* RFC 4231 case 6.*/
+  {sizeof hmac_key5, hmac_key5,
+   sizeof hmac_msg5 - 1U, (const uint8_t *)hmac_msg5,
+   hmac_sha256_5, hmac_sha512_5},
+  /* RFC 4231 case 7.*/
+  {sizeof hmac_key5, hmac_key5,
+   sizeof hmac_msg6 - 1U, (const uint8_t *)hmac_msg6,
+   hmac_sha256_6, hmac_sha512_6},
+  /* Longer than the SHA256 block only.*/
+  {sizeof hmac_key6, hmac_key6,
+   sizeof hmac_msg1 - 1U, (const uint8_t *)hmac_msg1,
+   hmac_sha256_7, hmac_sha512_7}
+};
+
+static uint8_t hmac_out[64];
+
+static void hmac_setup(void) {
+
+#if HAL_CRY_ENFORCE_FALLBACK == TRUE
+  cryObjectInit(&cryhmac);
+#endif
+  cryStart(&HMAC_DRIVER, NULL);
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page cry_test_012_001 [12.1] HMAC-SHA256 known answers
+ *
+ * <h2>Description</h2>
+ * The HMAC-SHA256 of the RFC 4231 test cases 1, 2, 3, 4, 6 and 7 is
+ * calculated and compared with the expected result, cases 6 and 7 use a
+ * 131 bytes key which must be hashed before use. A 100 bytes key,
+ * longer than the SHA256 block but not than the SHA512 block, is also
+ * tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [12.1.1] calculating the MAC of each vector in a single update
+ * - [12.1.2] calculating the MAC of each vector in two updates, the key
+ *   is loaded again for each vector
+ * .
+ */
+
+static void cry_test_012_001_setup(void) {
+  hmac_setup();
+}
+
+static void cry_test_012_001_teardown(void) {
+  cryStop(&HMAC_DRIVER);
+}
+
+static void cry_test_012_001_execute(void) {
+
+  /* [12.1.1] calculating the MAC of each vector in a single update*/
+  test_set_step(1);
+  {
+    unsigned i;
+
+    for (i = 0U; i < HMAC_VECTORS; i++) {
+      const hmac_vector_t *vp = &hmac_vectors[i];
+      HMACSHA256Context ctx;
+      cryerror_t err;
+
+      err = cryLoadHMACTransientKey(&HMAC_DRIVER, vp->keysize, vp->key);
+      test_assert(err == CRY_NOERROR, "key loading failed");
+      err = cryHMACSHA256Init(&HMAC_DRIVER, &ctx);
+      test_assert(err == CRY_NOERROR, "initialization failed");
+      err = cryHMACSHA256Update(&HMAC_DRIVER, &ctx, vp->msgsize, vp->msg);
+      test_assert(err == CRY_NOERROR, "update failed");
+      err = cryHMACSHA256Final(&HMAC_DRIVER, &ctx, hmac_out);
+      test_assert(err == CRY_NOERROR, "finalization failed");
+      test_assert(memcmp(hmac_out, vp->sha256, 32U) == 0, "MAC mismatch");
+    }
+  }
+
+  /* [12.1.2] calculating the MAC of each vector in two updates, the key
+     is loaded again for each vector*/
+  test_set_step(2);
+  {
+    unsigned i;
+
+    for (i = 0U; i < HMAC_VECTORS; i++) {
+      const hmac_vector_t *vp = &hmac_vectors[i];
+      HMACSHA256Context ctx;
+      size_t half = vp->msgsize / 2U;
+      cryerror_t err;
+
+      err = cryLoadHMACTransientKey(&HMAC_DRIVER, vp->keysize, vp->key);
+      test_assert(err == CRY_NOERROR, "key loading failed");
+      err = cryHMACSHA256Init(&HMAC_DRIVER, &ctx);
+      test_assert(err == CRY_NOERROR, "initialization failed");
+      err = cryHMACSHA256Update(&HMAC_DRIVER, &ctx, half, vp->msg);
+      test_assert(err == CRY_NOERROR, "update failed");
+      err = cryHMACSHA256Update(&HMAC_DRIVER, &ctx, vp->msgsize - half,
+                                vp->msg + half);
+      test_assert(err == CRY_NOERROR, "update failed");
+      err = cryHMACSHA256Final(&HMAC_DRIVER, &ctx, hmac_out);
+      test_assert(err == CRY_NOERROR, "finalization failed");
+      test_assert(memcmp(hmac_out, vp->sha256, 32U) == 0, "MAC mismatch");
+    }
+  }
+}
+
+static const testcase_t cry_test_012_001 = {
+  "HMAC-SHA256 known answers",
+  cry_test_012_001_setup,
+  cry_test_012_001_teardown,
+  cry_test_012_001_execute
+};
+/**
+ * @page cry_test_012_002 [12.2] HMAC-SHA512 known answers
+ *
+ * <h2>Description</h2>
+ * The HMAC-SHA512 of the RFC 4231 test cases 1, 2, 3, 4, 6 and 7 is
+ * calculated and compared with the expected result, cases 6 and 7 use a
+ * 131 bytes key which must be hashed before use. A 100 bytes key,
+ * longer than the SHA256 block but not than the SHA512 block, is also
+ * tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [12.2.1] calculating the MAC of each vector in a single update
+ * - [12.2.2] calculating the MAC of each vector in two updates, the key
+ *   is loaded again for each vector
+ * .
+ */
+
+static void cry_test_012_002_setup(void) {
+  hmac_setup();
+}
+
+static void cry_test_012_002_teardown(void) {
+  cryStop(&HMAC_DRIVER);
+}
+
+static void cry_test_012_002_execute(void) {
+
+  /* [12.2.1] calculating the MAC of each vector in a single update*/
+  test_set_step(1);
+  {
+    unsigned i;
+
+    for (i = 0U; i < HMAC_VECTORS; i++) {
+      const hmac_vector_t *vp = &hmac_vectors[i];
+      HMACSHA512Context ctx;
+      cryerror_t err;
+
+      err = cryLoadHMACTransientKey(&HMAC_DRIVER, vp->keysize, vp->key);
+      test_assert(err == CRY_NOERROR, "key loading failed");
+      err = cryHMACSHA512Init(&HMAC_DRIVER, &ctx);
+      test_assert(err == CRY_NOERROR, "initialization failed");
+      err = cryHMACSHA512Update(&HMAC_DRIVER, &ctx, vp->msgsize, vp->msg);
+      test_assert(err == CRY_NOERROR, "update failed");
+      err = cryHMACSHA512Final(&HMAC_DRIVER, &ctx, hmac_out);
+      test_assert(err == CRY_NOERROR, "finalization failed");
+      test_assert(memcmp(hmac_out, vp->sha512, 64U) == 0, "MAC mismatch");
+    }
+  }
+
+  /* [12.2.2] calculating the MAC of each vector in two updates, the key
+     is loaded again for each vector*/
+  test_set_step(2);
+  {
+    unsigned i;
+
+    for (i = 0U; i < HMAC_VECTORS; i++) {
+      const hmac_vector_t *vp = &hmac_vectors[i];
+      HMACSHA512Context ctx;
+      size_t half = vp->msgsize / 2U;
+      cryerror_t err;
+
+      err = cryLoadHMACTransientKey(&HMAC_DRIVER, vp->keysize, vp->key);
+      test_assert(err == CRY_NOERROR, "key loading failed");
+      err = cryHMACSHA512Init(&HMAC_DRIVER, &ctx);
+      test_assert(err == CRY_NOERROR, "initialization failed");
+      err = cryHMACSHA512Update(&HMAC_DRIVER, &ctx, half, vp->msg);
+      test_assert(err == CRY_NOERROR, "update failed");
+      err = cryHMACSHA512Update(&HMAC_DRIVER, &ctx, vp->msgsize - half,
+                                vp->msg + half);
+      test_assert(err == CRY_NOERROR, "update failed");
+      err = cryHMACSHA512Final(&HMAC_DRIVER, &ctx, hmac_out);
+      test_assert(err == CRY_NOERROR, "finalization failed");
+      test_assert(memcmp(hmac_out, vp->sha512, 64U) == 0, "MAC mismatch");
+    }
+  }
+}
+
+static const testcase_t cry_test_012_002 = {
+  "HMAC-SHA512 known answers",
+  cry_test_012_002_setup,
+  cry_test_012_002_teardown,
+  cry_test_012_002_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const cry_test_sequence_012_array[] = {
+  &cry_test_012_001,
+  &cry_test_012_002,
+  NULL
+};
+
+/**
+ * @brief   HMAC known answers.
+ */
+const testsequence_t cry_test_sequence_012 = {
+  "HMAC known answers",
+  cry_test_sequence_012_array
+};
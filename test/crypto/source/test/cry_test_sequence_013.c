@@ -0,0 +1,1035 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "cry_test_root.h"
+
+/**
+ * @file    cry_test_sequence_013.c
+ * @brief   Test Sequence 013 code.
+ *
+ * @page cry_test_sequence_013 [13] Portable API known answers
+ *
+ * File: @ref cry_test_sequence_013.c
+ *
+ * <h2>Description</h2>
+ * Known answer tests of the AES CBC, CFB, CTR and GCM modes and of the
+ * SHA-1 and SHA-512 hashes using the portable API, the expected results
+ * are the testref tables and the NIST SP 800-38A CTR vectors.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage cry_test_013_001
+ * - @subpage cry_test_013_002
+ * - @subpage cry_test_013_003
+ * - @subpage cry_test_013_004
+ * - @subpage cry_test_013_005
+ * - @subpage cry_test_013_006
+ * - @subpage cry_test_013_007
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#include "ref_aes.h"
+#include "ref_gcm.h"
+#include "ref_sha.h"
+
+#if HAL_CRY_ENFORCE_FALLBACK == TRUE
+static CRYDriver crykat;
+#define KAT_DRIVER                          crykat
+#else
+#define KAT_DRIVER                          CRYD1
+#endif
+
+#define KAT_TEXT_SIZE                       640U
+#define KAT_SP800_SIZE                      64U
+
+typedef cryerror_t (*katfn_t)(CRYDriver *cryp,
+                              crykey_t key_id,
+                              size_t size,
+                              const uint8_t *in,
+                              uint8_t *out,
+                              const uint8_t *iv);
+
+/*
+ * Keys, vector and text the testref AES tables have been calculated with,
+ * the keys and the vector are the test_keys[] and test_vectors[] words
+ * serialized in little endian order.
+ */
+static const uint8_t kat_key[32] = {
+  0x67, 0x45, 0x23, 0x01, 0xef, 0xcd, 0xab, 0x89,
+  0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe,
+  0xaa, 0x55, 0xaa, 0x55, 0x55, 0xaa, 0x55, 0xaa,
+  0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff
+};
+
+static const uint8_t kat_iv[16] = {
+  0x44, 0x33, 0x22, 0x11, 0x88, 0x77, 0x66, 0x55,
+  0x22, 0x22, 0x11, 0x11, 0x44, 0x44, 0x33, 0x33
+};
+
+static const char kat_text[] =
+  "Lorem ipsum dolor sit amet, consectetur adipiscing elit. Praesen"
+  "t et pellentesque risus. Sed id gravida elit. Proin eget accumsa"
+  "n mi. Aliquam vitae dui porta, euismod velit viverra, elementum "
+  "lacus. Nunc turpis orci, venenatis vel vulputate nec, luctus sit"
+  "amet urna. Ut et nunc purus. Aliquam erat volutpat. Vestibulum n"
+  "ulla dolor, cursus vitae cursus eget, dapibus eget sapien. Integ"
+  "er justo eros, commodo ut massa eu, bibendum elementum tellus. N"
+  "am quis dolor in libero placerat congue. Sed sodales urna sceler"
+  "isque dui faucibus, vitae malesuada dui fermentum. Proin ultrici"
+  "es sit amet justo at ornare. Suspendisse efficitur purus nullam.";
+
+/*
+ * NIST SP 800-38A appendix F.5 CTR vectors, the counter block and the plain
+ * text are common to the three key sizes.
+ */
+static const uint8_t kat_sp800_key128[16] = {
+  0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+  0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c
+};
+
+static const uint8_t kat_sp800_key192[24] = {
+  0x8e, 0x73, 0xb0, 0xf7, 0xda, 0x0e, 0x64, 0x52,
+  0xc8, 0x10, 0xf3, 0x2b, 0x80, 0x90, 0x79, 0xe5,
+  0x62, 0xf8, 0xea, 0xd2, 0x52, 0x2c, 0x6b, 0x7b
+};
+
+static const uint8_t kat_sp800_key256[32] = {
+  0x60, 0x3d, 0xeb, 0x10, 0x15, 0xca, 0x71, 0xbe,
+  0x2b, 0x73, 0xae, 0xf0, 0x85, 0x7d, 0x77, 0x81,
+  0x1f, 0x35, 0x2c, 0x07, 0x3b, 0x61, 0x08, 0xd7,
+  0x2d, 0x98, 0x10, 0xa3, 0x09, 0x14, 0xdf, 0xf4
+};
+
+static const uint8_t kat_sp800_counter[16] = {
+  0xf0, 0xf1, 0xf2, 0xf3, 0xf4, 0xf5, 0xf6, 0xf7,
+  0xf8, 0xf9, 0xfa, 0xfb, 0xfc, 0xfd, 0xfe, 0xff
+};
+
+static const uint8_t kat_sp800_plain[64] = {
+  0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+  0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+  0xae, 0x2d, 0x8a, 0x57, 0x1e, 0x03, 0xac, 0x9c,
+  0x9e, 0xb7, 0x6f, 0xac, 0x45, 0xaf, 0x8e, 0x51,
+  0x30, 0xc8, 0x1c, 0x46, 0xa3, 0x5c, 0xe4, 0x11,
+  0xe5, 0xfb, 0xc1, 0x19, 0x1a, 0x0a, 0x52, 0xef,
+  0xf6, 0x9f, 0x24, 0x45, 0xdf, 0x4f, 0x9b, 0x17,
+  0xad, 0x2b, 0x41, 0x7b, 0xe6, 0x6c, 0x37, 0x10
+};
+
+static const uint8_t kat_sp800_ctr128[64] = {
+  0x87, 0x4d, 0x61, 0x91, 0xb6, 0x20, 0xe3, 0x26,
+  0x1b, 0xef, 0x68, 0x64, 0x99, 0x0d, 0xb6, 0xce,
+  0x98, 0x06, 0xf6, 0x6b, 0x79, 0x70, 0xfd, 0xff,
+  0x86, 0x17, 0x18, 0x7b, 0xb9, 0xff, 0xfd, 0xff,
+  0x5a, 0xe4, 0xdf, 0x3e, 0xdb, 0xd5, 0xd3, 0x5e,
+  0x5b, 0x4f, 0x09, 0x02, 0x0d, 0xb0, 0x3e, 0xab,
+  0x1e, 0x03, 0x1d, 0xda, 0x2f, 0xbe, 0x03, 0xd1,
+  0x79, 0x21, 0x70, 0xa0, 0xf3, 0x00, 0x9c, 0xee
+};
+
+static const uint8_t kat_sp800_ctr192[64] = {
+  0x1a, 0xbc, 0x93, 0x24, 0x17, 0x52, 0x1c, 0xa2,
+  0x4f, 0x2b, 0x04, 0x59, 0xfe, 0x7e, 0x6e, 0x0b,
+  0x09, 0x03, 0x39, 0xec, 0x0a, 0xa6, 0xfa, 0xef,
+  0xd5, 0xcc, 0xc2, 0xc6, 0xf4, 0xce, 0x8e, 0x94,
+  0x1e, 0x36, 0xb2, 0x6b, 0xd1, 0xeb, 0xc6, 0x70,
+  0xd1, 0xbd, 0x1d, 0x66, 0x56, 0x20, 0xab, 0xf7,
+  0x4f, 0x78, 0xa7, 0xf6, 0xd2, 0x98, 0x09, 0x58,
+  0x5a, 0x97, 0xda, 0xec, 0x58, 0xc6, 0xb0, 0x50
+};
+
+static const uint8_t kat_sp800_ctr256[64] = {
+  0x60, 0x1e, 0xc3, 0x13, 0x77, 0x57, 0x89, 0xa5,
+  0xb7, 0xa7, 0xf5, 0x04, 0xbb, 0xf3, 0xd2, 0x28,
+  0xf4, 0x43, 0xe3, 0xca, 0x4d, 0x62, 0xb5, 0x9a,
+  0xca, 0x84, 0xe9, 0x90, 0xca, 0xca, 0xf5, 0xc5,
+  0x2b, 0x09, 0x30, 0xda, 0xa2, 0x3d, 0xe9, 0x4c,
+  0xe8, 0x70, 0x17, 0xba, 0x2d, 0x84, 0x98, 0x8d,
+  0xdf, 0xc9, 0xc5, 0x8d, 0xb6, 0x7a, 0xad, 0xa6,
+  0x13, 0xc2, 0xdd, 0x08, 0x45, 0x79, 0x41, 0xa6
+};
+
+static const uint8_t kat_sha_abc[3] = {'a', 'b', 'c'};
+
+static const char kat_sha_56[] =
+  "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+
+static ALIGNED_VAR(4) uint8_t kat_sha_a[128];
+static ALIGNED_VAR(4) uint8_t kat_out[KAT_TEXT_SIZE];
+static ALIGNED_VAR(4) uint8_t kat_chk[KAT_TEXT_SIZE];
+static uint8_t kat_tag[16];
+
+static void kat_setup(void) {
+
+#if HAL_CRY_ENFORCE_FALLBACK == TRUE
+  cryObjectInit(&crykat);
+#endif
+  cryStart(&KAT_DRIVER, NULL);
+  memset(kat_sha_a, 'a', sizeof kat_sha_a);
+}
+
+/*
+ * Encrypts the text comparing the result with the expected cipher text,
+ * the cipher text is then decrypted and compared with the text.
+ */
+static bool kat_cipher(katfn_t encfn, katfn_t decfn, size_t size,
+                       const uint8_t *text, const uint8_t *iv,
+                       const uint8_t *cipher) {
+
+  if ((encfn(&KAT_DRIVER, 0, size, text, kat_out, iv) != CRY_NOERROR) ||
+      (memcmp(kat_out, cipher, size) != 0)) {
+    return false;
+  }
+  if ((decfn(&KAT_DRIVER, 0, size, kat_out, kat_chk, iv) != CRY_NOERROR) ||
+      (memcmp(kat_chk, text, size) != 0)) {
+    return false;
+  }
+  return true;
+}
+
+/*
+ * Encrypts the text in two chained segments, the vector of the second
+ * segment is the last cipher block of the first segment for CBC and CFB
+ * and the counter advanced by the blocks of the first segment for CTR.
+ */
+static bool kat_chained(katfn_t encfn, bool ctr, size_t size,
+                        const uint8_t *text, const uint8_t *iv,
+                        const uint8_t *cipher) {
+  uint8_t next[16];
+  size_t first = (size / 2U) & ~(size_t)15;
+  unsigned i, blocks;
+
+  if (encfn(&KAT_DRIVER, 0, first, text, kat_out, iv) != CRY_NOERROR) {
+    return false;
+  }
+  if (ctr) {
+    memcpy(next, iv, sizeof next);
+    for (blocks = first / 16U; blocks > 0U; blocks--) {
+      for (i = sizeof next; (i > 0U) && (++next[i - 1U] == 0U); i--) {
+      }
+    }
+  }
+  else {
+    memcpy(next, &kat_out[first - sizeof next], sizeof next);
+  }
+  if (encfn(&KAT_DRIVER, 0, size - first, text + first, kat_out + first,
+            next) != CRY_NOERROR) {
+    return false;
+  }
+  return memcmp(kat_out, cipher, size) == 0;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page cry_test_013_001 [13.1] AES-CBC known answers
+ *
+ * <h2>Description</h2>
+ * The 640 bytes text is encrypted and decrypted in AES-CBC mode using
+ * 128, 192 and 256 bits keys, the cipher text is compared with the
+ * testref tables. The text is also encrypted in two chained segments.
+ *
+ * <h2>Test Steps</h2>
+ * - [13.1.1] loading the 128 bits key, encrypting and decrypting the
+ *   text, the result is compared with refAES_CBC_128
+ * - [13.1.2] loading the 192 bits key, encrypting and decrypting the
+ *   text, the result is compared with refAES_CBC_192
+ * - [13.1.3] loading the 256 bits key, encrypting and decrypting the
+ *   text, the result is compared with refAES_CBC_256
+ * .
+ */
+
+static void cry_test_013_001_setup(void) {
+  kat_setup();
+}
+
+static void cry_test_013_001_teardown(void) {
+  cryStop(&KAT_DRIVER);
+}
+
+static void cry_test_013_001_execute(void) {
+
+  /* [13.1.1] loading the 128 bits key, encrypting and decrypting the
+     text, the result is compared with refAES_CBC_128*/
+  test_set_step(1);
+  {
+    cryerror_t err;
+
+    err = cryLoadAESTransientKey(&KAT_DRIVER, 16U, kat_key);
+    test_assert(err == CRY_NOERROR, "key loading failed");
+    test_assert(kat_cipher(cryEncryptAES_CBC, cryDecryptAES_CBC, KAT_TEXT_SIZE,
+                           (const uint8_t *)kat_text, kat_iv, refAES_CBC_128),
+                "CBC-128 mismatch");
+    test_assert(kat_chained(cryEncryptAES_CBC, false, KAT_TEXT_SIZE,
+                            (const uint8_t *)kat_text, kat_iv, refAES_CBC_128),
+                "chained CBC-128 mismatch");
+  }
+
+  /* [13.1.2] loading the 192 bits key, encrypting and decrypting the
+     text, the result is compared with refAES_CBC_192*/
+  test_set_step(2);
+  {
+    cryerror_t err;
+
+    err = cryLoadAESTransientKey(&KAT_DRIVER, 24U, kat_key);
+    test_assert(err == CRY_NOERROR, "key loading failed");
+    test_assert(kat_cipher(cryEncryptAES_CBC, cryDecryptAES_CBC, KAT_TEXT_SIZE,
+                           (const uint8_t *)kat_text, kat_iv, refAES_CBC_192),
+                "CBC-192 mismatch");
+    test_assert(kat_chained(cryEncryptAES_CBC, false, KAT_TEXT_SIZE,
+                            (const uint8_t *)kat_text, kat_iv, refAES_CBC_192),
+                "chained CBC-192 mismatch");
+  }
+
+  /* [13.1.3] loading the 256 bits key, encrypting and decrypting the
+     text, the result is compared with refAES_CBC_256*/
+  test_set_step(3);
+  {
+    cryerror_t err;
+
+    err = cryLoadAESTransientKey(&KAT_DRIVER, 32U, kat_key);
+    test_assert(err == CRY_NOERROR, "key loading failed");
+    test_assert(kat_cipher(cryEncryptAES_CBC, cryDecryptAES_CBC, KAT_TEXT_SIZE,
+                           (const uint8_t *)kat_text, kat_iv, refAES_CBC_256),
+                "CBC-256 mismatch");
+    test_assert(kat_chained(cryEncryptAES_CBC, false, KAT_TEXT_SIZE,
+                            (const uint8_t *)kat_text, kat_iv, refAES_CBC_256),
+                "chained CBC-256 mismatch");
+  }
+}
+
+static const testcase_t cry_test_013_001 = {
+  "AES-CBC known answers",
+  cry_test_013_001_setup,
+  cry_test_013_001_teardown,
+  cry_test_013_001_execute
+};
+
+/**
+ * @page cry_test_013_002 [13.2] AES-CFB known answers
+ *
+ * <h2>Description</h2>
+ * The 640 bytes text is encrypted and decrypted in AES-CFB mode using
+ * 128, 192 and 256 bits keys, the cipher text is compared with the
+ * testref tables. The text is also encrypted in two chained segments.
+ *
+ * <h2>Test Steps</h2>
+ * - [13.2.1] loading the 128 bits key, encrypting and decrypting the
+ *   text, the result is compared with refAES_CFB_128
+ * - [13.2.2] loading the 192 bits key, encrypting and decrypting the
+ *   text, the result is compared with refAES_CFB_192
+ * - [13.2.3] loading the 256 bits key, encrypting and decrypting the
+ *   text, the result is compared with refAES_CFB_256
+ * .
+ */
+
+static void cry_test_013_002_setup(void) {
+  kat_setup();
+}
+
+static void cry_test_013_002_teardown(void) {
+  cryStop(&KAT_DRIVER);
+}
+
+static void cry_test_013_002_execute(void) {
+
+  /* [13.2.1] loading the 128 bits key, encrypting and decrypting the
+     text, the result is compared with refAES_CFB_128*/
+  test_set_step(1);
+  {
+    cryerror_t err;
+
+    err = cryLoadAESTransientKey(&KAT_DRIVER, 16U, kat_key);
+    test_assert(err == CRY_NOERROR, "key loading failed");
+    test_assert(kat_cipher(cryEncryptAES_CFB, cryDecryptAES_CFB, KAT_TEXT_SIZE,
+                           (const uint8_t *)kat_text, kat_iv, refAES_CFB_128),
+                "CFB-128 mismatch");
+    test_assert(kat_chained(cryEncryptAES_CFB, false, KAT_TEXT_SIZE,
+                            (const uint8_t *)kat_text, kat_iv, refAES_CFB_128),
+                "chained CFB-128 mismatch");
+  }
+
+  /* [13.2.2] loading the 192 bits key, encrypting and decrypting the
+     text, the result is compared with refAES_CFB_192*/
+  test_set_step(2);
+  {
+    cryerror_t err;
+
+    err = cryLoadAESTransientKey(&KAT_DRIVER, 24U, kat_key);
+    test_assert(err == CRY_NOERROR, "key loading failed");
+    test_assert(kat_cipher(cryEncryptAES_CFB, cryDecryptAES_CFB, KAT_TEXT_SIZE,
+                           (const uint8_t *)kat_text, kat_iv, refAES_CFB_192),
+                "CFB-192 mismatch");
+    test_assert(kat_chained(cryEncryptAES_CFB, false, KAT_TEXT_SIZE,
+                            (const uint8_t *)kat_text, kat_iv, refAES_CFB_192),
+                "chained CFB-192 mismatch");
+  }
+
+  /* [13.2.3] loading the 256 bits key, encrypting and decrypting the
+     text, the result is compared with refAES_CFB_256*/
+  test_set_step(3);
+  {
+    cryerror_t err;
+
+    err = cryLoadAESTransientKey(&KAT_DRIVER, 32U, kat_key);
+    test_assert(err == CRY_NOERROR, "key loading failed");
+    test_assert(kat_cipher(cryEncryptAES_CFB, cryDecryptAES_CFB, KAT_TEXT_SIZE,
+                           (const uint8_t *)kat_text, kat_iv, refAES_CFB_256),
+                "CFB-256 mismatch");
+    test_assert(kat_chained(cryEncryptAES_CFB, false, KAT_TEXT_SIZE,
+                            (const uint8_t *)kat_text, kat_iv, refAES_CFB_256),
+                "chained CFB-256 mismatch");
+  }
+}
+
+static const testcase_t cry_test_013_002 = {
+  "AES-CFB known answers",
+  cry_test_013_002_setup,
+  cry_test_013_002_teardown,
+  cry_test_013_002_execute
+};
+
+/**
+ * @page cry_test_013_003 [13.3] AES-CTR known answers
+ *
+ * <h2>Description</h2>
+ * The 640 bytes text is encrypted and decrypted in AES-CTR mode using
+ * 128, 192 and 256 bits keys, the cipher text is compared with the
+ * testref tables. The text is also encrypted in two chained segments.
+ *
+ * <h2>Test Steps</h2>
+ * - [13.3.1] loading the 128 bits key, encrypting and decrypting the
+ *   text, the result is compared with refAES_CTR_128
+ * - [13.3.2] loading the 192 bits key, encrypting and decrypting the
+ *   text, the result is compared with refAES_CTR_192
+ * - [13.3.3] loading the 256 bits key, encrypting and decrypting the
+ *   text, the result is compared with refAES_CTR_256
+ * .
+ */
+
+static void cry_test_013_003_setup(void) {
+  kat_setup();
+}
+
+static void cry_test_013_003_teardown(void) {
+  cryStop(&KAT_DRIVER);
+}
+
+static void cry_test_013_003_execute(void) {
+
+  /* [13.3.1] loading the 128 bits key, encrypting and decrypting the
+     text, the result is compared with refAES_CTR_128*/
+  test_set_step(1);
+  {
+    cryerror_t err;
+
+    err = cryLoadAESTransientKey(&KAT_DRIVER, 16U, kat_key);
+    test_assert(err == CRY_NOERROR, "key loading failed");
+    test_assert(kat_cipher(cryEncryptAES_CTR, cryDecryptAES_CTR, KAT_TEXT_SIZE,
+                           (const uint8_t *)kat_text, kat_iv, refAES_CTR_128),
+                "CTR-128 mismatch");
+    test_assert(kat_chained(cryEncryptAES_CTR, true, KAT_TEXT_SIZE,
+                            (const uint8_t *)kat_text, kat_iv, refAES_CTR_128),
+                "chained CTR-128 mismatch");
+  }
+
+  /* [13.3.2] loading the 192 bits key, encrypting and decrypting the
+     text, the result is compared with refAES_CTR_192*/
+  test_set_step(2);
+  {
+    cryerror_t err;
+
+    err = cryLoadAESTransientKey(&KAT_DRIVER, 24U, kat_key);
+    test_assert(err == CRY_NOERROR, "key loading failed");
+    test_assert(kat_cipher(cryEncryptAES_CTR, cryDecryptAES_CTR, KAT_TEXT_SIZE,
+                           (const uint8_t *)kat_text, kat_iv, refAES_CTR_192),
+                "CTR-192 mismatch");
+    test_assert(kat_chained(cryEncryptAES_CTR, true, KAT_TEXT_SIZE,
+                            (const uint8_t *)kat_text, kat_iv, refAES_CTR_192),
+                "chained CTR-192 mismatch");
+  }
+
+  /* [13.3.3] loading the 256 bits key, encrypting and decrypting the
+     text, the result is compared with refAES_CTR_256*/
+  test_set_step(3);
+  {
+    cryerror_t err;
+
+    err = cryLoadAESTransientKey(&KAT_DRIVER, 32U, kat_key);
+    test_assert(err == CRY_NOERROR, "key loading failed");
+    test_assert(kat_cipher(cryEncryptAES_CTR, cryDecryptAES_CTR, KAT_TEXT_SIZE,
+                           (const uint8_t *)kat_text, kat_iv, refAES_CTR_256),
+                "CTR-256 mismatch");
+    test_assert(kat_chained(cryEncryptAES_CTR, true, KAT_TEXT_SIZE,
+                            (const uint8_t *)kat_text, kat_iv, refAES_CTR_256),
+                "chained CTR-256 mismatch");
+  }
+}
+
+static const testcase_t cry_test_013_003 = {
+  "AES-CTR known answers",
+  cry_test_013_003_setup,
+  cry_test_013_003_teardown,
+  cry_test_013_003_execute
+};
+
+/**
+ * @page cry_test_013_004 [13.4] AES-CTR NIST SP 800-38A vectors
+ *
+ * <h2>Description</h2>
+ * The CTR-AES128, CTR-AES192 and CTR-AES256 vectors of NIST SP 800-38A
+ * appendix F.5 are encrypted and decrypted, the counter block carries
+ * from the least significant byte into the next one between the first
+ * and the second block.
+ *
+ * <h2>Test Steps</h2>
+ * - [13.4.1] loading the 128 bits key, checking the vectors F.5.1 and
+ *   F.5.2
+ * - [13.4.2] loading the 192 bits key, checking the vectors F.5.3 and
+ *   F.5.4
+ * - [13.4.3] loading the 256 bits key, checking the vectors F.5.5 and
+ *   F.5.6
+ * .
+ */
+
+static void cry_test_013_004_setup(void) {
+  kat_setup();
+}
+
+static void cry_test_013_004_teardown(void) {
+  cryStop(&KAT_DRIVER);
+}
+
+static void cry_test_013_004_execute(void) {
+
+  /* [13.4.1] loading the 128 bits key, checking the vectors F.5.1 and
+     F.5.2*/
+  test_set_step(1);
+  {
+    cryerror_t err;
+
+    err = cryLoadAESTransientKey(&KAT_DRIVER, sizeof kat_sp800_key128,
+                                 kat_sp800_key128);
+    test_assert(err == CRY_NOERROR, "key loading failed");
+    test_assert(kat_cipher(cryEncryptAES_CTR, cryDecryptAES_CTR, KAT_SP800_SIZE,
+                           kat_sp800_plain, kat_sp800_counter,
+                           kat_sp800_ctr128),
+                "CTR-AES128 mismatch");
+    test_assert(kat_chained(cryEncryptAES_CTR, true, KAT_SP800_SIZE,
+                            kat_sp800_plain, kat_sp800_counter,
+                            kat_sp800_ctr128),
+                "chained CTR-AES128 mismatch");
+  }
+
+  /* [13.4.2] loading the 192 bits key, checking the vectors F.5.3 and
+     F.5.4*/
+  test_set_step(2);
+  {
+    cryerror_t err;
+
+    err = cryLoadAESTransientKey(&KAT_DRIVER, sizeof kat_sp800_key192,
+                                 kat_sp800_key192);
+    test_assert(err == CRY_NOERROR, "key loading failed");
+    test_assert(kat_cipher(cryEncryptAES_CTR, cryDecryptAES_CTR, KAT_SP800_SIZE,
+                           kat_sp800_plain, kat_sp800_counter,
+                           kat_sp800_ctr192),
+                "CTR-AES192 mismatch");
+    test_assert(kat_chained(cryEncryptAES_CTR, true, KAT_SP800_SIZE,
+                            kat_sp800_plain, kat_sp800_counter,
+                            kat_sp800_ctr192),
+                "chained CTR-AES192 mismatch");
+  }
+
+  /* [13.4.3] loading the 256 bits key, checking the vectors F.5.5 and
+     F.5.6*/
+  test_set_step(3);
+  {
+    cryerror_t err;
+
+    err = cryLoadAESTransientKey(&KAT_DRIVER, sizeof kat_sp800_key256,
+                                 kat_sp800_key256);
+    test_assert(err == CRY_NOERROR, "key loading failed");
+    test_assert(kat_cipher(cryEncryptAES_CTR, cryDecryptAES_CTR, KAT_SP800_SIZE,
+                           kat_sp800_plain, kat_sp800_counter,
+                           kat_sp800_ctr256),
+                "CTR-AES256 mismatch");
+    test_assert(kat_chained(cryEncryptAES_CTR, true, KAT_SP800_SIZE,
+                            kat_sp800_plain, kat_sp800_counter,
+                            kat_sp800_ctr256),
+                "chained CTR-AES256 mismatch");
+  }
+}
+
+static const testcase_t cry_test_013_004 = {
+  "AES-CTR NIST SP 800-38A vectors",
+  cry_test_013_004_setup,
+  cry_test_013_004_teardown,
+  cry_test_013_004_execute
+};
+
+/**
+ * @page cry_test_013_005 [13.5] AES-GCM known answers
+ *
+ * <h2>Description</h2>
+ * The testref GCM vectors 3 and 4 are encrypted and decrypted using the
+ * one-shot and the streaming functions, a decryption with a corrupted
+ * tag must fail the authentication.
+ *
+ * <h2>Test Steps</h2>
+ * - [13.5.1] loading the key of the vector 3, encrypting, the cipher
+ *   text and the tag are compared with C3 and T3
+ * - [13.5.2] decrypting, the text is compared with P3 then the
+ *   decryption is repeated with a corrupted tag
+ * - [13.5.3] encrypting and decrypting the vector 3 using the streaming
+ *   functions, one block per update
+ * - [13.5.4] loading the key of the vector 4, encrypting, the cipher
+ *   text and the tag are compared with C4 and T4
+ * - [13.5.5] decrypting, the text is compared with P4 then the
+ *   decryption is repeated with a corrupted tag
+ * - [13.5.6] encrypting and decrypting the vector 4 using the streaming
+ *   functions, one block per update
+ * .
+ */
+
+static void cry_test_013_005_setup(void) {
+  kat_setup();
+}
+
+static void cry_test_013_005_teardown(void) {
+  cryStop(&KAT_DRIVER);
+}
+
+static void cry_test_013_005_execute(void) {
+
+  /* [13.5.1] loading the key of the vector 3, encrypting, the cipher
+     text and the tag are compared with C3 and T3*/
+  test_set_step(1);
+  {
+    cryerror_t err;
+
+    err = cryLoadAESTransientKey(&KAT_DRIVER, K3_LEN, K3);
+    test_assert(err == CRY_NOERROR, "key loading failed");
+    err = cryEncryptAES_GCM(&KAT_DRIVER, 0, AAD3_LEN, A3, P3_LEN, P3, kat_out,
+                            IV3, T3_LEN, kat_tag);
+    test_assert(err == CRY_NOERROR, "encryption failed");
+    test_assert(memcmp(kat_out, C3, C3_LEN) == 0, "cipher text mismatch");
+    test_assert(memcmp(kat_tag, T3, T3_LEN) == 0, "tag mismatch");
+  }
+
+  /* [13.5.2] decrypting, the text is compared with P3 then the
+     decryption is repeated with a corrupted tag*/
+  test_set_step(2);
+  {
+    cryerror_t err;
+
+    err = cryDecryptAES_GCM(&KAT_DRIVER, 0, AAD3_LEN, A3, C3_LEN, C3, kat_chk,
+                            IV3, T3_LEN, T3);
+    test_assert(err == CRY_NOERROR, "decryption failed");
+    test_assert(memcmp(kat_chk, P3, P3_LEN) == 0, "text mismatch");
+    memcpy(kat_tag, T3, T3_LEN);
+    kat_tag[T3_LEN - 1] ^= 1U;
+    err = cryDecryptAES_GCM(&KAT_DRIVER, 0, AAD3_LEN, A3, C3_LEN, C3, kat_chk,
+                            IV3, T3_LEN, kat_tag);
+    test_assert(err == CRY_ERR_AUTH_FAILED, "corrupted tag accepted");
+  }
+
+  /* [13.5.3] encrypting and decrypting the vector 3 using the streaming
+     functions, one block per update*/
+  test_set_step(3);
+  {
+    AESGCMContext ctx;
+    cryerror_t err;
+    size_t n;
+
+    err = cryAES_GCMInit(&KAT_DRIVER, &ctx, 0, IV3, AAD3_LEN, A3);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    for (n = 0U; n < P3_LEN; n += 16U) {
+      err = cryEncryptAES_GCMUpdate(&KAT_DRIVER, &ctx, 16U, P3 + n, kat_out + n);
+      test_assert(err == CRY_NOERROR, "update failed");
+    }
+    err = cryEncryptAES_GCMFinal(&KAT_DRIVER, &ctx, T3_LEN, kat_tag);
+    test_assert(err == CRY_NOERROR, "finalization failed");
+    test_assert(memcmp(kat_out, C3, C3_LEN) == 0, "cipher text mismatch");
+    test_assert(memcmp(kat_tag, T3, T3_LEN) == 0, "tag mismatch");
+
+    err = cryAES_GCMInit(&KAT_DRIVER, &ctx, 0, IV3, AAD3_LEN, A3);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    for (n = 0U; n < C3_LEN; n += 16U) {
+      err = cryDecryptAES_GCMUpdate(&KAT_DRIVER, &ctx, 16U, C3 + n, kat_chk + n);
+      test_assert(err == CRY_NOERROR, "update failed");
+    }
+    err = cryDecryptAES_GCMFinal(&KAT_DRIVER, &ctx, T3_LEN, T3);
+    test_assert(err == CRY_NOERROR, "authentication failed");
+    test_assert(memcmp(kat_chk, P3, P3_LEN) == 0, "text mismatch");
+  }
+
+  /* [13.5.4] loading the key of the vector 4, encrypting, the cipher
+     text and the tag are compared with C4 and T4*/
+  test_set_step(4);
+  {
+    cryerror_t err;
+
+    err = cryLoadAESTransientKey(&KAT_DRIVER, K4_LEN, K4);
+    test_assert(err == CRY_NOERROR, "key loading failed");
+    err = cryEncryptAES_GCM(&KAT_DRIVER, 0, AAD4_LEN, A4, P4_LEN, P4, kat_out,
+                            IV4, T4_LEN, kat_tag);
+    test_assert(err == CRY_NOERROR, "encryption failed");
+    test_assert(memcmp(kat_out, C4, C4_LEN) == 0, "cipher text mismatch");
+    test_assert(memcmp(kat_tag, T4, T4_LEN) == 0, "tag mismatch");
+  }
+
+  /* [13.5.5] decrypting, the text is compared with P4 then the
+     decryption is repeated with a corrupted tag*/
+  test_set_step(5);
+  {
+    cryerror_t err;
+
+    err = cryDecryptAES_GCM(&KAT_DRIVER, 0, AAD4_LEN, A4, C4_LEN, C4, kat_chk,
+                            IV4, T4_LEN, T4);
+    test_assert(err == CRY_NOERROR, "decryption failed");
+    test_assert(memcmp(kat_chk, P4, P4_LEN) == 0, "text mismatch");
+    memcpy(kat_tag, T4, T4_LEN);
+    kat_tag[T4_LEN - 1] ^= 1U;
+    err = cryDecryptAES_GCM(&KAT_DRIVER, 0, AAD4_LEN, A4, C4_LEN, C4, kat_chk,
+                            IV4, T4_LEN, kat_tag);
+    test_assert(err == CRY_ERR_AUTH_FAILED, "corrupted tag accepted");
+  }
+
+  /* [13.5.6] encrypting and decrypting the vector 4 using the streaming
+     functions, one block per update*/
+  test_set_step(6);
+  {
+    AESGCMContext ctx;
+    cryerror_t err;
+    size_t n;
+
+    err = cryAES_GCMInit(&KAT_DRIVER, &ctx, 0, IV4, AAD4_LEN, A4);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    for (n = 0U; n < P4_LEN; n += 16U) {
+      err = cryEncryptAES_GCMUpdate(&KAT_DRIVER, &ctx, 16U, P4 + n, kat_out + n);
+      test_assert(err == CRY_NOERROR, "update failed");
+    }
+    err = cryEncryptAES_GCMFinal(&KAT_DRIVER, &ctx, T4_LEN, kat_tag);
+    test_assert(err == CRY_NOERROR, "finalization failed");
+    test_assert(memcmp(kat_out, C4, C4_LEN) == 0, "cipher text mismatch");
+    test_assert(memcmp(kat_tag, T4, T4_LEN) == 0, "tag mismatch");
+
+    err = cryAES_GCMInit(&KAT_DRIVER, &ctx, 0, IV4, AAD4_LEN, A4);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    for (n = 0U; n < C4_LEN; n += 16U) {
+      err = cryDecryptAES_GCMUpdate(&KAT_DRIVER, &ctx, 16U, C4 + n, kat_chk + n);
+      test_assert(err == CRY_NOERROR, "update failed");
+    }
+    err = cryDecryptAES_GCMFinal(&KAT_DRIVER, &ctx, T4_LEN, T4);
+    test_assert(err == CRY_NOERROR, "authentication failed");
+    test_assert(memcmp(kat_chk, P4, P4_LEN) == 0, "text mismatch");
+  }
+}
+
+static const testcase_t cry_test_013_005 = {
+  "AES-GCM known answers",
+  cry_test_013_005_setup,
+  cry_test_013_005_teardown,
+  cry_test_013_005_execute
+};
+
+/**
+ * @page cry_test_013_006 [13.6] SHA-1 known answers
+ *
+ * <h2>Description</h2>
+ * The SHA-1 digests of the testref messages are calculated and compared
+ * with the testref tables, the messages are the empty message, "abc",
+ * the 56 bytes FIPS 180 message and 64 and 128 "a" characters.
+ *
+ * <h2>Test Steps</h2>
+ * - [13.6.1] digest of the empty message, compared with
+ *   refSHA_SHA1_EMPTY
+ * - [13.6.2] digest of the message "abc", compared with refSHA_SHA1_3
+ * - [13.6.3] digest of the 56 bytes message "abcdbcde...nopq", compared
+ *   with refSHA_SHA1_56
+ * - [13.6.4] digest of 64 "a" characters, compared with refSHA_SHA1_64
+ * - [13.6.5] digest of 128 "a" characters, compared with
+ *   refSHA_SHA1_128
+ * - [13.6.6] digest of 128 "a" characters in two updates of 1 and 127
+ *   bytes, compared with refSHA_SHA1_128
+ * .
+ */
+
+static void cry_test_013_006_setup(void) {
+  kat_setup();
+}
+
+static void cry_test_013_006_teardown(void) {
+  cryStop(&KAT_DRIVER);
+}
+
+static void cry_test_013_006_execute(void) {
+
+  /* [13.6.1] digest of the empty message, compared with
+     refSHA_SHA1_EMPTY*/
+  test_set_step(1);
+  {
+    SHA1Context ctx;
+    cryerror_t err;
+
+    err = crySHA1Init(&KAT_DRIVER, &ctx);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    err = crySHA1Final(&KAT_DRIVER, &ctx, kat_out);
+    test_assert(err == CRY_NOERROR, "finalization failed");
+    test_assert(memcmp(kat_out, refSHA_SHA1_EMPTY, 20U) == 0, "digest mismatch");
+  }
+
+  /* [13.6.2] digest of the message "abc", compared with refSHA_SHA1_3*/
+  test_set_step(2);
+  {
+    SHA1Context ctx;
+    cryerror_t err;
+
+    err = crySHA1Init(&KAT_DRIVER, &ctx);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    err = crySHA1Update(&KAT_DRIVER, &ctx, 3U, kat_sha_abc);
+    test_assert(err == CRY_NOERROR, "update failed");
+    err = crySHA1Final(&KAT_DRIVER, &ctx, kat_out);
+    test_assert(err == CRY_NOERROR, "finalization failed");
+    test_assert(memcmp(kat_out, refSHA_SHA1_3, 20U) == 0, "digest mismatch");
+  }
+
+  /* [13.6.3] digest of the 56 bytes message "abcdbcde...nopq", compared
+     with refSHA_SHA1_56*/
+  test_set_step(3);
+  {
+    SHA1Context ctx;
+    cryerror_t err;
+
+    err = crySHA1Init(&KAT_DRIVER, &ctx);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    err = crySHA1Update(&KAT_DRIVER, &ctx, 56U, (const uint8_t *)kat_sha_56);
+    test_assert(err == CRY_NOERROR, "update failed");
+    err = crySHA1Final(&KAT_DRIVER, &ctx, kat_out);
+    test_assert(err == CRY_NOERROR, "finalization failed");
+    test_assert(memcmp(kat_out, refSHA_SHA1_56, 20U) == 0, "digest mismatch");
+  }
+
+  /* [13.6.4] digest of 64 "a" characters, compared with refSHA_SHA1_64*/
+  test_set_step(4);
+  {
+    SHA1Context ctx;
+    cryerror_t err;
+
+    err = crySHA1Init(&KAT_DRIVER, &ctx);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    err = crySHA1Update(&KAT_DRIVER, &ctx, 64U, kat_sha_a);
+    test_assert(err == CRY_NOERROR, "update failed");
+    err = crySHA1Final(&KAT_DRIVER, &ctx, kat_out);
+    test_assert(err == CRY_NOERROR, "finalization failed");
+    test_assert(memcmp(kat_out, refSHA_SHA1_64, 20U) == 0, "digest mismatch");
+  }
+
+  /* [13.6.5] digest of 128 "a" characters, compared with
+     refSHA_SHA1_128*/
+  test_set_step(5);
+  {
+    SHA1Context ctx;
+    cryerror_t err;
+
+    err = crySHA1Init(&KAT_DRIVER, &ctx);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    err = crySHA1Update(&KAT_DRIVER, &ctx, 128U, kat_sha_a);
+    test_assert(err == CRY_NOERROR, "update failed");
+    err = crySHA1Final(&KAT_DRIVER, &ctx, kat_out);
+    test_assert(err == CRY_NOERROR, "finalization failed");
+    test_assert(memcmp(kat_out, refSHA_SHA1_128, 20U) == 0, "digest mismatch");
+  }
+
+  /* [13.6.6] digest of 128 "a" characters in two updates of 1 and 127
+     bytes, compared with refSHA_SHA1_128*/
+  test_set_step(6);
+  {
+    SHA1Context ctx;
+    cryerror_t err;
+
+    err = crySHA1Init(&KAT_DRIVER, &ctx);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    err = crySHA1Update(&KAT_DRIVER, &ctx, 1U, kat_sha_a);
+    test_assert(err == CRY_NOERROR, "update failed");
+    err = crySHA1Update(&KAT_DRIVER, &ctx, 127U, kat_sha_a + 1);
+    test_assert(err == CRY_NOERROR, "update failed");
+    err = crySHA1Final(&KAT_DRIVER, &ctx, kat_out);
+    test_assert(err == CRY_NOERROR, "finalization failed");
+    test_assert(memcmp(kat_out, refSHA_SHA1_128, 20U) == 0, "digest mismatch");
+  }
+}
+
+static const testcase_t cry_test_013_006 = {
+  "SHA-1 known answers",
+  cry_test_013_006_setup,
+  cry_test_013_006_teardown,
+  cry_test_013_006_execute
+};
+
+/**
+ * @page cry_test_013_007 [13.7] SHA-512 known answers
+ *
+ * <h2>Description</h2>
+ * The SHA-512 digests of the testref messages are calculated and
+ * compared with the testref tables, the messages are "abc", the 56
+ * bytes FIPS 180 message and 64 and 128 "a" characters.
+ *
+ * <h2>Test Steps</h2>
+ * - [13.7.1] digest of the message "abc", compared with refSHA_SHA512_3
+ * - [13.7.2] digest of the 56 bytes message "abcdbcde...nopq", compared
+ *   with refSHA_SHA512_56
+ * - [13.7.3] digest of 64 "a" characters, compared with
+ *   refSHA_SHA512_64
+ * - [13.7.4] digest of 128 "a" characters, compared with
+ *   refSHA_SHA512_128
+ * - [13.7.5] digest of 128 "a" characters in two updates of 1 and 127
+ *   bytes, compared with refSHA_SHA512_128
+ * .
+ */
+
+static void cry_test_013_007_setup(void) {
+  kat_setup();
+}
+
+static void cry_test_013_007_teardown(void) {
+  cryStop(&KAT_DRIVER);
+}
+
+static void cry_test_013_007_execute(void) {
+
+  /* [13.7.1] digest of the message "abc", compared with refSHA_SHA512_3*/
+  test_set_step(1);
+  {
+    SHA512Context ctx;
+    cryerror_t err;
+
+    err = crySHA512Init(&KAT_DRIVER, &ctx);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    err = crySHA512Update(&KAT_DRIVER, &ctx, 3U, kat_sha_abc);
+    test_assert(err == CRY_NOERROR, "update failed");
+    err = crySHA512Final(&KAT_DRIVER, &ctx, kat_out);
+    test_assert(err == CRY_NOERROR, "finalization failed");
+    test_assert(memcmp(kat_out, refSHA_SHA512_3, 64U) == 0, "digest mismatch");
+  }
+
+  /* [13.7.2] digest of the 56 bytes message "abcdbcde...nopq", compared
+     with refSHA_SHA512_56*/
+  test_set_step(2);
+  {
+    SHA512Context ctx;
+    cryerror_t err;
+
+    err = crySHA512Init(&KAT_DRIVER, &ctx);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    err = crySHA512Update(&KAT_DRIVER, &ctx, 56U, (const uint8_t *)kat_sha_56);
+    test_assert(err == CRY_NOERROR, "update failed");
+    err = crySHA512Final(&KAT_DRIVER, &ctx, kat_out);
+    test_assert(err == CRY_NOERROR, "finalization failed");
+    test_assert(memcmp(kat_out, refSHA_SHA512_56, 64U) == 0, "digest mismatch");
+  }
+
+  /* [13.7.3] digest of 64 "a" characters, compared with
+     refSHA_SHA512_64*/
+  test_set_step(3);
+  {
+    SHA512Context ctx;
+    cryerror_t err;
+
+    err = crySHA512Init(&KAT_DRIVER, &ctx);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    err = crySHA512Update(&KAT_DRIVER, &ctx, 64U, kat_sha_a);
+    test_assert(err == CRY_NOERROR, "update failed");
+    err = crySHA512Final(&KAT_DRIVER, &ctx, kat_out);
+    test_assert(err == CRY_NOERROR, "finalization failed");
+    test_assert(memcmp(kat_out, refSHA_SHA512_64, 64U) == 0, "digest mismatch");
+  }
+
+  /* [13.7.4] digest of 128 "a" characters, compared with
+     refSHA_SHA512_128*/
+  test_set_step(4);
+  {
+    SHA512Context ctx;
+    cryerror_t err;
+
+    err = crySHA512Init(&KAT_DRIVER, &ctx);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    err = crySHA512Update(&KAT_DRIVER, &ctx, 128U, kat_sha_a);
+    test_assert(err == CRY_NOERROR, "update failed");
+    err = crySHA512Final(&KAT_DRIVER, &ctx, kat_out);
+    test_assert(err == CRY_NOERROR, "finalization failed");
+    test_assert(memcmp(kat_out, refSHA_SHA512_128, 64U) == 0, "digest mismatch");
+  }
+
+  /* [13.7.5] digest of 128 "a" characters in two updates of 1 and 127
+     bytes, compared with refSHA_SHA512_128*/
+  test_set_step(5);
+  {
+    SHA512Context ctx;
+    cryerror_t err;
+
+    err = crySHA512Init(&KAT_DRIVER, &ctx);
+    test_assert(err == CRY_NOERROR, "initialization failed");
+    err = crySHA512Update(&KAT_DRIVER, &ctx, 1U, kat_sha_a);
+    test_assert(err == CRY_NOERROR, "update failed");
+    err = crySHA512Update(&KAT_DRIVER, &ctx, 127U, kat_sha_a + 1);
+    test_assert(err == CRY_NOERROR, "update failed");
+    err = crySHA512Final(&KAT_DRIVER, &ctx, kat_out);
+    test_assert(err == CRY_NOERROR, "finalization failed");
+    test_assert(memcmp(kat_out, refSHA_SHA512_128, 64U) == 0, "digest mismatch");
+  }
+}
+
+static const testcase_t cry_test_013_007 = {
+  "SHA-512 known answers",
+  cry_test_013_007_setup,
+  cry_test_013_007_teardown,
+  cry_test_013_007_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const cry_test_sequence_013_array[] = {
+  &cry_test_013_001,
+  &cry_test_013_002,
+  &cry_test_013_003,
+  &cry_test_013_004,
+  &cry_test_013_005,
+  &cry_test_013_006,
+  &cry_test_013_007,
+  NULL
+};
+
+/**
+ * @brief   Portable API known answers.
+ */
+const testsequence_t cry_test_sequence_013 = {
+  "Portable API known answers",
+  cry_test_sequence_013_array
+};
@@ -0,0 +1,66 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdlib.h>
+
+#include "ch.h"
+#include "hal.h"
+#include "cry_test_root.h"
+#include "console.h"
+
+/*
+ * Sequences of the crypto test suite using the portable API.
+ */
+static const testsequence_t * const cry_testbuild_array[] = {
+  &cry_test_sequence_010,
+#if HAL_CRY_USE_QUEUE == TRUE
+  &cry_test_sequence_011,
+#endif
+  &cry_test_sequence_012,
+  &cry_test_sequence_013,
+  NULL
+};
+
+static const testsuite_t cry_testbuild_suite = {
+  "ChibiOS HAL Crypto Test Suite (simulator)",
+  cry_testbuild_array
+};
+
+/*
+ * Simulator main.
+ */
+int main(int argc, char *argv[]) {
+
+  (void)argc;
+  (void)argv;
+
+  /*
+   * System initializations.
+   * - HAL initialization, this also initializes the configured device drivers
+   *   and performs the board-specific initializations.
+   * - Kernel initialization, the main() function becomes a thread and the
+   *   RTOS is active.
+   */
+  halInit();
+  conInit();
+  chSysInit();
+
+  test_execute((BaseSequentialStream *)&CD1, &cry_testbuild_suite);
+  if (test_global_fail)
+    exit(1);
+  else
+    exit(0);
+}
@@ -0,0 +1,13 @@
+# List of all the ChibiOS/HAL test files.
+TESTSRC += ${CHIBIOS}/test/hal/source/test/hal_test_root.c \
+           ${CHIBIOS}/test/hal/source/test/hal_test_sequence_001.c \
+           ${CHIBIOS}/test/hal/source/test/hal_test_sequence_002.c \
+           ${CHIBIOS}/test/hal/source/test/hal_test_sequence_003.c \
+           ${CHIBIOS}/test/hal/source/test/hal_test_sequence_004.c \
+           ${CHIBIOS}/test/hal/source/test/hal_test_sequence_005.c \
+           ${CHIBIOS}/test/hal/source/test/hal_test_sequence_006.c \
+           ${CHIBIOS}/test/hal/source/test/hal_test_sequence_007.c \
+           ${CHIBIOS}/test/hal/source/test/hal_test_sequence_008.c
+
+# Required include directories
+TESTINC += ${CHIBIOS}/test/hal/source/test
@@ -0,0 +1,130 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @mainpage Test Suite Specification
+ * Test suite for ChibiOS/HAL. The purpose of this suite is to perform
+ * unit tests on the portable HAL drivers code using the simulator low
+ * level drivers.
+ *
+ * <h2>Test Sequences</h2>
+ * - @subpage hal_test_sequence_001
+ * - @subpage hal_test_sequence_002
+ * - @subpage hal_test_sequence_003
+ * - @subpage hal_test_sequence_004
+ * - @subpage hal_test_sequence_005
+ * - @subpage hal_test_sequence_006
+ * - @subpage hal_test_sequence_007
+ * - @subpage hal_test_sequence_008
+ * .
+ */
+
+/**
+ * @file    hal_test_root.c
+ * @brief   Test Suite root structures code.
+ */
+
+#include "hal.h"
+#include "hal_test_root.h"
+
+#if !defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* Module exported variables.                                                */
+/*===========================================================================*/
+
+/**
+ * @brief   Array of test sequences.
+ */
+const testsequence_t * const hal_test_suite_array[] = {
+#if ((HAL_USE_SPI == TRUE) && (SPI_USE_QUEUE == TRUE) && (SPI_USE_WAIT == TRUE) && (SPI_SELECT_MODE == SPI_SELECT_MODE_LLD) && defined(SIMULATOR)) || defined(__DOXYGEN__)
+  &hal_test_sequence_001,
+#endif
+#if ((HAL_TEST_SNOR == TRUE) && (SNOR_USE_READ_CACHE == TRUE)) || defined(__DOXYGEN__)
+  &hal_test_sequence_002,
+#endif
+#if ((HAL_TEST_SNOR == TRUE) && (SNOR_USE_ERASE_QUEUE == TRUE) && (SNOR_USE_ERASE_SUSPEND == TRUE)) || defined(__DOXYGEN__)
+  &hal_test_sequence_003,
+#endif
+  &hal_test_sequence_004,
+#if (HAL_USE_SERIAL == TRUE) || defined(__DOXYGEN__)
+  &hal_test_sequence_005,
+#endif
+  &hal_test_sequence_006,
+#if ((HAL_USE_SERIAL_USB == TRUE) && defined(SIMULATOR)) || defined(__DOXYGEN__)
+  &hal_test_sequence_007,
+#endif
+#if (HAL_TEST_LIS3DSH == TRUE) || defined(__DOXYGEN__)
+  &hal_test_sequence_008,
+#endif
+  NULL
+};
+
+/**
+ * @brief   Test suite root structure.
+ */
+const testsuite_t hal_test_suite = {
+  "ChibiOS/HAL Test Suite",
+  hal_test_suite_array
+};
+
+/*===========================================================================*/
+/* Shared code.                                                              */
+/*===========================================================================*/
+
+#if (HAL_TEST_SNOR == TRUE) || defined(__DOXYGEN__)
+sim_n25q_t n25q_model;
+
+static uint8_t n25q_model_mem[N25Q_MODEL_SIZE];
+
+static const SPIConfig snor_spicfg = {
+  .end_cb = NULL,
+  .device = simN25QGetDevice(&n25q_model)
+};
+
+const SNORConfig snorcfg1 = {
+  .busp             = &SPID1,
+  .buscfg           = &snor_spicfg
+};
+
+SNORDriver snor1;
+
+uint8_t n25q_model_pattern(flash_offset_t offset) {
+
+  return (uint8_t)(offset + (offset >> 8) + 1U);
+}
+
+void n25q_model_reset(void) {
+  flash_offset_t offset;
+
+  simN25QObjectInit(&n25q_model, n25q_model_mem, N25Q_MODEL_SIZE);
+  for (offset = 0U; offset < N25Q_MODEL_SIZE; offset++) {
+    n25q_model_mem[offset] = n25q_model_pattern(offset);
+  }
+}
+
+bool n25q_model_check(flash_offset_t offset, size_t n, const uint8_t *p) {
+
+  while (n-- > 0U) {
+    if (*p++ != n25q_model_pattern(offset++)) {
+      return false;
+    }
+  }
+  return true;
+}
+#endif /* HAL_TEST_SNOR == TRUE */
+
+#endif /* !defined(__DOXYGEN__) */
@@ -0,0 +1,95 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+/**
+ * @file    hal_test_root.h
+ * @brief   Test Suite root structures header.
+ */
+
+#ifndef HAL_TEST_ROOT_H
+#define HAL_TEST_ROOT_H
+
+#include "ch_test.h"
+
+#include "hal_test_sequence_001.h"
+#include "hal_test_sequence_002.h"
+#include "hal_test_sequence_003.h"
+#include "hal_test_sequence_004.h"
+#include "hal_test_sequence_005.h"
+#include "hal_test_sequence_006.h"
+#include "hal_test_sequence_007.h"
+#include "hal_test_sequence_008.h"
+
+#if !defined(__DOXYGEN__)
+
+/*===========================================================================*/
+/* External declarations.                                                    */
+/*===========================================================================*/
+
+extern const testsuite_t hal_test_suite;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+#ifdef __cplusplus
+}
+#endif
+
+/*===========================================================================*/
+/* Shared definitions.                                                       */
+/*===========================================================================*/
+
+#define TEST_SUITE_NAME                     "ChibiOS/HAL Test Suite"
+
+/* Serial NOR tests are enabled when the driver is part of the build, it
+   uses a simulated N25Q device in SPI mode.*/
+#if (HAL_USE_SPI == TRUE) && (SPI_SELECT_MODE == SPI_SELECT_MODE_LLD) &&   \
+    defined(SIMULATOR) && defined(SNOR_BUS_DRIVER)
+#include "hal_serial_nor.h"
+#define HAL_TEST_SNOR                       TRUE
+#else
+#define HAL_TEST_SNOR                       FALSE
+#endif
+
+#if (HAL_TEST_SNOR == TRUE) || defined(__DOXYGEN__)
+#include "sim_n25q.h"
+
+#define N25Q_MODEL_SIZE                     0x40000U
+
+extern sim_n25q_t n25q_model;
+extern const SNORConfig snorcfg1;
+extern SNORDriver snor1;
+
+uint8_t n25q_model_pattern(flash_offset_t offset);
+void n25q_model_reset(void);
+bool n25q_model_check(flash_offset_t offset, size_t n, const uint8_t *p);
+#endif
+
+/* LIS3DSH tests are enabled when the device driver is part of the build,
+   it uses a simulated device on the SPI transactions queue.*/
+#if (HAL_USE_SPI == TRUE) && (SPI_SELECT_MODE == SPI_SELECT_MODE_LLD) &&   \
+    (SPI_USE_QUEUE == TRUE) && (SPI_USE_WAIT == TRUE) &&                   \
+    defined(SIMULATOR) && defined(LIS3DSH_USE_SPI)
+#include "lis3dsh.h"
+#include "sim_lis3dsh.h"
+#define HAL_TEST_LIS3DSH                    TRUE
+#else
+#define HAL_TEST_LIS3DSH                    FALSE
+#endif
+
+#endif /* !defined(__DOXYGEN__) */
+
+#endif /* HAL_TEST_ROOT_H */
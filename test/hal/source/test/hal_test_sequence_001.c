@@ -0,0 +1,440 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "hal_test_root.h"
+
+/**
+ * @file    hal_test_sequence_001.c
+ * @brief   Test Sequence 001 code.
+ *
+ * @page hal_test_sequence_001 [1] SPI transactions queue
+ *
+ * File: @ref hal_test_sequence_001.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the SPI driver transactions queue using the
+ * simulated SPI driver, devices are modeled in order to record the CS
+ * line transitions.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (HAL_USE_SPI == TRUE) && (SPI_USE_QUEUE == TRUE) && (SPI_USE_WAIT == TRUE) && (SPI_SELECT_MODE == SPI_SELECT_MODE_LLD) && defined(SIMULATOR)
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage hal_test_001_001
+ * - @subpage hal_test_001_002
+ * - @subpage hal_test_001_003
+ * .
+ */
+
+#if ((HAL_USE_SPI == TRUE) && (SPI_USE_QUEUE == TRUE) && (SPI_USE_WAIT == TRUE) && (SPI_SELECT_MODE == SPI_SELECT_MODE_LLD) && defined(SIMULATOR)) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+/* Simulated device state.*/
+typedef struct {
+  char                      name;
+  bool                      selected;
+  uint8_t                   data;
+} spi_test_device_t;
+
+static spi_test_device_t devstate_a = {'A', false, 0U};
+static spi_test_device_t devstate_b = {'B', false, 0U};
+
+static spi_transaction_t tr[5];
+static uint8_t rxbuf[5][4];
+static spi_transaction_t *tr_late;
+
+/*
+ * Device CS asserted, only transitions are recorded because the CS line
+ * is asserted again at the start of each member of a group.
+ */
+static void dev_select(void *arg) {
+  spi_test_device_t *devp = (spi_test_device_t *)arg;
+
+  if (!devp->selected) {
+    devp->selected = true;
+    test_emit_token_i(devp->name);
+  }
+}
+
+/*
+ * Device CS deasserted.
+ */
+static void dev_unselect(void *arg) {
+  spi_test_device_t *devp = (spi_test_device_t *)arg;
+
+  if (devp->selected) {
+    devp->selected = false;
+    test_emit_token_i((char)(devp->name + ('a' - 'A')));
+  }
+}
+
+/*
+ * Device frame exchange, the device returns a counter, exchanges without
+ * CS asserted are recorded as errors.
+ */
+static uint8_t dev_exchange(void *arg, uint8_t frame) {
+  spi_test_device_t *devp = (spi_test_device_t *)arg;
+
+  (void)frame;
+
+  if (!devp->selected) {
+    osalSysLockFromISR();
+    test_emit_token_i('!');
+    osalSysUnlockFromISR();
+  }
+
+  return devp->data++;
+}
+
+static const spi_sim_device_t dev_a = {
+  dev_select, dev_unselect, dev_exchange, &devstate_a
+};
+
+static const spi_sim_device_t dev_b = {
+  dev_select, dev_unselect, dev_exchange, &devstate_b
+};
+
+static const SPIConfig spicfg_loop = {
+  .end_cb = NULL,
+  .device = NULL
+};
+
+static const SPIConfig spicfg_a = {
+  .end_cb = NULL,
+  .device = &dev_a
+};
+
+static const SPIConfig spicfg_b = {
+  .end_cb = NULL,
+  .device = &dev_b
+};
+
+/*
+ * Transaction callback, it records the transaction index and queues the
+ * late transaction, if any.
+ */
+static void tr_end(SPIDriver *spip, spi_transaction_t *stp) {
+
+  osalSysLockFromISR();
+  test_emit_token_i((char)('0' + (stp - tr)));
+  if (tr_late != NULL) {
+    spiQueueTransactionI(spip, tr_late);
+    tr_late = NULL;
+  }
+  osalSysUnlockFromISR();
+}
+
+/*
+ * Prepares a transaction receiving 4 frames, group members are linked to
+ * the following transaction.
+ */
+static void tr_init(unsigned i, const SPIConfig *cfgp,
+                    uint8_t prio, uint8_t flags) {
+  spi_transaction_t *stp = &tr[i];
+
+  stp->next   = (flags & SPI_TRANSACTION_KEEP_SELECTED) != 0U ? &tr[i + 1U] :
+                                                                NULL;
+  stp->config = cfgp;
+  stp->n      = sizeof rxbuf[i];
+  stp->txbuf  = NULL;
+  stp->rxbuf  = rxbuf[i];
+  stp->end_cb = tr_end;
+  stp->prio   = prio;
+  stp->flags  = flags;
+  stp->state  = SPI_TRANSACTION_IDLE;
+}
+
+static void spi_test_setup(const SPIConfig *cfgp) {
+
+  devstate_a.selected = false;
+  devstate_a.data     = 0U;
+  devstate_b.selected = false;
+  devstate_b.data     = 0U;
+  tr_late = NULL;
+  spiStart(&SPID1, cfgp);
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page hal_test_001_001 [1.1] Priority ordering
+ *
+ * <h2>Description</h2>
+ * Transactions are queued while the driver is busy, the execution order
+ * is checked.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.1.1] Five transactions are queued from within a critical zone,
+ *   the first one is started immediately.
+ * - [1.1.2] Waiting for the lowest priority transaction, the others are
+ *   expected to be executed in priority order, FIFO order for equal
+ *   priorities.
+ * - [1.1.3] The driver is expected to be idle with an empty queue.
+ * .
+ */
+
+static void hal_test_001_001_setup(void) {
+  spi_test_setup(&spicfg_loop);
+}
+
+static void hal_test_001_001_teardown(void) {
+  spiStop(&SPID1);
+}
+
+static void hal_test_001_001_execute(void) {
+
+  /* [1.1.1] Five transactions are queued from within a critical zone,
+     the first one is started immediately.*/
+  test_set_step(1);
+  {
+    tr_init(0U, &spicfg_loop, 0U, 0U);
+    tr_init(1U, &spicfg_loop, 1U, 0U);
+    tr_init(2U, &spicfg_loop, 3U, 0U);
+    tr_init(3U, &spicfg_loop, 2U, 0U);
+    tr_init(4U, &spicfg_loop, 3U, 0U);
+    osalSysLock();
+    spiQueueTransactionI(&SPID1, &tr[0]);
+    spiQueueTransactionI(&SPID1, &tr[1]);
+    spiQueueTransactionI(&SPID1, &tr[2]);
+    spiQueueTransactionI(&SPID1, &tr[3]);
+    spiQueueTransactionI(&SPID1, &tr[4]);
+    osalSysUnlock();
+  }
+  test_end_step(1);
+
+  /* [1.1.2] Waiting for the lowest priority transaction, the others are
+     expected to be executed in priority order, FIFO order for equal
+     priorities.*/
+  test_set_step(2);
+  {
+    spiWaitTransaction(&SPID1, &tr[1]);
+    test_assert_sequence("02431", "invalid order");
+  }
+  test_end_step(2);
+
+  /* [1.1.3] The driver is expected to be idle with an empty queue.*/
+  test_set_step(3);
+  {
+    test_assert((SPID1.state == SPI_READY) &&
+                (SPID1.tqueue == NULL) && (SPID1.tcurrent == NULL),
+                "driver not idle");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t hal_test_001_001 = {
+  "Priority ordering",
+  hal_test_001_001_setup,
+  hal_test_001_001_teardown,
+  hal_test_001_001_execute
+};
+
+/**
+ * @page hal_test_001_002 [1.2] Groups ordering
+ *
+ * <h2>Description</h2>
+ * A group and single transactions are queued while the driver is busy,
+ * the group is expected to be executed as a whole with the CS line
+ * asserted once.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.2.1] A transaction on device A is started, then a group of two
+ *   transactions on device A and two transactions on device B, one with
+ *   the same priority of the group and one with higher priority, are
+ *   queued.
+ * - [1.2.2] Waiting for the last transaction, the group is expected to
+ *   be executed after the higher priority transaction and before the
+ *   transaction with equal priority.
+ * - [1.2.3] The driver is expected to be idle with an empty queue.
+ * .
+ */
+
+static void hal_test_001_002_setup(void) {
+  spi_test_setup(&spicfg_a);
+}
+
+static void hal_test_001_002_teardown(void) {
+  spiStop(&SPID1);
+}
+
+static void hal_test_001_002_execute(void) {
+
+  /* [1.2.1] A transaction on device A is started, then a group of two
+     transactions on device A and two transactions on device B, one with
+     the same priority of the group and one with higher priority, are
+     queued.*/
+  test_set_step(1);
+  {
+    tr_init(0U, &spicfg_a, 0U, 0U);
+    tr_init(1U, &spicfg_a, 2U, SPI_TRANSACTION_KEEP_SELECTED);
+    tr_init(2U, &spicfg_a, 2U, 0U);
+    tr_init(3U, &spicfg_b, 2U, 0U);
+    tr_init(4U, &spicfg_b, 3U, 0U);
+    osalSysLock();
+    spiQueueTransactionI(&SPID1, &tr[0]);
+    spiQueueTransactionI(&SPID1, &tr[1]);
+    spiQueueTransactionI(&SPID1, &tr[3]);
+    spiQueueTransactionI(&SPID1, &tr[4]);
+    osalSysUnlock();
+  }
+  test_end_step(1);
+
+  /* [1.2.2] Waiting for the last transaction, the group is expected to
+     be executed after the higher priority transaction and before the
+     transaction with equal priority.*/
+  test_set_step(2);
+  {
+    spiWaitTransaction(&SPID1, &tr[3]);
+    test_assert_sequence("Aa0Bb4A1a2Bb3", "invalid sequence");
+  }
+  test_end_step(2);
+
+  /* [1.2.3] The driver is expected to be idle with an empty queue.*/
+  test_set_step(3);
+  {
+    test_assert((SPID1.state == SPI_READY) &&
+                (SPID1.tqueue == NULL) && (SPID1.tcurrent == NULL),
+                "driver not idle");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t hal_test_001_002 = {
+  "Groups ordering",
+  hal_test_001_002_setup,
+  hal_test_001_002_teardown,
+  hal_test_001_002_execute
+};
+
+/**
+ * @page hal_test_001_003 [1.3] Group in progress
+ *
+ * <h2>Description</h2>
+ * A higher priority transaction is queued from the callback of the
+ * first member of a group being executed, the group is expected to not
+ * be split.
+ *
+ * <h2>Test Steps</h2>
+ * - [1.3.1] A group of three transactions on device A is queued, a
+ *   transaction on device B with higher priority is queued by the
+ *   callback of the first member.
+ * - [1.3.2] Waiting for the last member of the group then for the late
+ *   transaction, it is expected to be executed after the whole group
+ *   and the CS line of device A is expected to be asserted once.
+ * - [1.3.3] Checking the received data, the group members received
+ *   consecutive frames from device A.
+ * - [1.3.4] The driver is expected to be idle with an empty queue.
+ * .
+ */
+
+static void hal_test_001_003_setup(void) {
+  spi_test_setup(&spicfg_a);
+}
+
+static void hal_test_001_003_teardown(void) {
+  spiStop(&SPID1);
+}
+
+static void hal_test_001_003_execute(void) {
+  unsigned i;
+
+  /* [1.3.1] A group of three transactions on device A is queued, a
+     transaction on device B with higher priority is queued by the
+     callback of the first member.*/
+  test_set_step(1);
+  {
+    tr_init(1U, &spicfg_a, 0U, SPI_TRANSACTION_KEEP_SELECTED);
+    tr_init(2U, &spicfg_a, 0U, SPI_TRANSACTION_KEEP_SELECTED);
+    tr_init(3U, &spicfg_a, 0U, 0U);
+    tr_init(4U, &spicfg_b, 5U, 0U);
+    tr_late = &tr[4];
+    spiQueueTransaction(&SPID1, &tr[1]);
+  }
+  test_end_step(1);
+
+  /* [1.3.2] Waiting for the last member of the group then for the late
+     transaction, it is expected to be executed after the whole group
+     and the CS line of device A is expected to be asserted once.*/
+  test_set_step(2);
+  {
+    spiWaitTransaction(&SPID1, &tr[3]);
+    spiWaitTransaction(&SPID1, &tr[4]);
+    test_assert_sequence("A12a3Bb4", "invalid sequence");
+  }
+  test_end_step(2);
+
+  /* [1.3.3] Checking the received data, the group members received
+     consecutive frames from device A.*/
+  test_set_step(3);
+  {
+    for (i = 0U; i < 12U; i++) {
+      test_assert(rxbuf[1U + (i / 4U)][i % 4U] == (uint8_t)i, "invalid data");
+    }
+    for (i = 0U; i < 4U; i++) {
+      test_assert(rxbuf[4][i] == (uint8_t)i, "invalid data");
+    }
+  }
+  test_end_step(3);
+
+  /* [1.3.4] The driver is expected to be idle with an empty queue.*/
+  test_set_step(4);
+  {
+    test_assert((SPID1.state == SPI_READY) &&
+                (SPID1.tqueue == NULL) && (SPID1.tcurrent == NULL),
+                "driver not idle");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t hal_test_001_003 = {
+  "Group in progress",
+  hal_test_001_003_setup,
+  hal_test_001_003_teardown,
+  hal_test_001_003_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const hal_test_sequence_001_array[] = {
+  &hal_test_001_001,
+  &hal_test_001_002,
+  &hal_test_001_003,
+  NULL
+};
+
+/**
+ * @brief   SPI transactions queue.
+ */
+const testsequence_t hal_test_sequence_001 = {
+  "SPI transactions queue",
+  hal_test_sequence_001_array
+};
+
+#endif /* (HAL_USE_SPI == TRUE) && (SPI_USE_QUEUE == TRUE) && (SPI_USE_WAIT == TRUE) && (SPI_SELECT_MODE == SPI_SELECT_MODE_LLD) && defined(SIMULATOR) */
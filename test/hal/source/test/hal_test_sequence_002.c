@@ -0,0 +1,589 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "hal_test_root.h"
+
+/**
+ * @file    hal_test_sequence_002.c
+ * @brief   Test Sequence 002 code.
+ *
+ * @page hal_test_sequence_002 [2] Serial NOR read cache
+ *
+ * File: @ref hal_test_sequence_002.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the serial NOR driver read cache using a
+ * simulated N25Q device, device accesses are counted by the device
+ * model.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (HAL_TEST_SNOR == TRUE) && (SNOR_USE_READ_CACHE == TRUE)
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage hal_test_002_001
+ * - @subpage hal_test_002_002
+ * - @subpage hal_test_002_003
+ * - @subpage hal_test_002_004
+ * - @subpage hal_test_002_005
+ * - @subpage hal_test_002_006
+ * - @subpage hal_test_002_007
+ * .
+ */
+
+#if ((HAL_TEST_SNOR == TRUE) && (SNOR_USE_READ_CACHE == TRUE)) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+static uint8_t snor_buf[512];
+
+static void snor_test_setup(void) {
+
+  n25q_model_reset();
+  snorObjectInit(&snor1);
+  snorStart(&snor1, &snorcfg1);
+}
+
+/* Size of the area read by the benchmark, it does not fit the cache.*/
+#define SNOR_BENCH_AREA                     0x1000U
+
+/*
+ * Counts the bytes read in a one second time window using sequential reads
+ * of 16 bytes, through the cache or directly from the device as the driver
+ * does when the cache is disabled.
+ */
+static uint32_t snor_bench_loop(bool cached) {
+  systime_t start, end;
+  flash_offset_t offset = 0U;
+  uint32_t n = 0U;
+
+  chThdSleep(1);
+  start = chVTGetSystemTime();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  do {
+    if (cached) {
+      (void) flashRead(&snor1, offset, 16U, snor_buf);
+    }
+    else {
+      bus_acquire(snorcfg1.busp, snorcfg1.buscfg);
+      (void) snor_device_read(&snor1, offset, 16U, snor_buf);
+      bus_release(snorcfg1.busp);
+    }
+    offset = (offset + 16U) & (SNOR_BENCH_AREA - 1U);
+    n += 16U;
+  } while (chVTIsSystemTimeWithinX(start, end));
+
+  return n;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page hal_test_002_001 [2.1] Cache misses and hits
+ *
+ * <h2>Description</h2>
+ * Small reads are performed, missing lines are fetched from the device
+ * and the following reads are served by the cache.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.1.1] Reading 16 bytes, the line is fetched from the device.
+ * - [2.1.2] Reading the remaining 48 bytes of the same line, the data
+ *   is served by the cache.
+ * - [2.1.3] Reading the next line, the access is sequential so the
+ *   following line is also fetched using a single device read.
+ * - [2.1.4] Reading the prefetched line, the data is served by the
+ *   cache.
+ * .
+ */
+
+static void hal_test_002_001_setup(void) {
+  snor_test_setup();
+}
+
+static void hal_test_002_001_teardown(void) {
+  snorStop(&snor1);
+}
+
+static void hal_test_002_001_execute(void) {
+  flash_error_t err;
+
+  /* [2.1.1] Reading 16 bytes, the line is fetched from the device.*/
+  test_set_step(1);
+  {
+    err = flashRead(&snor1, 0x100U, 16U, snor_buf);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model_check(0x100U, 16U, snor_buf), "wrong data");
+    test_assert((n25q_model.reads == 1U) &&
+                (n25q_model.read_bytes == SNOR_READ_CACHE_LINE_SIZE),
+                "unexpected device access");
+  }
+  test_end_step(1);
+
+  /* [2.1.2] Reading the remaining 48 bytes of the same line, the data
+     is served by the cache.*/
+  test_set_step(2);
+  {
+    err = flashRead(&snor1, 0x110U, 48U, snor_buf);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model_check(0x110U, 48U, snor_buf), "wrong data");
+    test_assert((n25q_model.reads == 1U) &&
+                (n25q_model.read_bytes == SNOR_READ_CACHE_LINE_SIZE),
+                "unexpected device access");
+  }
+  test_end_step(2);
+
+  /* [2.1.3] Reading the next line, the access is sequential so the
+     following line is also fetched using a single device read.*/
+  test_set_step(3);
+  {
+    err = flashRead(&snor1, 0x140U, 16U, snor_buf);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model_check(0x140U, 16U, snor_buf), "wrong data");
+    test_assert((n25q_model.reads == 2U) &&
+                (n25q_model.read_bytes == 3U * SNOR_READ_CACHE_LINE_SIZE),
+                "unexpected device access");
+  }
+  test_end_step(3);
+
+  /* [2.1.4] Reading the prefetched line, the data is served by the
+     cache.*/
+  test_set_step(4);
+  {
+    err = flashRead(&snor1, 0x180U, SNOR_READ_CACHE_LINE_SIZE, snor_buf);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model_check(0x180U, SNOR_READ_CACHE_LINE_SIZE, snor_buf), "wrong data");
+    test_assert((n25q_model.reads == 2U) &&
+                (n25q_model.read_bytes == 3U * SNOR_READ_CACHE_LINE_SIZE),
+                "unexpected device access");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t hal_test_002_001 = {
+  "Cache misses and hits",
+  hal_test_002_001_setup,
+  hal_test_002_001_teardown,
+  hal_test_002_001_execute
+};
+
+/**
+ * @page hal_test_002_002 [2.2] Reads larger than the cache
+ *
+ * <h2>Description</h2>
+ * A read larger than the cache is performed, the data is read directly
+ * from the device and not cached.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.2.1] Reading 512 bytes, the data is read from the device.
+ * - [2.2.2] Reading 16 bytes of the same area, the line is fetched from
+ *   the device.
+ * .
+ */
+
+static void hal_test_002_002_setup(void) {
+  snor_test_setup();
+}
+
+static void hal_test_002_002_teardown(void) {
+  snorStop(&snor1);
+}
+
+static void hal_test_002_002_execute(void) {
+  flash_error_t err;
+
+  /* [2.2.1] Reading 512 bytes, the data is read from the device.*/
+  test_set_step(1);
+  {
+    err = flashRead(&snor1, 0x1000U, 512U, snor_buf);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model_check(0x1000U, 512U, snor_buf), "wrong data");
+    test_assert((n25q_model.reads == 1U) &&
+                (n25q_model.read_bytes == 512U),
+                "unexpected device access");
+  }
+  test_end_step(1);
+
+  /* [2.2.2] Reading 16 bytes of the same area, the line is fetched from
+     the device.*/
+  test_set_step(2);
+  {
+    err = flashRead(&snor1, 0x1000U, 16U, snor_buf);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model_check(0x1000U, 16U, snor_buf), "wrong data");
+    test_assert((n25q_model.reads == 2U) &&
+                (n25q_model.read_bytes == 512U + SNOR_READ_CACHE_LINE_SIZE),
+                "unexpected device access");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t hal_test_002_002 = {
+  "Reads larger than the cache",
+  hal_test_002_002_setup,
+  hal_test_002_002_teardown,
+  hal_test_002_002_execute
+};
+
+/**
+ * @page hal_test_002_003 [2.3] Invalidation on program
+ *
+ * <h2>Description</h2>
+ * A cached line is programmed, the line is expected to be fetched again
+ * from the device.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.3.1] Reading a line, it is fetched from the device.
+ * - [2.3.2] Programming 4 bytes within the line.
+ * - [2.3.3] Reading the line again, it is fetched from the device and
+ *   the programmed bytes are expected to be zero.
+ * .
+ */
+
+static void hal_test_002_003_setup(void) {
+  snor_test_setup();
+}
+
+static void hal_test_002_003_teardown(void) {
+  snorStop(&snor1);
+}
+
+static void hal_test_002_003_execute(void) {
+  flash_error_t err;
+
+  /* [2.3.1] Reading a line, it is fetched from the device.*/
+  test_set_step(1);
+  {
+    err = flashRead(&snor1, 0x200U, SNOR_READ_CACHE_LINE_SIZE, snor_buf);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model_check(0x200U, SNOR_READ_CACHE_LINE_SIZE, snor_buf), "wrong data");
+    test_assert(n25q_model.reads == 1U, "unexpected device access");
+  }
+  test_end_step(1);
+
+  /* [2.3.2] Programming 4 bytes within the line.*/
+  test_set_step(2);
+  {
+    static const uint8_t zeros[4] = {0U, 0U, 0U, 0U};
+
+    err = flashProgram(&snor1, 0x208U, sizeof zeros, zeros);
+    test_assert(err == FLASH_NO_ERROR, "program failed");
+  }
+  test_end_step(2);
+
+  /* [2.3.3] Reading the line again, it is fetched from the device and
+     the programmed bytes are expected to be zero.*/
+  test_set_step(3);
+  {
+    err = flashRead(&snor1, 0x200U, SNOR_READ_CACHE_LINE_SIZE, snor_buf);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model.reads == 2U, "unexpected device access");
+    test_assert(n25q_model_check(0x200U, 8U, &snor_buf[0]) &&
+                (snor_buf[8] == 0U) && (snor_buf[9] == 0U) &&
+                (snor_buf[10] == 0U) && (snor_buf[11] == 0U) &&
+                n25q_model_check(0x20CU, SNOR_READ_CACHE_LINE_SIZE - 12U,
+                                 &snor_buf[12]),
+                "wrong data");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t hal_test_002_003 = {
+  "Invalidation on program",
+  hal_test_002_003_setup,
+  hal_test_002_003_teardown,
+  hal_test_002_003_execute
+};
+
+/**
+ * @page hal_test_002_004 [2.4] Invalidation on erase
+ *
+ * <h2>Description</h2>
+ * The sector containing a cached line is erased, the line is expected
+ * to be fetched again from the device.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.4.1] Reading a line of sector 1, it is fetched from the device.
+ * - [2.4.2] Erasing sector 1.
+ * - [2.4.3] Reading the line again, it is fetched from the device and
+ *   it is expected to be erased.
+ * .
+ */
+
+static void hal_test_002_004_setup(void) {
+  snor_test_setup();
+}
+
+static void hal_test_002_004_teardown(void) {
+  snorStop(&snor1);
+}
+
+static void hal_test_002_004_execute(void) {
+  flash_error_t err;
+  unsigned i;
+
+  /* [2.4.1] Reading a line of sector 1, it is fetched from the device.*/
+  test_set_step(1);
+  {
+    err = flashRead(&snor1, 0x10000U, SNOR_READ_CACHE_LINE_SIZE, snor_buf);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model_check(0x10000U, SNOR_READ_CACHE_LINE_SIZE, snor_buf), "wrong data");
+    test_assert(n25q_model.reads == 1U, "unexpected device access");
+  }
+  test_end_step(1);
+
+  /* [2.4.2] Erasing sector 1.*/
+  test_set_step(2);
+  {
+    err = flashStartEraseSector(&snor1, 1U);
+    test_assert(err == FLASH_NO_ERROR, "erase failed");
+    err = flashWaitErase((BaseFlash *)&snor1);
+    test_assert(err == FLASH_NO_ERROR, "erase failed");
+  }
+  test_end_step(2);
+
+  /* [2.4.3] Reading the line again, it is fetched from the device and
+     it is expected to be erased.*/
+  test_set_step(3);
+  {
+    err = flashRead(&snor1, 0x10000U, SNOR_READ_CACHE_LINE_SIZE, snor_buf);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model.reads == 2U, "unexpected device access");
+    for (i = 0U; i < SNOR_READ_CACHE_LINE_SIZE; i++) {
+      test_assert(snor_buf[i] == 0xFFU, "not erased");
+    }
+  }
+  test_end_step(3);
+}
+
+static const testcase_t hal_test_002_004 = {
+  "Invalidation on erase",
+  hal_test_002_004_setup,
+  hal_test_002_004_teardown,
+  hal_test_002_004_execute
+};
+
+/**
+ * @page hal_test_002_005 [2.5] Explicit invalidation
+ *
+ * <h2>Description</h2>
+ * The device content is changed without using the driver, cached data
+ * is stale until snorCacheInvalidate() is called.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.5.1] Reading 16 bytes, the line is fetched from the device.
+ * - [2.5.2] Changing the device content then reading again, the stale
+ *   data is served by the cache.
+ * - [2.5.3] Invalidating the cache then reading again, the line is
+ *   fetched from the device.
+ * .
+ */
+
+static void hal_test_002_005_setup(void) {
+  snor_test_setup();
+}
+
+static void hal_test_002_005_teardown(void) {
+  snorStop(&snor1);
+}
+
+static void hal_test_002_005_execute(void) {
+  flash_error_t err;
+
+  /* [2.5.1] Reading 16 bytes, the line is fetched from the device.*/
+  test_set_step(1);
+  {
+    err = flashRead(&snor1, 0x300U, 16U, snor_buf);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model_check(0x300U, 16U, snor_buf), "wrong data");
+    test_assert(n25q_model.reads == 1U, "unexpected device access");
+  }
+  test_end_step(1);
+
+  /* [2.5.2] Changing the device content then reading again, the stale
+     data is served by the cache.*/
+  test_set_step(2);
+  {
+    n25q_model.mem[0x300] = 0U;
+    err = flashRead(&snor1, 0x300U, 16U, snor_buf);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model_check(0x300U, 16U, snor_buf), "wrong data");
+    test_assert(n25q_model.reads == 1U, "unexpected device access");
+  }
+  test_end_step(2);
+
+  /* [2.5.3] Invalidating the cache then reading again, the line is
+     fetched from the device.*/
+  test_set_step(3);
+  {
+    snorCacheInvalidate(&snor1);
+    err = flashRead(&snor1, 0x300U, 16U, snor_buf);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model.reads == 2U, "unexpected device access");
+    test_assert((snor_buf[0] == 0U) &&
+                n25q_model_check(0x301U, 15U, &snor_buf[1]),
+                "wrong data");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t hal_test_002_005 = {
+  "Explicit invalidation",
+  hal_test_002_005_setup,
+  hal_test_002_005_teardown,
+  hal_test_002_005_execute
+};
+
+/**
+ * @page hal_test_002_006 [2.6] Small reads throughput, cache enabled
+ *
+ * <h2>Description</h2>
+ * Sequential reads of 16 bytes are performed through the driver, the
+ * data is served by the cache and the device is accessed once every two
+ * lines.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.6.1] The bytes read through the cache are counted in a one
+ *   second time window.
+ * - [2.6.2] Checking the data of the last read then the score is
+ *   printed.
+ * .
+ */
+
+static void hal_test_002_006_setup(void) {
+  snor_test_setup();
+}
+
+static void hal_test_002_006_teardown(void) {
+  snorStop(&snor1);
+}
+
+static void hal_test_002_006_execute(void) {
+  uint32_t n;
+
+  /* [2.6.1] The bytes read through the cache are counted in a one
+     second time window.*/
+  test_set_step(1);
+  {
+    n = snor_bench_loop(true);
+  }
+  test_end_step(1);
+
+  /* [2.6.2] Checking the data of the last read then the score is
+     printed.*/
+  test_set_step(2);
+  {
+    test_assert(n25q_model_check((flash_offset_t)((n - 16U) &
+                                                  (SNOR_BENCH_AREA - 1U)),
+                                 16U, snor_buf), "wrong data");
+    test_bench_score(n, "bytes/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t hal_test_002_006 = {
+  "Small reads throughput, cache enabled",
+  hal_test_002_006_setup,
+  hal_test_002_006_teardown,
+  hal_test_002_006_execute
+};
+
+/**
+ * @page hal_test_002_007 [2.7] Small reads throughput, cache disabled
+ *
+ * <h2>Description</h2>
+ * The same sequential reads are performed directly on the device, each
+ * read is a device access as when the cache is disabled.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.7.1] The bytes read directly from the device are counted in a
+ *   one second time window.
+ * - [2.7.2] Checking the data of the last read then the score is
+ *   printed.
+ * .
+ */
+
+static void hal_test_002_007_setup(void) {
+  snor_test_setup();
+}
+
+static void hal_test_002_007_teardown(void) {
+  snorStop(&snor1);
+}
+
+static void hal_test_002_007_execute(void) {
+  uint32_t n;
+
+  /* [2.7.1] The bytes read directly from the device are counted in a
+     one second time window.*/
+  test_set_step(1);
+  {
+    n = snor_bench_loop(false);
+  }
+  test_end_step(1);
+
+  /* [2.7.2] Checking the data of the last read then the score is
+     printed.*/
+  test_set_step(2);
+  {
+    test_assert(n25q_model_check((flash_offset_t)((n - 16U) &
+                                                  (SNOR_BENCH_AREA - 1U)),
+                                 16U, snor_buf), "wrong data");
+    test_bench_score(n, "bytes/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t hal_test_002_007 = {
+  "Small reads throughput, cache disabled",
+  hal_test_002_007_setup,
+  hal_test_002_007_teardown,
+  hal_test_002_007_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const hal_test_sequence_002_array[] = {
+  &hal_test_002_001,
+  &hal_test_002_002,
+  &hal_test_002_003,
+  &hal_test_002_004,
+  &hal_test_002_005,
+  &hal_test_002_006,
+  &hal_test_002_007,
+  NULL
+};
+
+/**
+ * @brief   Serial NOR read cache.
+ */
+const testsequence_t hal_test_sequence_002 = {
+  "Serial NOR read cache",
+  hal_test_sequence_002_array
+};
+
+#endif /* (HAL_TEST_SNOR == TRUE) && (SNOR_USE_READ_CACHE == TRUE) */
@@ -0,0 +1,558 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "hal_test_root.h"
+
+/**
+ * @file    hal_test_sequence_003.c
+ * @brief   Test Sequence 003 code.
+ *
+ * @page hal_test_sequence_003 [3] Serial NOR erase queue
+ *
+ * File: @ref hal_test_sequence_003.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the serial NOR driver deferred erase queue and
+ * the reads performed while an erase operation is suspended, using a
+ * simulated N25Q device.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (HAL_TEST_SNOR == TRUE) && (SNOR_USE_ERASE_QUEUE == TRUE) && (SNOR_USE_ERASE_SUSPEND == TRUE)
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage hal_test_003_001
+ * - @subpage hal_test_003_002
+ * - @subpage hal_test_003_003
+ * - @subpage hal_test_003_004
+ * - @subpage hal_test_003_005
+ * .
+ */
+
+#if ((HAL_TEST_SNOR == TRUE) && (SNOR_USE_ERASE_QUEUE == TRUE) && (SNOR_USE_ERASE_SUSPEND == TRUE)) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+static uint8_t snor_erase_buf[64];
+
+static void snor_erase_test_setup(void) {
+
+  n25q_model_reset();
+  snorObjectInit(&snor1);
+  snorStart(&snor1, &snorcfg1);
+}
+
+static flash_error_t snor_erase_test_service(void) {
+  flash_error_t err;
+  unsigned i;
+
+  for (i = 0U; i < 100U; i++) {
+    err = snorServiceEraseQueue(&snor1, NULL);
+    if (err != FLASH_BUSY_ERASING) {
+      break;
+    }
+  }
+
+  return err;
+}
+
+#if (PORT_SUPPORTS_RT == TRUE) || defined(__DOXYGEN__)
+/* Status reads required by a long erase, the driver waits 1mS after each
+   busy status.*/
+#define SNOR_LONG_ERASE_POLLS               50U
+
+/* Number of reads performed by the latency measurement.*/
+#define SNOR_LATENCY_READS                  8U
+
+/*
+ * Measures the average latency of reads of sector 0 issued while sector 1
+ * is being erased, the reads either suspend the erase or wait for its
+ * completion. Each read targets a different line so it is never served
+ * by the read cache.
+ */
+static flash_error_t snor_erase_latency(bool suspend, uint32_t *nsp) {
+  systime_t start;
+  rtcnt_t rtstart, rt;
+  uint64_t total = 0U, freq;
+  flash_error_t err;
+  unsigned i;
+
+  chThdSleep(1);
+  start = chVTGetSystemTimeX();
+  rtstart = chSysGetRealtimeCounterX();
+  for (i = 0U; i < SNOR_LATENCY_READS; i++) {
+    err = flashStartEraseSector(&snor1, 1U);
+    if (err != FLASH_NO_ERROR) {
+      return err;
+    }
+
+    rt = chSysGetRealtimeCounterX();
+    if (!suspend) {
+      err = flashWaitErase((BaseFlash *)&snor1);
+    }
+    if (err == FLASH_NO_ERROR) {
+      err = flashRead(&snor1, (flash_offset_t)(i * 0x100U), 16U,
+                      snor_erase_buf);
+    }
+    total += (uint64_t)(rtcnt_t)(chSysGetRealtimeCounterX() - rt);
+    if (err != FLASH_NO_ERROR) {
+      return err;
+    }
+
+    if (suspend) {
+      err = flashWaitErase((BaseFlash *)&snor1);
+      if (err != FLASH_NO_ERROR) {
+        return err;
+      }
+    }
+  }
+
+  /* Realtime counter frequency measured over the elapsed system time.*/
+  freq = ((uint64_t)(rtcnt_t)(chSysGetRealtimeCounterX() - rtstart) *
+          (uint64_t)CH_CFG_ST_FREQUENCY) /
+         (uint64_t)chTimeDiffX(start, chVTGetSystemTimeX());
+  *nsp = (uint32_t)((total * 1000000000ULL) /
+                    (freq * (uint64_t)SNOR_LATENCY_READS));
+
+  return FLASH_NO_ERROR;
+}
+#endif /* PORT_SUPPORTS_RT == TRUE */
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page hal_test_003_001 [3.1] Queued erase operations
+ *
+ * <h2>Description</h2>
+ * Two sectors are queued for erase, one of them twice, the queue is
+ * then serviced until empty and the sectors are verified.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.1.1] Queuing sectors 1, 2 and 1 again, the duplicate is not
+ *   queued.
+ * - [3.1.2] Servicing the queue until all erase operations are
+ *   complete.
+ * - [3.1.3] Verifying that sectors 1 and 2 are erased and sectors 0 and
+ *   3 are not.
+ * .
+ */
+
+static void hal_test_003_001_setup(void) {
+  snor_erase_test_setup();
+}
+
+static void hal_test_003_001_teardown(void) {
+  snorStop(&snor1);
+}
+
+static void hal_test_003_001_execute(void) {
+  flash_error_t err;
+
+  /* [3.1.1] Queuing sectors 1, 2 and 1 again, the duplicate is not
+     queued.*/
+  test_set_step(1);
+  {
+    err = snorQueueEraseSector(&snor1, 1U);
+    test_assert(err == FLASH_NO_ERROR, "queue failed");
+    err = snorQueueEraseSector(&snor1, 2U);
+    test_assert(err == FLASH_NO_ERROR, "queue failed");
+    err = snorQueueEraseSector(&snor1, 1U);
+    test_assert(err == FLASH_NO_ERROR, "queue failed");
+    test_assert(snor1.erase_count == 2U, "wrong queue size");
+  }
+  test_end_step(1);
+
+  /* [3.1.2] Servicing the queue until all erase operations are
+     complete.*/
+  test_set_step(2);
+  {
+    err = snor_erase_test_service();
+    test_assert(err == FLASH_NO_ERROR, "service failed");
+    test_assert(snor1.erase_count == 0U, "queue not empty");
+  }
+  test_end_step(2);
+
+  /* [3.1.3] Verifying that sectors 1 and 2 are erased and sectors 0 and
+     3 are not.*/
+  test_set_step(3);
+  {
+    err = flashVerifyErase(&snor1, 1U);
+    test_assert(err == FLASH_NO_ERROR, "sector 1 not erased");
+    err = flashVerifyErase(&snor1, 2U);
+    test_assert(err == FLASH_NO_ERROR, "sector 2 not erased");
+    err = flashVerifyErase(&snor1, 0U);
+    test_assert(err == FLASH_ERROR_VERIFY, "sector 0 erased");
+    err = flashVerifyErase(&snor1, 3U);
+    test_assert(err == FLASH_ERROR_VERIFY, "sector 3 erased");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t hal_test_003_001 = {
+  "Queued erase operations",
+  hal_test_003_001_setup,
+  hal_test_003_001_teardown,
+  hal_test_003_001_execute
+};
+
+/**
+ * @page hal_test_003_002 [3.2] Programming queued sectors
+ *
+ * <h2>Description</h2>
+ * A sector is queued for erase, programming it is expected to fail
+ * until its erase has been performed.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.2.1] Queuing sector 1.
+ * - [3.2.2] Programming the last bytes of sector 0 and the first bytes
+ *   of sector 1, FLASH_ERROR_PROGRAM is expected and the device content
+ *   is not changed.
+ * - [3.2.3] Programming sector 0, the operation is expected to succeed.
+ * - [3.2.4] Servicing the queue then programming sector 1, the
+ *   operation is expected to succeed.
+ * .
+ */
+
+static void hal_test_003_002_setup(void) {
+  snor_erase_test_setup();
+}
+
+static void hal_test_003_002_teardown(void) {
+  snorStop(&snor1);
+}
+
+static void hal_test_003_002_execute(void) {
+  static const uint8_t zeros[4] = {0U, 0U, 0U, 0U};
+  flash_error_t err;
+
+  /* [3.2.1] Queuing sector 1.*/
+  test_set_step(1);
+  {
+    err = snorQueueEraseSector(&snor1, 1U);
+    test_assert(err == FLASH_NO_ERROR, "queue failed");
+  }
+  test_end_step(1);
+
+  /* [3.2.2] Programming the last bytes of sector 0 and the first bytes
+     of sector 1, FLASH_ERROR_PROGRAM is expected and the device content
+     is not changed.*/
+  test_set_step(2);
+  {
+    err = flashProgram(&snor1, 0xFFFEU, sizeof zeros, zeros);
+    test_assert(err == FLASH_ERROR_PROGRAM, "program not rejected");
+    test_assert(n25q_model_check(0xFFFEU, 4U, &n25q_model.mem[0xFFFE]),
+                "content changed");
+  }
+  test_end_step(2);
+
+  /* [3.2.3] Programming sector 0, the operation is expected to succeed.*/
+  test_set_step(3);
+  {
+    err = flashProgram(&snor1, 0xFFF0U, sizeof zeros, zeros);
+    test_assert(err == FLASH_NO_ERROR, "program failed");
+    test_assert(n25q_model.mem[0xFFF0] == 0U, "not programmed");
+  }
+  test_end_step(3);
+
+  /* [3.2.4] Servicing the queue then programming sector 1, the
+     operation is expected to succeed.*/
+  test_set_step(4);
+  {
+    err = snor_erase_test_service();
+    test_assert(err == FLASH_NO_ERROR, "service failed");
+    err = flashProgram(&snor1, 0x10000U, sizeof zeros, zeros);
+    test_assert(err == FLASH_NO_ERROR, "program failed");
+    test_assert(n25q_model.mem[0x10000] == 0U, "not programmed");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t hal_test_003_002 = {
+  "Programming queued sectors",
+  hal_test_003_002_setup,
+  hal_test_003_002_teardown,
+  hal_test_003_002_execute
+};
+
+#if (SNOR_ERASE_QUEUE_SIZE < 4U) || defined(__DOXYGEN__)
+/**
+ * @page hal_test_003_003 [3.3] Queue full
+ *
+ * <h2>Description</h2>
+ * The queue is filled, queuing another sector is expected to fail while
+ * queuing an already queued sector is expected to succeed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - SNOR_ERASE_QUEUE_SIZE < 4U
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [3.3.1] Filling the queue.
+ * - [3.3.2] Queuing another sector, FLASH_BUSY_ERASING is expected.
+ * - [3.3.3] Queuing an already queued sector, the operation is expected
+ *   to succeed.
+ * - [3.3.4] Servicing the queue until all erase operations are
+ *   complete.
+ * .
+ */
+
+static void hal_test_003_003_setup(void) {
+  snor_erase_test_setup();
+}
+
+static void hal_test_003_003_teardown(void) {
+  snorStop(&snor1);
+}
+
+static void hal_test_003_003_execute(void) {
+  flash_error_t err;
+  flash_sector_t sector;
+
+  /* [3.3.1] Filling the queue.*/
+  test_set_step(1);
+  {
+    for (sector = 0U; sector < SNOR_ERASE_QUEUE_SIZE; sector++) {
+      err = snorQueueEraseSector(&snor1, sector);
+      test_assert(err == FLASH_NO_ERROR, "queue failed");
+    }
+  }
+  test_end_step(1);
+
+  /* [3.3.2] Queuing another sector, FLASH_BUSY_ERASING is expected.*/
+  test_set_step(2);
+  {
+    err = snorQueueEraseSector(&snor1, SNOR_ERASE_QUEUE_SIZE);
+    test_assert(err == FLASH_BUSY_ERASING, "queue not full");
+  }
+  test_end_step(2);
+
+  /* [3.3.3] Queuing an already queued sector, the operation is expected
+     to succeed.*/
+  test_set_step(3);
+  {
+    err = snorQueueEraseSector(&snor1, 0U);
+    test_assert(err == FLASH_NO_ERROR, "queue failed");
+  }
+  test_end_step(3);
+
+  /* [3.3.4] Servicing the queue until all erase operations are
+     complete.*/
+  test_set_step(4);
+  {
+    err = snor_erase_test_service();
+    test_assert(err == FLASH_NO_ERROR, "service failed");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t hal_test_003_003 = {
+  "Queue full",
+  hal_test_003_003_setup,
+  hal_test_003_003_teardown,
+  hal_test_003_003_execute
+};
+#endif /* SNOR_ERASE_QUEUE_SIZE < 4U */
+
+/**
+ * @page hal_test_003_004 [3.4] Reads while erasing
+ *
+ * <h2>Description</h2>
+ * The area preceding the sector being erased is read sequentially while
+ * the erase is suspended, the sector being erased is expected not to be
+ * prefetched.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.4.1] Starting the erase of sector 1.
+ * - [3.4.2] Reading sequentially the end of sector 0, the erase
+ *   operation is suspended during the reads.
+ * - [3.4.3] Reading sector 1 while erasing, FLASH_BUSY_ERASING is
+ *   expected.
+ * - [3.4.4] Waiting for the erase completion then reading the start of
+ *   sector 1, the data is expected to be erased.
+ * .
+ */
+
+static void hal_test_003_004_setup(void) {
+  snor_erase_test_setup();
+}
+
+static void hal_test_003_004_teardown(void) {
+  snorStop(&snor1);
+}
+
+static void hal_test_003_004_execute(void) {
+  flash_error_t err;
+  unsigned i;
+
+  /* [3.4.1] Starting the erase of sector 1.*/
+  test_set_step(1);
+  {
+    err = flashStartEraseSector(&snor1, 1U);
+    test_assert(err == FLASH_NO_ERROR, "erase failed");
+  }
+  test_end_step(1);
+
+  /* [3.4.2] Reading sequentially the end of sector 0, the erase
+     operation is suspended during the reads.*/
+  test_set_step(2);
+  {
+    err = flashRead(&snor1, 0xFF80U, 64U, snor_erase_buf);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model_check(0xFF80U, 64U, snor_erase_buf), "wrong data");
+    err = flashRead(&snor1, 0xFFC0U, 16U, snor_erase_buf);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model_check(0xFFC0U, 16U, snor_erase_buf), "wrong data");
+    test_assert(n25q_model.suspends == 2U, "not suspended");
+  }
+  test_end_step(2);
+
+  /* [3.4.3] Reading sector 1 while erasing, FLASH_BUSY_ERASING is
+     expected.*/
+  test_set_step(3);
+  {
+    err = flashRead(&snor1, 0x10000U, 16U, snor_erase_buf);
+    test_assert(err == FLASH_BUSY_ERASING, "read allowed");
+  }
+  test_end_step(3);
+
+  /* [3.4.4] Waiting for the erase completion then reading the start of
+     sector 1, the data is expected to be erased.*/
+  test_set_step(4);
+  {
+    err = flashWaitErase((BaseFlash *)&snor1);
+    test_assert(err == FLASH_NO_ERROR, "erase failed");
+    err = flashRead(&snor1, 0x10000U, 16U, snor_erase_buf);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    for (i = 0U; i < 16U; i++) {
+      test_assert(snor_erase_buf[i] == 0xFFU, "not erased");
+    }
+  }
+  test_end_step(4);
+}
+
+static const testcase_t hal_test_003_004 = {
+  "Reads while erasing",
+  hal_test_003_004_setup,
+  hal_test_003_004_teardown,
+  hal_test_003_004_execute
+};
+
+#if (PORT_SUPPORTS_RT == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page hal_test_003_005 [3.5] Read latency during a long erase
+ *
+ * <h2>Description</h2>
+ * Reads are issued while a long erase operation is in progress, the
+ * average read latency is measured when the read suspends the erase and
+ * when it waits for the erase completion as it would without erase
+ * suspend.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - PORT_SUPPORTS_RT == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [3.5.1] Reading during the erase, the erase is suspended by each
+ *   read and the score is printed.
+ * - [3.5.2] Waiting for the erase completion before each read, the
+ *   score is printed.
+ * .
+ */
+
+static void hal_test_003_005_setup(void) {
+  snor_erase_test_setup();
+  n25q_model.erase_length = SNOR_LONG_ERASE_POLLS;
+}
+
+static void hal_test_003_005_teardown(void) {
+  snorStop(&snor1);
+}
+
+static void hal_test_003_005_execute(void) {
+  flash_error_t err;
+  uint32_t ns;
+
+  /* [3.5.1] Reading during the erase, the erase is suspended by each
+     read and the score is printed.*/
+  test_set_step(1);
+  {
+    err = snor_erase_latency(true, &ns);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model.suspends == SNOR_LATENCY_READS, "not suspended");
+    test_bench_score(ns, "ns/read");
+  }
+  test_end_step(1);
+
+  /* [3.5.2] Waiting for the erase completion before each read, the
+     score is printed.*/
+  test_set_step(2);
+  {
+    err = snor_erase_latency(false, &ns);
+    test_assert(err == FLASH_NO_ERROR, "read failed");
+    test_assert(n25q_model.suspends == SNOR_LATENCY_READS, "unexpected suspend");
+    test_bench_score(ns, "ns/read");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t hal_test_003_005 = {
+  "Read latency during a long erase",
+  hal_test_003_005_setup,
+  hal_test_003_005_teardown,
+  hal_test_003_005_execute
+};
+#endif /* PORT_SUPPORTS_RT == TRUE */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const hal_test_sequence_003_array[] = {
+  &hal_test_003_001,
+  &hal_test_003_002,
+#if (SNOR_ERASE_QUEUE_SIZE < 4U) || defined(__DOXYGEN__)
+  &hal_test_003_003,
+#endif
+  &hal_test_003_004,
+#if (PORT_SUPPORTS_RT == TRUE) || defined(__DOXYGEN__)
+  &hal_test_003_005,
+#endif
+  NULL
+};
+
+/**
+ * @brief   Serial NOR erase queue.
+ */
+const testsequence_t hal_test_sequence_003 = {
+  "Serial NOR erase queue",
+  hal_test_sequence_003_array
+};
+
+#endif /* (HAL_TEST_SNOR == TRUE) && (SNOR_USE_ERASE_QUEUE == TRUE) && (SNOR_USE_ERASE_SUSPEND == TRUE) */
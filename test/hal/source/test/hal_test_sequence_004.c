@@ -0,0 +1,530 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "hal_test_root.h"
+
+/**
+ * @file    hal_test_sequence_004.c
+ * @brief   Test Sequence 004 code.
+ *
+ * @page hal_test_sequence_004 [4] I/O queues block transfers
+ *
+ * File: @ref hal_test_sequence_004.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the I/O queues and serial driver functions moving
+ * blocks of data from the low side of the queues.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage hal_test_004_001
+ * - @subpage hal_test_004_002
+ * - @subpage hal_test_004_003
+ * - @subpage hal_test_004_004
+ * - @subpage hal_test_004_005
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#define QUEUES_SIZE                         8U
+
+static const uint8_t queues_pattern[] = "0123456789ABCDEF";
+static uint8_t queues_buf[QUEUES_SIZE];
+static uint8_t queues_data[16];
+static input_queue_t iq;
+static output_queue_t oq;
+static unsigned queues_notifications;
+static virtual_timer_t queues_vt;
+#if (HAL_USE_SERIAL == TRUE) || defined(__DOXYGEN__)
+static event_listener_t queues_el;
+#endif
+
+static void queues_notify(io_queue_t *qp) {
+
+  (void)qp;
+  queues_notifications++;
+}
+
+static void queues_iq_write_cb(void *p) {
+
+  (void)p;
+  chSysLockFromISR();
+  (void) iqWriteI(&iq, queues_pattern, 4U);
+  chSysUnlockFromISR();
+}
+
+static void queues_oq_read_cb(void *p) {
+
+  (void)p;
+  chSysLockFromISR();
+  (void) oqReadI(&oq, queues_data, 4U);
+  chSysUnlockFromISR();
+}
+
+static void queues_setup(void) {
+
+  queues_notifications = 0U;
+  memset(queues_data, 0, sizeof queues_data);
+  iqObjectInit(&iq, queues_buf, QUEUES_SIZE, queues_notify, NULL);
+  oqObjectInit(&oq, queues_buf, QUEUES_SIZE, queues_notify, NULL);
+  chVTObjectInit(&queues_vt);
+}
+
+#if (HAL_USE_SERIAL == TRUE) || defined(__DOXYGEN__)
+static void queues_serial_setup(eventflags_t flags) {
+
+  chSysLock();
+  iqResetI(&SD1.iqueue);
+  oqResetI(&SD1.oqueue);
+  chSysUnlock();
+  chEvtRegisterMaskWithFlags(chnGetEventSource(&SD1), &queues_el,
+                             EVENT_MASK(0), flags);
+}
+
+static void queues_serial_teardown(void) {
+
+  chEvtUnregister(chnGetEventSource(&SD1), &queues_el);
+  chSysLock();
+  iqResetI(&SD1.iqueue);
+  oqResetI(&SD1.oqueue);
+  chSysUnlock();
+}
+#endif
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page hal_test_004_001 [4.1] Input queue block writes
+ *
+ * <h2>Description</h2>
+ * Blocks are written into an input queue using iqWriteI(), writes
+ * wrapping around the buffer end and writes exceeding the free space
+ * are tested. The notification callback is invoked by the reads.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.1.1] Writing 5 bytes into the empty queue.
+ * - [4.1.2] Reading 3 bytes, the notification callback is invoked once.
+ * - [4.1.3] Writing 10 bytes, the write wraps around the buffer end and
+ *   it is truncated to the 6 free bytes.
+ * - [4.1.4] Writing into the full queue, no data is transferred.
+ * - [4.1.5] Reading the whole queue content, the data is expected in
+ *   write order and the notification callback is invoked once.
+ * .
+ */
+
+static void hal_test_004_001_setup(void) {
+  queues_setup();
+}
+
+static void hal_test_004_001_execute(void) {
+  size_t n;
+
+  /* [4.1.1] Writing 5 bytes into the empty queue.*/
+  test_set_step(1);
+  {
+    chSysLock();
+    n = iqWriteI(&iq, queues_pattern, 5U);
+    chSysUnlock();
+    test_assert(n == 5U, "wrong size");
+    test_assert_lock(iqGetFullI(&iq) == 5U, "wrong counter");
+  }
+  test_end_step(1);
+
+  /* [4.1.2] Reading 3 bytes, the notification callback is invoked once.*/
+  test_set_step(2);
+  {
+    n = iqReadTimeout(&iq, queues_data, 3U, TIME_IMMEDIATE);
+    test_assert(n == 3U, "wrong size");
+    test_assert(memcmp(queues_data, "012", 3U) == 0, "wrong data");
+    test_assert(queues_notifications == 1U, "wrong notifications");
+  }
+  test_end_step(2);
+
+  /* [4.1.3] Writing 10 bytes, the write wraps around the buffer end and
+     it is truncated to the 6 free bytes.*/
+  test_set_step(3);
+  {
+    chSysLock();
+    n = iqWriteI(&iq, &queues_pattern[5], 10U);
+    chSysUnlock();
+    test_assert(n == 6U, "wrong size");
+    test_assert_lock(iqIsFullI(&iq), "not full");
+  }
+  test_end_step(3);
+
+  /* [4.1.4] Writing into the full queue, no data is transferred.*/
+  test_set_step(4);
+  {
+    chSysLock();
+    n = iqWriteI(&iq, queues_pattern, 1U);
+    chSysUnlock();
+    test_assert(n == 0U, "wrong size");
+  }
+  test_end_step(4);
+
+  /* [4.1.5] Reading the whole queue content, the data is expected in
+     write order and the notification callback is invoked once.*/
+  test_set_step(5);
+  {
+    n = iqReadTimeout(&iq, queues_data, 16U, TIME_IMMEDIATE);
+    test_assert(n == 8U, "wrong size");
+    test_assert(memcmp(queues_data, "3456789A", 8U) == 0, "wrong data");
+    test_assert(queues_notifications == 2U, "wrong notifications");
+    test_assert_lock(iqIsEmptyI(&iq), "not empty");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t hal_test_004_001 = {
+  "Input queue block writes",
+  hal_test_004_001_setup,
+  NULL,
+  hal_test_004_001_execute
+};
+
+/**
+ * @page hal_test_004_002 [4.2] Output queue block reads
+ *
+ * <h2>Description</h2>
+ * Blocks are read from an output queue using oqReadI(), reads wrapping
+ * around the buffer end and reads exceeding the queue content are
+ * tested. The notification callback is invoked by the writes.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.2.1] Writing 6 bytes, the notification callback is invoked once.
+ * - [4.2.2] Reading 4 bytes.
+ * - [4.2.3] Writing 6 bytes, the queue wraps around the buffer end and
+ *   it is full.
+ * - [4.2.4] Reading 16 bytes, the read wraps around the buffer end and
+ *   it is truncated to the 8 queued bytes.
+ * - [4.2.5] Reading from the empty queue, no data is transferred.
+ * .
+ */
+
+static void hal_test_004_002_setup(void) {
+  queues_setup();
+}
+
+static void hal_test_004_002_execute(void) {
+  size_t n;
+
+  /* [4.2.1] Writing 6 bytes, the notification callback is invoked once.*/
+  test_set_step(1);
+  {
+    n = oqWriteTimeout(&oq, queues_pattern, 6U, TIME_IMMEDIATE);
+    test_assert(n == 6U, "wrong size");
+    test_assert(queues_notifications == 1U, "wrong notifications");
+  }
+  test_end_step(1);
+
+  /* [4.2.2] Reading 4 bytes.*/
+  test_set_step(2);
+  {
+    chSysLock();
+    n = oqReadI(&oq, queues_data, 4U);
+    chSysUnlock();
+    test_assert(n == 4U, "wrong size");
+    test_assert(memcmp(queues_data, "0123", 4U) == 0, "wrong data");
+  }
+  test_end_step(2);
+
+  /* [4.2.3] Writing 6 bytes, the queue wraps around the buffer end and
+     it is full.*/
+  test_set_step(3);
+  {
+    n = oqWriteTimeout(&oq, &queues_pattern[6], 6U, TIME_IMMEDIATE);
+    test_assert(n == 6U, "wrong size");
+    test_assert_lock(oqIsFullI(&oq), "not full");
+  }
+  test_end_step(3);
+
+  /* [4.2.4] Reading 16 bytes, the read wraps around the buffer end and
+     it is truncated to the 8 queued bytes.*/
+  test_set_step(4);
+  {
+    chSysLock();
+    n = oqReadI(&oq, queues_data, 16U);
+    chSysUnlock();
+    test_assert(n == 8U, "wrong size");
+    test_assert(memcmp(queues_data, "456789AB", 8U) == 0, "wrong data");
+    test_assert_lock(oqIsEmptyI(&oq), "not empty");
+  }
+  test_end_step(4);
+
+  /* [4.2.5] Reading from the empty queue, no data is transferred.*/
+  test_set_step(5);
+  {
+    chSysLock();
+    n = oqReadI(&oq, queues_data, 1U);
+    chSysUnlock();
+    test_assert(n == 0U, "wrong size");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t hal_test_004_002 = {
+  "Output queue block reads",
+  hal_test_004_002_setup,
+  NULL,
+  hal_test_004_002_execute
+};
+
+/**
+ * @page hal_test_004_003 [4.3] Waiting threads wakeup
+ *
+ * <h2>Description</h2>
+ * Threads waiting on the queues are woken up by block transfers
+ * performed in ISR context.
+ *
+ * <h2>Test Steps</h2>
+ * - [4.3.1] Reading 4 bytes from the empty input queue, the data is
+ *   written by a timer callback using iqWriteI().
+ * - [4.3.2] Writing 12 bytes into the empty output queue, the writer
+ *   waits until a timer callback reads 4 bytes using oqReadI().
+ * .
+ */
+
+static void hal_test_004_003_setup(void) {
+  queues_setup();
+}
+
+static void hal_test_004_003_execute(void) {
+  size_t n;
+
+  /* [4.3.1] Reading 4 bytes from the empty input queue, the data is
+     written by a timer callback using iqWriteI().*/
+  test_set_step(1);
+  {
+    chVTSet(&queues_vt, TIME_MS2I(10), queues_iq_write_cb, NULL);
+    n = iqReadTimeout(&iq, queues_data, 4U, TIME_MS2I(500));
+    test_assert(n == 4U, "wrong size");
+    test_assert(memcmp(queues_data, "0123", 4U) == 0, "wrong data");
+  }
+  test_end_step(1);
+
+  /* [4.3.2] Writing 12 bytes into the empty output queue, the writer
+     waits until a timer callback reads 4 bytes using oqReadI().*/
+  test_set_step(2);
+  {
+    chVTSet(&queues_vt, TIME_MS2I(10), queues_oq_read_cb, NULL);
+    n = oqWriteTimeout(&oq, queues_pattern, 12U, TIME_MS2I(500));
+    test_assert(n == 12U, "wrong size");
+    test_assert(memcmp(queues_data, "0123", 4U) == 0, "wrong data");
+    test_assert_lock(oqIsFullI(&oq), "not full");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t hal_test_004_003 = {
+  "Waiting threads wakeup",
+  hal_test_004_003_setup,
+  NULL,
+  hal_test_004_003_execute
+};
+
+#if (HAL_USE_SERIAL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page hal_test_004_004 [4.4] Serial driver incoming blocks
+ *
+ * <h2>Description</h2>
+ * Blocks are received using sdIncomingDataBlockI(), the generated event
+ * flags are checked.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - HAL_USE_SERIAL == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [4.4.1] Receiving 4 bytes, CHN_INPUT_AVAILABLE is expected.
+ * - [4.4.2] Receiving more data than the free space,
+ *   SD_QUEUE_FULL_ERROR is expected.
+ * - [4.4.3] Reading the received data, the data in excess has been
+ *   discarded.
+ * .
+ */
+
+static void hal_test_004_004_setup(void) {
+  queues_serial_setup(CHN_INPUT_AVAILABLE | SD_QUEUE_FULL_ERROR);
+}
+
+static void hal_test_004_004_teardown(void) {
+  queues_serial_teardown();
+}
+
+static void hal_test_004_004_execute(void) {
+  size_t n;
+
+  /* [4.4.1] Receiving 4 bytes, CHN_INPUT_AVAILABLE is expected.*/
+  test_set_step(1);
+  {
+    chSysLock();
+    sdIncomingDataBlockI(&SD1, queues_pattern, 4U);
+    chSysUnlock();
+    test_assert(chEvtGetAndClearFlags(&queues_el) == CHN_INPUT_AVAILABLE,
+                "wrong flags");
+  }
+  test_end_step(1);
+
+  /* [4.4.2] Receiving more data than the free space,
+     SD_QUEUE_FULL_ERROR is expected.*/
+  test_set_step(2);
+  {
+    chSysLock();
+    sdIncomingDataBlockI(&SD1, queues_pattern, SERIAL_BUFFERS_SIZE);
+    chSysUnlock();
+    test_assert(chEvtGetAndClearFlags(&queues_el) == SD_QUEUE_FULL_ERROR,
+                "wrong flags");
+  }
+  test_end_step(2);
+
+  /* [4.4.3] Reading the received data, the data in excess has been
+     discarded.*/
+  test_set_step(3);
+  {
+    n = iqReadTimeout(&SD1.iqueue, queues_data, 4U, TIME_IMMEDIATE);
+    test_assert(n == 4U, "wrong size");
+    test_assert(memcmp(queues_data, "0123", 4U) == 0, "wrong data");
+    test_assert_lock(iqGetFullI(&SD1.iqueue) == SERIAL_BUFFERS_SIZE - 4U,
+                     "wrong counter");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t hal_test_004_004 = {
+  "Serial driver incoming blocks",
+  hal_test_004_004_setup,
+  hal_test_004_004_teardown,
+  hal_test_004_004_execute
+};
+#endif /* HAL_USE_SERIAL == TRUE */
+
+#if (HAL_USE_SERIAL == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page hal_test_004_005 [4.5] Serial driver outgoing blocks
+ *
+ * <h2>Description</h2>
+ * Blocks are transmitted using sdRequestDataBlockI(), the generated
+ * event flags are checked.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - HAL_USE_SERIAL == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [4.5.1] Writing 6 bytes then requesting 4 bytes.
+ * - [4.5.2] Requesting 16 bytes, the remaining 2 bytes are returned.
+ * - [4.5.3] Requesting from the empty queue, CHN_OUTPUT_EMPTY is
+ *   expected.
+ * .
+ */
+
+static void hal_test_004_005_setup(void) {
+  queues_serial_setup(CHN_OUTPUT_EMPTY);
+}
+
+static void hal_test_004_005_teardown(void) {
+  queues_serial_teardown();
+}
+
+static void hal_test_004_005_execute(void) {
+  size_t n;
+
+  /* [4.5.1] Writing 6 bytes then requesting 4 bytes.*/
+  test_set_step(1);
+  {
+    n = oqWriteTimeout(&SD1.oqueue, queues_pattern, 6U, TIME_IMMEDIATE);
+    test_assert(n == 6U, "wrong size");
+    chSysLock();
+    n = sdRequestDataBlockI(&SD1, queues_data, 4U);
+    chSysUnlock();
+    test_assert(n == 4U, "wrong size");
+    test_assert(memcmp(queues_data, "0123", 4U) == 0, "wrong data");
+    test_assert(chEvtGetAndClearFlags(&queues_el) == 0U, "wrong flags");
+  }
+  test_end_step(1);
+
+  /* [4.5.2] Requesting 16 bytes, the remaining 2 bytes are returned.*/
+  test_set_step(2);
+  {
+    chSysLock();
+    n = sdRequestDataBlockI(&SD1, queues_data, 16U);
+    chSysUnlock();
+    test_assert(n == 2U, "wrong size");
+    test_assert(memcmp(queues_data, "45", 2U) == 0, "wrong data");
+    test_assert(chEvtGetAndClearFlags(&queues_el) == 0U, "wrong flags");
+  }
+  test_end_step(2);
+
+  /* [4.5.3] Requesting from the empty queue, CHN_OUTPUT_EMPTY is
+     expected.*/
+  test_set_step(3);
+  {
+    chSysLock();
+    n = sdRequestDataBlockI(&SD1, queues_data, 16U);
+    chSysUnlock();
+    test_assert(n == 0U, "wrong size");
+    test_assert(chEvtGetAndClearFlags(&queues_el) == CHN_OUTPUT_EMPTY,
+                "wrong flags");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t hal_test_004_005 = {
+  "Serial driver outgoing blocks",
+  hal_test_004_005_setup,
+  hal_test_004_005_teardown,
+  hal_test_004_005_execute
+};
+#endif /* HAL_USE_SERIAL == TRUE */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const hal_test_sequence_004_array[] = {
+  &hal_test_004_001,
+  &hal_test_004_002,
+  &hal_test_004_003,
+#if (HAL_USE_SERIAL == TRUE) || defined(__DOXYGEN__)
+  &hal_test_004_004,
+#endif
+#if (HAL_USE_SERIAL == TRUE) || defined(__DOXYGEN__)
+  &hal_test_004_005,
+#endif
+  NULL
+};
+
+/**
+ * @brief   I/O queues block transfers.
+ */
+const testsequence_t hal_test_sequence_004 = {
+  "I/O queues block transfers",
+  hal_test_sequence_004_array
+};
@@ -0,0 +1,291 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "hal_test_root.h"
+
+/**
+ * @file    hal_test_sequence_005.c
+ * @brief   Test Sequence 005 code.
+ *
+ * @page hal_test_sequence_005 [5] I/O queues benchmark
+ *
+ * File: @ref hal_test_sequence_005.c
+ *
+ * <h2>Description</h2>
+ * This sequence measures the serial driver throughput through an
+ * emulated loopback UART with a hardware FIFO, the data is moved
+ * between the queues and the FIFO one byte at time or in blocks.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - HAL_USE_SERIAL == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage hal_test_005_001
+ * - @subpage hal_test_005_002
+ * .
+ */
+
+#if (HAL_USE_SERIAL == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+/* Size of the emulated UART hardware FIFO.*/
+#define QBENCH_FIFO_SIZE                    16U
+
+static THD_WORKING_AREA(qbench_wa_isr, 1024);
+static THD_WORKING_AREA(qbench_wa_writer, 1024);
+static thread_t *qbench_isr_tp;
+static thread_t *qbench_writer_tp;
+static bool qbench_block;
+static uint8_t qbench_buf[64];
+
+/*
+ * Emulated loopback UART interrupt, up to a FIFO worth of transmitted data
+ * is received back. The transfer is limited to the input queue free space,
+ * the data is never discarded.
+ */
+static void qbench_isr(void) {
+  uint8_t fifo[QBENCH_FIFO_SIZE];
+  size_t i, n;
+
+  chSysLock();
+  n = iqGetEmptyI(&SD1.iqueue);
+  if (n > QBENCH_FIFO_SIZE) {
+    n = QBENCH_FIFO_SIZE;
+  }
+  if (n > 0U) {
+    if (qbench_block) {
+      n = sdRequestDataBlockI(&SD1, fifo, n);
+      if (n > 0U) {
+        sdIncomingDataBlockI(&SD1, fifo, n);
+      }
+    }
+    else {
+      for (i = 0U; i < n; i++) {
+        msg_t b = sdRequestDataI(&SD1);
+        if (b < MSG_OK) {
+          break;
+        }
+        sdIncomingDataI(&SD1, (uint8_t)b);
+      }
+    }
+  }
+  chSchRescheduleS();
+  chSysUnlock();
+}
+
+/*
+ * Interrupts source, it runs when the writer and the reader are waiting.
+ */
+static THD_FUNCTION(qbench_isr_thread, p) {
+
+  (void)p;
+  while (!chThdShouldTerminateX()) {
+    qbench_isr();
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  }
+}
+
+static THD_FUNCTION(qbench_writer_thread, p) {
+
+  (void)p;
+  while (!chThdShouldTerminateX()) {
+    (void) chnWriteTimeout(&SD1, qbench_buf, sizeof qbench_buf,
+                           TIME_MS2I(10));
+  }
+}
+
+static void qbench_setup(bool block) {
+
+  qbench_block = block;
+  chSysLock();
+  iqResetI(&SD1.iqueue);
+  oqResetI(&SD1.oqueue);
+  chSysUnlock();
+  qbench_writer_tp = chThdCreateStatic(qbench_wa_writer,
+                                       sizeof qbench_wa_writer,
+                                       chThdGetPriorityX() - 1,
+                                       qbench_writer_thread, NULL);
+  qbench_isr_tp = chThdCreateStatic(qbench_wa_isr, sizeof qbench_wa_isr,
+                                    chThdGetPriorityX() - 2,
+                                    qbench_isr_thread, NULL);
+}
+
+static void qbench_teardown(void) {
+
+  chThdTerminate(qbench_writer_tp);
+  chThdTerminate(qbench_isr_tp);
+  chThdWait(qbench_writer_tp);
+  chThdWait(qbench_isr_tp);
+  chSysLock();
+  iqResetI(&SD1.iqueue);
+  oqResetI(&SD1.oqueue);
+  chSysUnlock();
+}
+
+/*
+ * Counts the bytes received in a one second time window.
+ */
+static uint32_t qbench_loop(void) {
+  systime_t start, end;
+  uint8_t buf[sizeof qbench_buf];
+  uint32_t n = 0U;
+
+  chThdSleep(1);
+  start = chVTGetSystemTime();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  do {
+    n += (uint32_t)chnReadTimeout(&SD1, buf, sizeof buf, TIME_MS2I(10));
+  } while (chVTIsSystemTimeWithinX(start, end));
+
+  return n;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page hal_test_005_001 [5.1] Loopback throughput, byte transfers
+ *
+ * <h2>Description</h2>
+ * A writer thread sends data through the loopback, the emulated
+ * interrupt moves it using sdRequestDataI() and sdIncomingDataI().
+ *
+ * <h2>Test Steps</h2>
+ * - [5.1.1] The bytes received through the loopback, moved using
+ *   sdRequestDataI() and sdIncomingDataI(), are counted in a one second
+ *   time window.
+ * - [5.1.2] Score is printed.
+ * .
+ */
+
+static void hal_test_005_001_setup(void) {
+  qbench_setup(false);
+}
+
+static void hal_test_005_001_teardown(void) {
+  qbench_teardown();
+}
+
+static void hal_test_005_001_execute(void) {
+  uint32_t n;
+
+  /* [5.1.1] The bytes received through the loopback, moved using
+     sdRequestDataI() and sdIncomingDataI(), are counted in a one second
+     time window.*/
+  test_set_step(1);
+  {
+    n = qbench_loop();
+  }
+  test_end_step(1);
+
+  /* [5.1.2] Score is printed.*/
+  test_set_step(2);
+  {
+    test_bench_score(n, "bytes/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t hal_test_005_001 = {
+  "Loopback throughput, byte transfers",
+  hal_test_005_001_setup,
+  hal_test_005_001_teardown,
+  hal_test_005_001_execute
+};
+
+/**
+ * @page hal_test_005_002 [5.2] Loopback throughput, block transfers
+ *
+ * <h2>Description</h2>
+ * A writer thread sends data through the loopback, the emulated
+ * interrupt moves it using sdRequestDataBlockI() and
+ * sdIncomingDataBlockI().
+ *
+ * <h2>Test Steps</h2>
+ * - [5.2.1] The bytes received through the loopback, moved using
+ *   sdRequestDataBlockI() and sdIncomingDataBlockI(), are counted in a
+ *   one second time window.
+ * - [5.2.2] Score is printed.
+ * .
+ */
+
+static void hal_test_005_002_setup(void) {
+  qbench_setup(true);
+}
+
+static void hal_test_005_002_teardown(void) {
+  qbench_teardown();
+}
+
+static void hal_test_005_002_execute(void) {
+  uint32_t n;
+
+  /* [5.2.1] The bytes received through the loopback, moved using
+     sdRequestDataBlockI() and sdIncomingDataBlockI(), are counted in a
+     one second time window.*/
+  test_set_step(1);
+  {
+    n = qbench_loop();
+  }
+  test_end_step(1);
+
+  /* [5.2.2] Score is printed.*/
+  test_set_step(2);
+  {
+    test_bench_score(n, "bytes/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t hal_test_005_002 = {
+  "Loopback throughput, block transfers",
+  hal_test_005_002_setup,
+  hal_test_005_002_teardown,
+  hal_test_005_002_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const hal_test_sequence_005_array[] = {
+  &hal_test_005_001,
+  &hal_test_005_002,
+  NULL
+};
+
+/**
+ * @brief   I/O queues benchmark.
+ */
+const testsequence_t hal_test_sequence_005 = {
+  "I/O queues benchmark",
+  hal_test_sequence_005_array
+};
+
+#endif /* HAL_USE_SERIAL == TRUE */
@@ -0,0 +1,575 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "hal_test_root.h"
+
+/**
+ * @file    hal_test_sequence_006.c
+ * @brief   Test Sequence 006 code.
+ *
+ * @page hal_test_sequence_006 [6] Buffers queues zero-copy access
+ *
+ * File: @ref hal_test_sequence_006.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the buffers queues functions accessing the data
+ * in place and the vectored writes.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage hal_test_006_001
+ * - @subpage hal_test_006_002
+ * - @subpage hal_test_006_003
+ * - @subpage hal_test_006_004
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#define BQUEUES_SIZE                        8U
+#define BQUEUES_NUMBER                      3U
+
+static const uint8_t bqueues_pattern[] = "0123456789ABCDEFGHIJKLMNOPQRSTUV";
+static uint8_t bqueues_ib[BQ_BUFFER_SIZE(BQUEUES_NUMBER, BQUEUES_SIZE)];
+static uint8_t bqueues_ob[BQ_BUFFER_SIZE(BQUEUES_NUMBER, BQUEUES_SIZE)];
+static uint8_t bqueues_data[BQUEUES_SIZE];
+static input_buffers_queue_t ibq;
+static output_buffers_queue_t obq;
+static unsigned bqueues_notifications;
+static virtual_timer_t bqueues_vt;
+
+static void bqueues_notify(io_buffers_queue_t *bqp) {
+
+  (void)bqp;
+  bqueues_notifications++;
+}
+
+/*
+ * Low side of the input queue, a buffer is filled with the specified data.
+ */
+static void bqueues_fill_i(const uint8_t *bp, size_t n) {
+  uint8_t *buf;
+
+  buf = ibqGetEmptyBufferI(&ibq);
+  if (buf != NULL) {
+    memcpy(buf, bp, n);
+    ibqPostFullBufferI(&ibq, n);
+  }
+}
+
+static void bqueues_fill(const uint8_t *bp, size_t n) {
+
+  chSysLock();
+  bqueues_fill_i(bp, n);
+  chSysUnlock();
+}
+
+/*
+ * Low side of the output queue, a buffer is copied in bqueues_data and
+ * released, zero is returned if there are no full buffers.
+ */
+static size_t bqueues_drain_i(void) {
+  uint8_t *buf;
+  size_t n;
+
+  buf = obqGetFullBufferI(&obq, &n);
+  if (buf == NULL) {
+    return 0U;
+  }
+  memcpy(bqueues_data, buf, n);
+  obqReleaseEmptyBufferI(&obq);
+
+  return n;
+}
+
+static size_t bqueues_drain(void) {
+  size_t n;
+
+  chSysLock();
+  n = bqueues_drain_i();
+  chSysUnlock();
+
+  return n;
+}
+
+static void bqueues_fill_cb(void *p) {
+
+  (void)p;
+  chSysLockFromISR();
+  bqueues_fill_i(bqueues_pattern, 6U);
+  chSysUnlockFromISR();
+}
+
+static void bqueues_drain_cb(void *p) {
+
+  (void)p;
+  chSysLockFromISR();
+  (void) bqueues_drain_i();
+  chSysUnlockFromISR();
+}
+
+static void bqueues_setup(void) {
+
+  bqueues_notifications = 0U;
+  memset(bqueues_data, 0, sizeof bqueues_data);
+  ibqObjectInit(&ibq, false, bqueues_ib, BQUEUES_SIZE, BQUEUES_NUMBER,
+                bqueues_notify, NULL);
+  obqObjectInit(&obq, false, bqueues_ob, BQUEUES_SIZE, BQUEUES_NUMBER,
+                bqueues_notify, NULL);
+  chVTObjectInit(&bqueues_vt);
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page hal_test_006_001 [6.1] Input queue views
+ *
+ * <h2>Description</h2>
+ * The received data is accessed using ibqGetViewTimeout() and released
+ * using ibqConsume(), partial releases and views on consecutive buffers
+ * are tested. The notification callback is invoked once for each
+ * released buffer.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.1.1] Getting a view of the empty queue, a timeout is expected
+ *   both with TIME_IMMEDIATE and with a short timeout.
+ * - [6.1.2] Posting a full buffer and a 5 bytes buffer, the view covers
+ *   the first buffer only.
+ * - [6.1.3] Consuming 0 and then 3 bytes, the view is restricted to the
+ *   remaining data and no notification is generated.
+ * - [6.1.4] Consuming the remaining data, the buffer is released and
+ *   the view moves on the next buffer.
+ * - [6.1.5] Consuming 2 bytes then reading the rest using
+ *   ibqReadTimeout(), the read continues from the view position.
+ * .
+ */
+
+static void hal_test_006_001_setup(void) {
+  bqueues_setup();
+}
+
+static void hal_test_006_001_execute(void) {
+  uint8_t *bp;
+  size_t n;
+
+  /* [6.1.1] Getting a view of the empty queue, a timeout is expected
+     both with TIME_IMMEDIATE and with a short timeout.*/
+  test_set_step(1);
+  {
+    n = ibqGetViewTimeout(&ibq, &bp, TIME_IMMEDIATE);
+    test_assert(n == 0U, "wrong size");
+    n = ibqGetViewTimeout(&ibq, &bp, TIME_MS2I(10));
+    test_assert(n == 0U, "wrong size");
+  }
+  test_end_step(1);
+
+  /* [6.1.2] Posting a full buffer and a 5 bytes buffer, the view covers
+     the first buffer only.*/
+  test_set_step(2);
+  {
+    bqueues_fill(bqueues_pattern, BQUEUES_SIZE);
+    bqueues_fill(&bqueues_pattern[BQUEUES_SIZE], 5U);
+    n = ibqGetViewTimeout(&ibq, &bp, TIME_IMMEDIATE);
+    test_assert(n == BQUEUES_SIZE, "wrong size");
+    test_assert(memcmp(bp, "01234567", n) == 0, "wrong data");
+  }
+  test_end_step(2);
+
+  /* [6.1.3] Consuming 0 and then 3 bytes, the view is restricted to the
+     remaining data and no notification is generated.*/
+  test_set_step(3);
+  {
+    ibqConsume(&ibq, 0U);
+    ibqConsume(&ibq, 3U);
+    n = ibqGetViewTimeout(&ibq, &bp, TIME_IMMEDIATE);
+    test_assert(n == 5U, "wrong size");
+    test_assert(memcmp(bp, "34567", n) == 0, "wrong data");
+    test_assert(bqueues_notifications == 0U, "wrong notifications");
+  }
+  test_end_step(3);
+
+  /* [6.1.4] Consuming the remaining data, the buffer is released and
+     the view moves on the next buffer.*/
+  test_set_step(4);
+  {
+    ibqConsume(&ibq, 5U);
+    test_assert(bqueues_notifications == 1U, "wrong notifications");
+    n = ibqGetViewTimeout(&ibq, &bp, TIME_IMMEDIATE);
+    test_assert(n == 5U, "wrong size");
+    test_assert(memcmp(bp, "89ABC", n) == 0, "wrong data");
+  }
+  test_end_step(4);
+
+  /* [6.1.5] Consuming 2 bytes then reading the rest using
+     ibqReadTimeout(), the read continues from the view position.*/
+  test_set_step(5);
+  {
+    ibqConsume(&ibq, 2U);
+    n = ibqReadTimeout(&ibq, bqueues_data, sizeof bqueues_data, TIME_IMMEDIATE);
+    test_assert(n == 3U, "wrong size");
+    test_assert(memcmp(bqueues_data, "ABC", n) == 0, "wrong data");
+    test_assert(bqueues_notifications == 2U, "wrong notifications");
+    test_assert_lock(ibqIsEmptyI(&ibq), "not empty");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t hal_test_006_001 = {
+  "Input queue views",
+  hal_test_006_001_setup,
+  NULL,
+  hal_test_006_001_execute
+};
+
+/**
+ * @page hal_test_006_002 [6.2] Output queue views
+ *
+ * <h2>Description</h2>
+ * Data is written in place using obqGetViewTimeout() and obqCommit(),
+ * partial commits, flushes and the full queue condition are tested. The
+ * notification callback is invoked once for each posted buffer.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.2.1] Getting a view of the empty queue, the whole buffer is
+ *   available.
+ * - [6.2.2] Writing and committing 3 bytes then committing 0 bytes, the
+ *   buffer is not posted and the view is restricted to the remaining
+ *   space.
+ * - [6.2.3] Committing the remaining space, the buffer is posted with a
+ *   notification.
+ * - [6.2.4] Committing 2 bytes then writing 4 bytes using
+ *   obqWriteTimeout() and flushing, the buffer contains both the
+ *   writes.
+ * - [6.2.5] Committing all the buffers, the queue is full and a timeout
+ *   is expected both with TIME_IMMEDIATE and with a short timeout.
+ * .
+ */
+
+static void hal_test_006_002_setup(void) {
+  bqueues_setup();
+}
+
+static void hal_test_006_002_execute(void) {
+  uint8_t *bp;
+  size_t n;
+  unsigned i;
+
+  /* [6.2.1] Getting a view of the empty queue, the whole buffer is
+     available.*/
+  test_set_step(1);
+  {
+    n = obqGetViewTimeout(&obq, &bp, TIME_IMMEDIATE);
+    test_assert(n == BQUEUES_SIZE, "wrong size");
+  }
+  test_end_step(1);
+
+  /* [6.2.2] Writing and committing 3 bytes then committing 0 bytes, the
+     buffer is not posted and the view is restricted to the remaining
+     space.*/
+  test_set_step(2);
+  {
+    memcpy(bp, bqueues_pattern, 3U);
+    obqCommit(&obq, 3U);
+    obqCommit(&obq, 0U);
+    test_assert(bqueues_notifications == 0U, "wrong notifications");
+    test_assert(bqueues_drain() == 0U, "buffer posted");
+    n = obqGetViewTimeout(&obq, &bp, TIME_IMMEDIATE);
+    test_assert(n == 5U, "wrong size");
+  }
+  test_end_step(2);
+
+  /* [6.2.3] Committing the remaining space, the buffer is posted with a
+     notification.*/
+  test_set_step(3);
+  {
+    memcpy(bp, &bqueues_pattern[3], 5U);
+    obqCommit(&obq, 5U);
+    test_assert(bqueues_notifications == 1U, "wrong notifications");
+    n = bqueues_drain();
+    test_assert(n == BQUEUES_SIZE, "wrong size");
+    test_assert(memcmp(bqueues_data, "01234567", n) == 0, "wrong data");
+  }
+  test_end_step(3);
+
+  /* [6.2.4] Committing 2 bytes then writing 4 bytes using
+     obqWriteTimeout() and flushing, the buffer contains both the
+     writes.*/
+  test_set_step(4);
+  {
+    n = obqGetViewTimeout(&obq, &bp, TIME_IMMEDIATE);
+    test_assert(n == BQUEUES_SIZE, "wrong size");
+    memcpy(bp, "ab", 2U);
+    obqCommit(&obq, 2U);
+    n = obqWriteTimeout(&obq, bqueues_pattern, 4U, TIME_IMMEDIATE);
+    test_assert(n == 4U, "wrong size");
+    obqFlush(&obq);
+    test_assert(bqueues_notifications == 2U, "wrong notifications");
+    n = bqueues_drain();
+    test_assert(n == 6U, "wrong size");
+    test_assert(memcmp(bqueues_data, "ab0123", n) == 0, "wrong data");
+  }
+  test_end_step(4);
+
+  /* [6.2.5] Committing all the buffers, the queue is full and a timeout
+     is expected both with TIME_IMMEDIATE and with a short timeout.*/
+  test_set_step(5);
+  {
+    for (i = 0U; i < BQUEUES_NUMBER; i++) {
+      n = obqGetViewTimeout(&obq, &bp, TIME_IMMEDIATE);
+      test_assert(n == BQUEUES_SIZE, "wrong size");
+      obqCommit(&obq, n);
+    }
+    test_assert_lock(obqIsFullI(&obq), "not full");
+    n = obqGetViewTimeout(&obq, &bp, TIME_IMMEDIATE);
+    test_assert(n == 0U, "wrong size");
+    n = obqGetViewTimeout(&obq, &bp, TIME_MS2I(10));
+    test_assert(n == 0U, "wrong size");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t hal_test_006_002 = {
+  "Output queue views",
+  hal_test_006_002_setup,
+  NULL,
+  hal_test_006_002_execute
+};
+
+/**
+ * @page hal_test_006_003 [6.3] Vectored writes
+ *
+ * <h2>Description</h2>
+ * Data is written using obqWriteVTimeout(), zero sized elements,
+ * elements crossing the buffers boundaries and the full queue condition
+ * are tested. A single notification is expected for all the buffers
+ * posted by a write unless the writer has to wait for a free buffer.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.3.1] Writing only zero sized elements, no buffer is acquired or
+ *   posted.
+ * - [6.3.2] Writing 16 bytes in elements crossing the buffers boundary,
+ *   mixed with zero sized elements. Two buffers are posted with a
+ *   single notification.
+ * - [6.3.3] Writing 5 bytes, the buffer is not filled and it is not
+ *   posted until a flush.
+ * - [6.3.4] Writing 32 bytes using TIME_IMMEDIATE, the write is
+ *   truncated to the queue space. The posted buffers are notified
+ *   before giving up.
+ * - [6.3.5] Writing 32 bytes, the writer waits until a timer callback
+ *   releases a buffer. The buffers posted before waiting and the last
+ *   one are notified separately.
+ * .
+ */
+
+static void hal_test_006_003_setup(void) {
+  bqueues_setup();
+}
+
+static void hal_test_006_003_execute(void) {
+  size_t n;
+
+  /* [6.3.1] Writing only zero sized elements, no buffer is acquired or
+     posted.*/
+  test_set_step(1);
+  {
+    static const bqiovec_t iov[] = {
+      {bqueues_pattern, 0U},
+      {NULL, 0U}
+    };
+
+    n = obqWriteVTimeout(&obq, iov, 2U, TIME_IMMEDIATE);
+    test_assert(n == 0U, "wrong size");
+    obqFlush(&obq);
+    test_assert(bqueues_notifications == 0U, "wrong notifications");
+    test_assert(bqueues_drain() == 0U, "buffer posted");
+  }
+  test_end_step(1);
+
+  /* [6.3.2] Writing 16 bytes in elements crossing the buffers boundary,
+     mixed with zero sized elements. Two buffers are posted with a
+     single notification.*/
+  test_set_step(2);
+  {
+    static const bqiovec_t iov[] = {
+      {bqueues_pattern, 3U},
+      {NULL, 0U},
+      {&bqueues_pattern[3], 12U},
+      {bqueues_pattern, 0U},
+      {&bqueues_pattern[15], 1U}
+    };
+
+    n = obqWriteVTimeout(&obq, iov, 5U, TIME_IMMEDIATE);
+    test_assert(n == 16U, "wrong size");
+    test_assert(bqueues_notifications == 1U, "wrong notifications");
+    n = bqueues_drain();
+    test_assert(n == BQUEUES_SIZE, "wrong size");
+    test_assert(memcmp(bqueues_data, "01234567", n) == 0, "wrong data");
+    n = bqueues_drain();
+    test_assert(n == BQUEUES_SIZE, "wrong size");
+    test_assert(memcmp(bqueues_data, "89ABCDEF", n) == 0, "wrong data");
+  }
+  test_end_step(2);
+
+  /* [6.3.3] Writing 5 bytes, the buffer is not filled and it is not
+     posted until a flush.*/
+  test_set_step(3);
+  {
+    static const bqiovec_t iov[] = {
+      {bqueues_pattern, 2U},
+      {&bqueues_pattern[2], 3U}
+    };
+
+    n = obqWriteVTimeout(&obq, iov, 2U, TIME_IMMEDIATE);
+    test_assert(n == 5U, "wrong size");
+    test_assert(bqueues_notifications == 1U, "wrong notifications");
+    obqFlush(&obq);
+    test_assert(bqueues_notifications == 2U, "wrong notifications");
+    n = bqueues_drain();
+    test_assert(n == 5U, "wrong size");
+    test_assert(memcmp(bqueues_data, "01234", n) == 0, "wrong data");
+  }
+  test_end_step(3);
+
+  /* [6.3.4] Writing 32 bytes using TIME_IMMEDIATE, the write is
+     truncated to the queue space. The posted buffers are notified
+     before giving up.*/
+  test_set_step(4);
+  {
+    static const bqiovec_t iov[] = {
+      {bqueues_pattern, 32U}
+    };
+
+    bqueues_notifications = 0U;
+    n = obqWriteVTimeout(&obq, iov, 1U, TIME_IMMEDIATE);
+    test_assert(n == BQUEUES_NUMBER * BQUEUES_SIZE, "wrong size");
+    test_assert(bqueues_notifications == 1U, "wrong notifications");
+    while (bqueues_drain() > 0U) {
+    }
+  }
+  test_end_step(4);
+
+  /* [6.3.5] Writing 32 bytes, the writer waits until a timer callback
+     releases a buffer. The buffers posted before waiting and the last
+     one are notified separately.*/
+  test_set_step(5);
+  {
+    static const bqiovec_t iov[] = {
+      {bqueues_pattern, 32U}
+    };
+
+    bqueues_notifications = 0U;
+    chVTSet(&bqueues_vt, TIME_MS2I(10), bqueues_drain_cb, NULL);
+    n = obqWriteVTimeout(&obq, iov, 1U, TIME_MS2I(500));
+    test_assert(n == 32U, "wrong size");
+    test_assert(bqueues_notifications == 2U, "wrong notifications");
+    test_assert_lock(obqIsFullI(&obq), "not full");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t hal_test_006_003 = {
+  "Vectored writes",
+  hal_test_006_003_setup,
+  NULL,
+  hal_test_006_003_execute
+};
+
+/**
+ * @page hal_test_006_004 [6.4] Waiting threads wakeup
+ *
+ * <h2>Description</h2>
+ * Threads waiting for a view are woken up by buffers posted or released
+ * in ISR context.
+ *
+ * <h2>Test Steps</h2>
+ * - [6.4.1] Getting a view of the empty input queue, the buffer is
+ *   posted by a timer callback.
+ * - [6.4.2] Getting a view of the full output queue, a buffer is
+ *   released by a timer callback.
+ * .
+ */
+
+static void hal_test_006_004_setup(void) {
+  bqueues_setup();
+}
+
+static void hal_test_006_004_execute(void) {
+  uint8_t *bp;
+  size_t n;
+  unsigned i;
+
+  /* [6.4.1] Getting a view of the empty input queue, the buffer is
+     posted by a timer callback.*/
+  test_set_step(1);
+  {
+    chVTSet(&bqueues_vt, TIME_MS2I(10), bqueues_fill_cb, NULL);
+    n = ibqGetViewTimeout(&ibq, &bp, TIME_MS2I(500));
+    test_assert(n == 6U, "wrong size");
+    test_assert(memcmp(bp, "012345", n) == 0, "wrong data");
+    ibqConsume(&ibq, n);
+  }
+  test_end_step(1);
+
+  /* [6.4.2] Getting a view of the full output queue, a buffer is
+     released by a timer callback.*/
+  test_set_step(2);
+  {
+    for (i = 0U; i < BQUEUES_NUMBER; i++) {
+      n = obqGetViewTimeout(&obq, &bp, TIME_IMMEDIATE);
+      obqCommit(&obq, n);
+    }
+    chVTSet(&bqueues_vt, TIME_MS2I(10), bqueues_drain_cb, NULL);
+    n = obqGetViewTimeout(&obq, &bp, TIME_MS2I(500));
+    test_assert(n == BQUEUES_SIZE, "wrong size");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t hal_test_006_004 = {
+  "Waiting threads wakeup",
+  hal_test_006_004_setup,
+  NULL,
+  hal_test_006_004_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const hal_test_sequence_006_array[] = {
+  &hal_test_006_001,
+  &hal_test_006_002,
+  &hal_test_006_003,
+  &hal_test_006_004,
+  NULL
+};
+
+/**
+ * @brief   Buffers queues zero-copy access.
+ */
+const testsequence_t hal_test_sequence_006 = {
+  "Buffers queues zero-copy access",
+  hal_test_sequence_006_array
+};
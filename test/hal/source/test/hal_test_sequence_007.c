@@ -0,0 +1,441 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "hal_test_root.h"
+
+/**
+ * @file    hal_test_sequence_007.c
+ * @brief   Test Sequence 007 code.
+ *
+ * @page hal_test_sequence_007 [7] Serial over USB benchmark
+ *
+ * File: @ref hal_test_sequence_007.c
+ *
+ * <h2>Description</h2>
+ * This sequence measures the serial over USB driver throughput through
+ * the simulated USB host, the data sent on the IN side of the data
+ * endpoint is looped back on its OUT side. The endpoint transfers are
+ * instantaneous so the scores measure the CPU cost of the driver and of
+ * the buffers queues.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - (HAL_USE_SERIAL_USB == TRUE) && defined(SIMULATOR)
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage hal_test_007_001
+ * - @subpage hal_test_007_002
+ * - @subpage hal_test_007_003
+ * .
+ */
+
+#if ((HAL_USE_SERIAL_USB == TRUE) && defined(SIMULATOR)) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+#define BQBENCH_MODE_COPY                   0U
+#define BQBENCH_MODE_VIEWS                  1U
+#define BQBENCH_MODE_VECTORED               2U
+
+#define BQBENCH_DATA_EP                     1U
+#define BQBENCH_INTERRUPT_EP                2U
+
+static THD_WORKING_AREA(bqbench_wa_isr, 1024);
+static THD_WORKING_AREA(bqbench_wa_writer, 1024);
+static thread_t *bqbench_isr_tp;
+static thread_t *bqbench_writer_tp;
+static unsigned bqbench_mode;
+static uint8_t bqbench_buf[64];
+static SerialUSBDriver bqbench_sdu;
+
+static USBInEndpointState bqbench_ep1instate;
+static USBOutEndpointState bqbench_ep1outstate;
+static USBInEndpointState bqbench_ep2instate;
+
+/*
+ * Data endpoint, the simulated host sends back the data received on the IN
+ * side through the OUT side.
+ */
+static const USBEndpointConfig bqbench_ep1config = {
+  USB_EP_MODE_TYPE_BULK,
+  NULL,
+  sduDataTransmitted,
+  sduDataReceived,
+  0x0040,
+  0x0040,
+  &bqbench_ep1instate,
+  &bqbench_ep1outstate
+};
+
+/*
+ * Interrupt endpoint.
+ */
+static const USBEndpointConfig bqbench_ep2config = {
+  USB_EP_MODE_TYPE_INTR,
+  NULL,
+  sduInterruptTransmitted,
+  NULL,
+  0x0010,
+  0x0000,
+  &bqbench_ep2instate,
+  NULL
+};
+
+/*
+ * The simulated host does not request descriptors.
+ */
+static const USBDescriptor *bqbench_get_descriptor(USBDriver *usbp,
+                                                   uint8_t dtype,
+                                                   uint8_t dindex,
+                                                   uint16_t lang) {
+
+  (void)usbp;
+  (void)dtype;
+  (void)dindex;
+  (void)lang;
+
+  return NULL;
+}
+
+static void bqbench_usb_event(USBDriver *usbp, usbevent_t event) {
+
+  if (event == USB_EVENT_CONFIGURED) {
+    chSysLockFromISR();
+    usbInitEndpointI(usbp, BQBENCH_DATA_EP, &bqbench_ep1config);
+    usbInitEndpointI(usbp, BQBENCH_INTERRUPT_EP, &bqbench_ep2config);
+    sduConfigureHookI(&bqbench_sdu);
+    chSysUnlockFromISR();
+  }
+}
+
+static void bqbench_sof(USBDriver *usbp) {
+
+  (void)usbp;
+  chSysLockFromISR();
+  sduSOFHookI(&bqbench_sdu);
+  chSysUnlockFromISR();
+}
+
+static const USBConfig bqbench_usbcfg = {
+  bqbench_usb_event,
+  bqbench_get_descriptor,
+  sduRequestsHook,
+  bqbench_sof
+};
+
+static const SerialUSBConfig bqbench_sducfg = {
+  &USBD1,
+  BQBENCH_DATA_EP,
+  BQBENCH_DATA_EP,
+  BQBENCH_INTERRUPT_EP
+};
+
+/*
+ * Interrupts source, it runs when the writer and the reader are waiting.
+ */
+static THD_FUNCTION(bqbench_isr_thread, p) {
+
+  (void)p;
+  while (!chThdShouldTerminateX()) {
+    _sim_check_for_interrupts();
+  }
+}
+
+static THD_FUNCTION(bqbench_writer_thread, p) {
+  static const bqiovec_t iov[] = {
+    {&bqbench_buf[0], 4U},
+    {&bqbench_buf[4], 56U},
+    {&bqbench_buf[60], 4U}
+  };
+  uint8_t *bp;
+  size_t n;
+
+  (void)p;
+  while (!chThdShouldTerminateX()) {
+    switch (bqbench_mode) {
+    case BQBENCH_MODE_VIEWS:
+      n = sduGetWriteViewTimeout(&bqbench_sdu, &bp, TIME_MS2I(10));
+      if (n > 0U) {
+        memset(bp, 0x55, n);
+        sduCommit(&bqbench_sdu, n);
+      }
+      break;
+    case BQBENCH_MODE_VECTORED:
+      (void) sduWriteVTimeout(&bqbench_sdu, iov, 3U, TIME_MS2I(10));
+      break;
+    default:
+      (void) chnWriteTimeout(&bqbench_sdu, bqbench_buf, sizeof bqbench_buf,
+                             TIME_MS2I(10));
+      break;
+    }
+  }
+}
+
+static void bqbench_setup(unsigned mode) {
+  unsigned i;
+
+  bqbench_mode = mode;
+  bqbench_isr_tp = chThdCreateStatic(bqbench_wa_isr, sizeof bqbench_wa_isr,
+                                     chThdGetPriorityX() - 2,
+                                     bqbench_isr_thread, NULL);
+
+  /* The simulated host enumerates the device after the start.*/
+  sduObjectInit(&bqbench_sdu);
+  sduStart(&bqbench_sdu, &bqbench_sducfg);
+  usbStart(&USBD1, &bqbench_usbcfg);
+  usbConnectBus(&USBD1);
+  for (i = 0U; i < 100U; i++) {
+    if (usbGetDriverStateI(&USBD1) == USB_ACTIVE) {
+      break;
+    }
+    chThdSleepMilliseconds(1);
+  }
+
+  bqbench_writer_tp = chThdCreateStatic(bqbench_wa_writer,
+                                        sizeof bqbench_wa_writer,
+                                        chThdGetPriorityX() - 1,
+                                        bqbench_writer_thread, NULL);
+}
+
+static void bqbench_teardown(void) {
+
+  chThdTerminate(bqbench_writer_tp);
+  chThdWait(bqbench_writer_tp);
+  sduStop(&bqbench_sdu);
+  usbDisconnectBus(&USBD1);
+  usbStop(&USBD1);
+  chThdTerminate(bqbench_isr_tp);
+  chThdWait(bqbench_isr_tp);
+}
+
+/*
+ * Counts the bytes received in a one second time window.
+ */
+static uint32_t bqbench_loop(void) {
+  systime_t start, end;
+  uint8_t buf[sizeof bqbench_buf];
+  uint8_t *bp;
+  uint32_t n = 0U;
+  size_t size;
+
+  chThdSleep(1);
+  start = chVTGetSystemTime();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  do {
+    if (bqbench_mode == BQBENCH_MODE_COPY) {
+      n += (uint32_t)chnReadTimeout(&bqbench_sdu, buf, sizeof buf,
+                                    TIME_MS2I(10));
+    }
+    else {
+      size = sduGetReadViewTimeout(&bqbench_sdu, &bp, TIME_MS2I(10));
+      if (size > 0U) {
+        n += (uint32_t)size;
+        sduConsume(&bqbench_sdu, size);
+      }
+    }
+  } while (chVTIsSystemTimeWithinX(start, end));
+
+  return n;
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page hal_test_007_001 [7.1] Loopback throughput, copy
+ *
+ * <h2>Description</h2>
+ * A writer thread sends 64 bytes blocks using chnWriteTimeout(), the
+ * data is read using chnReadTimeout().
+ *
+ * <h2>Test Steps</h2>
+ * - [7.1.1] The bytes received through the loopback, moved using
+ *   chnWriteTimeout() and chnReadTimeout(), are counted in a one second
+ *   time window.
+ * - [7.1.2] Score is printed.
+ * .
+ */
+
+static void hal_test_007_001_setup(void) {
+  bqbench_setup(BQBENCH_MODE_COPY);
+}
+
+static void hal_test_007_001_teardown(void) {
+  bqbench_teardown();
+}
+
+static void hal_test_007_001_execute(void) {
+  uint32_t n;
+
+  /* [7.1.1] The bytes received through the loopback, moved using
+     chnWriteTimeout() and chnReadTimeout(), are counted in a one second
+     time window.*/
+  test_set_step(1);
+  {
+    n = bqbench_loop();
+    test_assert(n > 0U, "no data");
+  }
+  test_end_step(1);
+
+  /* [7.1.2] Score is printed.*/
+  test_set_step(2);
+  {
+    test_bench_score(n, "bytes/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t hal_test_007_001 = {
+  "Loopback throughput, copy",
+  hal_test_007_001_setup,
+  hal_test_007_001_teardown,
+  hal_test_007_001_execute
+};
+
+/**
+ * @page hal_test_007_002 [7.2] Loopback throughput, zero-copy views
+ *
+ * <h2>Description</h2>
+ * A writer thread fills the output buffers in place, the data is
+ * accessed in place in the input buffers.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.2.1] The bytes received through the loopback, moved using
+ *   sduGetWriteViewTimeout() and sduGetReadViewTimeout(), are counted
+ *   in a one second time window.
+ * - [7.2.2] Score is printed.
+ * .
+ */
+
+static void hal_test_007_002_setup(void) {
+  bqbench_setup(BQBENCH_MODE_VIEWS);
+}
+
+static void hal_test_007_002_teardown(void) {
+  bqbench_teardown();
+}
+
+static void hal_test_007_002_execute(void) {
+  uint32_t n;
+
+  /* [7.2.1] The bytes received through the loopback, moved using
+     sduGetWriteViewTimeout() and sduGetReadViewTimeout(), are counted
+     in a one second time window.*/
+  test_set_step(1);
+  {
+    n = bqbench_loop();
+    test_assert(n > 0U, "no data");
+  }
+  test_end_step(1);
+
+  /* [7.2.2] Score is printed.*/
+  test_set_step(2);
+  {
+    test_bench_score(n, "bytes/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t hal_test_007_002 = {
+  "Loopback throughput, zero-copy views",
+  hal_test_007_002_setup,
+  hal_test_007_002_teardown,
+  hal_test_007_002_execute
+};
+
+/**
+ * @page hal_test_007_003 [7.3] Loopback throughput, vectored writes
+ *
+ * <h2>Description</h2>
+ * A writer thread sends 64 bytes blocks made of three elements using
+ * sduWriteVTimeout(), the data is accessed in place in the input
+ * buffers.
+ *
+ * <h2>Test Steps</h2>
+ * - [7.3.1] The bytes received through the loopback, moved using
+ *   sduWriteVTimeout() and sduGetReadViewTimeout(), are counted in a
+ *   one second time window.
+ * - [7.3.2] Score is printed.
+ * .
+ */
+
+static void hal_test_007_003_setup(void) {
+  bqbench_setup(BQBENCH_MODE_VECTORED);
+}
+
+static void hal_test_007_003_teardown(void) {
+  bqbench_teardown();
+}
+
+static void hal_test_007_003_execute(void) {
+  uint32_t n;
+
+  /* [7.3.1] The bytes received through the loopback, moved using
+     sduWriteVTimeout() and sduGetReadViewTimeout(), are counted in a
+     one second time window.*/
+  test_set_step(1);
+  {
+    n = bqbench_loop();
+    test_assert(n > 0U, "no data");
+  }
+  test_end_step(1);
+
+  /* [7.3.2] Score is printed.*/
+  test_set_step(2);
+  {
+    test_bench_score(n, "bytes/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t hal_test_007_003 = {
+  "Loopback throughput, vectored writes",
+  hal_test_007_003_setup,
+  hal_test_007_003_teardown,
+  hal_test_007_003_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const hal_test_sequence_007_array[] = {
+  &hal_test_007_001,
+  &hal_test_007_002,
+  &hal_test_007_003,
+  NULL
+};
+
+/**
+ * @brief   Serial over USB benchmark.
+ */
+const testsequence_t hal_test_sequence_007 = {
+  "Serial over USB benchmark",
+  hal_test_sequence_007_array
+};
+
+#endif /* (HAL_USE_SERIAL_USB == TRUE) && defined(SIMULATOR) */
@@ -0,0 +1,329 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "hal_test_root.h"
+
+/**
+ * @file    hal_test_sequence_008.c
+ * @brief   Test Sequence 008 code.
+ *
+ * @page hal_test_sequence_008 [8] LIS3DSH over the SPI transactions queue
+ *
+ * File: @ref hal_test_sequence_008.c
+ *
+ * <h2>Description</h2>
+ * This sequence tests the LIS3DSH accelerometer driver using a
+ * simulated device, the registers are accessed through groups of queued
+ * SPI transactions.
+ *
+ * <h2>Conditions</h2>
+ * This sequence is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - HAL_TEST_LIS3DSH == TRUE
+ * .
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage hal_test_008_001
+ * - @subpage hal_test_008_002
+ * - @subpage hal_test_008_003
+ * .
+ */
+
+#if (HAL_TEST_LIS3DSH == TRUE) || defined(__DOXYGEN__)
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#include <string.h>
+
+static sim_lis3dsh_t lis3dsh_model;
+static LIS3DSHDriver lis3dsh1;
+
+static const SPIConfig lis3dsh_spicfg = {
+  .end_cb = NULL,
+  .device = simLIS3DSHGetDevice(&lis3dsh_model)
+};
+
+static const LIS3DSHConfig lis3dshcfg1 = {
+  .spip              = &SPID1,
+  .spicfg            = &lis3dsh_spicfg,
+  .accsensitivity    = NULL,
+  .accbias           = NULL,
+  .accfullscale      = LIS3DSH_ACC_FS_2G,
+  .accoutputdatarate = LIS3DSH_ACC_ODR_100HZ
+};
+
+/* Loop-back traffic sharing the bus with the device.*/
+static const SPIConfig lis3dsh_lbcfg = {
+  .end_cb = NULL,
+  .device = NULL
+};
+
+static THD_WORKING_AREA(lis3dsh_wa_lb, 1024);
+static thread_t *lis3dsh_lb_tp;
+static uint32_t lis3dsh_lb_count;
+static uint32_t lis3dsh_lb_errors;
+
+static THD_FUNCTION(lis3dsh_lb_thread, p) {
+  static const uint8_t txbuf[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+  uint8_t rxbuf[8];
+  spi_transaction_t t;
+
+  (void)p;
+  memset(&t, 0, sizeof t);
+  t.config = &lis3dsh_lbcfg;
+  t.n      = sizeof txbuf;
+  t.txbuf  = txbuf;
+  t.rxbuf  = rxbuf;
+  t.state  = SPI_TRANSACTION_IDLE;
+  while (!chThdShouldTerminateX()) {
+    memset(rxbuf, 0, sizeof rxbuf);
+    spiQueueTransaction(&SPID1, &t);
+    spiWaitTransaction(&SPID1, &t);
+    if (memcmp(rxbuf, txbuf, sizeof txbuf) != 0) {
+      lis3dsh_lb_errors++;
+    }
+    lis3dsh_lb_count++;
+  }
+}
+
+static void lis3dsh_test_setup(void) {
+
+  simLIS3DSHObjectInit(&lis3dsh_model);
+  lis3dshObjectInit(&lis3dsh1);
+  lis3dshStart(&lis3dsh1, &lis3dshcfg1);
+}
+
+static void lis3dsh_set_axes(int16_t x, int16_t y, int16_t z) {
+
+  chSysLock();
+  simLIS3DSHSetAxesI(&lis3dsh_model, x, y, z);
+  chSysUnlock();
+}
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+/**
+ * @page hal_test_008_001 [8.1] Device configuration
+ *
+ * <h2>Description</h2>
+ * The driver is started and the full scale is changed, the control
+ * registers are checked in the device model.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.1.1] Checking the registers written on start, each register
+ *   access is a single CS cycle.
+ * - [8.1.2] Changing the full scale, CTRL_REG5 is read and written.
+ * .
+ */
+
+static void hal_test_008_001_setup(void) {
+  lis3dsh_test_setup();
+}
+
+static void hal_test_008_001_teardown(void) {
+  lis3dshStop(&lis3dsh1);
+}
+
+static void hal_test_008_001_execute(void) {
+
+  /* [8.1.1] Checking the registers written on start, each register
+     access is a single CS cycle.*/
+  test_set_step(1);
+  {
+    test_assert(simLIS3DSHGetRegister(&lis3dsh_model, SIM_LIS3DSH_AD_CTRL_REG4) ==
+                (LIS3DSH_CTRL_REG4_XEN | LIS3DSH_CTRL_REG4_YEN |
+                 LIS3DSH_CTRL_REG4_ZEN | LIS3DSH_ACC_ODR_100HZ),
+                "wrong CTRL_REG4");
+    test_assert(simLIS3DSHGetRegister(&lis3dsh_model, SIM_LIS3DSH_AD_CTRL_REG5) ==
+                LIS3DSH_ACC_FS_2G, "wrong CTRL_REG5");
+    test_assert(simLIS3DSHGetRegister(&lis3dsh_model, SIM_LIS3DSH_AD_CTRL_REG6) ==
+                LIS3DSH_CTRL_REG6_ADD_INC, "wrong CTRL_REG6");
+    test_assert((lis3dsh_model.selects == 3U) &&
+                (lis3dsh_model.writes == 3U),
+                "unexpected device access");
+  }
+  test_end_step(1);
+
+  /* [8.1.2] Changing the full scale, CTRL_REG5 is read and written.*/
+  test_set_step(2);
+  {
+    msg_t msg;
+
+    msg = lis3dshAccelerometerSetFullScale(&lis3dsh1, LIS3DSH_ACC_FS_4G);
+    test_assert(msg == MSG_OK, "set full scale failed");
+    test_assert(simLIS3DSHGetRegister(&lis3dsh_model, SIM_LIS3DSH_AD_CTRL_REG5) ==
+                LIS3DSH_ACC_FS_4G, "wrong CTRL_REG5");
+    test_assert((lis3dsh_model.selects == 5U) &&
+                (lis3dsh_model.reads == 1U) &&
+                (lis3dsh_model.writes == 4U),
+                "unexpected device access");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t hal_test_008_001 = {
+  "Device configuration",
+  hal_test_008_001_setup,
+  hal_test_008_001_teardown,
+  hal_test_008_001_execute
+};
+
+/**
+ * @page hal_test_008_002 [8.2] Raw data
+ *
+ * <h2>Description</h2>
+ * A sample is set in the device model and read back using the
+ * accelerometer interface.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.2.1] Reading a sample, the six output registers are read in a
+ *   single CS cycle.
+ * .
+ */
+
+static void hal_test_008_002_setup(void) {
+  lis3dsh_test_setup();
+}
+
+static void hal_test_008_002_teardown(void) {
+  lis3dshStop(&lis3dsh1);
+}
+
+static void hal_test_008_002_execute(void) {
+  int32_t axes[LIS3DSH_ACC_NUMBER_OF_AXES];
+  msg_t msg;
+
+  /* [8.2.1] Reading a sample, the six output registers are read in a
+     single CS cycle.*/
+  test_set_step(1);
+  {
+    lis3dsh_set_axes(1000, -2000, 32767);
+    msg = lis3dshAccelerometerReadRaw(&lis3dsh1, axes);
+    test_assert(msg == MSG_OK, "read failed");
+    test_assert((axes[0] == 1000) && (axes[1] == -2000) &&
+                (axes[2] == 32767), "wrong sample");
+    test_assert((lis3dsh_model.selects == 4U) &&
+                (lis3dsh_model.reads == 6U),
+                "unexpected device access");
+    test_assert((simLIS3DSHGetRegister(&lis3dsh_model, SIM_LIS3DSH_AD_STATUS) &
+                 SIM_LIS3DSH_STATUS_ZYXDA) == 0U,
+                "new data flag not cleared");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t hal_test_008_002 = {
+  "Raw data",
+  hal_test_008_002_setup,
+  hal_test_008_002_teardown,
+  hal_test_008_002_execute
+};
+
+/**
+ * @page hal_test_008_003 [8.3] Shared bus
+ *
+ * <h2>Description</h2>
+ * A thread keeps the bus busy with loop-back transactions using a
+ * different configuration while samples are read, the register accesses
+ * must not be split by the other transactions.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.3.1] Reading 100 samples with different values.
+ * - [8.3.2] Checking the device accesses and the loop-back traffic.
+ * .
+ */
+
+static void hal_test_008_003_setup(void) {
+  lis3dsh_test_setup();
+  lis3dsh_lb_count = 0U;
+  lis3dsh_lb_errors = 0U;
+  lis3dsh_lb_tp = chThdCreateStatic(lis3dsh_wa_lb, sizeof lis3dsh_wa_lb,
+                                    chThdGetPriorityX() - 1,
+                                    lis3dsh_lb_thread, NULL);
+}
+
+static void hal_test_008_003_teardown(void) {
+  chThdTerminate(lis3dsh_lb_tp);
+  chThdWait(lis3dsh_lb_tp);
+  lis3dshStop(&lis3dsh1);
+}
+
+static void hal_test_008_003_execute(void) {
+  int32_t axes[LIS3DSH_ACC_NUMBER_OF_AXES];
+  int16_t i;
+  msg_t msg;
+
+  /* [8.3.1] Reading 100 samples with different values.*/
+  test_set_step(1);
+  {
+    for (i = 0; i < 100; i++) {
+      lis3dsh_set_axes(i, (int16_t)(i * -3), (int16_t)(i * 300));
+      msg = lis3dshAccelerometerReadRaw(&lis3dsh1, axes);
+      test_assert(msg == MSG_OK, "read failed");
+      test_assert((axes[0] == i) && (axes[1] == i * -3) &&
+                  (axes[2] == i * 300), "wrong sample");
+      chThdSleep(1);
+    }
+  }
+  test_end_step(1);
+
+  /* [8.3.2] Checking the device accesses and the loop-back traffic.*/
+  test_set_step(2);
+  {
+    test_assert((lis3dsh_model.selects == 103U) &&
+                (lis3dsh_model.reads == 600U),
+                "unexpected device access");
+    test_assert(lis3dsh_lb_count > 0U, "no loop-back traffic");
+    test_assert(lis3dsh_lb_errors == 0U, "loop-back data corrupted");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t hal_test_008_003 = {
+  "Shared bus",
+  hal_test_008_003_setup,
+  hal_test_008_003_teardown,
+  hal_test_008_003_execute
+};
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const hal_test_sequence_008_array[] = {
+  &hal_test_008_001,
+  &hal_test_008_002,
+  &hal_test_008_003,
+  NULL
+};
+
+/**
+ * @brief   LIS3DSH over the SPI transactions queue.
+ */
+const testsequence_t hal_test_sequence_008 = {
+  "LIS3DSH over the SPI transactions queue",
+  hal_test_sequence_008_array
+};
+
+#endif /* HAL_TEST_LIS3DSH == TRUE */
@@ -56,6 +56,15 @@ static const char *test_failure_message;
 static char test_tokens_buffer[TEST_CFG_MAX_TOKENS];
 static char *test_tokp;
 static BaseSequentialStream *test_chp;
+static unsigned test_bench_run;
+static unsigned test_bench_nscores;
+static const char *test_bench_units[TEST_CFG_BENCH_MAX_SCORES];
+static unsigned test_bench_counts[TEST_CFG_BENCH_MAX_SCORES];
+static uint32_t test_bench_samples[TEST_CFG_BENCH_MAX_SCORES]
+                                  [TEST_CFG_BENCH_REPETITIONS];
+#if TEST_CFG_BENCH_FORMAT == TEST_BENCH_FORMAT_JSON
+static bool test_bench_first;
+#endif
 
 /*===========================================================================*/
 /* Module local functions.                                                   */
@@ -74,16 +83,284 @@ static void print_tokens(void) {
 }
 
 static void execute_test(const testcase_t *tcp) {
+  unsigned i;
 
-  /* Initialization */
-  clear_tokens();
-  test_local_fail = false;
+  for (i = 0U; i < TEST_CFG_BENCH_MAX_SCORES; i++)
+    test_bench_counts[i] = 0U;
+
+  /* Test cases reporting scores are benchmarks, those are run again for
+     the configured number of warm-up and measured runs.*/
+  test_bench_run = 0U;
+  do {
+    /* Initialization */
+    clear_tokens();
+    test_local_fail = false;
+    test_bench_nscores = 0U;
+
+    if (tcp->setup != NULL)
+      tcp->setup();
+    tcp->execute();
+    if (tcp->teardown != NULL)
+      tcp->teardown();
+
+    test_bench_run++;
+  } while (!test_local_fail && (test_bench_nscores > 0U) &&
+           (test_bench_run < (TEST_CFG_BENCH_WARMUP +
+                              TEST_CFG_BENCH_REPETITIONS)));
+}
+
+static void sort_samples(uint32_t *p, unsigned n) {
+  unsigned i, j;
+
+  for (i = 1U; i < n; i++) {
+    uint32_t x = p[i];
+
+    for (j = i; (j > 0U) && (p[j - 1U] > x); j--)
+      p[j] = p[j - 1U];
+    p[j] = x;
+  }
+}
+
+#if TEST_CFG_BENCH_FORMAT != TEST_BENCH_FORMAT_TEXT
+static void print_quoted(const char *s) {
+
+  streamPut(test_chp, '"');
+  while (*s) {
+#if TEST_CFG_BENCH_FORMAT == TEST_BENCH_FORMAT_JSON
+    if ((*s == '"') || (*s == '\\'))
+      streamPut(test_chp, '\\');
+#else
+    if (*s == '"')
+      streamPut(test_chp, '"');
+#endif
+    streamPut(test_chp, *s++);
+  }
+  streamPut(test_chp, '"');
+}
+
+static void print_config_key(const char *key) {
+
+#if TEST_CFG_BENCH_FORMAT == TEST_BENCH_FORMAT_JSON
+  if (!test_bench_first)
+    streamPut(test_chp, ',');
+  test_bench_first = false;
+  print_quoted(key);
+  streamPut(test_chp, ':');
+#else
+  test_print("# ");
+  test_print(key);
+  streamPut(test_chp, '=');
+#endif
+}
+
+static void print_config_string(const char *key, const char *value) {
+
+  print_config_key(key);
+#if TEST_CFG_BENCH_FORMAT == TEST_BENCH_FORMAT_JSON
+  print_quoted(value);
+#else
+  test_println(value);
+#endif
+}
+
+static void print_config_number(const char *key, uint32_t value) {
+
+  print_config_key(key);
+  test_printn(value);
+#if TEST_CFG_BENCH_FORMAT == TEST_BENCH_FORMAT_CSV
+  test_println("");
+#endif
+}
+
+/* Configuration record, the build and kernel settings affecting the
+   benchmark scores.*/
+static void print_bench_config(const testsuite_t *tsp) {
+
+#if TEST_CFG_BENCH_FORMAT == TEST_BENCH_FORMAT_JSON
+  test_print("{\"config\":{");
+  test_bench_first = true;
+#endif
+  if (tsp->name != NULL)
+    print_config_string("suite", tsp->name);
+#if defined(PORT_ARCHITECTURE_NAME)
+  print_config_string("port", PORT_ARCHITECTURE_NAME);
+#endif
+#if defined(PORT_CORE_VARIANT_NAME)
+  print_config_string("core", PORT_CORE_VARIANT_NAME);
+#endif
+#if defined(PORT_COMPILER_NAME)
+  print_config_string("compiler", PORT_COMPILER_NAME);
+#endif
+#if defined(PORT_INFO)
+  print_config_string("port_info", PORT_INFO);
+#endif
+#if defined(CH_KERNEL_VERSION)
+  print_config_string("kernel", CH_KERNEL_VERSION);
+#endif
+#if defined(PLATFORM_NAME)
+  print_config_string("platform", PLATFORM_NAME);
+#endif
+#if defined(BOARD_NAME)
+  print_config_string("board", BOARD_NAME);
+#endif
+  print_config_string("compiled", __DATE__ " - " __TIME__);
+#if defined(CH_CFG_ST_RESOLUTION)
+  print_config_number("CH_CFG_ST_RESOLUTION", CH_CFG_ST_RESOLUTION);
+#endif
+#if defined(CH_CFG_ST_FREQUENCY)
+  print_config_number("CH_CFG_ST_FREQUENCY", CH_CFG_ST_FREQUENCY);
+#endif
+#if defined(CH_CFG_INTERVALS_SIZE)
+  print_config_number("CH_CFG_INTERVALS_SIZE", CH_CFG_INTERVALS_SIZE);
+#endif
+#if defined(CH_CFG_TIME_TYPES_SIZE)
+  print_config_number("CH_CFG_TIME_TYPES_SIZE", CH_CFG_TIME_TYPES_SIZE);
+#endif
+#if defined(CH_CFG_ST_TIMEDELTA)
+  print_config_number("CH_CFG_ST_TIMEDELTA", CH_CFG_ST_TIMEDELTA);
+#endif
+#if defined(CH_CFG_TIME_QUANTUM)
+  print_config_number("CH_CFG_TIME_QUANTUM", CH_CFG_TIME_QUANTUM);
+#endif
+#if defined(CH_CFG_MAX_THREADS)
+  print_config_number("CH_CFG_MAX_THREADS", CH_CFG_MAX_THREADS);
+#endif
+#if defined(CH_CFG_OPTIMIZE_SPEED)
+  print_config_number("CH_CFG_OPTIMIZE_SPEED", CH_CFG_OPTIMIZE_SPEED);
+#endif
+#if defined(CH_CFG_USE_TM)
+  print_config_number("CH_CFG_USE_TM", CH_CFG_USE_TM);
+#endif
+#if defined(CH_CFG_USE_REGISTRY)
+  print_config_number("CH_CFG_USE_REGISTRY", CH_CFG_USE_REGISTRY);
+#endif
+#if defined(CH_DBG_STATISTICS)
+  print_config_number("CH_DBG_STATISTICS", CH_DBG_STATISTICS);
+#endif
+#if defined(CH_DBG_SYSTEM_STATE_CHECK)
+  print_config_number("CH_DBG_SYSTEM_STATE_CHECK", CH_DBG_SYSTEM_STATE_CHECK);
+#endif
+#if defined(CH_DBG_ENABLE_CHECKS)
+  print_config_number("CH_DBG_ENABLE_CHECKS", CH_DBG_ENABLE_CHECKS);
+#endif
+#if defined(CH_DBG_ENABLE_ASSERTS)
+  print_config_number("CH_DBG_ENABLE_ASSERTS", CH_DBG_ENABLE_ASSERTS);
+#endif
+#if defined(CH_DBG_TRACE_MASK)
+  print_config_number("CH_DBG_TRACE_MASK", CH_DBG_TRACE_MASK);
+#endif
+#if defined(CH_DBG_ENABLE_STACK_CHECK)
+  print_config_number("CH_DBG_ENABLE_STACK_CHECK", CH_DBG_ENABLE_STACK_CHECK);
+#endif
+#if defined(CH_DBG_FILL_THREADS)
+  print_config_number("CH_DBG_FILL_THREADS", CH_DBG_FILL_THREADS);
+#endif
+#if defined(CH_DBG_THREADS_PROFILING)
+  print_config_number("CH_DBG_THREADS_PROFILING", CH_DBG_THREADS_PROFILING);
+#endif
+  print_config_number("warmup", TEST_CFG_BENCH_WARMUP);
+  print_config_number("repetitions", TEST_CFG_BENCH_REPETITIONS);
+#if TEST_CFG_BENCH_FORMAT == TEST_BENCH_FORMAT_JSON
+  test_println("}}");
+#else
+  test_println("suite,id,sequence,case,unit,n,min,median,p99,max");
+#endif
+}
+#endif /* TEST_CFG_BENCH_FORMAT != TEST_BENCH_FORMAT_TEXT */
+
+/* Statistics of the scores reported by the last executed test case, the
+   median of an even number of samples is the mean of the central ones,
+   p99 is calculated using the nearest-rank method.*/
+static void print_bench_results(const testsuite_t *tsp,
+                                unsigned tseq, unsigned tcase) {
+  unsigned i;
+
+#if TEST_CFG_BENCH_FORMAT == TEST_BENCH_FORMAT_TEXT
+  (void)tsp;
+  (void)tseq;
+  (void)tcase;
+#endif
+
+  for (i = 0U; i < TEST_CFG_BENCH_MAX_SCORES; i++) {
+    uint32_t *p = test_bench_samples[i];
+    unsigned n = test_bench_counts[i];
+    uint32_t median;
 
-  if (tcp->setup != NULL)
-    tcp->setup();
-  tcp->execute();
-  if (tcp->teardown != NULL)
-    tcp->teardown();
+    if (n == 0U)
+      continue;
+
+    sort_samples(p, n);
+    median = p[(n - 1U) / 2U];
+    if ((n & 1U) == 0U) {
+      uint32_t hi = p[n / 2U];
+
+      median = (median / 2U) + (hi / 2U) + (median & hi & 1U);
+    }
+
+    test_print("--- Score : ");
+    test_printn(median);
+    streamPut(test_chp, ' ');
+    test_print(test_bench_units[i]);
+    if (n > 1U) {
+      test_print(" (min ");
+      test_printn(p[0]);
+      test_print(", p99 ");
+      test_printn(p[(((99U * n) + 99U) / 100U) - 1U]);
+      test_print(", max ");
+      test_printn(p[n - 1U]);
+      streamPut(test_chp, ')');
+    }
+    test_println("");
+
+#if TEST_CFG_BENCH_FORMAT == TEST_BENCH_FORMAT_JSON
+    test_print("{\"suite\":");
+    print_quoted(tsp->name != NULL ? tsp->name : "");
+    test_print(",\"id\":\"");
+    test_printn(tseq + 1U);
+    streamPut(test_chp, '.');
+    test_printn(tcase + 1U);
+    test_print("\",\"sequence\":");
+    print_quoted(tsp->sequences[tseq]->name);
+    test_print(",\"case\":");
+    print_quoted(tsp->sequences[tseq]->cases[tcase]->name);
+    test_print(",\"unit\":");
+    print_quoted(test_bench_units[i]);
+    test_print(",\"n\":");
+    test_printn(n);
+    test_print(",\"min\":");
+    test_printn(p[0]);
+    test_print(",\"median\":");
+    test_printn(median);
+    test_print(",\"p99\":");
+    test_printn(p[(((99U * n) + 99U) / 100U) - 1U]);
+    test_print(",\"max\":");
+    test_printn(p[n - 1U]);
+    test_println("}");
+#elif TEST_CFG_BENCH_FORMAT == TEST_BENCH_FORMAT_CSV
+    print_quoted(tsp->name != NULL ? tsp->name : "");
+    test_print(",\"");
+    test_printn(tseq + 1U);
+    streamPut(test_chp, '.');
+    test_printn(tcase + 1U);
+    test_print("\",");
+    print_quoted(tsp->sequences[tseq]->name);
+    streamPut(test_chp, ',');
+    print_quoted(tsp->sequences[tseq]->cases[tcase]->name);
+    streamPut(test_chp, ',');
+    print_quoted(test_bench_units[i]);
+    streamPut(test_chp, ',');
+    test_printn(n);
+    streamPut(test_chp, ',');
+    test_printn(p[0]);
+    streamPut(test_chp, ',');
+    test_printn(median);
+    streamPut(test_chp, ',');
+    test_printn(p[(((99U * n) + 99U) / 100U) - 1U]);
+    streamPut(test_chp, ',');
+    test_printn(p[n - 1U]);
+    test_println("");
+#endif
+  }
 }
 
 static void print_line(void) {
@@ -220,6 +497,33 @@ void test_emit_token_i(char token) {
     *test_tokp++ = token;
 }
 
+/**
+ * @brief   Reports a benchmark score.
+ * @details Scores are identified by the order in which they are reported
+ *          within the test case, the scores of the warm-up runs are
+ *          discarded and statistics are printed after the last measured
+ *          run.
+ * @note    This function can only be called from test_case execute context.
+ *
+ * @param[in] score     the score value
+ * @param[in] unit      the score unit as string, for example "msgs/S"
+ *
+ * @api
+ */
+void test_bench_score(uint32_t score, const char *unit) {
+  unsigned i = test_bench_nscores++;
+
+#if TEST_CFG_BENCH_WARMUP > 0
+  if (test_bench_run < TEST_CFG_BENCH_WARMUP)
+    return;
+#endif
+
+  if (i < TEST_CFG_BENCH_MAX_SCORES) {
+    test_bench_units[i] = unit;
+    test_bench_samples[i][test_bench_counts[i]++] = score;
+  }
+}
+
 /**
  * @brief   Test execution thread function.
  *
@@ -278,6 +582,10 @@ msg_t test_execute(BaseSequentialStream *stream, const testsuite_t *tsp) {
 #endif
 #if defined(TEST_REPORT_HOOK_HEADER)
   TEST_REPORT_HOOK_HEADER
+#endif
+#if TEST_CFG_BENCH_FORMAT != TEST_BENCH_FORMAT_TEXT
+  test_println("***");
+  print_bench_config(tsp);
 #endif
   test_println("");
 
@@ -306,6 +614,7 @@ msg_t test_execute(BaseSequentialStream *stream, const testsuite_t *tsp) {
       osalThreadSleepMilliseconds(TEST_CFG_DELAY_BETWEEN_TESTS);
 #endif
       execute_test(tsp->sequences[tseq]->cases[tcase]);
+      print_bench_results(tsp, (unsigned)tseq, (unsigned)tcase);
       if (test_local_fail) {
         test_print("--- Result: FAILURE (#");
         test_printn(test_step);
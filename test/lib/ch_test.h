@@ -29,6 +29,24 @@
 /* Module constants.                                                         */
 /*===========================================================================*/
 
+/**
+ * @name    Benchmark records formats
+ * @{
+ */
+/**
+ * @brief   Human readable "--- Score" lines only.
+ */
+#define TEST_BENCH_FORMAT_TEXT              0
+/**
+ * @brief   One JSON object per line, config record in the report header.
+ */
+#define TEST_BENCH_FORMAT_JSON              1
+/**
+ * @brief   CSV rows, config as "#" comment lines in the report header.
+ */
+#define TEST_BENCH_FORMAT_CSV               2
+/** @} */
+
 /*===========================================================================*/
 /* Module pre-compile time settings.                                         */
 /*===========================================================================*/
@@ -62,10 +80,61 @@
 #define TEST_CFG_SIZE_REPORT                TRUE
 #endif
 
+/**
+ * @brief   Format of the benchmark records.
+ * @details Records are emitted, one per line, in addition to the normal
+ *          test report so that they can be filtered out of the output.
+ */
+#if !defined(TEST_CFG_BENCH_FORMAT) || defined(__DOXYGEN__)
+#define TEST_CFG_BENCH_FORMAT               TEST_BENCH_FORMAT_TEXT
+#endif
+
+/**
+ * @brief   Number of discarded warm-up runs of benchmark test cases.
+ */
+#if !defined(TEST_CFG_BENCH_WARMUP) || defined(__DOXYGEN__)
+#define TEST_CFG_BENCH_WARMUP               0
+#endif
+
+/**
+ * @brief   Number of measured runs of benchmark test cases.
+ * @note    A test case is a benchmark if it reports scores using
+ *          @p test_bench_score(), the whole case including setup and
+ *          teardown is repeated.
+ */
+#if !defined(TEST_CFG_BENCH_REPETITIONS) || defined(__DOXYGEN__)
+#define TEST_CFG_BENCH_REPETITIONS          1
+#endif
+
+/**
+ * @brief   Maximum number of scores reported by a single test case.
+ */
+#if !defined(TEST_CFG_BENCH_MAX_SCORES) || defined(__DOXYGEN__)
+#define TEST_CFG_BENCH_MAX_SCORES           4
+#endif
+
 /*===========================================================================*/
 /* Derived constants and error checks.                                       */
 /*===========================================================================*/
 
+#if (TEST_CFG_BENCH_FORMAT != TEST_BENCH_FORMAT_TEXT) &&                    \
+    (TEST_CFG_BENCH_FORMAT != TEST_BENCH_FORMAT_JSON) &&                    \
+    (TEST_CFG_BENCH_FORMAT != TEST_BENCH_FORMAT_CSV)
+#error "invalid TEST_CFG_BENCH_FORMAT value"
+#endif
+
+#if TEST_CFG_BENCH_WARMUP < 0
+#error "invalid TEST_CFG_BENCH_WARMUP value"
+#endif
+
+#if TEST_CFG_BENCH_REPETITIONS < 1
+#error "invalid TEST_CFG_BENCH_REPETITIONS value"
+#endif
+
+#if TEST_CFG_BENCH_MAX_SCORES < 1
+#error "invalid TEST_CFG_BENCH_MAX_SCORES value"
+#endif
+
 /*===========================================================================*/
 /* Module data structures and types.                                         */
 /*===========================================================================*/
@@ -216,6 +285,7 @@ extern "C" {
   void test_println(const char *msgp);
   void test_emit_token(char token);
   void test_emit_token_i(char token);
+  void test_bench_score(uint32_t score, const char *unit);
   msg_t test_execute(BaseSequentialStream *stream, const testsuite_t *tsp);
 #ifdef __cplusplus
 }
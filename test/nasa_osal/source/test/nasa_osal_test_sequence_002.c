@@ -20,6 +20,8 @@
  * - @subpage nasa_osal_test_002_002
  * - @subpage nasa_osal_test_002_003
  * - @subpage nasa_osal_test_002_004
+ * - @subpage nasa_osal_test_002_005
+ * - @subpage nasa_osal_test_002_006
  * .
  */
 
@@ -47,6 +49,41 @@ static void test_task_writer(void) {
     }
   }
 }
+#define BENCH_MESSAGE_SIZE  256
+
+static uint32 queue_loop(uint32 id, bool zero_copy) {
+  systime_t start, end;
+  uint32 n = 0;
+
+  start = chVTGetSystemTime();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  do {
+    void *p;
+    uint32 size;
+
+    if (zero_copy) {
+      (void) OS_QueueAllocBuffer(id, &p, OS_PEND);
+      memset(p, 0x55, BENCH_MESSAGE_SIZE);
+      (void) OS_QueuePutBuffer(id, p, BENCH_MESSAGE_SIZE);
+      (void) OS_QueueGetBuffer(id, &p, &size, OS_PEND);
+      (void) OS_QueueReleaseBuffer(id, p);
+    }
+    else {
+      uint8 data[BENCH_MESSAGE_SIZE];
+
+      memset(data, 0x55, BENCH_MESSAGE_SIZE);
+      (void) OS_QueuePut(id, data, BENCH_MESSAGE_SIZE, 0);
+      (void) OS_QueueGet(id, data, BENCH_MESSAGE_SIZE, &size, OS_PEND);
+    }
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+
+  return n;
+}
+
 
 /****************************************************************************
  * Test cases.
@@ -368,6 +405,191 @@ static const testcase_t nasa_osal_test_002_004 = {
   nasa_osal_test_002_004_execute
 };
 
+/**
+ * @page nasa_osal_test_002_005 [2.5] OS_QueueAllocBuffer() and OS_QueueGetBuffer() functionality
+ *
+ * <h2>Description</h2>
+ * Messages are exchanged by passing the ownership of the queue buffers,
+ * the received buffers must be the same buffers allocated by the
+ * writer.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.5.1] Allocating all the buffers of the queue, a further
+ *   allocation must fail.
+ * - [2.5.2] Filling and posting the buffers, the same buffers must be
+ *   retrieved in order, then the buffers are released.
+ * - [2.5.3] Releasing a buffer not belonging to the queue, an error is
+ *   expected.
+ * - [2.5.4] Deleting the queue, the old identifier and name must no
+ *   more be valid.
+ * .
+ */
+
+static void nasa_osal_test_002_005_setup(void) {
+  qid = 0;
+  (void) OS_QueueCreate(&qid, "test queue", 2, MESSAGE_SIZE, 0);
+}
+
+static void nasa_osal_test_002_005_teardown(void) {
+  if (qid != 0) {
+    (void) OS_QueueDelete(qid);
+  }
+}
+
+static void nasa_osal_test_002_005_execute(void) {
+  void *buf1, *buf2;
+
+  /* [2.5.1] Allocating all the buffers of the queue, a further
+     allocation must fail.*/
+  test_set_step(1);
+  {
+    int32 err;
+    void *p;
+
+    err = OS_QueueAllocBuffer(qid, &buf1, OS_CHECK);
+    test_assert(err == OS_SUCCESS, "allocation failed");
+    err = OS_QueueAllocBuffer(qid, &buf2, OS_CHECK);
+    test_assert(err == OS_SUCCESS, "allocation failed");
+    err = OS_QueueAllocBuffer(qid, &p, OS_CHECK);
+    test_assert(err == OS_QUEUE_FULL, "unexpected error code");
+  }
+
+  /* [2.5.2] Filling and posting the buffers, the same buffers must be
+     retrieved in order, then the buffers are released.*/
+  test_set_step(2);
+  {
+    int32 err;
+    void *p;
+    uint32 size;
+
+    strcpy(buf1, "Hello");
+    err = OS_QueuePutBuffer(qid, buf1, 6);
+    test_assert(err == OS_SUCCESS, "post failed");
+    strcpy(buf2, "World");
+    err = OS_QueuePutBuffer(qid, buf2, 6);
+    test_assert(err == OS_SUCCESS, "post failed");
+
+    err = OS_QueueGetBuffer(qid, &p, &size, OS_CHECK);
+    test_assert(err == OS_SUCCESS, "get failed");
+    test_assert((p == buf1) && (size == 6), "wrong buffer");
+    test_assert(strcmp(p, "Hello") == 0, "wrong message");
+    err = OS_QueueReleaseBuffer(qid, p);
+    test_assert(err == OS_SUCCESS, "release failed");
+
+    err = OS_QueueGetBuffer(qid, &p, &size, OS_CHECK);
+    test_assert(err == OS_SUCCESS, "get failed");
+    test_assert((p == buf2) && (size == 6), "wrong buffer");
+    test_assert(strcmp(p, "World") == 0, "wrong message");
+    err = OS_QueueReleaseBuffer(qid, p);
+    test_assert(err == OS_SUCCESS, "release failed");
+
+    err = OS_QueueGetBuffer(qid, &p, &size, OS_CHECK);
+    test_assert(err == OS_QUEUE_EMPTY, "unexpected error code");
+  }
+
+  /* [2.5.3] Releasing a buffer not belonging to the queue, an error is
+     expected.*/
+  test_set_step(3);
+  {
+    int32 err;
+    char data[MESSAGE_SIZE];
+
+    err = OS_QueueReleaseBuffer(qid, data);
+    test_assert(err == OS_ERROR, "foreign buffer not detected");
+  }
+
+  /* [2.5.4] Deleting the queue, the old identifier and name must no
+     more be valid.*/
+  test_set_step(4);
+  {
+    int32 err;
+    uint32 local_qid;
+
+    err = OS_QueueDelete(qid);
+    test_assert(err == OS_SUCCESS, "queue deletion failed");
+    err = OS_QueuePut(qid, "Hello World", 12, 0);
+    test_assert(err == OS_ERR_INVALID_ID, "stale id not detected");
+    err = OS_QueueGetIdByName(&local_qid, "test queue");
+    test_assert(err == OS_ERR_NAME_NOT_FOUND, "stale name not detected");
+    qid = 0;
+  }
+}
+
+static const testcase_t nasa_osal_test_002_005 = {
+  "OS_QueueAllocBuffer() and OS_QueueGetBuffer() functionality",
+  nasa_osal_test_002_005_setup,
+  nasa_osal_test_002_005_teardown,
+  nasa_osal_test_002_005_execute
+};
+
+/**
+ * @page nasa_osal_test_002_006 [2.6] OS_QueuePut() and OS_QueueGet() throughput
+ *
+ * <h2>Description</h2>
+ * Messages are exchanged through a queue for one second, first copying
+ * them then passing the buffers ownership, the number of exchanged
+ * messages is printed.
+ *
+ * <h2>Test Steps</h2>
+ * - [2.6.1] Exchanging messages using OS_QueuePut() and OS_QueueGet().
+ * - [2.6.2] Score is printed.
+ * - [2.6.3] Exchanging messages using OS_QueuePutBuffer() and
+ *   OS_QueueGetBuffer().
+ * - [2.6.4] Score is printed.
+ * .
+ */
+
+static void nasa_osal_test_002_006_setup(void) {
+  qid = 0;
+  (void) OS_QueueCreate(&qid, "test queue", 4, BENCH_MESSAGE_SIZE, 0);
+}
+
+static void nasa_osal_test_002_006_teardown(void) {
+  if (qid != 0) {
+    (void) OS_QueueDelete(qid);
+  }
+}
+
+static void nasa_osal_test_002_006_execute(void) {
+  uint32 n;
+
+  /* [2.6.1] Exchanging messages using OS_QueuePut() and OS_QueueGet().*/
+  test_set_step(1);
+  {
+    n = queue_loop(qid, false);
+  }
+
+  /* [2.6.2] Score is printed.*/
+  test_set_step(2);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" msgs/S (copy)");
+  }
+
+  /* [2.6.3] Exchanging messages using OS_QueuePutBuffer() and
+     OS_QueueGetBuffer().*/
+  test_set_step(3);
+  {
+    n = queue_loop(qid, true);
+  }
+
+  /* [2.6.4] Score is printed.*/
+  test_set_step(4);
+  {
+    test_print("--- Score : ");
+    test_printn(n);
+    test_println(" msgs/S (zero copy)");
+  }
+}
+
+static const testcase_t nasa_osal_test_002_006 = {
+  "OS_QueuePut() and OS_QueueGet() throughput",
+  nasa_osal_test_002_006_setup,
+  nasa_osal_test_002_006_teardown,
+  nasa_osal_test_002_006_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -380,6 +602,8 @@ const testcase_t * const nasa_osal_test_sequence_002_array[] = {
   &nasa_osal_test_002_002,
   &nasa_osal_test_002_003,
   &nasa_osal_test_002_004,
+  &nasa_osal_test_002_005,
+  &nasa_osal_test_002_006,
   NULL
 };
 
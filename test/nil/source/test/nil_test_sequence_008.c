@@ -41,6 +41,7 @@
  * - @subpage nil_test_008_005
  * - @subpage nil_test_008_006
  * - @subpage nil_test_008_007
+ * - @subpage nil_test_008_008
  * .
  */
 
@@ -104,6 +105,17 @@ static THD_FUNCTION(bmk_thread4, p) {
   chSysUnlock();
 }
 
+static THD_FUNCTION(bmk_thread5, p) {
+  msg_t msg;
+
+  (void)p;
+  chSysLock();
+  do {
+    msg = chSchGoSleepTimeoutS(NIL_STATE_SLEEPING, TIME_MS2I(1000));
+  } while (msg == MSG_OK);
+  chSysUnlock();
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -164,11 +176,8 @@ static void nil_test_008_001_execute(void) {
   /* [8.1.3] Score is printed.*/
   test_set_step(3);
   {
-    test_print("--- Score : ");
-    test_printn(n);
-    test_print(" msgs/S, ");
-    test_printn(n << 1);
-    test_println(" ctxswc/S");
+    test_bench_score(n, "msgs/S");
+    test_bench_score(n << 1, "ctxswc/S");
   }
   test_end_step(3);
 }
@@ -237,11 +246,8 @@ static void nil_test_008_002_execute(void) {
   /* [8.2.3] Score is printed.*/
   test_set_step(3);
   {
-    test_print("--- Score : ");
-    test_printn(n);
-    test_print(" msgs/S, ");
-    test_printn(n << 1);
-    test_println(" ctxswc/S");
+    test_bench_score(n, "msgs/S");
+    test_bench_score(n << 1, "ctxswc/S");
   }
   test_end_step(3);
 }
@@ -326,9 +332,7 @@ static void nil_test_008_003_execute(void) {
   /* [8.3.4] Score is printed.*/
   test_set_step(4);
   {
-    test_print("--- Score : ");
-    test_printn(n * 2);
-    test_println(" ctxswc/S");
+    test_bench_score(n * 2, "ctxswc/S");
   }
   test_end_step(4);
 }
@@ -389,9 +393,7 @@ static void nil_test_008_004_execute(void) {
   /* [8.4.2] Score is printed.*/
   test_set_step(2);
   {
-    test_print("--- Score : ");
-    test_printn(n);
-    test_println(" threads/S");
+    test_bench_score(n, "threads/S");
   }
   test_end_step(2);
 }
@@ -453,9 +455,7 @@ static void nil_test_008_005_execute(void) {
   /* [8.5.2] Score is printed.*/
   test_set_step(2);
   {
-    test_print("--- Score : ");
-    test_printn(n);
-    test_println(" threads/S");
+    test_bench_score(n, "threads/S");
   }
   test_end_step(2);
 }
@@ -526,9 +526,7 @@ static void nil_test_008_006_execute(void) {
   /* [8.6.2] The score is printed.*/
   test_set_step(2);
   {
-    test_print("--- Score : ");
-    test_printn(n * 4);
-    test_println(" wait+signal/S");
+    test_bench_score(n * 4, "wait+signal/S");
   }
   test_end_step(2);
 }
@@ -542,24 +540,108 @@ static const testcase_t nil_test_008_006 = {
 #endif /* CH_CFG_USE_SEMAPHORES */
 
 /**
- * @page nil_test_008_007 [8.7] RAM Footprint
+ * @page nil_test_008_007 [8.7] Context Switch performance with timeouts
  *
  * <h2>Description</h2>
- * The memory size of the various kernel objects is printed.
+ * A thread is created that performs a @p chSchGoSleepTimeoutS() into a
+ * loop, the thread is awakened as fast is possible by the tester
+ * thread before the timeout expires.<br> The difference from the plain
+ * Context Switch score is the cost of arming and disarming a timeout
+ * on each cycle.
  *
  * <h2>Test Steps</h2>
- * - [8.7.1] The size of the system area is printed.
- * - [8.7.2] The size of a thread structure is printed.
- * - [8.7.3] The size of a semaphore structure is printed.
- * - [8.7.4] The size of an event source is printed.
- * - [8.7.5] The size of an event listener is printed.
- * - [8.7.6] The size of a mailbox is printed.
+ * - [8.7.1] Starting the target thread at an higher priority level.
+ * - [8.7.2] Waking up the thread as fast as possible in a one second
+ *   time window.
+ * - [8.7.3] Stopping the target thread.
+ * - [8.7.4] Score is printed.
  * .
  */
 
 static void nil_test_008_007_execute(void) {
+  thread_t *tp;
+  uint32_t n;
 
-  /* [8.7.1] The size of the system area is printed.*/
+  /* [8.7.1] Starting the target thread at an higher priority level.*/
+  test_set_step(1);
+  {
+    thread_descriptor_t td = {
+      .name  = "sleeper",
+      .wbase = wa_common,
+      .wend  = THD_WORKING_AREA_END(wa_common),
+      .prio  = chThdGetPriorityX() - 1,
+      .funcp = bmk_thread5,
+      .arg   = NULL
+    };
+    tp = chThdCreate(&td);
+  }
+  test_end_step(1);
+
+  /* [8.7.2] Waking up the thread as fast as possible in a one second
+     time window.*/
+  test_set_step(2);
+  {
+    systime_t start, end;
+
+    n = 0;
+    start = test_wait_tick();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      chSysLock();
+      chSchWakeupS(tp, MSG_OK);
+      chSchWakeupS(tp, MSG_OK);
+      chSchWakeupS(tp, MSG_OK);
+      chSchWakeupS(tp, MSG_OK);
+      chSysUnlock();
+      n += 4;
+    } while (chVTIsSystemTimeWithinX(start, end));
+  }
+  test_end_step(2);
+
+  /* [8.7.3] Stopping the target thread.*/
+  test_set_step(3);
+  {
+    chSysLock();
+    chSchWakeupS(tp, MSG_TIMEOUT);
+    chSysUnlock();
+    chThdWait(tp);
+  }
+  test_end_step(3);
+
+  /* [8.7.4] Score is printed.*/
+  test_set_step(4);
+  {
+    test_bench_score(n * 2, "ctxswc/S");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t nil_test_008_007 = {
+  "Context Switch performance with timeouts",
+  NULL,
+  NULL,
+  nil_test_008_007_execute
+};
+
+/**
+ * @page nil_test_008_008 [8.8] RAM Footprint
+ *
+ * <h2>Description</h2>
+ * The memory size of the various kernel objects is printed.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.8.1] The size of the system area is printed.
+ * - [8.8.2] The size of a thread structure is printed.
+ * - [8.8.3] The size of a semaphore structure is printed.
+ * - [8.8.4] The size of an event source is printed.
+ * - [8.8.5] The size of an event listener is printed.
+ * - [8.8.6] The size of a mailbox is printed.
+ * .
+ */
+
+static void nil_test_008_008_execute(void) {
+
+  /* [8.8.1] The size of the system area is printed.*/
   test_set_step(1);
   {
     test_print("--- OS    : ");
@@ -568,7 +650,7 @@ static void nil_test_008_007_execute(void) {
   }
   test_end_step(1);
 
-  /* [8.7.2] The size of a thread structure is printed.*/
+  /* [8.8.2] The size of a thread structure is printed.*/
   test_set_step(2);
   {
     test_print("--- Thread: ");
@@ -577,7 +659,7 @@ static void nil_test_008_007_execute(void) {
   }
   test_end_step(2);
 
-  /* [8.7.3] The size of a semaphore structure is printed.*/
+  /* [8.8.3] The size of a semaphore structure is printed.*/
   test_set_step(3);
   {
 #if CH_CFG_USE_SEMAPHORES || defined(__DOXYGEN__)
@@ -588,7 +670,7 @@ static void nil_test_008_007_execute(void) {
   }
   test_end_step(3);
 
-  /* [8.7.4] The size of an event source is printed.*/
+  /* [8.8.4] The size of an event source is printed.*/
   test_set_step(4);
   {
 #if CH_CFG_USE_EVENTS || defined(__DOXYGEN__)
@@ -599,7 +681,7 @@ static void nil_test_008_007_execute(void) {
   }
   test_end_step(4);
 
-  /* [8.7.5] The size of an event listener is printed.*/
+  /* [8.8.5] The size of an event listener is printed.*/
   test_set_step(5);
   {
 #if CH_CFG_USE_EVENTS || defined(__DOXYGEN__)
@@ -610,7 +692,7 @@ static void nil_test_008_007_execute(void) {
   }
   test_end_step(5);
 
-  /* [8.7.6] The size of a mailbox is printed.*/
+  /* [8.8.6] The size of a mailbox is printed.*/
   test_set_step(6);
   {
 #if CH_CFG_USE_MAILBOXES || defined(__DOXYGEN__)
@@ -622,11 +704,11 @@ static void nil_test_008_007_execute(void) {
   test_end_step(6);
 }
 
-static const testcase_t nil_test_008_007 = {
+static const testcase_t nil_test_008_008 = {
   "RAM Footprint",
   NULL,
   NULL,
-  nil_test_008_007_execute
+  nil_test_008_008_execute
 };
 
 /****************************************************************************
@@ -650,6 +732,7 @@ const testcase_t * const nil_test_sequence_008_array[] = {
   &nil_test_008_006,
 #endif
   &nil_test_008_007,
+  &nil_test_008_008,
   NULL
 };
 
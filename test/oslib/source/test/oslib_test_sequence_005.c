@@ -37,6 +37,7 @@
  *
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_005_001
+ * - @subpage oslib_test_005_002
  * .
  */
 
@@ -110,6 +111,31 @@ static THD_FUNCTION(Thread1, arg) {
   chThdExit(0x0FA5);
 }
 
+#define DELEGATES_QUEUE_SIZE 4
+
+/* The calls queue dispatcher runs below the test thread, NIL priorities are
+   ordered the other way around.*/
+#if defined(__CHIBIOS_NIL__)
+#define DISPATCHER_PRIO (chThdGetPriorityX() + 1)
+#else
+#define DISPATCHER_PRIO (chThdGetPriorityX() - 1)
+#endif
+
+static delegate_queue_t dq;
+static delegate_call_t calls[DELEGATES_QUEUE_SIZE];
+
+static THD_FUNCTION(Thread2, arg) {
+
+  (void)arg;
+
+  exit_flag = false;
+  do {
+    chDelegateDispatchQueue(&dq);
+  } while (!exit_flag);
+
+  chThdExit(0x0FA5);
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -190,6 +216,136 @@ static const testcase_t oslib_test_005_001 = {
   oslib_test_005_001_execute
 };
 
+/**
+ * @page oslib_test_005_002 [5.2] Calls queue test
+ *
+ * <h2>Description</h2>
+ * The asynchronous calls queue API is tested for functionality. The
+ * dispatcher thread has lower priority than the caller so the queued
+ * calls are executed in batches.
+ *
+ * <h2>Test Steps</h2>
+ * - [5.2.1] Initializing the calls queue and starting the dispatcher
+ *   thread.
+ * - [5.2.2] Posting calls without futures until the queue is full, the
+ *   dispatcher is not running so no tokens are expected.
+ * - [5.2.3] Posting into the full queue, a timeout is expected.
+ * - [5.2.4] Posting a call with a future, the caller waits for a free
+ *   slot then for the result, checking the result and the emitted
+ *   tokens.
+ * - [5.2.5] Terminating the dispatcher using an asynchronous call,
+ *   waiting for the thread to terminate.
+ * .
+ */
+
+static void oslib_test_005_002_execute(void) {
+  thread_t *tp;
+
+  /* [5.2.1] Initializing the calls queue and starting the dispatcher
+     thread.*/
+  test_set_step(1);
+  {
+    thread_descriptor_t td = {
+      .name  = "dispatcher",
+      .wbase = waThread1,
+      .wend  = THD_WORKING_AREA_END(waThread1),
+      .prio  = DISPATCHER_PRIO,
+      .funcp = Thread2,
+      .arg   = NULL
+    };
+
+    chDelegateQueueObjectInit(&dq, calls, DELEGATES_QUEUE_SIZE);
+    tp = chThdCreate(&td);
+  }
+  test_end_step(1);
+
+  /* [5.2.2] Posting calls without futures until the queue is full, the
+     dispatcher is not running so no tokens are expected.*/
+  test_set_step(2);
+  {
+    msg_t msg;
+
+    msg = chDelegateCallAsync0(&dq, NULL, (delegate_fn0_t)dis_func0);
+    test_assert(msg == MSG_OK, "post failed");
+
+    msg = chDelegateCallAsync1(&dq, NULL, (delegate_fn1_t)dis_func1, 'A');
+    test_assert(msg == MSG_OK, "post failed");
+
+    msg = chDelegateCallAsync2(&dq, NULL, (delegate_fn2_t)dis_func2, 'B', 'C');
+    test_assert(msg == MSG_OK, "post failed");
+
+    msg = chDelegateCallAsync3(&dq, NULL, (delegate_fn3_t)dis_func3, 'D', 'E', 'F');
+    test_assert(msg == MSG_OK, "post failed");
+
+    test_assert_sequence("", "unexpected tokens");
+  }
+  test_end_step(2);
+
+  /* [5.2.3] Posting into the full queue, a timeout is expected.*/
+  test_set_step(3);
+  {
+    delegate_call_t dc = {
+      .func.fn0 = (delegate_fn0_t)dis_func0,
+      .argc     = 0U,
+      .future   = NULL
+    };
+    msg_t msg;
+
+    chSysLock();
+    msg = chDelegatePostI(&dq, &dc);
+    chSysUnlock();
+    test_assert(msg == MSG_TIMEOUT, "queue not full");
+
+    msg = chDelegatePostTimeout(&dq, &dc, TIME_IMMEDIATE);
+    test_assert(msg == MSG_TIMEOUT, "queue not full");
+  }
+  test_end_step(3);
+
+  /* [5.2.4] Posting a call with a future, the caller waits for a free
+     slot then for the result, checking the result and the emitted
+     tokens.*/
+  test_set_step(4);
+  {
+    delegate_future_t future;
+    msg_t msg;
+
+    msg = chDelegateCallAsync4(&dq, &future, (delegate_fn4_t)dis_func4, 'G', 'H', 'I', 'J');
+    test_assert(msg == MSG_OK, "post failed");
+
+    msg = chDelegateFutureWaitTimeout(&future, TIME_INFINITE);
+    test_assert(msg == MSG_OK, "wait failed");
+    test_assert(chDelegateFutureIsDoneX(&future), "not completed");
+    test_assert(chDelegateFutureGetResultX(&future) == (msg_t)'G', "invalid return value");
+
+    test_assert_sequence("0ABCDEFGHIJ", "unexpected tokens");
+  }
+  test_end_step(4);
+
+  /* [5.2.5] Terminating the dispatcher using an asynchronous call,
+     waiting for the thread to terminate.*/
+  test_set_step(5);
+  {
+    delegate_future_t future;
+    msg_t msg;
+
+    msg = chDelegateCallAsync0(&dq, &future, (delegate_fn0_t)dis_func_end);
+    test_assert(msg == MSG_OK, "post failed");
+    test_assert(chDelegateFutureWait(&future) == (msg_t)0xAA55, "invalid return value");
+    test_assert_sequence("Z", "unexpected tokens");
+
+    msg = chThdWait(tp);
+    test_assert(msg == 0x0FA5, "invalid exit code");
+  }
+  test_end_step(5);
+}
+
+static const testcase_t oslib_test_005_002 = {
+  "Calls queue test",
+  NULL,
+  NULL,
+  oslib_test_005_002_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -199,6 +355,7 @@ static const testcase_t oslib_test_005_001 = {
  */
 const testcase_t * const oslib_test_sequence_005_array[] = {
   &oslib_test_005_001,
+  &oslib_test_005_002,
   NULL
 };
 
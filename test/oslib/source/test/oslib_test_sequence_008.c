@@ -38,6 +38,8 @@
  * <h2>Test Cases</h2>
  * - @subpage oslib_test_008_001
  * - @subpage oslib_test_008_002
+ * - @subpage oslib_test_008_003
+ * - @subpage oslib_test_008_004
  * .
  */
 
@@ -47,12 +49,29 @@
  * Shared code.
  ****************************************************************************/
 
+#include <string.h>
+
 #define ALLOC_SIZE 16
 #define HEAP_SIZE (ALLOC_SIZE * 8)
 
 static memory_heap_t test_heap;
 static uint8_t test_heap_buffer[HEAP_SIZE];
 
+#define REALLOC_HEADER_SIZE 16
+#define REALLOC_MESSAGE_SIZE 128
+#define REALLOC_RECORD_SIZE 512
+
+static void *copy_realloc(void *p, size_t size) {
+  void *np;
+  size_t n = chHeapGetSize(p);
+
+  np = chHeapAlloc(NULL, size);
+  memcpy(np, p, n < size ? n : size);
+  chHeapFree(p);
+
+  return np;
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -268,6 +287,214 @@ static const testcase_t oslib_test_008_002 = {
   oslib_test_008_002_execute
 };
 
+/**
+ * @page oslib_test_008_003 [8.3] Reallocation
+ *
+ * <h2>Description</h2>
+ * The chHeapRealloc() function is tested in all its code paths: growing
+ * in place, shrinking, moving the block and failing. The test expects
+ * to find the heap back to the initial status after each step.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.3.1] Testing initial conditions, the heap must not be fragmented
+ *   and one free block present.
+ * - [8.3.2] Growing a block followed by free space, the block must be
+ *   extended in place.
+ * - [8.3.3] Shrinking the same block, the block must not move and the
+ *   excess must be merged with the free space.
+ * - [8.3.4] Growing a block followed by an allocated block, the block
+ *   must be moved and the content preserved.
+ * - [8.3.5] Growing a block beyond the available space, an error is
+ *   expected and the original block must be left untouched.
+ * - [8.3.6] Testing final conditions. The heap geometry must be the
+ *   same than the one registered at beginning.
+ * .
+ */
+
+static void oslib_test_008_003_setup(void) {
+  chHeapObjectInit(&test_heap, test_heap_buffer, sizeof(test_heap_buffer));
+}
+
+static void oslib_test_008_003_execute(void) {
+  void *p1, *p2, *p3;
+  size_t n, sz;
+
+  /* [8.3.1] Testing initial conditions, the heap must not be fragmented
+     and one free block present.*/
+  test_set_step(1);
+  {
+    test_assert(chHeapStatus(&test_heap, &sz, NULL) == 1, "heap fragmented");
+  }
+  test_end_step(1);
+
+  /* [8.3.2] Growing a block followed by free space, the block must be
+     extended in place.*/
+  test_set_step(2);
+  {
+    p1 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    test_assert(p1 != NULL, "allocation failed");
+    p2 = chHeapRealloc(p1, ALLOC_SIZE * 2);
+    test_assert(p2 == p1, "block moved");
+    test_assert(chHeapGetSize(p2) == ALLOC_SIZE * 2, "wrong size");
+    test_assert(chHeapStatus(&test_heap, &n, NULL) == 1, "heap fragmented");
+  }
+  test_end_step(2);
+
+  /* [8.3.3] Shrinking the same block, the block must not move and the
+     excess must be merged with the free space.*/
+  test_set_step(3);
+  {
+    p2 = chHeapRealloc(p1, ALLOC_SIZE);
+    test_assert(p2 == p1, "block moved");
+    test_assert(chHeapGetSize(p2) == ALLOC_SIZE, "wrong size");
+    test_assert(chHeapStatus(&test_heap, &n, NULL) == 1, "heap fragmented");
+    chHeapFree(p1);
+    test_assert(chHeapStatus(&test_heap, &n, NULL) == 1, "heap fragmented");
+    test_assert(n == sz, "size changed");
+  }
+  test_end_step(3);
+
+  /* [8.3.4] Growing a block followed by an allocated block, the block
+     must be moved and the content preserved.*/
+  test_set_step(4);
+  {
+    p1 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    p2 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    memset(p1, 0x55, ALLOC_SIZE);
+    p3 = chHeapRealloc(p1, ALLOC_SIZE * 2);
+    test_assert(p3 != NULL, "reallocation failed");
+    test_assert(p3 != p1, "block not moved");
+    test_assert(((uint8_t *)p3)[0] == 0x55, "content lost");
+    test_assert(((uint8_t *)p3)[ALLOC_SIZE - 1] == 0x55, "content lost");
+    chHeapFree(p2);
+    chHeapFree(p3);
+    test_assert(chHeapStatus(&test_heap, &n, NULL) == 1, "heap fragmented");
+  }
+  test_end_step(4);
+
+  /* [8.3.5] Growing a block beyond the available space, an error is
+     expected and the original block must be left untouched.*/
+  test_set_step(5);
+  {
+    p1 = chHeapAlloc(&test_heap, ALLOC_SIZE);
+    p2 = chHeapRealloc(p1, sizeof test_heap_buffer * 2);
+    test_assert(p2 == NULL, "reallocation not failed");
+    test_assert(chHeapGetSize(p1) == ALLOC_SIZE, "wrong size");
+    chHeapFree(p1);
+  }
+  test_end_step(5);
+
+  /* [8.3.6] Testing final conditions. The heap geometry must be the
+     same than the one registered at beginning.*/
+  test_set_step(6);
+  {
+    test_assert(chHeapStatus(&test_heap, &n, NULL) == 1, "heap fragmented");
+    test_assert(n == sz, "size changed");
+  }
+  test_end_step(6);
+}
+
+static const testcase_t oslib_test_008_003 = {
+  "Reallocation",
+  oslib_test_008_003_setup,
+  NULL,
+  oslib_test_008_003_execute
+};
+
+/**
+ * @page oslib_test_008_004 [8.4] Reallocation performance
+ *
+ * <h2>Description</h2>
+ * A buffer on the default heap is repeatedly grown and shrunk following
+ * the pattern of a TLS record buffer: a small header buffer is
+ * allocated, grown to hold an handshake message then a full record,
+ * finally shrunk back and freed. The same sequence is then performed
+ * using allocate/copy/free cycles. The scores are calculated by
+ * measuring the number of iterations after a second of continuous
+ * operations.
+ *
+ * <h2>Test Steps</h2>
+ * - [8.4.1] Checking that the default heap can hold the largest buffer.
+ * - [8.4.2] Growing and shrinking the buffer using chHeapRealloc() in a
+ *   one second time window, then printing the score.
+ * - [8.4.3] Performing the same sequence using chHeapAlloc(), memcpy()
+ *   and chHeapFree() in a one second time window, then printing the
+ *   score.
+ * .
+ */
+
+static void oslib_test_008_004_execute(void) {
+  void *p;
+  uint32_t n;
+
+  /* [8.4.1] Checking that the default heap can hold the largest buffer.*/
+  test_set_step(1);
+  {
+    p = chHeapAlloc(NULL, REALLOC_RECORD_SIZE);
+    test_assert(p != NULL, "allocation failed");
+    chHeapFree(p);
+  }
+  test_end_step(1);
+
+  /* [8.4.2] Growing and shrinking the buffer using chHeapRealloc() in a
+     one second time window, then printing the score.*/
+  test_set_step(2);
+  {
+    systime_t start, end;
+
+    n = 0;
+    chThdSleep(1);
+    start = chVTGetSystemTimeX();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      p = chHeapAlloc(NULL, REALLOC_HEADER_SIZE);
+      p = chHeapRealloc(p, REALLOC_MESSAGE_SIZE);
+      p = chHeapRealloc(p, REALLOC_RECORD_SIZE);
+      p = chHeapRealloc(p, REALLOC_HEADER_SIZE);
+      chHeapFree(p);
+      n++;
+    #if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+    #endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    test_bench_score(n * 3, "reallocs/S");
+  }
+  test_end_step(2);
+
+  /* [8.4.3] Performing the same sequence using chHeapAlloc(), memcpy()
+     and chHeapFree() in a one second time window, then printing the
+     score.*/
+  test_set_step(3);
+  {
+    systime_t start, end;
+
+    n = 0;
+    chThdSleep(1);
+    start = chVTGetSystemTimeX();
+    end = chTimeAddX(start, TIME_MS2I(1000));
+    do {
+      p = chHeapAlloc(NULL, REALLOC_HEADER_SIZE);
+      p = copy_realloc(p, REALLOC_MESSAGE_SIZE);
+      p = copy_realloc(p, REALLOC_RECORD_SIZE);
+      p = copy_realloc(p, REALLOC_HEADER_SIZE);
+      chHeapFree(p);
+      n++;
+    #if defined(SIMULATOR)
+      _sim_check_for_interrupts();
+    #endif
+    } while (chVTIsSystemTimeWithinX(start, end));
+    test_bench_score(n * 3, "reallocs/S (copy)");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_008_004 = {
+  "Reallocation performance",
+  NULL,
+  NULL,
+  oslib_test_008_004_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -278,6 +505,8 @@ static const testcase_t oslib_test_008_002 = {
 const testcase_t * const oslib_test_sequence_008_array[] = {
   &oslib_test_008_001,
   &oslib_test_008_002,
+  &oslib_test_008_003,
+  &oslib_test_008_004,
   NULL
 };
 
@@ -42,6 +42,7 @@
  * - @subpage oslib_test_009_004
  * - @subpage oslib_test_009_005
  * - @subpage oslib_test_009_006
+ * - @subpage oslib_test_009_007
  * .
  */
 
@@ -51,6 +52,19 @@
  * Shared code.
  ****************************************************************************/
 
+#if CH_CFG_FACTORY_GENERIC_BUFFERS == TRUE
+#define LOOKUP_OBJECTS 32U
+
+static void make_name(char *p, unsigned i) {
+
+  p[0] = 'o';
+  p[1] = 'b';
+  p[2] = 'j';
+  p[3] = (char)('0' + (i / 10U));
+  p[4] = (char)('0' + (i % 10U));
+  p[5] = '\0';
+}
+#endif
 
 /****************************************************************************
  * Test cases.
@@ -777,6 +791,148 @@ static const testcase_t oslib_test_009_006 = {
 };
 #endif /* CH_CFG_FACTORY_PIPES == TRUE */
 
+#if (CH_CFG_FACTORY_GENERIC_BUFFERS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_009_007 [9.7] Dynamic objects lookup
+ *
+ * <h2>Description</h2>
+ * This test case verifies the names lookup of the factory with many
+ * objects, objects are created and released in an interleaved order and
+ * retrieved using the handles API.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_FACTORY_GENERIC_BUFFERS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [9.7.1] Creating the dynamic buffers, must succeed.
+ * - [9.7.2] Opening all the buffers by name, the expected buffers must
+ *   be returned, then closing them.
+ * - [9.7.3] Releasing the even buffers, the odd buffers must still be
+ *   found.
+ * - [9.7.4] Creating the even buffers again, all the buffers must be
+ *   found.
+ * - [9.7.5] Releasing all the buffers, none must be found.
+ * .
+ */
+
+static void oslib_test_009_007_teardown(void) {
+  unsigned i;
+
+  for (i = 0U; i < LOOKUP_OBJECTS; i++) {
+    dyn_buffer_t *dbp;
+    char name[8];
+
+    make_name(name, i);
+    dbp = chFactoryFindBuffer(name);
+    if (dbp != NULL) {
+      while (dbp->element.refs > 0U) {
+        chFactoryReleaseBuffer(dbp);
+      }
+    }
+  }
+}
+
+static void oslib_test_009_007_execute(void) {
+  dyn_buffer_t *dbps[LOOKUP_OBJECTS];
+  char name[8];
+  unsigned i;
+
+  /* [9.7.1] Creating the dynamic buffers, must succeed.*/
+  test_set_step(1);
+  {
+    for (i = 0U; i < LOOKUP_OBJECTS; i++) {
+      make_name(name, i);
+      dbps[i] = chFactoryCreateBuffer(name, 16U);
+      test_assert(dbps[i] != NULL, "cannot create");
+    }
+  }
+  test_end_step(1);
+
+  /* [9.7.2] Opening all the buffers by name, the expected buffers must
+     be returned, then closing them.*/
+  test_set_step(2);
+  {
+    for (i = 0U; i < LOOKUP_OBJECTS; i++) {
+      uint8_t *bp;
+
+      make_name(name, i);
+      bp = chFactoryOpenBuffer(name);
+      test_assert(bp == chFactoryGetBuffer(dbps[i]), "buffer mismatch");
+      test_assert(dbps[i]->element.refs == 2, "references mismatch");
+      chFactoryCloseBuffer(bp);
+      test_assert(dbps[i]->element.refs == 1, "references mismatch");
+    }
+  }
+  test_end_step(2);
+
+  /* [9.7.3] Releasing the even buffers, the odd buffers must still be
+     found.*/
+  test_set_step(3);
+  {
+    for (i = 0U; i < LOOKUP_OBJECTS; i += 2U) {
+      chFactoryReleaseBuffer(dbps[i]);
+    }
+    for (i = 0U; i < LOOKUP_OBJECTS; i++) {
+      dyn_buffer_t *dbp;
+
+      make_name(name, i);
+      dbp = chFactoryFindBuffer(name);
+      if ((i & 1U) == 0U) {
+        test_assert(dbp == NULL, "found");
+      }
+      else {
+        test_assert(dbp == dbps[i], "not found");
+        chFactoryReleaseBuffer(dbp);
+      }
+    }
+  }
+  test_end_step(3);
+
+  /* [9.7.4] Creating the even buffers again, all the buffers must be
+     found.*/
+  test_set_step(4);
+  {
+    for (i = 0U; i < LOOKUP_OBJECTS; i += 2U) {
+      make_name(name, i);
+      dbps[i] = chFactoryCreateBuffer(name, 16U);
+      test_assert(dbps[i] != NULL, "cannot create");
+    }
+    for (i = 0U; i < LOOKUP_OBJECTS; i++) {
+      dyn_buffer_t *dbp;
+
+      make_name(name, i);
+      dbp = chFactoryFindBuffer(name);
+      test_assert(dbp == dbps[i], "not found");
+      chFactoryReleaseBuffer(dbp);
+    }
+  }
+  test_end_step(4);
+
+  /* [9.7.5] Releasing all the buffers, none must be found.*/
+  test_set_step(5);
+  {
+    for (i = 0U; i < LOOKUP_OBJECTS; i++) {
+      chFactoryReleaseBuffer(dbps[i]);
+    }
+    for (i = 0U; i < LOOKUP_OBJECTS; i++) {
+      make_name(name, i);
+      test_assert(chFactoryFindBuffer(name) == NULL, "found");
+    }
+  }
+  test_end_step(5);
+}
+
+static const testcase_t oslib_test_009_007 = {
+  "Dynamic objects lookup",
+  NULL,
+  oslib_test_009_007_teardown,
+  oslib_test_009_007_execute
+};
+#endif /* CH_CFG_FACTORY_GENERIC_BUFFERS == TRUE */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -802,6 +958,9 @@ const testcase_t * const oslib_test_sequence_009_array[] = {
 #endif
 #if (CH_CFG_FACTORY_PIPES == TRUE) || defined(__DOXYGEN__)
   &oslib_test_009_006,
+#endif
+#if (CH_CFG_FACTORY_GENERIC_BUFFERS == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_009_007,
 #endif
   NULL
 };
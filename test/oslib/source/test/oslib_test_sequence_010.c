@@ -0,0 +1,1749 @@
+/*
+    ChibiOS - Copyright (C) 2006..2017 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include "hal.h"
+#include "oslib_test_root.h"
+
+/**
+ * @file    oslib_test_sequence_010.c
+ * @brief   Test Sequence 010 code.
+ *
+ * @page oslib_test_sequence_010 [10] Benchmarks
+ *
+ * File: @ref oslib_test_sequence_010.c
+ *
+ * <h2>Description</h2>
+ * Performance benchmarks of the OS Library primitives. Each test case
+ * runs the measured operation continuously for one second, the
+ * throughput is reported as operations per second. If the port supports
+ * the realtime counter then the latency of all the calls is collected
+ * in a histogram and reported as nanoseconds per operation at the median
+ * and at the 99th percentile, the counter frequency is calibrated against
+ * the system time. Contention is tested using a peer thread exchanging data with
+ * the test thread.
+ *
+ * <h2>Test Cases</h2>
+ * - @subpage oslib_test_010_001
+ * - @subpage oslib_test_010_002
+ * - @subpage oslib_test_010_003
+ * - @subpage oslib_test_010_004
+ * - @subpage oslib_test_010_005
+ * - @subpage oslib_test_010_006
+ * - @subpage oslib_test_010_007
+ * - @subpage oslib_test_010_008
+ * - @subpage oslib_test_010_009
+ * - @subpage oslib_test_010_010
+ * - @subpage oslib_test_010_011
+ * - @subpage oslib_test_010_012
+ * - @subpage oslib_test_010_013
+ * - @subpage oslib_test_010_014
+ * - @subpage oslib_test_010_015
+ * - @subpage oslib_test_010_016
+ * - @subpage oslib_test_010_017
+ * - @subpage oslib_test_010_018
+ * - @subpage oslib_test_010_019
+ * - @subpage oslib_test_010_020
+ * - @subpage oslib_test_010_021
+ * .
+ */
+
+/****************************************************************************
+ * Shared code.
+ ****************************************************************************/
+
+#define BENCH_BATCH                 16U
+#define BENCH_HIST_SUB_BITS         3U
+#define BENCH_HIST_SIZE             ((((unsigned)sizeof (rtcnt_t) * 8U) -   \
+                                      BENCH_HIST_SUB_BITS + 1U) <<          \
+                                     BENCH_HIST_SUB_BITS)
+#define BENCH_PIPE_SIZE             128U
+#define BENCH_OBJECTS               8U
+#define BENCH_FACTORY_OBJECTS       500U
+#define BENCH_HEAP_SIZE             1024U
+
+/* Peer threads priorities relative to the test thread, NIL priorities are
+   ordered the other way around.*/
+#if defined(__CHIBIOS_NIL__)
+#define BENCH_PRIO_ABOVE            (chThdGetPriorityX() - 1)
+#define BENCH_PRIO_BELOW            (chThdGetPriorityX() + 1)
+#else
+#define BENCH_PRIO_ABOVE            (chThdGetPriorityX() + 1)
+#define BENCH_PRIO_BELOW            (chThdGetPriorityX() - 1)
+#endif
+
+#if (CH_CFG_USE_MAILBOXES == TRUE) || (CH_CFG_USE_PIPES == TRUE) ||         \
+    (CH_CFG_USE_JOBS == TRUE) || (CH_CFG_USE_DELEGATES == TRUE)
+static THD_WORKING_AREA(waBench, 256);
+static thread_t *bench_tp;
+
+static thread_t *bench_start(tfunc_t funcp, tprio_t prio) {
+  thread_descriptor_t td = {
+    .name  = "bench",
+    .wbase = waBench,
+    .wend  = THD_WORKING_AREA_END(waBench),
+    .prio  = prio,
+    .funcp = funcp,
+    .arg   = NULL
+  };
+
+  return chThdCreate(&td);
+}
+#endif
+
+#if PORT_SUPPORTS_RT == TRUE
+/* Durations histogram, values below 2^BENCH_HIST_SUB_BITS have a bucket
+   each, above that each power of two is split in 2^BENCH_HIST_SUB_BITS
+   buckets so the error is below 1/2^BENCH_HIST_SUB_BITS of the value.*/
+static uint32_t bench_hist[BENCH_HIST_SIZE];
+
+static void bench_hist_add(rtcnt_t v) {
+  unsigned e = BENCH_HIST_SUB_BITS;
+
+  if (v < ((rtcnt_t)1 << BENCH_HIST_SUB_BITS)) {
+    bench_hist[v]++;
+    return;
+  }
+  while ((e < (((unsigned)sizeof (rtcnt_t) * 8U) - 1U)) &&
+         ((v >> (e + 1U)) != (rtcnt_t)0)) {
+    e++;
+  }
+  bench_hist[((e - BENCH_HIST_SUB_BITS + 1U) << BENCH_HIST_SUB_BITS) +
+             ((unsigned)(v >> (e - BENCH_HIST_SUB_BITS)) &
+              ((1U << BENCH_HIST_SUB_BITS) - 1U))]++;
+}
+
+/* Value at the specified percentile of n samples, the bucket center.*/
+static rtcnt_t bench_hist_percentile(uint32_t n, unsigned pct) {
+  uint32_t rank = (uint32_t)((((uint64_t)n * pct) + 99U) / 100U);
+  uint32_t cnt = 0U;
+  unsigned i, g;
+
+  for (i = 0U; i < BENCH_HIST_SIZE - 1U; i++) {
+    cnt += bench_hist[i];
+    if (cnt >= rank) {
+      break;
+    }
+  }
+  if (i < (1U << BENCH_HIST_SUB_BITS)) {
+    return (rtcnt_t)i;
+  }
+  g = i >> BENCH_HIST_SUB_BITS;
+
+  return ((rtcnt_t)((1U << BENCH_HIST_SUB_BITS) +
+                    (i & ((1U << BENCH_HIST_SUB_BITS) - 1U))) << (g - 1U)) +
+         (((rtcnt_t)1 << (g - 1U)) >> 1);
+}
+#endif
+
+static systime_t bench_wait_tick(void) {
+
+  chThdSleep(1);
+  return chVTGetSystemTimeX();
+}
+
+/*
+ * Runs the benchmark function for one second, each call performs
+ * BENCH_BATCH operations. The throughput score is the number of
+ * operations multiplied by the weight, the latency scores are calculated
+ * on the durations of all the calls.
+ */
+static void bench_run(void (*fn)(void), uint32_t weight, const char *unit,
+                      const char *p50unit, const char *p99unit) {
+  systime_t start, end;
+  uint32_t n = 0U;
+#if PORT_SUPPORTS_RT == TRUE
+  rtcnt_t rtstart, rt;
+  uint64_t freq;
+  unsigned i;
+
+  for (i = 0U; i < BENCH_HIST_SIZE; i++) {
+    bench_hist[i] = 0U;
+  }
+#endif
+
+  start = bench_wait_tick();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+#if PORT_SUPPORTS_RT == TRUE
+  rtstart = chSysGetRealtimeCounterX();
+#endif
+  do {
+#if PORT_SUPPORTS_RT == TRUE
+    rt = chSysGetRealtimeCounterX();
+    fn();
+    bench_hist_add(chSysGetRealtimeCounterX() - rt);
+#else
+    fn();
+#endif
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+  test_bench_score(n * BENCH_BATCH * weight, unit);
+
+#if PORT_SUPPORTS_RT == TRUE
+  /* Realtime counter frequency measured over the elapsed system time.*/
+  freq = ((uint64_t)(chSysGetRealtimeCounterX() - rtstart) *
+          (uint64_t)CH_CFG_ST_FREQUENCY) /
+         (uint64_t)chTimeDiffX(start, chVTGetSystemTimeX());
+  test_bench_score((uint32_t)(((uint64_t)bench_hist_percentile(n, 50U) *
+                               1000000000ULL) / (freq * BENCH_BATCH)),
+                   p50unit);
+  test_bench_score((uint32_t)(((uint64_t)bench_hist_percentile(n, 99U) *
+                               1000000000ULL) / (freq * BENCH_BATCH)),
+                   p99unit);
+#else
+  (void)p50unit;
+  (void)p99unit;
+#endif
+}
+
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+static mailbox_t bench_mb;
+static msg_t bench_mb_buffer[BENCH_BATCH];
+
+static THD_FUNCTION(bench_mb_consumer, arg) {
+  msg_t msg, data;
+
+  (void)arg;
+
+  do {
+    msg = chMBFetchTimeout(&bench_mb, &data, TIME_INFINITE);
+  } while (msg == MSG_OK);
+}
+
+static THD_FUNCTION(bench_mb_producer, arg) {
+  msg_t msg;
+
+  (void)arg;
+
+  do {
+    msg = chMBPostTimeout(&bench_mb, (msg_t)0x55AA, TIME_INFINITE);
+  } while (msg == MSG_OK);
+}
+
+static void bench_mb_post(void) {
+  unsigned i;
+
+  for (i = 0U; i < BENCH_BATCH; i++) {
+    (void) chMBPostTimeout(&bench_mb, (msg_t)i, TIME_INFINITE);
+  }
+}
+
+static void bench_mb_fetch(void) {
+  unsigned i;
+  msg_t data;
+
+  for (i = 0U; i < BENCH_BATCH; i++) {
+    (void) chMBFetchTimeout(&bench_mb, &data, TIME_INFINITE);
+  }
+}
+
+static void bench_mb_post_fetch(void) {
+
+  bench_mb_post();
+  bench_mb_fetch();
+}
+#endif
+
+#if (CH_CFG_USE_PIPES == TRUE) || defined(__DOXYGEN__)
+static pipe_t bench_pipe;
+static uint8_t bench_pipe_buffer[BENCH_PIPE_SIZE];
+static uint8_t bench_wdata[BENCH_PIPE_SIZE];
+static uint8_t bench_rdata[BENCH_PIPE_SIZE];
+static size_t bench_size;
+
+static THD_FUNCTION(bench_pipe_reader, arg) {
+  size_t n;
+
+  (void)arg;
+
+  do {
+    n = chPipeReadTimeout(&bench_pipe, bench_rdata, bench_size, TIME_INFINITE);
+  } while (n == bench_size);
+}
+
+static void bench_pipe_write(void) {
+  unsigned i;
+
+  for (i = 0U; i < BENCH_BATCH; i++) {
+    (void) chPipeWriteTimeout(&bench_pipe, bench_wdata, bench_size, TIME_INFINITE);
+  }
+}
+
+static void bench_pipe_write_read(void) {
+  unsigned i;
+
+  for (i = 0U; i < BENCH_BATCH; i++) {
+    (void) chPipeWriteTimeout(&bench_pipe, bench_wdata, bench_size, TIME_INFINITE);
+    (void) chPipeReadTimeout(&bench_pipe, bench_rdata, bench_size, TIME_INFINITE);
+  }
+}
+#endif
+
+#if (CH_CFG_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+static jobs_queue_t bench_jq;
+static job_descriptor_t bench_jobs[BENCH_BATCH];
+static msg_t bench_jmsgs[BENCH_BATCH];
+
+static void bench_job(void *arg) {
+
+  (void)arg;
+}
+
+static THD_FUNCTION(bench_dispatcher, arg) {
+  msg_t msg;
+
+  (void)arg;
+
+  do {
+    msg = chJobDispatch(&bench_jq);
+  } while (msg == MSG_OK);
+}
+
+static void bench_job_post(void) {
+  unsigned i;
+
+  for (i = 0U; i < BENCH_BATCH; i++) {
+    job_descriptor_t *jdp = chJobGet(&bench_jq);
+
+    jdp->jobfunc = bench_job;
+    jdp->jobarg  = NULL;
+    chJobPost(&bench_jq, jdp);
+  }
+}
+
+static void bench_job_post_dispatch(void) {
+  unsigned i;
+
+  bench_job_post();
+  for (i = 0U; i < BENCH_BATCH; i++) {
+    (void) chJobDispatch(&bench_jq);
+  }
+}
+#endif
+
+#if (CH_CFG_USE_DELEGATES == TRUE) || defined(__DOXYGEN__)
+static bool bench_exit;
+
+static msg_t bench_nop(void) {
+
+  return MSG_OK;
+}
+
+static msg_t bench_end(void) {
+
+  bench_exit = true;
+
+  return MSG_OK;
+}
+
+static THD_FUNCTION(bench_delegate, arg) {
+
+  (void)arg;
+
+  bench_exit = false;
+  do {
+    chDelegateDispatch();
+  } while (!bench_exit);
+}
+
+static void bench_delegate_call(void) {
+  unsigned i;
+
+  for (i = 0U; i < BENCH_BATCH; i++) {
+    (void) chDelegateCallDirect0(bench_tp, bench_nop);
+  }
+}
+#endif
+
+#if (CH_CFG_USE_OBJ_CACHES == TRUE) || defined(__DOXYGEN__)
+typedef struct {
+  oc_object_t       header;
+  uint8_t           data[16];
+} bench_object_t;
+
+static oc_hash_header_t bench_hash[BENCH_OBJECTS * 2U];
+static bench_object_t bench_objects[BENCH_OBJECTS];
+static objects_cache_t bench_cache;
+static uint32_t bench_key, bench_keys;
+
+static bool bench_obj_read(objects_cache_t *ocp,
+                           oc_object_t *objp,
+                           bool async) {
+
+  objp->obj_flags &= ~OC_FLAG_NOTSYNC;
+
+  if (async) {
+    chCacheReleaseObject(ocp, objp);
+  }
+
+  return false;
+}
+
+static bool bench_obj_write(objects_cache_t *ocp,
+                            oc_object_t *objp,
+                            bool async) {
+
+  (void)ocp;
+  (void)objp;
+  (void)async;
+
+  return false;
+}
+
+static void bench_cache_get(void) {
+  unsigned i;
+
+  for (i = 0U; i < BENCH_BATCH; i++) {
+    oc_object_t *objp = chCacheGetObject(&bench_cache, 0U,
+                                         bench_key++ % bench_keys);
+
+    if ((objp->obj_flags & OC_FLAG_NOTSYNC) != 0U) {
+      (void) chCacheReadObject(&bench_cache, objp, false);
+    }
+    chCacheReleaseObject(&bench_cache, objp);
+  }
+}
+#endif
+
+#if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
+static memory_pool_t bench_pool;
+static guarded_memory_pool_t bench_gpool;
+static void *bench_pool_buffer[BENCH_BATCH][4];
+static void *bench_ptrs[BENCH_BATCH];
+
+static void bench_pool_alloc_free(void) {
+  unsigned i;
+
+  for (i = 0U; i < BENCH_BATCH; i++) {
+    bench_ptrs[i] = chPoolAlloc(&bench_pool);
+  }
+  for (i = 0U; i < BENCH_BATCH; i++) {
+    chPoolFree(&bench_pool, bench_ptrs[i]);
+  }
+}
+
+static void bench_gpool_alloc_free(void) {
+  unsigned i;
+
+  for (i = 0U; i < BENCH_BATCH; i++) {
+    bench_ptrs[i] = chGuardedPoolAllocTimeout(&bench_gpool, TIME_INFINITE);
+  }
+  for (i = 0U; i < BENCH_BATCH; i++) {
+    chGuardedPoolFree(&bench_gpool, bench_ptrs[i]);
+  }
+}
+#endif
+
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+static memory_heap_t bench_heap;
+static CH_HEAP_AREA(bench_heap_buffer, BENCH_HEAP_SIZE);
+static void *bench_fragments[BENCH_OBJECTS];
+static size_t bench_alloc_size;
+
+/*
+ * The heap is fragmented by allocating blocks and freeing every other
+ * one, small allocations can be satisfied by the first fragments while
+ * larger ones have to walk the free list.
+ */
+static void bench_heap_setup(void) {
+  unsigned i;
+
+  chHeapObjectInit(&bench_heap, bench_heap_buffer, sizeof bench_heap_buffer);
+  for (i = 0U; i < BENCH_OBJECTS; i++) {
+    bench_fragments[i] = chHeapAlloc(&bench_heap, 16U);
+  }
+  for (i = 0U; i < BENCH_OBJECTS; i += 2U) {
+    chHeapFree(bench_fragments[i]);
+  }
+}
+
+static void bench_heap_teardown(void) {
+  unsigned i;
+
+  for (i = 1U; i < BENCH_OBJECTS; i += 2U) {
+    chHeapFree(bench_fragments[i]);
+  }
+}
+
+static void bench_heap_alloc_free(void) {
+  unsigned i;
+
+  for (i = 0U; i < BENCH_BATCH; i++) {
+    chHeapFree(chHeapAlloc(&bench_heap, bench_alloc_size));
+  }
+}
+#endif
+
+#if ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) &&       \
+     (CH_CFG_USE_HEAP == TRUE)) || defined(__DOXYGEN__)
+#if ((CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) &&                          \
+     (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8)) || defined(__DOXYGEN__)
+static registered_object_t *bench_rops[BENCH_FACTORY_OBJECTS];
+static unsigned bench_nrops, bench_next, bench_serial;
+
+static void bench_factory_name(char *name, unsigned n) {
+
+  name[0] = 'o';
+  name[1] = 'b';
+  name[2] = 'j';
+  name[3] = (char)('0' + ((n / 100U) % 10U));
+  name[4] = (char)('0' + ((n / 10U) % 10U));
+  name[5] = (char)('0' + (n % 10U));
+  name[6] = '\0';
+}
+
+/*
+ * Registers the specified number of objects named "obj000", "obj001" and
+ * so on, the lookups use the names stored in the registered objects.
+ */
+static bool bench_factory_register(unsigned n) {
+  char name[8];
+
+  bench_nrops = 0U;
+  bench_next = 0U;
+  while (bench_nrops < n) {
+    bench_factory_name(name, bench_nrops);
+    bench_rops[bench_nrops] = chFactoryRegisterObject(name, NULL);
+    if (bench_rops[bench_nrops] == NULL) {
+      return false;
+    }
+    bench_nrops++;
+  }
+  bench_serial = n % 1000U;
+
+  return true;
+}
+
+static void bench_factory_release(void) {
+
+  while (bench_nrops > 0U) {
+    bench_nrops--;
+    if (bench_rops[bench_nrops] != NULL) {
+      chFactoryReleaseObject(bench_rops[bench_nrops]);
+    }
+  }
+}
+
+/*
+ * Replaces the oldest registered object with a new one, the registered
+ * names are always the last used ones so they stay distinct.
+ */
+static void bench_factory_churn(void) {
+  char name[8];
+  unsigned i;
+
+  for (i = 0U; i < BENCH_BATCH; i++) {
+    if (bench_rops[bench_next] != NULL) {
+      chFactoryReleaseObject(bench_rops[bench_next]);
+    }
+    bench_factory_name(name, bench_serial);
+    bench_rops[bench_next] = chFactoryRegisterObject(name, NULL);
+    bench_serial = (bench_serial + 1U) % 1000U;
+    if (++bench_next >= bench_nrops) {
+      bench_next = 0U;
+    }
+  }
+}
+
+static void bench_factory_find(void) {
+  unsigned i;
+
+  for (i = 0U; i < BENCH_BATCH; i++) {
+    registered_object_t *rop;
+
+    rop = chFactoryFindObject(bench_rops[bench_next]->element.name);
+    chFactoryReleaseObject(rop);
+    if (++bench_next >= bench_nrops) {
+      bench_next = 0U;
+    }
+  }
+}
+#endif
+
+#if (CH_CFG_FACTORY_GENERIC_BUFFERS == TRUE) || defined(__DOXYGEN__)
+static void bench_factory_buffer(void) {
+  unsigned i;
+
+  for (i = 0U; i < BENCH_BATCH; i++) {
+    dyn_buffer_t *dbp = chFactoryCreateBuffer("bench", 16U);
+
+    chFactoryReleaseBuffer(dbp);
+  }
+}
+#endif
+#endif
+
+/****************************************************************************
+ * Test cases.
+ ****************************************************************************/
+
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_001 [10.1] Mailboxes, no contention
+ *
+ * <h2>Description</h2>
+ * Messages are posted and fetched by the test thread, the mailbox never
+ * blocks.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MAILBOXES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.1.1] Posting and fetching messages in a one second time window,
+ *   the score is reported.
+ * .
+ */
+
+static void oslib_test_010_001_setup(void) {
+  chMBObjectInit(&bench_mb, bench_mb_buffer, BENCH_BATCH);
+}
+
+static void oslib_test_010_001_execute(void) {
+
+  /* [10.1.1] Posting and fetching messages in a one second time window,
+     the score is reported.*/
+  test_set_step(1);
+  {
+    bench_run(bench_mb_post_fetch, 1U, "msgs/S", "ns/msg p50", "ns/msg p99");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t oslib_test_010_001 = {
+  "Mailboxes, no contention",
+  oslib_test_010_001_setup,
+  NULL,
+  oslib_test_010_001_execute
+};
+#endif /* CH_CFG_USE_MAILBOXES == TRUE */
+
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_002 [10.2] Mailboxes, higher priority consumer
+ *
+ * <h2>Description</h2>
+ * Messages are posted by the test thread and fetched by a thread at
+ * higher priority, each message causes two context switches.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MAILBOXES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.2.1] Starting the consumer thread.
+ * - [10.2.2] Posting messages in a one second time window, the score is
+ *   reported.
+ * - [10.2.3] Resetting the mailbox, the peer thread terminates.
+ * .
+ */
+
+static void oslib_test_010_002_setup(void) {
+  chMBObjectInit(&bench_mb, bench_mb_buffer, BENCH_BATCH);
+}
+
+static void oslib_test_010_002_execute(void) {
+
+  /* [10.2.1] Starting the consumer thread.*/
+  test_set_step(1);
+  {
+    bench_tp = bench_start(bench_mb_consumer, BENCH_PRIO_ABOVE);
+  }
+  test_end_step(1);
+
+  /* [10.2.2] Posting messages in a one second time window, the score is
+     reported.*/
+  test_set_step(2);
+  {
+    bench_run(bench_mb_post, 1U, "msgs/S", "ns/msg p50", "ns/msg p99");
+  }
+  test_end_step(2);
+
+  /* [10.2.3] Resetting the mailbox, the peer thread terminates.*/
+  test_set_step(3);
+  {
+    chMBReset(&bench_mb);
+    (void) chThdWait(bench_tp);
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_010_002 = {
+  "Mailboxes, higher priority consumer",
+  oslib_test_010_002_setup,
+  NULL,
+  oslib_test_010_002_execute
+};
+#endif /* CH_CFG_USE_MAILBOXES == TRUE */
+
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_003 [10.3] Mailboxes, lower priority producer
+ *
+ * <h2>Description</h2>
+ * Messages are posted by a thread at lower priority and fetched by the
+ * test thread, the producer fills the mailbox each time the test thread
+ * waits.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MAILBOXES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.3.1] Starting the producer thread.
+ * - [10.3.2] Fetching messages in a one second time window, the score
+ *   is reported.
+ * - [10.3.3] Resetting the mailbox, the peer thread terminates.
+ * .
+ */
+
+static void oslib_test_010_003_setup(void) {
+  chMBObjectInit(&bench_mb, bench_mb_buffer, BENCH_BATCH);
+}
+
+static void oslib_test_010_003_execute(void) {
+
+  /* [10.3.1] Starting the producer thread.*/
+  test_set_step(1);
+  {
+    bench_tp = bench_start(bench_mb_producer, BENCH_PRIO_BELOW);
+  }
+  test_end_step(1);
+
+  /* [10.3.2] Fetching messages in a one second time window, the score
+     is reported.*/
+  test_set_step(2);
+  {
+    bench_run(bench_mb_fetch, 1U, "msgs/S", "ns/msg p50", "ns/msg p99");
+  }
+  test_end_step(2);
+
+  /* [10.3.3] Resetting the mailbox, the peer thread terminates.*/
+  test_set_step(3);
+  {
+    chMBReset(&bench_mb);
+    (void) chThdWait(bench_tp);
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_010_003 = {
+  "Mailboxes, lower priority producer",
+  oslib_test_010_003_setup,
+  NULL,
+  oslib_test_010_003_execute
+};
+#endif /* CH_CFG_USE_MAILBOXES == TRUE */
+
+#if (CH_CFG_USE_PIPES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_004 [10.4] Pipes, no contention, 16 bytes transfers
+ *
+ * <h2>Description</h2>
+ * Blocks of 16 bytes are written and read back by the test thread.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_PIPES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.4.1] Writing and reading in a one second time window, the score
+ *   is reported.
+ * .
+ */
+
+static void oslib_test_010_004_setup(void) {
+  chPipeObjectInit(&bench_pipe, bench_pipe_buffer, BENCH_PIPE_SIZE);
+  bench_size = 16U;
+}
+
+static void oslib_test_010_004_execute(void) {
+
+  /* [10.4.1] Writing and reading in a one second time window, the score
+     is reported.*/
+  test_set_step(1);
+  {
+    bench_run(bench_pipe_write_read, bench_size, "bytes/S", "ns/transfer p50", "ns/transfer p99");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t oslib_test_010_004 = {
+  "Pipes, no contention, 16 bytes transfers",
+  oslib_test_010_004_setup,
+  NULL,
+  oslib_test_010_004_execute
+};
+#endif /* CH_CFG_USE_PIPES == TRUE */
+
+#if (CH_CFG_USE_PIPES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_005 [10.5] Pipes, no contention, 128 bytes transfers
+ *
+ * <h2>Description</h2>
+ * Blocks of 128 bytes are written and read back by the test thread.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_PIPES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.5.1] Writing and reading in a one second time window, the score
+ *   is reported.
+ * .
+ */
+
+static void oslib_test_010_005_setup(void) {
+  chPipeObjectInit(&bench_pipe, bench_pipe_buffer, BENCH_PIPE_SIZE);
+  bench_size = 128U;
+}
+
+static void oslib_test_010_005_execute(void) {
+
+  /* [10.5.1] Writing and reading in a one second time window, the score
+     is reported.*/
+  test_set_step(1);
+  {
+    bench_run(bench_pipe_write_read, bench_size, "bytes/S", "ns/transfer p50", "ns/transfer p99");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t oslib_test_010_005 = {
+  "Pipes, no contention, 128 bytes transfers",
+  oslib_test_010_005_setup,
+  NULL,
+  oslib_test_010_005_execute
+};
+#endif /* CH_CFG_USE_PIPES == TRUE */
+
+#if (CH_CFG_USE_PIPES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_006 [10.6] Pipes, higher priority reader, 64 bytes transfers
+ *
+ * <h2>Description</h2>
+ * Blocks of 64 bytes are written by the test thread and read by a
+ * thread at higher priority.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_PIPES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.6.1] Starting the reader thread.
+ * - [10.6.2] Writing in a one second time window, the score is
+ *   reported.
+ * - [10.6.3] Resetting the pipe, the reader thread terminates.
+ * .
+ */
+
+static void oslib_test_010_006_setup(void) {
+  chPipeObjectInit(&bench_pipe, bench_pipe_buffer, BENCH_PIPE_SIZE);
+  bench_size = 64U;
+}
+
+static void oslib_test_010_006_execute(void) {
+
+  /* [10.6.1] Starting the reader thread.*/
+  test_set_step(1);
+  {
+    bench_tp = bench_start(bench_pipe_reader, BENCH_PRIO_ABOVE);
+  }
+  test_end_step(1);
+
+  /* [10.6.2] Writing in a one second time window, the score is
+     reported.*/
+  test_set_step(2);
+  {
+    bench_run(bench_pipe_write, bench_size, "bytes/S", "ns/transfer p50", "ns/transfer p99");
+  }
+  test_end_step(2);
+
+  /* [10.6.3] Resetting the pipe, the reader thread terminates.*/
+  test_set_step(3);
+  {
+    chPipeReset(&bench_pipe);
+    (void) chThdWait(bench_tp);
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_010_006 = {
+  "Pipes, higher priority reader, 64 bytes transfers",
+  oslib_test_010_006_setup,
+  NULL,
+  oslib_test_010_006_execute
+};
+#endif /* CH_CFG_USE_PIPES == TRUE */
+
+#if (CH_CFG_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_007 [10.7] Jobs, no contention
+ *
+ * <h2>Description</h2>
+ * Jobs are posted and then dispatched by the test thread.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_JOBS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.7.1] Posting and dispatching jobs in a one second time window,
+ *   the score is reported.
+ * .
+ */
+
+static void oslib_test_010_007_setup(void) {
+  chJobObjectInit(&bench_jq, BENCH_BATCH, bench_jobs, bench_jmsgs);
+}
+
+static void oslib_test_010_007_execute(void) {
+
+  /* [10.7.1] Posting and dispatching jobs in a one second time window,
+     the score is reported.*/
+  test_set_step(1);
+  {
+    bench_run(bench_job_post_dispatch, 1U, "jobs/S", "ns/job p50", "ns/job p99");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t oslib_test_010_007 = {
+  "Jobs, no contention",
+  oslib_test_010_007_setup,
+  NULL,
+  oslib_test_010_007_execute
+};
+#endif /* CH_CFG_USE_JOBS == TRUE */
+
+#if (CH_CFG_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_008 [10.8] Jobs, higher priority dispatcher
+ *
+ * <h2>Description</h2>
+ * Jobs are posted by the test thread and dispatched by a thread at
+ * higher priority.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_JOBS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.8.1] Starting the dispatcher thread.
+ * - [10.8.2] Posting jobs in a one second time window, the score is
+ *   reported.
+ * - [10.8.3] Posting a null job, the dispatcher thread terminates.
+ * .
+ */
+
+static void oslib_test_010_008_setup(void) {
+  chJobObjectInit(&bench_jq, BENCH_BATCH, bench_jobs, bench_jmsgs);
+}
+
+static void oslib_test_010_008_execute(void) {
+
+  /* [10.8.1] Starting the dispatcher thread.*/
+  test_set_step(1);
+  {
+    bench_tp = bench_start(bench_dispatcher, BENCH_PRIO_ABOVE);
+  }
+  test_end_step(1);
+
+  /* [10.8.2] Posting jobs in a one second time window, the score is
+     reported.*/
+  test_set_step(2);
+  {
+    bench_run(bench_job_post, 1U, "jobs/S", "ns/job p50", "ns/job p99");
+  }
+  test_end_step(2);
+
+  /* [10.8.3] Posting a null job, the dispatcher thread terminates.*/
+  test_set_step(3);
+  {
+    job_descriptor_t *jdp = chJobGet(&bench_jq);
+
+    jdp->jobfunc = NULL;
+    chJobPost(&bench_jq, jdp);
+    (void) chThdWait(bench_tp);
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_010_008 = {
+  "Jobs, higher priority dispatcher",
+  oslib_test_010_008_setup,
+  NULL,
+  oslib_test_010_008_execute
+};
+#endif /* CH_CFG_USE_JOBS == TRUE */
+
+#if (CH_CFG_USE_DELEGATES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_009 [10.9] Delegates, higher priority dispatcher
+ *
+ * <h2>Description</h2>
+ * Functions without parameters are called through a delegate thread at
+ * higher priority.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_DELEGATES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.9.1] Starting the delegate thread.
+ * - [10.9.2] Calling functions in a one second time window, the score
+ *   is reported.
+ * - [10.9.3] Calling the termination function, the delegate thread
+ *   terminates.
+ * .
+ */
+
+static void oslib_test_010_009_execute(void) {
+
+  /* [10.9.1] Starting the delegate thread.*/
+  test_set_step(1);
+  {
+    bench_tp = bench_start(bench_delegate, BENCH_PRIO_ABOVE);
+  }
+  test_end_step(1);
+
+  /* [10.9.2] Calling functions in a one second time window, the score
+     is reported.*/
+  test_set_step(2);
+  {
+    bench_run(bench_delegate_call, 1U, "calls/S", "ns/call p50", "ns/call p99");
+  }
+  test_end_step(2);
+
+  /* [10.9.3] Calling the termination function, the delegate thread
+     terminates.*/
+  test_set_step(3);
+  {
+    (void) chDelegateCallDirect0(bench_tp, bench_end);
+    (void) chThdWait(bench_tp);
+  }
+  test_end_step(3);
+}
+
+static const testcase_t oslib_test_010_009 = {
+  "Delegates, higher priority dispatcher",
+  NULL,
+  NULL,
+  oslib_test_010_009_execute
+};
+#endif /* CH_CFG_USE_DELEGATES == TRUE */
+
+#if (CH_CFG_USE_OBJ_CACHES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_010 [10.10] Object caches, hits
+ *
+ * <h2>Description</h2>
+ * Objects already in the cache are repeatedly retrieved and released.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_OBJ_CACHES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.10.1] Retrieving and releasing objects in a one second time
+ *   window, the score is reported.
+ * .
+ */
+
+static void oslib_test_010_010_setup(void) {
+  chCacheObjectInit(&bench_cache, BENCH_OBJECTS * 2U, bench_hash,
+                    BENCH_OBJECTS, sizeof (bench_object_t), bench_objects,
+                    bench_obj_read, bench_obj_write);
+  bench_key  = 0U;
+  bench_keys = BENCH_OBJECTS / 2U;
+}
+
+static void oslib_test_010_010_execute(void) {
+
+  /* [10.10.1] Retrieving and releasing objects in a one second time
+     window, the score is reported.*/
+  test_set_step(1);
+  {
+    bench_run(bench_cache_get, 1U, "gets/S", "ns/get p50", "ns/get p99");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t oslib_test_010_010 = {
+  "Object caches, hits",
+  oslib_test_010_010_setup,
+  NULL,
+  oslib_test_010_010_execute
+};
+#endif /* CH_CFG_USE_OBJ_CACHES == TRUE */
+
+#if (CH_CFG_USE_OBJ_CACHES == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_011 [10.11] Object caches, misses
+ *
+ * <h2>Description</h2>
+ * More objects than the cache can hold are retrieved in sequence, every
+ * retrieval recycles the least recently used object and reads it
+ * synchronously.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_OBJ_CACHES == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.11.1] Retrieving and releasing objects in a one second time
+ *   window, the score is reported.
+ * .
+ */
+
+static void oslib_test_010_011_setup(void) {
+  chCacheObjectInit(&bench_cache, BENCH_OBJECTS * 2U, bench_hash,
+                    BENCH_OBJECTS, sizeof (bench_object_t), bench_objects,
+                    bench_obj_read, bench_obj_write);
+  bench_key  = 0U;
+  bench_keys = BENCH_OBJECTS * 2U;
+}
+
+static void oslib_test_010_011_execute(void) {
+
+  /* [10.11.1] Retrieving and releasing objects in a one second time
+     window, the score is reported.*/
+  test_set_step(1);
+  {
+    bench_run(bench_cache_get, 1U, "gets/S", "ns/get p50", "ns/get p99");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t oslib_test_010_011 = {
+  "Object caches, misses",
+  oslib_test_010_011_setup,
+  NULL,
+  oslib_test_010_011_execute
+};
+#endif /* CH_CFG_USE_OBJ_CACHES == TRUE */
+
+#if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_012 [10.12] Memory pools
+ *
+ * <h2>Description</h2>
+ * Objects are allocated from a memory pool and then freed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MEMPOOLS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.12.1] Allocating and freeing objects in a one second time
+ *   window, the score is reported.
+ * .
+ */
+
+static void oslib_test_010_012_setup(void) {
+  chPoolObjectInit(&bench_pool, sizeof bench_pool_buffer[0], NULL);
+  chPoolLoadArray(&bench_pool, bench_pool_buffer, BENCH_BATCH);
+}
+
+static void oslib_test_010_012_execute(void) {
+
+  /* [10.12.1] Allocating and freeing objects in a one second time
+     window, the score is reported.*/
+  test_set_step(1);
+  {
+    bench_run(bench_pool_alloc_free, 1U, "allocs/S", "ns/alloc p50", "ns/alloc p99");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t oslib_test_010_012 = {
+  "Memory pools",
+  oslib_test_010_012_setup,
+  NULL,
+  oslib_test_010_012_execute
+};
+#endif /* CH_CFG_USE_MEMPOOLS == TRUE */
+
+#if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_013 [10.13] Guarded memory pools
+ *
+ * <h2>Description</h2>
+ * Objects are allocated from a guarded memory pool and then freed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_MEMPOOLS == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.13.1] Allocating and freeing objects in a one second time
+ *   window, the score is reported.
+ * .
+ */
+
+static void oslib_test_010_013_setup(void) {
+  chGuardedPoolObjectInit(&bench_gpool, sizeof bench_pool_buffer[0]);
+  chGuardedPoolLoadArray(&bench_gpool, bench_pool_buffer, BENCH_BATCH);
+}
+
+static void oslib_test_010_013_execute(void) {
+
+  /* [10.13.1] Allocating and freeing objects in a one second time
+     window, the score is reported.*/
+  test_set_step(1);
+  {
+    bench_run(bench_gpool_alloc_free, 1U, "allocs/S", "ns/alloc p50", "ns/alloc p99");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t oslib_test_010_013 = {
+  "Guarded memory pools",
+  oslib_test_010_013_setup,
+  NULL,
+  oslib_test_010_013_execute
+};
+#endif /* CH_CFG_USE_MEMPOOLS == TRUE */
+
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_014 [10.14] Memory heaps, 16 bytes blocks
+ *
+ * <h2>Description</h2>
+ * Blocks of 16 bytes are allocated from a fragmented heap and then
+ * freed.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_HEAP == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.14.1] Allocating and freeing blocks in a one second time
+ *   window, the score is reported.
+ * .
+ */
+
+static void oslib_test_010_014_setup(void) {
+  bench_heap_setup();
+  bench_alloc_size = 16U;
+}
+
+static void oslib_test_010_014_teardown(void) {
+  bench_heap_teardown();
+}
+
+static void oslib_test_010_014_execute(void) {
+
+  /* [10.14.1] Allocating and freeing blocks in a one second time
+     window, the score is reported.*/
+  test_set_step(1);
+  {
+    bench_run(bench_heap_alloc_free, 1U, "allocs/S", "ns/alloc p50", "ns/alloc p99");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t oslib_test_010_014 = {
+  "Memory heaps, 16 bytes blocks",
+  oslib_test_010_014_setup,
+  oslib_test_010_014_teardown,
+  oslib_test_010_014_execute
+};
+#endif /* CH_CFG_USE_HEAP == TRUE */
+
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_015 [10.15] Memory heaps, 128 bytes blocks
+ *
+ * <h2>Description</h2>
+ * Blocks of 128 bytes are allocated from a fragmented heap and then
+ * freed, the allocator has to skip the smaller fragments.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_HEAP == TRUE
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.15.1] Allocating and freeing blocks in a one second time
+ *   window, the score is reported.
+ * .
+ */
+
+static void oslib_test_010_015_setup(void) {
+  bench_heap_setup();
+  bench_alloc_size = 128U;
+}
+
+static void oslib_test_010_015_teardown(void) {
+  bench_heap_teardown();
+}
+
+static void oslib_test_010_015_execute(void) {
+
+  /* [10.15.1] Allocating and freeing blocks in a one second time
+     window, the score is reported.*/
+  test_set_step(1);
+  {
+    bench_run(bench_heap_alloc_free, 1U, "allocs/S", "ns/alloc p50", "ns/alloc p99");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t oslib_test_010_015 = {
+  "Memory heaps, 128 bytes blocks",
+  oslib_test_010_015_setup,
+  oslib_test_010_015_teardown,
+  oslib_test_010_015_execute
+};
+#endif /* CH_CFG_USE_HEAP == TRUE */
+
+#if (((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_016 [10.16] Objects factory, registry lookup, 1 object
+ *
+ * <h2>Description</h2>
+ * Registered objects are searched by name and released, the lookups
+ * cycle over the single registered object.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.16.1] Registering 1 object.
+ * - [10.16.2] Searching objects in a one second time window, the score
+ *   is reported.
+ * .
+ */
+
+static void oslib_test_010_016_teardown(void) {
+  bench_factory_release();
+}
+
+static void oslib_test_010_016_execute(void) {
+
+  /* [10.16.1] Registering 1 object.*/
+  test_set_step(1);
+  {
+    test_assert(bench_factory_register(1U), "cannot register");
+  }
+  test_end_step(1);
+
+  /* [10.16.2] Searching objects in a one second time window, the score
+     is reported.*/
+  test_set_step(2);
+  {
+    bench_run(bench_factory_find, 1U, "finds/S", "ns/find p50", "ns/find p99");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t oslib_test_010_016 = {
+  "Objects factory, registry lookup, 1 object",
+  NULL,
+  oslib_test_010_016_teardown,
+  oslib_test_010_016_execute
+};
+#endif /* ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8) */
+
+#if (((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_017 [10.17] Objects factory, registry lookup, 10 objects
+ *
+ * <h2>Description</h2>
+ * Registered objects are searched by name and released, the lookups
+ * cycle over all the 10 registered objects.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.17.1] Registering 10 objects.
+ * - [10.17.2] Searching objects in a one second time window, the score
+ *   is reported.
+ * .
+ */
+
+static void oslib_test_010_017_teardown(void) {
+  bench_factory_release();
+}
+
+static void oslib_test_010_017_execute(void) {
+
+  /* [10.17.1] Registering 10 objects.*/
+  test_set_step(1);
+  {
+    test_assert(bench_factory_register(10U), "cannot register");
+  }
+  test_end_step(1);
+
+  /* [10.17.2] Searching objects in a one second time window, the score
+     is reported.*/
+  test_set_step(2);
+  {
+    bench_run(bench_factory_find, 1U, "finds/S", "ns/find p50", "ns/find p99");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t oslib_test_010_017 = {
+  "Objects factory, registry lookup, 10 objects",
+  NULL,
+  oslib_test_010_017_teardown,
+  oslib_test_010_017_execute
+};
+#endif /* ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8) */
+
+#if (((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_018 [10.18] Objects factory, registry lookup, 100 objects
+ *
+ * <h2>Description</h2>
+ * Registered objects are searched by name and released, the lookups
+ * cycle over all the 100 registered objects.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.18.1] Registering 100 objects.
+ * - [10.18.2] Searching objects in a one second time window, the score
+ *   is reported.
+ * .
+ */
+
+static void oslib_test_010_018_teardown(void) {
+  bench_factory_release();
+}
+
+static void oslib_test_010_018_execute(void) {
+
+  /* [10.18.1] Registering 100 objects.*/
+  test_set_step(1);
+  {
+    test_assert(bench_factory_register(100U), "cannot register");
+  }
+  test_end_step(1);
+
+  /* [10.18.2] Searching objects in a one second time window, the score
+     is reported.*/
+  test_set_step(2);
+  {
+    bench_run(bench_factory_find, 1U, "finds/S", "ns/find p50", "ns/find p99");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t oslib_test_010_018 = {
+  "Objects factory, registry lookup, 100 objects",
+  NULL,
+  oslib_test_010_018_teardown,
+  oslib_test_010_018_execute
+};
+#endif /* ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8) */
+
+#if (((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_019 [10.19] Objects factory, registry lookup, 500 objects
+ *
+ * <h2>Description</h2>
+ * Registered objects are searched by name and released, the lookups
+ * cycle over all the 500 registered objects.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.19.1] Registering 500 objects.
+ * - [10.19.2] Searching objects in a one second time window, the score
+ *   is reported.
+ * .
+ */
+
+static void oslib_test_010_019_teardown(void) {
+  bench_factory_release();
+}
+
+static void oslib_test_010_019_execute(void) {
+
+  /* [10.19.1] Registering 500 objects.*/
+  test_set_step(1);
+  {
+    test_assert(bench_factory_register(500U), "cannot register");
+  }
+  test_end_step(1);
+
+  /* [10.19.2] Searching objects in a one second time window, the score
+     is reported.*/
+  test_set_step(2);
+  {
+    bench_run(bench_factory_find, 1U, "finds/S", "ns/find p50", "ns/find p99");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t oslib_test_010_019 = {
+  "Objects factory, registry lookup, 500 objects",
+  NULL,
+  oslib_test_010_019_teardown,
+  oslib_test_010_019_execute
+};
+#endif /* ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8) */
+
+#if (((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_020 [10.20] Objects factory, registry lookup after churn, 500 objects
+ *
+ * <h2>Description</h2>
+ * Registered objects are replaced by objects with different names for
+ * one second, then the lookups cycle over all the 500 registered
+ * objects. Lookups must not be slower than without the previous
+ * deletions.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.20.1] Registering 500 objects.
+ * - [10.20.2] Replacing objects in a one second time window, the score
+ *   is reported.
+ * - [10.20.3] Checking that all the objects have been registered and
+ *   can be found.
+ * - [10.20.4] Searching objects in a one second time window, the score
+ *   is reported.
+ * .
+ */
+
+static void oslib_test_010_020_teardown(void) {
+  bench_factory_release();
+}
+
+static void oslib_test_010_020_execute(void) {
+
+  /* [10.20.1] Registering 500 objects.*/
+  test_set_step(1);
+  {
+    test_assert(bench_factory_register(500U), "cannot register");
+  }
+  test_end_step(1);
+
+  /* [10.20.2] Replacing objects in a one second time window, the score
+     is reported.*/
+  test_set_step(2);
+  {
+    bench_run(bench_factory_churn, 1U, "replaces/S", "ns/replace p50", "ns/replace p99");
+  }
+  test_end_step(2);
+
+  /* [10.20.3] Checking that all the objects have been registered and
+     can be found.*/
+  test_set_step(3);
+  {
+    unsigned i;
+
+    for (i = 0U; i < bench_nrops; i++) {
+      registered_object_t *rop;
+
+      test_assert(bench_rops[i] != NULL, "cannot register");
+      rop = chFactoryFindObject(bench_rops[i]->element.name);
+      test_assert(rop == bench_rops[i], "wrong object");
+      chFactoryReleaseObject(rop);
+    }
+  }
+  test_end_step(3);
+
+  /* [10.20.4] Searching objects in a one second time window, the score
+     is reported.*/
+  test_set_step(4);
+  {
+    bench_run(bench_factory_find, 1U, "finds/S", "ns/find p50", "ns/find p99");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t oslib_test_010_020 = {
+  "Objects factory, registry lookup after churn, 500 objects",
+  NULL,
+  oslib_test_010_020_teardown,
+  oslib_test_010_020_execute
+};
+#endif /* ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8) */
+
+#if (((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_GENERIC_BUFFERS == TRUE)) || defined(__DOXYGEN__)
+/**
+ * @page oslib_test_010_021 [10.21] Objects factory, dynamic buffers
+ *
+ * <h2>Description</h2>
+ * Dynamic buffers are created and then released.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_GENERIC_BUFFERS == TRUE)
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.21.1] Creating and releasing buffers in a one second time
+ *   window, the score is reported.
+ * .
+ */
+
+static void oslib_test_010_021_execute(void) {
+
+  /* [10.21.1] Creating and releasing buffers in a one second time
+     window, the score is reported.*/
+  test_set_step(1);
+  {
+    bench_run(bench_factory_buffer, 1U, "buffers/S", "ns/buffer p50", "ns/buffer p99");
+  }
+  test_end_step(1);
+}
+
+static const testcase_t oslib_test_010_021 = {
+  "Objects factory, dynamic buffers",
+  NULL,
+  NULL,
+  oslib_test_010_021_execute
+};
+#endif /* ((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_GENERIC_BUFFERS == TRUE) */
+
+/****************************************************************************
+ * Exported data.
+ ****************************************************************************/
+
+/**
+ * @brief   Array of test cases.
+ */
+const testcase_t * const oslib_test_sequence_010_array[] = {
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_001,
+#endif
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_002,
+#endif
+#if (CH_CFG_USE_MAILBOXES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_003,
+#endif
+#if (CH_CFG_USE_PIPES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_004,
+#endif
+#if (CH_CFG_USE_PIPES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_005,
+#endif
+#if (CH_CFG_USE_PIPES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_006,
+#endif
+#if (CH_CFG_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_007,
+#endif
+#if (CH_CFG_USE_JOBS == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_008,
+#endif
+#if (CH_CFG_USE_DELEGATES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_009,
+#endif
+#if (CH_CFG_USE_OBJ_CACHES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_010,
+#endif
+#if (CH_CFG_USE_OBJ_CACHES == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_011,
+#endif
+#if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_012,
+#endif
+#if (CH_CFG_USE_MEMPOOLS == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_013,
+#endif
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_014,
+#endif
+#if (CH_CFG_USE_HEAP == TRUE) || defined(__DOXYGEN__)
+  &oslib_test_010_015,
+#endif
+#if (((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8)) || defined(__DOXYGEN__)
+  &oslib_test_010_016,
+#endif
+#if (((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8)) || defined(__DOXYGEN__)
+  &oslib_test_010_017,
+#endif
+#if (((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8)) || defined(__DOXYGEN__)
+  &oslib_test_010_018,
+#endif
+#if (((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8)) || defined(__DOXYGEN__)
+  &oslib_test_010_019,
+#endif
+#if (((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_OBJECTS_REGISTRY == TRUE) && (CH_CFG_FACTORY_MAX_NAMES_LENGTH >= 8)) || defined(__DOXYGEN__)
+  &oslib_test_010_020,
+#endif
+#if (((CH_CFG_USE_FACTORY == TRUE) && (CH_CFG_USE_MEMPOOLS == TRUE) && (CH_CFG_USE_HEAP == TRUE)) && (CH_CFG_FACTORY_GENERIC_BUFFERS == TRUE)) || defined(__DOXYGEN__)
+  &oslib_test_010_021,
+#endif
+  NULL
+};
+
+/**
+ * @brief   Benchmarks.
+ */
+const testsequence_t oslib_test_sequence_010 = {
+  "Benchmarks",
+  oslib_test_sequence_010_array
+};
@@ -32,6 +32,7 @@
  * <h2>Test Cases</h2>
  * - @subpage rt_test_003_001
  * - @subpage rt_test_003_002
+ * - @subpage rt_test_003_003
  * .
  */
 
@@ -41,6 +42,22 @@
 
 #include "ch.h"
 
+static virtual_timer_t vt;
+static volatile unsigned vtcnt, vtlimit;
+
+/* Continuous timer callback, it stops the timer when the expirations
+   counter reaches the limit.*/
+static void vtcb(void *p) {
+  virtual_timer_t *vtp = (virtual_timer_t *)p;
+
+  chSysLockFromISR();
+  vtcnt++;
+  if (vtcnt == vtlimit) {
+    chVTResetI(vtp);
+  }
+  chSysUnlockFromISR();
+}
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -153,6 +170,80 @@ static const testcase_t rt_test_003_002 = {
   rt_test_003_002_execute
 };
 
+/**
+ * @page rt_test_003_003 [3.3] Continuous virtual timers functionality
+ *
+ * <h2>Description</h2>
+ * The functionality of the API @p chVTSetContinuous() is tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [3.3.1] A continuous timer with a 10 ticks interval is armed, after
+ *   55 ticks it must have expired exactly 5 times and it must be still
+ *   armed.
+ * - [3.3.2] The timer is stopped, no more expirations are expected.
+ * - [3.3.3] The timer is armed again and stopped by its own callback on
+ *   the third expiration.
+ * .
+ */
+
+static void rt_test_003_003_setup(void) {
+  chVTObjectInit(&vt);
+}
+
+static void rt_test_003_003_teardown(void) {
+  chVTReset(&vt);
+}
+
+static void rt_test_003_003_execute(void) {
+  systime_t start;
+
+  /* [3.3.1] A continuous timer with a 10 ticks interval is armed, after
+     55 ticks it must have expired exactly 5 times and it must be still
+     armed.*/
+  test_set_step(1);
+  {
+    vtcnt = 0U;
+    vtlimit = 0U;
+    start = test_wait_tick();
+    chVTSetContinuous(&vt, 10, vtcb, &vt);
+    chThdSleepUntil(chTimeAddX(start, 55));
+    test_assert(vtcnt == 5U, "wrong number of expirations");
+    test_assert(chVTIsArmed(&vt) == true, "timer not armed");
+  }
+  test_end_step(1);
+
+  /* [3.3.2] The timer is stopped, no more expirations are expected.*/
+  test_set_step(2);
+  {
+    chVTReset(&vt);
+    test_assert(chVTIsArmed(&vt) == false, "timer still armed");
+    chThdSleep(20);
+    test_assert(vtcnt == 5U, "unexpected expiration");
+  }
+  test_end_step(2);
+
+  /* [3.3.3] The timer is armed again and stopped by its own callback on
+     the third expiration.*/
+  test_set_step(3);
+  {
+    vtcnt = 0U;
+    vtlimit = 3U;
+    start = test_wait_tick();
+    chVTSetContinuous(&vt, 10, vtcb, &vt);
+    chThdSleepUntil(chTimeAddX(start, 55));
+    test_assert(vtcnt == 3U, "wrong number of expirations");
+    test_assert(chVTIsArmed(&vt) == false, "timer still armed");
+  }
+  test_end_step(3);
+}
+
+static const testcase_t rt_test_003_003 = {
+  "Continuous virtual timers functionality",
+  rt_test_003_003_setup,
+  rt_test_003_003_teardown,
+  rt_test_003_003_execute
+};
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -163,6 +254,7 @@ static const testcase_t rt_test_003_002 = {
 const testcase_t * const rt_test_sequence_003_array[] = {
   &rt_test_003_001,
   &rt_test_003_002,
+  &rt_test_003_003,
   NULL
 };
 
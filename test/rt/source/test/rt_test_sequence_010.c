@@ -42,6 +42,8 @@
  * - @subpage rt_test_010_005
  * - @subpage rt_test_010_006
  * - @subpage rt_test_010_007
+ * - @subpage rt_test_010_008
+ * - @subpage rt_test_010_009
  * .
  */
 
@@ -573,6 +575,222 @@ static const testcase_t rt_test_010_007 = {
   rt_test_010_007_execute
 };
 
+/**
+ * @page rt_test_010_008 [10.8] Broadcasting on multiple Event Sources
+ *
+ * <h2>Description</h2>
+ * Functionality of chEvtBroadcastFlagsMany() is tested.
+ *
+ * <h2>Test Steps</h2>
+ * - [10.8.1] Registering on two event sources associating them with
+ *   events 1 and 4.
+ * - [10.8.2] Broadcasting flag 2 on both Event Sources with a single
+ *   call then verifying that both events and flags have been received.
+ * - [10.8.3] Broadcasting on the first Event Source only, only event 1
+ *   is expected.
+ * - [10.8.4] Unregistering from the Event Sources.
+ * .
+ */
+
+static void rt_test_010_008_setup(void) {
+  chEvtGetAndClearEvents(ALL_EVENTS);
+  chEvtObjectInit(&es1);
+  chEvtObjectInit(&es2);
+}
+
+static void rt_test_010_008_execute(void) {
+  eventmask_t m;
+  event_listener_t el1, el2;
+  event_source_t * const sources[2] = {&es1, &es2};
+
+  /* [10.8.1] Registering on two event sources associating them with
+     events 1 and 4.*/
+  test_set_step(1);
+  {
+    chEvtRegisterMask(&es1, &el1, 1);
+    chEvtRegisterMask(&es2, &el2, 4);
+  }
+  test_end_step(1);
+
+  /* [10.8.2] Broadcasting flag 2 on both Event Sources with a single
+     call then verifying that both events and flags have been received.*/
+  test_set_step(2);
+  {
+    chEvtBroadcastFlagsMany(sources, 2U, (eventflags_t)2);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == 5, "wrong events mask");
+    test_assert(chEvtGetAndClearFlags(&el1) == (eventflags_t)2, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el2) == (eventflags_t)2, "wrong flags");
+  }
+  test_end_step(2);
+
+  /* [10.8.3] Broadcasting on the first Event Source only, only event 1
+     is expected.*/
+  test_set_step(3);
+  {
+    chEvtBroadcastFlagsMany(sources, 1U, (eventflags_t)8);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == 1, "wrong events mask");
+    test_assert(chEvtGetAndClearFlags(&el1) == (eventflags_t)8, "wrong flags");
+    test_assert(chEvtGetAndClearFlags(&el2) == (eventflags_t)0, "unexpected flags");
+  }
+  test_end_step(3);
+
+  /* [10.8.4] Unregistering from the Event Sources.*/
+  test_set_step(4);
+  {
+    chEvtUnregister(&es1, &el1);
+    chEvtUnregister(&es2, &el2);
+    test_assert(!chEvtIsListeningI(&es1), "stuck listener");
+    test_assert(!chEvtIsListeningI(&es2), "stuck listener");
+  }
+  test_end_step(4);
+}
+
+static const testcase_t rt_test_010_008 = {
+  "Broadcasting on multiple Event Sources",
+  rt_test_010_008_setup,
+  NULL,
+  rt_test_010_008_execute
+};
+
+#if (CH_CFG_USE_EVENTS_COALESCING) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_010_009 [10.9] Events coalescing
+ *
+ * <h2>Description</h2>
+ * Wakeup coalescing on an Event Listener is tested. The first broadcast
+ * in an interval is signaled immediately, further broadcasts are
+ * deferred to the interval end unless the threshold is reached.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_EVENTS_COALESCING
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [10.9.1] Registering on the Event Source, the coalescing interval
+ *   is 100mS and the threshold is 3.
+ * - [10.9.2] Broadcasting flag 1, the first broadcast is signaled
+ *   immediately.
+ * - [10.9.3] Broadcasting flags 2 and 4 within the interval, the signal
+ *   is deferred.
+ * - [10.9.4] Broadcasting flag 8, the threshold is reached and the
+ *   accumulated flags are signaled immediately.
+ * - [10.9.5] Waiting for the interval to expire then broadcasting flags
+ *   16 and 32, the first broadcast is signaled immediately, the second
+ *   one after 100mS.
+ * - [10.9.6] Disabling coalescing, broadcasts are signaled immediately.
+ * - [10.9.7] Unregistering from the Event Source.
+ * .
+ */
+
+static void rt_test_010_009_setup(void) {
+  chEvtGetAndClearEvents(ALL_EVENTS);
+  chEvtObjectInit(&es1);
+}
+
+static void rt_test_010_009_execute(void) {
+  eventmask_t m;
+  eventflags_t f;
+  event_listener_t el1;
+  systime_t target_time;
+
+  /* [10.9.1] Registering on the Event Source, the coalescing interval
+     is 100mS and the threshold is 3.*/
+  test_set_step(1);
+  {
+    chEvtRegisterMask(&es1, &el1, 1);
+    chEvtSetCoalescing(&el1, TIME_MS2I(100), 3U);
+  }
+  test_end_step(1);
+
+  /* [10.9.2] Broadcasting flag 1, the first broadcast is signaled
+     immediately.*/
+  test_set_step(2);
+  {
+    chEvtBroadcastFlags(&es1, (eventflags_t)1);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == 1, "event not signaled");
+    f = chEvtGetAndClearFlags(&el1);
+    test_assert(f == (eventflags_t)1, "wrong flags");
+  }
+  test_end_step(2);
+
+  /* [10.9.3] Broadcasting flags 2 and 4 within the interval, the signal
+     is deferred.*/
+  test_set_step(3);
+  {
+    chEvtBroadcastFlags(&es1, (eventflags_t)2);
+    chEvtBroadcastFlags(&es1, (eventflags_t)4);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == 0, "event not deferred");
+  }
+  test_end_step(3);
+
+  /* [10.9.4] Broadcasting flag 8, the threshold is reached and the
+     accumulated flags are signaled immediately.*/
+  test_set_step(4);
+  {
+    chEvtBroadcastFlags(&es1, (eventflags_t)8);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == 1, "event not signaled");
+    f = chEvtGetAndClearFlags(&el1);
+    test_assert(f == (eventflags_t)14, "wrong flags");
+  }
+  test_end_step(4);
+
+  /* [10.9.5] Waiting for the interval to expire then broadcasting flags
+     16 and 32, the first broadcast is signaled immediately, the second
+     one after 100mS.*/
+  test_set_step(5);
+  {
+    chThdSleepMilliseconds(150);
+    target_time = chTimeAddX(test_wait_tick(), TIME_MS2I(100));
+    chEvtBroadcastFlags(&es1, (eventflags_t)16);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == 1, "event not signaled");
+    chEvtBroadcastFlags(&es1, (eventflags_t)32);
+    m = chEvtWaitAny(ALL_EVENTS);
+    test_assert_time_window(target_time,
+                            chTimeAddX(target_time, ALLOWED_DELAY),
+                            "out of time window");
+    test_assert(m == 1, "wrong events mask");
+    f = chEvtGetAndClearFlags(&el1);
+    test_assert(f == (eventflags_t)48, "wrong flags");
+  }
+  test_end_step(5);
+
+  /* [10.9.6] Disabling coalescing, broadcasts are signaled immediately.*/
+  test_set_step(6);
+  {
+    chEvtSetCoalescing(&el1, (sysinterval_t)0, 0U);
+    chEvtBroadcastFlags(&es1, (eventflags_t)64);
+    m = chEvtGetAndClearEvents(ALL_EVENTS);
+    test_assert(m == 1, "event not signaled");
+    f = chEvtGetAndClearFlags(&el1);
+    test_assert(f == (eventflags_t)64, "wrong flags");
+  }
+  test_end_step(6);
+
+  /* [10.9.7] Unregistering from the Event Source.*/
+  test_set_step(7);
+  {
+    chEvtUnregister(&es1, &el1);
+    test_assert(!chEvtIsListeningI(&es1), "stuck listener");
+  }
+  test_end_step(7);
+}
+
+static const testcase_t rt_test_010_009 = {
+  "Events coalescing",
+  rt_test_010_009_setup,
+  NULL,
+  rt_test_010_009_execute
+};
+#endif /* CH_CFG_USE_EVENTS_COALESCING */
+
 /****************************************************************************
  * Exported data.
  ****************************************************************************/
@@ -590,6 +808,10 @@ const testcase_t * const rt_test_sequence_010_array[] = {
   &rt_test_010_006,
 #endif
   &rt_test_010_007,
+  &rt_test_010_008,
+#if (CH_CFG_USE_EVENTS_COALESCING) || defined(__DOXYGEN__)
+  &rt_test_010_009,
+#endif
   NULL
 };
 
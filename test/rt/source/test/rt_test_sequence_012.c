@@ -46,6 +46,8 @@
  * - @subpage rt_test_012_010
  * - @subpage rt_test_012_011
  * - @subpage rt_test_012_012
+ * - @subpage rt_test_012_013
+ * - @subpage rt_test_012_014
  * .
  */
 
@@ -134,6 +136,51 @@ static THD_FUNCTION(bmk_thread8, p) {
   } while(!chThdShouldTerminateX());
 }
 
+#if CH_CFG_USE_EVENTS
+static EVENTSOURCE_DECL(bmk_es);
+static sysinterval_t bmk_interval;
+static uint32_t bmk_wakeups;
+
+static THD_FUNCTION(bmk_thread9, p) {
+  event_listener_t el;
+
+  (void)p;
+  chEvtRegisterMask(&bmk_es, &el, EVENT_MASK(0));
+#if CH_CFG_USE_EVENTS_COALESCING
+  chEvtSetCoalescing(&el, bmk_interval, 0U);
+#endif
+  while (!chThdShouldTerminateX()) {
+    (void) chEvtWaitAny(EVENT_MASK(0));
+    (void) chEvtGetAndClearFlags(&el);
+    bmk_wakeups++;
+  }
+  chEvtUnregister(&bmk_es, &el);
+}
+
+NOINLINE static uint32_t evt_storm_test(uint32_t *wakeups) {
+  systime_t start, end;
+  uint32_t n = 0;
+
+  bmk_wakeups = 0;
+  threads[0] = chThdCreateStatic(wa[0], WA_SIZE, chThdGetPriorityX() + 1,
+                                 bmk_thread9, NULL);
+  start = test_wait_tick();
+  end = chTimeAddX(start, TIME_MS2I(1000));
+  do {
+    chEvtBroadcastFlags(&bmk_es, (eventflags_t)1);
+    n++;
+#if defined(SIMULATOR)
+    _sim_check_for_interrupts();
+#endif
+  } while (chVTIsSystemTimeWithinX(start, end));
+  *wakeups = bmk_wakeups;
+  chThdTerminate(threads[0]);
+  chEvtBroadcastFlags(&bmk_es, (eventflags_t)1);
+  test_wait_threads();
+  return n;
+}
+#endif
+
 /****************************************************************************
  * Test cases.
  ****************************************************************************/
@@ -185,11 +232,8 @@ static void rt_test_012_001_execute(void) {
   /* [12.1.3] Score is printed.*/
   test_set_step(3);
   {
-    test_print("--- Score : ");
-    test_printn(n);
-    test_print(" msgs/S, ");
-    test_printn(n << 1);
-    test_println(" ctxswc/S");
+    test_bench_score(n, "msgs/S");
+    test_bench_score(n << 1, "ctxswc/S");
   }
   test_end_step(3);
 }
@@ -249,11 +293,8 @@ static void rt_test_012_002_execute(void) {
   /* [12.2.3] Score is printed.*/
   test_set_step(3);
   {
-    test_print("--- Score : ");
-    test_printn(n);
-    test_print(" msgs/S, ");
-    test_printn(n << 1);
-    test_println(" ctxswc/S");
+    test_bench_score(n, "msgs/S");
+    test_bench_score(n << 1, "ctxswc/S");
   }
   test_end_step(3);
 }
@@ -327,11 +368,8 @@ static void rt_test_012_003_execute(void) {
   /* [12.3.4] Score is printed.*/
   test_set_step(4);
   {
-    test_print("--- Score : ");
-    test_printn(n);
-    test_print(" msgs/S, ");
-    test_printn(n << 1);
-    test_println(" ctxswc/S");
+    test_bench_score(n, "msgs/S");
+    test_bench_score(n << 1, "ctxswc/S");
   }
   test_end_step(4);
 }
@@ -412,9 +450,7 @@ static void rt_test_012_004_execute(void) {
   /* [12.4.4] Score is printed.*/
   test_set_step(4);
   {
-    test_print("--- Score : ");
-    test_printn(n * 2);
-    test_println(" ctxswc/S");
+    test_bench_score(n * 2, "ctxswc/S");
   }
   test_end_step(4);
 }
@@ -470,9 +506,7 @@ static void rt_test_012_005_execute(void) {
   /* [12.5.2] Score is printed.*/
   test_set_step(2);
   {
-    test_print("--- Score : ");
-    test_printn(n);
-    test_println(" threads/S");
+    test_bench_score(n, "threads/S");
   }
   test_end_step(2);
 }
@@ -533,9 +567,7 @@ static void rt_test_012_006_execute(void) {
   /* [12.6.2] Score is printed.*/
   test_set_step(2);
   {
-    test_print("--- Score : ");
-    test_printn(n);
-    test_println(" threads/S");
+    test_bench_score(n, "threads/S");
   }
   test_end_step(2);
 }
@@ -623,11 +655,8 @@ static void rt_test_012_007_execute(void) {
   /* [12.7.4] The score is printed.*/
   test_set_step(4);
   {
-    test_print("--- Score : ");
-    test_printn(n);
-    test_print(" reschedules/S, ");
-    test_printn(n * 6);
-    test_println(" ctxswc/S");
+    test_bench_score(n, "reschedules/S");
+    test_bench_score(n * 6, "ctxswc/S");
   }
   test_end_step(4);
 }
@@ -688,9 +717,7 @@ static void rt_test_012_008_execute(void) {
   /* [12.8.3] The score is printed.*/
   test_set_step(3);
   {
-    test_print("--- Score : ");
-    test_printn(n);
-    test_println(" ctxswc/S");
+    test_bench_score(n, "ctxswc/S");
   }
   test_end_step(3);
 }
@@ -750,9 +777,7 @@ static void rt_test_012_009_execute(void) {
   /* [12.9.2] The score is printed.*/
   test_set_step(2);
   {
-    test_print("--- Score : ");
-    test_printn(n * 2);
-    test_println(" timers/S");
+    test_bench_score(n * 2, "timers/S");
   }
   test_end_step(2);
 }
@@ -823,9 +848,7 @@ static void rt_test_012_010_execute(void) {
   /* [12.10.2] The score is printed.*/
   test_set_step(2);
   {
-    test_print("--- Score : ");
-    test_printn(n * 4);
-    test_println(" wait+signal/S");
+    test_bench_score(n * 4, "wait+signal/S");
   }
   test_end_step(2);
 }
@@ -897,9 +920,7 @@ static void rt_test_012_011_execute(void) {
   /* [12.11.2] The score is printed.*/
   test_set_step(2);
   {
-    test_print("--- Score : ");
-    test_printn(n * 4);
-    test_println(" lock+unlock/S");
+    test_bench_score(n * 4, "lock+unlock/S");
   }
   test_end_step(2);
 }
@@ -912,28 +933,131 @@ static const testcase_t rt_test_012_011 = {
 };
 #endif /* CH_CFG_USE_MUTEXES */
 
+#if (CH_CFG_USE_EVENTS) || defined(__DOXYGEN__)
 /**
- * @page rt_test_012_012 [12.12] RAM Footprint
+ * @page rt_test_012_012 [12.12] Event flags broadcast storm
  *
  * <h2>Description</h2>
- * The memory size of the various kernel objects is printed.
+ * A thread continuously broadcasts on an Event Source while a higher
+ * priority thread listens on it, each broadcast wakes up the listener.
+ * The score is the number of broadcasts and of listener wakeups per
+ * second.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_EVENTS
+ * .
  *
  * <h2>Test Steps</h2>
- * - [12.12.1] The size of the system area is printed.
- * - [12.12.2] The size of a thread structure is printed.
- * - [12.12.3] The size of a virtual timer structure is printed.
- * - [12.12.4] The size of a semaphore structure is printed.
- * - [12.12.5] The size of a mutex is printed.
- * - [12.12.6] The size of a condition variable is printed.
- * - [12.12.7] The size of an event source is printed.
- * - [12.12.8] The size of an event listener is printed.
- * - [12.12.9] The size of a mailbox is printed.
+ * - [12.12.1] The listener thread is started then the Event Source is
+ *   broadcasted continuously for one second.
+ * - [12.12.2] The score is printed.
  * .
  */
 
 static void rt_test_012_012_execute(void) {
+  uint32_t n, w;
+
+  /* [12.12.1] The listener thread is started then the Event Source is
+     broadcasted continuously for one second.*/
+  test_set_step(1);
+  {
+    bmk_interval = (sysinterval_t)0;
+    n = evt_storm_test(&w);
+  }
+  test_end_step(1);
+
+  /* [12.12.2] The score is printed.*/
+  test_set_step(2);
+  {
+    test_bench_score(n, "broadcasts/S");
+    test_bench_score(w, "wakeups/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_012_012 = {
+  "Event flags broadcast storm",
+  NULL,
+  NULL,
+  rt_test_012_012_execute
+};
+#endif /* CH_CFG_USE_EVENTS */
+
+#if (CH_CFG_USE_EVENTS && CH_CFG_USE_EVENTS_COALESCING) || defined(__DOXYGEN__)
+/**
+ * @page rt_test_012_013 [12.13] Event flags broadcast storm, coalesced
+ *
+ * <h2>Description</h2>
+ * Same as the previous test but the listener coalesces wakeups with a
+ * one tick interval, the broadcaster is preempted once per interval at
+ * most.
+ *
+ * <h2>Conditions</h2>
+ * This test is only executed if the following preprocessor condition
+ * evaluates to true:
+ * - CH_CFG_USE_EVENTS && CH_CFG_USE_EVENTS_COALESCING
+ * .
+ *
+ * <h2>Test Steps</h2>
+ * - [12.13.1] The listener thread is started then the Event Source is
+ *   broadcasted continuously for one second.
+ * - [12.13.2] The score is printed.
+ * .
+ */
+
+static void rt_test_012_013_execute(void) {
+  uint32_t n, w;
+
+  /* [12.13.1] The listener thread is started then the Event Source is
+     broadcasted continuously for one second.*/
+  test_set_step(1);
+  {
+    bmk_interval = (sysinterval_t)1;
+    n = evt_storm_test(&w);
+  }
+  test_end_step(1);
+
+  /* [12.13.2] The score is printed.*/
+  test_set_step(2);
+  {
+    test_bench_score(n, "broadcasts/S");
+    test_bench_score(w, "wakeups/S");
+  }
+  test_end_step(2);
+}
+
+static const testcase_t rt_test_012_013 = {
+  "Event flags broadcast storm, coalesced",
+  NULL,
+  NULL,
+  rt_test_012_013_execute
+};
+#endif /* CH_CFG_USE_EVENTS && CH_CFG_USE_EVENTS_COALESCING */
+
+/**
+ * @page rt_test_012_014 [12.14] RAM Footprint
+ *
+ * <h2>Description</h2>
+ * The memory size of the various kernel objects is printed.
+ *
+ * <h2>Test Steps</h2>
+ * - [12.14.1] The size of the system area is printed.
+ * - [12.14.2] The size of a thread structure is printed.
+ * - [12.14.3] The size of a virtual timer structure is printed.
+ * - [12.14.4] The size of a semaphore structure is printed.
+ * - [12.14.5] The size of a mutex is printed.
+ * - [12.14.6] The size of a condition variable is printed.
+ * - [12.14.7] The size of an event source is printed.
+ * - [12.14.8] The size of an event listener is printed.
+ * - [12.14.9] The size of a mailbox is printed.
+ * .
+ */
 
-  /* [12.12.1] The size of the system area is printed.*/
+static void rt_test_012_014_execute(void) {
+
+  /* [12.14.1] The size of the system area is printed.*/
   test_set_step(1);
   {
     test_print("--- OS    : ");
@@ -942,7 +1066,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(1);
 
-  /* [12.12.2] The size of a thread structure is printed.*/
+  /* [12.14.2] The size of a thread structure is printed.*/
   test_set_step(2);
   {
     test_print("--- Thread: ");
@@ -951,7 +1075,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(2);
 
-  /* [12.12.3] The size of a virtual timer structure is printed.*/
+  /* [12.14.3] The size of a virtual timer structure is printed.*/
   test_set_step(3);
   {
     test_print("--- Timer : ");
@@ -960,7 +1084,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(3);
 
-  /* [12.12.4] The size of a semaphore structure is printed.*/
+  /* [12.14.4] The size of a semaphore structure is printed.*/
   test_set_step(4);
   {
 #if CH_CFG_USE_SEMAPHORES || defined(__DOXYGEN__)
@@ -971,7 +1095,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(4);
 
-  /* [12.12.5] The size of a mutex is printed.*/
+  /* [12.14.5] The size of a mutex is printed.*/
   test_set_step(5);
   {
 #if CH_CFG_USE_MUTEXES || defined(__DOXYGEN__)
@@ -982,7 +1106,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(5);
 
-  /* [12.12.6] The size of a condition variable is printed.*/
+  /* [12.14.6] The size of a condition variable is printed.*/
   test_set_step(6);
   {
 #if CH_CFG_USE_CONDVARS || defined(__DOXYGEN__)
@@ -993,7 +1117,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(6);
 
-  /* [12.12.7] The size of an event source is printed.*/
+  /* [12.14.7] The size of an event source is printed.*/
   test_set_step(7);
   {
 #if CH_CFG_USE_EVENTS || defined(__DOXYGEN__)
@@ -1004,7 +1128,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(7);
 
-  /* [12.12.8] The size of an event listener is printed.*/
+  /* [12.14.8] The size of an event listener is printed.*/
   test_set_step(8);
   {
 #if CH_CFG_USE_EVENTS || defined(__DOXYGEN__)
@@ -1015,7 +1139,7 @@ static void rt_test_012_012_execute(void) {
   }
   test_end_step(8);
 
-  /* [12.12.9] The size of a mailbox is printed.*/
+  /* [12.14.9] The size of a mailbox is printed.*/
   test_set_step(9);
   {
 #if CH_CFG_USE_MAILBOXES || defined(__DOXYGEN__)
@@ -1027,11 +1151,11 @@ static void rt_test_012_012_execute(void) {
   test_end_step(9);
 }
 
-static const testcase_t rt_test_012_012 = {
+static const testcase_t rt_test_012_014 = {
   "RAM Footprint",
   NULL,
   NULL,
-  rt_test_012_012_execute
+  rt_test_012_014_execute
 };
 
 /****************************************************************************
@@ -1065,7 +1189,13 @@ const testcase_t * const rt_test_sequence_012_array[] = {
 #if (CH_CFG_USE_MUTEXES) || defined(__DOXYGEN__)
   &rt_test_012_011,
 #endif
+#if (CH_CFG_USE_EVENTS) || defined(__DOXYGEN__)
   &rt_test_012_012,
+#endif
+#if (CH_CFG_USE_EVENTS && CH_CFG_USE_EVENTS_COALESCING) || defined(__DOXYGEN__)
+  &rt_test_012_013,
+#endif
+  &rt_test_012_014,
   NULL
 };
 
@@ -122,6 +122,10 @@ test cfg32 "-DCH_CFG_ST_RESOLUTION=16 -DCH_CFG_INTERVALS_SIZE=64"
 test cfg33 "-DCH_CFG_INTERVALS_SIZE=64"
 test cfg34 "-DCH_CFG_USE_OBJ_FIFOS=FALSE"
 test cfg35 "-DCH_CFG_USE_FACTORY=FALSE"
+test cfg36 "-DCH_CFG_USE_THREADS_TABLE=TRUE"
+test cfg37 "-DCH_CFG_USE_EVENTS_COALESCING=FALSE"
+test cfg38 "-DCH_CFG_FACTORY_HASH_SIZE=64"
+test cfg39 "-DTEST_CFG_BENCH_FORMAT=TEST_BENCH_FORMAT_JSON -DTEST_CFG_BENCH_WARMUP=1 -DTEST_CFG_BENCH_REPETITIONS=5"
 
 rm *log.txt 2> /dev/null
 echo
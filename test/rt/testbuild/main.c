@@ -24,6 +24,24 @@
 #include "oslib_test_root.h"
 #include "console.h"
 
+#if CH_CFG_USE_THREADS_TABLE == TRUE
+/*
+ * Threads table, the thread is created by chSysInit() and runs before
+ * chSysInit() returns because its priority is above NORMALPRIO.
+ */
+static THD_WORKING_AREA(waTable, 1024);
+static bool table_thread_started;
+
+static THD_FUNCTION(table_thread, arg) {
+
+  table_thread_started = (bool)(arg == (void *)waTable);
+}
+
+THD_TABLE_BEGIN
+  THD_TABLE_THREAD(NORMALPRIO + 1, "table", waTable, table_thread, waTable)
+THD_TABLE_END
+#endif
+
 /*
  * Simulator main.
  */
@@ -43,6 +61,12 @@ int main(int argc, char *argv[]) {
   conInit();
   chSysInit();
 
+#if CH_CFG_USE_THREADS_TABLE == TRUE
+  if (!table_thread_started) {
+    exit(1);
+  }
+#endif
+
   test_execute((BaseSequentialStream *)&CD1, &rt_test_suite);
   test_execute((BaseSequentialStream *)&CD1, &oslib_test_suite);
   if (test_global_fail)
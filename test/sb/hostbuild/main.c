@@ -0,0 +1,809 @@
+/*
+    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+
+    Licensed under the Apache License, Version 2.0 (the "License");
+    you may not use this file except in compliance with the License.
+    You may obtain a copy of the License at
+
+        http://www.apache.org/licenses/LICENSE-2.0
+
+    Unless required by applicable law or agreed to in writing, software
+    distributed under the License is distributed on an "AS IS" BASIS,
+    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+    See the License for the specific language governing permissions and
+    limitations under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "sbchannel.h"
+#include "sbbatch.h"
+
+#define RING_SIZE           64U
+#define GUARD_SIZE          64U
+#define GUARD_VALUE         0xA5U
+
+#define SBMEM_BASE          0x20000000U
+#define SBMEM_SIZE          1024U
+
+#define BENCH_RING_SIZE     4096U
+#define BENCH_CHUNK         256U
+#define BENCH_BYTES         (256U * 1024U * 1024U)
+
+/*
+ * Checks a condition, failures are counted and reported at the end.
+ */
+#define CHECK(cond) do {                                                    \
+  if (!(cond)) {                                                            \
+    printf("  failed at line %d: %s\n", __LINE__, #cond);                   \
+    failures++;                                                             \
+  }                                                                         \
+} while (false)
+
+static unsigned failures;
+
+/*
+ * Shared area of the tested channel followed by a guard area, nothing must
+ * be written past the channel area.
+ */
+static union {
+  uint64_t                  align;
+  uint8_t                   bytes[SB_CHANNEL_AREA_SIZE(RING_SIZE) + GUARD_SIZE];
+} area;
+
+static sb_ring_t ring;
+
+/*------------------------------------------------------------------------*
+ * Helpers.                                                               *
+ *------------------------------------------------------------------------*/
+
+static void ring_setup(uint32_t counter) {
+
+  sb_ring_init(&ring, area.bytes, RING_SIZE);
+  sb_ring_reset(&ring);
+  memset(ring.buffer, 0, RING_SIZE);
+  memset(&area.bytes[SB_CHANNEL_AREA_SIZE(RING_SIZE)], GUARD_VALUE,
+         GUARD_SIZE);
+
+  /* Counters starting from an arbitrary value, as after a long run.*/
+  ring.hdr->head = counter;
+  ring.hdr->tail = counter;
+}
+
+static bool guard_intact(void) {
+  unsigned i;
+
+  for (i = 0U; i < GUARD_SIZE; i++) {
+    if (area.bytes[SB_CHANNEL_AREA_SIZE(RING_SIZE) + i] != GUARD_VALUE) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * Byte of a data stream, the stream position is encoded in the data so
+ * that reordered, lost or duplicated bytes are detected.
+ */
+static uint8_t stream_byte(uint32_t pos) {
+
+  return (uint8_t)((pos * 7U) ^ (pos >> 8));
+}
+
+static uint64_t host_time_ns(void) {
+  struct timespec ts;
+
+  (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return ((uint64_t)ts.tv_sec * 1000000000U) + (uint64_t)ts.tv_nsec;
+}
+
+/*------------------------------------------------------------------------*
+ * Channel tests.                                                         *
+ *------------------------------------------------------------------------*/
+
+/*
+ * Empty and full conditions, doorbells are only reported on the empty to
+ * not empty and on the full to not full transitions.
+ */
+static void test_empty_full(uint32_t counter) {
+  uint8_t buf[RING_SIZE + 1U];
+  const uint8_t *rp;
+  uint8_t *wp;
+  bool db;
+  unsigned i;
+
+  ring_setup(counter);
+
+  /* Empty channel.*/
+  CHECK(sb_ring_get_used(&ring) == 0U);
+  CHECK(sb_ring_read_span(&ring, &rp) == 0U);
+  CHECK(sb_ring_read(&ring, buf, sizeof buf, &db) == 0U);
+  CHECK(!db);
+
+  /* First write into an empty channel rings the doorbell, the next one
+     does not.*/
+  for (i = 0U; i < sizeof buf; i++) {
+    buf[i] = stream_byte(i);
+  }
+  CHECK(sb_ring_write(&ring, buf, 1U, &db) == 1U);
+  CHECK(db);
+  CHECK(sb_ring_write(&ring, buf + 1, RING_SIZE, &db) == RING_SIZE - 1U);
+  CHECK(!db);
+
+  /* Full channel, writes are refused.*/
+  CHECK(sb_ring_get_used(&ring) == RING_SIZE);
+  CHECK(sb_ring_write_span(&ring, &wp) == 0U);
+  CHECK(sb_ring_write(&ring, buf, 1U, &db) == 0U);
+  CHECK(!db);
+
+  /* First read from a full channel rings the doorbell, the next one does
+     not.*/
+  memset(buf, 0, sizeof buf);
+  CHECK(sb_ring_read(&ring, buf, 1U, &db) == 1U);
+  CHECK(db);
+  CHECK(sb_ring_read(&ring, buf + 1, sizeof buf, &db) == RING_SIZE - 1U);
+  CHECK(!db);
+  for (i = 0U; i < RING_SIZE; i++) {
+    CHECK(buf[i] == stream_byte(i));
+  }
+
+  /* Empty again.*/
+  CHECK(sb_ring_get_used(&ring) == 0U);
+  CHECK(sb_ring_read_span(&ring, &rp) == 0U);
+  CHECK(sb_ring_write_span(&ring, &wp) == RING_SIZE - (counter % RING_SIZE));
+  CHECK(guard_intact());
+}
+
+/*
+ * Spans stop at the end of the buffer, the data crossing the end is
+ * returned by the next span.
+ */
+static void test_spans(uint32_t counter) {
+  const uint8_t *rp = NULL;
+  uint8_t *wp = NULL;
+  size_t n;
+  bool db;
+
+  ring_setup(counter);
+
+  /* Moving the counters 8 bytes before the end of the buffer.*/
+  n = (size_t)((RING_SIZE - 8U - counter) & (RING_SIZE - 1U));
+  ring.hdr->head += (uint32_t)n;
+  ring.hdr->tail += (uint32_t)n;
+
+  /* The first span ends at the end of the buffer.*/
+  n = sb_ring_write_span(&ring, &wp);
+  CHECK(n == 8U);
+  CHECK(wp == &ring.buffer[RING_SIZE - 8U]);
+  memset(wp, 0x11, n);
+  db = sb_ring_write_commit(&ring, n);
+  CHECK(db);
+
+  /* The second span starts at the beginning and stops at the tail.*/
+  n = sb_ring_write_span(&ring, &wp);
+  CHECK(n == RING_SIZE - 8U);
+  CHECK(wp == &ring.buffer[0]);
+  memset(wp, 0x22, 16U);
+  db = sb_ring_write_commit(&ring, 16U);
+  CHECK(!db);
+  CHECK(sb_ring_get_used(&ring) == 24U);
+
+  /* Reading in place, two spans.*/
+  n = sb_ring_read_span(&ring, &rp);
+  CHECK(n == 8U);
+  CHECK((rp == &ring.buffer[RING_SIZE - 8U]) && (rp[0] == 0x11U));
+  CHECK(!sb_ring_read_release(&ring, n));
+  n = sb_ring_read_span(&ring, &rp);
+  CHECK(n == 16U);
+  CHECK((rp == &ring.buffer[0]) && (rp[15] == 0x22U));
+  CHECK(!sb_ring_read_release(&ring, n));
+  CHECK(sb_ring_get_used(&ring) == 0U);
+  CHECK(guard_intact());
+}
+
+/*
+ * Stream of writes and reads of varying sizes, the counters cross the end
+ * of the buffer many times and, depending on the initial value, overflow
+ * the 32 bits range.
+ */
+static void test_stream(uint32_t counter) {
+  uint8_t buf[RING_SIZE];
+  uint32_t wpos = 0U, rpos = 0U, seed = 12345U;
+  unsigned i, k, initial = failures;
+  size_t n, m;
+  bool db;
+
+  ring_setup(counter);
+
+  for (i = 0U; i < 100000U; i++) {
+    seed = (seed * 1103515245U) + 12345U;
+    n = (size_t)((seed >> 16) % (RING_SIZE + 8U));
+
+    /* Writing, the written size is limited by the free space.*/
+    if (n > RING_SIZE) {
+      n = RING_SIZE;
+    }
+    for (k = 0U; k < n; k++) {
+      buf[k] = stream_byte(wpos + k);
+    }
+    m = sb_ring_write(&ring, buf, n, &db);
+    CHECK(m == ((n < RING_SIZE - (wpos - rpos)) ?
+                n : RING_SIZE - (wpos - rpos)));
+    CHECK(db == ((m > 0U) && (wpos == rpos)));
+    wpos += (uint32_t)m;
+    CHECK(sb_ring_get_used(&ring) == wpos - rpos);
+
+    /* Reading a different amount.*/
+    seed = (seed * 1103515245U) + 12345U;
+    n = (size_t)((seed >> 16) % (RING_SIZE + 8U));
+    m = sb_ring_read(&ring, buf, n, &db);
+    CHECK(m == ((n < wpos - rpos) ? n : wpos - rpos));
+    CHECK(db == ((m > 0U) && (wpos - rpos == RING_SIZE)));
+    for (k = 0U; k < m; k++) {
+      if (buf[k] != stream_byte(rpos + k)) {
+        CHECK(buf[k] == stream_byte(rpos + k));
+        break;
+      }
+    }
+    rpos += (uint32_t)m;
+    if (failures > initial) {
+      break;
+    }
+  }
+
+  CHECK(ring.hdr->head == counter + wpos);
+  CHECK(ring.hdr->tail == counter + rpos);
+  CHECK(guard_intact());
+}
+
+/*
+ * A corrupted header must not make the other side access memory outside
+ * the channel area, the channel is seen as full for the producer and as
+ * empty for the consumer.
+ */
+static void test_corrupted(void) {
+  uint8_t buf[RING_SIZE];
+  const uint8_t *rp;
+  uint8_t *wp;
+  bool db;
+
+  /* Head ahead of the tail by more than the buffer size.*/
+  ring_setup(0U);
+  ring.hdr->head = RING_SIZE + 1U;
+  CHECK(sb_ring_get_used(&ring) == RING_SIZE);
+  CHECK(sb_ring_write_span(&ring, &wp) == 0U);
+  CHECK(sb_ring_write(&ring, buf, sizeof buf, &db) == 0U);
+  CHECK(sb_ring_read_span(&ring, &rp) == 0U);
+  CHECK(sb_ring_read(&ring, buf, sizeof buf, &db) == 0U);
+
+  /* Tail ahead of the head.*/
+  ring_setup(0U);
+  ring.hdr->tail = 1U;
+  CHECK(sb_ring_get_used(&ring) == RING_SIZE);
+  CHECK(sb_ring_write_span(&ring, &wp) == 0U);
+  CHECK(sb_ring_write(&ring, buf, sizeof buf, &db) == 0U);
+  CHECK(sb_ring_read_span(&ring, &rp) == 0U);
+  CHECK(sb_ring_read(&ring, buf, sizeof buf, &db) == 0U);
+
+  /* The size in the shared header is ignored.*/
+  ring_setup(0U);
+  ring.hdr->size = 0xFFFFFFFFU;
+  ring.hdr->head = RING_SIZE - 1U;
+  ring.hdr->tail = RING_SIZE - 1U;
+  memset(buf, 0x5A, sizeof buf);
+  CHECK(sb_ring_write(&ring, buf, sizeof buf, &db) == RING_SIZE);
+  CHECK(sb_ring_write(&ring, buf, sizeof buf, &db) == 0U);
+  CHECK(ring.buffer[RING_SIZE - 1U] == 0x5AU);
+  CHECK(ring.buffer[RING_SIZE - 2U] == 0x5AU);
+
+  CHECK(guard_intact());
+}
+
+/*------------------------------------------------------------------------*
+ * Batch tests.                                                           *
+ *------------------------------------------------------------------------*/
+
+/*
+ * Sandbox memory, sandbox addresses are translated into host pointers by
+ * the dispatcher as the MPU would do.
+ */
+static union {
+  uint64_t                  align;
+  uint8_t                   bytes[SBMEM_SIZE + GUARD_SIZE];
+} sbmem;
+
+static sb_batch_header_t *batch;
+static uint32_t batch_size;
+static unsigned dispatched;
+static uint8_t stdout_log[SBMEM_SIZE];
+static size_t stdout_n;
+
+/*
+ * Translates a sandbox range, same checks of find_region() in sbhost.c.
+ */
+static uint8_t *sandbox_range(uint32_t start, uint32_t size) {
+
+  if ((start >= SBMEM_BASE) && (start < SBMEM_BASE + SBMEM_SIZE) &&
+      (size <= (SBMEM_BASE + SBMEM_SIZE) - start)) {
+    return &sbmem.bytes[start - SBMEM_BASE];
+  }
+  return NULL;
+}
+
+static uint32_t sandbox_address(const void *p) {
+
+  return SBMEM_BASE + (uint32_t)((const uint8_t *)p - sbmem.bytes);
+}
+
+/*
+ * Dispatcher serving a subset of the sandbox services.
+ */
+static uint32_t test_dispatch(void *p, const sb_sqe_t *sqep) {
+  sb_sqe_t *sq = (sb_sqe_t *)(batch + 1);
+  uint8_t *bp;
+
+  (void)p;
+
+  dispatched++;
+  switch (sqep->svc) {
+  case 0:
+    /* Posix-style file services, stdout and stdin only.*/
+    if (sqep->r[0] == SB_POSIX_WRITE) {
+      bp = sandbox_range(sqep->r[2], sqep->r[3]);
+      if (bp == NULL) {
+        return SB_ERR_EFAULT;
+      }
+      if (sqep->r[1] != 1U) {
+        return SB_ERR_EBADFD;
+      }
+      memcpy(&stdout_log[stdout_n], bp, sqep->r[3]);
+      stdout_n += sqep->r[3];
+      return sqep->r[3];
+    }
+    if (sqep->r[0] == SB_POSIX_READ) {
+      bp = sandbox_range(sqep->r[2], sqep->r[3]);
+      if (bp == NULL) {
+        return SB_ERR_EFAULT;
+      }
+      if (sqep->r[1] != 0U) {
+        return SB_ERR_EBADFD;
+      }
+      memset(bp, 0x3C, sqep->r[3]);
+      return sqep->r[3];
+    }
+    return SB_ERR_ENOSYS;
+  case 2:
+    /* System time.*/
+    return 1000U + dispatched;
+  case 20:
+    /* Hostile service, it rewrites the shared area while executing.*/
+    sq[batch->sq_tail & (batch_size - 1U)].user = 0xDEADBEEFU;
+    sq[(batch->sq_tail + 1U) & (batch_size - 1U)].svc = 12U;
+    batch->sq_head = batch->sq_tail + 1000U;
+    batch->cq_tail = batch->cq_head + 1000U;
+    return SB_ERR_NOERROR;
+  default:
+    return SB_ERR_ENOSYS;
+  }
+}
+
+static void batch_setup(uint32_t n, uint32_t counter) {
+
+  memset(sbmem.bytes, 0, SBMEM_SIZE);
+  memset(&sbmem.bytes[SBMEM_SIZE], GUARD_VALUE, GUARD_SIZE);
+  memset(stdout_log, 0, sizeof stdout_log);
+  stdout_n   = 0U;
+  dispatched = 0U;
+
+  /* The batch area is at the start of the sandbox memory.*/
+  batch      = (sb_batch_header_t *)sbmem.bytes;
+  batch_size = n;
+  batch->sq_head = counter;
+  batch->sq_tail = counter;
+  batch->cq_head = counter;
+  batch->cq_tail = counter;
+}
+
+static bool sbmem_guard_intact(void) {
+  unsigned i;
+
+  for (i = 0U; i < GUARD_SIZE; i++) {
+    if (sbmem.bytes[SBMEM_SIZE + i] != GUARD_VALUE) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * Same as sbBatchAdd() in sbuser.h.
+ */
+static bool batch_add(uint32_t svc, uint32_t r0, uint32_t r1,
+                      uint32_t r2, uint32_t r3, uint32_t user) {
+  sb_sqe_t *sqep;
+
+  if ((batch->sq_head - batch->sq_tail) >= batch_size) {
+    return false;
+  }
+
+  sqep = &((sb_sqe_t *)(batch + 1))[batch->sq_head & (batch_size - 1U)];
+  sqep->svc  = svc;
+  sqep->r[0] = r0;
+  sqep->r[1] = r1;
+  sqep->r[2] = r2;
+  sqep->r[3] = r3;
+  sqep->user = user;
+  batch->sq_head++;
+
+  return true;
+}
+
+/*
+ * Same as sbBatchGetCompletion() in sbuser.h.
+ */
+static bool batch_get(sb_cqe_t *cqep) {
+  const sb_cqe_t *cq = (const sb_cqe_t *)&((sb_sqe_t *)(batch + 1))[batch_size];
+
+  if (batch->cq_head == batch->cq_tail) {
+    return false;
+  }
+
+  *cqep = cq[batch->cq_tail & (batch_size - 1U)];
+  batch->cq_tail++;
+
+  return true;
+}
+
+static uint32_t batch_submit(void) {
+
+  return sb_batch_execute(batch, batch_size, test_dispatch, NULL);
+}
+
+/*
+ * Requests are executed in order, completions carry the user data.
+ */
+static void test_batch_order(uint32_t counter) {
+  uint8_t *msg = &sbmem.bytes[SBMEM_SIZE - 64U];
+  sb_cqe_t cqe = {0U, 0U};
+  unsigned i;
+
+  batch_setup(8U, counter);
+  memcpy(msg, "hello, world\n", 13U);
+
+  CHECK(batch_add(0U, SB_POSIX_WRITE, 1U, sandbox_address(msg), 7U, 1U));
+  CHECK(batch_add(2U, 0U, 0U, 0U, 0U, 2U));
+  CHECK(batch_add(0U, SB_POSIX_WRITE, 1U, sandbox_address(msg + 7), 6U, 3U));
+  CHECK(batch_add(0U, SB_POSIX_READ, 0U, sandbox_address(msg + 32), 4U, 4U));
+  CHECK(batch_submit() == 4U);
+  CHECK(batch_submit() == 0U);
+  CHECK(dispatched == 4U);
+
+  for (i = 1U; i <= 4U; i++) {
+    CHECK(batch_get(&cqe));
+    CHECK(cqe.user == i);
+  }
+  CHECK(!batch_get(&cqe));
+  CHECK((stdout_n == 13U) && (memcmp(stdout_log, "hello, world\n", 13U) == 0));
+  CHECK(memcmp(msg + 32, "\x3C\x3C\x3C\x3C", 4U) == 0);
+  CHECK(batch->sq_tail == counter + 4U);
+  CHECK(batch->cq_head == counter + 4U);
+}
+
+/*
+ * Malformed entries are completed with an error without being dispatched,
+ * the following entries are executed normally.
+ */
+static void test_batch_malformed(uint32_t counter) {
+  static const uint32_t svcs[] = {
+    256U, 0xFFFFFFFFU, (uint32_t)SB_BATCH_SVC_SETUP,
+    (uint32_t)SB_BATCH_SVC_SUBMIT, 99U, 2U
+  };
+  static const uint32_t results[] = {
+    SB_ERR_EINVAL, SB_ERR_EINVAL, SB_ERR_EINVAL, SB_ERR_EINVAL,
+    SB_ERR_ENOSYS, 1002U
+  };
+  sb_cqe_t cqe = {0U, 0U};
+  unsigned i;
+
+  batch_setup(8U, counter);
+
+  for (i = 0U; i < sizeof svcs / sizeof svcs[0]; i++) {
+    CHECK(batch_add(svcs[i], 0U, 0U, 0U, 0U, 100U + i));
+  }
+  CHECK(batch_submit() == sizeof svcs / sizeof svcs[0]);
+  CHECK(dispatched == 2U);
+  for (i = 0U; i < sizeof svcs / sizeof svcs[0]; i++) {
+    CHECK(batch_get(&cqe));
+    CHECK((cqe.user == 100U + i) && (cqe.result == results[i]));
+  }
+  CHECK(sbmem_guard_intact());
+}
+
+/*
+ * Buffers outside the sandbox memory are refused, the error is posted
+ * and the following entries are executed.
+ */
+static void test_batch_fault(uint32_t counter) {
+  static const uint32_t bufs[][2] = {
+    {SBMEM_BASE - 1U, 2U},
+    {SBMEM_BASE + SBMEM_SIZE, 1U},
+    {SBMEM_BASE + SBMEM_SIZE - 4U, 5U},
+    {SBMEM_BASE + 16U, 0xFFFFFFF0U},
+    {0U, 16U}
+  };
+  sb_cqe_t cqe = {0U, 0U};
+  unsigned i;
+
+  batch_setup(16U, counter);
+
+  for (i = 0U; i < sizeof bufs / sizeof bufs[0]; i++) {
+    CHECK(batch_add(0U, SB_POSIX_READ, 0U, bufs[i][0], bufs[i][1], i));
+    CHECK(batch_add(0U, SB_POSIX_WRITE, 1U, bufs[i][0], bufs[i][1], i));
+  }
+  CHECK(batch_add(0U, SB_POSIX_READ, 0U, SBMEM_BASE + SBMEM_SIZE - 4U, 4U,
+                  100U));
+  CHECK(batch_submit() == (2U * (sizeof bufs / sizeof bufs[0])) + 1U);
+
+  for (i = 0U; i < 2U * (sizeof bufs / sizeof bufs[0]); i++) {
+    CHECK(batch_get(&cqe));
+    CHECK((cqe.user == i / 2U) && (cqe.result == SB_ERR_EFAULT));
+  }
+  CHECK(batch_get(&cqe));
+  CHECK((cqe.user == 100U) && (cqe.result == 4U));
+  CHECK(stdout_n == 0U);
+  CHECK(sbmem_guard_intact());
+}
+
+/*
+ * Requests are executed as long as there is space in the completion ring,
+ * the remaining ones stay queued.
+ */
+static void test_batch_full(uint32_t counter) {
+  sb_cqe_t cqe = {0U, 0U};
+  unsigned i;
+
+  batch_setup(8U, counter);
+
+  for (i = 0U; i < 8U; i++) {
+    CHECK(batch_add(2U, 0U, 0U, 0U, 0U, i));
+  }
+  CHECK(!batch_add(2U, 0U, 0U, 0U, 0U, 8U));
+  CHECK(batch_submit() == 8U);
+
+  /* Completion ring full.*/
+  for (i = 8U; i < 12U; i++) {
+    CHECK(batch_add(2U, 0U, 0U, 0U, 0U, i));
+  }
+  CHECK(batch_submit() == 0U);
+  CHECK(dispatched == 8U);
+
+  /* Partial execution.*/
+  for (i = 0U; i < 3U; i++) {
+    CHECK(batch_get(&cqe));
+    CHECK(cqe.user == i);
+  }
+  CHECK(batch_submit() == 3U);
+  CHECK(batch->sq_head - batch->sq_tail == 1U);
+
+  /* The last request after reaping everything.*/
+  for (i = 3U; i < 11U; i++) {
+    CHECK(batch_get(&cqe));
+    CHECK(cqe.user == i);
+  }
+  CHECK(!batch_get(&cqe));
+  CHECK(batch_submit() == 1U);
+  CHECK(batch_get(&cqe));
+  CHECK(cqe.user == 11U);
+  CHECK(dispatched == 12U);
+}
+
+/*
+ * Inconsistent counters result in no execution and no writes in the
+ * completion ring.
+ */
+static void test_batch_corrupted(void) {
+  const sb_cqe_t *cq;
+  unsigned i;
+
+  /* Submission counters distance above the ring size.*/
+  batch_setup(8U, 0U);
+  cq = (const sb_cqe_t *)&((sb_sqe_t *)(batch + 1))[batch_size];
+  for (i = 0U; i < 8U; i++) {
+    CHECK(batch_add(2U, 0U, 0U, 0U, 0U, i));
+  }
+  batch->sq_head += 1U;
+  CHECK(batch_submit() == 0U);
+  batch->sq_head = batch->sq_tail - 1U;
+  CHECK(batch_submit() == 0U);
+
+  /* Completion counters distance above the ring size.*/
+  batch->sq_head = batch->sq_tail + 8U;
+  batch->cq_tail = batch->cq_head + 1U;
+  CHECK(batch_submit() == 0U);
+  batch->cq_tail = batch->cq_head - 9U;
+  CHECK(batch_submit() == 0U);
+
+  CHECK(dispatched == 0U);
+  for (i = 0U; i < 8U; i++) {
+    CHECK((cq[i].user == 0U) && (cq[i].result == 0U));
+  }
+  CHECK(sbmem_guard_intact());
+}
+
+/*
+ * A service rewriting the shared area while executing does not affect the
+ * entry being executed nor the number of executed requests.
+ */
+static void test_batch_hostile(void) {
+  sb_cqe_t cqe = {0U, 0U};
+
+  batch_setup(8U, 0U);
+
+  CHECK(batch_add(20U, 0U, 0U, 0U, 0U, 1U));
+  CHECK(batch_add(2U, 0U, 0U, 0U, 0U, 2U));
+  CHECK(batch_submit() == 2U);
+  CHECK(dispatched == 1U);
+
+  /* The counters written by the sandbox are restored.*/
+  batch->sq_head = batch->sq_tail;
+  batch->cq_tail = batch->cq_head - 2U;
+  CHECK(batch_get(&cqe));
+  CHECK((cqe.user == 1U) && (cqe.result == SB_ERR_NOERROR));
+  CHECK(batch_get(&cqe));
+  CHECK((cqe.user == 2U) && (cqe.result == SB_ERR_EINVAL));
+  CHECK(sbmem_guard_intact());
+}
+
+/*------------------------------------------------------------------------*
+ * Channel benchmark.                                                     *
+ *------------------------------------------------------------------------*/
+
+static union {
+  uint64_t                  align;
+  uint8_t                   bytes[SB_CHANNEL_AREA_SIZE(BENCH_RING_SIZE)];
+} bench_area;
+
+static sb_ring_t bench_ring;
+static bool bench_inplace;
+static unsigned bench_doorbells;
+
+/*
+ * Producer side, the consumer runs in the main thread. Doorbells are only
+ * counted, both sides poll the channel and yield when it is full or empty.
+ */
+static void *bench_producer(void *arg) {
+  uint8_t buf[BENCH_CHUNK];
+  uint32_t sent = 0U;
+  uint8_t *wp;
+  size_t n;
+  bool db;
+
+  (void)arg;
+
+  memset(buf, 0x55, sizeof buf);
+  while (sent < BENCH_BYTES) {
+    if (bench_inplace) {
+      n = sb_ring_write_span(&bench_ring, &wp);
+      if (n > BENCH_CHUNK) {
+        n = BENCH_CHUNK;
+      }
+      if (n > 0U) {
+        memset(wp, 0x55, n);
+        db = sb_ring_write_commit(&bench_ring, n);
+      }
+      else {
+        db = false;
+      }
+    }
+    else {
+      n = sb_ring_write(&bench_ring, buf, sizeof buf, &db);
+    }
+    if (db) {
+      bench_doorbells++;
+    }
+    if (n == 0U) {
+      (void) sched_yield();
+    }
+    sent += (uint32_t)n;
+  }
+
+  return NULL;
+}
+
+static void bench(bool inplace) {
+  uint8_t buf[BENCH_CHUNK];
+  uint32_t received = 0U;
+  uint64_t start, elapsed;
+  unsigned doorbells = 0U;
+  const uint8_t *rp;
+  pthread_t tid;
+  size_t n;
+  bool db;
+
+  sb_ring_init(&bench_ring, bench_area.bytes, BENCH_RING_SIZE);
+  sb_ring_reset(&bench_ring);
+  bench_inplace = inplace;
+  bench_doorbells = 0U;
+
+  start = host_time_ns();
+  (void) pthread_create(&tid, NULL, bench_producer, NULL);
+  while (received < BENCH_BYTES) {
+    if (inplace) {
+      n = sb_ring_read_span(&bench_ring, &rp);
+      db = (n > 0U) && sb_ring_read_release(&bench_ring, n);
+    }
+    else {
+      n = sb_ring_read(&bench_ring, buf, sizeof buf, &db);
+    }
+    if (db) {
+      doorbells++;
+    }
+    if (n == 0U) {
+      (void) sched_yield();
+    }
+    received += (uint32_t)n;
+  }
+  (void) pthread_join(tid, NULL);
+  elapsed = host_time_ns() - start;
+
+  printf("Channel throughput, %s\n", inplace ? "in place" : "copy");
+  printf("  %" PRIu64 " MB/s, %u+%u doorbells\n",
+         ((uint64_t)BENCH_BYTES * 1000U) / elapsed, bench_doorbells,
+         doorbells);
+}
+
+/*------------------------------------------------------------------------*
+ * Main.                                                                  *
+ *------------------------------------------------------------------------*/
+
+int main(int argc, char *argv[]) {
+  static const uint32_t counters[] = {
+    0U, 5U, RING_SIZE - 1U, 0xFFFFFFF0U, 0xFFFFFFFFU, 0x7FFFFFE3U
+  };
+  unsigned i;
+
+  printf("*** Channel ring size: %u\n", RING_SIZE);
+  printf("*** Sandbox memory:    %u\n\n", SBMEM_SIZE);
+
+  for (i = 0U; i < sizeof counters / sizeof counters[0]; i++) {
+    printf("Channel, counters from 0x%08" PRIx32 "\n", counters[i]);
+    test_empty_full(counters[i]);
+    test_spans(counters[i]);
+    test_stream(counters[i]);
+  }
+  printf("Channel, corrupted header\n");
+  test_corrupted();
+
+  for (i = 0U; i < sizeof counters / sizeof counters[0]; i++) {
+    printf("Batch, counters from 0x%08" PRIx32 "\n", counters[i]);
+    test_batch_order(counters[i]);
+    test_batch_malformed(counters[i]);
+    test_batch_fault(counters[i]);
+    test_batch_full(counters[i]);
+  }
+  printf("Batch, corrupted header\n");
+  test_batch_corrupted();
+  printf("Batch, shared area rewritten by a service\n");
+  test_batch_hostile();
+
+  if ((argc > 1) && (strcmp(argv[1], "bench") == 0)) {
+    printf("\n");
+    bench(false);
+    bench(true);
+  }
+
+  if (failures > 0U) {
+    printf("\nFinal result: FAILURE (%u)\n", failures);
+    return 1;
+  }
+  printf("\nFinal result: SUCCESS\n");
+
+  return 0;
+}
@@ -281,6 +281,13 @@
 #define HAL_CRY_ENFORCE_FALLBACK            FALSE
 #endif
 
+/**
+ * @brief   Enables the requests queue APIs.
+ */
+#if !defined(HAL_CRY_USE_QUEUE) || defined(__DOXYGEN__)
+#define HAL_CRY_USE_QUEUE                   FALSE
+#endif
+
 /*===========================================================================*/
 /* DAC driver related settings.                                              */
 /*===========================================================================*/
@@ -486,6 +493,14 @@
 #define SPI_USE_MUTUAL_EXCLUSION            TRUE
 #endif
 
+/**
+ * @brief   Enables the transactions queue APIs.
+ * @note    Disabling this option saves both code and data space.
+ */
+#if !defined(SPI_USE_QUEUE) || defined(__DOXYGEN__)
+#define SPI_USE_QUEUE                       FALSE
+#endif
+
 /**
  * @brief   Handling method for SPI CS line.
  * @note    Disabling this option saves both code and data space.
@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+#
+#    ChibiOS - Copyright (C) 2006..2018 Giovanni Di Sirio
+#
+#    Licensed under the Apache License, Version 2.0 (the "License");
+#    you may not use this file except in compliance with the License.
+#    You may obtain a copy of the License at
+#
+#        http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing, software
+#    distributed under the License is distributed on an "AS IS" BASIS,
+#    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#    See the License for the specific language governing permissions and
+#    limitations under the License.
+
+"""Decoder for the frames produced by os/various/binlog.
+
+Usage: binlog_decode.py <application.elf> [capture.bin]
+
+Format strings and string arguments are read from the allocated sections
+of the ELF file, the capture is read from stdin if not specified.
+"""
+
+import re
+import struct
+import sys
+
+SYNC = 0xA5
+HEADER_SIZE = 10
+ID_DROPPED = 0
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+
+class Image:
+    """Allocated sections of an ELF file."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            data = f.read()
+        if data[:4] != b'\x7fELF':
+            raise ValueError('not an ELF file')
+        is64 = data[4] == 2
+        self.endian = '<' if data[5] == 1 else '>'
+        e = self.endian
+        if is64:
+            shoff, = struct.unpack_from(e + 'Q', data, 0x28)
+            shentsize, shnum = struct.unpack_from(e + 'HH', data, 0x3A)
+        else:
+            shoff, = struct.unpack_from(e + 'I', data, 0x20)
+            shentsize, shnum = struct.unpack_from(e + 'HH', data, 0x2E)
+        self.sections = []
+        for i in range(shnum):
+            base = shoff + i * shentsize
+            if is64:
+                _, stype, flags, addr, offset, size = \
+                    struct.unpack_from(e + 'IIQQQQ', data, base)
+            else:
+                _, stype, flags, addr, offset, size = \
+                    struct.unpack_from(e + 'IIIIII', data, base)
+            if (flags & SHF_ALLOC) and stype != SHT_NOBITS and size > 0:
+                self.sections.append((addr, data[offset:offset + size]))
+
+    def string(self, addr):
+        for base, content in self.sections:
+            if base <= addr < base + len(content):
+                end = content.find(b'\0', addr - base)
+                if end < 0:
+                    end = len(content)
+                return content[addr - base:end].decode('latin-1')
+        return None
+
+
+SPEC = re.compile(r'%([-+0]*)(\*|\d*)(?:\.(\*|\d*))?[lL]?(.)', re.S)
+
+
+def signed(v):
+    return v - (1 << 32) if v & 0x80000000 else v
+
+
+def format_record(image, fmt, args):
+    """Formats a record using the chprintf() conversions subset.
+
+    A "*" width or precision takes its value from the arguments, before
+    the converted value, as chprintf() does. A negative "*" width does not
+    pad, a negative "*" precision prints an empty string.
+    """
+    args = list(args)
+
+    def pop():
+        return args.pop(0) if args else 0
+
+    def conv(m):
+        flags, width, precision, c = m.groups()
+        if width == '*':
+            w = max(signed(pop()), 0)
+        else:
+            w = int(width) if width else 0
+        if precision == '*':
+            p = signed(pop())
+        else:
+            p = int(precision) if precision else 0
+        if c not in 'cCsSdDiIuUxXpPoO':
+            return c
+        v = pop()
+        if c in 'sS':
+            text = image.string(v)
+            text = '(null)' if v == 0 else (text or '<0x%08X>' % v)
+            if p < 0:
+                text = ''
+            elif p > 0:
+                text = text[:p]
+            flags = flags.replace('0', '')
+        elif c in 'cC':
+            text = chr(v & 0xFF)
+            flags = flags.replace('0', '')
+        elif c in 'dDiI':
+            v = signed(v)
+            text = ('+' if '+' in flags and v >= 0 else '') + str(v)
+        elif c in 'oO':
+            text = '%o' % v
+        elif c in 'uU':
+            text = str(v)
+        else:
+            text = '%X' % v
+        if '-' in flags:
+            return text.ljust(w)
+        if '0' in flags:
+            sign = text[0] if text[:1] in '+-' and text else ''
+            return sign + text[len(sign):].rjust(w - len(sign), '0')
+        return text.rjust(w)
+
+    return SPEC.sub(conv, fmt)
+
+
+def decode(image, stream, out):
+    data = stream.read()
+    e = image.endian
+    i = 0
+    while i + HEADER_SIZE <= len(data):
+        if data[i] != SYNC:
+            i += 1
+            continue
+        nargs = data[i + 1] & 0x0F
+        core = data[i + 1] >> 4
+        size = HEADER_SIZE + 4 * nargs
+        if i + size > len(data):
+            break
+        stamp, fid = struct.unpack_from(e + 'II', data, i + 2)
+        args = struct.unpack_from(e + '%dI' % nargs, data, i + HEADER_SIZE)
+        fmt = image.string(fid) if fid != ID_DROPPED else None
+        if fid == ID_DROPPED and nargs == 1:
+            text = '*** %d records dropped ***' % args[0]
+        elif fmt is None:
+            i += 1
+            continue
+        else:
+            text = format_record(image, fmt, args)
+        out.write('[%10u:%u] %s' % (stamp, core, text.rstrip('\r\n')) + '\n')
+        i += size
+
+
+def main(argv):
+    if len(argv) not in (2, 3):
+        sys.stderr.write(__doc__)
+        return 1
+    image = Image(argv[1])
+    if len(argv) == 3:
+        with open(argv[2], 'rb') as f:
+            decode(image, f, sys.stdout)
+    else:
+        decode(image, sys.stdin.buffer, sys.stdout)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv))
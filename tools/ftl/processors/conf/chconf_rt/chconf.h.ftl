@@ -212,6 +212,17 @@
 #define CH_CFG_USE_REGISTRY                 ${doc.CH_CFG_USE_REGISTRY!"TRUE"}
 #endif
 
+/**
+ * @brief   Static threads table.
+ * @details If enabled then the threads declared in the application
+ *          threads table are created by @p chSysInit().
+ *
+ * @note    The default is @p FALSE.
+ */
+#if !defined(CH_CFG_USE_THREADS_TABLE)
+#define CH_CFG_USE_THREADS_TABLE            ${doc.CH_CFG_USE_THREADS_TABLE!"FALSE"}
+#endif
+
 /**
  * @brief   Threads synchronization APIs.
  * @details If enabled then the @p chThdWait() function is included in
@@ -314,6 +325,19 @@
 #define CH_CFG_USE_EVENTS_TIMEOUT           ${doc.CH_CFG_USE_EVENTS_TIMEOUT!"TRUE"}
 #endif
 
+/**
+ * @brief   Events Flags coalescing.
+ * @details If enabled then event listeners can limit the rate of the
+ *          wakeups caused by broadcasts, the broadcasts received within
+ *          a minimum interval are delivered with a single wakeup.
+ *
+ * @note    The default is @p FALSE.
+ * @note    Requires @p CH_CFG_USE_EVENTS.
+ */
+#if !defined(CH_CFG_USE_EVENTS_COALESCING)
+#define CH_CFG_USE_EVENTS_COALESCING        ${doc.CH_CFG_USE_EVENTS_COALESCING!"FALSE"}
+#endif
+
 /**
  * @brief   Synchronous Messages APIs.
  * @details If enabled then the synchronous messages APIs are included
@@ -507,6 +531,17 @@
 #define CH_CFG_FACTORY_MAX_NAMES_LENGTH     ${doc.CH_CFG_FACTORY_MAX_NAMES_LENGTH!"8"}
 #endif
 
+/**
+ * @brief   Size of the names hash index of each objects list.
+ * @details If not zero then each list of the factory is indexed by an
+ *          open addressing hash table of the specified size, objects
+ *          not fitting the table are still found by a linear search.
+ * @note    Must be zero or a power of two.
+ */
+#if !defined(CH_CFG_FACTORY_HASH_SIZE)
+#define CH_CFG_FACTORY_HASH_SIZE            ${doc.CH_CFG_FACTORY_HASH_SIZE!"0"}
+#endif
+
 /**
  * @brief   Enables the registry of generic objects.
  */